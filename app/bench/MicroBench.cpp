@@ -0,0 +1,123 @@
+#include "MicroBench.h"
+#include "MicroBench_Impl.h"
+
+#include "core/Log.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string_view>
+
+namespace Nyx {
+
+namespace MicroBench {
+
+void Run::report(std::string bench, std::string variant, uint64_t items,
+                 double ms) {
+  const double nsPerItem = items ? ms * 1e6 / double(items) : 0.0;
+  std::printf("%-18s %-24s %9llu %11.3f %10.2f\n", bench.c_str(),
+              variant.c_str(), (unsigned long long)items, ms, nsPerItem);
+  std::fflush(stdout);
+  m_rows.push_back({std::move(bench), std::move(variant), items, ms});
+}
+
+bool Run::check(bool ok, const std::string &what) {
+  if (!ok) {
+    std::printf("CHECK FAILED: %s\n", what.c_str());
+    std::fflush(stdout);
+    ++m_failures;
+  }
+  return ok;
+}
+
+namespace {
+volatile uint64_t g_sink = 0;
+} // namespace
+
+void sink(uint64_t v) { g_sink = g_sink + v; }
+
+} // namespace MicroBench
+
+namespace {
+
+using namespace MicroBench;
+
+struct Case {
+  const char *name;
+  void (*fn)(Run &);
+};
+
+// Case names are what --filter matches against.
+constexpr Case kCases[] = {
+    {"ecs", benchComponentStorage},
+    {"transform", benchTransforms},
+    {"churn", benchWorldChurn},
+    {"matopt", benchMaterialOptimizer},
+    {"matglsl", benchMaterialGLSL},
+    {"texcook", benchTextureCooker},
+    {"texpool", benchTexturePools},
+    {"scenesave", benchSceneSave},
+    {"sceneload", benchSceneLoad},
+    {"scenedecode", benchSceneDecodeScaling},
+    {"scenesnap", benchSceneSnapshot},
+    {"scenecodec", benchSceneCodec},
+    {"draws", benchDrawSort},
+    {"mdi", benchMultiDraw},
+    {"bvh", benchBVH},
+};
+
+} // namespace
+
+int runMicroBenchmarks(const MicroBenchDesc &desc) {
+  Run run(desc.repeats);
+  std::printf("%-18s %-24s %9s %11s %10s\n", "bench", "variant", "items",
+              "median ms", "ns/item");
+
+  uint32_t ran = 0;
+  for (const Case &c : kCases) {
+    if (!desc.filter.empty() &&
+        std::string_view(c.name).find(desc.filter) == std::string_view::npos)
+      continue;
+    c.fn(run);
+    ++ran;
+  }
+  if (ran == 0) {
+    Log::Error("Bench: no micro-benchmark matches '{}'", desc.filter);
+    return 2;
+  }
+  const int status = run.failures() ? 1 : 0;
+  if (run.failures())
+    Log::Error("Bench: {} check(s) failed", run.failures());
+
+  if (desc.timingsPath.empty())
+    return status;
+
+  nlohmann::json rows = nlohmann::json::array();
+  for (const Row &r : run.rows()) {
+    rows.push_back({{"bench", r.bench},
+                    {"variant", r.variant},
+                    {"items", r.items},
+                    {"medianMs", r.ms}});
+  }
+  nlohmann::json j = nlohmann::json::object();
+  j["repeats"] = desc.repeats;
+  j["failedChecks"] = run.failures();
+  j["rows"] = std::move(rows);
+
+  std::ofstream out(desc.timingsPath, std::ios::binary);
+  if (!out.is_open()) {
+    Log::Error("Bench: failed to open '{}'", desc.timingsPath);
+    return 1;
+  }
+  out << j.dump(2) << '\n';
+  if (!out.good()) {
+    Log::Error("Bench: failed to write '{}'", desc.timingsPath);
+    return 1;
+  }
+  Log::Info("Bench: {} micro-benchmark rows -> {}", run.rows().size(),
+            desc.timingsPath);
+  return status;
+}
+
+} // namespace Nyx
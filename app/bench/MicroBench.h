@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Nyx {
+
+struct MicroBenchDesc {
+  std::string filter;      // runs cases whose name contains it; empty = all
+  std::string timingsPath; // JSON of every row; empty skips the dump
+  uint32_t repeats = 5;    // each row reports the median of this many runs
+};
+
+// Micro-benchmarks of individual engine systems (nyx_bench --micro), each
+// timing the current path next to the one it replaced where that is still
+// reproducible. Every case runs on the CPU: no window or GL context is
+// created, and GPU-side paths are timed by the frame benchmark instead.
+// Prints one row per (case, variant, size) and returns a process exit code,
+// 1 if any case's correctness check failed.
+int runMicroBenchmarks(const MicroBenchDesc &desc);
+
+} // namespace Nyx
@@ -0,0 +1,197 @@
+#include "MicroBench_Impl.h"
+
+#include "scene/DynamicBVH.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+namespace Nyx::MicroBench {
+
+namespace {
+
+// ---- Bounding volume hierarchy ----
+
+// Unit-ish props scattered over a 1000-unit cube.
+AABB randomBox(Rng &rng) {
+  const auto coord = [&] { return float(rng.below(100000u)) * 0.01f - 500.0f; };
+  const auto size = [&] { return 0.25f + float(rng.below(200u)) * 0.01f; };
+  const glm::vec3 c(coord(), coord(), coord());
+  return AABB::fromCenterExtents(c, glm::vec3(size(), size(), size()));
+}
+
+// The same slab test the tree runs, against one box.
+float raySlab(const AABB &b, const glm::vec3 &origin, const glm::vec3 &dir) {
+  float tEnter = 0.0f;
+  float tExit = std::numeric_limits<float>::max();
+  for (int i = 0; i < 3; ++i) {
+    if (dir[i] == 0.0f) {
+      if (origin[i] < b.min[i] || origin[i] > b.max[i])
+        return -1.0f;
+      continue;
+    }
+    float t0 = (b.min[i] - origin[i]) / dir[i];
+    float t1 = (b.max[i] - origin[i]) / dir[i];
+    if (t0 > t1)
+      std::swap(t0, t1);
+    tEnter = std::max(tEnter, t0);
+    tExit = std::min(tExit, t1);
+  }
+  return tEnter <= tExit ? tEnter : -1.0f;
+}
+
+// Closest box hit, as RenderableRegistry::raycast narrows maxT.
+float closestHit(const DynamicBVH &bvh, const glm::vec3 &origin,
+                 const glm::vec3 &dir, float maxT) {
+  float best = maxT;
+  bvh.raycast(origin, dir, maxT, [&](uint32_t, float tEnter) {
+    best = std::min(best, tEnter);
+    return best;
+  });
+  return best;
+}
+
+} // namespace
+
+void benchBVH(Run &run) {
+  constexpr uint32_t kProxies = 100'000u;
+  constexpr uint32_t kQueries = 1000u;
+  constexpr float kMaxT = 5000.0f;
+  Rng rng;
+
+  std::vector<AABB> boxes(kProxies);
+  for (AABB &b : boxes)
+    b = randomBox(rng);
+  DynamicBVH bvh;
+  std::vector<uint32_t> proxies(kProxies);
+  double ms = run.time(
+      [&] { bvh.clear(); },
+      [&] {
+        for (uint32_t i = 0; i < kProxies; ++i)
+          proxies[i] = bvh.insert(boxes[i], i);
+        bvh.rebuild();
+      });
+  run.report("bvh.100k", "insert+rebuild", kProxies, ms);
+
+  // Box queries of about 1% of the scene's width, as a picking marquee or
+  // a light's influence would be.
+  std::vector<AABB> queries(kQueries);
+  for (AABB &q : queries) {
+    q = AABB::fromCenterExtents(randomBox(rng).center(), glm::vec3(10.0f));
+  }
+  std::vector<uint32_t> fromTree;
+  std::vector<uint32_t> fromScan;
+  ms = run.time([&] {
+    fromTree.clear();
+    for (const AABB &q : queries)
+      bvh.queryAABB(q, [&](uint32_t i) { fromTree.push_back(i); });
+  });
+  run.report("bvh.100k", "queryAABB tree", kQueries, ms);
+  ms = run.time([&] {
+    fromScan.clear();
+    for (const AABB &q : queries) {
+      for (uint32_t i = 0; i < kProxies; ++i) {
+        if (q.overlaps(boxes[i]))
+          fromScan.push_back(i);
+      }
+    }
+  });
+  run.report("bvh.100k", "queryAABB brute force", kQueries, ms);
+  std::sort(fromTree.begin(), fromTree.end());
+  std::sort(fromScan.begin(), fromScan.end());
+  run.check(fromTree == fromScan,
+            "bvh: queryAABB found " + std::to_string(fromTree.size()) +
+                " overlaps, brute force " + std::to_string(fromScan.size()));
+
+  // Rays from random points toward random points; a fifth run along an axis
+  // so the zero direction components are covered too.
+  std::vector<glm::vec3> origins(kQueries);
+  std::vector<glm::vec3> dirs(kQueries);
+  for (uint32_t i = 0; i < kQueries; ++i) {
+    origins[i] = randomBox(rng).center();
+    glm::vec3 d = randomBox(rng).center() - origins[i];
+    if (i % 5u == 0)
+      d = glm::vec3(0.0f);
+    d[i % 3u] += (i & 1u) ? 1.0f : -1.0f;
+    dirs[i] = glm::normalize(d);
+  }
+  std::vector<float> treeHits(kQueries);
+  std::vector<float> scanHits(kQueries);
+  ms = run.time([&] {
+    for (uint32_t i = 0; i < kQueries; ++i)
+      treeHits[i] = closestHit(bvh, origins[i], dirs[i], kMaxT);
+  });
+  run.report("bvh.100k", "raycast tree", kQueries, ms);
+  ms = run.time([&] {
+    for (uint32_t i = 0; i < kQueries; ++i) {
+      float best = kMaxT;
+      for (const AABB &b : boxes) {
+        const float t = raySlab(b, origins[i], dirs[i]);
+        if (t >= 0.0f && t < best)
+          best = t;
+      }
+      scanHits[i] = best;
+    }
+  });
+  run.report("bvh.100k", "raycast brute force", kQueries, ms);
+  uint32_t wrongHits = 0;
+  for (uint32_t i = 0; i < kQueries; ++i) {
+    if (std::abs(treeHits[i] - scanHits[i]) > 1e-3f * (1.0f + scanHits[i]))
+      ++wrongHits;
+  }
+  run.check(wrongHits == 0, "bvh: " + std::to_string(wrongHits) +
+                                " rays hit a different box than brute force");
+
+  // An axis-parallel ray starting on a box's face plane: 0 * inf in the slab
+  // test used to turn into NaN and miss.
+  {
+    DynamicBVH one;
+    one.insert({glm::vec3(0.0f), glm::vec3(1.0f)}, 0);
+    const float t = closestHit(one, glm::vec3(0.0f, 0.5f, -5.0f),
+                               glm::vec3(0.0f, 0.0f, 1.0f), kMaxT);
+    run.check(t == 5.0f, "bvh: ray along a box face hit at " +
+                             std::to_string(t) + ", expected 5");
+  }
+
+  // A frame of gameplay: 1% of the proxies move a little, then maintain()
+  // decides whether to rebuild. The old check walked the whole tree.
+  constexpr uint32_t kMoved = kProxies / 100u;
+  bvh.rebuild();
+  const uint32_t rebuildsBefore = bvh.rebuildCount();
+  const auto frame = [&] {
+    for (uint32_t m = 0; m < kMoved; ++m) {
+      const uint32_t i = rng.below(kProxies);
+      const glm::vec3 step(float(rng.below(100u)) * 0.01f - 0.5f, 0.0f,
+                           float(rng.below(100u)) * 0.01f - 0.5f);
+      boxes[i] = {boxes[i].min + step, boxes[i].max + step};
+      bvh.update(proxies[i], boxes[i]);
+    }
+    sink(bvh.maintain() ? 1u : 0u);
+  };
+  ms = run.time(frame);
+  run.report("bvh.100k", "1% moved+maintain", kMoved, ms);
+  ms = run.time([&] { sink(uint64_t(bvh.sahCostRecomputed())); });
+  run.report("bvh.100k", "full SAH walk (old check)", kProxies, ms);
+
+  for (uint32_t f = 0; f < 200u; ++f)
+    frame();
+  const float tracked = bvh.sahCost();
+  const float walked = bvh.sahCostRecomputed();
+  std::printf("bvh: height %u, SAH cost %.2f tracked / %.2f walked, %u "
+              "rebuilds over 200 frames\n",
+              bvh.height(), tracked, walked,
+              bvh.rebuildCount() - rebuildsBefore);
+  run.check(std::abs(tracked - walked) <= 1e-3f * walked,
+            "bvh: tracked SAH cost " + std::to_string(tracked) +
+                " drifted from the tree's " + std::to_string(walked));
+
+  // Removing everything but one leaves no internal nodes behind.
+  for (uint32_t i = 1; i < kProxies; ++i)
+    bvh.remove(proxies[i]);
+  run.check(bvh.proxyCount() == 1 && bvh.sahCost() == 0.0f,
+            "bvh: single-proxy tree still reports internal area");
+}
+
+} // namespace Nyx::MicroBench
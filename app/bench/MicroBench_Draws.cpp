@@ -0,0 +1,274 @@
+#include "MicroBench_Impl.h"
+
+#include "core/RadixSort.h"
+#include "render/draw/MultiDrawBatch.h"
+#include "scene/DrawKey.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <string>
+
+namespace Nyx::MicroBench {
+
+namespace {
+
+// ---- Draw sorting ----
+
+// The opaque key before depth was bucketed: 22 bits of exact distance above
+// material and mesh, so two draws practically never share a state run.
+uint64_t exactDepthKey(const Renderable &r, const glm::vec3 &camPos) {
+  const uint32_t distBits = drawKeyDistanceBits(r, camPos) >> 9;
+  return (uint64_t(r.isCamera) << 62) | (uint64_t(distBits & 0x3FFFFFu) << 40) |
+         (uint64_t(r.materialGpuIndex & 0xFFFFFFu) << 16) |
+         (uint64_t(r.mesh) << 8);
+}
+
+// A city block: draws spread over a 400-unit cube around the camera, 256
+// materials and every procedural mesh.
+std::vector<Renderable> makeDraws(uint32_t n) {
+  Rng rng;
+  std::vector<Renderable> draws(n);
+  for (Renderable &r : draws) {
+    const auto coord = [&] { return float(rng.below(40000u)) * 0.01f - 200.0f; };
+    r.model[3] = glm::vec4(coord(), coord(), coord(), 1.0f);
+    r.materialGpuIndex = rng.below(256u);
+    r.mesh = ProcMeshType(rng.below(5u));
+  }
+  return draws;
+}
+
+// Material or mesh switches a batcher walking `order` would make.
+uint32_t stateChanges(const std::vector<Renderable> &draws,
+                      const std::vector<uint32_t> &order) {
+  uint32_t changes = 0;
+  for (size_t i = 1; i < order.size(); ++i) {
+    const Renderable &a = draws[order[i - 1]];
+    const Renderable &b = draws[order[i]];
+    if (a.materialGpuIndex != b.materialGpuIndex || a.mesh != b.mesh)
+      ++changes;
+  }
+  return changes;
+}
+
+// ---- Multi-draw batching ----
+
+// A GLMeshPool layout for the five procedural meshes, packed back to back.
+std::vector<GLMeshRange> poolRanges() {
+  const uint32_t indexCounts[] = {36u, 6u, 96u, 2880u, 2904u};
+  const uint32_t vertexCounts[] = {24u, 4u, 33u, 561u, 507u};
+  std::vector<GLMeshRange> ranges;
+  uint32_t firstIndex = 0;
+  int32_t baseVertex = 0;
+  for (uint32_t i = 0; i < 5u; ++i) {
+    ranges.push_back({firstIndex, indexCounts[i], baseVertex});
+    firstIndex += indexCounts[i];
+    baseVertex += int32_t(vertexCounts[i]);
+  }
+  return ranges;
+}
+
+// Per-program ranges of the indirect buffer, grouped the way the forward
+// pass does: graph materials with a specialized program (every fourth here)
+// get their own batch, the rest share the VM program, cameras go last.
+struct ForwardBatches final {
+  std::vector<std::vector<DrawRange>> programs;
+  std::vector<DrawRange> cameras;
+};
+
+void collectForward(const std::vector<Renderable> &draws,
+                    const std::vector<uint32_t> &order, ForwardBatches &out) {
+  for (std::vector<DrawRange> &ranges : out.programs)
+    ranges.clear();
+  out.cameras.clear();
+  uint32_t drawIndex = 0;
+  for (uint32_t i : order) {
+    const Renderable &r = draws[i];
+    if (r.isCamera) {
+      appendDrawIndex(out.cameras, drawIndex++);
+      continue;
+    }
+    const uint32_t prog =
+        r.materialGpuIndex % 4u == 0 ? 1u + r.materialGpuIndex / 4u : 0u;
+    appendDrawIndex(out.programs[prog], drawIndex++);
+  }
+}
+
+// Marks every command the ranges cover; false if one is covered twice.
+bool cover(const std::vector<DrawRange> &ranges, std::vector<uint8_t> &seen) {
+  for (const DrawRange &d : ranges) {
+    for (uint32_t i = d.first; i < d.first + d.count; ++i) {
+      if (i >= seen.size() || seen[i])
+        return false;
+      seen[i] = 1;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+void benchDrawSort(Run &run) {
+  constexpr uint32_t kDraws = 100'000u;
+  const std::vector<Renderable> draws = makeDraws(kDraws);
+  const glm::vec3 camPos(0.0f);
+
+  std::vector<uint64_t> keys;
+  std::vector<uint32_t> order;
+  std::vector<uint64_t> keyScratch;
+  std::vector<uint32_t> orderScratch;
+  const auto buildAndSort = [&](auto &&keyOf) {
+    keys.resize(kDraws);
+    order.resize(kDraws);
+    for (uint32_t i = 0; i < kDraws; ++i) {
+      keys[i] = keyOf(draws[i], camPos);
+      order[i] = i;
+    }
+    radixSortKeys(keys, order, keyScratch, orderScratch);
+  };
+
+  double ms = run.time([&] { buildAndSort(exactDepthKey); });
+  run.report("draws.100k", "exact depth key+radix", kDraws, ms);
+  const uint32_t exactChanges = stateChanges(draws, order);
+
+  ms = run.time([&] { buildAndSort(opaqueDrawKey); });
+  run.report("draws.100k", "bucketed key+radix", kDraws, ms);
+  const uint32_t bucketedChanges = stateChanges(draws, order);
+  const std::vector<uint32_t> radixOrder = order;
+
+  // What the radix sort replaced, on the same keys.
+  std::vector<uint64_t> unsorted(kDraws);
+  std::vector<uint32_t> stableOrder(kDraws);
+  ms = run.time([&] {
+    for (uint32_t i = 0; i < kDraws; ++i)
+      unsorted[i] = opaqueDrawKey(draws[i], camPos);
+    std::iota(stableOrder.begin(), stableOrder.end(), 0u);
+    std::stable_sort(
+        stableOrder.begin(), stableOrder.end(),
+        [&](uint32_t a, uint32_t b) { return unsorted[a] < unsorted[b]; });
+  });
+  run.report("draws.100k", "bucketed key+stable_sort", kDraws, ms);
+
+  std::printf("draws: %u state changes with exact depth keys, %u bucketed\n",
+              exactChanges, bucketedChanges);
+  run.check(radixOrder == stableOrder,
+            "draws: radix sort order differs from std::stable_sort");
+  run.check(bucketedChanges * 2u < exactChanges,
+            "draws: bucketed keys saved too few state changes (" +
+                std::to_string(bucketedChanges) + " vs " +
+                std::to_string(exactChanges) + ")");
+
+  // Depth buckets still run front to back.
+  uint32_t backwards = 0;
+  for (uint32_t i = 1; i < kDraws; ++i) {
+    const uint32_t a =
+        drawKeyDepthBucket(drawKeyDistanceBits(draws[radixOrder[i - 1]], camPos));
+    const uint32_t b =
+        drawKeyDepthBucket(drawKeyDistanceBits(draws[radixOrder[i]], camPos));
+    if (b < a)
+      ++backwards;
+  }
+  run.check(backwards == 0, "draws: " + std::to_string(backwards) +
+                                " draws sorted into a nearer depth bucket");
+}
+
+void benchMultiDraw(Run &run) {
+  constexpr uint32_t kDraws = 100'000u;
+  std::vector<Renderable> draws = makeDraws(kDraws);
+  for (uint32_t i = 0; i < kDraws; i += 100u)
+    draws[i].isCamera = true;
+  const glm::vec3 camPos(0.0f);
+  std::vector<uint64_t> keys(kDraws);
+  std::vector<uint32_t> order(kDraws);
+  for (uint32_t i = 0; i < kDraws; ++i) {
+    keys[i] = opaqueDrawKey(draws[i], camPos);
+    order[i] = i;
+  }
+  std::vector<uint64_t> keyScratch;
+  std::vector<uint32_t> orderScratch;
+  radixSortKeys(keys, order, keyScratch, orderScratch);
+  const std::vector<GLMeshRange> meshes = poolRanges();
+
+  // One command per draw, as EngineContext builds the indirect buffer.
+  std::vector<DrawIndirectCmd> cmds;
+  double ms = run.time([&] {
+    cmds.clear();
+    cmds.reserve(kDraws);
+    for (uint32_t i : order) {
+      const GLMeshRange &mesh = meshes[uint32_t(draws[i].mesh)];
+      DrawIndirectCmd cmd{};
+      cmd.count = mesh.indexCount;
+      cmd.instanceCount = 1;
+      cmd.firstIndex = mesh.firstIndex;
+      cmd.baseVertex = mesh.baseVertex;
+      cmd.baseInstance = uint32_t(cmds.size());
+      cmds.push_back(cmd);
+    }
+  });
+  run.report("mdi.100k", "build commands", kDraws, ms);
+
+  ForwardBatches forward;
+  forward.programs.resize(1u + 256u / 4u);
+  ms = run.time([&] { collectForward(draws, order, forward); });
+  run.report("mdi.100k", "forward ranges", kDraws, ms);
+
+  std::vector<DrawRange> depth;
+  ms = run.time([&] {
+    depth.clear();
+    uint32_t drawIndex = 0;
+    for (uint32_t i : order) {
+      if (!draws[i].isCamera)
+        appendDrawIndex(depth, drawIndex);
+      drawIndex++;
+    }
+  });
+  run.report("mdi.100k", "depth pre-pass ranges", kDraws, ms);
+
+  // Shadow casters go through MultiDrawBatch, models alongside.
+  MultiDrawBatch shadow;
+  ms = run.time([&] {
+    shadow.reset();
+    for (uint32_t i : order) {
+      if (!draws[i].isCamera)
+        shadow.add(meshes[uint32_t(draws[i].mesh)], draws[i].model);
+    }
+  });
+  run.report("mdi.100k", "shadow batch add", kDraws, ms);
+
+  size_t forwardCalls = forward.cameras.size();
+  for (const std::vector<DrawRange> &ranges : forward.programs)
+    forwardCalls += ranges.size();
+  std::printf("mdi: forward %zu multi-draws for %u commands, depth pre-pass "
+              "%zu\n",
+              forwardCalls, kDraws, depth.size());
+
+  bool cmdsOk = cmds.size() == kDraws;
+  for (uint32_t i = 0; cmdsOk && i < kDraws; ++i) {
+    const GLMeshRange &mesh = meshes[uint32_t(draws[order[i]].mesh)];
+    cmdsOk = cmds[i].baseInstance == i && cmds[i].instanceCount == 1u &&
+             cmds[i].firstIndex == mesh.firstIndex &&
+             cmds[i].count == mesh.indexCount &&
+             cmds[i].baseVertex == mesh.baseVertex;
+  }
+  run.check(cmdsOk, "mdi: an indirect command doesn't match its draw");
+
+  // Every command is drawn exactly once per pass, cameras only by the
+  // forward pass.
+  std::vector<uint8_t> seen(kDraws, 0u);
+  bool once = cover(forward.cameras, seen);
+  for (const std::vector<DrawRange> &ranges : forward.programs)
+    once = cover(ranges, seen) && once;
+  run.check(once && std::find(seen.begin(), seen.end(), 0u) == seen.end(),
+            "mdi: forward ranges miss or repeat a command");
+  std::fill(seen.begin(), seen.end(), 0u);
+  bool depthOk = cover(depth, seen);
+  for (uint32_t i = 0; depthOk && i < kDraws; ++i)
+    depthOk = seen[i] == (draws[order[i]].isCamera ? 0u : 1u);
+  run.check(depthOk, "mdi: depth pre-pass ranges don't cover the non-camera "
+                     "commands exactly");
+  run.check(forwardCalls * 4u < kDraws,
+            "mdi: " + std::to_string(forwardCalls) +
+                " forward multi-draws, batching saved too little");
+}
+
+} // namespace Nyx::MicroBench
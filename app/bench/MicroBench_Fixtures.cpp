@@ -0,0 +1,69 @@
+#include "MicroBench_Impl.h"
+
+#include "scene/World.h"
+
+namespace Nyx::MicroBench {
+
+ScratchDir::ScratchDir(const char *name)
+    : m_path(std::filesystem::temp_directory_path() / name) {
+  std::error_code ec;
+  std::filesystem::remove_all(m_path, ec);
+  std::filesystem::create_directories(m_path, ec);
+}
+
+ScratchDir::~ScratchDir() {
+  std::error_code ec;
+  std::filesystem::remove_all(m_path, ec);
+}
+
+void buildScene(World &w, uint32_t n) {
+  w.clear();
+  EntityID parent = InvalidEntity;
+  for (uint32_t i = 0; i < n; ++i) {
+    const EntityID e = w.createEntity("Prop " + std::to_string(i % 64u));
+    if (i % 8u != 0)
+      w.setParent(e, parent);
+    parent = e;
+    CTransform &t = w.transform(e);
+    t.translation = glm::vec3(float(i % 100u), float(i / 100u), 0.0f);
+    if (i % 2u == 0) {
+      CMesh &m = w.ensureMesh(e);
+      m.submeshes[0].type = ProcMeshType(i % 3u);
+      m.submeshes[0].materialAssetPath =
+          "/Game/Materials/M_" + std::to_string(i % 16u);
+    }
+  }
+  w.updateTransforms();
+  w.clearEvents();
+}
+
+SceneDigest describeScene(const World &w) {
+  SceneDigest out;
+  out.reserve(w.alive().size());
+  for (EntityID e : w.alive()) {
+    SavedEntity &s = out[w.uuid(e).value];
+    s.name = w.name(e).name;
+    s.parent = w.uuid(w.parentOf(e)).value;
+    s.translation = w.transform(e).translation;
+    s.hidden = w.transform(e).hidden;
+    if (w.hasMesh(e)) {
+      for (const MeshSubmesh &sm : w.mesh(e).submeshes)
+        s.materials.push_back(sm.materialAssetPath);
+    }
+  }
+  return out;
+}
+
+uint32_t sceneMismatches(const SceneDigest &want, const SceneDigest &got) {
+  uint32_t wrong = 0;
+  for (const auto &[uuid, s] : want) {
+    auto it = got.find(uuid);
+    if (it == got.end() || !(it->second == s))
+      ++wrong;
+  }
+  for (const auto &[uuid, s] : got)
+    wrong += want.contains(uuid) ? 0u : 1u;
+  return wrong;
+}
+
+} // namespace Nyx::MicroBench
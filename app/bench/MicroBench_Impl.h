@@ -0,0 +1,142 @@
+#pragma once
+
+// Internal to the MicroBench_*.cpp files.
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nyx {
+class World;
+}
+
+namespace Nyx::MicroBench {
+
+struct Row {
+  std::string bench;
+  std::string variant;
+  uint64_t items = 0;
+  double ms = 0.0; // median
+};
+
+class Run final {
+public:
+  explicit Run(uint32_t repeats) : m_repeats(repeats ? repeats : 1u) {}
+
+  // Median wall time of `repeats` calls to body(); setup() runs untimed
+  // before each one.
+  template <class Setup, class Body> double time(Setup &&setup, Body &&body) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> ms(m_repeats);
+    for (double &m : ms) {
+      setup();
+      const Clock::time_point t0 = Clock::now();
+      body();
+      m = std::chrono::duration<double, std::milli>(Clock::now() - t0)
+              .count();
+    }
+    std::nth_element(ms.begin(), ms.begin() + ms.size() / 2, ms.end());
+    return ms[ms.size() / 2];
+  }
+  template <class Body> double time(Body &&body) {
+    return time([] {}, body);
+  }
+
+  void report(std::string bench, std::string variant, uint64_t items,
+              double ms);
+  const std::vector<Row> &rows() const { return m_rows; }
+
+  // Correctness checks ride along with the timings: a failed one is printed
+  // and makes nyx_bench --micro exit non-zero. Returns `ok`.
+  bool check(bool ok, const std::string &what);
+  uint32_t failures() const { return m_failures; }
+
+private:
+  uint32_t m_repeats;
+  uint32_t m_failures = 0;
+  std::vector<Row> m_rows;
+};
+
+// Keeps a result alive so the timed loop is not optimized away.
+void sink(uint64_t v);
+
+// Fixed-seed xorshift, so every run times the same shuffles.
+struct Rng final {
+  uint32_t state = 0x2545F491u;
+  uint32_t next() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+  uint32_t below(uint32_t n) { return uint32_t((uint64_t(next()) * n) >> 32); }
+  template <class T> void shuffle(std::vector<T> &v) {
+    for (uint32_t i = (uint32_t)v.size(); i > 1; --i)
+      std::swap(v[i - 1], v[below(i)]);
+  }
+};
+
+// ---- Shared fixtures (MicroBench_Fixtures.cpp) ----
+
+// An empty directory under the system temp dir, removed with everything in it
+// when the case is done.
+class ScratchDir final {
+public:
+  explicit ScratchDir(const char *name);
+  ~ScratchDir();
+  ScratchDir(const ScratchDir &) = delete;
+  ScratchDir &operator=(const ScratchDir &) = delete;
+
+  const std::filesystem::path &path() const { return m_path; }
+  std::string file(const char *name) const { return (m_path / name).string(); }
+
+private:
+  std::filesystem::path m_path;
+};
+
+// Forest of 8-deep chains; every other entity has a mesh, names repeat so the
+// string table stays small like in a real level. Transforms are up to date
+// and no events are pending.
+void buildScene(World &w, uint32_t n);
+
+// What a save has to keep of each entity, by UUID.
+struct SavedEntity final {
+  std::string name;
+  uint64_t parent = 0;
+  glm::vec3 translation{};
+  bool hidden = false;
+  std::vector<std::string> materials;
+
+  bool operator==(const SavedEntity &) const = default;
+};
+using SceneDigest = std::unordered_map<uint64_t, SavedEntity>;
+
+SceneDigest describeScene(const World &w);
+// Entities of `want` that `got` lacks or holds differently, plus any extra
+// ones in `got`.
+uint32_t sceneMismatches(const SceneDigest &want, const SceneDigest &got);
+
+// One function per case, defined next to the systems they cover.
+void benchComponentStorage(Run &run); // MicroBench_World.cpp
+void benchTransforms(Run &run);       // MicroBench_World.cpp
+void benchWorldChurn(Run &run);       // MicroBench_World.cpp
+void benchMaterialOptimizer(Run &run); // MicroBench_Material.cpp
+void benchMaterialGLSL(Run &run);      // MicroBench_Material.cpp
+void benchTextureCooker(Run &run);     // MicroBench_Texture.cpp
+void benchTexturePools(Run &run);      // MicroBench_Texture.cpp
+void benchSceneSave(Run &run);         // MicroBench_Scene.cpp
+void benchSceneLoad(Run &run);         // MicroBench_Scene.cpp
+void benchSceneDecodeScaling(Run &run); // MicroBench_Scene.cpp
+void benchSceneSnapshot(Run &run);     // MicroBench_Scene.cpp
+void benchSceneCodec(Run &run);        // MicroBench_Scene.cpp
+void benchDrawSort(Run &run);          // MicroBench_Draws.cpp
+void benchMultiDraw(Run &run);         // MicroBench_Draws.cpp
+void benchBVH(Run &run);               // MicroBench_BVH.cpp
+
+} // namespace Nyx::MicroBench
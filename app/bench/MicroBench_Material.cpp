@@ -0,0 +1,460 @@
+#include "MicroBench_Impl.h"
+
+#include "render/gl/ShaderSourceLoader.h"
+#include "render/material/MaterialGraphCPU.h"
+#include "render/material/MaterialGraphGLSL.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+
+namespace Nyx::MicroBench {
+
+namespace {
+
+// ---- Material graph optimizer ----
+
+// Editor-style graphs, wired the way MaterialSystem's graph UI does it.
+class GraphBuilder final {
+public:
+  MatNodeID node(MatNodeType type, glm::vec4 f = glm::vec4(0.0f),
+                 glm::uvec4 u = glm::uvec4(0u)) {
+    MatNode n{};
+    n.id = m_g.nextNodeId++;
+    n.type = type;
+    n.f = f;
+    n.u = u;
+    m_g.nodes.push_back(n);
+    return n.id;
+  }
+  MatNodeID constant(float x) {
+    return node(MatNodeType::ConstFloat, glm::vec4(x, 0.0f, 0.0f, 0.0f));
+  }
+  void link(MatNodeID from, uint32_t fromSlot, MatNodeID to,
+            uint32_t toSlot) {
+    m_g.links.push_back(
+        MatLink{m_g.nextLinkId++, MatPin{from, fromSlot}, MatPin{to, toSlot}});
+  }
+  MatNodeID op(MatNodeType type, MatNodeID a, MatNodeID b = 0,
+               MatNodeID c = 0) {
+    const MatNodeID id = node(type);
+    const MatNodeID in[3] = {a, b, c};
+    for (uint32_t s = 0; s < 3; ++s)
+      if (in[s])
+        link(in[s], 0, id, s);
+    return id;
+  }
+
+  // SurfaceOutput slots: base, metallic, roughness, normal, ao, emissive,
+  // alpha. 0 leaves a slot on its default.
+  MaterialGraph finish(std::initializer_list<MatNodeID> slots) {
+    const MatNodeID out = node(MatNodeType::SurfaceOutput);
+    uint32_t s = 0;
+    for (MatNodeID src : slots) {
+      if (src)
+        link(src, 0, out, s);
+      ++s;
+    }
+    return m_g;
+  }
+
+private:
+  MaterialGraph m_g{};
+};
+
+constexpr uint32_t swizzleMask(uint32_t x, uint32_t y, uint32_t z,
+                               uint32_t w) {
+  return x | (y << 8) | (z << 16) | (w << 24);
+}
+
+// Builtins and wiring: nothing folds, only CSE and register packing apply.
+MaterialGraph graphInputs() {
+  GraphBuilder b;
+  const MatNodeID uv = b.node(MatNodeType::UV0);
+  const MatNodeID n = b.node(MatNodeType::NormalWS);
+  const MatNodeID v = b.node(MatNodeType::ViewDirWS);
+  const MatNodeID h = b.op(MatNodeType::Normalize3,
+                           b.op(MatNodeType::Add, n, v));
+  const MatNodeID u = b.node(MatNodeType::Channel, glm::vec4(0.0f),
+                             glm::uvec4(0u, 0u, 0u, 0u));
+  b.link(uv, 0, u, 0);
+  const MatNodeID split = b.node(MatNodeType::Split);
+  b.link(uv, 0, split, 0);
+  const MatNodeID rough = b.node(MatNodeType::OneMinus);
+  b.link(split, 1, rough, 0);
+  const MatNodeID swz = b.node(MatNodeType::Swizzle, glm::vec4(0.0f),
+                               glm::uvec4(swizzleMask(2, 1, 0, 3), 0, 0, 0));
+  b.link(v, 0, swz, 0);
+  // The same N.V twice; CSE keeps one.
+  const MatNodeID ndv = b.op(MatNodeType::Clamp01,
+                             b.op(MatNodeType::Dot3, n, v));
+  const MatNodeID ndv2 = b.op(MatNodeType::Clamp01,
+                              b.op(MatNodeType::Dot3, n, v));
+  const MatNodeID ao = b.op(MatNodeType::Max, ndv, ndv2);
+  return b.finish({h, u, rough, n, ao, swz, ndv});
+}
+
+// Every constant node and math op on constants: folds to Const4s only.
+MaterialGraph graphConstants() {
+  GraphBuilder b;
+  const MatNodeID c3 =
+      b.node(MatNodeType::ConstVec3, glm::vec4(0.2f, 0.4f, 0.6f, 0.0f));
+  const MatNodeID col =
+      b.node(MatNodeType::ConstColor, glm::vec4(0.9f, 0.5f, 0.1f, 0.0f));
+  const MatNodeID c4 =
+      b.node(MatNodeType::ConstVec4, glm::vec4(1.5f, -0.5f, 2.0f, 0.25f));
+  const MatNodeID t = b.constant(0.3f);
+  const MatNodeID base = b.op(MatNodeType::Lerp, c3, col, t);
+  const MatNodeID metal = b.op(MatNodeType::Pow, b.constant(0.5f),
+                               b.constant(2.2f));
+  const MatNodeID rough = b.op(
+      MatNodeType::Clamp01,
+      b.op(MatNodeType::Div, b.op(MatNodeType::Sub, c4, t), b.constant(3.0f)));
+  const MatNodeID normal = b.op(MatNodeType::Normalize3, c4);
+  const MatNodeID ao = b.op(MatNodeType::OneMinus,
+                            b.op(MatNodeType::Dot3, c3, c3));
+  const MatNodeID emis = b.op(MatNodeType::Min,
+                              b.op(MatNodeType::Mul, col, c4),
+                              b.op(MatNodeType::Max, c3, t));
+  return b.finish({base, metal, rough, normal, ao, emis, t});
+}
+
+// x+0, x-0, x*1, x/1 around live inputs, plus a subgraph nothing reads.
+MaterialGraph graphIdentities() {
+  GraphBuilder b;
+  const MatNodeID uv = b.node(MatNodeType::UV0);
+  const MatNodeID n = b.node(MatNodeType::NormalWS);
+  const MatNodeID zero = b.constant(0.0f);
+  const MatNodeID one =
+      b.node(MatNodeType::ConstVec4, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+  const MatNodeID x = b.op(
+      MatNodeType::Div,
+      b.op(MatNodeType::Mul,
+           b.op(MatNodeType::Sub, b.op(MatNodeType::Add, uv, zero), zero),
+           one),
+      one);
+  const MatNodeID y = b.op(MatNodeType::Add, zero,
+                           b.op(MatNodeType::Mul, one, n));
+  // Dead: computed, never wired to the output.
+  b.op(MatNodeType::Pow, b.op(MatNodeType::Add, x, y), b.constant(3.0f));
+  b.op(MatNodeType::Normalize3, y);
+  const MatNodeID base = b.op(MatNodeType::Clamp01, x);
+  return b.finish({base, 0, b.op(MatNodeType::OneMinus, x), y, 0, 0, 0});
+}
+
+// Every texture node; color, MRA and normal maps sampled twice per UV.
+MaterialGraph graphTextures() {
+  GraphBuilder b;
+  const MatNodeID tiling =
+      b.node(MatNodeType::ConstVec4, glm::vec4(2.0f, 3.0f, 0.0f, 0.0f));
+  const MatNodeID uv = b.op(MatNodeType::Mul, b.node(MatNodeType::UV0),
+                            tiling);
+  const auto tex = [&](MatNodeType type, uint32_t index, uint32_t srgb) {
+    const MatNodeID id =
+        b.node(type, glm::vec4(0.0f), glm::uvec4(index, srgb, 0u, 0u));
+    b.link(uv, 0, id, 0);
+    return id;
+  };
+  const MatNodeID albedo = tex(MatNodeType::Texture2D, 0, 1);
+  const MatNodeID albedo2 = tex(MatNodeType::Texture2D, 0, 1);
+  const MatNodeID mask = tex(MatNodeType::Texture2D, 1, 0);
+  const MatNodeID mra = tex(MatNodeType::TextureMRA, 2, 0);
+  const MatNodeID mra2 = tex(MatNodeType::TextureMRA, 2, 0);
+  const MatNodeID nrm = tex(MatNodeType::NormalMap, 3, 0);
+  b.link(b.constant(0.75f), 0, nrm, 2);
+  const MatNodeID nrm2 = tex(MatNodeType::NormalMap, 3, 0);
+
+  const MatNodeID base = b.op(MatNodeType::Lerp, albedo, albedo2, mask);
+  const MatNodeID metal = b.node(MatNodeType::Channel, glm::vec4(0.0f),
+                                 glm::uvec4(0u, 0u, 0u, 0u));
+  b.link(mra, 0, metal, 0);
+  const MatNodeID split = b.node(MatNodeType::Split);
+  b.link(mra2, 0, split, 0);
+  const MatNodeID rough = b.node(MatNodeType::Max);
+  b.link(split, 1, rough, 0);
+  b.link(b.constant(0.05f), 0, rough, 1);
+  const MatNodeID normal = b.op(MatNodeType::Normalize3,
+                                b.op(MatNodeType::Add, nrm, nrm2));
+  const MatNodeID ao = b.node(MatNodeType::OneMinus);
+  b.link(split, 2, ao, 0);
+  const MatNodeID emis = b.op(MatNodeType::Mul, mask, b.constant(0.2f));
+  return b.finish({base, metal, rough, normal, ao, emis, mask});
+}
+
+// Constants mixed into live math, so folding stops partway.
+MaterialGraph graphMixed() {
+  GraphBuilder b;
+  const MatNodeID uv = b.node(MatNodeType::UV0);
+  const MatNodeID n = b.node(MatNodeType::NormalWS);
+  const MatNodeID v = b.node(MatNodeType::ViewDirWS);
+  const MatNodeID k = b.op(MatNodeType::Mul, b.constant(2.0f),
+                           b.constant(3.5f));
+  const MatNodeID tintA =
+      b.node(MatNodeType::ConstColor, glm::vec4(0.8f, 0.3f, 0.1f, 0.0f));
+  const MatNodeID tintB =
+      b.node(MatNodeType::ConstColor, glm::vec4(0.1f, 0.4f, 0.9f, 0.0f));
+  MatNodeID x = b.op(MatNodeType::Mul, uv, k);
+  for (int i = 0; i < 4; ++i) {
+    x = b.op(MatNodeType::Sub, x, b.op(MatNodeType::Min, x, b.constant(1.0f)));
+    x = b.op(MatNodeType::OneMinus, b.op(MatNodeType::Clamp01, x));
+  }
+  const MatNodeID fres = b.op(
+      MatNodeType::Pow,
+      b.op(MatNodeType::OneMinus,
+           b.op(MatNodeType::Clamp01, b.op(MatNodeType::Dot3, n, v))),
+      b.op(MatNodeType::Add, b.constant(4.0f), b.constant(1.0f)));
+  const MatNodeID base = b.op(MatNodeType::Lerp, tintA, tintB, x);
+  const MatNodeID rough = b.op(MatNodeType::Div, x, k);
+  const MatNodeID emis = b.op(MatNodeType::Mul, tintB, fres);
+  return b.finish({base, fres, rough, 0, 0, emis, 0});
+}
+
+struct TestGraph final {
+  const char *name;
+  MaterialGraph graph;
+};
+
+void makeTextures(MatCPUImageTextures &textures) {
+  constexpr uint32_t kSize = 64;
+  Rng rng;
+  for (uint32_t t = 0; t < 4; ++t) {
+    std::vector<uint8_t> px(kSize * kSize * 4);
+    for (uint8_t &p : px)
+      p = uint8_t(rng.next() >> 24);
+    textures.set(t, kSize, kSize, std::move(px));
+  }
+}
+
+std::vector<MatCPUSample> makeSamples(uint32_t count) {
+  std::vector<MatCPUSample> samples(count);
+  Rng rng;
+  const auto unit = [&] { return float(rng.next() >> 8) / float(1u << 24); };
+  for (MatCPUSample &s : samples) {
+    s.uv = {unit() * 2.0f - 0.5f, unit() * 2.0f - 0.5f};
+    s.normal = {unit() - 0.5f, unit() - 0.5f, 0.25f + unit()};
+    s.viewDir = {unit() - 0.5f, unit() - 0.5f, 0.25f + unit()};
+    s.tangent = {1.0f, unit() - 0.5f, 0.0f, unit() < 0.5f ? -1.0f : 1.0f};
+  }
+  return samples;
+}
+
+// Folded constants come from glm on the host and the VM does the same math
+// per lane, so allow a few ULPs; everything else must match exactly.
+bool sameValue(float a, float b) {
+  return std::fabs(a - b) <= 1e-5f * std::max(1.0f, std::fabs(a));
+}
+
+uint32_t countMismatches(const std::vector<MatCPUSurface> &ref,
+                         const std::vector<MatCPUSurface> &opt) {
+  uint32_t bad = 0;
+  for (size_t i = 0; i < ref.size(); ++i) {
+    const MatCPUSurface &r = ref[i];
+    const MatCPUSurface &o = opt[i];
+    const float a[] = {r.baseColor.x, r.baseColor.y, r.baseColor.z,
+                       r.metallic,    r.roughness,   r.ao,
+                       r.emissive.x,  r.emissive.y,  r.emissive.z,
+                       r.normalWS.x,  r.normalWS.y,  r.normalWS.z,
+                       r.alpha};
+    const float b[] = {o.baseColor.x, o.baseColor.y, o.baseColor.z,
+                       o.metallic,    o.roughness,   o.ao,
+                       o.emissive.x,  o.emissive.y,  o.emissive.z,
+                       o.normalWS.x,  o.normalWS.y,  o.normalWS.z,
+                       o.alpha};
+    for (size_t k = 0; k < std::size(a); ++k)
+      bad += sameValue(a[k], b[k]) ? 0u : 1u;
+  }
+  return bad;
+}
+
+// ---- GLSL variants ----
+
+void writeText(const std::filesystem::path &path, const char *text) {
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream(path, std::ios::binary) << text;
+}
+
+// A fragment shader with nested includes, one included twice, and a pair
+// of headers that include each other.
+void writeShaderTree(const std::filesystem::path &root) {
+  writeText(root / "base.frag", "#version 460 core\n"
+                                "#include \"inc/common.glsl\"\n"
+                                "#include \"inc/leaf.glsl\"\n"
+                                "void main() {}\n");
+  writeText(root / "inc/common.glsl", "#include \"inc/leaf.glsl\"\n"
+                                      "float common_fn();\n");
+  writeText(root / "inc/leaf.glsl", "float leaf_fn();\n");
+  writeText(root / "cycle.frag", "#version 460 core\n"
+                                 "#include \"inc/cycle_a.glsl\"\n");
+  writeText(root / "inc/cycle_a.glsl", "#include \"inc/cycle_b.glsl\"\n");
+  writeText(root / "inc/cycle_b.glsl", "#include \"inc/cycle_a.glsl\"\n");
+}
+
+// Expanded sources must not depend on the loader instance or its cache.
+void checkShaderLoader(Run &run, const std::filesystem::path &root) {
+  ShaderSourceLoader cached;
+  cached.setRoot(root.string());
+  ShaderSourceLoader uncached;
+  uncached.setRoot(root.string());
+  uncached.setCacheEnabled(false);
+
+  const ShaderSourceLoader::LoadResult a = cached.loadExpanded("base.frag");
+  const ShaderSourceLoader::LoadResult b = cached.loadExpanded("base.frag");
+  const ShaderSourceLoader::LoadResult c = uncached.loadExpanded("base.frag");
+  if (!run.check(a.ok && b.ok && c.ok,
+                 "matglsl: base.frag won't expand: " + a.error + c.error))
+    return;
+  run.check(a.expandedSource == b.expandedSource &&
+                a.expandedSource == c.expandedSource && a.fileDeps == b.fileDeps &&
+                a.fileDeps == c.fileDeps,
+            "matglsl: expanding the same shader twice gave different text");
+  const std::string &src = a.expandedSource;
+  const size_t leaf = src.find("float leaf_fn();");
+  const size_t common = src.find("float common_fn();");
+  run.check(src.find("#include") == std::string::npos &&
+                leaf != std::string::npos && common != std::string::npos &&
+                leaf < common,
+            "matglsl: includes expanded out of order");
+  run.check(!uncached.loadExpanded("cycle.frag").ok,
+            "matglsl: an include cycle expanded");
+
+  double ms = run.time([&] { sink(cached.loadExpanded("base.frag").ok); });
+  run.report("matglsl.loader", "cached expand", 1u, ms);
+  ms = run.time([&] { sink(uncached.loadExpanded("base.frag").ok); });
+  run.report("matglsl.loader", "uncached expand", 1u, ms);
+}
+
+} // namespace
+
+void benchMaterialGLSL(Run &run) {
+  const TestGraph graphs[] = {
+      {"inputs", graphInputs()},         {"constants", graphConstants()},
+      {"identities", graphIdentities()}, {"textures", graphTextures()},
+      {"mixed", graphMixed()},
+  };
+  const ScratchDir scratch("nyx_micro_shaders");
+  const std::filesystem::path &root = scratch.path();
+  writeShaderTree(root);
+  checkShaderLoader(run, root);
+
+  ShaderSourceLoader loader;
+  loader.setRoot(root.string());
+  const std::string base = loader.loadExpanded("base.frag").expandedSource;
+  const std::string define =
+      std::string("#define ") + kMaterialSpecializedDefine + " 1\n";
+
+  // Each graph compiled by two compilers must hash and generate the same;
+  // different graphs must not collide, or the program cache shares them.
+  std::vector<uint64_t> hashes;
+  std::vector<std::string> texts;
+  for (const TestGraph &t : graphs) {
+    const std::string name = "matglsl." + std::string(t.name);
+    CompiledMaterialGraph first;
+    CompiledMaterialGraph second;
+    MatCompilerError err;
+    MaterialGraphCompiler a;
+    MaterialGraphCompiler b;
+    if (!run.check(a.compile(t.graph, first, &err) &&
+                       b.compile(MaterialGraph(t.graph), second, &err),
+                   name + ": compile: " + err.msg))
+      continue;
+    const std::string text = generateMaterialGLSL(first);
+    run.check(first.hash == second.hash &&
+                  text == generateMaterialGLSL(second) &&
+                  text == generateMaterialGLSL(first),
+              name + ": the same graph generated different GLSL");
+    run.check(text.find(kMaterialSpecializedFn) != std::string::npos,
+              name + ": generated GLSL lacks " +
+                  std::string(kMaterialSpecializedFn));
+
+    const std::string variant = specializeForwardSource(base, text);
+    run.check(variant == specializeForwardSource(base, text) &&
+                  variant.compare(variant.find('\n') + 1, define.size(),
+                                  define) == 0 &&
+                  variant.ends_with(text),
+              name + ": specialized source is malformed or unstable");
+
+    const double ms = run.time([&] {
+      sink(specializeForwardSource(base, generateMaterialGLSL(first)).size());
+    });
+    run.report(name, std::to_string(first.nodes.size()) + " ops to GLSL", 1u,
+               ms);
+    hashes.push_back(first.hash);
+    texts.push_back(text);
+  }
+  for (size_t i = 0; i < hashes.size(); ++i) {
+    for (size_t j = i + 1; j < hashes.size(); ++j) {
+      run.check(hashes[i] != hashes[j] && texts[i] != texts[j],
+                "matglsl: graphs " + std::string(graphs[i].name) + " and " +
+                    graphs[j].name + " share a variant");
+    }
+  }
+  run.check(specializeForwardSource("void main() {}\n", "").empty(),
+            "matglsl: specialized a shader without #version");
+}
+
+void benchMaterialOptimizer(Run &run) {
+  const TestGraph graphs[] = {
+      {"inputs", graphInputs()},         {"constants", graphConstants()},
+      {"identities", graphIdentities()}, {"textures", graphTextures()},
+      {"mixed", graphMixed()},
+  };
+  MatCPUImageTextures textures;
+  makeTextures(textures);
+  constexpr uint32_t kSamples = 1u << 16;
+  const std::vector<MatCPUSample> samples = makeSamples(kSamples);
+  std::vector<MatCPUSurface> ref(kSamples);
+  std::vector<MatCPUSurface> opt(kSamples);
+
+  for (const TestGraph &t : graphs) {
+    const std::string name = t.name;
+    MaterialGraphCompiler compiler;
+    CompiledMaterialGraph naive;
+    CompiledMaterialGraph optimized;
+    MatCompilerError err;
+    compiler.setOptimize(false);
+    if (!run.check(compiler.compile(t.graph, naive, &err),
+                   "matopt." + name + ": naive compile: " + err.msg))
+      continue;
+    compiler.setOptimize(true);
+    if (!run.check(compiler.compile(t.graph, optimized, &err),
+                   "matopt." + name + ": optimized compile: " + err.msg))
+      continue;
+    run.check(optimized.nodes.size() < naive.nodes.size(),
+              "matopt." + name + ": optimizer removed no ops");
+
+    // Both paths, so a lane-width bug cannot hide behind the optimizer.
+    for (MatCPUPath path : {MatCPUPath::Scalar, matCPUBestPath()}) {
+      const bool evaluated =
+          evalMaterialCPU(naive, samples.data(), ref.data(), kSamples,
+                          &textures, path) &&
+          evalMaterialCPU(optimized, samples.data(), opt.data(), kSamples,
+                          &textures, path);
+      if (!run.check(evaluated, "matopt." + name + ": CPU VM rejected it"))
+        break;
+      const uint32_t bad = countMismatches(ref, opt);
+      run.check(bad == 0, "matopt." + name + " (" + matCPUPathName(path) +
+                              "): " + std::to_string(bad) +
+                              " values differ from the unoptimized program");
+    }
+
+    const std::string bench = "matopt." + name;
+    double ms = run.time([&] {
+      evalMaterialCPU(naive, samples.data(), ref.data(), kSamples, &textures);
+    });
+    run.report(bench, std::to_string(naive.nodes.size()) + " ops", kSamples,
+               ms);
+    ms = run.time([&] {
+      evalMaterialCPU(optimized, samples.data(), opt.data(), kSamples,
+                      &textures);
+    });
+    run.report(bench,
+               std::to_string(optimized.nodes.size()) + " ops optimized",
+               kSamples, ms);
+  }
+}
+
+} // namespace Nyx::MicroBench
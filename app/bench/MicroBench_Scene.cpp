@@ -0,0 +1,622 @@
+#include "MicroBench_Impl.h"
+
+#include "animation/AnimationSystem.h"
+#include "core/JobSystem.h"
+#include "core/Paths.h"
+#include "io/FileUtil.h"
+#include "scene/World.h"
+#include "serialization/NyxBinaryReader.h"
+#include "serialization/NyxChunkCodec.h"
+#include "serialization/NyxChunkIDs.h"
+#include "serialization/SceneSaveState.h"
+#include "serialization/SceneSerializer.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+
+namespace Nyx::MicroBench {
+
+namespace {
+
+// ---- Scene saves ----
+
+// Loads `path` into a fresh World and compares it with `w` entity by entity.
+// Tombstones and appended entities must not stop the load from seeding the
+// next incremental save.
+void checkReload(Run &run, const World &w, const std::string &path,
+                 const std::string &what) {
+  World loaded;
+  SceneSaveState seeded;
+  if (!run.check(SceneSerializer::load(path, loaded, seeded),
+                 what + ": saved scene won't load"))
+    return;
+  run.check(seeded.matchesFile(path),
+            what + ": reload would rewrite the whole file on its next save");
+  const SceneDigest want = describeScene(w);
+  const SceneDigest got = describeScene(loaded);
+  const uint32_t wrong = sceneMismatches(want, got);
+  run.check(wrong == 0,
+            what + ": reloaded " + std::to_string(got.size()) +
+                " entities for " + std::to_string(want.size()) + ", " +
+                std::to_string(wrong) + " differ");
+}
+
+struct Edit final {
+  const char *name;
+  std::function<void(World &, Rng &)> apply;
+};
+
+EntityID pick(const World &w, Rng &rng) {
+  return w.alive()[rng.below(uint32_t(w.alive().size()))];
+}
+
+// What the std::ifstream reader did before the mapped one, minus all the
+// decoding: seek to every chunk and pull its uncompressed size in through
+// one 4-byte read() per field. A lower bound for the old load path. Chunks
+// are compressed now, so a read running off the end of the file starts over
+// at the chunk; only the number of calls matters.
+uint64_t streamReadChunks(const std::string &path,
+                          const std::vector<NyxTocEntry> &toc) {
+  std::ifstream in(path, std::ios::binary);
+  uint64_t sum = 0;
+  for (const NyxTocEntry &entry : toc) {
+    const std::streamoff payload = std::streamoff(entry.offset + 16u);
+    in.seekg(payload, std::ios::beg);
+    const uint64_t words = std::max(entry.rawSize, entry.size) / 4u;
+    for (uint64_t i = 0; i < words; ++i) {
+      uint32_t v = 0;
+      if (!in.read(reinterpret_cast<char *>(&v), sizeof(v))) {
+        in.clear();
+        in.seekg(payload, std::ios::beg);
+      }
+      sum += v;
+    }
+  }
+  return sum;
+}
+
+// The same word-by-word walk through the mapped reader, after each chunk's
+// checksum and decompression: the I/O half of the current load path.
+uint64_t mappedReadChunks(const std::string &path) {
+  NyxBinaryReader r(path);
+  uint64_t magic = 0;
+  uint32_t version = 0;
+  if (!r.readSceneHeader(magic, version) || !r.loadTOC())
+    return 0;
+  uint64_t sum = 0;
+  std::vector<uint8_t> storage;
+  NyxChunkReader chunk;
+  for (const NyxTocEntry &entry : r.toc()) {
+    if (!r.openChunk(entry, storage, chunk))
+      continue;
+    while (chunk.remaining() >= 4u)
+      sum += chunk.readU32();
+  }
+  return sum;
+}
+
+// ---- Chunk codecs ----
+
+// TRNS records are 10 floats: translation, rotation, scale.
+constexpr uint8_t kTransformStrideWords = 10;
+
+// Chunks of a saved scene as the loader decodes them.
+struct RawChunk final {
+  uint32_t fourcc = 0;
+  std::vector<uint8_t> raw;
+};
+
+bool readRawChunks(const std::string &path, std::vector<RawChunk> &out) {
+  NyxBinaryReader r(path);
+  uint64_t magic = 0;
+  uint32_t version = 0;
+  if (!r.readSceneHeader(magic, version) || !r.loadTOC())
+    return false;
+  out.clear();
+  std::vector<uint8_t> storage;
+  NyxChunkReader chunk;
+  for (const NyxTocEntry &entry : r.toc()) {
+    if (!r.openChunk(entry, storage, chunk))
+      return false;
+    RawChunk &c = out.emplace_back();
+    c.fourcc = entry.fourcc;
+    if (const uint8_t *p = chunk.readView(chunk.remaining()))
+      c.raw.assign(p, p + chunk.size());
+  }
+  return true;
+}
+
+// How every chunk is stored: all raw, all LZ (what the saver does), or LZ
+// with TRNS records XOR-delta'd and split into byte planes first, as 2.0
+// files up to this build stored them.
+enum class CodecMix : uint8_t { Raw, LZ, ShuffleLZ };
+
+struct StoredChunk final {
+  NyxTocEntry entry;
+  std::vector<uint8_t> stored;
+};
+
+uint64_t encodeChunks(const std::vector<RawChunk> &chunks, CodecMix mix,
+                      std::vector<StoredChunk> &out) {
+  out.resize(chunks.size());
+  uint64_t bytes = 0;
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    const RawChunk &c = chunks[i];
+    const bool shuffle = mix == CodecMix::ShuffleLZ &&
+                         c.fourcc == static_cast<uint32_t>(NyxChunk::TRNS);
+    const NyxCodec codec = mix == CodecMix::Raw ? NyxCodec::None
+                           : shuffle            ? NyxCodec::ShuffleDeltaLZ
+                                                : NyxCodec::LZ;
+    StoredChunk &s = out[i];
+    s.entry = NyxTocEntry{};
+    s.entry.fourcc = c.fourcc;
+    s.entry.codec =
+        nyxEncodeChunk(codec, kTransformStrideWords, c.raw, s.stored);
+    s.entry.filterStride =
+        s.entry.codec == NyxCodec::ShuffleDeltaLZ ? kTransformStrideWords : 0;
+    s.entry.size = s.stored.size();
+    s.entry.rawSize = c.raw.size();
+    bytes += s.stored.size();
+  }
+  return bytes;
+}
+
+// Size and decode time of one scene's chunks under each mix, whole file and
+// TRNS alone; every mix must decode back to the same bytes.
+void codecScene(Run &run, const std::string &name, const std::string &path) {
+  std::vector<RawChunk> chunks;
+  if (!run.check(readRawChunks(path, chunks),
+                 "scenecodec." + name + ": scene won't open"))
+    return;
+  uint64_t rawBytes = 0;
+  uint64_t rawTrns = 0;
+  for (const RawChunk &c : chunks) {
+    rawBytes += c.raw.size();
+    if (c.fourcc == static_cast<uint32_t>(NyxChunk::TRNS))
+      rawTrns += c.raw.size();
+  }
+
+  const std::string bench = "scenecodec." + name;
+  const struct {
+    CodecMix mix;
+    const char *name;
+  } mixes[] = {{CodecMix::Raw, "raw"},
+               {CodecMix::LZ, "LZ"},
+               {CodecMix::ShuffleLZ, "shuffle+LZ"}};
+  std::vector<StoredChunk> stored;
+  std::vector<uint8_t> decoded;
+  for (const auto &m : mixes) {
+    const uint64_t bytes = encodeChunks(chunks, m.mix, stored);
+    uint64_t trnsBytes = 0;
+    for (const StoredChunk &c : stored) {
+      if (c.entry.fourcc == static_cast<uint32_t>(NyxChunk::TRNS))
+        trnsBytes += c.stored.size();
+    }
+    const double ms = run.time([&] {
+      for (const StoredChunk &c : stored) {
+        nyxDecodeChunk(c.entry, c.stored.data(), decoded);
+        sink(decoded.size());
+      }
+    });
+    run.report(bench, std::string(m.name) + " decode", rawBytes, ms);
+    std::printf("%s: %-10s %10llu bytes (%5.1f%%), TRNS %9llu bytes "
+                "(%5.1f%%)\n",
+                bench.c_str(), m.name, (unsigned long long)bytes,
+                rawBytes ? 100.0 * double(bytes) / double(rawBytes) : 0.0,
+                (unsigned long long)trnsBytes,
+                rawTrns ? 100.0 * double(trnsBytes) / double(rawTrns) : 0.0);
+
+    uint32_t wrong = 0;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      if (!nyxDecodeChunk(stored[i].entry, stored[i].stored.data(),
+                          decoded) ||
+          decoded != chunks[i].raw)
+        ++wrong;
+    }
+    run.check(wrong == 0, bench + ": " + std::to_string(wrong) + " " +
+                              m.name + " chunks don't round-trip");
+  }
+}
+
+} // namespace
+
+void benchSceneCodec(Run &run) {
+  const ScratchDir dir("nyx_micro_scenes");
+  const std::string path = dir.file("codec.nyxscene");
+  for (uint32_t n : {1'000u, 100'000u}) {
+    World w;
+    buildScene(w, n);
+    SceneSerializer::save(path, w);
+    codecScene(run, std::to_string(n / 1000u) + "k", path);
+
+    // The same props placed by hand: off the grid, turned about Y.
+    Rng rng;
+    for (EntityID e : w.alive()) {
+      CTransform &t = w.transform(e);
+      t.translation.x += float(rng.below(1000u)) * 0.001f;
+      t.translation.z += float(rng.below(1000u)) * 0.001f;
+      const float yaw = float(rng.below(3600u)) * 0.1f;
+      t.rotation = glm::angleAxis(glm::radians(yaw), glm::vec3(0, 1, 0));
+    }
+    SceneSerializer::save(path, w);
+    codecScene(run, std::to_string(n / 1000u) + "k-placed", path);
+  }
+
+  // The sample project's scenes, when the engine root was found.
+  const std::filesystem::path scenes = Paths::engineRoot().empty()
+                                           ? std::filesystem::path()
+                                           : Paths::engineRoot().parent_path() /
+                                                 "project/Content/Scenes";
+  std::error_code ec;
+  for (const auto &f : std::filesystem::directory_iterator(scenes, ec)) {
+    if (f.path().extension() == ".nyxscene")
+      codecScene(run, f.path().stem().string(), f.path().string());
+  }
+}
+
+void benchSceneLoad(Run &run) {
+  const ScratchDir dir("nyx_micro_scenes");
+  const std::string path = dir.file("load.nyxscene");
+
+  for (uint32_t n : {10'000u, 100'000u, 1'000'000u}) {
+    const std::string bench = "sceneload." + std::to_string(n / 1000u) + "k";
+    World w;
+    buildScene(w, n);
+    SceneSerializer::save(path, w);
+
+    World loaded;
+    double ms = run.time([&] { SceneSerializer::load(path, loaded); });
+    run.report(bench, "mapped load", n, ms);
+    run.check(loaded.alive().size() == n,
+              bench + ": loaded " + std::to_string(loaded.alive().size()) +
+                  " entities");
+
+    std::vector<NyxTocEntry> toc;
+    {
+      NyxBinaryReader r(path);
+      uint64_t magic = 0;
+      uint32_t version = 0;
+      if (!run.check(r.readSceneHeader(magic, version) && r.loadTOC(),
+                     bench + ": saved scene has no valid TOC"))
+        continue;
+      toc = r.toc();
+    }
+    ms = run.time([&] { sink(streamReadChunks(path, toc)); });
+    run.report(bench, "ifstream field reads", n, ms);
+    ms = run.time([&] { sink(mappedReadChunks(path)); });
+    run.report(bench, "mapped field reads", n, ms);
+  }
+}
+
+void benchSceneDecodeScaling(Run &run) {
+  constexpr uint32_t kEntities = 200'000u;
+  const ScratchDir dir("nyx_micro_scenes");
+  const std::string path = dir.file("decode.nyxscene");
+
+  World w;
+  buildScene(w, kEntities);
+  SceneSerializer::save(path, w);
+  const SceneDigest want = describeScene(w);
+
+  // 1 thread is the caller alone; every step adds one pool worker. Each
+  // count must load exactly the scene the serial decode does.
+  JobSystem &jobs = JobSystem::instance();
+  const uint32_t limit = jobs.helperLimit();
+  double serialMs = 0.0;
+  for (uint32_t threads = 1; threads <= jobs.workerCount() + 1u; ++threads) {
+    jobs.setHelperLimit(threads - 1u);
+    World loaded;
+    const double ms =
+        run.time([&] { SceneSerializer::load(path, loaded); });
+    run.report("sceneload.200k", std::to_string(threads) + " threads",
+               kEntities, ms);
+    if (threads == 1)
+      serialMs = ms;
+    std::printf("sceneload: %2u threads %.2fx\n", threads,
+                ms > 0.0 ? serialMs / ms : 0.0);
+
+    const uint32_t wrong = sceneMismatches(want, describeScene(loaded));
+    run.check(wrong == 0,
+              "sceneload: " + std::to_string(threads) + " threads loaded " +
+                  std::to_string(wrong) + " entities differently");
+  }
+  jobs.setHelperLimit(limit);
+
+  // A chunk that fails to decode fails the whole load, and the scene that
+  // was open stays as it was.
+  std::vector<NyxTocEntry> trns;
+  {
+    NyxBinaryReader r(path);
+    uint64_t magic = 0;
+    uint32_t version = 0;
+    if (r.readSceneHeader(magic, version) && r.loadTOC())
+      trns = r.findAll(static_cast<uint32_t>(NyxChunk::TRNS));
+  }
+  if (!run.check(!trns.empty(), "sceneload: saved scene has no TRNS chunk"))
+    return;
+  {
+    std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+    f.seekp(std::streamoff(trns.back().offset + 16u + trns.back().size / 2u));
+    f.put(char(0x5A));
+  }
+  World loaded;
+  buildScene(loaded, 1000u);
+  const SceneDigest open = describeScene(loaded);
+  run.check(!SceneSerializer::load(path, loaded),
+            "sceneload: a scene with a damaged chunk loaded");
+  run.check(sceneMismatches(open, describeScene(loaded)) == 0,
+            "sceneload: a failed load changed the open scene");
+}
+
+void benchSceneSnapshot(Run &run) {
+  constexpr uint32_t kEntities = 100'000u;
+  const ScratchDir dir("nyx_micro_scenes");
+  const std::string inlinePath = dir.file("inline.nyxscene");
+  const std::string path = dir.file("snapshot.nyxscene");
+
+  World w;
+  buildScene(w, kEntities);
+
+  // A full save: what the main thread stalls for (capture) against what
+  // moves to the worker (write) and an inline save of the same scene.
+  SceneSaveState state;
+  SceneSaveSnapshot snap;
+  double ms = run.time([&] { SceneSerializer::save(inlinePath, w); });
+  run.report("scenesnap.100k", "full: inline save", kEntities, ms);
+  ms = run.time(
+      [&] {
+        state.reset();
+        snap = SceneSaveSnapshot{};
+      },
+      [&] { SceneSerializer::capture(path, w, state, snap); });
+  run.report("scenesnap.100k", "full: capture (main)", kEntities, ms);
+  ms = run.time(
+      [&] {
+        state.reset();
+        snap = SceneSaveSnapshot{};
+        SceneSerializer::capture(path, w, state, snap);
+      },
+      [&] { SceneSerializer::write(snap); });
+  run.report("scenesnap.100k", "full: write (worker)", kEntities, ms);
+  SceneSerializer::finish(state, snap);
+
+  std::vector<uint8_t> inlineBytes;
+  std::vector<uint8_t> snapBytes;
+  run.check(FileUtil::readFileBytes(inlinePath, inlineBytes) &&
+                FileUtil::readFileBytes(path, snapBytes) &&
+                inlineBytes == snapBytes,
+            "scenesnap: snapshot save differs from an inline save");
+
+  // A full save hands the entity order to the writer, which sorts it;
+  // entities created and renamed meanwhile reach the next delta save.
+  state.reset();
+  SceneSerializer::capture(path, w, state, snap);
+  const EntityID added = w.createEntity("Created during the save");
+  w.setParent(added, w.alive()[7]);
+  w.setName(w.alive()[11], "Renamed during the save");
+  state.observe(w.events());
+  w.clearEvents();
+  SceneSerializer::write(snap);
+  SceneSerializer::finish(state, snap);
+  SceneSerializer::save(path, w, state);
+  run.check(state.lastIncremental,
+            "scenesnap: save after a full one was not incremental");
+  {
+    World loaded;
+    run.check(SceneSerializer::load(path, loaded),
+              "scenesnap: scene saved after a full one won't load");
+    const uint32_t wrong =
+        sceneMismatches(describeScene(w), describeScene(loaded));
+    run.check(wrong == 0, "scenesnap: " + std::to_string(wrong) +
+                              " entities lost edits made during a full save");
+  }
+
+  // Edits made while the worker writes must not reach the file: it holds
+  // the scene as it was at capture.
+  SceneDigest want = describeScene(w);
+  const EntityID moved = w.alive()[kEntities / 2u];
+  w.transform(moved).translation.x += 1.0f;
+  w.transform(moved).dirty = true;
+  want[w.uuid(moved).value].translation.x += 1.0f;
+  w.updateTransforms();
+  state.observe(w.events());
+  w.clearEvents();
+  SceneSerializer::capture(path, w, state, snap);
+  for (uint32_t i = 0; i < kEntities; i += 97u)
+    w.setName(w.alive()[i], "Edited during the save");
+  w.transform(moved).translation.x += 100.0f;
+  const bool written = SceneSerializer::write(snap);
+  SceneSerializer::finish(state, snap);
+  run.check(written && state.lastIncremental,
+            "scenesnap: delta save was not written incrementally");
+  {
+    World loaded;
+    run.check(SceneSerializer::load(path, loaded),
+              "scenesnap: delta-saved scene won't load");
+    const uint32_t wrong = sceneMismatches(want, describeScene(loaded));
+    run.check(wrong == 0, "scenesnap: " + std::to_string(wrong) +
+                              " entities differ from the captured scene");
+  }
+  w.clearEvents();
+}
+
+void benchSceneSave(Run &run) {
+  constexpr uint32_t kEntities = 100'000u;
+  // Each edit touches at most 16 entity pages, plus a string page, MATL,
+  // CAMR, LITE and CATS; a full save writes kEntities / 1024 pages of each
+  // paged chunk.
+  constexpr uint32_t kMaxDeltaChunks = 24u;
+  const ScratchDir dir("nyx_micro_scenes");
+  const std::string path = dir.file("save.nyxscene");
+
+  World w;
+  buildScene(w, kEntities);
+  Rng rng;
+
+  const double fullMs =
+      run.time([&] { SceneSerializer::save(path, w); });
+  run.report("scenesave.100k", "full", kEntities, fullMs);
+  checkReload(run, w, path, "scenesave.full");
+
+  const Edit edits[] = {
+      {"move 1",
+       [](World &w, Rng &rng) {
+         const EntityID e = pick(w, rng);
+         w.transform(e).translation.x += 1.0f;
+         w.transform(e).dirty = true;
+         w.updateTransforms();
+       }},
+      {"rename 16",
+       [](World &w, Rng &rng) {
+         for (uint32_t i = 0; i < 16u; ++i)
+           w.setName(pick(w, rng), "Renamed " + std::to_string(rng.next()));
+       }},
+      {"create 16",
+       [](World &w, Rng &rng) {
+         for (uint32_t i = 0; i < 16u; ++i) {
+           const EntityID e = w.createEntity("New");
+           w.setParent(e, pick(w, rng));
+           w.ensureMesh(e).submeshes[0].materialAssetPath = "/Game/M_New";
+         }
+       }},
+      {"destroy 16",
+       [](World &w, Rng &rng) {
+         // Leaves, so the count of touched pages stays bounded.
+         for (uint32_t i = 0; i < 16u;) {
+           const EntityID e = pick(w, rng);
+           if (w.hierarchy(e).firstChild != InvalidEntity)
+             continue;
+           w.destroyEntity(e);
+           ++i;
+         }
+       }},
+      {"animate 16",
+       [](World &w, Rng &rng) {
+         // AnimationSystem writes CTransform without events; the
+         // TransformChanged the save needs only appears once the frame's
+         // updateTransforms() runs.
+         AnimationClip clip;
+         for (uint32_t i = 0; i < 16u; ++i) {
+           const EntityID e = pick(w, rng);
+           const float y = w.transform(e).translation.y;
+           AnimTrack &t = clip.tracks.emplace_back();
+           t.entity = e;
+           t.blockId = 1;
+           t.channel = AnimChannel::TranslateY;
+           t.curve.keys = {{0, y}, {10, y + 5.0f}};
+           clip.entityRanges.push_back({e, 1, 0, 10});
+         }
+         AnimationSystem anim;
+         anim.setWorld(&w);
+         anim.setActiveClip(&clip);
+         anim.setFrame(5);
+         w.updateTransforms();
+       }},
+  };
+
+  // Each repeat starts from a fresh full save, applies the edit and times
+  // only the save that follows it.
+  SceneSaveState state;
+  for (const Edit &edit : edits) {
+    const double ms = run.time(
+        [&] {
+          state.reset();
+          SceneSerializer::save(path, w, state);
+          edit.apply(w, rng);
+          state.observe(w.events());
+          w.clearEvents();
+        },
+        [&] { SceneSerializer::save(path, w, state); });
+    run.report("scenesave.100k", std::string("delta: ") + edit.name,
+               kEntities, ms);
+    std::printf("scenesave: %-10s %5u chunks written, %.1fx faster than "
+                "full\n",
+                edit.name, state.lastChunksWritten,
+                ms > 0.0 ? fullMs / ms : 0.0);
+
+    const std::string what = std::string("scenesave.") + edit.name;
+    run.check(state.lastIncremental, what + ": save was not incremental");
+    run.check(state.lastChunksWritten <= kMaxDeltaChunks,
+              what + ": rewrote " + std::to_string(state.lastChunksWritten) +
+                  " chunks");
+    checkReload(run, w, path, what);
+  }
+
+  // The delta chain must load as the same scene a full save writes.
+  const std::string fullPath = dir.file("full.nyxscene");
+  {
+    World fromDelta;
+    World fromFull;
+    run.check(SceneSerializer::save(fullPath, w) &&
+                  SceneSerializer::load(path, fromDelta) &&
+                  SceneSerializer::load(fullPath, fromFull),
+              "scenesave: delta/full comparison files won't save or load");
+    const uint32_t wrong =
+        sceneMismatches(describeScene(fromFull), describeScene(fromDelta));
+    run.check(wrong == 0, "scenesave: delta-saved scene has " +
+                              std::to_string(wrong) +
+                              " entities that differ from a full save");
+  }
+
+  // A same-size rewrite behind our back, with the old timestamp put back,
+  // still has to force a full save rather than an append onto it.
+  std::vector<uint8_t> bytes;
+  if (run.check(FileUtil::readFileBytes(path, bytes) && bytes.size() > 40u,
+                "scenesave: can't read the saved scene back")) {
+    bytes[bytes.size() - 40u] ^= 0xFFu; // last TOC entry's checksum
+    std::string err;
+    FileUtil::writeFileBytesAtomic(path, bytes.data(), bytes.size(), &err);
+    std::error_code ec;
+    std::filesystem::last_write_time(path, state.fileTime, ec);
+    run.check(!state.matchesFile(path),
+              "scenesave: a rewritten file still counts as ours");
+    SceneSerializer::save(path, w, state);
+    run.check(!state.lastIncremental,
+              "scenesave: appended to a file someone else rewrote");
+    checkReload(run, w, path, "scenesave.rewritten");
+  }
+
+  // An append cut short leaves a tail without a footer. The header's
+  // committed footer still names the last complete save, so the load finds
+  // it without walking back through the file.
+  state.reset();
+  SceneSerializer::save(path, w, state);
+  const EntityID moved = pick(w, rng);
+  w.transform(moved).translation.x += 1.0f;
+  w.transform(moved).dirty = true;
+  w.updateTransforms();
+  state.observe(w.events());
+  w.clearEvents();
+  SceneSerializer::save(path, w, state);
+  run.check(state.lastIncremental, "scenesave.torn: save was not incremental");
+  {
+    std::ofstream f(path, std::ios::binary | std::ios::app);
+    const std::vector<char> tail(8u << 20, char(0x5A));
+    f.write(tail.data(), std::streamsize(tail.size()));
+  }
+  bool recovered = false;
+  const double ms = run.time([&] {
+    NyxBinaryReader r(path);
+    uint64_t magic = 0;
+    uint32_t version = 0;
+    recovered =
+        r.readSceneHeader(magic, version) && r.loadTOC() && r.recoveredTOC();
+  });
+  run.report("scenesave.100k", "torn tail: find TOC", kEntities, ms);
+  run.check(recovered, "scenesave.torn: last complete save not recovered");
+  World loaded;
+  run.check(SceneSerializer::load(path, loaded),
+            "scenesave.torn: scene with a torn tail won't load");
+  const uint32_t wrong =
+      sceneMismatches(describeScene(w), describeScene(loaded));
+  run.check(wrong == 0, "scenesave.torn: " + std::to_string(wrong) +
+                            " entities differ from the last save");
+}
+
+} // namespace Nyx::MicroBench
@@ -0,0 +1,347 @@
+#include "MicroBench_Impl.h"
+
+#include "render/material/TextureCooker.h"
+#include "render/material/TexturePoolLayers.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+namespace Nyx::MicroBench {
+
+namespace {
+
+// ---- Texture cooking ----
+
+enum class Pattern { Color, Alpha, Normal };
+
+// Color blends two colors by smooth waves, so even the 4x4 mips stay on one
+// color line per block and any error is the codec's quantization. Alpha adds
+// an independent ramp; Normal is a field of unit bumps.
+std::vector<uint8_t> makeImage(Pattern pattern, uint32_t w, uint32_t h) {
+  std::vector<uint8_t> px(size_t(w) * h * 4);
+  const auto u8 = [](float v) {
+    return uint8_t(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+  };
+  for (uint32_t y = 0; y < h; ++y) {
+    for (uint32_t x = 0; x < w; ++x) {
+      uint8_t *p = &px[(size_t(y) * w + x) * 4];
+      const float fx = float(x) / float(w);
+      const float fy = float(y) / float(h);
+      if (pattern == Pattern::Normal) {
+        const float nx = 0.4f * std::sin(fx * 18.0f);
+        const float ny = 0.4f * std::cos(fy * 14.0f);
+        const float nz = std::sqrt(1.0f - nx * nx - ny * ny);
+        p[0] = u8(nx * 0.5f + 0.5f);
+        p[1] = u8(ny * 0.5f + 0.5f);
+        p[2] = u8(nz * 0.5f + 0.5f);
+        p[3] = 255;
+        continue;
+      }
+      const float t = 0.5f + 0.25f * std::sin(fx * 9.0f + fy * 3.0f) +
+                      0.25f * std::cos(fy * 7.0f);
+      p[0] = u8(0.9f - 0.7f * t);
+      p[1] = u8(0.2f + 0.6f * t);
+      p[2] = u8(0.4f + 0.3f * t);
+      p[3] = pattern == Pattern::Alpha ? u8(fx) : 255;
+    }
+  }
+  return px;
+}
+
+double psnr(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b) {
+  if (a.size() != b.size())
+    return 0.0;
+  double sq = 0.0;
+  for (size_t i = 0; i < a.size(); ++i) {
+    const double d = double(a[i]) - double(b[i]);
+    sq += d * d;
+  }
+  if (sq == 0.0)
+    return 99.0;
+  return 10.0 * std::log10(255.0 * 255.0 * double(a.size()) / sq);
+}
+
+struct RoundTrip final {
+  const char *name;
+  Pattern pattern;
+  bool srgb;
+  TextureCompression compression;
+  TextureCodec expect;
+  // Every level against the RGBA8 cook of the same mips. BC1/BC3 lose the
+  // most on the 16x8 level, where 4 palette entries span a whole wave.
+  double minPSNR;
+};
+
+// Cooks `img` with and without compression and checks every decoded level
+// against the uncompressed chain, which is the source mips bit for bit.
+void checkRoundTrip(Run &run, const RoundTrip &rt, uint32_t w, uint32_t h) {
+  const std::vector<uint8_t> img = makeImage(rt.pattern, w, h);
+  TextureImportSettings settings{};
+  settings.srgb = rt.srgb;
+  settings.compression = TextureCompression::Off;
+  CookedTexture ref;
+  CookedTexture cooked;
+  const bool ok = cookTexture(img.data(), w, h, settings, ref);
+  settings.compression = rt.compression;
+  const std::string what = std::string("texcook.") + rt.name;
+  if (!run.check(ok && cookTexture(img.data(), w, h, settings, cooked),
+                 what + ": cook failed"))
+    return;
+  run.check(cooked.codec == rt.expect,
+            what + ": cooked as " + textureCodecName(cooked.codec) +
+                ", expected " + textureCodecName(rt.expect));
+  run.check(cooked.levels.size() == size_t(std::bit_width(std::max(w, h))),
+            what + ": incomplete mip chain");
+
+  std::vector<uint8_t> base;
+  run.check(decodeCookedLevel(ref, 0, base) && base == img,
+            what + ": RGBA8 base level differs from the source");
+
+  std::vector<uint8_t> want;
+  std::vector<uint8_t> got;
+  double worst = 99.0;
+  for (uint32_t l = 0; l < uint32_t(cooked.levels.size()); ++l) {
+    if (!run.check(decodeCookedLevel(ref, l, want) &&
+                       decodeCookedLevel(cooked, l, got),
+                   what + ": level " + std::to_string(l) + " won't decode"))
+      return;
+    worst = std::min(worst, psnr(want, got));
+  }
+  std::printf("texcook.%s: %s, worst level %.1f dB\n", rt.name,
+              textureCodecName(cooked.codec), worst);
+  run.check(worst >= rt.minPSNR,
+            what + ": " + std::to_string(worst) + " dB is under " +
+                std::to_string(rt.minPSNR));
+}
+
+// Two cooks of the same bytes share a key and the second is a cache hit; a
+// changed byte or setting gets its own key and misses.
+void checkCache(Run &run, const std::filesystem::path &dir) {
+  TextureCookCache cache;
+  cache.setDirectory(dir);
+  std::vector<uint8_t> img = makeImage(Pattern::Color, 64, 64);
+  const TextureImportSettings settings{};
+
+  const std::string key = textureCookKey(img.data(), img.size(), settings);
+  CookedTexture cooked;
+  CookedTexture loaded;
+  run.check(!cache.load(key, loaded), "texcook.cache: hit in an empty cache");
+  if (!run.check(cookTexture(img.data(), 64, 64, settings, cooked) &&
+                     cache.store(key, cooked, 1),
+                 "texcook.cache: cook or store failed"))
+    return;
+
+  const std::string again = textureCookKey(img.data(), img.size(), settings);
+  run.check(again == key, "texcook.cache: same content, different key");
+  run.check(cache.load(again, loaded), "texcook.cache: second cook missed");
+  run.check(loaded.codec == cooked.codec && loaded.srgb == cooked.srgb &&
+                loaded.levels.size() == cooked.levels.size() &&
+                loaded.data == cooked.data,
+            "texcook.cache: cached texture differs from the cook");
+
+  TextureImportSettings srgb = settings;
+  srgb.srgb = true;
+  const std::string srgbKey = textureCookKey(img.data(), img.size(), srgb);
+  run.check(srgbKey != key && !cache.load(srgbKey, loaded),
+            "texcook.cache: changed settings hit the old entry");
+
+  img[img.size() / 2] ^= 1u;
+  const std::string edited = textureCookKey(img.data(), img.size(), settings);
+  run.check(edited != key && !cache.load(edited, loaded),
+            "texcook.cache: changed content hit the old entry");
+}
+
+// ---- Texture pools ----
+
+// What the forward, pick-ID and preview passes each did per frame before
+// the pools: dedup every visible draw's textures into at most 16 units.
+// Returns how many distinct textures did not fit.
+uint32_t remapScan(const std::vector<uint32_t> &drawTextures,
+                   std::vector<uint32_t> &compact) {
+  std::unordered_map<uint32_t, uint32_t> used;
+  compact.clear();
+  uint32_t dropped = 0;
+  for (uint32_t tex : drawTextures) {
+    if (used.find(tex) != used.end())
+      continue;
+    if (compact.size() >= 16u) {
+      used[tex] = ~0u;
+      ++dropped;
+      continue;
+    }
+    used[tex] = uint32_t(compact.size());
+    compact.push_back(tex);
+  }
+  return dropped;
+}
+
+} // namespace
+
+void benchTexturePools(Run &run) {
+  constexpr uint32_t kMaxLayers = 256u;
+  constexpr uint32_t kOps = 1'000'000u;
+
+  // Loads and evictions at random against one pool. A layer must never be
+  // handed out twice, and freed layers must be reused before fresh ones.
+  TexturePoolLayers pool;
+  std::vector<uint32_t> live;
+  std::vector<uint8_t> taken(kMaxLayers, 0u);
+  uint32_t peak = 0;
+  uint32_t grows = 0;
+  bool unique = true;
+  Rng rng;
+  const auto churn = [&] {
+    pool = TexturePoolLayers{};
+    live.clear();
+    std::fill(taken.begin(), taken.end(), 0u);
+    peak = grows = 0;
+    unique = true;
+    for (uint32_t op = 0; op < kOps; ++op) {
+      if (live.empty() || rng.below(100u) < 55u) {
+        uint32_t layer = pool.take();
+        if (layer == TexturePoolLayers::None) {
+          const uint32_t cap = pool.nextCapacity(kMaxLayers);
+          if (cap == pool.capacity)
+            continue; // full: TextureTable leaves the texture unpooled
+          pool.capacity = cap;
+          ++grows;
+          layer = pool.take();
+        }
+        unique = unique && layer < pool.capacity && !taken[layer];
+        taken[layer] = 1u;
+        live.push_back(layer);
+        peak = std::max(peak, uint32_t(live.size()));
+      } else {
+        const uint32_t i = rng.below(uint32_t(live.size()));
+        const uint32_t layer = live[i];
+        live[i] = live.back();
+        live.pop_back();
+        taken[layer] = 0u;
+        pool.release(layer);
+      }
+    }
+  };
+  double ms = run.time(churn);
+  run.report("texpool", "layer take/release", kOps, ms);
+
+  run.check(unique, "texpool: a layer was handed out while still in use");
+  run.check(pool.live() == live.size(),
+            "texpool: pool counts " + std::to_string(pool.live()) +
+                " live layers, expected " + std::to_string(live.size()));
+  run.check(pool.used == peak,
+            "texpool: " + std::to_string(pool.used) +
+                " layers handed out for a peak of " + std::to_string(peak));
+  run.check(pool.capacity == kMaxLayers &&
+                grows == uint32_t(std::bit_width(
+                             kMaxLayers / TexturePoolLayers::kInitialLayers)),
+            "texpool: grew " + std::to_string(grows) + " times to " +
+                std::to_string(pool.capacity) + " layers");
+
+  // Size classes: a texture fits its own class from level 0 and covers more
+  // than half of it each way. A pool a quarter the size takes it once at
+  // most two top mips are dropped; an unmipped texture never shares a
+  // mipped pool.
+  uint32_t misfits = 0;
+  for (uint32_t i = 0; i < 100'000u; ++i) {
+    const uint32_t w = 1u + rng.below(4096u);
+    const uint32_t h = 1u + rng.below(4096u);
+    const uint32_t levels = uint32_t(std::bit_width(std::max(w, h)));
+    const TexturePoolClass own = texturePoolClass(w, h, levels);
+    const TexturePoolClass quarter =
+        texturePoolClass(std::max(own.w / 4u, 1u), std::max(own.h / 4u, 1u),
+                         levels);
+    const uint32_t base = texturePoolBaseLevel(quarter, w, h, levels);
+    const bool fits =
+        texturePoolBaseLevel(own, w, h, levels) == 0u && 2u * w > own.w &&
+        2u * h > own.h && base <= 2u &&
+        std::max(w >> base, 1u) <= quarter.w &&
+        std::max(h >> base, 1u) <= quarter.h &&
+        (own.levels == 1u ||
+         texturePoolBaseLevel(own, w, h, 1u) == TexturePoolLayers::None);
+    misfits += fits ? 0u : 1u;
+  }
+  run.check(misfits == 0, "texpool: " + std::to_string(misfits) +
+                              " textures misplaced by their size class");
+
+  // The per-pass scan the pools replaced, over 100k draws of 256 materials
+  // with 5 texture slots each, drawing from 600 textures.
+  std::vector<uint32_t> materialTextures(256u * 5u);
+  for (uint32_t &t : materialTextures)
+    t = rng.below(600u);
+  std::vector<uint32_t> drawTextures;
+  drawTextures.reserve(100'000u * 5u);
+  for (uint32_t d = 0; d < 100'000u; ++d) {
+    const uint32_t m = rng.below(256u);
+    for (uint32_t slot = 0; slot < 5u; ++slot)
+      drawTextures.push_back(materialTextures[m * 5u + slot]);
+  }
+  std::vector<uint32_t> compact;
+  uint32_t dropped = 0;
+  ms = run.time([&] { dropped = remapScan(drawTextures, compact); });
+  run.report("texpool", "per-pass remap scan (old)", 100'000u, ms);
+  std::printf("texpool: the old scan dropped %u of %u textures; pooled "
+              "passes only bind()\n",
+              dropped, dropped + uint32_t(compact.size()));
+}
+
+void benchTextureCooker(Run &run) {
+  const RoundTrip trips[] = {
+      {"rgba8", Pattern::Color, false, TextureCompression::Off,
+       TextureCodec::RGBA8, 99.0},
+      {"bc1", Pattern::Color, false, TextureCompression::Fast,
+       TextureCodec::BC1, 28.0},
+      {"bc3", Pattern::Alpha, false, TextureCompression::Fast,
+       TextureCodec::BC3, 28.0},
+      {"bc7", Pattern::Color, false, TextureCompression::High,
+       TextureCodec::BC7, 40.0},
+      {"bc7-srgb", Pattern::Color, true, TextureCompression::High,
+       TextureCodec::BC7, 40.0},
+      {"bc5", Pattern::Normal, false, TextureCompression::High,
+       TextureCodec::BC5, 40.0},
+  };
+  for (const RoundTrip &rt : trips)
+    checkRoundTrip(run, rt, 256, 128);
+  // Not block aligned: stays RGBA8 whatever was asked for.
+  checkRoundTrip(run,
+                 {"unaligned", Pattern::Color, false,
+                  TextureCompression::High, TextureCodec::RGBA8, 99.0},
+                 102, 62);
+
+  const ScratchDir scratch("nyx_micro_texcache");
+  const std::filesystem::path &dir = scratch.path();
+  checkCache(run, dir);
+
+  // What a cache hit saves a decode thread, per 512x512 texture.
+  constexpr uint32_t kSize = 512;
+  const std::vector<uint8_t> img = makeImage(Pattern::Color, kSize, kSize);
+  TextureCookCache cache;
+  cache.setDirectory(dir);
+  const uint64_t texels = uint64_t(kSize) * kSize;
+  for (TextureCompression c :
+       {TextureCompression::Off, TextureCompression::Fast,
+        TextureCompression::High}) {
+    TextureImportSettings settings{};
+    settings.compression = c;
+    CookedTexture cooked;
+    double ms = run.time(
+        [&] { cookTexture(img.data(), kSize, kSize, settings, cooked); });
+    const std::string codec = textureCodecName(cooked.codec);
+    run.report("texcook.512", "cook " + codec, texels, ms);
+
+    const std::string key = textureCookKey(img.data(), img.size(), settings);
+    cache.store(key, cooked, 0);
+    CookedTexture loaded;
+    ms = run.time([&] {
+      sink(textureCookKey(img.data(), img.size(), settings).size());
+      sink(cache.load(key, loaded) ? loaded.data.size() : 0);
+    });
+    run.report("texcook.512", "hash+cache hit " + codec, texels, ms);
+  }
+}
+
+} // namespace Nyx::MicroBench
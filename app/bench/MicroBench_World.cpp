@@ -0,0 +1,476 @@
+#include "MicroBench_Impl.h"
+
+#include "core/JobSystem.h"
+#include "scene/ComponentPool.h"
+#include "scene/World.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+namespace Nyx::MicroBench {
+
+namespace {
+
+// How World stored components before ComponentPool: one hash map per type.
+using LegacyStore = std::unordered_map<EntityID, CTransform, EntityHash>;
+
+std::vector<EntityID> makeEntities(uint32_t n) {
+  std::vector<EntityID> ids(n);
+  for (uint32_t i = 0; i < n; ++i)
+    ids[i] = EntityID{i + 1u, 1u};
+  return ids;
+}
+
+uint64_t touch(const CTransform &t) {
+  return uint64_t(t.translation.x) + (t.dirty ? 1u : 0u);
+}
+
+void legacyStorage(Run &run, const std::vector<EntityID> &ids,
+                   const std::vector<EntityID> &shuffled) {
+  const uint64_t n = ids.size();
+  LegacyStore store;
+
+  double ms = run.time([&] { store = LegacyStore(); },
+                       [&] {
+                         for (EntityID e : ids)
+                           store.emplace(e, CTransform{});
+                       });
+  run.report("ecs.create", "unordered_map", n, ms);
+
+  ms = run.time([&] {
+    uint64_t s = 0;
+    for (EntityID e : shuffled)
+      s += touch(store.at(e));
+    sink(s);
+  });
+  run.report("ecs.lookup", "unordered_map", n, ms);
+
+  // The old per-frame loops walked m_alive and probed the map per entity.
+  ms = run.time([&] {
+    uint64_t s = 0;
+    for (EntityID e : ids)
+      s += touch(store.at(e));
+    sink(s);
+  });
+  run.report("ecs.iterate", "unordered_map", n, ms);
+
+  ms = run.time(
+      [&] {
+        store.clear();
+        for (EntityID e : ids)
+          store.emplace(e, CTransform{});
+      },
+      [&] {
+        for (EntityID e : shuffled)
+          store.erase(e);
+      });
+  run.report("ecs.destroy", "unordered_map", n, ms);
+}
+
+void poolStorage(Run &run, const std::vector<EntityID> &ids,
+                 const std::vector<EntityID> &shuffled) {
+  const uint64_t n = ids.size();
+  ComponentPool<CTransform> pool;
+
+  double ms = run.time([&] { pool = ComponentPool<CTransform>(); },
+                       [&] {
+                         for (EntityID e : ids)
+                           pool.ensure(e);
+                       });
+  run.report("ecs.create", "ComponentPool", n, ms);
+
+  ms = run.time([&] {
+    uint64_t s = 0;
+    for (EntityID e : shuffled)
+      s += touch(pool.get(e));
+    sink(s);
+  });
+  run.report("ecs.lookup", "ComponentPool", n, ms);
+
+  ms = run.time([&] {
+    uint64_t s = 0;
+    for (const CTransform &t : pool.values())
+      s += touch(t);
+    sink(s);
+  });
+  run.report("ecs.iterate", "ComponentPool", n, ms);
+
+  ms = run.time(
+      [&] {
+        pool.clear();
+        for (EntityID e : ids)
+          pool.ensure(e);
+      },
+      [&] {
+        for (EntityID e : shuffled)
+          pool.remove(e);
+      });
+  run.report("ecs.destroy", "ComponentPool", n, ms);
+}
+
+// Whole entities: name, UUID, hierarchy and both transforms per create.
+void worldEntities(Run &run, uint32_t n) {
+  World world;
+  std::vector<EntityID> created;
+  created.reserve(n);
+  const std::string name = "Entity";
+
+  double ms = run.time(
+      [&] {
+        world.clear();
+        created.clear();
+      },
+      [&] {
+        for (uint32_t i = 0; i < n; ++i)
+          created.push_back(world.createEntity(name));
+      });
+  run.report("ecs.create", "World", n, ms);
+
+  Rng rng;
+  ms = run.time(
+      [&] {
+        world.clear();
+        created.clear();
+        for (uint32_t i = 0; i < n; ++i)
+          created.push_back(world.createEntity(name));
+        rng.shuffle(created);
+      },
+      [&] {
+        for (EntityID e : created)
+          world.destroyEntity(e);
+      });
+  run.report("ecs.destroy", "World", n, ms);
+}
+
+// ---- Transforms ----
+
+// The recursive update TransformSystem replaced: three component lookups
+// per node and a fresh roots() vector per call.
+glm::mat4 legacyTRS(const CTransform &t) {
+  glm::mat4 M(1.0f);
+  M = glm::translate(M, t.translation);
+  M *= glm::toMat4(t.rotation);
+  M = glm::scale(M, t.scale);
+  return M;
+}
+
+void legacyUpdateNode(World &w, EntityID e, const glm::mat4 &parentWorld,
+                      bool parentDirty) {
+  CTransform &lt = w.transform(e);
+  CWorldTransform &wt = w.worldTransform(e);
+  if (lt.dirty || parentDirty)
+    wt.dirty = true;
+  const bool worldUpdated = wt.dirty;
+  if (wt.dirty) {
+    wt.world = parentWorld * legacyTRS(lt);
+    wt.dirty = false;
+    lt.dirty = false;
+  }
+  EntityID c = w.hierarchy(e).firstChild;
+  while (c != InvalidEntity) {
+    const EntityID next = w.hierarchy(c).nextSibling;
+    legacyUpdateNode(w, c, wt.world, worldUpdated);
+    c = next;
+  }
+}
+
+void legacyUpdate(World &w) {
+  for (EntityID r : w.roots())
+    legacyUpdateNode(w, r, glm::mat4(1.0f), false);
+}
+
+// `roots` trees of `depth` levels where every node has `fanout` children
+// (a chain when fanout is 1). Returns the roots; all nodes go in `nodes`.
+std::vector<EntityID> buildForest(World &w, uint32_t roots, uint32_t depth,
+                                  uint32_t fanout,
+                                  std::vector<EntityID> &nodes) {
+  std::vector<EntityID> level;
+  std::vector<EntityID> next;
+  for (uint32_t i = 0; i < roots; ++i)
+    level.push_back(w.createEntity("Node"));
+  const std::vector<EntityID> rootIds = level;
+  nodes = level;
+  for (uint32_t d = 1; d < depth; ++d) {
+    next.clear();
+    for (EntityID p : level) {
+      for (uint32_t k = 0; k < fanout; ++k) {
+        const EntityID c = w.createEntity("Node");
+        w.setParent(c, p);
+        w.transform(c).translation = glm::vec3(0.0f, 1.0f, 0.0f);
+        next.push_back(c);
+      }
+    }
+    nodes.insert(nodes.end(), next.begin(), next.end());
+    level.swap(next);
+  }
+  w.clearEvents();
+  return rootIds;
+}
+
+// Budget for a 100k-node update with at least kTransformTargetThreads
+// threads. One core is bound by the ~11 MB of components each update reads
+// and writes, so fewer threads get a proportionally larger budget.
+constexpr double kTransformTargetMs = 1.0;
+constexpr uint32_t kTransformTargetThreads = 4;
+
+double transformBudgetMs(uint64_t nodes) {
+  const uint32_t threads = JobSystem::instance().workerCount() + 1u;
+  const double scale =
+      double(kTransformTargetThreads) / double(std::min(threads, kTransformTargetThreads));
+  return kTransformTargetMs * scale * double(nodes) / 1e5;
+}
+
+void transformShape(Run &run, const char *shape, uint32_t roots,
+                    uint32_t depth, uint32_t fanout) {
+  World w;
+  std::vector<EntityID> nodes;
+  const std::vector<EntityID> rootIds =
+      buildForest(w, roots, depth, fanout, nodes);
+  const uint64_t n = nodes.size();
+  w.updateTransforms();
+
+  // Animated: every local transform changed this frame.
+  const auto dirtyAll = [&] {
+    for (EntityID e : nodes)
+      w.transform(e).dirty = true;
+    w.clearEvents();
+  };
+  // Only the roots moved; everything below follows its parent.
+  const auto dirtyRoots = [&] {
+    for (EntityID e : rootIds)
+      w.transform(e).dirty = true;
+    w.clearEvents();
+  };
+
+  const std::string bench = std::string("transform.") + shape;
+  double ms = run.time(dirtyAll, [&] { legacyUpdate(w); });
+  run.report(bench, "recursive all-dirty", n, ms);
+  ms = run.time(dirtyAll, [&] { w.updateTransforms(); });
+  run.report(bench, "flattened all-dirty", n, ms);
+  const double allMs = ms;
+  ms = run.time(dirtyRoots, [&] { legacyUpdate(w); });
+  run.report(bench, "recursive roots-dirty", n, ms);
+  ms = run.time(dirtyRoots, [&] { w.updateTransforms(); });
+  run.report(bench, "flattened roots-dirty", n, ms);
+  const double worstMs = std::max(allMs, ms);
+  const double budgetMs = transformBudgetMs(n);
+  std::printf("%s: flattened update %.3f ms at worst, budget %.1f ms here "
+              "(%.1f ms from %u threads up): %s\n",
+              bench.c_str(), worstMs, budgetMs, kTransformTargetMs,
+              kTransformTargetThreads, worstMs < budgetMs ? "met" : "missed");
+
+  // Editor writes (undo, inspector drags) change a child's local transform
+  // without raising its dirty flag; moving the parent must still pick them
+  // up, as the recursive update did.
+  for (EntityID e : nodes)
+    w.transform(e).translation.x += 0.5f;
+  dirtyRoots();
+  w.updateTransforms();
+  std::vector<glm::mat4> flattened;
+  flattened.reserve(n);
+  for (EntityID e : nodes)
+    flattened.push_back(w.worldTransform(e).world);
+  dirtyRoots();
+  legacyUpdate(w);
+  uint64_t stale = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const glm::mat4 &ref = w.worldTransform(nodes[i]).world;
+    if (std::abs(flattened[i][3].x - ref[3].x) > 1e-3f)
+      ++stale;
+  }
+  run.check(stale == 0, bench + ": " + std::to_string(stale) +
+                            " nodes kept a stale local transform");
+}
+
+// ---- Entity churn ----
+
+// The test's own record of which entities should be alive, with O(1)
+// removal by slot index (World recycles indices, so they stay dense).
+struct LiveSet final {
+  std::vector<EntityID> ids;
+  std::vector<uint32_t> pos; // by EntityID::index
+  std::vector<EntityID> stale;
+
+  void clear() {
+    ids.clear();
+    pos.clear();
+    stale.clear();
+  }
+  void add(EntityID e) {
+    if (pos.size() <= e.index)
+      pos.resize(size_t(e.index) + 1u, ~0u);
+    pos[e.index] = uint32_t(ids.size());
+    ids.push_back(e);
+  }
+  void remove(EntityID e) {
+    const uint32_t p = pos[e.index];
+    ids[p] = ids.back();
+    pos[ids[p].index] = p;
+    ids.pop_back();
+    pos[e.index] = ~0u;
+    stale.push_back(e);
+  }
+};
+
+// Creates (half under a random parent), destroys random subtrees and
+// re-parents at random, keeping `live` in step with the World.
+void churn(World &w, LiveSet &live, Rng &rng, uint32_t ops,
+           std::vector<EntityID> &scratch) {
+  for (uint32_t i = 0; i < ops; ++i) {
+    const uint32_t roll = rng.below(10);
+    if (live.ids.empty() || roll < 4) {
+      const EntityID e = w.createEntity("Churn");
+      if (!live.ids.empty() && (roll & 1u))
+        w.setParent(e, live.ids[rng.below((uint32_t)live.ids.size())]);
+      live.add(e);
+    } else if (roll < 7) {
+      const EntityID root = live.ids[rng.below((uint32_t)live.ids.size())];
+      scratch.assign(1, root);
+      for (size_t k = 0; k < scratch.size(); ++k)
+        for (EntityID c = w.hierarchy(scratch[k]).firstChild;
+             c != InvalidEntity; c = w.hierarchy(c).nextSibling)
+          scratch.push_back(c);
+      w.destroyEntity(root);
+      for (EntityID e : scratch)
+        live.remove(e);
+    } else {
+      const EntityID child = live.ids[rng.below((uint32_t)live.ids.size())];
+      const EntityID parent =
+          roll == 9 ? InvalidEntity
+                    : live.ids[rng.below((uint32_t)live.ids.size())];
+      w.setParent(child, parent); // cycles are rejected by World
+    }
+  }
+  w.clearEvents();
+}
+
+// Every link symmetric, every node reachable from roots() exactly once.
+bool hierarchyConsistent(const World &w) {
+  const auto siblingsOk = [&](EntityID first, EntityID last,
+                              EntityID parent) {
+    EntityID prev = InvalidEntity;
+    for (EntityID c = first; c != InvalidEntity;
+         c = w.hierarchy(c).nextSibling) {
+      const CHierarchy &h = w.hierarchy(c);
+      if (!w.isAlive(c) || h.parent != parent || h.prevSibling != prev)
+        return false;
+      prev = c;
+    }
+    return prev == last;
+  };
+
+  const std::vector<EntityID> roots = w.roots();
+  if (!siblingsOk(roots.empty() ? InvalidEntity : roots.front(),
+                  roots.empty() ? InvalidEntity : roots.back(),
+                  InvalidEntity))
+    return false;
+  std::vector<EntityID> stack(roots.rbegin(), roots.rend());
+  size_t reached = 0;
+  while (!stack.empty()) {
+    const EntityID e = stack.back();
+    stack.pop_back();
+    if (++reached > w.alive().size())
+      return false; // a cycle
+    const CHierarchy &h = w.hierarchy(e);
+    if (!siblingsOk(h.firstChild, h.lastChild, e))
+      return false;
+    for (EntityID c = h.firstChild; c != InvalidEntity;
+         c = w.hierarchy(c).nextSibling)
+      stack.push_back(c);
+  }
+  return reached == w.alive().size();
+}
+
+void checkChurn(Run &run, const World &w, const LiveSet &live) {
+  run.check(w.alive().size() == live.ids.size(),
+            "churn: alive() has " + std::to_string(w.alive().size()) +
+                " entities, expected " + std::to_string(live.ids.size()));
+  uint32_t lost = 0;
+  for (EntityID e : live.ids)
+    lost += w.isAlive(e) ? 0u : 1u;
+  run.check(lost == 0, "churn: " + std::to_string(lost) +
+                           " live entities report dead");
+  uint32_t resolved = 0;
+  uint32_t recycled = 0;
+  for (EntityID e : live.stale) {
+    resolved += w.isAlive(e) ? 1u : 0u;
+    recycled += (e.index < live.pos.size() && live.pos[e.index] != ~0u)
+                    ? 1u
+                    : 0u;
+  }
+  run.check(resolved == 0, "churn: " + std::to_string(resolved) +
+                               " stale EntityIDs still resolve");
+  run.check(recycled > 0, "churn: no destroyed index was ever reused");
+  run.check(hierarchyConsistent(w), "churn: hierarchy links inconsistent");
+}
+
+} // namespace
+
+void benchComponentStorage(Run &run) {
+  for (uint32_t n : {10'000u, 100'000u, 1'000'000u}) {
+    const std::vector<EntityID> ids = makeEntities(n);
+    std::vector<EntityID> shuffled = ids;
+    Rng rng;
+    rng.shuffle(shuffled);
+
+    legacyStorage(run, ids, shuffled);
+    poolStorage(run, ids, shuffled);
+    worldEntities(run, n);
+  }
+}
+
+void benchTransforms(Run &run) {
+  std::printf("transform: %u threads\n",
+              JobSystem::instance().workerCount() + 1u);
+  // 100k nodes each: all roots, a rig-like 100-deep forest of chains, and
+  // ten roots with 10k direct children.
+  transformShape(run, "flat", 100'000u, 1u, 1u);
+  transformShape(run, "deep", 1'000u, 100u, 1u);
+  transformShape(run, "wide", 10u, 2u, 9'999u);
+}
+
+void benchWorldChurn(Run &run) {
+  constexpr uint32_t kEntities = 1'000'000u;
+  World w;
+  LiveSet live;
+  std::vector<EntityID> scratch;
+  Rng rng;
+
+  const auto populate = [&] {
+    w.clear();
+    live.clear();
+    for (uint32_t i = 0; i < kEntities; ++i)
+      live.add(w.createEntity("Churn"));
+    w.clearEvents();
+  };
+  double ms = run.time([&] { w.clear(); }, [&] {
+    for (uint32_t i = 0; i < kEntities; ++i)
+      w.createEntity("Churn");
+  });
+  run.report("churn", "create", kEntities, ms);
+
+  // 40% create, 30% destroySubtree, 30% reparent over a 1M-entity world;
+  // the last repeat's world is the one checked.
+  ms = run.time(
+      [&] {
+        populate();
+        rng = Rng{};
+      },
+      [&] { churn(w, live, rng, kEntities, scratch); });
+  run.report("churn", "create/destroy/reparent", kEntities, ms);
+  checkChurn(run, w, live);
+
+  ms = run.time([&] {
+    for (EntityID e : live.stale)
+      sink(w.isAlive(e) ? 1u : 0u);
+  });
+  run.report("churn", "stale isAlive", live.stale.size(), ms);
+}
+
+} // namespace Nyx::MicroBench
@@ -0,0 +1,95 @@
+#include "core/Log.h"
+
+#include "app/Benchmark.h"
+#include "bench/MicroBench.h"
+#include "core/Paths.h"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+
+static void printUsage() {
+  std::fprintf(stderr,
+               "usage: nyx_bench <scene.nyxscene> [--frames N] [--warmup N]\n"
+               "                 [--width W] [--height H] [--out timings.json]\n"
+               "                 [--image final.png] [--null-platform]\n"
+               "       nyx_bench --micro [--filter NAME] [--repeats N]\n"
+               "                 [--out rows.json]\n");
+}
+
+static bool parseU32(const char *s, uint32_t &out) {
+  const char *end = s + std::strlen(s);
+  const auto [p, ec] = std::from_chars(s, end, out);
+  return ec == std::errc() && p == end;
+}
+
+int main(int argc, char **argv) {
+  Nyx::Paths::init((argc > 0 && argv && argv[0]) ? argv[0] : ".");
+  Nyx::Log::Init();
+
+  Nyx::BenchmarkDesc desc{};
+  Nyx::MicroBenchDesc micro{};
+  bool microMode = false;
+  bool outGiven = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    bool ok = true;
+    if (arg == "--null-platform") {
+      desc.nullPlatform = true;
+      continue;
+    } else if (arg == "--micro") {
+      microMode = true;
+      continue;
+    } else if (arg == "--filter" && value) {
+      micro.filter = value;
+    } else if (arg == "--repeats" && value) {
+      ok = parseU32(value, micro.repeats) && micro.repeats > 0;
+    } else if (arg == "--frames" && value) {
+      ok = parseU32(value, desc.frames);
+    } else if (arg == "--warmup" && value) {
+      ok = parseU32(value, desc.warmupFrames);
+    } else if (arg == "--width" && value) {
+      ok = parseU32(value, desc.width);
+    } else if (arg == "--height" && value) {
+      ok = parseU32(value, desc.height);
+    } else if (arg == "--out" && value) {
+      desc.timingsPath = value;
+      outGiven = true;
+    } else if (arg == "--image" && value) {
+      desc.imagePath = value;
+    } else if (!arg.starts_with("--") && desc.scenePath.empty()) {
+      desc.scenePath = argv[i];
+      continue;
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      printUsage();
+      return 2;
+    }
+    ++i;
+  }
+  if (microMode) {
+    // Micro rows only go to a file when asked for.
+    if (outGiven)
+      micro.timingsPath = desc.timingsPath;
+    return Nyx::runMicroBenchmarks(micro);
+  }
+  if (desc.scenePath.empty()) {
+    printUsage();
+    return 2;
+  }
+
+  // Shaders load relative to the repo root, so resolve the user's paths first.
+  namespace fs = std::filesystem;
+  desc.scenePath = fs::absolute(desc.scenePath).string();
+  desc.timingsPath = fs::absolute(desc.timingsPath).string();
+  if (!desc.imagePath.empty())
+    desc.imagePath = fs::absolute(desc.imagePath).string();
+  fs::current_path(Nyx::Paths::engineRoot().parent_path());
+
+  return Nyx::runBenchmark(desc);
+}
@@ -0,0 +1,232 @@
+#include "render/material/MaterialGraphCPU.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+using namespace Nyx;
+
+namespace {
+
+// Builds VM programs by hand, one register per value (compiler contract).
+class ProgramBuilder final {
+public:
+  uint32_t uv() const { return 0; }
+  uint32_t normal() const { return 1; }
+  uint32_t view() const { return 2; }
+
+  uint32_t constant(float x, float y, float z, float w) {
+    uint32_t bits[4];
+    const float v[4] = {x, y, z, w};
+    std::memcpy(bits, v, sizeof(bits));
+    return emit(MatOp::Const4, bits[0], bits[1], bits[2], bits[3]);
+  }
+  uint32_t op(MatOp op, uint32_t a, uint32_t b = 0, uint32_t c = 0) {
+    return emit(op, a, b, c, 0);
+  }
+  uint32_t tex(MatOp op, uint32_t texIndex, uint32_t uvReg,
+               uint32_t strength = 0) {
+    return emit(op, uvReg, strength, 0, texIndex);
+  }
+
+  CompiledMaterialGraph finish(uint32_t base, uint32_t mr, uint32_t normal,
+                               uint32_t emissive, uint32_t alpha) {
+    m_g.header.nodeCount = (uint32_t)m_g.nodes.size();
+    m_g.header.outBaseColor = base;
+    m_g.header.outMR = mr;
+    m_g.header.outNormalWS = normal;
+    m_g.header.outEmissive = emissive;
+    m_g.header.outAlpha = alpha;
+    m_g.header.alphaCutoff = 0.5f;
+    return m_g;
+  }
+
+private:
+  uint32_t emit(MatOp op, uint32_t a, uint32_t b, uint32_t c,
+                uint32_t extra) {
+    m_g.nodes.push_back(
+        GpuMatNode{static_cast<uint32_t>(op), m_next, a, b, c, extra});
+    return m_next++;
+  }
+
+  CompiledMaterialGraph m_g{};
+  uint32_t m_next = 3;
+};
+
+struct Mix final {
+  const char *name;
+  CompiledMaterialGraph graph;
+};
+
+// Pure arithmetic: a procedural stripe/tint chain.
+CompiledMaterialGraph mixALU() {
+  ProgramBuilder b;
+  uint32_t x = b.op(MatOp::Swizzle, b.uv());
+  const uint32_t k = b.constant(7.0f, 3.0f, 0.25f, 1.0f);
+  const uint32_t tintA = b.constant(0.8f, 0.3f, 0.1f, 1.0f);
+  const uint32_t tintB = b.constant(0.1f, 0.4f, 0.9f, 1.0f);
+  for (int i = 0; i < 6; ++i) {
+    x = b.op(MatOp::Mul, x, k);
+    x = b.op(MatOp::Sub, x, b.op(MatOp::Min, x, k));
+    x = b.op(MatOp::Clamp01, x);
+    x = b.op(MatOp::OneMinus, x);
+  }
+  const uint32_t base = b.op(MatOp::Lerp, tintA, tintB, x);
+  const uint32_t mr = b.op(MatOp::Max, b.op(MatOp::Div, x, k), tintA);
+  return b.finish(base, mr, b.normal(), b.constant(0, 0, 0, 0), k);
+}
+
+// Transcendental and vector math: pow, dot, normalize.
+CompiledMaterialGraph mixMath() {
+  ProgramBuilder b;
+  const uint32_t e = b.constant(2.2f, 0.5f, 4.0f, 1.0f);
+  const uint32_t ndv = b.op(MatOp::Dot3, b.normal(), b.view());
+  uint32_t x = b.op(MatOp::Pow, b.op(MatOp::Clamp01, ndv), e);
+  for (int i = 0; i < 4; ++i) {
+    x = b.op(MatOp::Normalize3, b.op(MatOp::Add, x, b.normal()));
+    x = b.op(MatOp::Pow, b.op(MatOp::Dot3, x, b.view()), e);
+  }
+  const uint32_t rim = b.op(MatOp::OneMinus, x);
+  return b.finish(x, rim, b.normal(), rim, e);
+}
+
+// Sampling bound: four lookups blended together.
+CompiledMaterialGraph mixTexture() {
+  ProgramBuilder b;
+  const uint32_t scale = b.constant(4.0f, 4.0f, 0.0f, 0.0f);
+  const uint32_t uv2 = b.op(MatOp::Mul, b.uv(), scale);
+  const uint32_t t0 = b.tex(MatOp::Tex2D, 0, b.uv());
+  const uint32_t t1 = b.tex(MatOp::Tex2D_SRGB, 1, uv2);
+  const uint32_t t2 = b.tex(MatOp::Tex2D, 2, b.uv());
+  const uint32_t t3 = b.tex(MatOp::Tex2D_MRA, 3, uv2);
+  const uint32_t base = b.op(MatOp::Lerp, t0, t1, t2);
+  return b.finish(base, t3, b.normal(), b.constant(0, 0, 0, 0), t0);
+}
+
+// What the graph editor emits for a textured PBR material.
+CompiledMaterialGraph mixPBR() {
+  ProgramBuilder b;
+  const uint32_t tiling = b.constant(2.0f, 2.0f, 0.0f, 0.0f);
+  const uint32_t uv = b.op(MatOp::Mul, b.uv(), tiling);
+  const uint32_t albedo = b.tex(MatOp::Tex2D_SRGB, 0, uv);
+  const uint32_t tint = b.constant(0.9f, 0.85f, 0.8f, 1.0f);
+  const uint32_t base = b.op(MatOp::Mul, albedo, tint);
+  const uint32_t mra = b.tex(MatOp::Tex2D_MRA, 3, uv);
+  const uint32_t strength = b.constant(1.0f, 0.0f, 0.0f, 0.0f);
+  const uint32_t n = b.tex(MatOp::NormalMapTS, 2, uv, strength);
+  const uint32_t emissive = b.constant(0.0f, 0.0f, 0.0f, 0.0f);
+  return b.finish(base, mra, n, emissive, albedo);
+}
+
+void makeTextures(MatCPUImageTextures &textures) {
+  constexpr uint32_t kSize = 256;
+  for (uint32_t t = 0; t < 4; ++t) {
+    std::vector<uint8_t> px(kSize * kSize * 4);
+    uint32_t state = 0x9E3779B9u * (t + 1);
+    for (uint8_t &p : px) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      p = uint8_t(state >> 24);
+    }
+    textures.set(t, kSize, kSize, std::move(px));
+  }
+}
+
+std::vector<MatCPUSample> makeSamples(uint32_t count) {
+  std::vector<MatCPUSample> samples(count);
+  const uint32_t side = std::max(1u, (uint32_t)std::sqrt(double(count)));
+  for (uint32_t i = 0; i < count; ++i) {
+    const float u = float(i % side) / float(side);
+    const float v = float(i / side) / float(side);
+    MatCPUSample &s = samples[i];
+    s.uv = {u, v};
+    s.normal = {u - 0.5f, v - 0.5f, 1.0f};
+    s.viewDir = {0.2f, -0.1f, 1.0f};
+    s.tangent = {1.0f, 0.0f, 0.5f - u, 1.0f};
+  }
+  return samples;
+}
+
+bool sameBits(const std::vector<MatCPUSurface> &a,
+              const std::vector<MatCPUSurface> &b) {
+  return a.size() == b.size() &&
+         std::memcmp(a.data(), b.data(), a.size() * sizeof(MatCPUSurface)) ==
+             0;
+}
+
+bool parseU32(const char *s, uint32_t &out) {
+  const char *end = s + std::strlen(s);
+  const auto [p, ec] = std::from_chars(s, end, out);
+  return ec == std::errc() && p == end;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  uint32_t pixels = 256 * 256;
+  uint32_t reps = 20;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    bool ok = false;
+    if (arg == "--pixels" && value)
+      ok = parseU32(value, pixels) && pixels > 0;
+    else if (arg == "--reps" && value)
+      ok = parseU32(value, reps) && reps > 0;
+    if (!ok) {
+      std::fprintf(stderr, "usage: nyx_matvm_bench [--pixels N] [--reps N]\n");
+      return 2;
+    }
+    ++i;
+  }
+
+  MatCPUImageTextures textures;
+  makeTextures(textures);
+  const std::vector<MatCPUSample> samples = makeSamples(pixels);
+
+  const Mix mixes[] = {{"alu", mixALU()},
+                       {"math", mixMath()},
+                       {"texture", mixTexture()},
+                       {"pbr", mixPBR()}};
+  const MatCPUPath paths[] = {MatCPUPath::Scalar, MatCPUPath::SSE,
+                              MatCPUPath::AVX2};
+
+  std::printf("%u pixels, best of %u runs\n", pixels, reps);
+  std::printf("%-8s %4s  %-6s %9s %10s  %s\n", "mix", "ops", "path", "ns/px",
+              "Mpx/s", "vs scalar");
+  int status = 0;
+  for (const Mix &mix : mixes) {
+    std::vector<MatCPUSurface> reference(pixels);
+    evalMaterialCPU(mix.graph, samples.data(), reference.data(), pixels,
+                    &textures, MatCPUPath::Scalar);
+
+    for (const MatCPUPath path : paths) {
+      if (!matCPUPathSupported(path))
+        continue;
+      std::vector<MatCPUSurface> out(pixels);
+      double best = 1e30;
+      for (uint32_t r = 0; r < reps; ++r) {
+        const auto t0 = std::chrono::steady_clock::now();
+        evalMaterialCPU(mix.graph, samples.data(), out.data(), pixels,
+                        &textures, path);
+        const auto t1 = std::chrono::steady_clock::now();
+        best = std::min(
+            best, std::chrono::duration<double, std::nano>(t1 - t0).count());
+      }
+      const bool match = sameBits(out, reference);
+      if (!match)
+        status = 1;
+      const double nsPerPx = best / double(pixels);
+      std::printf("%-8s %4zu  %-6s %9.2f %10.1f  %s\n", mix.name,
+                  mix.graph.nodes.size(), matCPUPathName(path), nsPerPx,
+                  1e3 / nsPerPx, match ? "identical" : "MISMATCH");
+    }
+  }
+  return status;
+}
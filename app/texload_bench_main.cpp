@@ -0,0 +1,260 @@
+#include "core/Log.h"
+#include "platform/GLFWWindow.h"
+#include "render/gl/GLResources.h"
+#include "render/gl/GLUploadRing.h"
+#include "render/material/TextureTable.h"
+
+#include <glad/glad.h>
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace Nyx;
+
+namespace {
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+// Gives up on a run that has not made everything resident by then.
+constexpr double kTimeoutSeconds = 120.0;
+
+bool parseU32(const char *s, uint32_t &out) {
+  const char *end = s + std::strlen(s);
+  const auto [p, ec] = std::from_chars(s, end, out);
+  return ec == std::errc() && p == end;
+}
+
+// Gradients under value noise: compresses like a photo rather than like a
+// flat fill, so decode cost is realistic.
+bool writeTexture(const fs::path &path, uint32_t size, uint32_t seed) {
+  std::vector<uint8_t> px(size_t(size) * size * 4u);
+  uint32_t state = 0x9E3779B9u * (seed + 1);
+  for (uint32_t y = 0; y < size; ++y) {
+    for (uint32_t x = 0; x < size; ++x) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      const uint32_t noise = (state >> 24) & 31u;
+      uint8_t *p = &px[(size_t(y) * size + x) * 4u];
+      p[0] = uint8_t((x * 255u / size + noise + seed * 37u) & 255u);
+      p[1] = uint8_t((y * 255u / size + noise) & 255u);
+      p[2] = uint8_t(((x ^ y) + seed * 11u + noise) & 255u);
+      p[3] = 255;
+    }
+  }
+  return stbi_write_png(path.string().c_str(), int(size), int(size), 4,
+                        px.data(), int(size) * 4) != 0;
+}
+
+// Reuses PNGs left by an earlier run with the same count and size.
+bool makeTextures(const fs::path &dir, uint32_t count, uint32_t size,
+                  std::vector<std::string> &paths) {
+  std::error_code ec;
+  fs::create_directories(dir, ec);
+  for (uint32_t i = 0; i < count; ++i) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "tex_%u_%04u.png", size, i);
+    const fs::path path = dir / name;
+    if (!fs::exists(path, ec) && !writeTexture(path, size, i)) {
+      std::fprintf(stderr, "failed to write %s\n", path.string().c_str());
+      return false;
+    }
+    paths.push_back(fs::absolute(path).string());
+  }
+  return true;
+}
+
+struct RunResult final {
+  double ms = 0.0;
+  uint32_t frames = 0;
+  uint64_t poolBytes = 0;
+  bool ok = false;
+};
+
+struct RunDesc final {
+  uint32_t threads = 1;
+  uint64_t budgetBytes = 32ull << 20;
+  TextureCompression compression = TextureCompression::High;
+  bool cache = false;
+};
+
+bool parseCompression(std::string_view s, TextureCompression &out) {
+  if (s == "off")
+    out = TextureCompression::Off;
+  else if (s == "fast")
+    out = TextureCompression::Fast;
+  else if (s == "high")
+    out = TextureCompression::High;
+  else
+    return false;
+  return true;
+}
+
+// Loads every texture: requested up front, then re-requested each frame the
+// way MaterialSystem does, until all of them are resident. Without the
+// cooked cache every run decodes and cooks from scratch.
+RunResult timeToResident(GLResources &gl, GLUploadRing &upload,
+                         const std::vector<std::string> &paths,
+                         const RunDesc &desc) {
+  TextureTable table;
+  table.setDiskCacheEnabled(desc.cache);
+  table.setCompression(desc.compression);
+  table.setDecodeThreads(desc.threads);
+  TextureUploadBudget budget{};
+  budget.bytes = desc.budgetBytes;
+  table.setUploadBudget(budget);
+  table.init(gl, upload);
+
+  RunResult r{};
+  const Clock::time_point start = Clock::now();
+  std::vector<uint32_t> indices;
+  indices.reserve(paths.size());
+  for (const std::string &path : paths)
+    indices.push_back(table.getOrCreate2D(path, true));
+
+  for (;;) {
+    upload.beginFrame();
+    for (uint32_t index : indices)
+      table.request(index, TexturePriority::Visible);
+    table.processUploads();
+    ++r.frames;
+    if (table.stats().resident == paths.size()) {
+      glFinish();
+      r.ok = true;
+      break;
+    }
+    const double elapsed =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    if (elapsed > kTimeoutSeconds)
+      break;
+    // Stand-in for the rest of a frame's work.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  r.ms = std::chrono::duration<double, std::milli>(Clock::now() - start)
+             .count();
+  r.poolBytes = table.stats().poolBytes;
+  table.shutdown();
+  return r;
+}
+
+void printUsage() {
+  std::fprintf(stderr,
+               "usage: nyx_texload_bench [--dir D] [--count N] [--size S]\n"
+               "                         [--max-threads N] [--budget-mb N]\n"
+               "                         [--compression off|fast|high] "
+               "[--cache]\n"
+               "                         [--null-platform]\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Log::Init();
+
+  fs::path dir = fs::temp_directory_path() / "nyx_texload_bench";
+  uint32_t count = 128;
+  uint32_t size = 512;
+  uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  uint32_t budgetMB = 32;
+  RunDesc desc{};
+  bool nullPlatform = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    bool ok = false;
+    if (arg == "--null-platform") {
+      nullPlatform = true;
+      continue;
+    } else if (arg == "--cache") {
+      desc.cache = true;
+      continue;
+    } else if (arg == "--compression" && value) {
+      ok = parseCompression(value, desc.compression);
+    } else if (arg == "--dir" && value) {
+      dir = value;
+      ok = true;
+    } else if (arg == "--count" && value) {
+      ok = parseU32(value, count) && count > 0;
+    } else if (arg == "--size" && value) {
+      ok = parseU32(value, size) && size > 0;
+    } else if (arg == "--max-threads" && value) {
+      ok = parseU32(value, maxThreads) && maxThreads > 0;
+    } else if (arg == "--budget-mb" && value) {
+      ok = parseU32(value, budgetMB) && budgetMB > 0;
+    }
+    if (!ok) {
+      printUsage();
+      return 2;
+    }
+    ++i;
+  }
+
+  std::vector<std::string> paths;
+  if (!makeTextures(dir, count, size, paths))
+    return 1;
+
+  WindowDesc wd{};
+  wd.width = 64;
+  wd.height = 64;
+  wd.title = "Nyx Texture Load Bench";
+  wd.vsync = false;
+  wd.visible = false;
+  wd.nullPlatform = nullPlatform;
+  GLFWWindow window(wd);
+  GLResources gl;
+  GLUploadRing upload;
+  upload.init();
+
+  // 1, 2, 4, ... and maxThreads itself.
+  std::vector<uint32_t> sweep;
+  for (uint32_t t = 1; t < maxThreads; t *= 2)
+    sweep.push_back(t);
+  sweep.push_back(maxThreads);
+
+  // Warm the OS file cache so the first run does not pay for disk reads;
+  // with --cache this also fills the cooked cache, so the sweep measures
+  // cache hits.
+  desc.budgetBytes = uint64_t(budgetMB) << 20;
+  desc.threads = maxThreads;
+  const RunResult warm = timeToResident(gl, upload, paths, desc);
+
+  const double mb = double(count) * size * size * 4.0 / (1024.0 * 1024.0);
+  static const char *kCompressionNames[] = {"off", "fast", "high"};
+  std::printf("%u textures %ux%u (%.1f MB RGBA8) from %s\n", count, size,
+              size, mb, dir.string().c_str());
+  std::printf("compression %s, cooked cache %s, budget %u MB/frame, "
+              "VRAM %.1f MB\n",
+              kCompressionNames[size_t(desc.compression)],
+              desc.cache ? "on" : "off", budgetMB,
+              double(warm.poolBytes) / (1024.0 * 1024.0));
+  std::printf("%7s %12s %7s %10s %9s\n", "threads", "resident ms", "frames",
+              "MB/s", "speedup");
+  int status = 0;
+  double baseline = 0.0;
+  for (uint32_t threads : sweep) {
+    desc.threads = threads;
+    const RunResult r = timeToResident(gl, upload, paths, desc);
+    if (!r.ok) {
+      std::printf("%7u %12s\n", threads, "timeout");
+      status = 1;
+      continue;
+    }
+    if (baseline == 0.0)
+      baseline = r.ms;
+    std::printf("%7u %12.1f %7u %10.1f %8.2fx\n", threads, r.ms, r.frames,
+                mb / (r.ms * 1e-3), baseline / r.ms);
+  }
+
+  upload.shutdown();
+  return status;
+}
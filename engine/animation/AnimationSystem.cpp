@@ -1,6 +1,7 @@
 #include "AnimationSystem.h"
 
 #include "animation/AnimationTypes.h"
+#include "core/Profiler.h"
 #include "scene/Components.h"
 #include "scene/World.h"
 #include <algorithm>
@@ -92,6 +93,7 @@ void AnimationSystem::setFps(float fps) {
 }
 
 void AnimationSystem::tick(float dt) {
+  NYX_PROFILE_SCOPE("AnimationSystem::tick");
   if (!m_active && m_strips.empty())
     return;
 
@@ -4,6 +4,7 @@
 #include "EngineContext.h"
 
 #include "core/Log.h"
+#include "core/Profiler.h"
 
 #include "editor/EditorLayer.h"
 #include "editor/Selection.h"
@@ -52,6 +53,8 @@ void Application::initializeProjectAndSceneBindings() {
   }
 
   m_engine->world().setUUIDSeed(m_editorState.uuidSeed);
+  // Animated poses only reach the world's events inside render().
+  m_engine->setBeforeClearEvents([this] { m_sceneManager.trackWorldEvents(); });
 
   if (m_app->editorLayer()) {
     m_app->editorLayer()->setWorld(&m_engine->world());
@@ -151,6 +154,7 @@ void Application::renderEditorOverlay(bool &openUnsavedQuitPopup,
   if (!m_app->isEditorVisible())
     return;
 
+  NYX_PROFILE_SCOPE("ImGui");
   m_app->imguiBegin();
 
   ImGuiWindowFlags flags = ImGuiWindowFlags_MenuBar | ImGuiWindowFlags_NoDocking;
@@ -448,8 +452,10 @@ void Application::renderAndPresentFrame() {
     ed->viewport().lastRenderedSize = {renderW, renderH};
   }
 
-  if (editorVisible)
+  if (editorVisible) {
+    NYX_PROFILE_SCOPE("ImGui::Render");
     m_app->imguiEnd();
+  }
 
   auto &input = win.input();
   input.endFrame();
@@ -462,6 +468,7 @@ void Application::finalizeAndShutdown() {
   EditorStateIO::sanitizeBeforeSave(m_editorState);
   if (m_projectManager.hasProject()) {
     const bool savedScenes = m_sceneManager.saveAllProjectScenes();
+    m_sceneManager.waitForSaves();
     if (savedScenes) {
       if (auto *ed = m_app->editorLayer())
         ed->markSceneClean(*m_engine);
@@ -505,6 +512,7 @@ int Application::run() {
       continue;
     }
     m_app->beginFrame();
+    Profiler::instance().beginFrame();
 
     if (input.isPressed(Key::F)) {
       const bool wasVisible = m_app->isEditorVisible();
@@ -0,0 +1,272 @@
+#include "Benchmark.h"
+
+#include "app/EngineContext.h"
+#include "core/Log.h"
+#include "core/Profiler.h"
+#include "platform/GLFWWindow.h"
+#include "render/gl/GLGpuTimer.h"
+#include "serialization/SceneSerializer.h"
+
+#include <glad/glad.h>
+#include <nlohmann/json.hpp>
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Nyx {
+
+namespace {
+
+// Newest Profiler events scanned after each frame; one frame's CPU scopes
+// plus one frame's GPU passes fit comfortably.
+constexpr uint32_t kScanEvents = 1024;
+
+struct FrameTiming {
+  double cpuMs = 0.0;
+  double gpuMs = 0.0;
+};
+
+struct ScopeTotal {
+  double ms = 0.0;
+  uint32_t count = 0;
+};
+
+using ScopeTotals = std::unordered_map<const char *, ScopeTotal>;
+
+bool loadScene(EngineContext &engine, const std::string &path) {
+  engine.materials().reset();
+  World &world = engine.world();
+  if (!SceneSerializer::load(path, world)) {
+    Log::Error("Bench: failed to load scene '{}'", path);
+    return false;
+  }
+
+  const auto &sky = world.skySettings();
+  if (!sky.hdriPath.empty())
+    engine.envIBL().loadFromHDR(sky.hdriPath);
+  engine.rebuildEntityIndexMap();
+  engine.rebuildRenderables();
+
+  const EntityID cam = world.activeCamera();
+  if (cam == InvalidEntity || !world.hasCamera(cam)) {
+    for (EntityID e : world.alive()) {
+      if (world.hasCamera(e)) {
+        world.setActiveCamera(e);
+        break;
+      }
+    }
+  }
+  if (world.activeCamera() == InvalidEntity)
+    Log::Warn("Bench: scene has no camera; rendering with identity matrices");
+  return true;
+}
+
+// Adds one frame's events of `track` to the per-scope totals. Returns false
+// when the frame has none (e.g. its GPU query set was dropped).
+bool accumulate(const std::vector<ProfileEvent> &events, ProfileTrack track,
+                uint64_t frame, ScopeTotals &totals) {
+  bool any = false;
+  for (const ProfileEvent &e : events) {
+    if (e.track != track || e.frame != frame)
+      continue;
+    ScopeTotal &t = totals[e.name];
+    t.ms += double(e.endNs - e.startNs) * 1e-6;
+    ++t.count;
+    any = true;
+  }
+  return any;
+}
+
+nlohmann::json summarize(std::vector<double> ms) {
+  nlohmann::json j = nlohmann::json::object();
+  if (ms.empty())
+    return j;
+  std::sort(ms.begin(), ms.end());
+  double sum = 0.0;
+  for (double v : ms)
+    sum += v;
+  const auto pct = [&](double p) {
+    return ms[size_t(p * double(ms.size() - 1) + 0.5)];
+  };
+  j["mean"] = sum / double(ms.size());
+  j["min"] = ms.front();
+  j["max"] = ms.back();
+  j["p50"] = pct(0.50);
+  j["p95"] = pct(0.95);
+  j["p99"] = pct(0.99);
+  return j;
+}
+
+// Per-frame cost of each scope, most expensive first.
+nlohmann::json scopeAverages(const ScopeTotals &totals, uint32_t frames) {
+  std::vector<std::pair<const char *, ScopeTotal>> sorted(totals.begin(),
+                                                          totals.end());
+  std::sort(sorted.begin(), sorted.end(),
+            [](const auto &a, const auto &b) { return a.second.ms > b.second.ms; });
+
+  nlohmann::json arr = nlohmann::json::array();
+  for (const auto &[name, t] : sorted) {
+    arr.push_back({{"name", name},
+                   {"avgMs", frames ? t.ms / double(frames) : 0.0},
+                   {"count", t.count}});
+  }
+  return arr;
+}
+
+std::string glString(GLenum name) {
+  const GLubyte *s = glGetString(name);
+  return s ? reinterpret_cast<const char *>(s) : "";
+}
+
+bool dumpImage(uint32_t tex, uint32_t w, uint32_t h, const std::string &path) {
+  std::vector<uint8_t> rgba(size_t(w) * size_t(h) * 4u);
+  glGetTextureImage(tex, 0, GL_RGBA, GL_UNSIGNED_BYTE, GLsizei(rgba.size()),
+                    rgba.data());
+  stbi_flip_vertically_on_write(1);
+  const bool ok = stbi_write_png(path.c_str(), int(w), int(h), 4, rgba.data(),
+                                 int(w) * 4) != 0;
+  stbi_flip_vertically_on_write(0);
+  if (!ok)
+    Log::Error("Bench: failed to write image '{}'", path);
+  else
+    Log::Info("Bench: wrote {}", path);
+  return ok;
+}
+
+} // namespace
+
+int runBenchmark(const BenchmarkDesc &desc) {
+  if (desc.frames == 0 || desc.width == 0 || desc.height == 0) {
+    Log::Error("Bench: frames and resolution must be non-zero");
+    return 1;
+  }
+
+  WindowDesc wd{};
+  wd.width = int32_t(desc.width);
+  wd.height = int32_t(desc.height);
+  wd.title = "Nyx Bench";
+  wd.vsync = false;
+  wd.visible = false;
+  wd.nullPlatform = desc.nullPlatform;
+
+  // Declared first so the engine's GL objects go before the context.
+  GLFWWindow window(wd);
+  EngineContext engine;
+  if (!loadScene(engine, desc.scenePath))
+    return 1;
+
+  Profiler &prof = Profiler::instance();
+  prof.setEnabled(true);
+  const uint32_t droppedBefore = engine.renderer().gpuTimer().droppedFrames();
+
+  // Whole-frame GPU span from one timestamp pair per measured frame, read
+  // back after the loop so rendering never waits on the GPU.
+  std::vector<GLuint> queries(size_t(desc.frames) * 2u);
+  glGenQueries(GLsizei(queries.size()), queries.data());
+
+  const uint32_t w = desc.width;
+  const uint32_t h = desc.height;
+  const uint32_t measuredEnd = desc.warmupFrames + desc.frames;
+  // Trailing frames only flush the pass timer, which reads back late.
+  const uint32_t total = measuredEnd + GLGpuTimer::kFrames;
+
+  std::vector<FrameTiming> timings(desc.frames);
+  std::vector<ProfileEvent> events;
+  ScopeTotals cpuScopes;
+  ScopeTotals gpuScopes;
+  uint32_t gpuPassFrames = 0;
+  bool imageOk = true;
+
+  for (uint32_t i = 0; i < total; ++i) {
+    prof.beginFrame();
+    const uint64_t frame = prof.frame();
+    const bool measured = i >= desc.warmupFrames && i < measuredEnd;
+    const uint32_t m = i - desc.warmupFrames;
+
+    const uint64_t t0 = prof.nowNs();
+    engine.tick(desc.dt);
+    if (measured)
+      glQueryCounter(queries[m * 2], GL_TIMESTAMP);
+    const uint32_t tex = engine.render(w, h, w, h, w, h, false);
+    if (measured)
+      glQueryCounter(queries[m * 2 + 1], GL_TIMESTAMP);
+    const uint64_t t1 = prof.nowNs();
+
+    if (measured)
+      timings[m].cpuMs = double(t1 - t0) * 1e-6;
+
+    // Pass timings of frame F are read back during frame F + kFrames.
+    prof.snapshot(events, kScanEvents);
+    if (measured)
+      accumulate(events, ProfileTrack::Cpu, frame, cpuScopes);
+    if (i >= desc.warmupFrames + GLGpuTimer::kFrames &&
+        accumulate(events, ProfileTrack::Gpu, frame - GLGpuTimer::kFrames,
+                   gpuScopes))
+      ++gpuPassFrames;
+
+    if (i + 1 == measuredEnd) {
+      // Drain so the flush frames find every outstanding query set ready.
+      glFinish();
+      if (!desc.imagePath.empty())
+        imageOk = dumpImage(tex, w, h, desc.imagePath);
+    }
+  }
+
+  std::vector<double> cpuMs;
+  std::vector<double> gpuMs;
+  cpuMs.reserve(timings.size());
+  gpuMs.reserve(timings.size());
+  nlohmann::json perFrame = nlohmann::json::array();
+  for (uint32_t m = 0; m < desc.frames; ++m) {
+    GLuint64 t0 = 0;
+    GLuint64 t1 = 0;
+    glGetQueryObjectui64v(queries[m * 2], GL_QUERY_RESULT, &t0);
+    glGetQueryObjectui64v(queries[m * 2 + 1], GL_QUERY_RESULT, &t1);
+    FrameTiming &t = timings[m];
+    t.gpuMs = t1 >= t0 ? double(t1 - t0) * 1e-6 : 0.0;
+    cpuMs.push_back(t.cpuMs);
+    gpuMs.push_back(t.gpuMs);
+    perFrame.push_back({{"cpuMs", t.cpuMs}, {"gpuMs", t.gpuMs}});
+  }
+  glDeleteQueries(GLsizei(queries.size()), queries.data());
+
+  nlohmann::json j = nlohmann::json::object();
+  j["scene"] = desc.scenePath;
+  j["width"] = w;
+  j["height"] = h;
+  j["frames"] = desc.frames;
+  j["warmupFrames"] = desc.warmupFrames;
+  j["gl"] = {{"vendor", glString(GL_VENDOR)},
+             {"renderer", glString(GL_RENDERER)},
+             {"version", glString(GL_VERSION)}};
+  j["cpuMs"] = summarize(cpuMs);
+  j["gpuMs"] = summarize(gpuMs);
+  j["cpuScopes"] = scopeAverages(cpuScopes, desc.frames);
+  j["gpuPasses"] = scopeAverages(gpuScopes, gpuPassFrames);
+  j["gpuPassFrames"] = gpuPassFrames;
+  j["gpuPassSetsDropped"] =
+      engine.renderer().gpuTimer().droppedFrames() - droppedBefore;
+  j["perFrame"] = std::move(perFrame);
+
+  std::ofstream out(desc.timingsPath, std::ios::binary);
+  if (!out.is_open()) {
+    Log::Error("Bench: failed to open '{}'", desc.timingsPath);
+    return 1;
+  }
+  out << j.dump(2) << '\n';
+  if (!out.good()) {
+    Log::Error("Bench: failed to write '{}'", desc.timingsPath);
+    return 1;
+  }
+
+  Log::Info("Bench: {} frames at {}x{}, mean cpu {:.3f} ms, gpu {:.3f} ms -> {}",
+            desc.frames, w, h, j["cpuMs"]["mean"].get<double>(),
+            j["gpuMs"]["mean"].get<double>(), desc.timingsPath);
+  return imageOk ? 0 : 1;
+}
+
+} // namespace Nyx
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Nyx {
+
+struct BenchmarkDesc {
+  std::string scenePath;
+  uint32_t width = 1920;
+  uint32_t height = 1080;
+  uint32_t frames = 300;
+  uint32_t warmupFrames = 30;
+  // Fixed step so animated scenes render the same frames on every run.
+  float dt = 1.0f / 60.0f;
+  std::string timingsPath = "nyx_bench.json";
+  std::string imagePath; // PNG of the last frame; empty skips the dump
+  bool nullPlatform = false;
+};
+
+// Renders a scene offscreen through EngineContext::render, without the editor
+// or ImGui, and writes per-frame CPU/GPU timings plus per-pass averages as
+// JSON. Meant for perf regression runs on machines without a display or GPU
+// (Mesa llvmpipe). Paths must be absolute or relative to the repo root.
+// Returns a process exit code.
+int runBenchmark(const BenchmarkDesc &desc);
+
+} // namespace Nyx
@@ -1,5 +1,6 @@
 #include "EngineContext.h"
 
+#include "core/Profiler.h"
 #include "render/gl/GLResources.h"
 
 #include <glad/glad.h>
@@ -7,7 +8,8 @@
 namespace Nyx {
 
 EngineContext::EngineContext() {
-  m_materials.initGL(m_renderer.resources());
+  m_upload.init();
+  m_materials.initGL(m_renderer.resources(), m_upload);
   m_lights.initGL();
   m_envIBL.init(m_renderer.shaders());
 
@@ -18,9 +20,6 @@ EngineContext::EngineContext() {
   glNamedBufferData(m_shadowCSMUBO, sizeof(ShadowCSMUBO), nullptr,
                     GL_DYNAMIC_DRAW);
 
-  glCreateBuffers(1, &m_texRemapSSBO);
-  glNamedBufferData(m_texRemapSSBO, 0, nullptr, GL_DYNAMIC_DRAW);
-
   initPostFilters();
 
   m_animation.setWorld(&m_world);
@@ -36,10 +35,6 @@ EngineContext::~EngineContext() {
     glDeleteBuffers(1, &m_shadowCSMUBO);
     m_shadowCSMUBO = 0;
   }
-  if (m_texRemapSSBO) {
-    glDeleteBuffers(1, &m_texRemapSSBO);
-    m_texRemapSSBO = 0;
-  }
   if (m_postLUT3D) {
     glDeleteTextures(1, &m_postLUT3D);
     m_postLUT3D = 0;
@@ -52,15 +47,27 @@ EngineContext::~EngineContext() {
   m_postLUTIndex.clear();
   m_filterStack.shutdown();
   m_perDraw.shutdown();
+  m_drawCull.shutdown();
   m_lights.shutdownGL();
   m_materials.shutdownGL();
   m_envIBL.shutdown();
+  m_upload.shutdown();
 }
 
 void EngineContext::tick(float dt) {
+  NYX_PROFILE_SCOPE("EngineContext::tick");
   m_time += dt;
   m_dt = dt;
-  m_materials.processTextureUploads(8);
+  // Materials drawn last frame load their textures first.
+  m_visibleMaterials.clear();
+  if (m_materials.textures().pendingLoads() > 0) {
+    const std::vector<Renderable> &items = m_renderables.all();
+    for (uint32_t i = 0; i < items.size(); ++i) {
+      if (m_renderables.isVisible(i))
+        m_visibleMaterials.push_back(items[i].materialGpuIndex);
+    }
+  }
+  m_materials.processTextureUploads(m_visibleMaterials);
   m_materials.uploadIfDirty();
   m_animation.tick(dt);
 }
@@ -11,11 +11,14 @@
 #include "render/Renderer.h"
 #include "render/ShadowDebugMode.h"
 #include "render/SkyConstants.h"
+#include "render/ViewConstants.h"
 #include "render/TransparencyMode.h"
 #include "render/ViewMode.h"
+#include "render/draw/DrawCullBuffers.h"
 #include "render/draw/PerDrawSSBO.h"
 #include "render/filters/FilterStackSSBO.h"
 #include "render/gl/GLShaderUtil.h"
+#include "render/gl/GLUploadRing.h"
 #include "render/material/MaterialSystem.h"
 #include "render/shadows/CSMUtil.h"
 #include "scene/CameraSystem.h"
@@ -23,6 +26,7 @@
 #include "scene/RenderableRegistry.h"
 #include "scene/World.h"
 #include <cstdint>
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -47,6 +51,11 @@ public:
     m_pickY = py;
   }
   uint32_t lastPickedID() const { return m_lastPickedID; }
+  // CPU pick against the renderable BVH using the last rendered camera.
+  // Returns the pickID under (px, py) (top-left origin) or 0; unlike
+  // requestPick() it answers immediately without a GPU readback.
+  uint32_t pickRayCPU(uint32_t px, uint32_t py, uint32_t fbW,
+                      uint32_t fbH) const;
   void setSelection(const std::vector<EntityID> &ids) { m_selected = ids; }
   void setSelectionPickIDs(const std::vector<uint32_t> &ids,
                            uint32_t activePick = 0) {
@@ -136,6 +145,15 @@ public:
   float previewAmbient() const { return m_previewAmbient; }
 
   uint32_t materialIndex(const Renderable &r);
+  // Bumped whenever materialIndex() gives a submesh its own default material.
+  // That write happens mid-render, after this frame's events were consumed.
+  uint64_t defaultMaterialSerial() const { return m_defaultMaterialSerial; }
+  // Runs at the end of render(), right before the world's events are
+  // cleared. The first point that sees the TransformChanged events
+  // updateTransforms() raises for poses tick() wrote (animation).
+  void setBeforeClearEvents(std::function<void()> fn) {
+    m_beforeClearEvents = std::move(fn);
+  }
   void rebuildRenderables();
   void rebuildEntityIndexMap();
   void resetMaterials();
@@ -144,8 +162,14 @@ public:
   const EnvironmentIBL &envIBL() const { return m_envIBL; }
 
   uint32_t skyUBO() const { return m_skyUBO; }
+  // This frame's per-view constants; bound at kViewUBOBinding for all passes.
+  const ViewConstants &viewConstants() const { return m_view; }
   uint32_t shadowCSMUBO() const { return m_shadowCSMUBO; }
-  uint32_t texRemapSSBO() const { return m_texRemapSSBO; }
+
+  // Per-frame GPU upload memory (per-draw data, texture remaps, material
+  // table staging).
+  GLUploadRing &uploadRing() { return m_upload; }
+  const GLUploadRing &uploadRing() const { return m_upload; }
 
   Renderer &renderer() { return m_renderer; }
   const Renderer &renderer() const { return m_renderer; }
@@ -190,6 +214,25 @@ public:
   // Centralized draw point for baseInstance draws.
   void rendererDrawPrimitive(uint32_t meshHandle, uint32_t baseInstance);
 
+  // Visibility culling. Frustum culling runs on the CPU in
+  // RenderableRegistry::buildRoutedLists(); the GPU occlusion test culls the
+  // remaining forward draws against the depth pre-pass HiZ.
+  bool frustumCulling() const { return m_frustumCulling; }
+  void setFrustumCulling(bool on) { m_frustumCulling = on; }
+  bool gpuOcclusionCulling() const { return m_gpuOcclusionCulling; }
+  void setGpuOcclusionCulling(bool on) { m_gpuOcclusionCulling = on; }
+  // True when this frame's forward draws are occlusion-tested on the GPU.
+  bool gpuOcclusionActive() const { return m_gpuOcclusionActive; }
+  const CullStats &mainViewCullStats() const {
+    return m_renderables.cullStats();
+  }
+  uint32_t occlusionCulledCount() const {
+    return m_renderer.occlusionCulledCount();
+  }
+  const DrawCullBuffers &drawCull() const { return m_drawCull; }
+  // Spatial index over renderables (shadow caster queries, CPU picking).
+  const DynamicBVH &renderableBVH() const { return m_renderables.bvh(); }
+
   AnimationSystem &animation() { return m_animation; }
   const AnimationSystem &animation() const { return m_animation; }
 
@@ -200,11 +243,13 @@ private:
   void buildRenderables();
   void handleWorldEvent(const WorldEvent &e);
   void updateSkyUBO(const RenderPassContext &ctx);
+  void updateViewUBO(const RenderPassContext &ctx);
 
 private:
   float m_time = 0.0f;
   float m_dt = 0.016f;
   Renderer m_renderer{};
+  GLUploadRing m_upload{};
   MaterialSystem m_materials{};
   LightSystem m_lights{};
   CameraSystem m_cameras{};
@@ -212,8 +257,8 @@ private:
 
   SkyConstants m_sky{};
   uint32_t m_skyUBO = 0;
+  ViewConstants m_view{};
   uint32_t m_shadowCSMUBO = 0;
-  uint32_t m_texRemapSSBO = 0;
   uint32_t m_postLUT3D = 0; // identity LUT (index 0)
   std::vector<uint32_t> m_postLUTs{};
   std::vector<std::string> m_postLUTPaths{};
@@ -223,9 +268,12 @@ private:
   World m_world{};
   std::unordered_map<uint32_t, EntityID> m_entityByIndex;
   RenderableRegistry m_renderables{};
+  std::vector<uint32_t> m_visibleMaterials{}; // scratch for tick()
   std::vector<EntityID> m_selected{};
   std::vector<uint32_t> m_selectedPickIDs{};
   uint32_t m_selectedActivePick = 0;
+  uint64_t m_defaultMaterialSerial = 0;
+  std::function<void()> m_beforeClearEvents;
   PostGraph m_postGraph{};
   FilterRegistry m_filterRegistry{};
   FilterGraph m_filterGraph{};
@@ -274,6 +322,10 @@ private:
   uint32_t m_perDrawTransparentOffset = 0;
   uint32_t m_perDrawOpaqueCount = 0;
   uint32_t m_perDrawTransparentCount = 0;
+  DrawCullBuffers m_drawCull{};
+  bool m_frustumCulling = true;
+  bool m_gpuOcclusionCulling = false;
+  bool m_gpuOcclusionActive = false;
 
   AnimationSystem m_animation{};
   AnimationClip m_animationClip{
@@ -1,6 +1,7 @@
 #include "EngineContext.h"
 
 #include "core/Assert.h"
+#include "core/Profiler.h"
 #include "render/draw/DrawData.h"
 #include "render/passes/PassShadowCSM.h"
 #include "render/rg/RenderPassContext.h"
@@ -14,6 +15,7 @@
 namespace Nyx {
 
 void EngineContext::buildRenderables() {
+  NYX_PROFILE_SCOPE("EngineContext::buildRenderables");
   m_world.updateTransforms();
   m_renderables.applyEvents(m_world, m_world.events());
 }
@@ -29,6 +31,7 @@ uint32_t EngineContext::materialIndex(const Renderable &r) {
   if (sm.material == InvalidMaterial || !m_materials.isAlive(sm.material)) {
     MaterialData def{};
     sm.material = m_materials.create(def);
+    ++m_defaultMaterialSerial;
   }
   return m_materials.gpuIndex(sm.material);
 }
@@ -53,6 +56,9 @@ uint32_t EngineContext::render(uint32_t windowWidth, uint32_t windowHeight,
                                uint32_t viewportWidth, uint32_t viewportHeight,
                                uint32_t fbWidth, uint32_t fbHeight,
                                bool editorVisible) {
+  NYX_PROFILE_SCOPE("EngineContext::render");
+  m_upload.beginFrame();
+
   const auto &events = m_world.events().events();
   for (const auto &e : events)
     handleWorldEvent(e);
@@ -116,7 +122,11 @@ uint32_t EngineContext::render(uint32_t windowWidth, uint32_t windowHeight,
     }
   }
 
-  m_renderables.buildRoutedLists(ctx.cameraPos, ctx.cameraDir);
+  // Without a camera the matrices are identity; draw everything.
+  const Frustum frustum = Frustum::fromViewProj(ctx.viewProj);
+  m_renderables.buildRoutedLists(ctx.cameraPos, ctx.cameraDir,
+                                 (mats && m_frustumCulling) ? &frustum
+                                                            : nullptr);
 
   {
     const auto &opaque = m_renderables.opaque();
@@ -125,7 +135,33 @@ uint32_t EngineContext::render(uint32_t windowWidth, uint32_t windowHeight,
     std::vector<DrawData> draws;
     draws.reserve(opaque.size() + transparent.size());
 
+    m_gpuOcclusionActive = m_gpuOcclusionCulling && mats;
+    const bool occlusion = m_gpuOcclusionActive;
+    std::vector<DrawBounds> drawBounds;
+    std::vector<DrawIndirectCmd> drawCmds;
+    drawCmds.reserve(draws.capacity());
+    if (occlusion)
+      drawBounds.reserve(draws.capacity());
+
+    // One indirect command per DrawData entry; the forward and depth passes
+    // multi-draw straight out of this buffer.
     auto pushDraw = [&](const Renderable &r) {
+      if (occlusion) {
+        DrawBounds b{};
+        b.center = glm::vec4(r.bounds.center, 0.0f);
+        b.extents = glm::vec4(r.bounds.extents, 0.0f);
+        drawBounds.push_back(b);
+      }
+
+      const GLMeshRange &mesh = m_renderer.primitiveRange(r.mesh);
+      DrawIndirectCmd cmd{};
+      cmd.count = mesh.indexCount;
+      cmd.instanceCount = 1;
+      cmd.firstIndex = mesh.firstIndex;
+      cmd.baseVertex = mesh.baseVertex;
+      cmd.baseInstance = static_cast<uint32_t>(draws.size());
+      drawCmds.push_back(cmd);
+
       DrawData d{};
       d.model = r.model;
       d.materialIndex = r.materialGpuIndex;
@@ -151,12 +187,14 @@ uint32_t EngineContext::render(uint32_t windowWidth, uint32_t windowHeight,
     m_perDrawTransparentCount =
         static_cast<uint32_t>(draws.size() - m_perDrawTransparentOffset);
 
-    m_perDraw.upload(draws);
+    m_perDraw.upload(m_upload, draws);
+    m_drawCull.upload(m_upload, drawBounds, drawCmds);
   }
 
   m_lights.updateFromWorld(m_world);
 
   updateSkyUBO(ctx);
+  updateViewUBO(ctx);
   updatePostFilters();
 
   m_renderer.setSelectedPickIDs(m_selectedPickIDs, m_selectedActivePick);
@@ -218,11 +256,36 @@ uint32_t EngineContext::render(uint32_t windowWidth, uint32_t windowHeight,
     m_pickRequested = false;
   }
 
+  if (m_beforeClearEvents)
+    m_beforeClearEvents();
   m_world.clearEvents();
 
   return outTex;
 }
 
+uint32_t EngineContext::pickRayCPU(uint32_t px, uint32_t py, uint32_t fbW,
+                                   uint32_t fbH) const {
+  if (fbW == 0u || fbH == 0u)
+    return 0u;
+
+  const glm::vec2 ndc((float(px) + 0.5f) / float(fbW) * 2.0f - 1.0f,
+                      1.0f - (float(py) + 0.5f) / float(fbH) * 2.0f);
+  const glm::mat4 invVP = glm::inverse(m_cachedProj * m_cachedView);
+  glm::vec4 nearP = invVP * glm::vec4(ndc.x, ndc.y, -1.0f, 1.0f);
+  glm::vec4 farP = invVP * glm::vec4(ndc.x, ndc.y, 1.0f, 1.0f);
+  if (nearP.w == 0.0f || farP.w == 0.0f)
+    return 0u;
+  const glm::vec3 origin = glm::vec3(nearP) / nearP.w;
+  const glm::vec3 dir = glm::normalize(glm::vec3(farP) / farP.w - origin);
+
+  RenderableRegistry::RayHit hit{};
+  const bool found = m_renderables.raycast(
+      origin, dir, hit, [&](const Renderable &r) {
+        return !r.isCamera && !isEntityHidden(r.entity);
+      });
+  return found ? m_renderables.all()[hit.index].pickID : 0u;
+}
+
 void EngineContext::requestMaterialPreview(MaterialHandle h,
                                            uint32_t targetTex) {
   if (h == InvalidMaterial || targetTex == 0)
@@ -289,4 +352,18 @@ void EngineContext::updateSkyUBO(const RenderPassContext &ctx) {
   glBindBufferBase(GL_UNIFORM_BUFFER, 2, m_skyUBO);
 }
 
+// Uploaded through the ring, so nothing waits on last frame's reads.
+void EngineContext::updateViewUBO(const RenderPassContext &ctx) {
+  m_view.view = ctx.view;
+  m_view.proj = ctx.proj;
+  m_view.viewProj = ctx.viewProj;
+  m_view.invViewProj = glm::inverse(ctx.viewProj);
+  m_view.camPos = glm::vec4(ctx.cameraPos, 1.0f);
+  m_view.nearFarTime = glm::vec4(m_cachedNear, m_cachedFar, m_time, m_dt);
+  m_view.frame = glm::uvec4(ctx.frameIndex, ctx.fbWidth, ctx.fbHeight, 0u);
+
+  GLUploadRing::bindRange(GL_UNIFORM_BUFFER, kViewUBOBinding,
+                          m_upload.upload(&m_view, sizeof(ViewConstants)));
+}
+
 } // namespace Nyx
@@ -0,0 +1,114 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace Nyx {
+
+JobSystem::JobSystem(uint32_t workerCount) {
+  m_workers.reserve(workerCount);
+  for (uint32_t i = 0; i < workerCount; ++i)
+    m_workers.emplace_back([this] { workerLoop(); });
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  for (auto &t : m_workers) {
+    if (t.joinable())
+      t.join();
+  }
+}
+
+JobSystem &JobSystem::instance() {
+  static JobSystem js(std::max(1u, std::thread::hardware_concurrency()) - 1u);
+  return js;
+}
+
+void JobSystem::submit(std::function<void()> job) {
+  if (m_workers.empty()) {
+    job();
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_queue.push_back(std::move(job));
+  }
+  m_cv.notify_one();
+}
+
+void JobSystem::parallelFor(uint32_t count, uint32_t grain,
+                            const std::function<void(uint32_t, uint32_t)> &fn) {
+  if (count == 0)
+    return;
+  grain = std::max(1u, grain);
+  const uint32_t chunks = (count + grain - 1u) / grain;
+  const uint32_t helpers =
+      std::min({workerCount(), m_helperLimit.load(), chunks - 1u});
+  if (helpers == 0) {
+    fn(0, count);
+    return;
+  }
+
+  struct Loop {
+    std::atomic<uint32_t> next{0};
+    std::atomic<uint32_t> done{0};
+    std::mutex mutex;
+    std::condition_variable cv;
+  };
+  auto loop = std::make_shared<Loop>();
+
+  // Helpers may outlive this call (they find no work left and exit), so they
+  // only touch `fn` while a chunk is still unclaimed.
+  auto run = [loop, &fn, count, grain, chunks]() {
+    for (;;) {
+      const uint32_t c = loop->next.fetch_add(1, std::memory_order_relaxed);
+      if (c >= chunks)
+        return;
+      const uint32_t begin = c * grain;
+      fn(begin, std::min(count, begin + grain));
+      if (loop->done.fetch_add(1, std::memory_order_acq_rel) + 1u == chunks) {
+        std::lock_guard<std::mutex> lk(loop->mutex);
+        loop->cv.notify_all();
+      }
+    }
+  };
+
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (uint32_t i = 0; i < helpers; ++i)
+      m_queue.emplace_back(run);
+  }
+  if (helpers == 1)
+    m_cv.notify_one();
+  else
+    m_cv.notify_all();
+
+  run();
+
+  std::unique_lock<std::mutex> lk(loop->mutex);
+  loop->cv.wait(lk, [&] {
+    return loop->done.load(std::memory_order_acquire) == chunks;
+  });
+}
+
+void JobSystem::workerLoop() {
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lk(m_mutex);
+      m_cv.wait(lk, [&] { return m_stop || !m_queue.empty(); });
+      if (m_stop && m_queue.empty())
+        return;
+      job = std::move(m_queue.front());
+      m_queue.pop_front();
+    }
+    job();
+  }
+}
+
+} // namespace Nyx
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Nyx {
+
+// Fixed pool of worker threads shared by engine systems.
+// parallelFor() lets the calling thread take chunks too, so it is safe to call
+// from inside a job (nested loops never wait on a starved queue).
+class JobSystem final {
+public:
+  explicit JobSystem(uint32_t workerCount);
+  ~JobSystem();
+
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  // Process-wide pool sized to hardware_concurrency() - 1 workers.
+  static JobSystem &instance();
+
+  uint32_t workerCount() const { return (uint32_t)m_workers.size(); }
+
+  // Caps how many workers a parallelFor() recruits next to the caller, so
+  // scaling can be measured on one pool; ~0u (the default) means all.
+  void setHelperLimit(uint32_t limit) { m_helperLimit = limit; }
+  uint32_t helperLimit() const { return m_helperLimit; }
+
+  // Fire-and-forget job.
+  void submit(std::function<void()> job);
+
+  // Calls fn(begin, end) over [0, count) in chunks of at most `grain` items
+  // and returns once every chunk finished. Runs inline if one chunk suffices.
+  void parallelFor(uint32_t count, uint32_t grain,
+                   const std::function<void(uint32_t, uint32_t)> &fn);
+
+private:
+  void workerLoop();
+
+  std::vector<std::thread> m_workers;
+  std::deque<std::function<void()>> m_queue;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stop = false;
+  std::atomic<uint32_t> m_helperLimit{~0u};
+};
+
+} // namespace Nyx
@@ -0,0 +1,165 @@
+#include "Profiler.h"
+
+#include "core/Log.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace Nyx {
+
+namespace {
+
+thread_local uint16_t t_depth = 0;
+
+void writeJsonString(std::ostream &out, const char *s) {
+  out << '"';
+  for (; *s; ++s) {
+    const char c = *s;
+    if (c == '"' || c == '\\')
+      out << '\\' << c;
+    else if (static_cast<unsigned char>(c) < 0x20)
+      out << ' ';
+    else
+      out << c;
+  }
+  out << '"';
+}
+
+} // namespace
+
+Profiler::Profiler()
+    : m_slots(std::make_unique<Slot[]>(kCapacity)),
+      m_epoch(std::chrono::steady_clock::now()) {}
+
+Profiler &Profiler::instance() {
+  static Profiler p;
+  return p;
+}
+
+uint32_t Profiler::threadIndex() {
+  static std::atomic<uint32_t> next{1};
+  thread_local const uint32_t index =
+      next.fetch_add(1, std::memory_order_relaxed);
+  return index;
+}
+
+uint64_t Profiler::nowNs() const {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - m_epoch)
+      .count();
+}
+
+void Profiler::beginFrame() {
+  const uint64_t now = nowNs();
+  const uint64_t ended = m_frame.fetch_add(1, std::memory_order_relaxed);
+  if (ended > 0) {
+    m_lastFrameMs = double(now - m_frameStartNs) * 1e-6;
+    if (enabled()) {
+      ProfileEvent e{};
+      e.name = "Frame";
+      e.startNs = m_frameStartNs;
+      e.endNs = now;
+      e.frame = ended;
+      e.thread = threadIndex();
+      record(e);
+    }
+  }
+  m_frameStartNs = now;
+}
+
+void Profiler::record(const ProfileEvent &e) {
+  const uint64_t i = m_head.fetch_add(1, std::memory_order_relaxed);
+  Slot &s = m_slots[i & (kCapacity - 1)];
+  s.seq.store(2 * i + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  s.event = e;
+  s.seq.store(2 * i + 2, std::memory_order_release);
+}
+
+const char *Profiler::intern(std::string_view name) {
+  std::lock_guard<std::mutex> lk(m_internMutex);
+  return m_interned.emplace(name).first->c_str();
+}
+
+void Profiler::snapshot(std::vector<ProfileEvent> &out, uint32_t limit) const {
+  out.clear();
+  limit = std::min(limit, kCapacity);
+  const uint64_t head = m_head.load(std::memory_order_acquire);
+  const uint64_t first = head > limit ? head - limit : 0;
+  out.reserve(size_t(head - first));
+  for (uint64_t i = first; i < head; ++i) {
+    const Slot &s = m_slots[i & (kCapacity - 1)];
+    const uint64_t seq = s.seq.load(std::memory_order_acquire);
+    if (seq != 2 * i + 2)
+      continue; // still being written, or already overwritten
+    ProfileEvent e = s.event;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s.seq.load(std::memory_order_relaxed) != seq)
+      continue;
+    out.push_back(e);
+  }
+}
+
+bool Profiler::exportChromeTrace(const std::string &path) const {
+  std::vector<ProfileEvent> events;
+  snapshot(events);
+  std::sort(events.begin(), events.end(),
+            [](const ProfileEvent &a, const ProfileEvent &b) {
+              return a.startNs < b.startNs;
+            });
+
+  std::ofstream out(path, std::ios::binary);
+  if (!out.is_open()) {
+    Log::Warn("Profiler: failed to open trace path: {}", path);
+    return false;
+  }
+
+  out.setf(std::ios::fixed);
+  out.precision(3);
+  out << "{\"traceEvents\":[\n";
+  out << R"({"name":"thread_name","ph":"M","pid":1,"tid":0,)"
+      << R"("args":{"name":"GPU"}})";
+  for (const ProfileEvent &e : events) {
+    const bool gpu = e.track == ProfileTrack::Gpu;
+    out << ",\n{\"name\":";
+    writeJsonString(out, e.name);
+    out << ",\"cat\":\"" << (gpu ? "gpu" : "cpu") << "\",\"ph\":\"X\""
+        << ",\"ts\":" << double(e.startNs) * 1e-3
+        << ",\"dur\":" << double(e.endNs - e.startNs) * 1e-3
+        << ",\"pid\":1,\"tid\":" << (gpu ? 0u : e.thread)
+        << ",\"args\":{\"frame\":" << e.frame << "}}";
+  }
+  out << "\n]}\n";
+
+  if (!out.good()) {
+    Log::Warn("Profiler: failed to write trace: {}", path);
+    return false;
+  }
+  Log::Info("Profiler: wrote {} events to {}", events.size(), path);
+  return true;
+}
+
+ProfileScope::ProfileScope(const char *name) {
+  if (!name || !Profiler::instance().enabled())
+    return;
+  m_name = name;
+  m_depth = ++t_depth;
+  m_startNs = Profiler::instance().nowNs();
+}
+
+ProfileScope::~ProfileScope() {
+  if (!m_name)
+    return;
+  Profiler &p = Profiler::instance();
+  ProfileEvent e{};
+  e.name = m_name;
+  e.startNs = m_startNs;
+  e.endNs = p.nowNs();
+  e.frame = p.frame();
+  e.thread = Profiler::threadIndex();
+  e.depth = m_depth;
+  p.record(e);
+  --t_depth;
+}
+
+} // namespace Nyx
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace Nyx {
+
+enum class ProfileTrack : uint8_t { Cpu, Gpu };
+
+struct ProfileEvent {
+  const char *name = ""; // string literal or Profiler::intern()
+  uint64_t startNs = 0;  // Profiler clock (GPU events are shifted onto it)
+  uint64_t endNs = 0;
+  uint64_t frame = 0;
+  uint32_t thread = 0; // Profiler::threadIndex(); 0 on the GPU track
+  uint16_t depth = 0;  // nesting within its thread; "Frame" is 0
+  ProfileTrack track = ProfileTrack::Cpu;
+};
+
+// Frame profiler. CPU scopes (NYX_PROFILE_SCOPE) and GPU pass timings
+// (GLGpuTimer) go into one fixed-size ring that any thread writes without
+// locking: a writer claims a slot with a fetch_add and publishes it through
+// the slot's sequence number, readers skip slots torn by a concurrent write.
+// The oldest events are overwritten once the ring wraps.
+class Profiler final {
+public:
+  static constexpr uint32_t kCapacity = 1u << 16;
+
+  static Profiler &instance();
+
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  void setEnabled(bool enabled) {
+    m_enabled.store(enabled, std::memory_order_relaxed);
+  }
+  bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+  // Called by the main loop at the top of every frame; records the "Frame"
+  // event of the one that just ended.
+  void beginFrame();
+  uint64_t frame() const { return m_frame.load(std::memory_order_relaxed); }
+  double lastFrameMs() const { return m_lastFrameMs; }
+
+  uint64_t nowNs() const;
+  void record(const ProfileEvent &e);
+
+  // Stable copy of a runtime string (pass names) for ProfileEvent::name.
+  const char *intern(std::string_view name);
+
+  // The newest `limit` events still in the ring, in the order they were
+  // recorded.
+  void snapshot(std::vector<ProfileEvent> &out,
+                uint32_t limit = kCapacity) const;
+
+  // Chrome trace-event JSON, for chrome://tracing or Perfetto.
+  bool exportChromeTrace(const std::string &path) const;
+
+  // Small per-thread id, assigned on first use (starting at 1).
+  static uint32_t threadIndex();
+
+private:
+  Profiler();
+
+  struct Slot {
+    std::atomic<uint64_t> seq{0}; // 2i+1 while event i is written, 2i+2 after
+    ProfileEvent event{};
+  };
+
+  std::unique_ptr<Slot[]> m_slots;
+  std::atomic<uint64_t> m_head{0};
+  std::atomic<uint64_t> m_frame{0};
+  std::atomic<bool> m_enabled{true};
+  std::chrono::steady_clock::time_point m_epoch;
+  uint64_t m_frameStartNs = 0;
+  double m_lastFrameMs = 0.0;
+
+  std::mutex m_internMutex;
+  std::unordered_set<std::string> m_interned;
+};
+
+// Records [construction, destruction) on the calling thread. A null name or a
+// disabled profiler makes it a no-op.
+class ProfileScope final {
+public:
+  explicit ProfileScope(const char *name);
+  ~ProfileScope();
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+  const char *m_name = nullptr;
+  uint64_t m_startNs = 0;
+  uint16_t m_depth = 0;
+};
+
+} // namespace Nyx
+
+#define NYX_PROFILE_CONCAT_(a, b) a##b
+#define NYX_PROFILE_CONCAT(a, b) NYX_PROFILE_CONCAT_(a, b)
+#define NYX_PROFILE_SCOPE(name)                                                \
+  ::Nyx::ProfileScope NYX_PROFILE_CONCAT(nyxProfileScope_, __LINE__)(name)
@@ -0,0 +1,62 @@
+#include "RadixSort.h"
+
+#include "core/Assert.h"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace Nyx {
+
+void radixSortKeys(std::vector<uint64_t> &keys, std::vector<uint32_t> &values,
+                   std::vector<uint64_t> &keyScratch,
+                   std::vector<uint32_t> &valueScratch) {
+  NYX_ASSERT(keys.size() == values.size(), "radixSortKeys: size mismatch");
+  const size_t n = keys.size();
+  if (n < 2)
+    return;
+
+  // All eight histograms in one read of the keys.
+  std::array<std::array<uint32_t, 256>, 8> counts{};
+  for (uint64_t k : keys) {
+    for (uint32_t b = 0; b < 8; ++b)
+      ++counts[b][(k >> (b * 8)) & 0xFFu];
+  }
+
+  keyScratch.resize(n);
+  valueScratch.resize(n);
+  uint64_t *srcKeys = keys.data();
+  uint32_t *srcValues = values.data();
+  uint64_t *dstKeys = keyScratch.data();
+  uint32_t *dstValues = valueScratch.data();
+
+  for (uint32_t b = 0; b < 8; ++b) {
+    std::array<uint32_t, 256> &count = counts[b];
+    const uint32_t shift = b * 8;
+    // Every key has the same byte here: the pass would not move anything.
+    if (count[(srcKeys[0] >> shift) & 0xFFu] == n)
+      continue;
+
+    uint32_t offset = 0;
+    for (uint32_t &c : count) {
+      const uint32_t c0 = c;
+      c = offset;
+      offset += c0;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      const uint32_t dst = count[(srcKeys[i] >> shift) & 0xFFu]++;
+      dstKeys[dst] = srcKeys[i];
+      dstValues[dst] = srcValues[i];
+    }
+    std::swap(srcKeys, dstKeys);
+    std::swap(srcValues, dstValues);
+  }
+
+  // An odd number of passes leaves the result in the scratch arrays.
+  if (srcKeys != keys.data()) {
+    keys.swap(keyScratch);
+    values.swap(valueScratch);
+  }
+}
+
+} // namespace Nyx
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Nyx {
+
+// Stable LSD radix sort of (key, value) pairs held in two parallel arrays,
+// ascending by key. Works one byte at a time and skips bytes that are equal
+// across all keys, so sparse key layouts only pay for the bytes they use.
+// The scratch vectors are grown as needed and can be kept across calls.
+void radixSortKeys(std::vector<uint64_t> &keys, std::vector<uint32_t> &values,
+                   std::vector<uint64_t> &keyScratch,
+                   std::vector<uint32_t> &valueScratch);
+
+} // namespace Nyx
@@ -216,6 +216,8 @@ public:
   const std::vector<HistoryEntry> &entries() const { return m_entries; }
   int cursor() const { return m_cursor; }
   uint64_t revision() const { return m_revision; }
+  // Bumped by undo()/redo(), which edit World without leaving events behind.
+  uint64_t applySerial() const { return m_applySerial; }
 
 private:
   struct EntityState {
@@ -281,6 +283,7 @@ private:
 
   bool m_loadedFromDisk = false;
   uint64_t m_revision = 0;
+  uint64_t m_applySerial = 0;
   bool m_absorbMaterialOnlyChanges = false;
   bool m_transformBatchActive = false;
   std::string m_transformBatchLabel = "Transform";
@@ -102,6 +102,7 @@ bool EditorHistory::undo(World &world, MaterialSystem &materials,
     m_lastAnimation = captureAnimationState(*m_world);
   m_lastSky = world.skySettings();
   ++m_revision;
+  ++m_applySerial;
   return true;
 }
 
@@ -188,6 +189,7 @@ bool EditorHistory::redo(World &world, MaterialSystem &materials,
     m_lastAnimation = captureAnimationState(*m_world);
   m_lastSky = world.skySettings();
   ++m_revision;
+  ++m_applySerial;
   return true;
 }
 
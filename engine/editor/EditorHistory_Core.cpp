@@ -1,6 +1,7 @@
 #include "EditorHistory.h"
 
 #include "animation/AnimationSystem.h"
+#include "core/Profiler.h"
 #include "scene/World.h"
 
 #include <algorithm>
@@ -226,6 +227,7 @@ void EditorHistory::endTransformBatch(const World &world,
 void EditorHistory::processEvents(const World &world, const WorldEvents &ev,
                                   MaterialSystem &materials,
                                   const Selection &sel) {
+  NYX_PROFILE_SCOPE("EditorHistory::processEvents");
   if (!m_recording || m_applying)
     return;
 
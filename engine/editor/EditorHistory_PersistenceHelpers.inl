@@ -555,10 +555,16 @@ static Value jCategorySnapshot(const CategorySnapshot &s) {
     for (uint32_t v : c.children)
       ch.emplace_back((double)v);
     jc["children"] = Value(std::move(ch));
+    // [index, generation]: slots are recycled with a bumped generation, so
+    // the index alone no longer names the entity.
     Array ents;
     ents.reserve(c.entities.size());
-    for (const auto &e : c.entities)
-      ents.emplace_back((double)e.index);
+    for (const auto &e : c.entities) {
+      Array id;
+      id.emplace_back((double)e.index);
+      id.emplace_back((double)e.generation);
+      ents.emplace_back(Value(std::move(id)));
+    }
     jc["entities"] = Value(std::move(ents));
     cats.emplace_back(Value(std::move(jc)));
   }
@@ -594,8 +600,14 @@ static void readCategorySnapshot(const Value &v, CategorySnapshot &s) {
       if (const Value *ve = it.get("entities"); ve && ve->isArray()) {
         for (const Value &ch : ve->asArray()) {
           EntityID e{};
-          e.index = (uint32_t)ch.asNum();
-          e.generation = 1;
+          if (ch.isArray() && ch.asArray().size() >= 2) {
+            e.index = (uint32_t)ch.asArray()[0].asNum();
+            e.generation = (uint32_t)ch.asArray()[1].asNum();
+          } else {
+            // Written before generations were stored; every slot was fresh.
+            e.index = (uint32_t)ch.asNum();
+            e.generation = 1;
+          }
           c.entities.push_back(e);
         }
       }
@@ -4,6 +4,7 @@
 #include "core/Log.h"
 #include "scene/EntityID.h"
 #include "scene/Pick.h"
+#include "scene/SceneManager.h"
 #include "tools/EditorPersist.h"
 #include <cmath>
 #include <filesystem>
@@ -267,6 +268,159 @@ void EditorLayer::drawStats(EngineContext &engine, GizmoState &g) {
     engine.setShadowDebugAlpha(alpha);
   }
 
+  ImGui::SeparatorText("Culling");
+  bool frustumCull = engine.frustumCulling();
+  if (ImGui::Checkbox("Frustum Culling", &frustumCull))
+    engine.setFrustumCulling(frustumCull);
+  bool occlusionCull = engine.gpuOcclusionCulling();
+  if (ImGui::Checkbox("GPU Occlusion Culling", &occlusionCull))
+    engine.setGpuOcclusionCulling(occlusionCull);
+  const CullStats &cull = engine.mainViewCullStats();
+  ImGui::Text("Renderables: %u  Visible: %u  Frustum culled: %u", cull.tested,
+              cull.visible, cull.frustumCulled);
+  if (engine.gpuOcclusionCulling())
+    ImGui::Text("Occlusion culled: %u", engine.occlusionCulledCount());
+  const DynamicBVH &bvh = engine.renderableBVH();
+  ImGui::Text("BVH: %u nodes  height %u  SAH %.2f  rebuilds %u",
+              bvh.nodeCount(), bvh.height(), bvh.sahCost(), bvh.rebuildCount());
+
+  ImGui::SeparatorText("Render Graph");
+  bool graphCache = engine.renderer().graphCacheEnabled();
+  if (ImGui::Checkbox("Cache Compiled Graph", &graphCache))
+    engine.renderer().setGraphCacheEnabled(graphCache);
+  const RenderGraphStats &rg = engine.renderer().graphStats();
+  ImGui::Text("%u passes  %u textures  %u buffers  %s  (compiles %u)",
+              rg.passCount, rg.textureCount, rg.bufferCount,
+              rg.cacheHit ? "cached" : "compiled", rg.compiles);
+  ImGui::Text("Build %.3f ms  compile %.3f ms  execute %.3f ms", rg.buildMs,
+              rg.compileMs, rg.executeMs);
+  const RGTransientStats &tr = engine.renderer().transientStats();
+  constexpr double kMB = 1024.0 * 1024.0;
+  ImGui::Text("Transient: %u live %.1f MB  %u pooled %.1f MB",
+              tr.liveTextures, double(tr.liveBytes) / kMB, tr.pooledTextures,
+              double(tr.pooledBytes) / kMB);
+  ImGui::Text("Peak %.1f MB live  %.1f MB resident",
+              double(tr.peakLiveBytes) / kMB,
+              double(tr.peakResidentBytes) / kMB);
+  ImGui::Text("Reuse %.0f%% of %u acquires  created %u  evicted %u",
+              tr.reuseRate() * 100.0f, tr.acquires, tr.creations,
+              tr.evictions);
+  int budgetMB = int(engine.renderer().transientBudgetBytes() >> 20);
+  if (ImGui::DragInt("Transient Budget (MB)", &budgetMB, 8.0f, 0, 8192))
+    engine.renderer().setTransientBudgetBytes(uint64_t(budgetMB) << 20);
+
+  ImGui::SeparatorText("Draw Submission");
+  bool multiDraw = engine.renderer().multiDrawIndirect();
+  if (ImGui::Checkbox("Multi-Draw Indirect", &multiDraw))
+    engine.renderer().setMultiDrawIndirect(multiDraw);
+  const RenderSubmitStats submit = engine.renderer().submitStats();
+  auto submitRow = [](const char *label, const DrawSubmitStats &s) {
+    ImGui::Text("%-12s %5u meshes  %5u calls  %.3f ms", label, s.commands,
+                s.drawCalls, s.cpuMs);
+  };
+  submitRow("Depth pre", submit.depthPre);
+  submitRow("Opaque", submit.forwardOpaque);
+  submitRow("Transparent", submit.forwardTransparent);
+  submitRow("Shadows", submit.shadows);
+
+  ImGui::SeparatorText("GPU Uploads");
+  const GLUploadRingStats &up = engine.uploadRing().stats();
+  ImGui::Text("%.1f KB/frame in %u allocations  (ring %u KB x %u)",
+              double(up.bytesLastFrame) / 1024.0, up.allocationsLastFrame,
+              up.frameCapacity / 1024u, GLUploadRing::kFrames);
+  ImGui::Text("Stalls: %u this frame  %u total  %.2f ms  grows %u",
+              up.stallsLastFrame, up.stalls, up.stallMs, up.grows);
+
+  ImGui::SeparatorText("Material Textures");
+  const TextureResidencyStats &tex = engine.materials().textures().stats();
+  ImGui::Text("%u textures  %u resident", tex.textures, tex.resident);
+  if (tex.unpooled > 0) {
+    ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.35f, 1.0f),
+                       "%u textures in no pool: not drawn", tex.unpooled);
+  }
+  if (tex.downscaled > 0) {
+    ImGui::TextColored(ImVec4(1, 0.75f, 0.25f, 1),
+                       "%u textures below full resolution: pools full",
+                       tex.downscaled);
+  }
+  ImGui::Text("Pools: %u / %u  layers %u  %.1f MB", tex.pools,
+              TextureTable::kMaxPools, tex.poolLayers,
+              double(tex.poolBytes) / (1024.0 * 1024.0));
+  ImGui::Text("Binding: %.3f ms in %u binds  slot uploads %u",
+              tex.bindMsLastFrame, tex.bindsLastFrame, tex.slotUploads);
+  ImGui::Text("Decode: %u threads  %u queued  %u decoding  %u waiting  "
+              "%u cancelled",
+              tex.decodeThreads, tex.queued, tex.decoding, tex.waiting,
+              tex.cancelled);
+  ImGui::Text("Uploads: %u this frame  %.1f MB  %.3f ms",
+              tex.uploadsLastFrame,
+              double(tex.uploadBytesLastFrame) / (1024.0 * 1024.0),
+              tex.uploadMsLastFrame);
+  ImGui::Text("Cooked cache: %u hits  %u cooked", tex.cacheHits, tex.cooked);
+  {
+    TextureTable &table = engine.materials().textures();
+    static const char *kCompression[] = {"Off (RGBA8)", "Fast (BC1/3/5)",
+                                         "High (BC7/BC5)"};
+    int compression = int(table.compression());
+    if (ImGui::Combo("Compression", &compression, kCompression,
+                     IM_ARRAYSIZE(kCompression)))
+      table.setCompression(TextureCompression(compression));
+    int threads = int(table.decodeThreads());
+    if (ImGui::SliderInt("Decode Threads", &threads, 1, 16))
+      table.setDecodeThreads(uint32_t(threads));
+    TextureUploadBudget budget = table.uploadBudget();
+    int budgetMB = int(budget.bytes >> 20);
+    float budgetMs = float(budget.ms);
+    bool budgetChanged =
+        ImGui::SliderInt("Upload Budget MB", &budgetMB, 1, 256);
+    budgetChanged |=
+        ImGui::SliderFloat("Upload Budget ms", &budgetMs, 0.1f, 16.0f, "%.1f");
+    if (budgetChanged) {
+      budget.bytes = uint64_t(budgetMB) << 20;
+      budget.ms = double(budgetMs);
+      table.setUploadBudget(budget);
+    }
+  }
+
+  ImGui::SeparatorText("Material Programs");
+  MaterialProgramCache &progs = engine.renderer().materialPrograms();
+  bool specialize = progs.enabled();
+  if (ImGui::Checkbox("Specialize Graph Materials", &specialize))
+    progs.setEnabled(specialize);
+  const MaterialProgramStats ps = progs.stats();
+  ImGui::Text("%u ready  %u pending  %u failed  evicted %u  (%s compile)",
+              ps.ready, ps.pending, ps.failed, ps.evicted,
+              ps.parallelCompile ? "parallel" : "sync");
+
+  if (m_sceneManager && m_sceneManager->hasActive()) {
+    const SceneSaveState &save = m_sceneManager->saveState();
+    ImGui::SeparatorText("Scene Save");
+    ImGui::Text("Last: %s  %.1f KB  chunks %u written / %u reused",
+                save.lastIncremental ? "delta" : "full",
+                double(save.lastBytesWritten) / 1024.0, save.lastChunksWritten,
+                save.lastChunksReused);
+    ImGui::Text("File %.1f KB  live %.1f KB  appends %u",
+                double(save.fileBytes) / 1024.0,
+                double(save.liveBytes) / 1024.0, save.appendCount);
+
+    bool background = m_sceneManager->backgroundSaves();
+    if (ImGui::Checkbox("Background Saves", &background))
+      m_sceneManager->setBackgroundSaves(background);
+    const SceneSaveStatus &status = m_sceneManager->lastSave();
+    if (m_sceneManager->saveInFlight()) {
+      ImGui::TextUnformatted("Saving...");
+    } else if (status.phase != SceneSaveStatus::Phase::Idle) {
+      // An inline save blocks for capture + write; a background one only for
+      // the capture (plus waiting on a save still in flight).
+      ImGui::Text("%s  main thread %.2f ms  (inline would be %.2f ms)",
+                  status.phase == SceneSaveStatus::Phase::Saved ? "Saved"
+                                                                : "FAILED",
+                  status.stallMs, status.captureMs + status.writeMs);
+      ImGui::Text("Capture %.2f ms  encode+write %.2f ms%s", status.captureMs,
+                  status.writeMs, status.background ? " (worker)" : "");
+    }
+  }
+
   ImGui::SeparatorText("Shadow Bias");
   auto &csmCfg = engine.shadowCSMConfig();
   ImGui::Checkbox("Cull Front Faces", &csmCfg.cullFrontFaces);
@@ -288,6 +442,18 @@ void EditorLayer::processWorldEvents(EngineContext &engine) {
     return;
   m_history.setWorld(m_world, &engine.materials());
   m_history.setAbsorbMaterialOnlyChanges(m_absorbMaterialHistoryAfterSceneLoad);
+  if (m_sceneManager) {
+    m_sceneManager->pollSaves();
+    m_sceneManager->trackWorldEvents();
+    if (m_history.applySerial() != m_seenHistoryApplySerial) {
+      m_seenHistoryApplySerial = m_history.applySerial();
+      m_sceneManager->markActiveSceneFullyDirty();
+    }
+    if (engine.defaultMaterialSerial() != m_seenDefaultMaterialSerial) {
+      m_seenDefaultMaterialSerial = engine.defaultMaterialSerial();
+      m_sceneManager->markActiveSceneMeshesDirty();
+    }
+  }
   if (m_ignoreDirtyFramesAfterSceneLoad > 0) {
     // Scene load/open can trigger non-authoring material churn. Keep history
     // baseline synced but do not record entries during this warm-up window.
@@ -23,6 +23,7 @@
 #include "ui/panels/InspectorSky.h"
 #include "ui/panels/LUTManagerPanel.h"
 #include "ui/panels/MaterialGraphPanel.h"
+#include "ui/panels/ProfilerPanel.h"
 #include "ui/panels/ProjectSettingsPanel.h"
 #include "ui/panels/ViewportPanel.h"
 #include "editor/EditorHistory.h"
@@ -141,6 +142,7 @@ private:
   AssetBrowserPanel m_assetBrowser{};
   AssetRegistry m_assets{};
   LUTManagerPanel m_lutManager{};
+  ProfilerPanel m_profilerPanel{};
   MaterialGraphPanel m_materialGraphPanel{};
   PostGraphEditorPanel m_postGraphPanel{};
   SequencerPanel m_sequencerPanel{};
@@ -163,6 +165,8 @@ private:
   uint64_t m_lastCleanHistoryRevision = 0;
   uint64_t m_lastObservedHistoryRevision = 0;
   uint64_t m_seenSceneChangeSerial = 0;
+  uint64_t m_seenHistoryApplySerial = 0;
+  uint64_t m_seenDefaultMaterialSerial = 0;
   uint32_t m_ignoreDirtyFramesAfterSceneLoad = 0;
   bool m_absorbMaterialHistoryAfterSceneLoad = false;
   uint64_t m_lastObservedMaterialSerial = 0;
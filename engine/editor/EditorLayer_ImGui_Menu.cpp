@@ -155,6 +155,7 @@ void EditorLayer::drawMainMenuBar(EngineContext &engine) {
     ImGui::MenuItem("Post-Processing Graph", nullptr, &m_persist.panels.postGraph);
     ImGui::MenuItem("Sequencer", nullptr, &m_persist.panels.sequencer);
     ImGui::MenuItem("History", nullptr, &m_persist.panels.history);
+    ImGui::MenuItem("Profiler", nullptr, &m_persist.panels.profiler);
     ImGui::EndMenu();
   }
 
@@ -121,8 +121,10 @@ void EditorLayer::drawEditorPanels(EngineContext &engine) {
   if (m_persist.panels.sky)
     drawSkyPanel(*m_world, engine);
 
+  // Skipped while a save is still writing; the next frame picks it up.
   if (m_autoSave && m_sceneLoaded && !m_scenePath.empty() && m_sceneManager &&
-      m_sceneManager->hasActive() && m_sceneManager->active().dirty) {
+      m_sceneManager->hasActive() && m_sceneManager->active().dirty &&
+      !m_sceneManager->saveInFlight()) {
     if (m_sceneManager->saveActive())
       markSceneClean(engine);
   }
@@ -133,6 +135,9 @@ void EditorLayer::drawEditorPanels(EngineContext &engine) {
   if (m_persist.panels.lutManager)
     m_lutManager.draw(engine);
 
+  if (m_persist.panels.profiler)
+    m_profilerPanel.draw(engine);
+
   const auto &gizmo = m_viewport.gizmoState();
 
   if (m_persist.panels.postGraph) {
@@ -114,6 +114,15 @@ void SceneBrowserPanel::draw(SceneManager &sm, ProjectManager &pm) {
     }
   }
 
+  if (sm.saveInFlight()) {
+    ImGui::Spacing();
+    ImGui::TextDisabled("Saving...");
+  } else if (sm.lastSave().phase == SceneSaveStatus::Phase::Failed) {
+    ImGui::Spacing();
+    ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.35f, 1.0f),
+                       "Failed to save %s", sm.lastSave().path.c_str());
+  }
+
   if (!m_lastError.empty()) {
     ImGui::Spacing();
     ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.35f, 1.0f), "%s",
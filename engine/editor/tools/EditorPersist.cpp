@@ -61,6 +61,7 @@ EditorPersist::save(const std::string &path, const EditorPersistState &s) {
     put(o, "panel.postGraph", s.panels.postGraph);
     put(o, "panel.sequencer", s.panels.sequencer);
     put(o, "panel.history", s.panels.history);
+    put(o, "panel.profiler", s.panels.profiler);
 
     // Asset browser UI state
     put(o, "assetBrowser.folder", s.assetBrowserFolder);
@@ -160,6 +161,8 @@ std::expected<void, std::string> EditorPersist::load(const std::string &path,
         toBool(get("panel.sequencer"), out.panels.sequencer);
     out.panels.history =
         toBool(get("panel.history"), out.panels.history);
+    out.panels.profiler =
+        toBool(get("panel.profiler"), out.panels.profiler);
 
     out.assetBrowserFolder = get("assetBrowser.folder");
     out.assetBrowserFilter = get("assetBrowser.filter");
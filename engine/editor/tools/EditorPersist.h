@@ -37,6 +37,7 @@ struct EditorPanels final {
   bool postGraph = false;
   bool sequencer = false;
   bool history = false;
+  bool profiler = false;
 };
 
 struct EditorPersistState final {
@@ -29,7 +29,9 @@ void HierarchyPanel::drawEntityNode(World &world, EntityID e,
   if (!world.isAlive(e))
     return;
   m_visibleOrder.push_back(e);
-  const auto &nm = world.name(e).name;
+  // A copy: the context menu below creates and duplicates entities, which
+  // can move the name pool's storage.
+  const std::string nm = world.name(e).name;
   const bool hasMesh = world.hasMesh(e);
   const uint32_t subCount = hasMesh ? world.submeshCount(e) : 0;
   const bool hasSubmeshes = subCount > 0;
@@ -113,19 +113,33 @@ static void clearMaterialFromWorld(World &world, MaterialHandle h) {
     if (!world.isAlive(e) || !world.hasMesh(e))
       continue;
     const uint32_t n = world.submeshCount(e);
+    bool touched = false;
     for (uint32_t si = 0; si < n; ++si) {
       auto &sm = world.submesh(e, si);
-      if (sm.material == h)
+      if (sm.material == h) {
         sm.material = InvalidMaterial;
+        touched = true;
+      }
     }
+    if (touched)
+      world.events().push({WorldEventType::MeshChanged, e});
   }
 }
 
+// `hidden` is saved with the transform, so changing it has to be seen by the
+// incremental save like any other transform edit.
+static void setHidden(World &world, EntityID e, bool hidden) {
+  auto &tr = world.transform(e);
+  if (tr.hidden == hidden)
+    return;
+  tr.hidden = hidden;
+  world.events().push({WorldEventType::TransformChanged, e});
+}
+
 static void setHiddenRecursive(World &world, EntityID e, bool hidden) {
   if (!world.isAlive(e))
     return;
-  auto &tr = world.transform(e);
-  tr.hidden = hidden;
+  setHidden(world, e, hidden);
   EntityID ch = world.hierarchy(e).firstChild;
   while (ch != InvalidEntity) {
     EntityID next = world.hierarchy(ch).nextSibling;
@@ -138,10 +152,10 @@ static void isolateEntity(World &world, EntityID e, EntityID keepVisible) {
   for (EntityID id : world.alive()) {
     if (!world.isAlive(id))
       continue;
-    world.transform(id).hidden = true;
+    setHidden(world, id, true);
   }
   if (keepVisible != InvalidEntity && world.isAlive(keepVisible))
-    world.transform(keepVisible).hidden = false;
+    setHidden(world, keepVisible, false);
   setHiddenRecursive(world, e, false);
 }
 
@@ -149,10 +163,10 @@ static void unisolateAll(World &world, EntityID keepVisible) {
   for (EntityID id : world.alive()) {
     if (!world.isAlive(id))
       continue;
-    world.transform(id).hidden = false;
+    setHidden(world, id, false);
   }
   if (keepVisible != InvalidEntity && world.isAlive(keepVisible))
-    world.transform(keepVisible).hidden = false;
+    setHidden(world, keepVisible, false);
 }
 
 static void resetTransform(World &world, EntityID e) {
@@ -107,10 +107,14 @@ bool InspectorMaterial::drawSlot(MaterialSystem &materials,
 
   uint32_t glTex = 0;
   uint32_t texIndex = TextureTable::Invalid;
+  ImVec2 uv1(1.0f, 1.0f);
   if (!path.empty()) {
-    texIndex = materials.textures().getOrCreate2D(path, wantSRGB);
-    if (texIndex != TextureTable::Invalid)
+    texIndex = materials.textures().getOrCreate2D(path, wantSRGB,
+                                                  TexturePriority::Thumbnail);
+    if (texIndex != TextureTable::Invalid) {
       glTex = materials.textures().glTexByIndex(texIndex);
+      materials.textures().previewUV(texIndex, uv1.x, uv1.y);
+    }
   }
 
   ImGui::PushID((int)slot);
@@ -121,7 +125,7 @@ bool InspectorMaterial::drawSlot(MaterialSystem &materials,
 
   const float thumb = 72.0f;
   if (glTex != 0) {
-    ImGui::Image(toImTex(glTex), ImVec2(thumb, thumb));
+    ImGui::Image(toImTex(glTex), ImVec2(thumb, thumb), ImVec2(0, 0), uv1);
   } else {
     ImGui::Button("##empty", ImVec2(thumb, thumb));
   }
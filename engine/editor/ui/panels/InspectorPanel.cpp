@@ -65,6 +65,7 @@ static bool drawTransform(World &world, EntityID e,
   bool hidden = tr.hidden;
   if (ImGui::Checkbox("Hidden", &hidden)) {
     tr.hidden = hidden;
+    world.events().push({WorldEventType::TransformChanged, e});
     visibilityChanged = true;
   }
   ImGui::BeginDisabled();
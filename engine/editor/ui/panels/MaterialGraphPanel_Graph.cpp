@@ -148,12 +148,16 @@ void MaterialGraphPanel::drawGraph(EngineContext &engine) {
       ImGui::PushID((int)n.id);
 
       uint32_t glTex = 0;
+      ImVec2 uv1(1.0f, 1.0f);
       if (n.u.x != kInvalidTexIndex) {
+        materials.textures().request(n.u.x, TexturePriority::Thumbnail);
         glTex = materials.textures().glTexByIndex(n.u.x);
+        materials.textures().previewUV(n.u.x, uv1.x, uv1.y);
       }
       const ImVec2 thumb(48.0f, 48.0f);
       if (glTex != 0) {
-        ImGui::Image((ImTextureID)(uintptr_t)glTex, thumb);
+        ImGui::Image((ImTextureID)(uintptr_t)glTex, thumb, ImVec2(0, 0),
+                     uv1);
       } else {
         ImGui::Button("##tex", thumb);
       }
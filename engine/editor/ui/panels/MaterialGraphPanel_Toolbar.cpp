@@ -72,6 +72,17 @@ void MaterialGraphPanel::drawToolbar(EngineContext &engine) {
     ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.35f, 1.0f), "Graph Error: %s",
                        err.c_str());
   }
+  const MatOptStats &opt = materials.graphOptStats(m_mat);
+  if (err.empty() && opt.opsBefore > 0) {
+    ImGui::SameLine();
+    ImGui::TextDisabled("Ops %u -> %u, Regs %u -> %u", opt.opsBefore,
+                        opt.opsAfter, opt.regsBefore, opt.regsAfter);
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip("Folded: %u\nMerged: %u (texture samples: %u)\n"
+                        "Dead: %u",
+                        opt.folded, opt.merged, opt.texMerged, opt.removed);
+    }
+  }
   ImGui::SameLine();
   ImGui::TextDisabled("CPU %.2f ms", m_lastDrawMs);
 }
@@ -0,0 +1,149 @@
+#include "ProfilerPanel.h"
+
+#include "app/EngineContext.h"
+#include "platform/FileDialogs.h"
+
+#include <algorithm>
+#include <imgui.h>
+
+namespace Nyx {
+
+// Events scanned per refresh; GPU results lag two frames, so a few frames'
+// worth is plenty.
+static constexpr uint32_t kScanEvents = 8192;
+
+static double eventMs(const ProfileEvent &e) {
+  return double(e.endNs - e.startNs) * 1e-6;
+}
+
+static void updateAverages(const std::vector<ProfileEvent> &events,
+                           std::unordered_map<const char *, double> &avg) {
+  for (const ProfileEvent &e : events) {
+    auto [it, inserted] = avg.try_emplace(e.name, eventMs(e));
+    if (!inserted)
+      it->second = it->second * 0.9 + eventMs(e) * 0.1;
+  }
+}
+
+static void
+drawEventTable(const char *id, const std::vector<ProfileEvent> &events,
+               const std::unordered_map<const char *, double> &avg,
+               bool showThread) {
+  const ImGuiTableFlags flags = ImGuiTableFlags_RowBg |
+                                ImGuiTableFlags_BordersInnerV |
+                                ImGuiTableFlags_SizingStretchProp;
+  if (!ImGui::BeginTable(id, showThread ? 4 : 3, flags))
+    return;
+  ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch);
+  if (showThread)
+    ImGui::TableSetupColumn("Thread", ImGuiTableColumnFlags_WidthFixed);
+  ImGui::TableSetupColumn("ms", ImGuiTableColumnFlags_WidthFixed);
+  ImGui::TableSetupColumn("avg", ImGuiTableColumnFlags_WidthFixed);
+  ImGui::TableHeadersRow();
+
+  for (const ProfileEvent &e : events) {
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::Text("%*s%s", int(e.depth) * 2, "", e.name);
+    if (showThread) {
+      ImGui::TableNextColumn();
+      ImGui::Text("%u", e.thread);
+    }
+    ImGui::TableNextColumn();
+    ImGui::Text("%.3f", eventMs(e));
+    ImGui::TableNextColumn();
+    const auto it = avg.find(e.name);
+    ImGui::Text("%.3f", it != avg.end() ? it->second : eventMs(e));
+  }
+  ImGui::EndTable();
+}
+
+void ProfilerPanel::refresh() {
+  const Profiler &p = Profiler::instance();
+  if (p.frame() < 2)
+    return;
+  p.snapshot(m_events, kScanEvents);
+
+  // CPU: the frame that just ended. GPU: the newest frame read back so far.
+  const uint64_t cpuFrame = p.frame() - 1;
+  uint64_t gpuFrame = 0;
+  for (const ProfileEvent &e : m_events) {
+    if (e.track == ProfileTrack::Gpu)
+      gpuFrame = std::max(gpuFrame, e.frame);
+  }
+
+  if (cpuFrame != m_cpuFrame) {
+    m_cpuFrame = cpuFrame;
+    m_cpu.clear();
+    for (const ProfileEvent &e : m_events) {
+      if (e.track == ProfileTrack::Cpu && e.frame == cpuFrame)
+        m_cpu.push_back(e);
+    }
+    std::sort(m_cpu.begin(), m_cpu.end(),
+              [](const ProfileEvent &a, const ProfileEvent &b) {
+                if (a.thread != b.thread)
+                  return a.thread < b.thread;
+                return a.startNs < b.startNs;
+              });
+    updateAverages(m_cpu, m_cpuAvg);
+  }
+
+  if (gpuFrame != m_gpuFrame) {
+    m_gpuFrame = gpuFrame;
+    m_gpu.clear();
+    for (const ProfileEvent &e : m_events) {
+      if (e.track == ProfileTrack::Gpu && e.frame == gpuFrame)
+        m_gpu.push_back(e);
+    }
+    std::sort(m_gpu.begin(), m_gpu.end(),
+              [](const ProfileEvent &a, const ProfileEvent &b) {
+                return a.startNs < b.startNs;
+              });
+    updateAverages(m_gpu, m_gpuAvg);
+  }
+}
+
+void ProfilerPanel::draw(EngineContext &engine) {
+  ImGui::Begin("Profiler");
+
+  Profiler &p = Profiler::instance();
+  bool enabled = p.enabled();
+  if (ImGui::Checkbox("Enabled", &enabled))
+    p.setEnabled(enabled);
+  ImGui::SameLine();
+  ImGui::Checkbox("Pause", &m_paused);
+  ImGui::SameLine();
+  if (ImGui::Button("Export Chrome Trace...")) {
+    if (auto path = FileDialogs::saveFile("Export Chrome Trace", "json",
+                                          "nyx_trace.json")) {
+      if (!path->empty())
+        p.exportChromeTrace(*path);
+    }
+  }
+
+  if (!m_paused)
+    refresh();
+
+  ImGui::Text("Frame: %.2f ms", p.lastFrameMs());
+  ImGui::Text("GPU query sets dropped: %u",
+              engine.renderer().gpuTimer().droppedFrames());
+
+  bool multiThread = false;
+  for (const ProfileEvent &e : m_cpu)
+    multiThread = multiThread || e.thread != m_cpu.front().thread;
+
+  ImGui::SeparatorText("CPU");
+  drawEventTable("##profiler_cpu", m_cpu, m_cpuAvg, multiThread);
+
+  double gpuTotal = 0.0;
+  for (const ProfileEvent &e : m_gpu)
+    gpuTotal += eventMs(e);
+  ImGui::SeparatorText("GPU");
+  ImGui::Text("Passes: %.3f ms (frame %llu)", gpuTotal,
+              (unsigned long long)m_gpuFrame);
+  drawEventTable("##profiler_gpu", m_gpu, m_gpuAvg, false);
+
+  ImGui::End();
+}
+
+} // namespace Nyx
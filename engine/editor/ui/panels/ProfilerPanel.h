@@ -0,0 +1,33 @@
+#pragma once
+
+#include "core/Profiler.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Nyx {
+
+class EngineContext;
+
+// Last complete frame of the Profiler ring: CPU scopes nested per thread and
+// GPU pass timings (which arrive a couple of frames late).
+class ProfilerPanel final {
+public:
+  void draw(EngineContext &engine);
+
+private:
+  void refresh();
+
+  bool m_paused = false;
+  std::vector<ProfileEvent> m_events;
+  std::vector<ProfileEvent> m_cpu;
+  std::vector<ProfileEvent> m_gpu;
+  uint64_t m_cpuFrame = 0;
+  uint64_t m_gpuFrame = 0;
+  // Smoothed ms per scope name, keyed by the name pointer.
+  std::unordered_map<const char *, double> m_cpuAvg;
+  std::unordered_map<const char *, double> m_gpuAvg;
+};
+
+} // namespace Nyx
@@ -217,7 +217,7 @@ void EnvironmentIBL::dispatchPrefilter() {
   const uint32_t baseSize = m_settings.prefilterSize;
   const uint32_t mipCount = mipCountForSize(baseSize);
 
-  const GLint locSamples = glGetUniformLocation(prog, "u_SampleCount");
+  const GLint locSamples = GLShaderUtil::uniformLocation(prog, "u_SampleCount");
   if (locSamples >= 0)
     glUniform1ui(locSamples, m_settings.sampleCount);
 
@@ -228,7 +228,7 @@ void EnvironmentIBL::dispatchPrefilter() {
             ? 0.0f
             : static_cast<float>(mip) / static_cast<float>(mipCount - 1);
 
-    const GLint locR = glGetUniformLocation(prog, "u_Roughness");
+    const GLint locR = GLShaderUtil::uniformLocation(prog, "u_Roughness");
     if (locR >= 0)
       glUniform1f(locR, roughness);
 
@@ -0,0 +1,189 @@
+#include "Compression.h"
+
+#include <cstring>
+
+namespace Nyx::Compression {
+
+static constexpr size_t kMinMatch = 4;
+static constexpr size_t kMaxOffset = 65535;
+static constexpr uint32_t kHashBits = 14;
+// Matches never start in the last 12 bytes nor extend into the last 5, so the
+// block always ends with a literal run (same rule as LZ4).
+static constexpr size_t kMatchStartLimit = 12;
+static constexpr size_t kLastLiterals = 5;
+
+static uint32_t read32(const uint8_t *p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static uint32_t hash32(uint32_t v) {
+  return (v * 2654435761u) >> (32u - kHashBits);
+}
+
+static void writeLength(std::vector<uint8_t> &out, size_t len) {
+  while (len >= 255u) {
+    out.push_back(255u);
+    len -= 255u;
+  }
+  out.push_back(static_cast<uint8_t>(len));
+}
+
+static void emitSequence(std::vector<uint8_t> &out, const uint8_t *literals,
+                         size_t litLen, size_t offset, size_t matchLen) {
+  const size_t mlCode = matchLen ? matchLen - kMinMatch : 0;
+  const uint8_t token =
+      static_cast<uint8_t>(((litLen >= 15u ? 15u : litLen) << 4) |
+                           (mlCode >= 15u ? 15u : mlCode));
+  out.push_back(token);
+  if (litLen >= 15u)
+    writeLength(out, litLen - 15u);
+  out.insert(out.end(), literals, literals + litLen);
+
+  if (matchLen == 0)
+    return; // final literal-only sequence
+  out.push_back(static_cast<uint8_t>(offset & 0xFFu));
+  out.push_back(static_cast<uint8_t>(offset >> 8));
+  if (mlCode >= 15u)
+    writeLength(out, mlCode - 15u);
+}
+
+void lzCompress(const uint8_t *src, size_t n, std::vector<uint8_t> &out) {
+  out.reserve(out.size() + n + n / 255u + 16u);
+
+  size_t anchor = 0;
+  if (n > kMatchStartLimit) {
+    std::vector<uint32_t> table(size_t(1) << kHashBits, 0xFFFFFFFFu);
+    const size_t startLimit = n - kMatchStartLimit;
+    const size_t matchLimit = n - kLastLiterals;
+
+    size_t ip = 0;
+    while (ip < startLimit) {
+      const uint32_t seq = read32(src + ip);
+      const uint32_t h = hash32(seq);
+      const uint32_t ref = table[h];
+      table[h] = static_cast<uint32_t>(ip);
+
+      if (ref == 0xFFFFFFFFu || ip - ref > kMaxOffset ||
+          read32(src + ref) != seq) {
+        ++ip;
+        continue;
+      }
+
+      size_t len = kMinMatch;
+      while (ip + len < matchLimit && src[ref + len] == src[ip + len])
+        ++len;
+
+      emitSequence(out, src + anchor, ip - anchor, ip - ref, len);
+      ip += len;
+      anchor = ip;
+
+      // Keep the table warm across the match for the next search.
+      if (ip < startLimit)
+        table[hash32(read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2);
+    }
+  }
+
+  emitSequence(out, src + anchor, n - anchor, 0, 0);
+}
+
+static bool readLength(const uint8_t *&ip, const uint8_t *iend, size_t &len) {
+  uint8_t b = 0;
+  do {
+    if (ip >= iend)
+      return false;
+    b = *ip++;
+    len += b;
+  } while (b == 255u);
+  return true;
+}
+
+bool lzDecompress(const uint8_t *src, size_t srcSize, uint8_t *dst,
+                  size_t dstSize) {
+  const uint8_t *ip = src;
+  const uint8_t *const iend = src + srcSize;
+  uint8_t *op = dst;
+  uint8_t *const oend = dst + dstSize;
+
+  while (ip < iend) {
+    const uint8_t token = *ip++;
+
+    size_t litLen = token >> 4;
+    if (litLen == 15u && !readLength(ip, iend, litLen))
+      return false;
+    if (litLen > size_t(iend - ip) || litLen > size_t(oend - op))
+      return false;
+    if (litLen)
+      std::memcpy(op, ip, litLen);
+    ip += litLen;
+    op += litLen;
+
+    if (ip == iend)
+      break; // last sequence carries literals only
+
+    if (iend - ip < 2)
+      return false;
+    const size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+    ip += 2;
+    if (offset == 0 || offset > size_t(op - dst))
+      return false;
+
+    size_t matchLen = token & 15u;
+    if (matchLen == 15u && !readLength(ip, iend, matchLen))
+      return false;
+    matchLen += kMinMatch;
+    if (matchLen > size_t(oend - op))
+      return false;
+
+    const uint8_t *match = op - offset;
+    if (offset >= matchLen) {
+      std::memcpy(op, match, matchLen);
+      op += matchLen;
+    } else {
+      for (size_t i = 0; i < matchLen; ++i)
+        *op++ = match[i]; // overlapping copy repeats the pattern
+    }
+  }
+
+  return op == oend;
+}
+
+// ------------------------------
+// Shuffle + delta filter
+// ------------------------------
+
+void shuffleDeltaEncode(const uint8_t *src, size_t size, uint32_t strideWords,
+                        std::vector<uint8_t> &out) {
+  const size_t words = size / 4u;
+  const size_t base = out.size();
+  out.resize(base + size);
+  uint8_t *dst = out.data() + base;
+
+  for (size_t i = 0; i < words; ++i) {
+    uint32_t w = read32(src + i * 4u);
+    if (strideWords && i >= strideWords)
+      w ^= read32(src + (i - strideWords) * 4u);
+    for (size_t b = 0; b < 4u; ++b)
+      dst[b * words + i] = static_cast<uint8_t>(w >> (8u * b));
+  }
+  if (size > words * 4u)
+    std::memcpy(dst + words * 4u, src + words * 4u, size - words * 4u);
+}
+
+void shuffleDeltaDecode(const uint8_t *src, size_t size, uint32_t strideWords,
+                        uint8_t *dst) {
+  const size_t words = size / 4u;
+  for (size_t i = 0; i < words; ++i) {
+    uint32_t w = 0;
+    for (size_t b = 0; b < 4u; ++b)
+      w |= uint32_t(src[b * words + i]) << (8u * b);
+    if (strideWords && i >= strideWords)
+      w ^= read32(dst + (i - strideWords) * 4u);
+    std::memcpy(dst + i * 4u, &w, sizeof(w));
+  }
+  if (size > words * 4u)
+    std::memcpy(dst + words * 4u, src + words * 4u, size - words * 4u);
+}
+
+} // namespace Nyx::Compression
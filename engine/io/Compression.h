@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nyx::Compression {
+
+// Byte-oriented LZ77 in the LZ4 block style: 64 KiB window, 4-byte minimum
+// match, greedy hash-table matcher. Fast to decode and dependency free; meant
+// for chunk payloads, not archival ratios.
+
+// Appends the compressed form of src to out.
+void lzCompress(const uint8_t *src, size_t srcSize, std::vector<uint8_t> &out);
+
+// Decodes exactly dstSize bytes. Returns false on malformed input (never
+// reads or writes outside the given buffers).
+bool lzDecompress(const uint8_t *src, size_t srcSize, uint8_t *dst,
+                  size_t dstSize);
+
+// Lossless pre-filter for arrays of fixed-stride float records. Each 32-bit
+// word is XORed with the same word one record earlier and the words are then
+// split into byte planes, which turns slowly varying floats into long runs the
+// LZ stage can match. strideWords is the record size in 32-bit words.
+void shuffleDeltaEncode(const uint8_t *src, size_t size, uint32_t strideWords,
+                        std::vector<uint8_t> &out);
+void shuffleDeltaDecode(const uint8_t *src, size_t size, uint32_t strideWords,
+                        uint8_t *dst);
+
+} // namespace Nyx::Compression
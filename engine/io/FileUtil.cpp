@@ -155,4 +155,19 @@ bool writeFileBytesAtomic(const std::string &path, const void *data, size_t size
 #endif
 }
 
+bool syncFile(const std::string &path) {
+#if defined(_WIN32)
+  (void)path;
+  return true;
+#else
+  FILE *f = std::fopen(path.c_str(), "rb");
+  if (!f)
+    return false;
+  const int fd = fileno(f);
+  const bool ok = fd >= 0 && ::fsync(fd) == 0;
+  std::fclose(f);
+  return ok;
+#endif
+}
+
 } // namespace Nyx::FileUtil
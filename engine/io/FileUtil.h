@@ -11,6 +11,9 @@ bool readFileBytes(const std::string &path, std::vector<uint8_t> &out);
 bool writeFileBytesAtomic(const std::string &path, const void *data, size_t size,
                           std::string *outError = nullptr);
 
+// Flushes what has been written to `path` through to the disk (fsync).
+bool syncFile(const std::string &path);
+
 std::string directoryOf(const std::string &path);
 std::string filenameOf(const std::string &path);
 std::string joinPath(const std::string &a, const std::string &b);
@@ -0,0 +1,101 @@
+#include "MappedFile.h"
+
+#include "FileUtil.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Nyx {
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::open(const std::string &path) {
+  close();
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file != INVALID_HANDLE_VALUE) {
+    LARGE_INTEGER sz{};
+    if (GetFileSizeEx(file, &sz) && sz.QuadPart > 0) {
+      HANDLE map =
+          CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (map) {
+        void *view = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+        if (view) {
+          m_fileHandle = file;
+          m_mapHandle = map;
+          m_data = static_cast<const uint8_t *>(view);
+          m_size = static_cast<uint64_t>(sz.QuadPart);
+          m_mapped = true;
+          m_open = true;
+          return true;
+        }
+        CloseHandle(map);
+      }
+    }
+    CloseHandle(file);
+  }
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+      void *view = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                          MAP_PRIVATE, fd, 0);
+      if (view != MAP_FAILED) {
+        // Chunks are parsed front to back; let the kernel read ahead.
+        (void)::madvise(view, static_cast<size_t>(st.st_size),
+                        MADV_SEQUENTIAL);
+        ::close(fd);
+        m_data = static_cast<const uint8_t *>(view);
+        m_size = static_cast<uint64_t>(st.st_size);
+        m_mapped = true;
+        m_open = true;
+        return true;
+      }
+    }
+    ::close(fd);
+  }
+#endif
+
+  // Empty files and filesystems without mmap support end up here.
+  if (!FileUtil::readFileBytes(path, m_buffer))
+    return false;
+  m_data = m_buffer.data();
+  m_size = m_buffer.size();
+  m_open = true;
+  return true;
+}
+
+void MappedFile::close() {
+  if (m_mapped) {
+#if defined(_WIN32)
+    UnmapViewOfFile(m_data);
+    CloseHandle(static_cast<HANDLE>(m_mapHandle));
+    CloseHandle(static_cast<HANDLE>(m_fileHandle));
+    m_mapHandle = nullptr;
+    m_fileHandle = nullptr;
+#else
+    ::munmap(const_cast<uint8_t *>(m_data), static_cast<size_t>(m_size));
+#endif
+  }
+  m_buffer.clear();
+  m_buffer.shrink_to_fit();
+  m_data = nullptr;
+  m_size = 0;
+  m_open = false;
+  m_mapped = false;
+}
+
+} // namespace Nyx
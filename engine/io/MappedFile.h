@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nyx {
+
+// Read-only view of a whole file. Memory-maps it where the platform allows
+// and falls back to reading it into an owned buffer otherwise, so callers
+// always get one contiguous span that stays valid until close().
+class MappedFile final {
+public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool open(const std::string &path);
+  void close();
+
+  bool isOpen() const { return m_open; }
+  bool isMapped() const { return m_mapped; }
+
+  const uint8_t *data() const { return m_data; }
+  uint64_t size() const { return m_size; }
+
+private:
+  const uint8_t *m_data = nullptr;
+  uint64_t m_size = 0;
+  bool m_open = false;
+  bool m_mapped = false;
+
+  std::vector<uint8_t> m_buffer; // fallback storage when not mapped
+
+#if defined(_WIN32)
+  void *m_fileHandle = nullptr;
+  void *m_mapHandle = nullptr;
+#endif
+};
+
+} // namespace Nyx
@@ -15,7 +15,7 @@ static void glfwErrorCallback(int code, const char *msg) {
 }
 
 GLFWWindow::GLFWWindow(const WindowDesc &desc) {
-  initGLFW();
+  initGLFW(desc);
   createWindow(desc);
   initGL();
 
@@ -35,8 +35,15 @@ GLFWWindow::~GLFWWindow() {
   glfwTerminate();
 }
 
-void GLFWWindow::initGLFW() {
+void GLFWWindow::initGLFW(const WindowDesc &desc) {
   glfwSetErrorCallback(glfwErrorCallback);
+#if defined(GLFW_PLATFORM_NULL)
+  if (desc.nullPlatform)
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#else
+  if (desc.nullPlatform)
+    Log::Warn("GLFW built without a null platform; using the default one");
+#endif
   NYX_ASSERT(glfwInit() == GLFW_TRUE, "glfwInit failed");
 
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
@@ -49,6 +56,13 @@ void GLFWWindow::initGLFW() {
 
   glfwWindowHint(GLFW_SRGB_CAPABLE, GLFW_TRUE);
   glfwWindowHint(GLFW_DOUBLEBUFFER, GLFW_TRUE);
+
+  if (!desc.visible)
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#if defined(GLFW_PLATFORM_NULL)
+  if (desc.nullPlatform)
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+#endif
 }
 
 void GLFWWindow::createWindow(const WindowDesc &desc) {
@@ -15,6 +15,11 @@ struct WindowDesc {
   int32_t height = 900;
   std::string title = "Nyx Engine";
   bool vsync = true;
+  // Offscreen use (nyx_bench): the window is never shown. `nullPlatform`
+  // skips the display server entirely and creates the context via EGL
+  // (surfaceless on Mesa); needs GLFW 3.4, ignored on older builds.
+  bool visible = true;
+  bool nullPlatform = false;
 };
 
 class GLFWWindow final {
@@ -49,7 +54,7 @@ public:
   double getTimeSeconds() const;
 
 private:
-  void initGLFW();
+  void initGLFW(const WindowDesc &desc);
   void createWindow(const WindowDesc &desc);
   void initGL();
 
@@ -24,29 +24,35 @@ Renderer::Renderer() : m_rgRes(m_res) {
     std::filesystem::create_directories(path.parent_path());
     m_graph.enableDebug(path.string(), /*dumpLifetimes=*/true);
   }
+  m_graph.setGpuTimer(&m_gpuTimer);
+
+  // Indexed by ProcMeshType.
+  m_primitives.upload({makePrimitivePN(ProcMeshType::Cube, 32),
+                       makePrimitivePN(ProcMeshType::Plane, 32),
+                       makePrimitivePN(ProcMeshType::Circle, 32),
+                       makePrimitivePN(ProcMeshType::Sphere, 32),
+                       makePrimitivePN(ProcMeshType::Monkey, 32)});
 
   m_passEnvEquirect.configure(m_shaders);
   m_passEnvIrradiance.configure(m_shaders);
   m_passEnvPrefilter.configure(m_shaders);
   m_passEnvBRDF.configure(m_shaders);
 
-  m_passDepthPre.configure(m_shaders, m_res,
-                           [this](ProcMeshType t) { drawPrimitive(t); });
-  m_passShadowCSM.configure(m_shaders, m_res,
-                            [this](ProcMeshType t) { drawPrimitive(t); });
-  m_passShadowSpot.configure(m_shaders, m_res,
-                             [this](ProcMeshType t) { drawPrimitive(t); });
-  m_passShadowDir.configure(m_shaders, m_res,
-                            [this](ProcMeshType t) { drawPrimitive(t); });
-  m_passShadowPoint.configure(m_shaders, m_res,
-                              [this](ProcMeshType t) { drawPrimitive(t); });
+  m_passDepthPre.configure(m_shaders, m_res, m_primitives);
+  m_passShadowCSM.configure(m_shaders, m_res, m_primitives);
+  m_passShadowSpot.configure(m_shaders, m_res, m_primitives);
+  m_passShadowDir.configure(m_shaders, m_res, m_primitives);
+  m_passShadowPoint.configure(m_shaders, m_res, m_primitives);
   m_passHiZ.configure(m_shaders);
+  m_passOcclusionCull.configure(m_shaders);
   m_passLightCluster.configure(m_shaders);
   m_passLightGridDebug.configure(m_shaders);
-  m_passForwardOpaque.configure(m_shaders, m_res,
-                                [this](ProcMeshType t) { drawPrimitive(t); });
-  m_passForwardTransparent.configure(
-      m_shaders, m_res, [this](ProcMeshType t) { drawPrimitive(t); });
+  m_materialPrograms.configure(m_shaders, "forward_mrt.vert",
+                               "forward_mrt.frag");
+  m_passForwardOpaque.configure(m_shaders, m_res, m_primitives,
+                                &m_materialPrograms);
+  m_passForwardTransparent.configure(m_shaders, m_res, m_primitives,
+                                     &m_materialPrograms);
   m_passPickID.configure(m_shaders, m_res);
   m_passTransparentOIT.configure(m_shaders, m_res);
   m_passTransparentOITComposite.configure(m_shaders);
@@ -87,25 +93,30 @@ static uint32_t primIndex(ProcMeshType t) {
   }
 }
 
+const GLMeshRange &Renderer::primitiveRange(ProcMeshType t) const {
+  return m_primitives.range(primIndex(t));
+}
+
 void Renderer::drawPrimitive(ProcMeshType t) {
-  const uint32_t i = primIndex(t);
-  if (!m_primReady[i]) {
-    MeshCPU cpu = makePrimitivePN(t, 32);
-    m_primMeshes[i].upload(cpu);
-    m_primReady[i] = true;
-  }
-  m_primMeshes[i].draw();
+  m_primitives.draw(primIndex(t));
 }
 
 void Renderer::drawPrimitiveBaseInstance(ProcMeshType t,
                                          uint32_t baseInstance) {
-  const uint32_t i = primIndex(t);
-  if (!m_primReady[i]) {
-    MeshCPU cpu = makePrimitivePN(t, 32);
-    m_primMeshes[i].upload(cpu);
-    m_primReady[i] = true;
-  }
-  m_primMeshes[i].drawBaseInstance(baseInstance);
+  m_primitives.drawBaseInstance(primIndex(t), baseInstance);
+}
+
+RenderSubmitStats Renderer::submitStats() const {
+  RenderSubmitStats s{};
+  s.depthPre = m_passDepthPre.submitStats();
+  s.forwardOpaque = m_passForwardOpaque.submitStats();
+  if (!m_transparentOIT)
+    s.forwardTransparent = m_passForwardTransparent.submitStats();
+  s.shadows.add(m_passShadowCSM.submitStats());
+  s.shadows.add(m_passShadowSpot.submitStats());
+  s.shadows.add(m_passShadowDir.submitStats());
+  s.shadows.add(m_passShadowPoint.submitStats());
+  return s;
 }
 
 uint32_t Renderer::renderFrame(const RenderPassContext &ctx, bool editorVisible,
@@ -116,6 +127,8 @@ uint32_t Renderer::renderFrame(const RenderPassContext &ctx, bool editorVisible,
   setSelectedPickIDs(selectedPickIDs, engine.selectedActivePick());
 
   // Begin RG frame
+  m_gpuTimer.beginFrame();
+  m_materialPrograms.update();
   m_graph.reset();
   m_rgRes.beginFrame(ctx.frameIndex, ctx.fbWidth, ctx.fbHeight);
 
@@ -124,8 +137,9 @@ uint32_t Renderer::renderFrame(const RenderPassContext &ctx, bool editorVisible,
       .usage = RGTexUsage::DepthAttach | RGTexUsage::Sampled,
       .extent = {RenderExtentKind::Framebuffer, 0, 0},
   };
+  // r = min depth (light clustering), g = max depth (occlusion culling).
   const RenderTextureDesc hizDesc{
-      .format = RGFormat::R32F,
+      .format = RGFormat::RG32F,
       .usage = RGTexUsage::Sampled | RGTexUsage::Image,
       .extent = {RenderExtentKind::Framebuffer, 0, 0},
       .mipCount = 1,
@@ -291,6 +305,14 @@ uint32_t Renderer::renderFrame(const RenderPassContext &ctx, bool editorVisible,
                         RGBufferDesc{.byteSize = 1u,
                                      .usage = RGBufferUsage::SSBO,
                                      .dynamic = true});
+  m_graph.declareBuffer("Scene.DrawBounds",
+                        RGBufferDesc{.byteSize = 1u,
+                                     .usage = RGBufferUsage::SSBO,
+                                     .dynamic = true});
+  m_graph.declareBuffer("Scene.DrawIndirect",
+                        RGBufferDesc{.byteSize = 1u,
+                                     .usage = RGBufferUsage::SSBO,
+                                     .dynamic = true});
   m_graph.declareBuffer("Post.Filters",
                         RGBufferDesc{.byteSize = 1u,
                                      .usage = RGBufferUsage::SSBO,
@@ -314,6 +336,22 @@ uint32_t Renderer::renderFrame(const RenderPassContext &ctx, bool editorVisible,
       bb.bindExternalBuffer(perDrawRef, external);
     }
 
+    const RGBufferRef boundsRef = bb.getBuffer("Scene.DrawBounds");
+    if (boundsRef != InvalidRGBuffer) {
+      GLBuffer external{};
+      external.buf = engine.drawCull().boundsSSBO();
+      external.byteSize = 0;
+      bb.bindExternalBuffer(boundsRef, external);
+    }
+
+    const RGBufferRef indirectRef = bb.getBuffer("Scene.DrawIndirect");
+    if (indirectRef != InvalidRGBuffer) {
+      GLBuffer external{};
+      external.buf = engine.drawCull().indirectBuffer();
+      external.byteSize = 0;
+      bb.bindExternalBuffer(indirectRef, external);
+    }
+
     const RGBufferRef filtersRef = bb.getBuffer("Post.Filters");
     if (filtersRef != InvalidRGBuffer) {
       GLBuffer external{};
@@ -349,6 +387,7 @@ uint32_t Renderer::renderFrame(const RenderPassContext &ctx, bool editorVisible,
 
   m_passDepthPre.setup(m_graph, ctx, registry, engine, editorVisible);
   m_passHiZ.setup(m_graph, ctx, registry, engine, editorVisible);
+  m_passOcclusionCull.setup(m_graph, ctx, registry, engine, editorVisible);
   m_passLightCluster.setLightCount(engine.lights().lightCount());
   m_passLightCluster.setup(m_graph, ctx, registry, engine, editorVisible);
   m_passLightGridDebug.setup(m_graph, ctx, registry, engine, editorVisible);
@@ -361,6 +400,7 @@ uint32_t Renderer::renderFrame(const RenderPassContext &ctx, bool editorVisible,
 
   m_passSky.setup(m_graph, ctx, registry, engine, editorVisible);
 
+  m_transparentOIT = useOIT;
   if (useOIT) {
     m_passTransparentOIT.setup(m_graph, ctx, registry, engine, editorVisible);
     m_passTransparentOITComposite.setup(m_graph, ctx, registry, engine,
@@ -383,6 +423,7 @@ uint32_t Renderer::renderFrame(const RenderPassContext &ctx, bool editorVisible,
   m_passPresent.setup(m_graph, ctx, registry, engine, editorVisible);
 
   m_graph.execute(ctx, m_rgRes);
+  m_rgRes.gc();
 
   auto &bb = m_graph.blackboard();
   m_out.hdr = bb.textureHandle(bb.getTexture("HDR.Debug"));
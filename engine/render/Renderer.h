@@ -1,9 +1,12 @@
 #pragma once
 
 #include "render/gl/GLFullscreenTriangle.h"
+#include "render/gl/GLGpuTimer.h"
 #include "render/gl/GLMesh.h"
 #include "render/gl/GLResources.h"
 #include "render/gl/GLShaderUtil.h"
+#include "render/draw/MultiDrawBatch.h"
+#include "render/material/MaterialProgramCache.h"
 #include "render/passes/PassDepthPre.h"
 #include "render/passes/PassEnvBRDFLUT.h"
 #include "render/passes/PassEnvEquirectToCube.h"
@@ -18,6 +21,7 @@
 #include "render/passes/PassShadowPoint.h"
 #include "render/passes/PassLightCluster.h"
 #include "render/passes/PassLightGridDebug.h"
+#include "render/passes/PassOcclusionCull.h"
 #include "render/passes/PassMaterialPreview.h"
 #include "render/passes/PassPostFilters.h"
 #include "render/passes/PassPresent.h"
@@ -48,6 +52,14 @@ struct FrameOutputs {
   RGHandle preview = InvalidRG;
 };
 
+// Draw submission of the passes that go through multi-draw-indirect.
+struct RenderSubmitStats {
+  DrawSubmitStats depthPre{};
+  DrawSubmitStats forwardOpaque{};
+  DrawSubmitStats forwardTransparent{};
+  DrawSubmitStats shadows{};
+};
+
 class Renderer final {
 public:
   Renderer();
@@ -64,12 +76,21 @@ public:
                           uint32_t activePick);
   void drawPrimitive(ProcMeshType type);
   void drawPrimitiveBaseInstance(ProcMeshType type, uint32_t baseInstance);
+  // All primitives share one VAO; range() locates a mesh in it.
+  const GLMeshPool &primitives() const { return m_primitives; }
+  const GLMeshRange &primitiveRange(ProcMeshType type) const;
   void setOutlineThicknessPx(float px) { m_outlineThicknessPx = px; }
   float outlineThicknessPx() const { return m_outlineThicknessPx; }
 
   GLShaderUtil &shaders() { return m_shaders; }
   const GLShaderUtil &shaders() const { return m_shaders; }
 
+  // Per-graph specialized forward programs (VM fallback while compiling).
+  MaterialProgramCache &materialPrograms() { return m_materialPrograms; }
+  const MaterialProgramCache &materialPrograms() const {
+    return m_materialPrograms;
+  }
+
   GLResources &resources() { return m_res; }
   const GLResources &resources() const { return m_res; }
 
@@ -81,20 +102,40 @@ public:
   const PassShadowSpot& shadowSpotPass() const { return m_passShadowSpot; }
   const PassShadowDir& shadowDirPass() const { return m_passShadowDir; }
   const PassShadowPoint& shadowPointPass() const { return m_passShadowPoint; }
+  uint32_t occlusionCulledCount() const {
+    return m_passOcclusionCull.occludedCount();
+  }
   uint32_t previewTexture() const;
 
+  const RenderGraphStats &graphStats() const { return m_graph.stats(); }
+  void setGraphCacheEnabled(bool on) { m_graph.setCacheEnabled(on); }
+  bool graphCacheEnabled() const { return m_graph.cacheEnabled(); }
+  const GLGpuTimer &gpuTimer() const { return m_gpuTimer; }
+  const RGTransientStats &transientStats() const { return m_rgRes.stats(); }
+  // Pooled (currently unused) graph textures are freed above this.
+  void setTransientBudgetBytes(uint64_t bytes) {
+    m_rgRes.setBudgetBytes(bytes);
+  }
+  uint64_t transientBudgetBytes() const { return m_rgRes.budgetBytes(); }
+
+  // Off: the batched passes issue one indirect draw per command instead of
+  // one glMultiDrawElementsIndirect per batch, for comparison.
+  void setMultiDrawIndirect(bool on) { m_multiDraw = on; }
+  bool multiDrawIndirect() const { return m_multiDraw; }
+  RenderSubmitStats submitStats() const;
+
 private:
   // void ensureTargets(uint32_t w, uint32_t h);
   // void ensureScene();
 
-  // void ensurePrimitiveMeshes();
-
 private:
   RenderGraph m_graph;
+  GLGpuTimer m_gpuTimer;
   RGResources m_rgRes;
   FrameOutputs m_out;
   GLResources m_res;
   GLShaderUtil m_shaders{};
+  MaterialProgramCache m_materialPrograms;
 
   GLFullscreenTriangle m_fsTri;
 
@@ -105,6 +146,7 @@ private:
 
   PassDepthPre m_passDepthPre;
   PassHiZBuild m_passHiZ;
+  PassOcclusionCull m_passOcclusionCull;
   PassLightCluster m_passLightCluster;
   PassLightGridDebug m_passLightGridDebug;
   PassShadowCSM m_passShadowCSM;
@@ -125,8 +167,9 @@ private:
   PassPickID m_passPickID;
   PassPresent m_passPresent;
 
-  GLMesh m_primMeshes[5]{};
-  bool m_primReady[5]{false, false, false, false, false};
+  GLMeshPool m_primitives;
+  bool m_multiDraw = true;
+  bool m_transparentOIT = false;
   float m_outlineThicknessPx = 1.5f;
 };
 
@@ -0,0 +1,22 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+namespace Nyx {
+
+// Per-view constants, uploaded once per frame and bound for every pass.
+// std140; mirrors include/ViewCommon.glsl.
+inline constexpr uint32_t kViewUBOBinding = 1;
+
+struct ViewConstants final {
+  glm::mat4 view{1.0f};
+  glm::mat4 proj{1.0f};
+  glm::mat4 viewProj{1.0f};
+  glm::mat4 invViewProj{1.0f};
+  glm::vec4 camPos{0, 0, 0, 1};               // xyz = camera world pos
+  glm::vec4 nearFarTime{0.1f, 1000.0f, 0, 0}; // near, far, time, dt (s)
+  glm::uvec4 frame{0, 1, 1, 0}; // frame index, fb width, fb height
+};
+
+} // namespace Nyx
@@ -0,0 +1,45 @@
+#include "render/draw/DrawCullBuffers.h"
+
+#include "core/Assert.h"
+
+#include <glad/glad.h>
+
+namespace Nyx {
+
+void DrawCullBuffers::shutdown() {
+  m_bounds = {};
+  m_cmds = {};
+  m_count = 0;
+}
+
+// Fresh slices every frame: the GPU may still be culling and drawing from
+// the last frames' commands.
+void DrawCullBuffers::upload(GLUploadRing &ring,
+                             const std::vector<DrawBounds> &bounds,
+                             const std::vector<DrawIndirectCmd> &cmds) {
+  NYX_ASSERT(bounds.empty() || bounds.size() == cmds.size(),
+             "DrawCullBuffers: bounds/cmd count mismatch");
+  m_count = static_cast<uint32_t>(cmds.size());
+  m_bounds = {};
+  m_cmds = {};
+  if (m_count == 0)
+    return;
+
+  if (!bounds.empty())
+    m_bounds = ring.upload(bounds.data(), bounds.size() * sizeof(DrawBounds));
+  m_cmds = ring.upload(cmds.data(), cmds.size() * sizeof(DrawIndirectCmd));
+}
+
+void DrawCullBuffers::bindBounds(uint32_t binding) const {
+  GLUploadRing::bindRange(GL_SHADER_STORAGE_BUFFER, binding, m_bounds);
+}
+
+void DrawCullBuffers::bindCommands(uint32_t binding) const {
+  GLUploadRing::bindRange(GL_SHADER_STORAGE_BUFFER, binding, m_cmds);
+}
+
+void DrawCullBuffers::bindIndirect() const {
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_cmds.buffer);
+}
+
+} // namespace Nyx
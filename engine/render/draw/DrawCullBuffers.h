@@ -0,0 +1,40 @@
+#pragma once
+
+#include "render/draw/DrawData.h"
+#include "render/gl/GLUploadRing.h"
+#include <cstdint>
+#include <vector>
+
+namespace Nyx {
+
+// One indirect command per DrawData entry, plus the bounds the GPU occlusion
+// test reads, in this frame's slices of the upload ring. The cull pass only
+// rewrites instanceCount, so the CPU fills everything else. Bounds are only
+// uploaded when the test runs.
+class DrawCullBuffers final {
+public:
+  void shutdown();
+
+  // `bounds` is empty or parallel to `cmds`.
+  void upload(GLUploadRing &ring, const std::vector<DrawBounds> &bounds,
+              const std::vector<DrawIndirectCmd> &cmds);
+
+  // SSBO views for the cull pass; element 0 is the first draw.
+  void bindBounds(uint32_t binding) const;
+  void bindCommands(uint32_t binding) const;
+  // Binds the commands as GL_DRAW_INDIRECT_BUFFER; they start
+  // indirectOffset() bytes in.
+  void bindIndirect() const;
+  uintptr_t indirectOffset() const { return m_cmds.offset; }
+
+  uint32_t boundsSSBO() const { return m_bounds.buffer; }
+  uint32_t indirectBuffer() const { return m_cmds.buffer; }
+  uint32_t count() const { return m_count; }
+
+private:
+  GLUploadSlice m_bounds{};
+  GLUploadSlice m_cmds{};
+  uint32_t m_count = 0;
+};
+
+} // namespace Nyx
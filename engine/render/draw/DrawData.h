@@ -14,4 +14,20 @@ struct DrawData final {
   uint32_t _pad0 = 0;
 };
 
+// World-space AABB of a draw (same index as DrawData), read by the GPU
+// occlusion test.
+struct DrawBounds final {
+  glm::vec4 center{0.0f};  // xyz
+  glm::vec4 extents{0.0f}; // xyz half size
+};
+
+// Layout of GL's DrawElementsIndirectCommand.
+struct DrawIndirectCmd final {
+  uint32_t count = 0;
+  uint32_t instanceCount = 0;
+  uint32_t firstIndex = 0;
+  int32_t baseVertex = 0;
+  uint32_t baseInstance = 0;
+};
+
 } // namespace Nyx
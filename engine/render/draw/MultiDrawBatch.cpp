@@ -0,0 +1,69 @@
+#include "render/draw/MultiDrawBatch.h"
+
+#include <glad/glad.h>
+
+namespace Nyx {
+
+void drawIndirectRange(uintptr_t base, uint32_t first, uint32_t count,
+                       bool multiDraw, DrawSubmitStats &stats) {
+  if (count == 0)
+    return;
+  const uintptr_t offset = base + uintptr_t(first) * sizeof(DrawIndirectCmd);
+  if (multiDraw) {
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                reinterpret_cast<const void *>(offset),
+                                static_cast<GLsizei>(count), 0);
+    stats.drawCalls++;
+  } else {
+    for (uint32_t i = 0; i < count; ++i) {
+      glDrawElementsIndirect(
+          GL_TRIANGLES, GL_UNSIGNED_INT,
+          reinterpret_cast<const void *>(offset + i * sizeof(DrawIndirectCmd)));
+    }
+    stats.drawCalls += count;
+  }
+  stats.commands += count;
+}
+
+void MultiDrawBatch::shutdown() {
+  m_cmds = {};
+  m_models = {};
+}
+
+void MultiDrawBatch::reset() {
+  m_cmds.clear();
+  m_models.clear();
+}
+
+void MultiDrawBatch::add(const GLMeshRange &mesh, const glm::mat4 &model) {
+  DrawIndirectCmd cmd{};
+  cmd.count = mesh.indexCount;
+  cmd.instanceCount = 1;
+  cmd.firstIndex = mesh.firstIndex;
+  cmd.baseVertex = mesh.baseVertex;
+  cmd.baseInstance = static_cast<uint32_t>(m_cmds.size());
+  m_cmds.push_back(cmd);
+  m_models.push_back(model);
+}
+
+// Fresh slices every submit: earlier views this frame, and earlier frames,
+// may still be drawing from theirs.
+void MultiDrawBatch::submit(GLUploadRing &ring, bool multiDraw,
+                            DrawSubmitStats &stats) {
+  const uint32_t count = static_cast<uint32_t>(m_cmds.size());
+  if (count == 0)
+    return;
+
+  const GLUploadSlice cmds =
+      ring.upload(m_cmds.data(), count * sizeof(DrawIndirectCmd));
+  const GLUploadSlice models =
+      ring.upload(m_models.data(), count * sizeof(glm::mat4));
+  reset();
+
+  GLUploadRing::bindRange(GL_SHADER_STORAGE_BUFFER, kModelsBinding, models);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, cmds.buffer);
+  drawIndirectRange(cmds.offset, 0, count, multiDraw, stats);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+} // namespace Nyx
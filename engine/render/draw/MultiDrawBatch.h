@@ -0,0 +1,86 @@
+#pragma once
+
+#include "render/draw/DrawData.h"
+#include "render/gl/GLMesh.h"
+#include "render/gl/GLUploadRing.h"
+#include <chrono>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Nyx {
+
+// Per-pass submission counters for one frame.
+struct DrawSubmitStats final {
+  uint32_t commands = 0;  // meshes drawn
+  uint32_t drawCalls = 0; // GL draw calls that drew them
+  double cpuMs = 0.0;     // building and submitting the commands
+
+  void add(const DrawSubmitStats &o) {
+    commands += o.commands;
+    drawCalls += o.drawCalls;
+    cpuMs += o.cpuMs;
+  }
+};
+
+// Adds the time until it goes out of scope to stats.cpuMs.
+class SubmitTimer final {
+public:
+  explicit SubmitTimer(DrawSubmitStats &stats)
+      : m_stats(stats), m_start(std::chrono::steady_clock::now()) {}
+  ~SubmitTimer() {
+    m_stats.cpuMs += std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - m_start)
+                         .count();
+  }
+
+private:
+  DrawSubmitStats &m_stats;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+// Consecutive commands of an indirect buffer.
+struct DrawRange final {
+  uint32_t first = 0;
+  uint32_t count = 0;
+};
+
+// Appends command `index`, growing the last range when it is the next one.
+inline void appendDrawIndex(std::vector<DrawRange> &ranges, uint32_t index) {
+  if (!ranges.empty() && ranges.back().first + ranges.back().count == index)
+    ranges.back().count++;
+  else
+    ranges.push_back(DrawRange{index, 1});
+}
+
+// Draws `count` commands starting at command `first` of the commands that
+// begin `base` bytes into the bound GL_DRAW_INDIRECT_BUFFER (GLMeshPool VAO
+// bound): one glMultiDrawElementsIndirect, or one glDrawElementsIndirect per
+// command when `multiDraw` is off.
+void drawIndirectRange(uintptr_t base, uint32_t first, uint32_t count,
+                       bool multiDraw, DrawSubmitStats &stats);
+
+// Indirect commands plus a model matrix per command, for passes whose draws
+// are not in the per-draw SSBO (shadow views). Commands accumulate until
+// submit(), which uploads them and their models through the upload ring and
+// draws them, so each view costs one draw call. The vertex shader reads its
+// model as gModels[gl_BaseInstance] from binding kModelsBinding; base
+// instances count from the first command of the submit.
+class MultiDrawBatch final {
+public:
+  static constexpr uint32_t kModelsBinding = 11;
+
+  void shutdown();
+
+  // Drops commands not submitted yet.
+  void reset();
+
+  void add(const GLMeshRange &mesh, const glm::mat4 &model);
+  void submit(GLUploadRing &ring, bool multiDraw, DrawSubmitStats &stats);
+
+private:
+  std::vector<DrawIndirectCmd> m_cmds;
+  std::vector<glm::mat4> m_models;
+};
+
+} // namespace Nyx
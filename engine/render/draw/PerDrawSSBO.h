@@ -1,6 +1,7 @@
 #pragma once
 
 #include "render/draw/DrawData.h"
+#include "render/gl/GLUploadRing.h"
 #include <cstdint>
 #include <vector>
 
@@ -8,19 +9,20 @@ namespace Nyx {
 
 class PerDrawSSBO final {
 public:
-  void init();
   void shutdown();
 
-  // Upload DrawData[] for this frame. Realloc if needed.
-  void upload(const std::vector<DrawData> &draws);
+  // Upload DrawData[] for this frame into the upload ring.
+  void upload(GLUploadRing &ring, const std::vector<DrawData> &draws);
 
-  uint32_t ssbo() const { return m_ssbo; }
+  // Binds this frame's DrawData[] as an SSBO; gDraw[0] is the first draw.
+  void bind(uint32_t binding) const;
+
+  uint32_t ssbo() const { return m_slice.buffer; }
   uint32_t count() const { return m_count; }
 
 private:
-  uint32_t m_ssbo = 0;
+  GLUploadSlice m_slice{};
   uint32_t m_count = 0;
-  uint32_t m_capacity = 0; // in elements
 };
 
 } // namespace Nyx
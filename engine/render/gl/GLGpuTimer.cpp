@@ -0,0 +1,95 @@
+#include "GLGpuTimer.h"
+
+#include "core/Profiler.h"
+
+#include <glad/glad.h>
+
+namespace Nyx {
+
+GLGpuTimer::~GLGpuTimer() { shutdown(); }
+
+void GLGpuTimer::shutdown() {
+  if (!m_created)
+    return;
+  for (FrameQueries &f : m_frames) {
+    glDeleteQueries(kMaxScopes * 2, f.queries);
+    f.count = 0;
+  }
+  m_created = false;
+}
+
+void GLGpuTimer::beginFrame() {
+  if (!m_created) {
+    for (FrameQueries &f : m_frames)
+      glGenQueries(kMaxScopes * 2, f.queries);
+    m_created = true;
+  }
+
+  m_current = (m_current + 1) % kFrames;
+  FrameQueries &f = m_frames[m_current];
+  collect(f);
+
+  Profiler &p = Profiler::instance();
+  m_recording = p.enabled();
+  if (!m_recording)
+    return;
+
+  // Does not wait for queued commands; only pins the two clocks together.
+  GLint64 gpuNow = 0;
+  glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+  f.gpuToCpuNs = int64_t(p.nowNs()) - int64_t(gpuNow);
+  f.frame = p.frame();
+}
+
+uint32_t GLGpuTimer::begin(const char *name) {
+  FrameQueries &f = m_frames[m_current];
+  if (!m_recording || f.count >= kMaxScopes)
+    return kNone;
+  const uint32_t scope = f.count++;
+  f.names[scope] = name;
+  glQueryCounter(f.queries[scope * 2], GL_TIMESTAMP);
+  return scope;
+}
+
+void GLGpuTimer::end(uint32_t scope) {
+  if (scope == kNone)
+    return;
+  glQueryCounter(m_frames[m_current].queries[scope * 2 + 1], GL_TIMESTAMP);
+}
+
+void GLGpuTimer::collect(FrameQueries &f) {
+  if (f.count == 0)
+    return;
+  const uint32_t count = f.count;
+  f.count = 0;
+
+  // Timestamps complete in order, so the last one stands for the set.
+  GLuint available = GL_FALSE;
+  glGetQueryObjectuiv(f.queries[count * 2 - 1], GL_QUERY_RESULT_AVAILABLE,
+                      &available);
+  if (!available) {
+    ++m_dropped;
+    return;
+  }
+
+  Profiler &p = Profiler::instance();
+  for (uint32_t i = 0; i < count; ++i) {
+    GLuint64 t0 = 0;
+    GLuint64 t1 = 0;
+    glGetQueryObjectui64v(f.queries[i * 2], GL_QUERY_RESULT, &t0);
+    glGetQueryObjectui64v(f.queries[i * 2 + 1], GL_QUERY_RESULT, &t1);
+    const int64_t start = int64_t(t0) + f.gpuToCpuNs;
+    if (start < 0 || t1 < t0)
+      continue;
+
+    ProfileEvent e{};
+    e.name = f.names[i];
+    e.startNs = uint64_t(start);
+    e.endNs = e.startNs + (t1 - t0);
+    e.frame = f.frame;
+    e.track = ProfileTrack::Gpu;
+    p.record(e);
+  }
+}
+
+} // namespace Nyx
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Nyx {
+
+// GPU time of render graph passes from GL_TIMESTAMP query pairs. Query sets
+// are double-buffered: beginFrame() reads back the set issued two frames ago
+// if its results are already available and drops it otherwise, so profiling
+// never waits on the GPU. Results go to the Profiler's GPU track, shifted
+// onto its clock.
+class GLGpuTimer final {
+public:
+  static constexpr uint32_t kFrames = 2;
+  static constexpr uint32_t kMaxScopes = 64;
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  ~GLGpuTimer();
+  void shutdown();
+
+  void beginFrame();
+
+  // `name` must outlive the frame's readback (literal or interned).
+  // Returns kNone when profiling is off or the frame is full.
+  uint32_t begin(const char *name);
+  void end(uint32_t scope);
+
+  // Query sets thrown away because the GPU had not finished them in time.
+  uint32_t droppedFrames() const { return m_dropped; }
+
+private:
+  struct FrameQueries {
+    uint32_t queries[kMaxScopes * 2] = {};
+    const char *names[kMaxScopes] = {};
+    uint32_t count = 0;
+    uint64_t frame = 0;
+    int64_t gpuToCpuNs = 0; // Profiler clock - GL_TIMESTAMP clock
+  };
+
+  void collect(FrameQueries &f);
+
+  FrameQueries m_frames[kFrames];
+  uint32_t m_current = 0;
+  bool m_created = false;
+  bool m_recording = false;
+  uint32_t m_dropped = 0;
+};
+
+} // namespace Nyx
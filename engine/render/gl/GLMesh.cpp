@@ -5,6 +5,36 @@
 
 namespace Nyx {
 
+// VertexPNut layout shared by GLMesh and GLMeshPool.
+static void setupVertexPNut(uint32_t vao, uint32_t vbo, uint32_t ebo) {
+  glVertexArrayVertexBuffer(vao, 0, vbo, 0, sizeof(VertexPNut));
+  glVertexArrayElementBuffer(vao, ebo);
+
+  // layout(location=0) vec3 aPos
+  glEnableVertexArrayAttrib(vao, 0);
+  glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE,
+                            offsetof(VertexPNut, pos));
+  glVertexArrayAttribBinding(vao, 0, 0);
+
+  // layout(location=1) vec3 aNrm
+  glEnableVertexArrayAttrib(vao, 1);
+  glVertexArrayAttribFormat(vao, 1, 3, GL_FLOAT, GL_FALSE,
+                            offsetof(VertexPNut, nrm));
+  glVertexArrayAttribBinding(vao, 1, 0);
+
+  // layout(location=2) vec4 aTan
+  glEnableVertexArrayAttrib(vao, 2);
+  glVertexArrayAttribFormat(vao, 2, 4, GL_FLOAT, GL_FALSE,
+                            offsetof(VertexPNut, tan));
+  glVertexArrayAttribBinding(vao, 2, 0);
+
+  // layout(location=3) vec2 aUV
+  glEnableVertexArrayAttrib(vao, 3);
+  glVertexArrayAttribFormat(vao, 3, 2, GL_FLOAT, GL_FALSE,
+                            offsetof(VertexPNut, uv));
+  glVertexArrayAttribBinding(vao, 3, 0);
+}
+
 GLMesh::~GLMesh() {
   if (m_ebo)
     glDeleteBuffers(1, &m_ebo);
@@ -35,32 +65,7 @@ void GLMesh::upload(const MeshCPU &cpu) {
       m_ebo, static_cast<GLsizeiptr>(cpu.indices.size() * sizeof(uint32_t)),
       cpu.indices.data(), GL_STATIC_DRAW);
 
-  glVertexArrayVertexBuffer(m_vao, 0, m_vbo, 0, sizeof(VertexPNut));
-  glVertexArrayElementBuffer(m_vao, m_ebo);
-
-  // layout(location=0) vec3 aPos
-  glEnableVertexArrayAttrib(m_vao, 0);
-  glVertexArrayAttribFormat(m_vao, 0, 3, GL_FLOAT, GL_FALSE,
-                            offsetof(VertexPNut, pos));
-  glVertexArrayAttribBinding(m_vao, 0, 0);
-
-  // layout(location=1) vec3 aNrm
-  glEnableVertexArrayAttrib(m_vao, 1);
-  glVertexArrayAttribFormat(m_vao, 1, 3, GL_FLOAT, GL_FALSE,
-                            offsetof(VertexPNut, nrm));
-  glVertexArrayAttribBinding(m_vao, 1, 0);
-
-  // layout(location=2) vec4 aTan
-  glEnableVertexArrayAttrib(m_vao, 2);
-  glVertexArrayAttribFormat(m_vao, 2, 4, GL_FLOAT, GL_FALSE,
-                            offsetof(VertexPNut, tan));
-  glVertexArrayAttribBinding(m_vao, 2, 0);
-
-  // layout(location=3) vec2 aUV
-  glEnableVertexArrayAttrib(m_vao, 3);
-  glVertexArrayAttribFormat(m_vao, 3, 2, GL_FLOAT, GL_FALSE,
-                            offsetof(VertexPNut, uv));
-  glVertexArrayAttribBinding(m_vao, 3, 0);
+  setupVertexPNut(m_vao, m_vbo, m_ebo);
 }
 
 void GLMesh::draw() const {
@@ -80,4 +85,88 @@ void GLMesh::drawBaseInstance(uint32_t baseInstance) const {
       nullptr, 1, baseInstance);
 }
 
+void GLMesh::drawIndirect(uint64_t byteOffset) const {
+  if (!m_vao || m_indexCount == 0)
+    return;
+  glBindVertexArray(m_vao);
+  glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                         reinterpret_cast<const void *>(byteOffset));
+}
+
+GLMeshPool::~GLMeshPool() {
+  if (m_ebo)
+    glDeleteBuffers(1, &m_ebo);
+  if (m_vbo)
+    glDeleteBuffers(1, &m_vbo);
+  if (m_vao)
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+void GLMeshPool::upload(const std::vector<MeshCPU> &meshes) {
+  size_t vertexCount = 0;
+  size_t indexCount = 0;
+  for (const MeshCPU &m : meshes) {
+    NYX_ASSERT(!m.vertices.empty(), "GLMeshPool upload: no vertices");
+    NYX_ASSERT(!m.indices.empty(), "GLMeshPool upload: no indices");
+    vertexCount += m.vertices.size();
+    indexCount += m.indices.size();
+  }
+
+  std::vector<VertexPNut> vertices;
+  std::vector<uint32_t> indices;
+  vertices.reserve(vertexCount);
+  indices.reserve(indexCount);
+  m_ranges.clear();
+  m_ranges.reserve(meshes.size());
+  for (const MeshCPU &m : meshes) {
+    GLMeshRange r{};
+    r.firstIndex = static_cast<uint32_t>(indices.size());
+    r.indexCount = static_cast<uint32_t>(m.indices.size());
+    r.baseVertex = static_cast<int32_t>(vertices.size());
+    m_ranges.push_back(r);
+    vertices.insert(vertices.end(), m.vertices.begin(), m.vertices.end());
+    indices.insert(indices.end(), m.indices.begin(), m.indices.end());
+  }
+
+  if (!m_vao)
+    glCreateVertexArrays(1, &m_vao);
+  if (!m_vbo)
+    glCreateBuffers(1, &m_vbo);
+  if (!m_ebo)
+    glCreateBuffers(1, &m_ebo);
+
+  glNamedBufferData(m_vbo,
+                    static_cast<GLsizeiptr>(vertices.size() * sizeof(VertexPNut)),
+                    vertices.data(), GL_STATIC_DRAW);
+  glNamedBufferData(m_ebo,
+                    static_cast<GLsizeiptr>(indices.size() * sizeof(uint32_t)),
+                    indices.data(), GL_STATIC_DRAW);
+
+  setupVertexPNut(m_vao, m_vbo, m_ebo);
+}
+
+void GLMeshPool::bind() const { glBindVertexArray(m_vao); }
+
+void GLMeshPool::draw(uint32_t i) const {
+  if (!m_vao || i >= m_ranges.size())
+    return;
+  const GLMeshRange &r = m_ranges[i];
+  glBindVertexArray(m_vao);
+  glDrawElementsBaseVertex(
+      GL_TRIANGLES, static_cast<GLsizei>(r.indexCount), GL_UNSIGNED_INT,
+      reinterpret_cast<const void *>(uintptr_t(r.firstIndex) * sizeof(uint32_t)),
+      r.baseVertex);
+}
+
+void GLMeshPool::drawBaseInstance(uint32_t i, uint32_t baseInstance) const {
+  if (!m_vao || i >= m_ranges.size())
+    return;
+  const GLMeshRange &r = m_ranges[i];
+  glBindVertexArray(m_vao);
+  glDrawElementsInstancedBaseVertexBaseInstance(
+      GL_TRIANGLES, static_cast<GLsizei>(r.indexCount), GL_UNSIGNED_INT,
+      reinterpret_cast<const void *>(uintptr_t(r.firstIndex) * sizeof(uint32_t)),
+      1, r.baseVertex, baseInstance);
+}
+
 } // namespace Nyx
@@ -2,6 +2,7 @@
 
 #include "npgms/MeshCPU.h"
 #include <cstdint>
+#include <vector>
 
 namespace Nyx {
 
@@ -12,6 +13,11 @@ public:
   void upload(const MeshCPU &cpu);
   void draw() const;
   void drawBaseInstance(uint32_t baseInstance) const;
+  // Draws one DrawElementsIndirectCommand from the bound
+  // GL_DRAW_INDIRECT_BUFFER at `byteOffset`.
+  void drawIndirect(uint64_t byteOffset) const;
+
+  uint32_t indexCount() const { return m_indexCount; }
 
 private:
   uint32_t m_vao = 0;
@@ -20,4 +26,36 @@ private:
   uint32_t m_indexCount = 0;
 };
 
+// Where one mesh lives inside a GLMeshPool, in DrawElementsIndirectCommand
+// terms.
+struct GLMeshRange final {
+  uint32_t firstIndex = 0;
+  uint32_t indexCount = 0;
+  int32_t baseVertex = 0;
+};
+
+// Several meshes packed into one vertex/index buffer pair behind one VAO, so
+// draws of different meshes can share a glMultiDrawElementsIndirect.
+class GLMeshPool final {
+public:
+  ~GLMeshPool();
+
+  // Replaces the pool contents; range(i) describes meshes[i].
+  void upload(const std::vector<MeshCPU> &meshes);
+
+  const GLMeshRange &range(uint32_t i) const { return m_ranges[i]; }
+  uint32_t meshCount() const { return (uint32_t)m_ranges.size(); }
+  uint32_t vao() const { return m_vao; }
+
+  void bind() const;
+  void draw(uint32_t i) const;
+  void drawBaseInstance(uint32_t i, uint32_t baseInstance) const;
+
+private:
+  uint32_t m_vao = 0;
+  uint32_t m_vbo = 0;
+  uint32_t m_ebo = 0;
+  std::vector<GLMeshRange> m_ranges;
+};
+
 } // namespace Nyx
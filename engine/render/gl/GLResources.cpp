@@ -21,6 +21,8 @@ uint32_t GLResources::glInternalFormat(RGFormat f) {
     return GL_R32UI;
   case RGFormat::R32F:
     return GL_R32F;
+  case RGFormat::RG32F:
+    return GL_RG32F;
   default:
     return GL_RGBA8;
   }
@@ -34,6 +36,8 @@ uint32_t GLResources::glFormat(RGFormat f) {
     return GL_RED_INTEGER;
   case RGFormat::R32F:
     return GL_RED;
+  case RGFormat::RG32F:
+    return GL_RG;
   default:
     return GL_RGBA;
   }
@@ -48,6 +52,7 @@ uint32_t GLResources::glType(RGFormat f) {
   case RGFormat::R32UI:
     return GL_UNSIGNED_INT;
   case RGFormat::R32F:
+  case RGFormat::RG32F:
     return GL_FLOAT;
   default:
     return GL_UNSIGNED_BYTE;
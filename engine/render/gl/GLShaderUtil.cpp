@@ -1,11 +1,132 @@
 #include "GLShaderUtil.h"
 
 #include "core/Log.h"
+#include "render/rg/RGName.h"
 
 #include <glad/glad.h>
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace Nyx {
 
+namespace {
+
+std::unordered_map<uint32_t, GLProgramReflection> &reflectionCache() {
+  static std::unordered_map<uint32_t, GLProgramReflection> cache;
+  return cache;
+}
+
+template <class T>
+const T *findByName(const std::vector<T> &items, std::string_view name) {
+  const uint64_t h = GLProgramReflection::hashName(name);
+  for (const T &it : items) {
+    if (it.hash == h && it.name == name)
+      return &it;
+  }
+  return nullptr;
+}
+
+std::string resourceName(uint32_t prog, GLenum iface, uint32_t index,
+                         GLint length) {
+  std::string name;
+  name.resize(static_cast<size_t>(std::max(length, 1)));
+  GLsizei outLen = 0;
+  glGetProgramResourceName(prog, iface, index, length, &outLen, name.data());
+  name.resize(static_cast<size_t>(outLen));
+  return name;
+}
+
+void reflectBlocks(uint32_t prog, GLenum iface,
+                   std::vector<GLProgramReflection::Block> &out) {
+  GLint count = 0;
+  glGetProgramInterfaceiv(prog, iface, GL_ACTIVE_RESOURCES, &count);
+  out.reserve(static_cast<size_t>(count));
+  for (GLint i = 0; i < count; ++i) {
+    const GLenum props[] = {GL_NAME_LENGTH, GL_BUFFER_BINDING};
+    GLint values[2] = {};
+    glGetProgramResourceiv(prog, iface, static_cast<GLuint>(i), 2, props, 2,
+                           nullptr, values);
+    GLProgramReflection::Block b{};
+    b.name = resourceName(prog, iface, static_cast<uint32_t>(i), values[0]);
+    b.hash = GLProgramReflection::hashName(b.name);
+    b.index = static_cast<uint32_t>(i);
+    b.binding = values[1];
+    out.push_back(std::move(b));
+  }
+}
+
+} // namespace
+
+uint64_t GLProgramReflection::hashName(std::string_view name) {
+  return RGName::hashOf(name);
+}
+
+int GLProgramReflection::uniform(std::string_view name) const {
+  const Uniform *u = findByName(m_uniforms, name);
+  return u ? u->location : -1;
+}
+
+int GLProgramReflection::uniformBlockBinding(std::string_view name) const {
+  const Block *b = findByName(m_uniformBlocks, name);
+  return b ? b->binding : -1;
+}
+
+int GLProgramReflection::storageBlockBinding(std::string_view name) const {
+  const Block *b = findByName(m_storageBlocks, name);
+  return b ? b->binding : -1;
+}
+
+void GLShaderUtil::reflectProgram(uint32_t prog) {
+  GLProgramReflection r{};
+
+  GLint count = 0;
+  glGetProgramInterfaceiv(prog, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+  r.m_uniforms.reserve(static_cast<size_t>(count));
+  for (GLint i = 0; i < count; ++i) {
+    const GLenum props[] = {GL_NAME_LENGTH, GL_LOCATION, GL_TYPE,
+                            GL_ARRAY_SIZE, GL_BLOCK_INDEX};
+    GLint values[5] = {};
+    glGetProgramResourceiv(prog, GL_UNIFORM, static_cast<GLuint>(i), 5, props,
+                           5, nullptr, values);
+    if (values[4] != -1)
+      continue; // block member; has no location
+
+    GLProgramReflection::Uniform u{};
+    u.name =
+        resourceName(prog, GL_UNIFORM, static_cast<uint32_t>(i), values[0]);
+    if (u.name.ends_with("[0]"))
+      u.name.resize(u.name.size() - 3);
+    u.hash = GLProgramReflection::hashName(u.name);
+    u.location = values[1];
+    u.type = static_cast<uint32_t>(values[2]);
+    u.arraySize = values[3];
+    r.m_uniforms.push_back(std::move(u));
+  }
+
+  reflectBlocks(prog, GL_UNIFORM_BLOCK, r.m_uniformBlocks);
+  reflectBlocks(prog, GL_SHADER_STORAGE_BLOCK, r.m_storageBlocks);
+
+  reflectionCache()[prog] = std::move(r);
+}
+
+const GLProgramReflection &GLShaderUtil::reflection(uint32_t prog) {
+  static const GLProgramReflection kEmpty{};
+  if (prog == 0)
+    return kEmpty;
+  auto &cache = reflectionCache();
+  auto it = cache.find(prog);
+  if (it == cache.end()) {
+    reflectProgram(prog);
+    it = cache.find(prog);
+  }
+  return it->second;
+}
+
+void GLShaderUtil::forgetReflection(uint32_t prog) {
+  reflectionCache().erase(prog);
+}
+
 std::string GLShaderUtil::stageName(uint32_t glStage) {
   switch (glStage) {
   case GL_VERTEX_SHADER:
@@ -138,6 +259,7 @@ uint32_t GLShaderUtil::linkProgram(uint32_t vs, uint32_t fs) {
   glDetachShader(prog, vs);
   glDetachShader(prog, fs);
 
+  reflectProgram(prog);
   return prog;
 }
 
@@ -170,6 +292,7 @@ uint32_t GLShaderUtil::linkProgramCompute(uint32_t cs) {
   }
 
   glDetachShader(prog, cs);
+  reflectProgram(prog);
   return prog;
 }
 
@@ -4,9 +4,50 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace Nyx {
 
+// Active uniforms and blocks of one linked program, queried once after link.
+// Lookups are a hash and a scan over a handful of entries; no driver calls.
+class GLProgramReflection final {
+public:
+  struct Uniform {
+    uint64_t hash = 0;
+    int location = -1;
+    uint32_t type = 0; // GL type enum
+    int arraySize = 1;
+    std::string name; // array uniforms without the "[0]"
+  };
+
+  struct Block {
+    uint64_t hash = 0;
+    uint32_t index = 0;
+    int binding = -1;
+    std::string name;
+  };
+
+  // -1 if the program has no such (active) uniform.
+  int uniform(std::string_view name) const;
+  // Binding of a uniform / shader storage block, -1 if absent.
+  int uniformBlockBinding(std::string_view name) const;
+  int storageBlockBinding(std::string_view name) const;
+
+  const std::vector<Uniform> &uniforms() const { return m_uniforms; }
+  const std::vector<Block> &uniformBlocks() const { return m_uniformBlocks; }
+  const std::vector<Block> &storageBlocks() const { return m_storageBlocks; }
+
+  static uint64_t hashName(std::string_view name);
+
+private:
+  friend class GLShaderUtil;
+
+  std::vector<Uniform> m_uniforms;
+  std::vector<Block> m_uniformBlocks;
+  std::vector<Block> m_storageBlocks;
+};
+
 // Centralized OpenGL shader compilation/link helpers.
 // - takes GLSL sources from ShaderSourceLoader (files + includes)
 // - prints full logs on failure
@@ -38,12 +79,24 @@ public:
   uint32_t buildProgramVF(const std::string &vsPath, const std::string &fsPath);
   uint32_t buildProgramC(const std::string &csPath);
 
+  // Reflection cache, keyed by program name. linkProgram*() fill it, so a
+  // recycled program name never sees a stale entry; programs linked
+  // elsewhere are reflected on first use.
+  static const GLProgramReflection &reflection(uint32_t prog);
+  static int uniformLocation(uint32_t prog, std::string_view name) {
+    return reflection(prog).uniform(name);
+  }
+  // Drops the cached entry, e.g. for a program linked outside linkProgram*()
+  // whose name may have been recycled.
+  static void forgetReflection(uint32_t prog);
+
 private:
   ShaderSourceLoader m_loader;
 
   static std::string stageName(uint32_t glStage);
   static std::string getShaderInfoLog(uint32_t shader);
   static std::string getProgramInfoLog(uint32_t prog);
+  static void reflectProgram(uint32_t prog);
 };
 
 } // namespace Nyx
@@ -0,0 +1,163 @@
+#include "GLUploadRing.h"
+
+#include "core/Assert.h"
+#include "core/Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <glad/glad.h>
+
+namespace Nyx {
+
+static uint32_t alignUp(uint32_t v, uint32_t a) { return (v + a - 1) / a * a; }
+
+GLUploadRing::~GLUploadRing() { shutdown(); }
+
+void GLUploadRing::init(uint32_t bytesPerFrame) {
+  GLint ssboAlign = 0;
+  GLint uboAlign = 0;
+  glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &ssboAlign);
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uboAlign);
+  m_alignment = std::max<uint32_t>(
+      16u, std::max<uint32_t>((uint32_t)ssboAlign, (uint32_t)uboAlign));
+
+  createBuffer(bytesPerFrame);
+}
+
+void GLUploadRing::shutdown() {
+  for (void *&f : m_fences) {
+    if (f) {
+      glDeleteSync(static_cast<GLsync>(f));
+      f = nullptr;
+    }
+  }
+  for (uint32_t b : m_retired)
+    glDeleteBuffers(1, &b);
+  m_retired.clear();
+  if (m_buffer) {
+    glUnmapNamedBuffer(m_buffer);
+    glDeleteBuffers(1, &m_buffer);
+    m_buffer = 0;
+  }
+  m_mapped = nullptr;
+  m_frameCapacity = 0;
+  m_head = 0;
+}
+
+void GLUploadRing::createBuffer(uint32_t bytesPerFrame) {
+  m_frameCapacity = alignUp(std::max(bytesPerFrame, m_alignment), m_alignment);
+  const GLbitfield flags =
+      GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  const GLsizeiptr total = GLsizeiptr(m_frameCapacity) * kFrames;
+
+  glCreateBuffers(1, &m_buffer);
+  glNamedBufferStorage(m_buffer, total, nullptr, flags);
+  m_mapped =
+      static_cast<uint8_t *>(glMapNamedBufferRange(m_buffer, 0, total, flags));
+  NYX_ASSERT(m_mapped != nullptr, "GLUploadRing: persistent map failed");
+  m_stats.frameCapacity = m_frameCapacity;
+}
+
+void GLUploadRing::waitFence(void *&fence) {
+  if (!fence)
+    return;
+  GLsync sync = static_cast<GLsync>(fence);
+  GLenum r = glClientWaitSync(sync, 0, 0);
+  if (r == GL_TIMEOUT_EXPIRED) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    ++m_stats.stalls;
+    ++m_stats.stallsLastFrame;
+    do {
+      r = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+    } while (r == GL_TIMEOUT_EXPIRED);
+    m_stats.stallMs +=
+        std::chrono::duration<double, std::milli>(Clock::now() - start)
+            .count();
+  }
+  glDeleteSync(sync);
+  fence = nullptr;
+}
+
+void GLUploadRing::beginFrame() {
+  if (!m_buffer)
+    return;
+
+  m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  m_stats.bytesLastFrame = m_frameBytes;
+  m_stats.allocationsLastFrame = m_frameAllocations;
+  m_stats.stallsLastFrame = 0;
+  m_frameBytes = 0;
+  m_frameAllocations = 0;
+
+  for (uint32_t b : m_retired)
+    glDeleteBuffers(1, &b);
+  m_retired.clear();
+
+  m_frame = (m_frame + 1) % kFrames;
+  m_head = 0;
+  waitFence(m_fences[m_frame]);
+}
+
+GLUploadSlice GLUploadRing::allocate(size_t bytes) {
+  if (!m_buffer)
+    init();
+
+  // Zero-sized ranges cannot be bound; hand out a minimal one instead.
+  const uint32_t size = static_cast<uint32_t>(std::max<size_t>(bytes, 4));
+  if (m_head + size > m_frameCapacity) {
+    // Nothing in a fresh buffer is in flight, so its fences start clear.
+    Log::Warn("GLUploadRing: frame needs more than {} KB, growing",
+              m_frameCapacity / 1024);
+    for (void *&f : m_fences) {
+      if (f) {
+        glDeleteSync(static_cast<GLsync>(f));
+        f = nullptr;
+      }
+    }
+    // Left mapped: slices handed out this frame may not be written yet.
+    m_retired.push_back(m_buffer);
+    createBuffer(std::max(m_frameCapacity * 2u, size * 2u));
+    m_head = 0;
+    ++m_stats.grows;
+  }
+
+  GLUploadSlice s{};
+  s.buffer = m_buffer;
+  s.offset = m_frame * m_frameCapacity + m_head;
+  s.size = size;
+  s.ptr = m_mapped + s.offset;
+  m_head = std::min(alignUp(m_head + size, m_alignment), m_frameCapacity);
+
+  m_frameBytes += bytes;
+  ++m_frameAllocations;
+  return s;
+}
+
+GLUploadSlice GLUploadRing::upload(const void *data, size_t bytes) {
+  GLUploadSlice s = allocate(bytes);
+  if (bytes > 0)
+    std::memcpy(s.ptr, data, bytes);
+  return s;
+}
+
+void GLUploadRing::uploadToBuffer(uint32_t dst, size_t dstOffset,
+                                  const void *data, size_t bytes) {
+  if (bytes == 0)
+    return;
+  const GLUploadSlice s = upload(data, bytes);
+  glCopyNamedBufferSubData(s.buffer, dst, s.offset,
+                           static_cast<GLintptr>(dstOffset),
+                           static_cast<GLsizeiptr>(bytes));
+}
+
+void GLUploadRing::bindRange(uint32_t target, uint32_t binding,
+                             const GLUploadSlice &slice) {
+  if (!slice)
+    return;
+  glBindBufferRange(target, binding, slice.buffer, slice.offset, slice.size);
+}
+
+} // namespace Nyx
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nyx {
+
+// A piece of the upload ring, valid until the ring comes back around to the
+// frame that allocated it.
+struct GLUploadSlice {
+  uint32_t buffer = 0;
+  uint32_t offset = 0; // bytes
+  uint32_t size = 0;   // bytes
+  void *ptr = nullptr;
+
+  explicit operator bool() const { return buffer != 0; }
+};
+
+struct GLUploadRingStats {
+  uint64_t bytesLastFrame = 0;
+  uint32_t allocationsLastFrame = 0;
+  uint32_t stallsLastFrame = 0; // beginFrame() had to wait on the GPU
+  uint32_t stalls = 0;          // since init
+  double stallMs = 0.0;         // since init
+  uint32_t frameCapacity = 0;   // bytes per frame region
+  uint32_t grows = 0;
+};
+
+// Per-frame upload memory: one persistently mapped, coherent buffer split
+// into kFrames regions. Each frame sub-allocates linearly from its region;
+// beginFrame() fences the region just filled and waits for the fence of the
+// one it is about to reuse, so the CPU never writes memory the GPU may still
+// read and no call orphans or implicitly syncs in the driver.
+//
+// A frame that outgrows its region moves to a bigger buffer; the old one is
+// kept until the next beginFrame() so slices already handed out stay valid.
+class GLUploadRing final {
+public:
+  static constexpr uint32_t kFrames = 3;
+
+  ~GLUploadRing();
+
+  void init(uint32_t bytesPerFrame = 2u << 20);
+  void shutdown();
+
+  void beginFrame();
+
+  // Memory for `bytes`, aligned for SSBO/UBO binding; write through ptr.
+  GLUploadSlice allocate(size_t bytes);
+  // allocate() + copy.
+  GLUploadSlice upload(const void *data, size_t bytes);
+
+  // Copies `bytes` into `dst` at `dstOffset` through the ring. For data that
+  // changes rarely but has to outlive the frame (material tables).
+  void uploadToBuffer(uint32_t dst, size_t dstOffset, const void *data,
+                      size_t bytes);
+
+  static void bindRange(uint32_t target, uint32_t binding,
+                        const GLUploadSlice &slice);
+
+  const GLUploadRingStats &stats() const { return m_stats; }
+
+private:
+  void createBuffer(uint32_t bytesPerFrame);
+  void waitFence(void *&fence);
+
+  uint32_t m_buffer = 0;
+  uint8_t *m_mapped = nullptr;
+  uint32_t m_frameCapacity = 0;
+  uint32_t m_alignment = 256;
+
+  uint32_t m_frame = 0; // region being filled
+  uint32_t m_head = 0;  // bytes used in it
+  void *m_fences[kFrames] = {};
+
+  std::vector<uint32_t> m_retired; // outgrown buffers, freed next frame
+
+  GLUploadRingStats m_stats{};
+  uint64_t m_frameBytes = 0;
+  uint32_t m_frameAllocations = 0;
+};
+
+} // namespace Nyx
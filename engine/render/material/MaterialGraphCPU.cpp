@@ -0,0 +1,364 @@
+#include "MaterialGraphCPU.h"
+
+#include "MaterialGraphCPUKernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                     \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NYX_MATCPU_SSE 1
+#include <immintrin.h>
+#endif
+
+#if defined(NYX_MATCPU_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Nyx {
+
+namespace MatCPU {
+
+void powLanes(float *x, const float *y, uint32_t n) {
+  for (uint32_t i = 0; i < n; ++i)
+    x[i] = std::pow(x[i], y[i]);
+}
+
+void sampleLanes(const MatCPUTextureSource *src, uint32_t tex, const float *u,
+                 const float *v, uint32_t n, const float def[4], float *rgba) {
+  glm::vec4 texels[64];
+  if (n <= 64 && src && src->sample(tex, u, v, n, texels)) {
+    for (uint32_t i = 0; i < n; ++i)
+      for (uint32_t c = 0; c < 4; ++c)
+        rgba[c * n + i] = texels[i][c];
+    return;
+  }
+  for (uint32_t c = 0; c < 4; ++c)
+    std::fill_n(rgba + c * n, n, def[c]);
+}
+
+namespace {
+
+// Plain C++ over 4 lanes; compilers without SSE still get one op dispatch
+// per 4 pixels and loops they can auto-vectorize.
+struct PackScalar final {
+  static constexpr uint32_t W = 4;
+  struct F {
+    float v[4];
+  };
+
+  template <class Op> static F map(F a, F b, Op op) {
+    F r;
+    for (uint32_t i = 0; i < 4; ++i)
+      r.v[i] = op(a.v[i], b.v[i]);
+    return r;
+  }
+
+  static F load(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+  static void store(float *p, F a) {
+    for (uint32_t i = 0; i < 4; ++i)
+      p[i] = a.v[i];
+  }
+  static F set1(float x) { return {{x, x, x, x}}; }
+  static F add(F a, F b) {
+    return map(a, b, [](float x, float y) { return x + y; });
+  }
+  static F sub(F a, F b) {
+    return map(a, b, [](float x, float y) { return x - y; });
+  }
+  static F mul(F a, F b) {
+    return map(a, b, [](float x, float y) { return x * y; });
+  }
+  static F div(F a, F b) {
+    return map(a, b, [](float x, float y) { return x / y; });
+  }
+  // GLSL's definitions (min: y < x ? y : x, max: x < y ? y : x), which the
+  // SIMD packs match by swapping the minps/maxps operands.
+  static F min(F a, F b) {
+    return map(a, b, [](float x, float y) { return y < x ? y : x; });
+  }
+  static F max(F a, F b) {
+    return map(a, b, [](float x, float y) { return x < y ? y : x; });
+  }
+  static F sqrt(F a) {
+    F r;
+    for (uint32_t i = 0; i < 4; ++i)
+      r.v[i] = std::sqrt(a.v[i]);
+    return r;
+  }
+};
+
+#if defined(NYX_MATCPU_SSE)
+struct PackSSE final {
+  static constexpr uint32_t W = 4;
+  using F = __m128;
+
+  static F load(const float *p) { return _mm_loadu_ps(p); }
+  static void store(float *p, F a) { _mm_storeu_ps(p, a); }
+  static F set1(float x) { return _mm_set1_ps(x); }
+  static F add(F a, F b) { return _mm_add_ps(a, b); }
+  static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+  static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+  static F div(F a, F b) { return _mm_div_ps(a, b); }
+  static F min(F a, F b) { return _mm_min_ps(b, a); }
+  static F max(F a, F b) { return _mm_max_ps(b, a); }
+  static F sqrt(F a) { return _mm_sqrt_ps(a); }
+};
+#endif
+
+} // namespace
+
+void runScalar(const Job &job) { Kernel<PackScalar>(job).run(); }
+
+#if defined(NYX_MATCPU_SSE)
+void runSSE(const Job &job) { Kernel<PackSSE>(job).run(); }
+#endif
+
+} // namespace MatCPU
+
+static bool cpuHasAVX2() {
+#if defined(NYX_MATCPU_AVX2)
+#if defined(_MSC_VER)
+  int regs[4] = {};
+  __cpuid(regs, 1);
+  const bool osxsave = (regs[2] & (1 << 27)) != 0;
+  const bool avx = (regs[2] & (1 << 28)) != 0;
+  if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+    return false;
+  __cpuidex(regs, 7, 0);
+  return (regs[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+#else
+  return false;
+#endif
+}
+
+const char *matCPUPathName(MatCPUPath path) {
+  switch (path) {
+  case MatCPUPath::SSE:
+    return "SSE";
+  case MatCPUPath::AVX2:
+    return "AVX2";
+  default:
+    return "Scalar";
+  }
+}
+
+bool matCPUPathSupported(MatCPUPath path) {
+  switch (path) {
+  case MatCPUPath::Scalar:
+    return true;
+  case MatCPUPath::SSE:
+#if defined(NYX_MATCPU_SSE)
+    return true;
+#else
+    return false;
+#endif
+  case MatCPUPath::AVX2: {
+    static const bool has = cpuHasAVX2();
+    return has;
+  }
+  }
+  return false;
+}
+
+MatCPUPath matCPUBestPath() {
+  if (matCPUPathSupported(MatCPUPath::AVX2))
+    return MatCPUPath::AVX2;
+  if (matCPUPathSupported(MatCPUPath::SSE))
+    return MatCPUPath::SSE;
+  return MatCPUPath::Scalar;
+}
+
+bool evalMaterialCPU(const CompiledMaterialGraph &g, const MatCPUSample *in,
+                     MatCPUSurface *out, uint32_t count,
+                     const MatCPUTextureSource *textures, MatCPUPath path) {
+  if (g.nodes.empty())
+    return false;
+
+  MatCPU::Job job{};
+  job.nodes = g.nodes.data();
+  job.nodeCount = (uint32_t)g.nodes.size();
+  job.header = g.header;
+  job.in = in;
+  job.out = out;
+  job.count = count;
+  job.textures = textures;
+
+  // Every register an op or the header touches must fit the register file.
+  const GpuMatGraphHeader &h = g.header;
+  uint32_t regs = 3;
+  for (uint32_t r : {h.outBaseColor, h.outMR, h.outNormalWS, h.outEmissive,
+                     h.outAlpha})
+    regs = std::max(regs, r + 1);
+  for (const GpuMatNode &n : g.nodes) {
+    const MatOp op = static_cast<MatOp>(n.op);
+    if (op == MatOp::OutputSurface)
+      continue;
+    regs = std::max(regs, n.dst + 1);
+    if (op == MatOp::Const4)
+      continue;
+    regs = std::max(regs, n.a + 1);
+    switch (op) {
+    case MatOp::Append:
+    case MatOp::Lerp:
+      regs = std::max({regs, n.b + 1, n.c + 1});
+      break;
+    case MatOp::Add:
+    case MatOp::Sub:
+    case MatOp::Mul:
+    case MatOp::Div:
+    case MatOp::Min:
+    case MatOp::Max:
+    case MatOp::Pow:
+    case MatOp::Dot3:
+    case MatOp::NormalMapTS:
+      regs = std::max(regs, n.b + 1);
+      break;
+    default:
+      break;
+    }
+    job.needsTBN = job.needsTBN || op == MatOp::NormalMapTS;
+  }
+  if (regs > kMatVM_MaxRegs)
+    return false;
+
+  if (!matCPUPathSupported(path))
+    path = matCPUBestPath();
+  switch (path) {
+#if defined(NYX_MATCPU_AVX2)
+  case MatCPUPath::AVX2:
+    MatCPU::runAVX2(job);
+    break;
+#endif
+#if defined(NYX_MATCPU_SSE)
+  case MatCPUPath::SSE:
+    MatCPU::runSSE(job);
+    break;
+#endif
+  default:
+    MatCPU::runScalar(job);
+    break;
+  }
+  return true;
+}
+
+void MatCPUImageTextures::set(uint32_t tex, uint32_t width, uint32_t height,
+                              std::vector<uint8_t> rgba8) {
+  if (width == 0 || height == 0 ||
+      rgba8.size() < size_t(width) * height * 4) {
+    m_images.erase(tex);
+    return;
+  }
+  m_images[tex] = Image{width, height, std::move(rgba8)};
+}
+
+bool MatCPUImageTextures::sample(uint32_t tex, const float *u, const float *v,
+                                 uint32_t count, glm::vec4 *out) const {
+  auto it = m_images.find(tex);
+  if (it == m_images.end())
+    return false;
+  const Image &img = it->second;
+  const auto texel = [&](int32_t x, int32_t y) {
+    const uint8_t *p = &img.rgba8[(size_t(y) * img.width + x) * 4];
+    return glm::vec4(p[0], p[1], p[2], p[3]) * (1.0f / 255.0f);
+  };
+  const auto wrap = [](int32_t i, int32_t n) {
+    i %= n;
+    return i < 0 ? i + n : i;
+  };
+
+  const int32_t w = int32_t(img.width), h = int32_t(img.height);
+  for (uint32_t i = 0; i < count; ++i) {
+    // Texel centers at half-integers, as GL_LINEAR with GL_REPEAT.
+    const float x = u[i] * float(w) - 0.5f;
+    const float y = v[i] * float(h) - 0.5f;
+    if (!std::isfinite(x) || !std::isfinite(y)) {
+      out[i] = glm::vec4(0.0f);
+      continue;
+    }
+    const float fx = std::floor(x), fy = std::floor(y);
+    const float tx = x - fx, ty = y - fy;
+    const int32_t x0 = wrap(int32_t(std::fmod(fx, float(w))), w);
+    const int32_t y0 = wrap(int32_t(std::fmod(fy, float(h))), h);
+    const int32_t x1 = wrap(x0 + 1, w), y1 = wrap(y0 + 1, h);
+    const glm::vec4 top = glm::mix(texel(x0, y0), texel(x1, y0), tx);
+    const glm::vec4 bot = glm::mix(texel(x0, y1), texel(x1, y1), tx);
+    out[i] = glm::mix(top, bot, ty);
+  }
+  return true;
+}
+
+bool renderMaterialThumbnailCPU(const CompiledMaterialGraph &g, uint32_t size,
+                                std::vector<uint8_t> &rgba8,
+                                const MatCPUTextureSource *textures) {
+  if (size == 0)
+    return false;
+
+  // Orthographic unit sphere seen down -Z; UVs as the Sphere primitive maps
+  // them (longitude, latitude).
+  std::vector<MatCPUSample> samples;
+  std::vector<uint32_t> pixels;
+  samples.reserve(size_t(size) * size);
+  pixels.reserve(size_t(size) * size);
+  constexpr float kPi = 3.14159265358979f;
+  for (uint32_t y = 0; y < size; ++y) {
+    for (uint32_t x = 0; x < size; ++x) {
+      const float px = (float(x) + 0.5f) / float(size) * 2.0f - 1.0f;
+      const float py = 1.0f - (float(y) + 0.5f) / float(size) * 2.0f;
+      const float r2 = px * px + py * py;
+      if (r2 > 1.0f)
+        continue;
+      const glm::vec3 n(px, py, std::sqrt(1.0f - r2));
+      MatCPUSample s{};
+      s.normal = n;
+      s.viewDir = glm::vec3(0.0f, 0.0f, 1.0f);
+      s.uv = glm::vec2(0.5f + std::atan2(n.x, n.z) / (2.0f * kPi),
+                       0.5f - std::asin(n.y) / kPi);
+      const glm::vec3 t = glm::normalize(glm::vec3(n.z, 0.0f, -n.x) + 1e-6f);
+      s.tangent = glm::vec4(t, 1.0f);
+      samples.push_back(s);
+      pixels.push_back(y * size + x);
+    }
+  }
+
+  std::vector<MatCPUSurface> surf(samples.size());
+  if (!evalMaterialCPU(g, samples.data(), surf.data(),
+                       (uint32_t)samples.size(), textures))
+    return false;
+
+  rgba8.assign(size_t(size) * size * 4, 0);
+  const glm::vec3 L = glm::normalize(glm::vec3(-0.5f, 0.7f, 0.8f));
+  const glm::vec3 V(0.0f, 0.0f, 1.0f);
+  const glm::vec3 H = glm::normalize(L + V);
+  for (size_t i = 0; i < surf.size(); ++i) {
+    const MatCPUSurface &s = surf[i];
+    const glm::vec3 N = s.normalWS;
+    const float metal = glm::clamp(s.metallic, 0.0f, 1.0f);
+    const float rough = glm::clamp(s.roughness, 0.04f, 1.0f);
+    const float ndl = std::max(glm::dot(N, L), 0.0f);
+    const float ndh = std::max(glm::dot(N, H), 0.0f);
+
+    // Lambert plus normalized Blinn-Phong; enough to read the material.
+    const glm::vec3 f0 = glm::mix(glm::vec3(0.04f), s.baseColor, metal);
+    const float specPow = 2.0f / (rough * rough * rough * rough) - 2.0f;
+    const float spec = (specPow + 8.0f) / (8.0f * kPi) *
+                       std::pow(ndh, std::max(specPow, 1.0f));
+    const glm::vec3 diffuse = s.baseColor * (1.0f - metal) / kPi;
+    glm::vec3 c = (diffuse + f0 * spec) * ndl * 3.0f;
+    c += s.baseColor * 0.15f * s.ao + s.emissive;
+    c = c / (c + glm::vec3(1.0f)); // Reinhard
+
+    uint8_t *p = &rgba8[size_t(pixels[i]) * 4];
+    for (int k = 0; k < 3; ++k)
+      p[k] = uint8_t(std::pow(glm::clamp(c[k], 0.0f, 1.0f), 1.0f / 2.2f) *
+                         255.0f +
+                     0.5f);
+    p[3] = uint8_t(glm::clamp(s.alpha, 0.0f, 1.0f) * 255.0f + 0.5f);
+  }
+  return true;
+}
+
+} // namespace Nyx
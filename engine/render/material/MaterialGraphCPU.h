@@ -0,0 +1,87 @@
+#pragma once
+
+#include "MaterialGraphCompiler.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Nyx {
+
+// Per-pixel inputs: the VM builtins plus the tangent frame NormalMapTS uses.
+struct MatCPUSample final {
+  glm::vec2 uv{0.0f};                    // r0 (already scaled/offset)
+  glm::vec3 normal{0.0f, 0.0f, 1.0f};    // r1, normalized by the VM
+  glm::vec3 viewDir{0.0f, 0.0f, 1.0f};   // r2, normalized by the VM
+  glm::vec4 tangent{1.0f, 0.0f, 0.0f, 1.0f}; // xyz world, w = bitangent sign
+};
+
+// What evalMaterial() returns.
+struct MatCPUSurface final {
+  glm::vec3 baseColor{1.0f};
+  float metallic = 0.0f;
+  float roughness = 0.5f;
+  float ao = 1.0f;
+  glm::vec3 emissive{0.0f};
+  glm::vec3 normalWS{0.0f, 0.0f, 1.0f};
+  float alpha = 1.0f;
+};
+
+// Texture lookups for the Tex2D ops and NormalMapTS, a batch of UVs at a
+// time. Returning false makes every lane take the op's default, as
+// sampleMatTex() does for an unresolved texture.
+class MatCPUTextureSource {
+public:
+  virtual ~MatCPUTextureSource() = default;
+  virtual bool sample(uint32_t tex, const float *u, const float *v,
+                      uint32_t count, glm::vec4 *out) const = 0;
+};
+
+// RGBA8 images by TextureTable index, bilinear with repeat wrap (the
+// material sampler state), no mips.
+class MatCPUImageTextures final : public MatCPUTextureSource {
+public:
+  void set(uint32_t tex, uint32_t width, uint32_t height,
+           std::vector<uint8_t> rgba8);
+  void clear() { m_images.clear(); }
+
+  bool sample(uint32_t tex, const float *u, const float *v, uint32_t count,
+              glm::vec4 *out) const override;
+
+private:
+  struct Image final {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> rgba8;
+  };
+  std::unordered_map<uint32_t, Image> m_images;
+};
+
+// Instruction-set width of the interpreter: Scalar runs 4 lanes in plain
+// C++, SSE 4 lanes, AVX2 8 lanes. All three produce bit-identical results
+// (no FMA, exact div/sqrt; pow goes through std::pow per lane).
+enum class MatCPUPath : uint8_t { Scalar = 0, SSE, AVX2 };
+
+const char *matCPUPathName(MatCPUPath path);
+bool matCPUPathSupported(MatCPUPath path); // compiled in and CPU has it
+MatCPUPath matCPUBestPath();
+
+// CPU port of evalMaterial() in MaterialCommon.glsl, op for op, evaluated
+// over `count` samples. Returns false (and leaves `out` alone) for graphs
+// without nodes or with registers beyond kMatVM_MaxRegs. Unsupported paths
+// fall back to the best supported one.
+bool evalMaterialCPU(const CompiledMaterialGraph &g, const MatCPUSample *in,
+                     MatCPUSurface *out, uint32_t count,
+                     const MatCPUTextureSource *textures = nullptr,
+                     MatCPUPath path = matCPUBestPath());
+
+// Headless material ball: a `size` x `size` sphere under a fixed key light,
+// tonemapped to sRGB RGBA8 (top row first, transparent background). Returns
+// false if the graph cannot be evaluated.
+bool renderMaterialThumbnailCPU(const CompiledMaterialGraph &g, uint32_t size,
+                                std::vector<uint8_t> &rgba8,
+                                const MatCPUTextureSource *textures = nullptr);
+
+} // namespace Nyx
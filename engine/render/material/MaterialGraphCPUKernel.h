@@ -0,0 +1,381 @@
+#pragma once
+
+// Shared by MaterialGraphCPU.cpp (Scalar, SSE) and MaterialGraphCPU_AVX2.cpp,
+// which is built with AVX2 enabled. Everything instantiated per path lives in
+// an anonymous namespace so no AVX2-compiled inline function can be picked up
+// by the other translation unit; the lane helpers are defined out of line in
+// MaterialGraphCPU.cpp for the same reason.
+
+#include "MaterialGraphCPU.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace Nyx::MatCPU {
+
+struct Job final {
+  const GpuMatNode *nodes = nullptr;
+  uint32_t nodeCount = 0;
+  GpuMatGraphHeader header{};
+  bool needsTBN = false;
+  const MatCPUSample *in = nullptr;
+  MatCPUSurface *out = nullptr;
+  uint32_t count = 0;
+  const MatCPUTextureSource *textures = nullptr;
+};
+
+// x[i] = pow(x[i], y[i]).
+void powLanes(float *x, const float *y, uint32_t n);
+// Samples `tex` into SoA rgba (rgba + c * n), `def` where unavailable.
+void sampleLanes(const MatCPUTextureSource *src, uint32_t tex, const float *u,
+                 const float *v, uint32_t n, const float def[4], float *rgba);
+
+void runScalar(const Job &job);
+void runSSE(const Job &job);
+void runAVX2(const Job &job);
+
+namespace {
+
+// P is a pack of W floats with load/store/set1/add/sub/mul/div/min/max/sqrt.
+// Each op runs over a block of B packs, so the switch is paid once per
+// L = W * B pixels rather than once per pack.
+template <class P> class Kernel final {
+public:
+  using F = typename P::F;
+  static constexpr uint32_t W = P::W;
+  static constexpr uint32_t B = 4;
+  static constexpr uint32_t L = W * B;
+
+  explicit Kernel(const Job &job)
+      : m_job(job), m_regs(std::make_unique<Regs>()) {}
+
+  void run() {
+    for (uint32_t base = 0; base < m_job.count; base += L) {
+      const uint32_t n = (m_job.count - base < L) ? m_job.count - base : L;
+      loadInputs(base, n);
+      for (uint32_t i = 0; i < m_job.nodeCount; ++i)
+        exec(m_job.nodes[i]);
+      storeOutputs(base, n);
+    }
+  }
+
+private:
+  // B packs of component c of register reg.
+  F *r(uint32_t reg, uint32_t c) { return &m_regs->v[(reg * 4 + c) * B]; }
+
+  static F clamp01(F x) {
+    return P::min(P::max(x, P::set1(0.0f)), P::set1(1.0f));
+  }
+
+  static F mix(F x, F y, F t) {
+    return P::add(P::mul(x, P::sub(P::set1(1.0f), t)), P::mul(y, t));
+  }
+
+  static void normalize3(F &x, F &y, F &z) {
+    const F len = P::sqrt(
+        P::add(P::add(P::mul(x, x), P::mul(y, y)), P::mul(z, z)));
+    const F inv = P::div(P::set1(1.0f), len);
+    x = P::mul(x, inv);
+    y = P::mul(y, inv);
+    z = P::mul(z, inv);
+  }
+
+  template <class Fn> void unary(const GpuMatNode &n, Fn fn) {
+    for (uint32_t c = 0; c < 4; ++c) {
+      F *d = r(n.dst, c);
+      const F *a = r(n.a, c);
+      for (uint32_t k = 0; k < B; ++k)
+        d[k] = fn(a[k]);
+    }
+  }
+
+  template <class Fn> void binary(const GpuMatNode &n, Fn fn) {
+    for (uint32_t c = 0; c < 4; ++c) {
+      F *d = r(n.dst, c);
+      const F *a = r(n.a, c);
+      const F *b = r(n.b, c);
+      for (uint32_t k = 0; k < B; ++k)
+        d[k] = fn(a[k], b[k]);
+    }
+  }
+
+  // Lanes past the end repeat the last sample so every op sees valid input.
+  void loadInputs(uint32_t base, uint32_t n) {
+    alignas(32) float in[12][L];
+    for (uint32_t l = 0; l < L; ++l) {
+      const MatCPUSample &s = m_job.in[base + (l < n ? l : n - 1)];
+      const float v[12] = {s.uv.x,      s.uv.y,      s.normal.x,  s.normal.y,
+                           s.normal.z,  s.viewDir.x, s.viewDir.y, s.viewDir.z,
+                           s.tangent.x, s.tangent.y, s.tangent.z, s.tangent.w};
+      for (uint32_t k = 0; k < 12; ++k)
+        in[k][l] = v[k];
+    }
+    const F zero = P::set1(0.0f);
+
+    for (uint32_t k = 0; k < B; ++k) {
+      const uint32_t o = k * W;
+      r(0, 0)[k] = P::load(in[0] + o);
+      r(0, 1)[k] = P::load(in[1] + o);
+      r(0, 2)[k] = zero;
+      r(0, 3)[k] = zero;
+
+      F nx = P::load(in[2] + o), ny = P::load(in[3] + o),
+        nz = P::load(in[4] + o);
+      normalize3(nx, ny, nz);
+      r(1, 0)[k] = nx;
+      r(1, 1)[k] = ny;
+      r(1, 2)[k] = nz;
+      r(1, 3)[k] = zero;
+
+      F vx = P::load(in[5] + o), vy = P::load(in[6] + o),
+        vz = P::load(in[7] + o);
+      normalize3(vx, vy, vz);
+      r(2, 0)[k] = vx;
+      r(2, 1)[k] = vy;
+      r(2, 2)[k] = vz;
+      r(2, 3)[k] = zero;
+
+      if (!m_job.needsTBN)
+        continue;
+      F tx = P::load(in[8] + o), ty = P::load(in[9] + o),
+        tz = P::load(in[10] + o);
+      normalize3(tx, ty, tz);
+      const F sign = P::load(in[11] + o);
+      // B = cross(N, T) * w
+      F *m = m_tbn[k];
+      m[0] = tx;
+      m[1] = ty;
+      m[2] = tz;
+      m[3] = P::mul(P::sub(P::mul(ny, tz), P::mul(nz, ty)), sign);
+      m[4] = P::mul(P::sub(P::mul(nz, tx), P::mul(nx, tz)), sign);
+      m[5] = P::mul(P::sub(P::mul(nx, ty), P::mul(ny, tx)), sign);
+      m[6] = nx;
+      m[7] = ny;
+      m[8] = nz;
+    }
+  }
+
+  void storeOutputs(uint32_t base, uint32_t n) {
+    const GpuMatGraphHeader &h = m_job.header;
+    alignas(32) float o[13][L];
+    for (uint32_t k = 0; k < B; ++k) {
+      F nx = r(h.outNormalWS, 0)[k], ny = r(h.outNormalWS, 1)[k],
+        nz = r(h.outNormalWS, 2)[k];
+      normalize3(nx, ny, nz);
+      const F src[13] = {
+          r(h.outBaseColor, 0)[k], r(h.outBaseColor, 1)[k],
+          r(h.outBaseColor, 2)[k], r(h.outMR, 0)[k],
+          r(h.outMR, 1)[k],        r(h.outMR, 2)[k],
+          r(h.outEmissive, 0)[k],  r(h.outEmissive, 1)[k],
+          r(h.outEmissive, 2)[k],  nx,
+          ny,                      nz,
+          r(h.outAlpha, 0)[k]};
+      for (uint32_t i = 0; i < 13; ++i)
+        P::store(o[i] + k * W, src[i]);
+    }
+
+    for (uint32_t l = 0; l < n; ++l) {
+      // Member stores only: no glm function may be emitted in the AVX2
+      // translation unit.
+      MatCPUSurface &s = m_job.out[base + l];
+      s.baseColor.x = o[0][l];
+      s.baseColor.y = o[1][l];
+      s.baseColor.z = o[2][l];
+      s.metallic = o[3][l];
+      s.roughness = o[4][l];
+      s.ao = o[5][l];
+      s.emissive.x = o[6][l];
+      s.emissive.y = o[7][l];
+      s.emissive.z = o[8][l];
+      s.normalWS.x = o[9][l];
+      s.normalWS.y = o[10][l];
+      s.normalWS.z = o[11][l];
+      s.alpha = o[12][l];
+    }
+  }
+
+  // Samples n.extra at r(a).xy into out (SoA, L lanes per component).
+  void sample(const GpuMatNode &n, const float def[4], float *out) {
+    alignas(32) float u[L], v[L];
+    for (uint32_t k = 0; k < B; ++k) {
+      P::store(u + k * W, r(n.a, 0)[k]);
+      P::store(v + k * W, r(n.a, 1)[k]);
+    }
+    sampleLanes(m_job.textures, n.extra, u, v, L, def, out);
+  }
+
+  // Mirrors the op chain in evalMaterial(). Sources are read before dst is
+  // written wherever components cross, since the register allocator may
+  // give dst the register of an operand that dies at this op.
+  void exec(const GpuMatNode &n) {
+    const uint32_t d = n.dst;
+    const F zero = P::set1(0.0f);
+    switch (static_cast<MatOp>(n.op)) {
+    case MatOp::Const4: {
+      const uint32_t bits[4] = {n.a, n.b, n.c, n.extra};
+      for (uint32_t c = 0; c < 4; ++c) {
+        float f;
+        std::memcpy(&f, &bits[c], sizeof(f));
+        const F v = P::set1(f);
+        for (uint32_t k = 0; k < B; ++k)
+          r(d, c)[k] = v;
+      }
+      break;
+    }
+    case MatOp::Swizzle: {
+      uint32_t sel[4];
+      for (uint32_t c = 0; c < 4; ++c) {
+        const uint32_t ix = (n.extra >> (8 * c)) & 0xFFu;
+        sel[c] = ix < 3 ? ix : 3;
+      }
+      for (uint32_t k = 0; k < B; ++k) {
+        const F v[4] = {r(n.a, 0)[k], r(n.a, 1)[k], r(n.a, 2)[k],
+                        r(n.a, 3)[k]};
+        for (uint32_t c = 0; c < 4; ++c)
+          r(d, c)[k] = v[sel[c]];
+      }
+      break;
+    }
+    case MatOp::Append:
+      for (uint32_t k = 0; k < B; ++k) {
+        const F x = r(n.a, 0)[k], y = r(n.b, 0)[k], z = r(n.c, 0)[k];
+        r(d, 0)[k] = x;
+        r(d, 1)[k] = y;
+        r(d, 2)[k] = z;
+        r(d, 3)[k] = zero;
+      }
+      break;
+    case MatOp::Add:
+      binary(n, [](F a, F b) { return P::add(a, b); });
+      break;
+    case MatOp::Sub:
+      binary(n, [](F a, F b) { return P::sub(a, b); });
+      break;
+    case MatOp::Mul:
+      binary(n, [](F a, F b) { return P::mul(a, b); });
+      break;
+    case MatOp::Div:
+      binary(n, [](F a, F b) { return P::div(a, P::max(b, P::set1(1e-6f))); });
+      break;
+    case MatOp::Min:
+      binary(n, [](F a, F b) { return P::min(a, b); });
+      break;
+    case MatOp::Max:
+      binary(n, [](F a, F b) { return P::max(a, b); });
+      break;
+    case MatOp::Clamp01:
+      unary(n, [](F a) { return clamp01(a); });
+      break;
+    case MatOp::OneMinus:
+      unary(n, [](F a) { return P::sub(P::set1(1.0f), a); });
+      break;
+    case MatOp::Lerp:
+      for (uint32_t c = 0; c < 4; ++c) {
+        F *dc = r(d, c);
+        const F *a = r(n.a, c), *b = r(n.b, c), *t = r(n.c, c);
+        for (uint32_t k = 0; k < B; ++k)
+          dc[k] = mix(a[k], b[k], clamp01(t[k]));
+      }
+      break;
+    case MatOp::Pow:
+      for (uint32_t c = 0; c < 4; ++c) {
+        alignas(32) float x[L], y[L];
+        for (uint32_t k = 0; k < B; ++k) {
+          P::store(x + k * W, P::max(r(n.a, c)[k], zero));
+          P::store(y + k * W, P::max(r(n.b, c)[k], P::set1(1e-6f)));
+        }
+        powLanes(x, y, L);
+        for (uint32_t k = 0; k < B; ++k)
+          r(d, c)[k] = P::load(x + k * W);
+      }
+      break;
+    case MatOp::Dot3:
+      for (uint32_t k = 0; k < B; ++k) {
+        const F dot = P::add(P::add(P::mul(r(n.a, 0)[k], r(n.b, 0)[k]),
+                                    P::mul(r(n.a, 1)[k], r(n.b, 1)[k])),
+                             P::mul(r(n.a, 2)[k], r(n.b, 2)[k]));
+        for (uint32_t c = 0; c < 4; ++c)
+          r(d, c)[k] = dot;
+      }
+      break;
+    case MatOp::Normalize3:
+      for (uint32_t k = 0; k < B; ++k) {
+        F x = r(n.a, 0)[k], y = r(n.a, 1)[k], z = r(n.a, 2)[k];
+        normalize3(x, y, z);
+        r(d, 0)[k] = x;
+        r(d, 1)[k] = y;
+        r(d, 2)[k] = z;
+        r(d, 3)[k] = zero;
+      }
+      break;
+    case MatOp::Tex2D:
+    case MatOp::Tex2D_SRGB:
+    case MatOp::Tex2D_MRA: {
+      static constexpr float kDef[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+      alignas(32) float s[4 * L];
+      sample(n, kDef, s);
+      const MatOp op = static_cast<MatOp>(n.op);
+      if (op == MatOp::Tex2D_SRGB) {
+        alignas(32) float e[3 * L];
+        for (float &x : e)
+          x = 2.2f;
+        powLanes(s, e, 3 * L);
+      }
+      for (uint32_t k = 0; k < B; ++k) {
+        for (uint32_t c = 0; c < 3; ++c)
+          r(d, c)[k] = P::load(s + c * L + k * W);
+        r(d, 3)[k] = (op == MatOp::Tex2D_MRA) ? P::set1(1.0f)
+                                               : P::load(s + 3 * L + k * W);
+      }
+      break;
+    }
+    case MatOp::NormalMapTS: {
+      static constexpr float kDef[4] = {0.5f, 0.5f, 1.0f, 1.0f};
+      alignas(32) float s[4 * L];
+      sample(n, kDef, s);
+      const F one = P::set1(1.0f), two = P::set1(2.0f);
+      for (uint32_t k = 0; k < B; ++k) {
+        const F strength = r(n.b, 0)[k];
+        F x = P::sub(P::mul(P::load(s + 0 * L + k * W), two), one);
+        F y = P::sub(P::mul(P::load(s + 1 * L + k * W), two), one);
+        F z = P::sub(P::mul(P::load(s + 2 * L + k * W), two), one);
+        normalize3(x, y, z);
+        const F t = P::min(P::max(strength, zero), P::set1(4.0f));
+        x = mix(zero, x, t);
+        y = mix(zero, y, t);
+        z = mix(one, z, t);
+        normalize3(x, y, z);
+        const F *m = m_tbn[k];
+        F wx =
+            P::add(P::add(P::mul(m[0], x), P::mul(m[3], y)), P::mul(m[6], z));
+        F wy =
+            P::add(P::add(P::mul(m[1], x), P::mul(m[4], y)), P::mul(m[7], z));
+        F wz =
+            P::add(P::add(P::mul(m[2], x), P::mul(m[5], y)), P::mul(m[8], z));
+        normalize3(wx, wy, wz);
+        r(d, 0)[k] = wx;
+        r(d, 1)[k] = wy;
+        r(d, 2)[k] = wz;
+        r(d, 3)[k] = zero;
+      }
+      break;
+    }
+    default:
+      break; // OutputSurface: outputs come from the header
+    }
+  }
+
+  // (reg * 4 + component) * B + pack; 64 KiB at 8 lanes, so on the heap.
+  struct Regs final {
+    F v[kMatVM_MaxRegs * 4 * B];
+  };
+
+  const Job &m_job;
+  std::unique_ptr<Regs> m_regs;
+  F m_tbn[B][9]{};             // columns T, B, N per pack
+};
+
+} // namespace
+
+} // namespace Nyx::MatCPU
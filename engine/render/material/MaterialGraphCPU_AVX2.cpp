@@ -0,0 +1,36 @@
+// 8-lane path of the CPU material VM. CMake builds this file alone with AVX2
+// enabled (and defines NYX_MATCPU_AVX2); evalMaterialCPU() only calls it
+// after checking the CPU.
+
+#include "MaterialGraphCPUKernel.h"
+
+#if defined(NYX_MATCPU_AVX2) && defined(__AVX2__)
+#include <immintrin.h>
+
+namespace Nyx::MatCPU {
+
+namespace {
+
+struct PackAVX2 final {
+  static constexpr uint32_t W = 8;
+  using F = __m256;
+
+  static F load(const float *p) { return _mm256_loadu_ps(p); }
+  static void store(float *p, F a) { _mm256_storeu_ps(p, a); }
+  static F set1(float x) { return _mm256_set1_ps(x); }
+  static F add(F a, F b) { return _mm256_add_ps(a, b); }
+  static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+  static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+  static F div(F a, F b) { return _mm256_div_ps(a, b); }
+  static F min(F a, F b) { return _mm256_min_ps(b, a); }
+  static F max(F a, F b) { return _mm256_max_ps(b, a); }
+  static F sqrt(F a) { return _mm256_sqrt_ps(a); }
+};
+
+} // namespace
+
+void runAVX2(const Job &job) { Kernel<PackAVX2>(job).run(); }
+
+} // namespace Nyx::MatCPU
+
+#endif
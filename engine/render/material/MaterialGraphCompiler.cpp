@@ -8,6 +8,30 @@
 
 namespace Nyx {
 
+static uint64_t hashProgram(const CompiledMaterialGraph &g) {
+  uint64_t h = 14695981039346656037ULL;
+  auto mix = [&](uint32_t v) {
+    h ^= v;
+    h *= 1099511628211ULL;
+  };
+  for (const GpuMatNode &n : g.nodes) {
+    mix(n.op);
+    mix(n.dst);
+    mix(n.a);
+    mix(n.b);
+    mix(n.c);
+    mix(n.extra);
+  }
+  const GpuMatGraphHeader &hd = g.header;
+  for (uint32_t v : {hd.nodeCount, hd.outBaseColor, hd.outMR, hd.outNormalWS,
+                     hd.outEmissive, hd.outAlpha, hd.alphaMode})
+    mix(v);
+  uint32_t cutoff = 0;
+  std::memcpy(&cutoff, &hd.alphaCutoff, sizeof(cutoff));
+  mix(cutoff);
+  return h;
+}
+
 void MaterialGraphCompiler::setError(MatCompilerError *err, const char *msg) {
   if (err)
     err->msg = msg ? msg : "MaterialGraphCompiler error";
@@ -18,13 +42,8 @@ const MatNode *MaterialGraphCompiler::findNode(MatNodeID id) const {
   return (it != m_nodes.end()) ? it->second : nullptr;
 }
 
-uint32_t MaterialGraphCompiler::allocReg() {
-  uint32_t r = m_nextReg++;
-  if (m_nextReg >= kMatVM_MaxRegs) {
-    // clamp; caller will error
-  }
-  return r;
-}
+// Virtual register; the VM limit is checked after optimization.
+uint32_t MaterialGraphCompiler::allocReg() { return m_nextReg++; }
 
 uint32_t MaterialGraphCompiler::ensureInputReg(const MatNode &node,
                                                uint32_t inputSlot,
@@ -49,10 +68,6 @@ uint32_t MaterialGraphCompiler::ensureInputReg(const MatNode &node,
 
   // Not connected: emit const4 into new reg
   uint32_t dst = allocReg();
-  if (dst >= kMatVM_MaxRegs) {
-    setError(err, "Too many registers needed");
-    return 0;
-  }
 
   GpuMatNode cn{};
   cn.op = static_cast<uint32_t>(MatOp::Const4);
@@ -117,14 +132,7 @@ uint32_t MaterialGraphCompiler::compileNode(const MatNode &n, uint32_t outSlot,
   };
 
   // Node compilation
-  auto allocDst = [&]() -> uint32_t {
-    uint32_t r = allocReg();
-    if (r >= kMatVM_MaxRegs) {
-      setError(err, "Material VM: out of registers");
-      return 0;
-    }
-    return r;
-  };
+  auto allocDst = [&]() -> uint32_t { return allocReg(); };
 
   switch (n.type) {
   // Builtins
@@ -294,8 +302,8 @@ uint32_t MaterialGraphCompiler::compileNode(const MatNode &n, uint32_t outSlot,
   case MatNodeType::Split: {
     if (outSlot > 3)
       outSlot = 0;
-    if (info.outReg[outSlot] != 0u)
-      return info.outReg[outSlot];
+    if (info.outReg[outSlot] != 0xFFFFFFFFu)
+      return info.outReg[outSlot]; // remapped slot may already be built
     uint32_t dst = allocDst();
     uint32_t a = ensureInputReg(n, 0, 0, def0, prog, err);
     const uint32_t mask =
@@ -383,6 +391,9 @@ bool MaterialGraphCompiler::compile(const MaterialGraph &g,
                                     CompiledMaterialGraph &out,
                                     MatCompilerError *err) {
   out = {};
+  MatCompilerError localErr{};
+  if (!err)
+    err = &localErr;
 
   m_nodes.clear();
   m_incoming.clear();
@@ -423,13 +434,6 @@ bool MaterialGraphCompiler::compile(const MaterialGraph &g,
 
   if (!err->msg.empty())
     return false;
-  if (m_nextReg >= kMatVM_MaxRegs) {
-    setError(err, "Material VM: exceeded max regs");
-    return false;
-  }
-  if (prog.size() >= kMatVM_MaxNodes) {
-    setError(err, "Material VM: exceeded max nodes");
-  }
 
   uint32_t base = 0, metal = 0, rough = 0, normal = 1, ao = 0, emis = 0,
            alpha = 0;
@@ -467,10 +471,6 @@ bool MaterialGraphCompiler::compile(const MaterialGraph &g,
 
   out.header.outBaseColor = base;
   uint32_t mrReg = allocReg();
-  if (mrReg >= kMatVM_MaxRegs) {
-    setError(err, "Material VM: out of regs (MR)");
-    return false;
-  }
   {
     // Use Append with a=metalReg b=roughReg c=aoReg extra unused
     GpuMatNode an{};
@@ -491,10 +491,26 @@ bool MaterialGraphCompiler::compile(const MaterialGraph &g,
   out.header.alphaMode = static_cast<uint32_t>(g.alphaMode);
   out.header.alphaCutoff = g.alphaCutoff;
 
+  if (m_optimize) {
+    optimizeMaterialProgram(prog, out.header, out.stats);
+  } else {
+    out.stats.opsBefore = out.stats.opsAfter = uint32_t(prog.size());
+    out.stats.regsBefore = out.stats.regsAfter = m_nextReg;
+  }
+  if (out.stats.regsAfter > kMatVM_MaxRegs) {
+    setError(err, "Material VM: exceeded max regs");
+    return false;
+  }
+  if (prog.size() > kMatVM_MaxNodes) {
+    setError(err, "Material VM: exceeded max nodes");
+    return false;
+  }
+
   out.header.nodeOffset = 0;
   out.header.nodeCount = prog.size();
 
   out.nodes = std::move(prog);
+  out.hash = hashProgram(out);
   return true;
 }
 
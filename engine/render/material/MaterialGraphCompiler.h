@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MaterialGraph.h"
+#include "MaterialGraphOptimizer.h"
 #include "MaterialGraphVM.h"
 
 #include <cstdint>
@@ -15,6 +16,10 @@ namespace Nyx {
 struct CompiledMaterialGraph final {
   GpuMatGraphHeader header{};
   std::vector<GpuMatNode> nodes; // linear VM program
+  MatOptStats stats{};
+  // FNV-1a of the program and header (offset excluded); equal hashes mean
+  // interchangeable code, e.g. for specialized shader variants.
+  uint64_t hash = 0;
 };
 
 struct MatCompilerError final {
@@ -27,9 +32,14 @@ public:
   // - Produces linear nodes with register assignment.
   // - NormalMap outputs WORLD normal (uses TBN)
   // - OutputSurface writes header output regs
+  // - Emission uses one register per value; optimizeMaterialProgram() then
+  //   folds, merges, strips dead ops and packs registers (unless disabled).
   bool compile(const MaterialGraph &g, CompiledMaterialGraph &out,
                MatCompilerError *err = nullptr);
 
+  // Off: emit the naive program, e.g. to compare against optimized output.
+  void setOptimize(bool enabled) { m_optimize = enabled; }
+
 private:
   struct NodeInfo {
     glm::uvec4 outReg{0}; // for multi-outputs if needed
@@ -57,6 +67,7 @@ private:
   std::unordered_map<MatNodeID, NodeInfo> m_info;
 
   uint32_t m_nextReg = 0;
+  bool m_optimize = true;
   bool m_outSet = false;
   uint32_t m_outBase = 0;
   uint32_t m_outMetal = 0;
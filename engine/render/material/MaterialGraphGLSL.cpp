@@ -0,0 +1,212 @@
+#include "MaterialGraphGLSL.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <spdlog/fmt/fmt.h>
+
+namespace Nyx {
+
+namespace {
+
+std::string floatLiteral(float v) {
+  if (!std::isfinite(v)) {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return fmt::format("uintBitsToFloat(0x{:08x}u)", bits);
+  }
+  // Shortest round-trip form, so the literal is exactly the VM constant.
+  std::string s = fmt::format("{}", v);
+  if (s.find_first_of(".e") == std::string::npos)
+    s += ".0";
+  return s;
+}
+
+std::string reg(uint32_t r) { return fmt::format("r{}", r); }
+
+// Builtin registers are initialized up front (compiler contract).
+std::string builtinInit(uint32_t r) {
+  switch (r) {
+  case 0:
+    return "vec4(MAT_UV0, 0, 0)";
+  case 1:
+    return "vec4(normalize(f.nrmW), 0)";
+  default:
+    return "vec4(normalize(f.viewDirW), 0)";
+  }
+}
+
+void emitOp(std::string &s, const GpuMatNode &n) {
+  const std::string d = reg(n.dst);
+  const std::string a = reg(n.a);
+  const std::string b = reg(n.b);
+  const std::string c = reg(n.c);
+
+  switch (static_cast<MatOp>(n.op)) {
+  case MatOp::Const4: {
+    float v[4];
+    const uint32_t bits[4] = {n.a, n.b, n.c, n.extra};
+    std::memcpy(v, bits, sizeof(v));
+    s += fmt::format("  {} = vec4({}, {}, {}, {});\n", d, floatLiteral(v[0]),
+                     floatLiteral(v[1]), floatLiteral(v[2]), floatLiteral(v[3]));
+    break;
+  }
+  case MatOp::Swizzle: {
+    static constexpr char kComp[] = "xyzw";
+    char sw[5] = {};
+    for (int i = 0; i < 4; ++i) {
+      const uint32_t ix = (n.extra >> (8 * i)) & 0xFFu;
+      sw[i] = kComp[ix < 3 ? ix : 3];
+    }
+    s += fmt::format("  {} = {}.{};\n", d, a, sw);
+    break;
+  }
+  case MatOp::Append:
+    s += fmt::format("  {} = vec4({}.x, {}.x, {}.x, 0);\n", d, a, b, c);
+    break;
+  case MatOp::Add:
+    s += fmt::format("  {} = {} + {};\n", d, a, b);
+    break;
+  case MatOp::Sub:
+    s += fmt::format("  {} = {} - {};\n", d, a, b);
+    break;
+  case MatOp::Mul:
+    s += fmt::format("  {} = {} * {};\n", d, a, b);
+    break;
+  case MatOp::Div:
+    s += fmt::format("  {} = {} / max({}, vec4(1e-6));\n", d, a, b);
+    break;
+  case MatOp::Min:
+    s += fmt::format("  {} = min({}, {});\n", d, a, b);
+    break;
+  case MatOp::Max:
+    s += fmt::format("  {} = max({}, {});\n", d, a, b);
+    break;
+  case MatOp::Clamp01:
+    s += fmt::format("  {} = clamp({}, vec4(0), vec4(1));\n", d, a);
+    break;
+  case MatOp::OneMinus:
+    s += fmt::format("  {} = vec4(1) - {};\n", d, a);
+    break;
+  case MatOp::Lerp:
+    s += fmt::format("  {} = mix({}, {}, clamp({}, vec4(0), vec4(1)));\n", d,
+                     a, b, c);
+    break;
+  case MatOp::Pow:
+    s += fmt::format("  {} = pow(max({}, vec4(0)), max({}, vec4(1e-6)));\n", d,
+                     a, b);
+    break;
+  case MatOp::Dot3:
+    s += fmt::format("  {} = vec4(dot({}.xyz, {}.xyz));\n", d, a, b);
+    break;
+  case MatOp::Normalize3:
+    s += fmt::format("  {} = vec4(normalize({}.xyz), 0);\n", d, a);
+    break;
+  case MatOp::Tex2D:
+    s += fmt::format("  {} = sampleMatTex({}u, {}.xy, vec4(1.0));\n", d,
+                     n.extra, a);
+    break;
+  case MatOp::Tex2D_SRGB:
+    s += fmt::format("  {} = sampleMatTex({}u, {}.xy, vec4(1.0));\n", d,
+                     n.extra, a);
+    s += fmt::format("  {0}.rgb = srgbToLinear({0}.rgb);\n", d);
+    break;
+  case MatOp::Tex2D_MRA:
+    s += fmt::format(
+        "  {} = vec4(sampleMatTex({}u, {}.xy, vec4(1.0)).rgb, 1.0);\n", d,
+        n.extra, a);
+    break;
+  case MatOp::NormalMapTS:
+    s += "  {\n";
+    s += fmt::format("    vec3 ns = decodeNormalTS(sampleMatTex({}u, {}.xy, "
+                     "vec4(0.5, 0.5, 1.0, 1.0)).xyz);\n",
+                     n.extra, a);
+    s += fmt::format("    ns = normalize(mix(vec3(0, 0, 1), ns, "
+                     "clamp({}.x, 0.0, 4.0)));\n",
+                     b);
+    s += fmt::format("    {} = vec4(normalize(TBN * ns), 0);\n", d);
+    s += "  }\n";
+    break;
+  default:
+    break; // OutputSurface: outputs come from the header
+  }
+}
+
+} // namespace
+
+std::string generateMaterialGLSL(const CompiledMaterialGraph &g) {
+  const GpuMatGraphHeader &h = g.header;
+
+  uint32_t regCount = 3;
+  bool needsTBN = false;
+  for (const GpuMatNode &n : g.nodes) {
+    if (static_cast<MatOp>(n.op) == MatOp::OutputSurface)
+      continue;
+    regCount = std::max(regCount, n.dst + 1);
+    needsTBN = needsTBN || static_cast<MatOp>(n.op) == MatOp::NormalMapTS;
+  }
+  for (uint32_t r : {h.outBaseColor, h.outMR, h.outNormalWS, h.outEmissive,
+                     h.outAlpha})
+    regCount = std::max(regCount, r + 1);
+
+  std::string s;
+  s.reserve(256 + g.nodes.size() * 48);
+  s += fmt::format("// Material graph {:016x}, generated by "
+                   "MaterialGraphGLSL. Do not edit.\n",
+                   g.hash);
+  s += fmt::format(
+      "void {}(out vec3 baseColor, out float metallic, out float roughness,\n"
+      "    out float ao, out vec3 emissive, out vec3 normalWS,\n"
+      "    out float alpha, out uint alphaMode, out float alphaCutoff) {{\n",
+      kMaterialSpecializedFn);
+  s += fmt::format("  alphaMode = {}u;\n", h.alphaMode);
+  s += fmt::format("  alphaCutoff = {};\n", floatLiteral(h.alphaCutoff));
+
+  for (uint32_t r = 0; r < regCount; ++r) {
+    if (r < 3)
+      s += fmt::format("  vec4 {} = {};\n", reg(r), builtinInit(r));
+    else
+      s += fmt::format("  vec4 {} = vec4(0);\n", reg(r));
+  }
+  if (needsTBN) {
+    s += "  vec3 T = normalize(f.tanW.xyz);\n"
+         "  vec3 Nw = normalize(f.nrmW);\n"
+         "  vec3 B = cross(Nw, T) * f.tanW.w;\n"
+         "  mat3 TBN = mat3(T, B, Nw);\n";
+  }
+
+  for (const GpuMatNode &n : g.nodes)
+    emitOp(s, n);
+
+  s += fmt::format("  baseColor = {}.xyz;\n", reg(h.outBaseColor));
+  s += fmt::format("  metallic = {}.x;\n", reg(h.outMR));
+  s += fmt::format("  roughness = {}.y;\n", reg(h.outMR));
+  s += fmt::format("  ao = {}.z;\n", reg(h.outMR));
+  s += fmt::format("  emissive = {}.xyz;\n", reg(h.outEmissive));
+  s += fmt::format("  normalWS = normalize({}.xyz);\n", reg(h.outNormalWS));
+  s += fmt::format("  alpha = {}.x;\n", reg(h.outAlpha));
+  s += "}\n";
+  return s;
+}
+
+std::string specializeForwardSource(const std::string &expandedFrag,
+                                    const std::string &materialGLSL) {
+  const size_t version = expandedFrag.find("#version");
+  if (version == std::string::npos)
+    return {};
+  const size_t eol = expandedFrag.find('\n', version);
+  if (eol == std::string::npos)
+    return {};
+
+  std::string s;
+  s.reserve(expandedFrag.size() + materialGLSL.size() + 64);
+  s.append(expandedFrag, 0, eol + 1);
+  s += fmt::format("#define {} 1\n", kMaterialSpecializedDefine);
+  s += "#line 2\n";
+  s.append(expandedFrag, eol + 1);
+  s += "\n#line 1\n";
+  s += materialGLSL;
+  return s;
+}
+
+} // namespace Nyx
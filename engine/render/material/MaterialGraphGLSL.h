@@ -0,0 +1,31 @@
+#pragma once
+
+#include "MaterialGraphCompiler.h"
+
+#include <string>
+
+namespace Nyx {
+
+// Name of the function generateMaterialGLSL() defines; its signature matches
+// evalMaterial() in MaterialCommon.glsl.
+inline constexpr const char *kMaterialSpecializedFn = "evalMaterialSpecialized";
+
+// Defined in specialized forward_mrt.frag variants, which call the generated
+// function instead of running the VM.
+inline constexpr const char *kMaterialSpecializedDefine =
+    "NYX_MATERIAL_SPECIALIZED";
+
+// Translates a compiled VM program into one straight-line GLSL function with
+// the same per-op semantics as the interpreter loop in MaterialCommon.glsl.
+// Registers become locals, constants and texture indices become literals.
+// Output depends only on `g`, so equal graphs produce identical text.
+std::string generateMaterialGLSL(const CompiledMaterialGraph &g);
+
+// Specializes an expanded forward_mrt.frag: defines
+// kMaterialSpecializedDefine right after #version and appends the generated
+// function (the shader declares its prototype). Returns an empty string if
+// `expandedFrag` has no #version line.
+std::string specializeForwardSource(const std::string &expandedFrag,
+                                    const std::string &materialGLSL);
+
+} // namespace Nyx
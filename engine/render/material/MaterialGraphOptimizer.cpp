@@ -0,0 +1,393 @@
+#include "MaterialGraphOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+namespace Nyx {
+
+namespace {
+
+constexpr uint32_t kBuiltinRegs = 3; // UV0, NormalWS, ViewDirWS
+constexpr uint32_t kNoReg = 0xFFFFFFFFu;
+constexpr uint32_t kLiveToEnd = 0xFFFFFFFFu;
+
+enum : uint32_t { kUseA = 1u, kUseB = 2u, kUseC = 4u };
+
+// Which of a/b/c are register operands; must match MaterialCommon.glsl.
+uint32_t regOperands(MatOp op) {
+  switch (op) {
+  case MatOp::Swizzle:
+  case MatOp::Clamp01:
+  case MatOp::OneMinus:
+  case MatOp::Normalize3:
+  case MatOp::Tex2D:
+  case MatOp::Tex2D_SRGB:
+  case MatOp::Tex2D_MRA:
+    return kUseA;
+  case MatOp::Add:
+  case MatOp::Sub:
+  case MatOp::Mul:
+  case MatOp::Div:
+  case MatOp::Min:
+  case MatOp::Max:
+  case MatOp::Pow:
+  case MatOp::Dot3:
+  case MatOp::NormalMapTS:
+    return kUseA | kUseB;
+  case MatOp::Append:
+  case MatOp::Lerp:
+    return kUseA | kUseB | kUseC;
+  default:
+    return 0;
+  }
+}
+
+template <class F> void forEachOperand(GpuMatNode &n, F &&f) {
+  const uint32_t uses = regOperands(static_cast<MatOp>(n.op));
+  if (uses & kUseA)
+    f(n.a);
+  if (uses & kUseB)
+    f(n.b);
+  if (uses & kUseC)
+    f(n.c);
+}
+
+bool isTextureOp(MatOp op) {
+  return op == MatOp::Tex2D || op == MatOp::Tex2D_SRGB ||
+         op == MatOp::Tex2D_MRA || op == MatOp::NormalMapTS;
+}
+
+bool isCommutative(MatOp op) {
+  return op == MatOp::Add || op == MatOp::Mul || op == MatOp::Min ||
+         op == MatOp::Max;
+}
+
+glm::vec4 constValue(const GpuMatNode &n) {
+  return glm::uintBitsToFloat(glm::uvec4(n.a, n.b, n.c, n.extra));
+}
+
+GpuMatNode makeConst(uint32_t dst, const glm::vec4 &v) {
+  const glm::uvec4 bits = glm::floatBitsToUint(v);
+  GpuMatNode n{};
+  n.op = static_cast<uint32_t>(MatOp::Const4);
+  n.dst = dst;
+  n.a = bits.x;
+  n.b = bits.y;
+  n.c = bits.z;
+  n.extra = bits.w;
+  return n;
+}
+
+// CPU mirror of the shader VM for ops without texture or builtin inputs.
+bool foldOp(MatOp op, uint32_t extra, const glm::vec4 &a, const glm::vec4 &b,
+            const glm::vec4 &c, glm::vec4 &out) {
+  switch (op) {
+  case MatOp::Add:
+    out = a + b;
+    return true;
+  case MatOp::Sub:
+    out = a - b;
+    return true;
+  case MatOp::Mul:
+    out = a * b;
+    return true;
+  case MatOp::Div:
+    out = a / glm::max(b, glm::vec4(1e-6f));
+    return true;
+  case MatOp::Min:
+    out = glm::min(a, b);
+    return true;
+  case MatOp::Max:
+    out = glm::max(a, b);
+    return true;
+  case MatOp::Clamp01:
+    out = glm::clamp(a, glm::vec4(0.0f), glm::vec4(1.0f));
+    return true;
+  case MatOp::OneMinus:
+    out = glm::vec4(1.0f) - a;
+    return true;
+  case MatOp::Lerp:
+    out = glm::mix(a, b, glm::clamp(c, glm::vec4(0.0f), glm::vec4(1.0f)));
+    return true;
+  case MatOp::Pow:
+    out = glm::pow(glm::max(a, glm::vec4(0.0f)), glm::max(b, glm::vec4(1e-6f)));
+    return true;
+  case MatOp::Dot3:
+    out = glm::vec4(glm::dot(glm::vec3(a), glm::vec3(b)));
+    return true;
+  case MatOp::Normalize3: {
+    // normalize(0) is undefined in GLSL; leave it to the GPU.
+    const float len = glm::length(glm::vec3(a));
+    if (!(len > 0.0f))
+      return false;
+    out = glm::vec4(glm::vec3(a) / len, 0.0f);
+    return true;
+  }
+  case MatOp::Swizzle:
+    for (int i = 0; i < 4; ++i)
+      out[i] = a[int(std::min((extra >> (8 * i)) & 0xFFu, 3u))];
+    return true;
+  case MatOp::Append:
+    out = glm::vec4(a.x, b.x, c.x, 0.0f);
+    return true;
+  default:
+    return false;
+  }
+}
+
+struct NodeKey {
+  uint32_t op, a, b, c, extra;
+  bool operator==(const NodeKey &o) const {
+    return op == o.op && a == o.a && b == o.b && c == o.c && extra == o.extra;
+  }
+};
+
+struct NodeKeyHash {
+  size_t operator()(const NodeKey &k) const noexcept {
+    uint64_t h = 1469598103934665603ull;
+    for (uint32_t v : {k.op, k.a, k.b, k.c, k.extra})
+      h = (h ^ v) * 1099511628211ull;
+    return size_t(h);
+  }
+};
+
+using HeaderRegs = std::array<uint32_t *, 5>;
+
+HeaderRegs headerRegs(GpuMatGraphHeader &h) {
+  return {&h.outBaseColor, &h.outMR, &h.outNormalWS, &h.outEmissive,
+          &h.outAlpha};
+}
+
+// SSA check: operands defined before use, each register written once and
+// builtins never written.
+bool validate(const std::vector<GpuMatNode> &prog, const HeaderRegs &outs,
+              uint32_t regCount) {
+  std::vector<uint8_t> defined(regCount, 0);
+  std::fill_n(defined.begin(), std::min(kBuiltinRegs, regCount), 1);
+  for (GpuMatNode n : prog) {
+    if (static_cast<MatOp>(n.op) == MatOp::OutputSurface)
+      continue;
+    bool ok = true;
+    forEachOperand(n, [&](uint32_t &r) { ok = ok && r < regCount && defined[r]; });
+    if (!ok || n.dst < kBuiltinRegs || n.dst >= regCount || defined[n.dst])
+      return false;
+    defined[n.dst] = 1;
+  }
+  for (const uint32_t *r : outs) {
+    if (*r >= regCount || !defined[*r])
+      return false;
+  }
+  return true;
+}
+
+// x+0, x-0, x*1, x/1 (splat constants only) forward x unchanged.
+uint32_t forwardIdentity(const GpuMatNode &n, const std::vector<uint8_t> &isConst,
+                         const std::vector<glm::vec4> &values) {
+  const auto splat = [&](uint32_t r, float s) {
+    return isConst[r] && values[r] == glm::vec4(s);
+  };
+  switch (static_cast<MatOp>(n.op)) {
+  case MatOp::Add:
+    if (splat(n.b, 0.0f))
+      return n.a;
+    if (splat(n.a, 0.0f))
+      return n.b;
+    break;
+  case MatOp::Sub:
+    if (splat(n.b, 0.0f))
+      return n.a;
+    break;
+  case MatOp::Mul:
+    if (splat(n.b, 1.0f))
+      return n.a;
+    if (splat(n.a, 1.0f))
+      return n.b;
+    break;
+  case MatOp::Div:
+    if (splat(n.b, 1.0f))
+      return n.a;
+    break;
+  default:
+    break;
+  }
+  return kNoReg;
+}
+
+// Folding, identities and CSE in one forward sweep. Dropped values are
+// redirected through `alias`.
+void foldAndMerge(std::vector<GpuMatNode> &prog, std::vector<uint32_t> &alias,
+                  MatOptStats &stats) {
+  const size_t regCount = alias.size();
+  std::vector<uint8_t> isConst(regCount, 0);
+  std::vector<glm::vec4> values(regCount, glm::vec4(0.0f));
+  std::unordered_map<NodeKey, uint32_t, NodeKeyHash> seen;
+  seen.reserve(prog.size());
+
+  std::vector<GpuMatNode> out;
+  out.reserve(prog.size());
+  for (GpuMatNode n : prog) {
+    MatOp op = static_cast<MatOp>(n.op);
+    if (op == MatOp::OutputSurface)
+      continue;
+
+    if (op != MatOp::Const4) {
+      // Unused operand fields must not split otherwise equal keys.
+      const uint32_t uses = regOperands(op);
+      if (!(uses & kUseA))
+        n.a = 0;
+      if (!(uses & kUseB))
+        n.b = 0;
+      if (!(uses & kUseC))
+        n.c = 0;
+
+      bool allConst = true;
+      forEachOperand(n, [&](uint32_t &r) {
+        r = alias[r];
+        allConst = allConst && isConst[r];
+      });
+
+      glm::vec4 v{0.0f};
+      if (allConst &&
+          foldOp(op, n.extra, values[n.a], values[n.b], values[n.c], v)) {
+        n = makeConst(n.dst, v);
+        op = MatOp::Const4;
+        ++stats.folded;
+      } else if (const uint32_t fwd = forwardIdentity(n, isConst, values);
+                 fwd != kNoReg) {
+        alias[n.dst] = fwd;
+        ++stats.folded;
+        continue;
+      } else if (isCommutative(op) && n.a > n.b) {
+        std::swap(n.a, n.b);
+      }
+    }
+
+    const auto [it, inserted] =
+        seen.try_emplace(NodeKey{n.op, n.a, n.b, n.c, n.extra}, n.dst);
+    if (!inserted) {
+      alias[n.dst] = it->second;
+      ++stats.merged;
+      if (isTextureOp(op))
+        ++stats.texMerged;
+      continue;
+    }
+
+    if (op == MatOp::Const4) {
+      isConst[n.dst] = 1;
+      values[n.dst] = constValue(n);
+    }
+    out.push_back(n);
+  }
+  prog = std::move(out);
+}
+
+void eliminateDead(std::vector<GpuMatNode> &prog, const HeaderRegs &outs,
+                   size_t regCount, MatOptStats &stats) {
+  std::vector<uint8_t> live(regCount, 0);
+  for (const uint32_t *r : outs)
+    live[*r] = 1;
+
+  std::vector<GpuMatNode> kept;
+  kept.reserve(prog.size());
+  for (auto it = prog.rbegin(); it != prog.rend(); ++it) {
+    GpuMatNode n = *it;
+    if (!live[n.dst]) {
+      ++stats.removed;
+      continue;
+    }
+    forEachOperand(n, [&](uint32_t &r) { live[r] = 1; });
+    kept.push_back(n);
+  }
+  std::reverse(kept.begin(), kept.end());
+  prog = std::move(kept);
+}
+
+// Linear scan over straight-line SSA. A value's register is freed after its
+// last read, and the op reading it may write its result there: the VM reads
+// every operand before it writes dst. Lowest free register first keeps the
+// result deterministic.
+uint32_t allocateRegisters(std::vector<GpuMatNode> &prog,
+                           const HeaderRegs &outs, size_t regCount) {
+  std::vector<uint32_t> lastUse(regCount, 0);
+  for (uint32_t i = 0; i < uint32_t(prog.size()); ++i)
+    forEachOperand(prog[i], [&](uint32_t &r) { lastUse[r] = i; });
+  for (const uint32_t *r : outs)
+    lastUse[*r] = kLiveToEnd;
+
+  std::vector<uint32_t> phys(regCount, kNoReg);
+  for (uint32_t r = 0; r < kBuiltinRegs && r < regCount; ++r)
+    phys[r] = r;
+
+  std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<>> freeRegs;
+  uint32_t next = kBuiltinRegs;
+  for (uint32_t i = 0; i < uint32_t(prog.size()); ++i) {
+    GpuMatNode &n = prog[i];
+    uint32_t dying[3];
+    uint32_t dyingCount = 0;
+    forEachOperand(n, [&](uint32_t &r) {
+      if (r >= kBuiltinRegs && lastUse[r] == i &&
+          std::find(dying, dying + dyingCount, r) == dying + dyingCount)
+        dying[dyingCount++] = r;
+      r = phys[r];
+    });
+    for (uint32_t d = 0; d < dyingCount; ++d)
+      freeRegs.push(phys[dying[d]]);
+
+    uint32_t reg = next;
+    if (!freeRegs.empty()) {
+      reg = freeRegs.top();
+      freeRegs.pop();
+    } else {
+      ++next;
+    }
+    phys[n.dst] = reg;
+    n.dst = reg;
+  }
+
+  for (uint32_t *r : outs)
+    *r = phys[*r];
+  return next;
+}
+
+} // namespace
+
+void optimizeMaterialProgram(std::vector<GpuMatNode> &prog,
+                             GpuMatGraphHeader &header, MatOptStats &stats) {
+  const HeaderRegs outs = headerRegs(header);
+
+  uint32_t regCount = kBuiltinRegs;
+  for (const uint32_t *r : outs)
+    regCount = std::max(regCount, *r + 1);
+  for (GpuMatNode n : prog) {
+    if (static_cast<MatOp>(n.op) == MatOp::OutputSurface)
+      continue;
+    regCount = std::max(regCount, n.dst + 1);
+    forEachOperand(n, [&](uint32_t &r) { regCount = std::max(regCount, r + 1); });
+  }
+
+  stats = {};
+  stats.opsBefore = uint32_t(prog.size());
+  stats.regsBefore = regCount;
+  stats.opsAfter = stats.opsBefore;
+  stats.regsAfter = stats.regsBefore;
+  if (!validate(prog, outs, regCount))
+    return;
+
+  std::vector<uint32_t> alias(regCount);
+  for (uint32_t r = 0; r < regCount; ++r)
+    alias[r] = r;
+  foldAndMerge(prog, alias, stats);
+  for (uint32_t *r : outs)
+    *r = alias[*r];
+
+  eliminateDead(prog, outs, regCount, stats);
+  stats.regsAfter = allocateRegisters(prog, outs, regCount);
+  stats.opsAfter = uint32_t(prog.size());
+}
+
+} // namespace Nyx
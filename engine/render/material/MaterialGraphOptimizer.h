@@ -0,0 +1,35 @@
+#pragma once
+
+#include "MaterialGraphVM.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Nyx {
+
+struct MatOptStats final {
+  uint32_t opsBefore = 0;
+  uint32_t opsAfter = 0;
+  uint32_t regsBefore = 0; // one per emitted value
+  uint32_t regsAfter = 0;  // VM registers after allocation, builtins included
+  uint32_t folded = 0;     // ops turned into constants or forwarded operands
+  uint32_t merged = 0;     // common subexpressions dropped
+  uint32_t texMerged = 0;  // of which duplicate texture samples
+  uint32_t removed = 0;    // ops that never reached an output
+};
+
+// Optimizes a VM program fresh out of MaterialGraphCompiler, in place.
+// Relies on the compiler's contract: every register is written by exactly one
+// op (builtins 0..2 by none) and `header` names the output registers.
+//
+// Passes, in order: constant folding (plus x+0, x*1 style identities),
+// common-subexpression elimination (duplicate constants and texture samples
+// included), dead-op elimination rooted at the header outputs, and a linear
+// scan register allocator that packs the surviving values into as few VM
+// registers as liveness allows. OutputSurface markers are dropped; the shader
+// reads outputs through the header only. Programs that break the contract
+// are left untouched.
+void optimizeMaterialProgram(std::vector<GpuMatNode> &prog,
+                             GpuMatGraphHeader &header, MatOptStats &stats);
+
+} // namespace Nyx
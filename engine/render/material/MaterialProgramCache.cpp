@@ -0,0 +1,240 @@
+#include "MaterialProgramCache.h"
+
+#include "MaterialGraphGLSL.h"
+#include "core/Log.h"
+#include "render/gl/GLShaderUtil.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstring>
+#include <spdlog/fmt/fmt.h>
+
+namespace Nyx {
+
+// GL_COMPLETION_STATUS_KHR / _ARB; the glad loader carries no extensions.
+static constexpr GLenum kCompletionStatus = 0x91B1;
+
+static bool hasParallelShaderCompile() {
+  GLint n = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &n);
+  for (GLint i = 0; i < n; ++i) {
+    const char *ext = reinterpret_cast<const char *>(
+        glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+    if (!ext)
+      continue;
+    if (std::strcmp(ext, "GL_KHR_parallel_shader_compile") == 0 ||
+        std::strcmp(ext, "GL_ARB_parallel_shader_compile") == 0)
+      return true;
+  }
+  return false;
+}
+
+static std::string infoLog(uint32_t obj, bool program) {
+  GLint len = 0;
+  if (program)
+    glGetProgramiv(obj, GL_INFO_LOG_LENGTH, &len);
+  else
+    glGetShaderiv(obj, GL_INFO_LOG_LENGTH, &len);
+  if (len <= 1)
+    return {};
+  std::string log((size_t)len, '\0');
+  GLsizei outLen = 0;
+  if (program)
+    glGetProgramInfoLog(obj, len, &outLen, log.data());
+  else
+    glGetShaderInfoLog(obj, len, &outLen, log.data());
+  log.resize((size_t)std::max(outLen, 0));
+  return log;
+}
+
+static std::string variantName(const std::string &fsPath, uint64_t key) {
+  return fmt::format("{}#{:016x}", fsPath, key);
+}
+
+MaterialProgramCache::~MaterialProgramCache() { shutdown(); }
+
+void MaterialProgramCache::configure(GLShaderUtil &shaders, std::string vsPath,
+                                     std::string fsPath) {
+  shutdown();
+  m_shaders = &shaders;
+  m_fsPath = std::move(fsPath);
+  m_vs = shaders.compileFromFile(GL_VERTEX_SHADER, vsPath);
+  m_parallel = hasParallelShaderCompile();
+  Log::Info("MaterialProgramCache: {} compile",
+            m_parallel ? "parallel" : "synchronous");
+}
+
+void MaterialProgramCache::shutdown() {
+  for (auto &[key, e] : m_entries)
+    release(e);
+  m_entries.clear();
+  m_queue.clear();
+  m_inFlight.clear();
+  if (m_vs) {
+    glDeleteShader(m_vs);
+    m_vs = 0;
+  }
+  m_evicted = 0;
+}
+
+void MaterialProgramCache::release(Entry &e) {
+  if (e.prog) {
+    GLShaderUtil::forgetReflection(e.prog);
+    glDeleteProgram(e.prog);
+    e.prog = 0;
+  }
+  if (e.fs) {
+    glDeleteShader(e.fs);
+    e.fs = 0;
+  }
+}
+
+uint32_t MaterialProgramCache::acquire(const CompiledMaterialGraph &g) {
+  if (!m_enabled || !m_vs || g.nodes.empty())
+    return 0;
+
+  auto [it, inserted] = m_entries.try_emplace(g.hash);
+  Entry &e = it->second;
+  e.lastUsed = m_frame;
+  if (inserted) {
+    const auto base = m_shaders->loader().loadExpanded(m_fsPath);
+    e.source = base.ok ? specializeForwardSource(base.expandedSource,
+                                                 generateMaterialGLSL(g))
+                       : std::string{};
+    if (e.source.empty()) {
+      e.state = State::Failed;
+      return 0;
+    }
+    m_queue.push_back(g.hash);
+    return 0;
+  }
+  return e.state == State::Ready ? e.prog : 0;
+}
+
+void MaterialProgramCache::start(uint64_t key, Entry &e) {
+  if (!m_parallel) {
+    const std::string name = variantName(m_fsPath, key);
+    e.fs = GLShaderUtil::compileFromSource(GL_FRAGMENT_SHADER, e.source, name);
+    e.prog = e.fs ? GLShaderUtil::linkProgram(m_vs, e.fs) : 0;
+    if (e.fs) {
+      glDeleteShader(e.fs);
+      e.fs = 0;
+    }
+    e.state = e.prog ? State::Ready : State::Failed;
+    e.source = {};
+    return;
+  }
+
+  // Nothing below queries a status, so the driver is free to compile and
+  // link on its own threads; finish() polls kCompletionStatus.
+  e.fs = glCreateShader(GL_FRAGMENT_SHADER);
+  const char *src = e.source.c_str();
+  const GLint len = (GLint)e.source.size();
+  glShaderSource(e.fs, 1, &src, &len);
+  glCompileShader(e.fs);
+  e.prog = glCreateProgram();
+  glAttachShader(e.prog, m_vs);
+  glAttachShader(e.prog, e.fs);
+  glLinkProgram(e.prog);
+  e.source = {};
+  e.state = State::Compiling;
+  m_inFlight.push_back(key);
+}
+
+void MaterialProgramCache::finish(uint64_t key, Entry &e) {
+  GLint ok = 0;
+  glGetProgramiv(e.prog, GL_LINK_STATUS, &ok);
+  if (!ok) {
+    GLint compiled = 0;
+    glGetShaderiv(e.fs, GL_COMPILE_STATUS, &compiled);
+    const std::string log =
+        compiled ? infoLog(e.prog, true) : infoLog(e.fs, false);
+    Log::Error("Material variant {} FAILED:\n{}", variantName(m_fsPath, key),
+               log);
+    release(e);
+    e.state = State::Failed;
+    return;
+  }
+  glDetachShader(e.prog, m_vs);
+  glDetachShader(e.prog, e.fs);
+  glDeleteShader(e.fs);
+  e.fs = 0;
+  GLShaderUtil::forgetReflection(e.prog);
+  e.state = State::Ready;
+}
+
+void MaterialProgramCache::update() {
+  ++m_frame;
+  if (!m_vs)
+    return;
+
+  if (m_parallel) {
+    std::erase_if(m_inFlight, [&](uint64_t key) {
+      auto it = m_entries.find(key);
+      if (it == m_entries.end())
+        return true;
+      GLint done = 0;
+      glGetProgramiv(it->second.prog, kCompletionStatus, &done);
+      if (!done)
+        return false;
+      finish(key, it->second);
+      return true;
+    });
+  }
+
+  // Parallel: keep up to kMaxInFlight compiles going. Synchronous: one
+  // blocking compile per frame bounds the hitch.
+  const size_t budget =
+      m_parallel ? kMaxInFlight - std::min<size_t>(m_inFlight.size(),
+                                                    kMaxInFlight)
+                 : 1;
+  size_t started = 0;
+  while (started < budget && !m_queue.empty()) {
+    const uint64_t key = m_queue.front();
+    m_queue.erase(m_queue.begin());
+    auto it = m_entries.find(key);
+    if (it == m_entries.end() || it->second.state != State::Queued)
+      continue;
+    start(key, it->second);
+    ++started;
+  }
+
+  if (m_frame <= kEvictFrames)
+    return;
+  const uint64_t cutoff = m_frame - kEvictFrames;
+  for (auto it = m_entries.begin(); it != m_entries.end();) {
+    Entry &e = it->second;
+    if (e.lastUsed >= cutoff || e.state == State::Compiling) {
+      ++it;
+      continue;
+    }
+    if (e.state == State::Queued)
+      std::erase(m_queue, it->first);
+    release(e);
+    ++m_evicted;
+    it = m_entries.erase(it);
+  }
+}
+
+MaterialProgramStats MaterialProgramCache::stats() const {
+  MaterialProgramStats s{};
+  for (const auto &[key, e] : m_entries) {
+    switch (e.state) {
+    case State::Ready:
+      s.ready++;
+      break;
+    case State::Failed:
+      s.failed++;
+      break;
+    default:
+      s.pending++;
+      break;
+    }
+  }
+  s.evicted = m_evicted;
+  s.parallelCompile = m_parallel;
+  return s;
+}
+
+} // namespace Nyx
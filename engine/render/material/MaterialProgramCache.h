@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nyx {
+
+class GLShaderUtil;
+struct CompiledMaterialGraph;
+
+struct MaterialProgramStats final {
+  uint32_t ready = 0;
+  uint32_t pending = 0; // queued or compiling
+  uint32_t failed = 0;
+  uint32_t evicted = 0; // total since configure()
+  bool parallelCompile = false;
+};
+
+// forward_mrt programs specialized per material graph (MaterialGraphGLSL),
+// keyed by CompiledMaterialGraph::hash. A miss queues a compile and returns
+// 0; the caller keeps drawing with the generic VM program until the variant
+// links. With KHR/ARB_parallel_shader_compile the driver compiles in the
+// background and update() only polls; without it update() compiles one
+// variant per frame synchronously.
+class MaterialProgramCache final {
+public:
+  ~MaterialProgramCache();
+
+  void configure(GLShaderUtil &shaders, std::string vsPath,
+                 std::string fsPath);
+  void shutdown();
+
+  // Off: acquire() always returns 0. Existing variants are kept.
+  void setEnabled(bool on) { m_enabled = on; }
+  bool enabled() const { return m_enabled; }
+
+  // Linked program for `g`, or 0 while it compiles, after a failed compile,
+  // or for graphs without nodes.
+  uint32_t acquire(const CompiledMaterialGraph &g);
+
+  // Once per frame: finishes and starts compiles, evicts variants no draw
+  // acquired for kEvictFrames frames.
+  void update();
+
+  MaterialProgramStats stats() const;
+
+private:
+  static constexpr uint32_t kMaxInFlight = 8;
+  static constexpr uint64_t kEvictFrames = 600;
+
+  enum class State : uint8_t { Queued, Compiling, Ready, Failed };
+
+  struct Entry final {
+    State state = State::Queued;
+    uint32_t fs = 0;
+    uint32_t prog = 0;
+    uint64_t lastUsed = 0;
+    std::string source; // specialized fragment source, freed once started
+  };
+
+  void start(uint64_t key, Entry &e);
+  void finish(uint64_t key, Entry &e);
+  void release(Entry &e);
+
+  GLShaderUtil *m_shaders = nullptr;
+  std::string m_fsPath;
+  uint32_t m_vs = 0; // shared by every variant
+  bool m_parallel = false;
+  bool m_enabled = true;
+  uint64_t m_frame = 0;
+  uint32_t m_evicted = 0;
+
+  std::unordered_map<uint64_t, Entry> m_entries;
+  std::vector<uint64_t> m_queue;    // FIFO of Queued keys
+  std::vector<uint64_t> m_inFlight; // Compiling keys (parallel path only)
+};
+
+} // namespace Nyx
@@ -3,6 +3,7 @@
 #include "core/Assert.h"
 #include "material/MaterialHandle.h"
 #include "render/gl/GLResources.h"
+#include "render/gl/GLUploadRing.h"
 #include "render/material/GpuMaterial.h"
 
 #include <bit>
@@ -17,9 +18,10 @@ namespace Nyx {
 static uint32_t idxFromHandle(MaterialHandle h) { return h.slot; }
 static uint32_t genFromHandle(MaterialHandle h) { return h.gen; }
 
-void MaterialSystem::initGL(GLResources &gl) {
+void MaterialSystem::initGL(GLResources &gl, GLUploadRing &upload) {
   m_gl = &gl;
-  m_tex.init(gl);
+  m_upload = &upload;
+  m_tex.init(gl, upload);
 
   if (!m_ssbo)
     glCreateBuffers(1, &m_ssbo);
@@ -50,10 +52,14 @@ void MaterialSystem::shutdownGL() {
     glDeleteBuffers(1, &m_graphNodesSSBO);
     m_graphNodesSSBO = 0;
   }
+  m_ssboCapacity = 0;
+  m_graphHeadersCapacity = 0;
+  m_graphNodesCapacity = 0;
 
   m_slots.clear();
   m_free.clear();
   m_gl = nullptr;
+  m_upload = nullptr;
   m_anyDirty = true;
   m_anyGraphDirty = true;
   ++m_changeSerial;
@@ -243,12 +249,62 @@ void MaterialSystem::uploadIfDirty() {
   for (const Slot &s : m_slots)
     packed.push_back(s.alive ? s.gpu : GpuMaterialPacked{});
 
-  glNamedBufferData(m_ssbo, packed.size() * sizeof(GpuMaterialPacked),
-                    packed.data(), GL_DYNAMIC_DRAW);
+  uploadTable(m_ssbo, m_ssboCapacity, packed.data(),
+              packed.size() * sizeof(GpuMaterialPacked));
 
   m_anyDirty = false;
 }
 
+void MaterialSystem::uploadTable(uint32_t buf, uint32_t &capacity,
+                                 const void *data, size_t bytes) {
+  // No slack: shaders bound-check against the header table's length(), and
+  // slot tables only ever grow until reset().
+  if (bytes > capacity) {
+    capacity = static_cast<uint32_t>(bytes);
+    glNamedBufferData(buf, capacity, nullptr, GL_STATIC_DRAW);
+  }
+  m_upload->uploadToBuffer(buf, 0, data, bytes);
+}
+
+void MaterialSystem::processTextureUploads(
+    const std::vector<uint32_t> &visibleSlots) {
+  if (m_tex.pendingLoads() > 0)
+    requestTextures(visibleSlots);
+  m_tex.processUploads();
+}
+
+void MaterialSystem::requestTextures(
+    const std::vector<uint32_t> &visibleSlots) {
+  m_visibleScratch.assign(m_slots.size(), 0);
+  for (uint32_t slot : visibleSlots) {
+    if (slot < m_visibleScratch.size())
+      m_visibleScratch[slot] = 1;
+  }
+
+  for (uint32_t i = 0; i < m_slots.size(); ++i) {
+    const Slot &s = m_slots[i];
+    if (!s.alive)
+      continue;
+    const TexturePriority prio = m_visibleScratch[i]
+                                     ? TexturePriority::Visible
+                                     : TexturePriority::Editor;
+    const uint32_t texs[6] = {s.gpu.tex0123.x, s.gpu.tex0123.y,
+                              s.gpu.tex0123.z, s.gpu.tex0123.w,
+                              s.gpu.tex4_pad.x, s.gpu.tex4_pad.y};
+    for (uint32_t t : texs) {
+      if (t != kInvalidTexIndex)
+        m_tex.request(t, prio);
+    }
+    for (const MatNode &n : s.graph.nodes) {
+      if ((n.type == MatNodeType::Texture2D ||
+           n.type == MatNodeType::TextureMRA ||
+           n.type == MatNodeType::NormalMap) &&
+          n.u.x != kInvalidTexIndex)
+        m_tex.request(n.u.x, prio);
+    }
+  }
+}
+
 void MaterialSystem::reset() {
   if (!m_gl)
     return;
@@ -259,14 +315,17 @@ void MaterialSystem::reset() {
   m_anyGraphDirty = true;
 
   m_tex.shutdown();
-  m_tex.init(*m_gl);
+  m_tex.init(*m_gl, *m_upload);
 
   if (m_ssbo)
-    glNamedBufferData(m_ssbo, 0, nullptr, GL_DYNAMIC_DRAW);
+    glNamedBufferData(m_ssbo, 0, nullptr, GL_STATIC_DRAW);
   if (m_graphHeadersSSBO)
-    glNamedBufferData(m_graphHeadersSSBO, 0, nullptr, GL_DYNAMIC_DRAW);
+    glNamedBufferData(m_graphHeadersSSBO, 0, nullptr, GL_STATIC_DRAW);
   if (m_graphNodesSSBO)
-    glNamedBufferData(m_graphNodesSSBO, 0, nullptr, GL_DYNAMIC_DRAW);
+    glNamedBufferData(m_graphNodesSSBO, 0, nullptr, GL_STATIC_DRAW);
+  m_ssboCapacity = 0;
+  m_graphHeadersCapacity = 0;
+  m_graphNodesCapacity = 0;
 }
 
 void MaterialSystem::snapshot(MaterialSystemSnapshot &out) const {
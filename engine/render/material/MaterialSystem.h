@@ -12,6 +12,7 @@
 namespace Nyx {
 
 class GLResources;
+class GLUploadRing;
 
 class MaterialSystem final {
 public:
@@ -27,7 +28,7 @@ public:
     uint64_t changeSerial = 0;
   };
 
-  void initGL(GLResources &gl);
+  void initGL(GLResources &gl, GLUploadRing &upload);
   void shutdownGL();
 
   MaterialHandle create(const MaterialData &data);
@@ -40,11 +41,17 @@ public:
   MaterialGraph &graph(MaterialHandle h);
   const MaterialGraph &graph(MaterialHandle h) const;
   const std::string &graphError(MaterialHandle h) const;
+  // Op/register counts of the last graph compile, before and after
+  // optimization.
+  const MatOptStats &graphOptStats(MaterialHandle h) const;
   MatAlphaMode alphaMode(MaterialHandle h) const;
 
   uint32_t gpuIndex(MaterialHandle h) const; // index in SSBO array
   uint32_t slotCount() const { return (uint32_t)m_slots.size(); }
   MaterialHandle handleBySlot(uint32_t slot) const;
+  // Compiled graph of the material in `slot` (== gpuIndex), or nullptr when
+  // it has none and shades through the parameter path.
+  const CompiledMaterialGraph *compiledGraphBySlot(uint32_t slot) const;
   void ensureGraphFromMaterial(MaterialHandle h, bool force = false);
   void syncGraphFromMaterial(MaterialHandle h, bool force = false);
   void syncMaterialFromGraph(MaterialHandle h);
@@ -53,9 +60,11 @@ public:
   void markGraphDirty(MaterialHandle h);
   void uploadIfDirty();
   uint64_t changeSerial() const { return m_changeSerial; }
-  void processTextureUploads(uint32_t maxPerFrame = 8) {
-    m_tex.processUploads(maxPerFrame);
-  }
+  // Once per frame. While loads are pending, re-requests every texture a
+  // live material uses (Visible for the material slots in `visibleSlots`,
+  // Editor otherwise) so loads nothing uses any more get cancelled, then
+  // uploads finished decodes within the texture upload budget.
+  void processTextureUploads(const std::vector<uint32_t> &visibleSlots);
   void reset();
   void snapshot(MaterialSystemSnapshot &out) const;
   void restore(const MaterialSystemSnapshot &snap);
@@ -80,6 +89,7 @@ private:
   };
 
   GLResources *m_gl = nullptr;
+  GLUploadRing *m_upload = nullptr;
   TextureTable m_tex{};
 
   std::vector<Slot> m_slots;
@@ -87,11 +97,21 @@ private:
   uint32_t m_ssbo = 0;
   uint32_t m_graphHeadersSSBO = 0;
   uint32_t m_graphNodesSSBO = 0;
+  // Allocated bytes of the three tables; they only grow.
+  uint32_t m_ssboCapacity = 0;
+  uint32_t m_graphHeadersCapacity = 0;
+  uint32_t m_graphNodesCapacity = 0;
+  std::vector<uint8_t> m_visibleScratch; // per slot, for texture requests
   bool m_anyGraphDirty = true;
   bool m_anyDirty = false;
   uint64_t m_changeSerial = 1;
 
   void rebuildGpuForSlot(uint32_t idx);
+  void requestTextures(const std::vector<uint32_t> &visibleSlots);
+  // Copies a table into `buf` through the upload ring, growing it first if
+  // needed.
+  void uploadTable(uint32_t buf, uint32_t &capacity, const void *data,
+                   size_t bytes);
   void updateGraphTablesIfDirty();
 };
 
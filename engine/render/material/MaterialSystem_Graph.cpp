@@ -253,6 +253,23 @@ const std::string &MaterialSystem::graphError(MaterialHandle h) const {
   return m_slots[idxFromHandle(h)].graphErr;
 }
 
+const MatOptStats &MaterialSystem::graphOptStats(MaterialHandle h) const {
+  static const MatOptStats kEmpty;
+  if (!isAlive(h))
+    return kEmpty;
+  return m_slots[idxFromHandle(h)].compiled.stats;
+}
+
+const CompiledMaterialGraph *
+MaterialSystem::compiledGraphBySlot(uint32_t slot) const {
+  if (slot >= m_slots.size())
+    return nullptr;
+  const Slot &s = m_slots[slot];
+  if (!s.alive || s.compiled.nodes.empty())
+    return nullptr;
+  return &s.compiled;
+}
+
 MatAlphaMode MaterialSystem::alphaMode(MaterialHandle h) const {
   if (!isAlive(h))
     return MatAlphaMode::Opaque;
@@ -313,13 +330,10 @@ void MaterialSystem::updateGraphTablesIfDirty() {
     headers[i] = h;
   }
 
-  glNamedBufferData(m_graphHeadersSSBO,
-                    headers.size() * sizeof(GpuMatGraphHeader),
-                    headers.empty() ? nullptr : headers.data(),
-                    GL_DYNAMIC_DRAW);
-  glNamedBufferData(m_graphNodesSSBO,
-                    nodes.size() * sizeof(GpuMatNode),
-                    nodes.empty() ? nullptr : nodes.data(), GL_DYNAMIC_DRAW);
+  uploadTable(m_graphHeadersSSBO, m_graphHeadersCapacity, headers.data(),
+              headers.size() * sizeof(GpuMatGraphHeader));
+  uploadTable(m_graphNodesSSBO, m_graphNodesCapacity, nodes.data(),
+              nodes.size() * sizeof(GpuMatNode));
 
   m_anyGraphDirty = false;
 }
@@ -0,0 +1,935 @@
+#include "render/material/TextureCooker.h"
+
+#include <blake3.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace Nyx {
+
+namespace {
+
+constexpr uint32_t kCookMagic = 0x4E595843; // 'NYXC'
+// Bump whenever the same input would cook to different bytes (filter or
+// encoder changes); it is part of the cache key.
+constexpr uint32_t kCookVersion = 1;
+constexpr uint32_t kMaxLevels = 32;
+
+constexpr uint8_t kFlagSRGB = 1u << 0;
+constexpr uint8_t kFlagReconstructZ = 1u << 1;
+
+struct CookedFileHeader {
+  uint32_t magic = kCookMagic;
+  uint32_t version = kCookVersion;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t levels = 0;
+  uint8_t codec = 0;
+  uint8_t flags = 0;
+  uint16_t reserved = 0;
+  uint64_t dataBytes = 0;
+};
+
+struct CookedFileLevel {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint64_t offset = 0;
+  uint64_t size = 0;
+};
+
+// ---- sRGB ----
+
+constexpr uint32_t kLinearSteps = 16384;
+
+struct SRGBTables {
+  float toLinear[256];
+  uint8_t fromLinear[kLinearSteps];
+};
+
+const SRGBTables &srgbTables() {
+  static const SRGBTables tables = [] {
+    SRGBTables t{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      const double c = double(i) / 255.0;
+      t.toLinear[i] = float(c <= 0.04045 ? c / 12.92
+                                         : std::pow((c + 0.055) / 1.055, 2.4));
+    }
+    for (uint32_t i = 0; i < kLinearSteps; ++i) {
+      const double l = double(i) / double(kLinearSteps - 1);
+      const double c =
+          l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+      t.fromLinear[i] = uint8_t(std::clamp(c * 255.0 + 0.5, 0.0, 255.0));
+    }
+    return t;
+  }();
+  return tables;
+}
+
+uint8_t encodeSRGB(float linear) {
+  const float x = std::clamp(linear, 0.0f, 1.0f);
+  return srgbTables().fromLinear[uint32_t(x * float(kLinearSteps - 1) + 0.5f)];
+}
+
+// ---- mips ----
+
+enum class MipFilter : uint8_t { Linear, SRGB, Normal };
+
+float unorm(uint8_t v) { return float(v) * (1.0f / 255.0f); }
+
+uint8_t toUnorm8(float v) {
+  return uint8_t(std::clamp(v * 255.0f + 0.5f, 0.0f, 255.0f));
+}
+
+// Every texel a unit vector with Z >= 0 (within 8-bit quantization) and
+// alpha opaque: dropping Z and rebuilding it from XY is then lossless up to
+// that tolerance, whatever the image is used for.
+bool isNormalMap(const uint8_t *rgba, uint32_t w, uint32_t h) {
+  const size_t n = size_t(w) * h;
+  for (size_t i = 0; i < n; ++i) {
+    const uint8_t *p = rgba + i * 4;
+    if (p[3] != 255 || p[2] < 124)
+      return false;
+    const float x = unorm(p[0]) * 2.0f - 1.0f;
+    const float y = unorm(p[1]) * 2.0f - 1.0f;
+    const float z = unorm(p[2]) * 2.0f - 1.0f;
+    if (std::abs(x * x + y * y + z * z - 1.0f) > 0.1f)
+      return false;
+  }
+  return true;
+}
+
+bool hasAlpha(const uint8_t *rgba, uint32_t w, uint32_t h) {
+  const size_t n = size_t(w) * h;
+  for (size_t i = 0; i < n; ++i) {
+    if (rgba[i * 4 + 3] != 255)
+      return true;
+  }
+  return false;
+}
+
+// One 2x box step; an odd last row/column is folded into its neighbor.
+void downsample(const std::vector<uint8_t> &src, uint32_t sw, uint32_t sh,
+                std::vector<uint8_t> &dst, uint32_t dw, uint32_t dh,
+                MipFilter filter) {
+  const SRGBTables &srgb = srgbTables();
+  dst.resize(size_t(dw) * dh * 4);
+  for (uint32_t y = 0; y < dh; ++y) {
+    const uint32_t y0 = std::min(2 * y, sh - 1);
+    const uint32_t y1 = std::min(2 * y + 1, sh - 1);
+    for (uint32_t x = 0; x < dw; ++x) {
+      const uint32_t x0 = std::min(2 * x, sw - 1);
+      const uint32_t x1 = std::min(2 * x + 1, sw - 1);
+      const uint8_t *q[4] = {&src[(size_t(y0) * sw + x0) * 4],
+                             &src[(size_t(y0) * sw + x1) * 4],
+                             &src[(size_t(y1) * sw + x0) * 4],
+                             &src[(size_t(y1) * sw + x1) * 4]};
+      uint8_t *d = &dst[(size_t(y) * dw + x) * 4];
+      d[3] = uint8_t((q[0][3] + q[1][3] + q[2][3] + q[3][3] + 2) / 4);
+
+      if (filter == MipFilter::Linear) {
+        for (int c = 0; c < 3; ++c)
+          d[c] = uint8_t((q[0][c] + q[1][c] + q[2][c] + q[3][c] + 2) / 4);
+      } else if (filter == MipFilter::SRGB) {
+        for (int c = 0; c < 3; ++c) {
+          const float l = srgb.toLinear[q[0][c]] + srgb.toLinear[q[1][c]] +
+                          srgb.toLinear[q[2][c]] + srgb.toLinear[q[3][c]];
+          d[c] = encodeSRGB(l * 0.25f);
+        }
+      } else {
+        float v[3] = {};
+        for (const uint8_t *p : q) {
+          for (int c = 0; c < 3; ++c)
+            v[c] += unorm(p[c]) * 2.0f - 1.0f;
+        }
+        const float len = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        if (len < 1e-6f) {
+          v[0] = 0.0f;
+          v[1] = 0.0f;
+          v[2] = 1.0f;
+        } else {
+          for (float &c : v)
+            c /= len;
+        }
+        for (int c = 0; c < 3; ++c)
+          d[c] = toUnorm8(v[c] * 0.5f + 0.5f);
+      }
+    }
+  }
+}
+
+// ---- block helpers ----
+
+using Block = uint8_t[16][4];
+
+uint32_t blockBytes(TextureCodec codec) {
+  return codec == TextureCodec::BC1 ? 8u : 16u;
+}
+
+// Edge blocks of levels that are not a multiple of 4 repeat the last
+// row/column.
+void fetchBlock(const uint8_t *img, uint32_t w, uint32_t h, uint32_t bx,
+                uint32_t by, Block &out) {
+  for (uint32_t y = 0; y < 4; ++y) {
+    const uint32_t sy = std::min(by * 4 + y, h - 1);
+    for (uint32_t x = 0; x < 4; ++x) {
+      const uint32_t sx = std::min(bx * 4 + x, w - 1);
+      std::memcpy(out[y * 4 + x], img + (size_t(sy) * w + sx) * 4, 4);
+    }
+  }
+}
+
+void storeBlock(const Block &in, uint8_t *img, uint32_t w, uint32_t h,
+                uint32_t bx, uint32_t by) {
+  for (uint32_t y = 0; y < 4 && by * 4 + y < h; ++y) {
+    for (uint32_t x = 0; x < 4 && bx * 4 + x < w; ++x) {
+      std::memcpy(img + (size_t(by * 4 + y) * w + bx * 4 + x) * 4,
+                  in[y * 4 + x], 4);
+    }
+  }
+}
+
+// Mean and dominant direction of the block's first `channels` components
+// (power iteration on the covariance). The axis is zero for flat blocks.
+void principalAxis(const Block &px, int channels, float mean[4],
+                   float axis[4]) {
+  for (int c = 0; c < 4; ++c) {
+    mean[c] = 0.0f;
+    axis[c] = 0.0f;
+  }
+  for (const auto &p : px) {
+    for (int c = 0; c < channels; ++c)
+      mean[c] += float(p[c]);
+  }
+  for (int c = 0; c < channels; ++c)
+    mean[c] *= 1.0f / 16.0f;
+
+  float cov[4][4] = {};
+  for (const auto &p : px) {
+    float d[4] = {};
+    for (int c = 0; c < channels; ++c)
+      d[c] = float(p[c]) - mean[c];
+    for (int i = 0; i < channels; ++i) {
+      for (int j = 0; j < channels; ++j)
+        cov[i][j] += d[i] * d[j];
+    }
+  }
+
+  float v[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+  for (int iter = 0; iter < 8; ++iter) {
+    float r[4] = {};
+    for (int i = 0; i < channels; ++i) {
+      for (int j = 0; j < channels; ++j)
+        r[i] += cov[i][j] * v[j];
+    }
+    float len = 0.0f;
+    for (int c = 0; c < channels; ++c)
+      len += r[c] * r[c];
+    if (len < 1e-12f)
+      return;
+    len = 1.0f / std::sqrt(len);
+    for (int c = 0; c < channels; ++c)
+      v[c] = r[c] * len;
+  }
+  for (int c = 0; c < channels; ++c)
+    axis[c] = v[c];
+}
+
+// Block endpoints along the principal axis, at the extreme projections.
+void axisEndpoints(const Block &px, int channels, float lo[4], float hi[4]) {
+  float mean[4];
+  float axis[4];
+  principalAxis(px, channels, mean, axis);
+  float tMin = 0.0f;
+  float tMax = 0.0f;
+  for (const auto &p : px) {
+    float t = 0.0f;
+    for (int c = 0; c < channels; ++c)
+      t += (float(p[c]) - mean[c]) * axis[c];
+    tMin = std::min(tMin, t);
+    tMax = std::max(tMax, t);
+  }
+  for (int c = 0; c < 4; ++c) {
+    lo[c] = std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+    hi[c] = std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+  }
+}
+
+// Least-squares endpoints for fixed per-texel weights: texel i is
+// approximately (1 - t[i]) * a + t[i] * b. Returns false when the weights
+// do not pin both endpoints down.
+bool fitEndpoints(const Block &px, int channels, const float t[16],
+                  float a[4], float b[4]) {
+  float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+  float ax[4] = {}, bx[4] = {};
+  for (int i = 0; i < 16; ++i) {
+    const float wa = 1.0f - t[i];
+    const float wb = t[i];
+    aa += wa * wa;
+    bb += wb * wb;
+    ab += wa * wb;
+    for (int c = 0; c < channels; ++c) {
+      ax[c] += wa * float(px[i][c]);
+      bx[c] += wb * float(px[i][c]);
+    }
+  }
+  const float det = aa * bb - ab * ab;
+  if (std::abs(det) < 1e-6f)
+    return false;
+  const float inv = 1.0f / det;
+  for (int c = 0; c < 4; ++c) {
+    a[c] = std::clamp((ax[c] * bb - bx[c] * ab) * inv, 0.0f, 255.0f);
+    b[c] = std::clamp((bx[c] * aa - ax[c] * ab) * inv, 0.0f, 255.0f);
+  }
+  return true;
+}
+
+void put16(uint8_t *out, uint16_t v) {
+  out[0] = uint8_t(v);
+  out[1] = uint8_t(v >> 8);
+}
+
+uint16_t get16(const uint8_t *in) { return uint16_t(in[0] | (in[1] << 8)); }
+
+// ---- BC1 (opaque, four-color mode) ----
+
+uint16_t pack565(const float c[3]) {
+  const auto q = [](float v, float maxq) {
+    return uint16_t(std::clamp(v * maxq / 255.0f + 0.5f, 0.0f, maxq));
+  };
+  return uint16_t((q(c[0], 31.0f) << 11) | (q(c[1], 63.0f) << 5) |
+                  q(c[2], 31.0f));
+}
+
+void unpack565(uint16_t v, int out[3]) {
+  const int r = (v >> 11) & 31;
+  const int g = (v >> 5) & 63;
+  const int b = v & 31;
+  out[0] = (r << 3) | (r >> 2);
+  out[1] = (g << 2) | (g >> 4);
+  out[2] = (b << 3) | (b >> 2);
+}
+
+struct BC1Try {
+  uint16_t c0 = 0;
+  uint16_t c1 = 0;
+  uint32_t indices = 0;
+  float err = 1e30f;
+};
+
+BC1Try tryBC1(const Block &px, uint16_t c0, uint16_t c1) {
+  BC1Try r{};
+  if (c0 < c1)
+    std::swap(c0, c1);
+  r.c0 = c0;
+  r.c1 = c1;
+
+  int pal[4][3];
+  unpack565(c0, pal[0]);
+  unpack565(c1, pal[1]);
+  for (int c = 0; c < 3; ++c) {
+    pal[2][c] = (2 * pal[0][c] + pal[1][c]) / 3;
+    pal[3][c] = (pal[0][c] + 2 * pal[1][c]) / 3;
+  }
+  // Equal endpoints select three-color mode; index 0 is still exact.
+  const int count = c0 == c1 ? 1 : 4;
+
+  r.err = 0.0f;
+  for (int i = 0; i < 16; ++i) {
+    int best = 0;
+    int bestErr = 1 << 30;
+    for (int k = 0; k < count; ++k) {
+      int e = 0;
+      for (int c = 0; c < 3; ++c) {
+        const int d = int(px[i][c]) - pal[k][c];
+        e += d * d;
+      }
+      if (e < bestErr) {
+        bestErr = e;
+        best = k;
+      }
+    }
+    r.indices |= uint32_t(best) << (2 * i);
+    r.err += float(bestErr);
+  }
+  return r;
+}
+
+void encodeBC1(const Block &px, uint8_t *out) {
+  float lo[4];
+  float hi[4];
+  axisEndpoints(px, 3, lo, hi);
+  BC1Try best = tryBC1(px, pack565(hi), pack565(lo));
+
+  if (best.c0 != best.c1) {
+    constexpr float kT[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+    float t[16];
+    for (int i = 0; i < 16; ++i)
+      t[i] = kT[(best.indices >> (2 * i)) & 3u];
+    float a[4];
+    float b[4];
+    if (fitEndpoints(px, 3, t, a, b)) {
+      const BC1Try refined = tryBC1(px, pack565(a), pack565(b));
+      if (refined.err < best.err)
+        best = refined;
+    }
+  }
+
+  put16(out, best.c0);
+  put16(out + 2, best.c1);
+  for (int i = 0; i < 4; ++i)
+    out[4 + i] = uint8_t(best.indices >> (8 * i));
+}
+
+void decodeBC1(const uint8_t *in, Block &out) {
+  const uint16_t c0 = get16(in);
+  const uint16_t c1 = get16(in + 2);
+  int pal[4][4];
+  unpack565(c0, pal[0]);
+  unpack565(c1, pal[1]);
+  pal[0][3] = pal[1][3] = pal[2][3] = pal[3][3] = 255;
+  for (int c = 0; c < 3; ++c) {
+    if (c0 > c1) {
+      pal[2][c] = (2 * pal[0][c] + pal[1][c]) / 3;
+      pal[3][c] = (pal[0][c] + 2 * pal[1][c]) / 3;
+    } else {
+      pal[2][c] = (pal[0][c] + pal[1][c]) / 2;
+      pal[3][c] = 0;
+    }
+  }
+  if (c0 <= c1)
+    pal[3][3] = 0;
+  uint32_t bits = 0;
+  std::memcpy(&bits, in + 4, 4);
+  for (int i = 0; i < 16; ++i) {
+    const int k = (bits >> (2 * i)) & 3;
+    for (int c = 0; c < 4; ++c)
+      out[i][c] = uint8_t(pal[k][c]);
+  }
+}
+
+// ---- BC4 (one channel, eight-value mode) ----
+
+void bc4Palette(int a0, int a1, int pal[8]) {
+  pal[0] = a0;
+  pal[1] = a1;
+  if (a0 > a1) {
+    for (int i = 1; i < 7; ++i)
+      pal[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+  } else {
+    for (int i = 1; i < 5; ++i)
+      pal[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+    pal[6] = 0;
+    pal[7] = 255;
+  }
+}
+
+void encodeBC4(const Block &px, int channel, uint8_t *out) {
+  int lo = 255;
+  int hi = 0;
+  for (const auto &p : px) {
+    lo = std::min(lo, int(p[channel]));
+    hi = std::max(hi, int(p[channel]));
+  }
+  out[0] = uint8_t(hi);
+  out[1] = uint8_t(lo);
+  uint64_t bits = 0;
+  if (hi != lo) {
+    int pal[8];
+    bc4Palette(hi, lo, pal);
+    for (int i = 0; i < 16; ++i) {
+      const int v = px[i][channel];
+      int best = 0;
+      for (int k = 1; k < 8; ++k) {
+        if (std::abs(pal[k] - v) < std::abs(pal[best] - v))
+          best = k;
+      }
+      bits |= uint64_t(best) << (3 * i);
+    }
+  }
+  for (int i = 0; i < 6; ++i)
+    out[2 + i] = uint8_t(bits >> (8 * i));
+}
+
+void decodeBC4(const uint8_t *in, int channel, Block &out) {
+  int pal[8];
+  bc4Palette(in[0], in[1], pal);
+  uint64_t bits = 0;
+  for (int i = 0; i < 6; ++i)
+    bits |= uint64_t(in[2 + i]) << (8 * i);
+  for (int i = 0; i < 16; ++i)
+    out[i][channel] = uint8_t(pal[(bits >> (3 * i)) & 7u]);
+}
+
+// ---- BC7 (mode 6: one subset, RGBA 7.7.7.7 + p-bit, 4-bit indices) ----
+
+constexpr int kBC7Weights[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                                 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct BC7Try {
+  uint8_t q0[4] = {};
+  uint8_t q1[4] = {};
+  uint8_t p0 = 0;
+  uint8_t p1 = 0;
+  uint8_t idx[16] = {};
+  float err = 1e30f;
+};
+
+int bc7Interp(int e0, int e1, int w) {
+  return ((64 - w) * e0 + w * e1 + 32) >> 6;
+}
+
+BC7Try tryBC7(const Block &px, const float e0[4], const float e1[4]) {
+  BC7Try best{};
+  for (uint8_t p0 = 0; p0 < 2; ++p0) {
+    for (uint8_t p1 = 0; p1 < 2; ++p1) {
+      BC7Try r{};
+      r.p0 = p0;
+      r.p1 = p1;
+      int end0[4];
+      int end1[4];
+      for (int c = 0; c < 4; ++c) {
+        const auto q = [](float v, int p) {
+          const float x = (v - float(p)) * 0.5f + 0.5f;
+          return uint8_t(std::clamp(x, 0.0f, 127.0f));
+        };
+        r.q0[c] = q(e0[c], p0);
+        r.q1[c] = q(e1[c], p1);
+        end0[c] = (r.q0[c] << 1) | p0;
+        end1[c] = (r.q1[c] << 1) | p1;
+      }
+
+      int pal[16][4];
+      for (int k = 0; k < 16; ++k) {
+        for (int c = 0; c < 4; ++c)
+          pal[k][c] = bc7Interp(end0[c], end1[c], kBC7Weights[k]);
+      }
+      float dir[4];
+      float dd = 0.0f;
+      for (int c = 0; c < 4; ++c) {
+        dir[c] = float(end1[c] - end0[c]);
+        dd += dir[c] * dir[c];
+      }
+
+      r.err = 0.0f;
+      for (int i = 0; i < 16; ++i) {
+        // Nearest weight to the projection, then its neighbors.
+        int guess = 0;
+        if (dd > 0.0f) {
+          float t = 0.0f;
+          for (int c = 0; c < 4; ++c)
+            t += (float(px[i][c]) - float(end0[c])) * dir[c];
+          const float w = std::clamp(t / dd, 0.0f, 1.0f) * 64.0f;
+          while (guess < 15 && float(kBC7Weights[guess + 1]) <= w)
+            ++guess;
+        }
+        int bestK = guess;
+        int bestErr = 1 << 30;
+        for (int k = std::max(guess - 1, 0); k <= std::min(guess + 1, 15);
+             ++k) {
+          int e = 0;
+          for (int c = 0; c < 4; ++c) {
+            const int d = int(px[i][c]) - pal[k][c];
+            e += d * d;
+          }
+          if (e < bestErr) {
+            bestErr = e;
+            bestK = k;
+          }
+        }
+        r.idx[i] = uint8_t(bestK);
+        r.err += float(bestErr);
+      }
+      if (r.err < best.err)
+        best = r;
+    }
+  }
+  return best;
+}
+
+class BitWriter final {
+public:
+  explicit BitWriter(uint8_t *out) : m_out(out) { std::memset(out, 0, 16); }
+  void put(uint32_t value, uint32_t bits) {
+    for (uint32_t i = 0; i < bits; ++i, ++m_pos) {
+      if (value & (1u << i))
+        m_out[m_pos >> 3] |= uint8_t(1u << (m_pos & 7));
+    }
+  }
+
+private:
+  uint8_t *m_out;
+  uint32_t m_pos = 0;
+};
+
+class BitReader final {
+public:
+  explicit BitReader(const uint8_t *in) : m_in(in) {}
+  uint32_t get(uint32_t bits) {
+    uint32_t v = 0;
+    for (uint32_t i = 0; i < bits; ++i, ++m_pos)
+      v |= uint32_t((m_in[m_pos >> 3] >> (m_pos & 7)) & 1u) << i;
+    return v;
+  }
+
+private:
+  const uint8_t *m_in;
+  uint32_t m_pos = 0;
+};
+
+void encodeBC7(const Block &px, uint8_t *out) {
+  float lo[4];
+  float hi[4];
+  axisEndpoints(px, 4, lo, hi);
+  BC7Try best = tryBC7(px, lo, hi);
+
+  float t[16];
+  for (int i = 0; i < 16; ++i)
+    t[i] = float(kBC7Weights[best.idx[i]]) / 64.0f;
+  float a[4];
+  float b[4];
+  if (fitEndpoints(px, 4, t, a, b)) {
+    const BC7Try refined = tryBC7(px, a, b);
+    if (refined.err < best.err)
+      best = refined;
+  }
+
+  // The anchor texel's index MSB is implicit zero: swap the ends if needed.
+  if (best.idx[0] >= 8) {
+    for (int c = 0; c < 4; ++c)
+      std::swap(best.q0[c], best.q1[c]);
+    std::swap(best.p0, best.p1);
+    for (uint8_t &i : best.idx)
+      i = uint8_t(15 - i);
+  }
+
+  BitWriter w(out);
+  w.put(1u << 6, 7);
+  for (int c = 0; c < 4; ++c) {
+    w.put(best.q0[c], 7);
+    w.put(best.q1[c], 7);
+  }
+  w.put(best.p0, 1);
+  w.put(best.p1, 1);
+  w.put(best.idx[0], 3);
+  for (int i = 1; i < 16; ++i)
+    w.put(best.idx[i], 4);
+}
+
+bool decodeBC7(const uint8_t *in, Block &out) {
+  BitReader r(in);
+  if (r.get(7) != (1u << 6))
+    return false;
+  int q0[4];
+  int q1[4];
+  for (int c = 0; c < 4; ++c) {
+    q0[c] = int(r.get(7));
+    q1[c] = int(r.get(7));
+  }
+  const int p0 = int(r.get(1));
+  const int p1 = int(r.get(1));
+  for (int i = 0; i < 16; ++i) {
+    const int k = int(r.get(i == 0 ? 3 : 4));
+    for (int c = 0; c < 4; ++c) {
+      out[i][c] = uint8_t(bc7Interp((q0[c] << 1) | p0, (q1[c] << 1) | p1,
+                                    kBC7Weights[k]));
+    }
+  }
+  return true;
+}
+
+// ---- levels ----
+
+void encodeLevel(const uint8_t *img, uint32_t w, uint32_t h,
+                 TextureCodec codec, uint8_t *out) {
+  if (codec == TextureCodec::RGBA8) {
+    std::memcpy(out, img, size_t(w) * h * 4);
+    return;
+  }
+  const uint32_t bw = (w + 3) / 4;
+  const uint32_t bh = (h + 3) / 4;
+  const uint32_t stride = blockBytes(codec);
+  Block px;
+  for (uint32_t by = 0; by < bh; ++by) {
+    for (uint32_t bx = 0; bx < bw; ++bx) {
+      fetchBlock(img, w, h, bx, by, px);
+      uint8_t *dst = out + (size_t(by) * bw + bx) * stride;
+      switch (codec) {
+      case TextureCodec::BC1:
+        encodeBC1(px, dst);
+        break;
+      case TextureCodec::BC3:
+        encodeBC4(px, 3, dst);
+        encodeBC1(px, dst + 8);
+        break;
+      case TextureCodec::BC5:
+        encodeBC4(px, 0, dst);
+        encodeBC4(px, 1, dst + 8);
+        break;
+      case TextureCodec::BC7:
+        encodeBC7(px, dst);
+        break;
+      case TextureCodec::RGBA8:
+        break;
+      }
+    }
+  }
+}
+
+} // namespace
+
+const char *textureCodecName(TextureCodec codec) {
+  switch (codec) {
+  case TextureCodec::RGBA8:
+    return "RGBA8";
+  case TextureCodec::BC1:
+    return "BC1";
+  case TextureCodec::BC3:
+    return "BC3";
+  case TextureCodec::BC5:
+    return "BC5";
+  case TextureCodec::BC7:
+    return "BC7";
+  }
+  return "?";
+}
+
+uint64_t textureLevelBytes(TextureCodec codec, uint32_t w, uint32_t h) {
+  if (codec == TextureCodec::RGBA8)
+    return uint64_t(w) * h * 4u;
+  return uint64_t((w + 3) / 4) * ((h + 3) / 4) * blockBytes(codec);
+}
+
+std::string textureCookKey(const uint8_t *src, size_t size,
+                           const TextureImportSettings &settings) {
+  blake3_hasher hasher;
+  blake3_hasher_init(&hasher);
+  blake3_hasher_update(&hasher, src, size);
+  const uint8_t tail[7] = {uint8_t(settings.srgb ? 1 : 0),
+                           uint8_t(settings.compression),
+                           uint8_t(settings.mips ? 1 : 0),
+                           uint8_t(kCookVersion),
+                           uint8_t(kCookVersion >> 8),
+                           uint8_t(kCookVersion >> 16),
+                           uint8_t(kCookVersion >> 24)};
+  blake3_hasher_update(&hasher, tail, sizeof(tail));
+  uint8_t out[16];
+  blake3_hasher_finalize(&hasher, out, sizeof(out));
+
+  static constexpr char kHex[] = "0123456789abcdef";
+  std::string key(sizeof(out) * 2, '0');
+  for (size_t i = 0; i < sizeof(out); ++i) {
+    key[i * 2] = kHex[out[i] >> 4];
+    key[i * 2 + 1] = kHex[out[i] & 15];
+  }
+  return key;
+}
+
+bool cookTexture(const uint8_t *rgba8, uint32_t width, uint32_t height,
+                 const TextureImportSettings &settings, CookedTexture &out) {
+  out = {};
+  if (!rgba8 || width == 0 || height == 0)
+    return false;
+
+  const bool normalMap = !settings.srgb && isNormalMap(rgba8, width, height);
+  const bool blockAligned = width % 4 == 0 && height % 4 == 0;
+  TextureCodec codec = TextureCodec::RGBA8;
+  if (settings.compression != TextureCompression::Off && blockAligned) {
+    if (normalMap)
+      codec = TextureCodec::BC5;
+    else if (settings.compression == TextureCompression::High)
+      codec = TextureCodec::BC7;
+    else
+      codec = hasAlpha(rgba8, width, height) ? TextureCodec::BC3
+                                             : TextureCodec::BC1;
+  }
+  const MipFilter filter = settings.srgb ? MipFilter::SRGB
+                           : normalMap   ? MipFilter::Normal
+                                         : MipFilter::Linear;
+
+  out.width = width;
+  out.height = height;
+  out.codec = codec;
+  out.srgb = settings.srgb;
+  out.reconstructZ = codec == TextureCodec::BC5;
+
+  const uint32_t levels =
+      settings.mips ? uint32_t(std::bit_width(std::max(width, height))) : 1u;
+  uint64_t total = 0;
+  for (uint32_t l = 0; l < levels; ++l) {
+    CookedLevel lv{};
+    lv.width = std::max(width >> l, 1u);
+    lv.height = std::max(height >> l, 1u);
+    lv.offset = total;
+    lv.size = textureLevelBytes(codec, lv.width, lv.height);
+    total += lv.size;
+    out.levels.push_back(lv);
+  }
+  out.data.resize(total);
+
+  std::vector<uint8_t> cur(rgba8, rgba8 + size_t(width) * height * 4);
+  std::vector<uint8_t> next;
+  for (uint32_t l = 0; l < levels; ++l) {
+    const CookedLevel &lv = out.levels[l];
+    encodeLevel(cur.data(), lv.width, lv.height, codec,
+                out.data.data() + lv.offset);
+    if (l + 1 < levels) {
+      const CookedLevel &down = out.levels[l + 1];
+      downsample(cur, lv.width, lv.height, next, down.width, down.height,
+                 filter);
+      cur.swap(next);
+    }
+  }
+  return true;
+}
+
+bool writeCookedTexture(const std::filesystem::path &path,
+                        const CookedTexture &t) {
+  std::ofstream f(path, std::ios::binary | std::ios::trunc);
+  if (!f.is_open())
+    return false;
+
+  CookedFileHeader h{};
+  h.width = t.width;
+  h.height = t.height;
+  h.levels = static_cast<uint32_t>(t.levels.size());
+  h.codec = static_cast<uint8_t>(t.codec);
+  h.flags = uint8_t((t.srgb ? kFlagSRGB : 0) |
+                    (t.reconstructZ ? kFlagReconstructZ : 0));
+  h.dataBytes = t.data.size();
+  f.write(reinterpret_cast<const char *>(&h), sizeof(h));
+  for (const CookedLevel &lv : t.levels) {
+    const CookedFileLevel fl{lv.width, lv.height, lv.offset, lv.size};
+    f.write(reinterpret_cast<const char *>(&fl), sizeof(fl));
+  }
+  if (!t.data.empty())
+    f.write(reinterpret_cast<const char *>(t.data.data()),
+            static_cast<std::streamsize>(t.data.size()));
+  return bool(f);
+}
+
+bool readCookedTexture(const std::filesystem::path &path, CookedTexture &out) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f.is_open())
+    return false;
+
+  CookedFileHeader h{};
+  f.read(reinterpret_cast<char *>(&h), sizeof(h));
+  if (!f || h.magic != kCookMagic || h.version != kCookVersion ||
+      h.width == 0 || h.height == 0 || h.levels == 0 ||
+      h.levels > kMaxLevels || h.codec > uint8_t(TextureCodec::BC7))
+    return false;
+
+  CookedTexture t{};
+  t.width = h.width;
+  t.height = h.height;
+  t.codec = static_cast<TextureCodec>(h.codec);
+  t.srgb = (h.flags & kFlagSRGB) != 0;
+  t.reconstructZ = (h.flags & kFlagReconstructZ) != 0;
+
+  // Levels must be the exact chain the header implies, packed in order.
+  uint64_t expectOffset = 0;
+  for (uint32_t l = 0; l < h.levels; ++l) {
+    CookedFileLevel fl{};
+    f.read(reinterpret_cast<char *>(&fl), sizeof(fl));
+    if (!f || fl.width != std::max(h.width >> l, 1u) ||
+        fl.height != std::max(h.height >> l, 1u) ||
+        fl.offset != expectOffset ||
+        fl.size != textureLevelBytes(t.codec, fl.width, fl.height))
+      return false;
+    expectOffset += fl.size;
+    t.levels.push_back(CookedLevel{fl.width, fl.height, fl.offset, fl.size});
+  }
+  if (expectOffset != h.dataBytes)
+    return false;
+
+  t.data.resize(h.dataBytes);
+  f.read(reinterpret_cast<char *>(t.data.data()),
+         static_cast<std::streamsize>(h.dataBytes));
+  if (!f)
+    return false;
+  out = std::move(t);
+  return true;
+}
+
+bool decodeCookedLevel(const CookedTexture &t, uint32_t level,
+                       std::vector<uint8_t> &rgba8) {
+  if (level >= t.levels.size())
+    return false;
+  const CookedLevel &lv = t.levels[level];
+  if (lv.offset + lv.size > t.data.size())
+    return false;
+  const uint8_t *src = t.data.data() + lv.offset;
+  rgba8.resize(size_t(lv.width) * lv.height * 4);
+  if (t.codec == TextureCodec::RGBA8) {
+    std::memcpy(rgba8.data(), src, rgba8.size());
+    return true;
+  }
+
+  const uint32_t bw = (lv.width + 3) / 4;
+  const uint32_t bh = (lv.height + 3) / 4;
+  const uint32_t stride = blockBytes(t.codec);
+  Block px;
+  for (uint32_t by = 0; by < bh; ++by) {
+    for (uint32_t bx = 0; bx < bw; ++bx) {
+      const uint8_t *in = src + (size_t(by) * bw + bx) * stride;
+      switch (t.codec) {
+      case TextureCodec::BC1:
+        decodeBC1(in, px);
+        break;
+      case TextureCodec::BC3:
+        decodeBC1(in + 8, px);
+        decodeBC4(in, 3, px);
+        break;
+      case TextureCodec::BC5:
+        decodeBC4(in, 0, px);
+        decodeBC4(in + 8, 1, px);
+        for (auto &p : px) {
+          const float x = unorm(p[0]) * 2.0f - 1.0f;
+          const float y = unorm(p[1]) * 2.0f - 1.0f;
+          const float z = std::sqrt(std::max(1.0f - x * x - y * y, 0.0f));
+          p[2] = toUnorm8(z * 0.5f + 0.5f);
+          p[3] = 255;
+        }
+        break;
+      case TextureCodec::BC7:
+        if (!decodeBC7(in, px))
+          return false;
+        break;
+      case TextureCodec::RGBA8:
+        break;
+      }
+      storeBlock(px, rgba8.data(), lv.width, lv.height, bx, by);
+    }
+  }
+  return true;
+}
+
+bool TextureCookCache::load(const std::string &key, CookedTexture &out) const {
+  if (m_dir.empty())
+    return false;
+  return readCookedTexture(m_dir / (key + ".nyxtex"), out);
+}
+
+bool TextureCookCache::store(const std::string &key, const CookedTexture &t,
+                             uint64_t writer) const {
+  if (m_dir.empty())
+    return false;
+  const auto cachePath = m_dir / (key + ".nyxtex");
+  const auto tmpPath = m_dir / (key + ".tmp" + std::to_string(writer));
+  std::error_code ec;
+  if (!writeCookedTexture(tmpPath, t)) {
+    std::filesystem::remove(tmpPath, ec);
+    return false;
+  }
+  std::filesystem::rename(tmpPath, cachePath, ec);
+  if (ec) {
+    std::filesystem::remove(tmpPath, ec);
+    return false;
+  }
+  return true;
+}
+
+} // namespace Nyx
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Nyx {
+
+// Storage format of a cooked texture. BC1/BC3/BC7 hold color (sRGB or
+// linear), BC5 holds the XY of a unit normal map.
+enum class TextureCodec : uint8_t { RGBA8 = 0, BC1, BC3, BC5, BC7 };
+
+enum class TextureCompression : uint8_t {
+  Off = 0, // RGBA8
+  Fast,    // BC1 opaque, BC3 with alpha, BC5 normal maps
+  High,    // BC7 color, BC5 normal maps
+};
+
+// Everything besides the source bytes that changes the cooked result; part
+// of the cache key.
+struct TextureImportSettings {
+  bool srgb = false;
+  TextureCompression compression = TextureCompression::High;
+  bool mips = true;
+};
+
+struct CookedLevel {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint64_t offset = 0; // into CookedTexture::data
+  uint64_t size = 0;
+};
+
+// A texture ready for upload: every level already encoded, base level
+// first.
+struct CookedTexture {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  TextureCodec codec = TextureCodec::RGBA8;
+  bool srgb = false;
+  // BC5 keeps only XY; samplers rebuild Z (include/MaterialTextures.glsl).
+  bool reconstructZ = false;
+  std::vector<CookedLevel> levels;
+  std::vector<uint8_t> data;
+};
+
+const char *textureCodecName(TextureCodec codec);
+// Bytes of one `w` x `h` level, including partial edge blocks.
+uint64_t textureLevelBytes(TextureCodec codec, uint32_t w, uint32_t h);
+
+// blake3 of the source file bytes, the settings and the cooked format
+// version, as 32 hex digits. Independent of path and mtime, so touching or
+// moving a file keeps its cache entry.
+std::string textureCookKey(const uint8_t *src, size_t size,
+                           const TextureImportSettings &settings);
+
+// Builds the mip chain from RGBA8 (box filter; in linear light for sRGB,
+// renormalized for normal maps) and encodes every level. Compression picks
+// BC5 for images whose texels are all unit normals, and falls back to RGBA8
+// unless both sides are a multiple of 4.
+bool cookTexture(const uint8_t *rgba8, uint32_t width, uint32_t height,
+                 const TextureImportSettings &settings, CookedTexture &out);
+
+bool writeCookedTexture(const std::filesystem::path &path,
+                        const CookedTexture &t);
+bool readCookedTexture(const std::filesystem::path &path, CookedTexture &out);
+
+// Decodes one level back to RGBA8, with Z rebuilt for BC5. Handles every
+// block cookTexture() writes (BC7: mode 6 only).
+bool decodeCookedLevel(const CookedTexture &t, uint32_t level,
+                       std::vector<uint8_t> &rgba8);
+
+// Cooked textures on disk, one <textureCookKey>.nyxtex per entry. Safe to
+// use from several threads; no directory means every load misses.
+class TextureCookCache final {
+public:
+  void setDirectory(std::filesystem::path dir) { m_dir = std::move(dir); }
+  const std::filesystem::path &directory() const { return m_dir; }
+
+  // False on a miss or an entry readCookedTexture() rejects.
+  bool load(const std::string &key, CookedTexture &out) const;
+  // Writes a temp file named after `writer` and renames it into place, so
+  // two writers of the same key never leave a torn entry.
+  bool store(const std::string &key, const CookedTexture &t,
+             uint64_t writer) const;
+
+private:
+  std::filesystem::path m_dir;
+};
+
+} // namespace Nyx
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace Nyx {
+
+// Layer bookkeeping of one TextureTable array pool, apart from its GL
+// storage. Freed layers are handed out again before fresh ones; a full pool
+// grows by doubling, starting at kInitialLayers.
+struct TexturePoolLayers final {
+  static constexpr uint32_t kInitialLayers = 4;
+  static constexpr uint32_t None = 0xFFFFFFFFu;
+
+  uint32_t capacity = 0; // allocated layers
+  uint32_t used = 0;     // layers ever handed out
+  std::vector<uint32_t> freeLayers;
+
+  // A layer to load into, or None if the pool has to grow first.
+  uint32_t take() {
+    if (!freeLayers.empty()) {
+      const uint32_t layer = freeLayers.back();
+      freeLayers.pop_back();
+      return layer;
+    }
+    return used < capacity ? used++ : None;
+  }
+  void release(uint32_t layer) { freeLayers.push_back(layer); }
+
+  // Capacity for the next growth, clamped to `maxLayers`; equal to
+  // `capacity` once the pool cannot grow.
+  uint32_t nextCapacity(uint32_t maxLayers) const {
+    return std::min(capacity ? capacity * 2u : kInitialLayers, maxLayers);
+  }
+  uint32_t live() const { return used - (uint32_t)freeLayers.size(); }
+};
+
+// Layer shape of a pool. Pools hold power-of-two size classes: a texture
+// fills the top-left w x h of a layer in the class its sides round up to,
+// and its slot carries the UV scale. A mipped class keeps one level fewer
+// than a full chain, which every texture rounding up to it still has.
+struct TexturePoolClass final {
+  uint32_t w = 0;
+  uint32_t h = 0;
+  uint32_t levels = 1;
+};
+
+inline TexturePoolClass texturePoolClass(uint32_t w, uint32_t h,
+                                         uint32_t levels) {
+  TexturePoolClass c;
+  c.w = std::bit_ceil(std::max(w, 1u));
+  c.h = std::bit_ceil(std::max(h, 1u));
+  if (levels > 1u)
+    c.levels = std::max(uint32_t(std::bit_width(std::max(c.w, c.h))) - 1u, 1u);
+  return c;
+}
+
+// First level of a w x h texture with `levels` mips from which it fits
+// `pool`, or TexturePoolLayers::None. 0 in its own class; higher when the
+// pool is smaller and the texture has to drop its top mips to share it.
+inline uint32_t texturePoolBaseLevel(const TexturePoolClass &pool, uint32_t w,
+                                     uint32_t h, uint32_t levels) {
+  for (uint32_t b = 0; b < levels && levels - b >= pool.levels; ++b) {
+    if (std::max(w >> b, 1u) <= pool.w && std::max(h >> b, 1u) <= pool.h)
+      return b;
+  }
+  return TexturePoolLayers::None;
+}
+
+} // namespace Nyx
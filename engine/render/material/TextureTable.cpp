@@ -1,10 +1,13 @@
 #include "render/material/TextureTable.h"
 #include "core/Log.h"
+#include "core/Profiler.h"
 #include "render/gl/GLResources.h"
+#include "render/gl/GLUploadRing.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <fstream>
-#include <sstream>
 
 #include <glad/glad.h>
 #include <stb_image.h>
@@ -12,51 +15,119 @@
 namespace Nyx {
 
 namespace {
-constexpr uint32_t kCacheMagic = 0x4E595854; // 'NYXT'
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t kMaxDecodeThreads = 16;
+
+// EXT_texture_compression_s3tc / EXT_texture_sRGB; the glad loader carries
+// no extensions.
+constexpr GLenum kRGB_S3TC_DXT1 = 0x83F0;
+constexpr GLenum kRGBA_S3TC_DXT5 = 0x83F3;
+constexpr GLenum kSRGB_S3TC_DXT1 = 0x8C4C;
+constexpr GLenum kSRGB_ALPHA_S3TC_DXT5 = 0x8C4F;
+
+static GLenum poolFormat(TextureCodec codec, bool srgb) {
+  switch (codec) {
+  case TextureCodec::BC1:
+    return srgb ? kSRGB_S3TC_DXT1 : kRGB_S3TC_DXT1;
+  case TextureCodec::BC3:
+    return srgb ? kSRGB_ALPHA_S3TC_DXT5 : kRGBA_S3TC_DXT5;
+  case TextureCodec::BC5:
+    return GL_COMPRESSED_RG_RGTC2;
+  case TextureCodec::BC7:
+    return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+                : GL_COMPRESSED_RGBA_BPTC_UNORM;
+  case TextureCodec::RGBA8:
+    break;
+  }
+  return srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+}
 
-struct CacheHeader {
-  uint32_t magic = kCacheMagic;
-  uint32_t w = 0;
-  uint32_t h = 0;
-  uint32_t size = 0;
-};
+static bool hasS3TC() {
+  bool s3tc = false;
+  bool srgb = false;
+  GLint n = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &n);
+  for (GLint i = 0; i < n; ++i) {
+    const char *ext = reinterpret_cast<const char *>(
+        glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+    if (!ext)
+      continue;
+    s3tc |= std::strcmp(ext, "GL_EXT_texture_compression_s3tc") == 0;
+    srgb |= std::strcmp(ext, "GL_EXT_texture_sRGB") == 0;
+  }
+  return s3tc && srgb;
+}
 
-static std::string cacheKey(const std::string &path, bool srgb) {
-  std::error_code ec;
-  auto ftime = std::filesystem::last_write_time(path, ec);
-  std::uint64_t ts = ec ? 0u : static_cast<std::uint64_t>(ftime.time_since_epoch().count());
-  std::ostringstream ss;
-  ss << path << "|" << ts << "|" << (srgb ? 1 : 0);
-  return ss.str();
+static bool readFile(const std::string &path, std::vector<uint8_t> &out) {
+  std::ifstream f(path, std::ios::binary | std::ios::ate);
+  if (!f.is_open())
+    return false;
+  const std::streamsize size = f.tellg();
+  if (size <= 0)
+    return false;
+  out.resize(static_cast<size_t>(size));
+  f.seekg(0);
+  f.read(reinterpret_cast<char *>(out.data()), size);
+  return bool(f);
 }
 
-static std::string hashHex(const std::string &s) {
-  const std::uint64_t h = std::hash<std::string>{}(s);
-  std::ostringstream ss;
-  ss << std::hex << h;
-  return ss.str();
+// unorm16 x2, as unpackUnorm2x16() reads it in MaterialTextures.glsl.
+static uint32_t packUVScale(uint32_t w, uint32_t poolW, uint32_t h,
+                            uint32_t poolH) {
+  if (w == poolW && h == poolH)
+    return TextureTable::kSlotFullUV;
+  const auto unorm16 = [](uint32_t n, uint32_t d) {
+    return static_cast<uint32_t>((uint64_t(n) * 65535u + d / 2u) / d);
+  };
+  return unorm16(w, poolW) | (unorm16(h, poolH) << 16);
+}
+
+static void setSamplerParams(uint32_t tex) {
+  glTextureParameteri(tex, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glTextureParameteri(tex, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTextureParameteri(tex, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTextureParameteri(tex, GL_TEXTURE_WRAP_T, GL_REPEAT);
 }
 } // namespace
 
-void TextureTable::init(GLResources &gl) {
+void TextureTable::init(GLResources &gl, GLUploadRing &upload) {
   m_gl = &gl;
+  m_upload = &upload;
   m_entries.clear();
-  m_textures.clear();
+  m_pools.clear();
+  m_slots.clear();
   m_index.clear();
+  m_slotsDirty = true;
+  m_stats = {};
+  m_arrived.clear();
+  m_frame = 0;
+  m_pending = 0;
+
+  glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &m_maxLayers);
+  m_hasS3TC = hasS3TC();
+  m_cacheHits = 0;
+  m_cooks = 0;
+  if (!m_slotBuffer)
+    glCreateBuffers(1, &m_slotBuffer);
 
   m_placeholderLinear = createPlaceholder(false);
   m_placeholderSRGB = createPlaceholder(true);
 
-  m_cacheDir = std::filesystem::current_path() / ".cache" / "texcache";
+  const auto cacheDir =
+      std::filesystem::current_path() / ".cache" / "texcache";
   std::error_code ec;
-  std::filesystem::create_directories(m_cacheDir, ec);
+  std::filesystem::create_directories(cacheDir, ec);
+  m_cache.setDirectory(cacheDir);
 
-  startWorker();
+  startWorkers();
 }
 
 void TextureTable::shutdown() {
-  stopWorker();
+  stopWorkers();
   clearQueues();
+  m_arrived.clear();
+  m_pending = 0;
 
   for (const Entry &entry : m_entries) {
     if (entry.glTex != 0 && entry.glTex != m_placeholderLinear &&
@@ -64,6 +135,13 @@ void TextureTable::shutdown() {
       glDeleteTextures(1, &entry.glTex);
     }
   }
+  for (const Pool &pool : m_pools)
+    glDeleteTextures(1, &pool.tex);
+  if (m_slotBuffer) {
+    glDeleteBuffers(1, &m_slotBuffer);
+    m_slotBuffer = 0;
+  }
+  m_slotCapacity = 0;
   if (m_placeholderLinear) {
     glDeleteTextures(1, &m_placeholderLinear);
     m_placeholderLinear = 0;
@@ -74,9 +152,11 @@ void TextureTable::shutdown() {
   }
 
   m_entries.clear();
-  m_textures.clear();
+  m_pools.clear();
+  m_slots.clear();
   m_index.clear();
   m_gl = nullptr;
+  m_upload = nullptr;
 }
 
 int TextureTable::find(const std::string &path, bool srgb) const {
@@ -87,37 +167,68 @@ int TextureTable::find(const std::string &path, bool srgb) const {
   return static_cast<int>(it->second);
 }
 
-uint32_t TextureTable::getOrCreate2D(const std::string &path, bool srgb) {
+uint32_t TextureTable::getOrCreate2D(const std::string &path, bool srgb,
+                                     TexturePriority prio) {
   if (!m_gl || path.empty())
     return Invalid;
 
-  if (int idx = find(path, srgb); idx >= 0)
+  if (int idx = find(path, srgb); idx >= 0) {
+    request(static_cast<uint32_t>(idx), prio);
     return static_cast<uint32_t>(idx);
+  }
 
   Entry e{};
   e.path = path;
   e.srgb = srgb;
   e.glTex = srgb ? m_placeholderSRGB : m_placeholderLinear;
-  e.loading = true;
-  e.failed = false;
+  e.prio = prio;
 
   const uint32_t idx = static_cast<uint32_t>(m_entries.size());
   m_entries.push_back(std::move(e));
-  m_textures.push_back(m_entries.back().glTex);
+  m_slots.push_back(GpuSlot{});
+  m_slotsDirty = true;
   m_index[Key{path, srgb}] = idx;
 
-  enqueue(idx, path, srgb);
+  enqueue(idx);
 
   return idx;
 }
 
-void TextureTable::bindAll(uint32_t firstUnit, uint32_t maxCount) const {
-  size_t count = m_textures.size();
-  if (maxCount > 0 && count > maxCount)
-    count = maxCount;
-  for (size_t i = 0; i < count; ++i) {
-    glBindTextureUnit(firstUnit + static_cast<uint32_t>(i), m_textures[i]);
+void TextureTable::request(uint32_t texIndex, TexturePriority prio) {
+  if (texIndex == Invalid || texIndex >= m_entries.size() || !m_gl)
+    return;
+
+  Entry &e = m_entries[texIndex];
+  if (e.wantFrame != m_frame) {
+    e.wantFrame = m_frame;
+    e.prio = prio;
+  } else if (prio < e.prio) {
+    e.prio = prio;
   }
+  if (e.cancelled)
+    enqueue(texIndex);
+}
+
+void TextureTable::setDecodeThreads(uint32_t count) {
+  m_requestedThreads = count;
+  if (!m_gl)
+    return;
+  stopWorkers();
+  startWorkers();
+}
+
+void TextureTable::bind() {
+  const Clock::time_point start = Clock::now();
+
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kSlotsBinding, m_slotBuffer);
+  uint32_t units[kMaxPools] = {};
+  for (size_t i = 0; i < m_pools.size(); ++i)
+    units[i] = m_pools[i].tex;
+  glBindTextures(kFirstPoolUnit, kMaxPools, units);
+
+  ++m_frameBinds;
+  m_frameBindMs +=
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
 }
 
 bool TextureTable::reloadByIndex(uint32_t texIndex) {
@@ -128,99 +239,270 @@ bool TextureTable::reloadByIndex(uint32_t texIndex) {
   if (e.loading)
     return false;
 
-  if (e.glTex != 0 && e.glTex != m_placeholderLinear &&
-      e.glTex != m_placeholderSRGB) {
-    glDeleteTextures(1, &e.glTex);
-  }
-  e.glTex = e.srgb ? m_placeholderSRGB : m_placeholderLinear;
-  e.loading = true;
-  e.failed = false;
-  if (texIndex < m_textures.size())
-    m_textures[texIndex] = e.glTex;
+  releaseTexture(e);
+  setSlot(texIndex, e);
 
-  enqueue(texIndex, e.path, e.srgb);
+  enqueue(texIndex);
   return true;
 }
 
-void TextureTable::processUploads(uint32_t maxPerFrame) {
-  uint32_t budget = maxPerFrame;
-  while (budget > 0) {
-    Loaded t{};
-    {
-      std::lock_guard<std::mutex> lock(m_mutex);
-      if (m_ready.empty())
-        return;
-      t = std::move(m_ready.front());
-      m_ready.pop();
-    }
+void TextureTable::processUploads() {
+  NYX_PROFILE_SCOPE("TextureTable::processUploads");
+  m_stats.bindsLastFrame = m_frameBinds;
+  m_stats.bindMsLastFrame = m_frameBindMs;
+  m_frameBinds = 0;
+  m_frameBindMs = 0.0;
 
-    if (t.index == Invalid || t.index >= m_entries.size())
-      continue;
+  cancelUnrequested();
+  reprioritizeJobs();
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Loaded &t : m_ready)
+      m_arrived.push_back(std::move(t));
+    m_ready.clear();
+    m_stats.queued = static_cast<uint32_t>(m_jobs.size());
+    m_stats.decoding = static_cast<uint32_t>(m_inFlight.size());
+  }
 
+  // Drop results of cancelled or restarted loads; failed decodes finish
+  // here without spending budget.
+  size_t kept = 0;
+  for (size_t i = 0; i < m_arrived.size(); ++i) {
+    Loaded &t = m_arrived[i];
+    if (t.index >= m_entries.size())
+      continue;
     Entry &e = m_entries[t.index];
-    if (e.path != t.path || e.srgb != t.srgb)
+    if (!e.loading || e.ticket != t.ticket)
       continue;
-
     if (!t.ok) {
+      finishLoad(e);
       e.failed = true;
-      e.loading = false;
       continue;
     }
+    if (kept != i)
+      m_arrived[kept] = std::move(t);
+    ++kept;
+  }
+  m_arrived.resize(kept);
+  std::stable_sort(m_arrived.begin(), m_arrived.end(),
+                   [&](const Loaded &a, const Loaded &b) {
+                     return m_entries[a.index].prio < m_entries[b.index].prio;
+                   });
+
+  const Clock::time_point start = Clock::now();
+  uint32_t uploads = 0;
+  uint64_t bytes = 0;
+  double ms = 0.0;
+  size_t done = 0;
+  for (; done < m_arrived.size(); ++done) {
+    if (uploads > 0 && (bytes >= m_budget.bytes || ms >= m_budget.ms))
+      break;
+    const Loaded &t = m_arrived[done];
+    Entry &e = m_entries[t.index];
+    releaseTexture(e);
+    finishLoad(e);
+    e.failed = !uploadTexture(t.index, t);
+    setSlot(t.index, e);
+
+    ++uploads;
+    bytes += t.cooked.data.size();
+    ms = std::chrono::duration<double, std::milli>(Clock::now() - start)
+             .count();
+  }
+  m_arrived.erase(m_arrived.begin(),
+                  m_arrived.begin() + static_cast<std::ptrdiff_t>(done));
+
+  m_stats.waiting = static_cast<uint32_t>(m_arrived.size());
+  m_stats.cacheHits = m_cacheHits;
+  m_stats.cooked = m_cooks;
+  m_stats.uploadsLastFrame = uploads;
+  m_stats.uploadBytesLastFrame = bytes;
+  m_stats.uploadMsLastFrame = ms;
+  ++m_frame;
+
+  if (m_slotsDirty)
+    flushSlots();
+}
 
-    uint32_t newTex = uploadTexture(t);
-    if (newTex == 0) {
-      e.failed = true;
-      e.loading = false;
+// A load is unrequested once no getOrCreate2D()/request() has touched it for
+// kCancelAfterFrames frames, i.e. no material or editor view refers to it.
+void TextureTable::cancelUnrequested() {
+  if (m_pending == 0)
+    return;
+
+  std::vector<uint64_t> tickets;
+  for (Entry &e : m_entries) {
+    if (!e.loading || m_frame - e.wantFrame <= kCancelAfterFrames)
       continue;
-    }
+    tickets.push_back(e.ticket);
+    finishLoad(e);
+    e.cancelled = true;
+    ++m_stats.cancelled;
+  }
+  if (tickets.empty())
+    return;
 
-    if (e.glTex != 0 && e.glTex != m_placeholderLinear &&
-        e.glTex != m_placeholderSRGB) {
-      glDeleteTextures(1, &e.glTex);
+  std::sort(tickets.begin(), tickets.end());
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::erase_if(m_jobs, [&](const Job &j) {
+    return std::binary_search(tickets.begin(), tickets.end(), j.ticket);
+  });
+  for (uint64_t ticket : tickets) {
+    if (auto it = m_inFlight.find(ticket); it != m_inFlight.end())
+      it->second = true;
+  }
+}
+
+// Copies entry priorities (which change as materials scroll on and off
+// screen) onto their queued jobs and restores the queue order.
+void TextureTable::reprioritizeJobs() {
+  if (m_pending == 0)
+    return;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  bool changed = false;
+  for (Job &j : m_jobs) {
+    const TexturePriority prio = m_entries[j.index].prio;
+    if (j.prio != prio) {
+      j.prio = prio;
+      changed = true;
     }
-    e.glTex = newTex;
-    e.loading = false;
-    if (t.index < m_textures.size())
-      m_textures[t.index] = newTex;
+  }
+  if (changed) {
+    std::sort(m_jobs.begin(), m_jobs.end(), [](const Job &a, const Job &b) {
+      return a.prio != b.prio ? a.prio < b.prio : a.ticket < b.ticket;
+    });
+  }
+}
+
+void TextureTable::finishLoad(Entry &e) {
+  e.loading = false;
+  --m_pending;
+}
+
+void TextureTable::flushSlots() {
+  const Clock::time_point start = Clock::now();
 
-    budget -= 1;
+  // No slack: shaders bound-check slot indices against length().
+  const size_t bytes = m_slots.size() * sizeof(GpuSlot);
+  if (bytes != m_slotCapacity) {
+    m_slotCapacity = static_cast<uint32_t>(bytes);
+    glNamedBufferData(m_slotBuffer, m_slotCapacity, nullptr, GL_STATIC_DRAW);
   }
+  if (bytes > 0)
+    m_upload->uploadToBuffer(m_slotBuffer, 0, m_slots.data(), bytes);
+  m_slotsDirty = false;
+  ++m_stats.slotUploads;
+  updateStats();
+
+  m_frameBindMs +=
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
 }
 
-void TextureTable::startWorker() {
-  if (m_worker.joinable())
+void TextureTable::setSlot(uint32_t index, const Entry &e) {
+  if (index >= m_slots.size())
     return;
+  m_slots[index] =
+      GpuSlot{e.pool, e.layer | (e.reconstructZ ? kSlotReconstructZ : 0u),
+              e.uvScale};
+  m_slotsDirty = true;
+}
+
+void TextureTable::updateStats() {
+  m_stats.textures = static_cast<uint32_t>(m_entries.size());
+  m_stats.resident = 0;
+  m_stats.unpooled = 0;
+  m_stats.downscaled = 0;
+  for (const Entry &e : m_entries) {
+    if (e.pool != Invalid)
+      ++m_stats.resident;
+    if (e.unpooled)
+      ++m_stats.unpooled;
+    if (e.downscaled)
+      ++m_stats.downscaled;
+  }
+  m_stats.pools = 0;
+  m_stats.poolLayers = 0;
+  m_stats.poolBytes = 0;
+  for (const Pool &pool : m_pools) {
+    if (pool.tex == 0)
+      continue;
+    ++m_stats.pools;
+    m_stats.poolLayers += pool.layers.capacity;
+    uint64_t layerBytes = 0;
+    for (uint32_t l = 0; l < pool.levels; ++l) {
+      layerBytes += textureLevelBytes(pool.codec, std::max(pool.w >> l, 1u),
+                                      std::max(pool.h >> l, 1u));
+    }
+    m_stats.poolBytes += layerBytes * pool.layers.capacity;
+  }
+}
+
+void TextureTable::startWorkers() {
+  if (!m_workers.empty())
+    return;
+  uint32_t count = m_requestedThreads;
+  if (count == 0) {
+    const uint32_t hw = std::thread::hardware_concurrency();
+    count = hw > 1 ? hw - 1 : 1;
+  }
+  count = std::min(count, kMaxDecodeThreads);
+
   m_stop = false;
-  m_worker = std::thread([this] { workerLoop(); });
+  for (uint32_t i = 0; i < count; ++i)
+    m_workers.emplace_back([this] { workerLoop(); });
+  m_stats.decodeThreads = count;
 }
 
-void TextureTable::stopWorker() {
-  if (!m_worker.joinable())
+// Threads finish the decode they are on; queued jobs stay for the next pool.
+void TextureTable::stopWorkers() {
+  if (m_workers.empty())
     return;
   {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_stop = true;
   }
   m_cv.notify_all();
-  m_worker.join();
+  for (std::thread &t : m_workers)
+    t.join();
+  m_workers.clear();
+  m_stats.decodeThreads = 0;
 }
 
 void TextureTable::clearQueues() {
   std::lock_guard<std::mutex> lock(m_mutex);
-  std::queue<Job> emptyJobs;
-  std::swap(m_jobs, emptyJobs);
-  std::queue<Loaded> emptyReady;
-  std::swap(m_ready, emptyReady);
+  m_jobs.clear();
+  m_ready.clear();
+  m_inFlight.clear();
 }
 
-void TextureTable::enqueue(uint32_t index, const std::string &path, bool srgb) {
+void TextureTable::enqueue(uint32_t index) {
+  Entry &e = m_entries[index];
+  e.loading = true;
+  e.failed = false;
+  e.cancelled = false;
+  e.ticket = m_nextTicket++;
+  e.wantFrame = m_frame;
+  ++m_pending;
+
   Job j{};
   j.index = index;
-  j.path = path;
-  j.srgb = srgb;
+  j.path = e.path;
+  j.settings.srgb = e.srgb;
+  j.settings.compression =
+      (m_compression == TextureCompression::Fast && !m_hasS3TC)
+          ? TextureCompression::High
+          : m_compression;
+  j.prio = e.prio;
+  j.ticket = e.ticket;
   {
     std::lock_guard<std::mutex> lock(m_mutex);
-    m_jobs.push(std::move(j));
+    // Tickets only grow, so this keeps the (prio, ticket) order.
+    const auto at = std::upper_bound(
+        m_jobs.begin(), m_jobs.end(), j.prio,
+        [](TexturePriority p, const Job &q) { return p < q.prio; });
+    m_jobs.insert(at, std::move(j));
   }
   m_cv.notify_one();
 }
@@ -238,73 +520,224 @@ uint32_t TextureTable::createPlaceholder(bool srgb) const {
   return tex;
 }
 
-uint32_t TextureTable::uploadTexture(const Loaded &t) {
-  if (t.w <= 0 || t.h <= 0 || t.rgba.empty())
-    return 0;
-  uint32_t glTex = 0;
-  glCreateTextures(GL_TEXTURE_2D, 1, &glTex);
-  glTextureStorage2D(glTex, 1, t.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, t.w, t.h);
-  glTextureSubImage2D(glTex, 0, 0, 0, t.w, t.h, GL_RGBA, GL_UNSIGNED_BYTE,
-                      t.rgba.data());
-  glGenerateTextureMipmap(glTex);
-  glTextureParameteri(glTex, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-  glTextureParameteri(glTex, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTextureParameteri(glTex, GL_TEXTURE_WRAP_S, GL_REPEAT);
-  glTextureParameteri(glTex, GL_TEXTURE_WRAP_T, GL_REPEAT);
-  return glTex;
-}
-
-bool TextureTable::loadFromCache(const std::string &path, bool srgb,
-                                 Loaded &out) const {
-  if (m_cacheDir.empty())
+bool TextureTable::uploadTexture(uint32_t index, const Loaded &t) {
+  const CookedTexture &c = t.cooked;
+  if (c.width == 0 || c.height == 0 || c.levels.empty())
     return false;
-  const std::string key = hashHex(cacheKey(path, srgb));
-  const auto cachePath = m_cacheDir / (key + ".bin");
 
-  std::ifstream f(cachePath, std::ios::binary);
-  if (!f.is_open())
+  Entry &e = m_entries[index];
+  uint32_t base = 0;
+  const uint32_t poolIndex = findOrCreatePool(c, base);
+  uint32_t layer = 0;
+  if (poolIndex == Invalid || !allocLayer(poolIndex, layer)) {
+    Log::Error("TextureTable: no pool for {}x{} {} texture '{}'; it will "
+               "not be drawn",
+               c.width, c.height, textureCodecName(c.codec), t.path);
+    e.unpooled = true;
     return false;
+  }
+  const Pool &pool = m_pools[poolIndex];
+  if (base > 0) {
+    Log::Warn("TextureTable: all {} pools in use; '{}' shares a {}x{} pool "
+              "from mip {}",
+              kMaxPools, t.path, pool.w, pool.h, base);
+  }
 
-  CacheHeader h{};
-  f.read(reinterpret_cast<char *>(&h), sizeof(h));
-  if (!f || h.magic != kCacheMagic || h.w == 0 || h.h == 0 || h.size == 0)
-    return false;
-  if (h.size != h.w * h.h * 4)
+  // The view covers just this layer, so level uploads leave the rest of
+  // the pool alone; it doubles as the editor's 2D handle.
+  const uint32_t view = createLayerView(pool, layer);
+  const GLenum format = poolFormat(c.codec, c.srgb);
+  for (uint32_t l = 0; l < pool.levels; ++l) {
+    const CookedLevel &lv = c.levels[base + l];
+    const uint8_t *data = c.data.data() + lv.offset;
+    GLsizei w = static_cast<GLsizei>(lv.width);
+    GLsizei h = static_cast<GLsizei>(lv.height);
+    if (c.codec == TextureCodec::RGBA8) {
+      glTextureSubImage2D(view, static_cast<GLint>(l), 0, 0, w, h, GL_RGBA,
+                          GL_UNSIGNED_BYTE, data);
+    } else {
+      // A partial block is only legal where it ends the pool level; the
+      // cooked level already carries the padding.
+      const GLsizei poolW = static_cast<GLsizei>(std::max(pool.w >> l, 1u));
+      const GLsizei poolH = static_cast<GLsizei>(std::max(pool.h >> l, 1u));
+      w = std::min((w + 3) & ~3, poolW);
+      h = std::min((h + 3) & ~3, poolH);
+      glCompressedTextureSubImage2D(view, static_cast<GLint>(l), 0, 0, w, h,
+                                    format, static_cast<GLsizei>(lv.size),
+                                    data);
+    }
+  }
+
+  const CookedLevel &top = c.levels[base];
+  e.glTex = view;
+  e.pool = poolIndex;
+  e.layer = layer;
+  e.reconstructZ = c.reconstructZ;
+  e.uvScale = packUVScale(top.width, pool.w, top.height, pool.h);
+  e.downscaled = base > 0;
+  return true;
+}
+
+void TextureTable::releaseTexture(Entry &e) {
+  if (e.pool != Invalid) {
+    Pool &pool = m_pools[e.pool];
+    pool.layers.release(e.layer);
+    if (e.glTex != 0)
+      glDeleteTextures(1, &e.glTex);
+    if (pool.layers.live() == 0) {
+      glDeleteTextures(1, &pool.tex);
+      pool = Pool{};
+    }
+  }
+  e.glTex = e.srgb ? m_placeholderSRGB : m_placeholderLinear;
+  e.pool = Invalid;
+  e.layer = 0;
+  e.reconstructZ = false;
+  e.uvScale = kSlotFullUV;
+  e.unpooled = false;
+  e.downscaled = false;
+}
+
+// The texture's own size class if it has a pool or a unit is free for one;
+// otherwise the pool of the same format it loses the fewest mips to,
+// smallest first. `baseLevel` is the texture level uploaded as level 0.
+uint32_t TextureTable::findOrCreatePool(const CookedTexture &t,
+                                        uint32_t &baseLevel) {
+  const uint32_t levels = static_cast<uint32_t>(t.levels.size());
+  const TexturePoolClass want = texturePoolClass(t.width, t.height, levels);
+  baseLevel = 0;
+  uint32_t unit = Invalid;
+  for (uint32_t i = 0; i < m_pools.size(); ++i) {
+    const Pool &p = m_pools[i];
+    if (p.tex == 0) {
+      unit = std::min(unit, i);
+      continue;
+    }
+    if (p.w == want.w && p.h == want.h && p.levels == want.levels &&
+        p.codec == t.codec && p.srgb == t.srgb)
+      return i;
+  }
+  if (unit == Invalid && m_pools.size() < kMaxPools) {
+    unit = static_cast<uint32_t>(m_pools.size());
+    m_pools.emplace_back();
+  }
+
+  if (unit != Invalid) {
+    Pool &pool = m_pools[unit];
+    pool.w = want.w;
+    pool.h = want.h;
+    pool.codec = t.codec;
+    pool.srgb = t.srgb;
+    pool.levels = want.levels;
+    if (growPool(unit, TexturePoolLayers::kInitialLayers))
+      return unit;
+    pool = Pool{};
+    return Invalid;
+  }
+
+  uint32_t best = Invalid;
+  for (uint32_t i = 0; i < m_pools.size(); ++i) {
+    const Pool &p = m_pools[i];
+    if (p.codec != t.codec || p.srgb != t.srgb ||
+        p.layers.live() >= static_cast<uint32_t>(m_maxLayers))
+      continue;
+    const uint32_t base =
+        texturePoolBaseLevel({p.w, p.h, p.levels}, t.width, t.height, levels);
+    if (base == TexturePoolLayers::None)
+      continue;
+    if (best == Invalid || base < baseLevel ||
+        (base == baseLevel &&
+         uint64_t(p.w) * p.h < uint64_t(m_pools[best].w) * m_pools[best].h)) {
+      best = i;
+      baseLevel = base;
+    }
+  }
+  return best;
+}
+
+bool TextureTable::allocLayer(uint32_t poolIndex, uint32_t &outLayer) {
+  TexturePoolLayers &layers = m_pools[poolIndex].layers;
+  outLayer = layers.take();
+  if (outLayer != TexturePoolLayers::None)
+    return true;
+  if (!growPool(poolIndex,
+                layers.nextCapacity(static_cast<uint32_t>(m_maxLayers))))
     return false;
+  outLayer = layers.take();
+  return true;
+}
 
-  out.rgba.resize(h.size);
-  f.read(reinterpret_cast<char *>(out.rgba.data()), h.size);
-  if (!f)
+// Reallocates the pool with room for `capacity` layers and moves the used
+// layers over. Layer views alias the old storage, so they are recreated.
+bool TextureTable::growPool(uint32_t poolIndex, uint32_t capacity) {
+  Pool &pool = m_pools[poolIndex];
+  capacity = std::min(capacity, static_cast<uint32_t>(m_maxLayers));
+  if (capacity <= pool.layers.capacity)
     return false;
 
-  out.w = static_cast<int>(h.w);
-  out.h = static_cast<int>(h.h);
-  out.ok = true;
+  uint32_t tex = 0;
+  glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &tex);
+  glTextureStorage3D(tex, static_cast<GLsizei>(pool.levels),
+                     poolFormat(pool.codec, pool.srgb),
+                     static_cast<GLsizei>(pool.w),
+                     static_cast<GLsizei>(pool.h),
+                     static_cast<GLsizei>(capacity));
+  setSamplerParams(tex);
+
+  if (pool.tex != 0) {
+    if (pool.layers.used > 0) {
+      for (uint32_t l = 0; l < pool.levels; ++l) {
+        glCopyImageSubData(pool.tex, GL_TEXTURE_2D_ARRAY, l, 0, 0, 0, tex,
+                           GL_TEXTURE_2D_ARRAY, l, 0, 0, 0,
+                           static_cast<GLsizei>(std::max(pool.w >> l, 1u)),
+                           static_cast<GLsizei>(std::max(pool.h >> l, 1u)),
+                           static_cast<GLsizei>(pool.layers.used));
+      }
+    }
+    glDeleteTextures(1, &pool.tex);
+  }
+  pool.tex = tex;
+  pool.layers.capacity = capacity;
+
+  for (Entry &e : m_entries) {
+    if (e.pool != poolIndex)
+      continue;
+    glDeleteTextures(1, &e.glTex);
+    e.glTex = createLayerView(pool, e.layer);
+  }
   return true;
 }
 
-void TextureTable::writeCache(const Loaded &t) const {
-  if (m_cacheDir.empty() || !t.ok || t.w <= 0 || t.h <= 0)
-    return;
-
-  const std::string key = hashHex(cacheKey(t.path, t.srgb));
-  const auto cachePath = m_cacheDir / (key + ".bin");
+uint32_t TextureTable::createLayerView(const Pool &pool, uint32_t layer) const {
+  uint32_t view = 0;
+  glGenTextures(1, &view);
+  glTextureView(view, GL_TEXTURE_2D, pool.tex,
+                poolFormat(pool.codec, pool.srgb), 0, pool.levels, layer, 1);
+  setSamplerParams(view);
+  return view;
+}
 
-  std::ofstream f(cachePath, std::ios::binary | std::ios::trunc);
-  if (!f.is_open())
-    return;
+bool TextureTable::isCancelled(uint64_t ticket) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto it = m_inFlight.find(ticket);
+  return it != m_inFlight.end() && it->second;
+}
 
-  CacheHeader h{};
-  h.w = static_cast<uint32_t>(t.w);
-  h.h = static_cast<uint32_t>(t.h);
-  h.size = static_cast<uint32_t>(t.rgba.size());
+bool TextureTable::loadFromCache(const std::string &key,
+                                 CookedTexture &out) const {
+  return m_cacheEnabled && m_cache.load(key, out);
+}
 
-  f.write(reinterpret_cast<const char *>(&h), sizeof(h));
-  if (h.size)
-    f.write(reinterpret_cast<const char *>(t.rgba.data()), h.size);
+void TextureTable::writeCache(const std::string &key, const CookedTexture &t,
+                              uint64_t ticket) const {
+  // A restarted load can overlap a cancelled one still cooking the same
+  // file; the ticket keeps their temp files apart.
+  if (m_cacheEnabled)
+    m_cache.store(key, t, ticket);
 }
 
 void TextureTable::workerLoop() {
+  std::vector<uint8_t> src;
   for (;;) {
     Job job{};
     {
@@ -313,32 +746,57 @@ void TextureTable::workerLoop() {
       if (m_stop)
         return;
       job = std::move(m_jobs.front());
-      m_jobs.pop();
+      m_jobs.pop_front();
+      m_inFlight[job.ticket] = false;
     }
 
     Loaded t{};
     t.index = job.index;
+    t.ticket = job.ticket;
     t.path = job.path;
-    t.srgb = job.srgb;
 
-    if (!loadFromCache(job.path, job.srgb, t)) {
-      int w = 0, h = 0, c = 0;
-      stbi_uc *data = stbi_load(job.path.c_str(), &w, &h, &c, STBI_rgb_alpha);
-      if (!data) {
-        t.ok = false;
-      } else {
-        t.w = w;
-        t.h = h;
-        t.rgba.assign(data, data + (w * h * 4));
-        stbi_image_free(data);
+    std::string key;
+    bool cooked = false;
+    if (readFile(job.path, src)) {
+      key = textureCookKey(src.data(), src.size(), job.settings);
+      if (loadFromCache(key, t.cooked)) {
         t.ok = true;
-        writeCache(t);
+        ++m_cacheHits;
+      } else {
+        int w = 0, h = 0, c = 0;
+        stbi_uc *data =
+            stbi_load_from_memory(src.data(), static_cast<int>(src.size()),
+                                  &w, &h, &c, STBI_rgb_alpha);
+        // Cooking (BC7 in particular) is the expensive part; skip it for
+        // loads cancelled while decoding.
+        if (data && !isCancelled(job.ticket)) {
+          t.ok = cookTexture(data, static_cast<uint32_t>(w),
+                             static_cast<uint32_t>(h), job.settings, t.cooked);
+          cooked = t.ok;
+        }
+        if (data)
+          stbi_image_free(data);
       }
     }
 
     {
       std::lock_guard<std::mutex> lock(m_mutex);
-      m_ready.push(std::move(t));
+      const auto it = m_inFlight.find(job.ticket);
+      const bool cancelled = it != m_inFlight.end() && it->second;
+      if (it != m_inFlight.end())
+        m_inFlight.erase(it);
+      if (cancelled)
+        continue;
+    }
+
+    if (cooked) {
+      ++m_cooks;
+      writeCache(key, t.cooked, job.ticket);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_ready.push_back(std::move(t));
     }
   }
 }
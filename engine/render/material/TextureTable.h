@@ -1,11 +1,14 @@
 #pragma once
 
+#include "render/material/TextureCooker.h"
+#include "render/material/TexturePoolLayers.h"
+
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
 #include <filesystem>
+#include <deque>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -14,25 +17,132 @@
 namespace Nyx {
 
 class GLResources;
+class GLUploadRing;
+
+// Decode order. Loads start at Editor; MaterialSystem raises the textures of
+// materials drawn last frame to Visible. Lower values decode and upload
+// first.
+enum class TexturePriority : uint8_t { Visible = 0, Editor, Thumbnail };
+
+// Per-frame cap on main-thread uploads; whichever limit is hit first ends
+// the frame's uploads. One upload always goes through so a texture larger
+// than the byte budget still makes progress.
+struct TextureUploadBudget {
+  uint64_t bytes = 32ull << 20; // cooked bytes, all levels
+  double ms = 2.0;
+};
+
+struct TextureResidencyStats {
+  uint32_t textures = 0;   // table entries
+  uint32_t resident = 0;   // entries living in a pool layer
+  uint32_t pools = 0;      // size class/format buckets in use (<= kMaxPools)
+  uint32_t poolLayers = 0; // allocated layers across all pools
+  uint64_t poolBytes = 0;  // pool storage including mips
+  uint32_t unpooled = 0;   // loaded, but no pool could take them: not drawn
+  uint32_t downscaled = 0; // resident without their top mips (pools full)
+  uint32_t slotUploads = 0;
+  // CPU cost of making material textures visible to the shaders last frame:
+  // slot table upload plus the pool binds. This replaces the per-pass scan
+  // that compacted used textures into 16 units.
+  uint32_t bindsLastFrame = 0;
+  double bindMsLastFrame = 0.0;
+  // Decode pool.
+  uint32_t decodeThreads = 0;
+  uint32_t queued = 0;    // waiting for a decode thread
+  uint32_t decoding = 0;  // on a decode thread
+  uint32_t waiting = 0;   // decoded, waiting for upload budget
+  uint32_t cancelled = 0; // since init: loads dropped as unreferenced
+  uint32_t cacheHits = 0; // since init: loads served by the cooked cache
+  uint32_t cooked = 0;    // since init: loads that had to cook
+  uint32_t uploadsLastFrame = 0;
+  uint64_t uploadBytesLastFrame = 0;
+  double uploadMsLastFrame = 0.0;
+};
 
 // Owns GL textures for material slots and provides indices for GPU table.
+//
+// Residency: loaded textures live in layers of GL_TEXTURE_2D_ARRAY pools,
+// one pool per (power-of-two size class, GL format, mipped) bucket; see
+// TexturePoolClass. The slot table at kSlotsBinding maps a texture index to
+// its (pool, layer, UV scale), so shaders index textures by TextureTable
+// index directly (include/MaterialTextures.glsl) and passes only call
+// bind(). Once all kMaxPools units are taken, a texture shares the closest
+// pool of its format, dropping top mips if it is larger. A pool whose last
+// layer is released frees its storage and unit.
+//
+// Loading: a pool of decode threads works through one queue ordered by
+// TexturePriority. A load nobody has requested for kCancelAfterFrames
+// frames is cancelled: dropped from the queue, or discarded when its
+// decode finishes. Requesting it again restarts it.
+//
+// Disk cache: decode threads cook the source (TextureCooker: CPU mips,
+// optional BC compression) and store the result under .cache/texcache,
+// keyed by a hash of the file bytes and import settings. Cache hits upload
+// every level as stored, with no decode and no GPU mip generation.
 class TextureTable final {
 public:
-  void init(GLResources &gl);
+  static constexpr uint32_t kSlotsBinding = 15;
+  static constexpr uint32_t kFirstPoolUnit = 10;
+  static constexpr uint32_t kMaxPools = 16;
+  static constexpr uint32_t kCancelAfterFrames = 2;
+  // GpuSlot::layer flag: the texture is BC5 and samplers rebuild Z.
+  static constexpr uint32_t kSlotReconstructZ = 0x80000000u;
+  // GpuSlot::uvScale of a texture that fills its layer.
+  static constexpr uint32_t kSlotFullUV = 0xFFFFFFFFu;
+
+  void init(GLResources &gl, GLUploadRing &upload);
   void shutdown();
 
   // Returns texture index in table, or kInvalidTexIndex if load failed.
-  uint32_t getOrCreate2D(const std::string &path, bool srgb);
+  // Counts as a request for this frame (see request()).
+  uint32_t getOrCreate2D(const std::string &path, bool srgb,
+                         TexturePriority prio = TexturePriority::Editor);
+
+  // Keeps a pending load alive for this frame and raises it to `prio`.
+  // Restarts a cancelled load. No-op for loaded textures.
+  void request(uint32_t texIndex, TexturePriority prio);
+  uint32_t pendingLoads() const { return m_pending; }
+
+  // 0 = hardware threads - 1 (at least one). Restarts the pool; queued
+  // loads are kept.
+  void setDecodeThreads(uint32_t count);
+  uint32_t decodeThreads() const {
+    return static_cast<uint32_t>(m_workers.size());
+  }
+
+  void setUploadBudget(const TextureUploadBudget &budget) {
+    m_budget = budget;
+  }
+  const TextureUploadBudget &uploadBudget() const { return m_budget; }
 
-  const std::vector<uint32_t> &glTextures() const { return m_textures; }
+  // Cooked texture cache under .cache/texcache (on by default).
+  void setDiskCacheEnabled(bool enabled) { m_cacheEnabled = enabled; }
 
-  void bindAll(uint32_t firstUnit = 0, uint32_t maxCount = 0) const;
+  // Applies to loads started afterwards (reloadByIndex() to redo one).
+  // Fast falls back to High without S3TC support.
+  void setCompression(TextureCompression c) { m_compression = c; }
+  TextureCompression compression() const { return m_compression; }
 
+  // Binds the slot table and every pool.
+  void bind();
+
+  const TextureResidencyStats &stats() const { return m_stats; }
+
+  // 2D view of the texture's pool layer (or a placeholder while loading),
+  // for editor previews.
   uint32_t glTexByIndex(uint32_t texIndex) const {
     if (texIndex == Invalid || texIndex >= m_entries.size())
       return 0;
     return m_entries[texIndex].glTex;
   }
+  // Corner of glTexByIndex()'s layer the texture covers; uv1 for previews.
+  void previewUV(uint32_t texIndex, float &u, float &v) const {
+    const uint32_t scale = (texIndex == Invalid || texIndex >= m_entries.size())
+                               ? kSlotFullUV
+                               : m_entries[texIndex].uvScale;
+    u = float(scale & 0xFFFFu) / 65535.0f;
+    v = float(scale >> 16) / 65535.0f;
+  }
 
   const std::string &pathByIndex(uint32_t texIndex) const {
     static const std::string kEmpty;
@@ -49,24 +159,64 @@ public:
 
   bool reloadByIndex(uint32_t texIndex);
 
-  // Process completed async loads on the main thread.
-  void processUploads(uint32_t maxPerFrame = 8);
+  // Cancels unrequested loads, uploads decoded textures in priority order
+  // within the upload budget and publishes slot table changes. Called once
+  // per frame.
+  void processUploads();
 
   static constexpr uint32_t Invalid = 0xFFFFFFFF;
 
 private:
   GLResources *m_gl = nullptr;
+  GLUploadRing *m_upload = nullptr;
 
   struct Entry final {
     std::string path;
     bool srgb = false;
-    uint32_t glTex = 0;
+    uint32_t glTex = 0; // layer view, or a placeholder
+    uint32_t pool = Invalid;
+    uint32_t layer = 0;
     bool loading = false;
     bool failed = false;
+    bool cancelled = false;
+    bool reconstructZ = false;
+    uint32_t uvScale = kSlotFullUV; // unorm16 x2, as in GpuSlot
+    bool unpooled = false;
+    bool downscaled = false;
+    TexturePriority prio = TexturePriority::Editor;
+    uint64_t wantFrame = 0; // last frame it was requested in
+    uint64_t ticket = 0;    // of the current load; results must match
+  };
+
+  // tex == 0: freed; the unit is up for the next new bucket.
+  struct Pool final {
+    uint32_t tex = 0;
+    uint32_t w = 0;
+    uint32_t h = 0;
+    TextureCodec codec = TextureCodec::RGBA8;
+    bool srgb = false;
+    uint32_t levels = 1;
+    TexturePoolLayers layers;
+  };
+
+  // Mirrors GpuTextureSlot in include/MaterialTextures.glsl.
+  struct GpuSlot {
+    uint32_t pool = Invalid;
+    uint32_t layer = 0; // | kSlotReconstructZ
+    uint32_t uvScale = kSlotFullUV;
   };
 
   std::vector<Entry> m_entries;
-  std::vector<uint32_t> m_textures; // parallel glTex list for fast bind
+  std::vector<Pool> m_pools;
+  std::vector<GpuSlot> m_slots; // parallel to m_entries
+  uint32_t m_slotBuffer = 0;
+  uint32_t m_slotCapacity = 0; // bytes
+  bool m_slotsDirty = true;
+  int32_t m_maxLayers = 256;
+
+  TextureResidencyStats m_stats{};
+  uint32_t m_frameBinds = 0;
+  double m_frameBindMs = 0.0;
 
   struct Key {
     std::string path;
@@ -87,42 +237,71 @@ private:
   struct Job {
     uint32_t index = Invalid;
     std::string path;
-    bool srgb = false;
+    TextureImportSettings settings{};
+    TexturePriority prio = TexturePriority::Editor;
+    uint64_t ticket = 0;
   };
 
   struct Loaded {
     uint32_t index = Invalid;
+    uint64_t ticket = 0;
     std::string path;
-    bool srgb = false;
-    int w = 0;
-    int h = 0;
-    std::vector<uint8_t> rgba;
+    CookedTexture cooked;
     bool ok = false;
   };
 
-  std::thread m_worker;
+  std::vector<std::thread> m_workers;
+  uint32_t m_requestedThreads = 0; // 0 = auto
   std::mutex m_mutex;
   std::condition_variable m_cv;
-  std::queue<Job> m_jobs;
-  std::queue<Loaded> m_ready;
+  // Guarded by m_mutex. m_jobs stays sorted by (prio, ticket); m_inFlight
+  // maps the tickets on decode threads to their cancel flag.
+  std::deque<Job> m_jobs;
+  std::vector<Loaded> m_ready;
+  std::unordered_map<uint64_t, bool> m_inFlight;
   std::atomic<bool> m_stop{false};
+  std::atomic<uint32_t> m_cacheHits{0};
+  std::atomic<uint32_t> m_cooks{0};
+
+  // Main thread only.
+  std::vector<Loaded> m_arrived; // decoded, not uploaded yet
+  uint64_t m_nextTicket = 1;
+  uint64_t m_frame = 0;
+  uint32_t m_pending = 0; // entries with loading set
+  TextureUploadBudget m_budget{};
+  std::atomic<bool> m_cacheEnabled{true};
+  TextureCompression m_compression = TextureCompression::High;
+  bool m_hasS3TC = false;
 
   uint32_t m_placeholderLinear = 0;
   uint32_t m_placeholderSRGB = 0;
 
-  std::filesystem::path m_cacheDir;
+  TextureCookCache m_cache;
 
-  void startWorker();
-  void stopWorker();
+  void startWorkers();
+  void stopWorkers();
   void workerLoop();
-  void enqueue(uint32_t index, const std::string &path, bool srgb);
+  void enqueue(uint32_t index);
   void clearQueues();
+  void cancelUnrequested();
+  void reprioritizeJobs();
+  void finishLoad(Entry &e);
 
   uint32_t createPlaceholder(bool srgb) const;
-  uint32_t uploadTexture(const Loaded &t);
+  bool uploadTexture(uint32_t index, const Loaded &t);
+  void releaseTexture(Entry &e);
+  uint32_t findOrCreatePool(const CookedTexture &t, uint32_t &baseLevel);
+  bool allocLayer(uint32_t poolIndex, uint32_t &outLayer);
+  bool growPool(uint32_t poolIndex, uint32_t capacity);
+  uint32_t createLayerView(const Pool &pool, uint32_t layer) const;
+  void setSlot(uint32_t index, const Entry &e);
+  void flushSlots();
+  void updateStats();
 
-  bool loadFromCache(const std::string &path, bool srgb, Loaded &out) const;
-  void writeCache(const Loaded &t) const;
+  bool isCancelled(uint64_t ticket);
+  bool loadFromCache(const std::string &key, CookedTexture &out) const;
+  void writeCache(const std::string &key, const CookedTexture &t,
+                  uint64_t ticket) const;
 
   int find(const std::string &path, bool srgb) const;
 };
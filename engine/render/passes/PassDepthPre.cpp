@@ -8,8 +8,7 @@
 
 namespace Nyx {
 
-static constexpr uint32_t kMaterialsBinding = 14;
-static constexpr uint32_t kLightsBinding = 16;
+static constexpr uint32_t kPerDrawBinding = 13;
 
 PassDepthPre::~PassDepthPre() {
   if (m_fbo != 0 && m_res) {
@@ -23,12 +22,13 @@ PassDepthPre::~PassDepthPre() {
 }
 
 void PassDepthPre::configure(GLShaderUtil &shader, GLResources &res,
-                             std::function<void(ProcMeshType)> drawFn) {
+                             const GLMeshPool &meshes) {
   m_res = &res;
 
   m_fbo = res.acquireFBO();
-  m_prog = shader.buildProgramVF("forward.vert", "forward.frag");
-  m_draw = std::move(drawFn);
+  m_prog = shader.buildProgramVF("passes/depth_prepass.vert",
+                                 "passes/depth_prepass.frag");
+  m_meshes = &meshes;
 }
 
 void PassDepthPre::setup(RenderGraph &graph, const RenderPassContext &ctx,
@@ -36,11 +36,15 @@ void PassDepthPre::setup(RenderGraph &graph, const RenderPassContext &ctx,
                          EngineContext &engine, bool editorVisible) {
   (void)ctx;
   (void)editorVisible;
+  m_stats = {};
 
   graph.addPass(
       "DepthPre",
       [&](RenderPassBuilder &b) {
         b.writeTexture("Depth.Pre", RenderAccess::DepthWrite);
+        b.readBuffer("Scene.PerDraw", RenderAccess::SSBORead);
+        // Read before the occlusion test rewrites instanceCount.
+        b.readBuffer("Scene.DrawIndirect", RenderAccess::IndirectRead);
       },
       [&](const RenderPassContext &rc, RenderResourceBlackboard &bb,
           RGResources &rg) {
@@ -65,51 +69,36 @@ void PassDepthPre::setup(RenderGraph &graph, const RenderPassContext &ctx,
         glClearBufferfv(GL_DEPTH, 0, clearZ);
 
         engine.materials().uploadIfDirty();
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kMaterialsBinding,
-                         engine.materials().ssbo());
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kLightsBinding,
-                         engine.lights().ssbo());
+        engine.perDraw().bind(kPerDrawBinding);
 
+        // Camera matrices come from the per-view UBO.
         glUseProgram(m_prog);
 
-        const int locVP = glGetUniformLocation(m_prog, "u_ViewProj");
-        const int locV = glGetUniformLocation(m_prog, "u_View");
-        const int locM = glGetUniformLocation(m_prog, "u_Model");
-        const int locPick = glGetUniformLocation(m_prog, "u_PickID");
-        const int locVM = glGetUniformLocation(m_prog, "u_ViewMode");
-        const int locMat = glGetUniformLocation(m_prog, "u_MaterialIndex");
-        const int locIsLight = glGetUniformLocation(m_prog, "u_IsLight");
-        const int locLightColorInt =
-            glGetUniformLocation(m_prog, "u_LightColorIntensity");
-        const int locLightExposure =
-            glGetUniformLocation(m_prog, "u_LightExposure");
-
-        glUniform1ui(locVM, static_cast<uint32_t>(engine.viewMode()));
-        glUniformMatrix4fv(locVP, 1, GL_FALSE, &rc.viewProj[0][0]);
-        if (locV >= 0)
-          glUniformMatrix4fv(locV, 1, GL_FALSE, &rc.view[0][0]);
-
-        for (const auto &r : registry.all()) {
-          if (engine.isEntityHidden(r.entity))
-            continue;
-          if (r.isCamera)
-            continue;
-          glUniformMatrix4fv(locM, 1, GL_FALSE, &r.model[0][0]);
-          glUniform1ui(locPick, r.pickID);
-          glUniform1ui(locMat, engine.materialIndex(r));
-          if (locIsLight >= 0)
-            glUniform1i(locIsLight, r.isLight ? 1 : 0);
-          if (r.isLight) {
-            if (locLightColorInt >= 0) {
-              glUniform4f(locLightColorInt, r.lightColor.x, r.lightColor.y,
-                          r.lightColor.z, r.lightIntensity);
-            }
-            if (locLightExposure >= 0)
-              glUniform1f(locLightExposure, r.lightExposure);
+        // The per-draw list is every visible, non-hidden renderable (opaque,
+        // then transparent), so its commands cover the pre-pass minus the
+        // camera gizmos.
+        SubmitTimer timer(m_stats);
+        m_ranges.clear();
+        uint32_t drawIndex = 0;
+        auto collect = [&](const RenderableDrawList &list) {
+          for (const auto &r : list) {
+            if (engine.isEntityHidden(r.entity))
+              continue;
+            if (!r.isCamera)
+              appendDrawIndex(m_ranges, drawIndex);
+            drawIndex++;
           }
-          if (m_draw)
-            m_draw(r.mesh);
-        }
+        };
+        collect(registry.opaque());
+        collect(registry.transparentSorted());
+
+        const bool multiDraw = engine.renderer().multiDrawIndirect();
+        m_meshes->bind();
+        engine.drawCull().bindIndirect();
+        const uintptr_t cmdBase = engine.drawCull().indirectOffset();
+        for (const DrawRange &d : m_ranges)
+          drawIndirectRange(cmdBase, d.first, d.count, multiDraw, m_stats);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
       });
 }
 
@@ -1,9 +1,11 @@
 #pragma once
 
+#include "render/draw/MultiDrawBatch.h"
+#include "render/gl/GLMesh.h"
 #include "render/gl/GLResources.h"
 #include "render/gl/GLShaderUtil.h"
 #include "render/passes/RenderPass.h"
-#include <functional>
+#include <vector>
 
 namespace Nyx {
 
@@ -12,16 +14,21 @@ public:
   ~PassDepthPre() override;
 
   void configure(GLShaderUtil &shaders, GLResources &res,
-                 std::function<void(ProcMeshType)> drawFn);
+                 const GLMeshPool &meshes);
 
   void setup(RenderGraph &graph, const RenderPassContext &ctx,
              const RenderableRegistry &registry, EngineContext &engine,
              bool editorVisible) override;
 
+  const DrawSubmitStats &submitStats() const { return m_stats; }
+
 private:
   uint32_t m_fbo = 0;
   GLResources *m_res = nullptr;
-  std::function<void(ProcMeshType)> m_draw;
+  const GLMeshPool *m_meshes = nullptr;
+
+  DrawSubmitStats m_stats{};
+  std::vector<DrawRange> m_ranges; // per-draw indices, reused per frame
 };
 
 } // namespace Nyx
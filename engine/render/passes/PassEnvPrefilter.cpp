@@ -66,8 +66,10 @@ void PassEnvPrefilter::setup(RenderGraph &graph, const RenderPassContext &ctx,
 
         glUseProgram(m_prog);
 
-        const int locRough = glGetUniformLocation(m_prog, "u_Roughness");
-        const int locSamp = glGetUniformLocation(m_prog, "u_SampleCount");
+        const int locRough =
+            GLShaderUtil::uniformLocation(m_prog, "u_Roughness");
+        const int locSamp =
+            GLShaderUtil::uniformLocation(m_prog, "u_SampleCount");
 
         glBindTextureUnit(0, envTex);
 
@@ -2,13 +2,11 @@
 
 #include "app/EngineContext.h"
 #include "core/Assert.h"
+#include "render/material/MaterialProgramCache.h"
 #include "scene/World.h"
-#include "render/material/GpuMaterial.h"
-#include "render/material/MaterialGraph.h"
 
 #include <array>
 #include <glad/glad.h>
-#include <unordered_map>
 
 namespace Nyx {
 
@@ -28,12 +26,33 @@ PassForwardMRT::~PassForwardMRT() {
 }
 
 void PassForwardMRT::configure(GLShaderUtil &shader, GLResources &res,
-                               std::function<void(ProcMeshType)> drawFn) {
+                               const GLMeshPool &meshes,
+                               MaterialProgramCache *programs) {
   m_res = &res;
 
   m_fbo = res.acquireFBO();
   m_forwardProg = shader.buildProgramVF("forward_mrt.vert", "forward_mrt.frag");
-  m_draw = std::move(drawFn);
+  m_meshes = &meshes;
+  m_programs = programs;
+}
+
+PassForwardMRT::ProgramBatch &PassForwardMRT::batchFor(uint32_t prog) {
+  // Opaque draws are depth-equal against the prepass, so they may be grouped
+  // freely. Transparent draws keep their sorted order: only a run of draws
+  // with the same program shares a batch.
+  if (m_mode == Mode::Opaque) {
+    for (uint32_t i = 0; i < m_batchCount; ++i)
+      if (m_batches[i].prog == prog)
+        return m_batches[i];
+  } else if (m_batchCount > 0 && m_batches[m_batchCount - 1].prog == prog) {
+    return m_batches[m_batchCount - 1];
+  }
+  if (m_batchCount == m_batches.size())
+    m_batches.emplace_back();
+  ProgramBatch &b = m_batches[m_batchCount++];
+  b.prog = prog;
+  b.ranges.clear();
+  return b;
 }
 
 void PassForwardMRT::setup(RenderGraph &graph, const RenderPassContext &ctx,
@@ -41,6 +60,7 @@ void PassForwardMRT::setup(RenderGraph &graph, const RenderPassContext &ctx,
                            EngineContext &engine, bool editorVisible) {
   (void)ctx;
   (void)editorVisible;
+  m_stats = {};
 
   const char *passName =
       (m_mode == Mode::Transparent) ? "ForwardMRT_Transparent"
@@ -57,6 +77,7 @@ void PassForwardMRT::setup(RenderGraph &graph, const RenderPassContext &ctx,
         b.readTexture("Shadow.PointArray", RenderAccess::SampledRead);
         b.readBuffer("Scene.Lights", RenderAccess::SSBORead);
         b.readBuffer("Scene.PerDraw", RenderAccess::SSBORead);
+        b.readBuffer("Scene.DrawIndirect", RenderAccess::IndirectRead);
         b.readBuffer("LightGrid.Meta", RenderAccess::UBORead);
         b.readBuffer("LightGrid.Header", RenderAccess::SSBORead);
         b.readBuffer("LightGrid.Indices", RenderAccess::SSBORead);
@@ -113,8 +134,7 @@ void PassForwardMRT::setup(RenderGraph &graph, const RenderPassContext &ctx,
 
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kMaterialsBinding,
                          engine.materials().ssbo());
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kPerDrawBinding,
-                         engine.perDraw().ssbo());
+        engine.perDraw().bind(kPerDrawBinding);
         const auto &lights = buf(bb, rg, "Scene.Lights");
         const auto &gridMeta = buf(bb, rg, "LightGrid.Meta");
         const auto &gridHeader = buf(bb, rg, "LightGrid.Header");
@@ -129,23 +149,6 @@ void PassForwardMRT::setup(RenderGraph &graph, const RenderPassContext &ctx,
         if (gridIndices.buf)
           glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 25, gridIndices.buf);
 
-        glUseProgram(m_forwardProg);
-
-        const int locVP = glGetUniformLocation(m_forwardProg, "u_ViewProj");
-        const int locV = glGetUniformLocation(m_forwardProg, "u_View");
-        const int locCam = glGetUniformLocation(m_forwardProg, "u_CamPos");
-        const int locVM = glGetUniformLocation(m_forwardProg, "u_ViewMode");
-        const int locTexRemapCount =
-            glGetUniformLocation(m_forwardProg, "u_TexRemapCount");
-        const int locHasIBL = glGetUniformLocation(m_forwardProg, "u_HasIBL");
-
-        glUniform1ui(locVM, static_cast<uint32_t>(engine.viewMode()));
-        glUniformMatrix4fv(locVP, 1, GL_FALSE, &rc.viewProj[0][0]);
-        if (locV >= 0)
-          glUniformMatrix4fv(locV, 1, GL_FALSE, &rc.view[0][0]);
-        if (locCam >= 0)
-          glUniform3f(locCam, rc.cameraPos.x, rc.cameraPos.y, rc.cameraPos.z);
-
         const auto &csmAtlas = tex(bb, rg, "Shadow.CSMAtlas");
         const auto &spotAtlas = tex(bb, rg, "Shadow.SpotAtlas");
         const auto &dirAtlas = tex(bb, rg, "Shadow.DirAtlas");
@@ -174,8 +177,16 @@ void PassForwardMRT::setup(RenderGraph &graph, const RenderPassContext &ctx,
           glBindTextureUnit(1, env.envPrefilteredCube());
           glBindTextureUnit(2, env.brdfLUT());
         }
-        if (locHasIBL >= 0)
-          glUniform1i(locHasIBL, env.ready() ? 1 : 0);
+
+        // Camera matrices come from the per-view UBO.
+        auto useProgram = [&](uint32_t prog) {
+          glUseProgram(prog);
+          const int locVM = GLShaderUtil::uniformLocation(prog, "u_ViewMode");
+          const int locHasIBL = GLShaderUtil::uniformLocation(prog, "u_HasIBL");
+          glUniform1ui(locVM, static_cast<uint32_t>(engine.viewMode()));
+          if (locHasIBL >= 0)
+            glUniform1i(locHasIBL, env.ready() ? 1 : 0);
+        };
 
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 14,
                          engine.materials().ssbo());
@@ -184,23 +195,9 @@ void PassForwardMRT::setup(RenderGraph &graph, const RenderPassContext &ctx,
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 17,
                          engine.materials().graphNodesSSBO());
 
-        // Build a compact texture table for this frame (<=16).
-        auto &texTable = engine.materials().textures();
-        std::vector<uint32_t> compactOrig;
-        compactOrig.reserve(16);
-        std::unordered_map<uint32_t, uint32_t> used;
-
-        auto tryAdd = [&](uint32_t origIdx) {
-          if (origIdx == kInvalidTexIndex)
-            return;
-          if (used.find(origIdx) != used.end())
-            return;
-          if (compactOrig.size() >= 16)
-            return;
-          uint32_t compactIdx = static_cast<uint32_t>(compactOrig.size());
-          used[origIdx] = compactIdx;
-          compactOrig.push_back(origIdx);
-        };
+        // Materials index textures by TextureTable index; this binds the
+        // slot table and the texture pools (matches MaterialTextures.glsl).
+        engine.materials().textures().bind();
 
         const auto &drawList =
             (m_mode == Mode::Transparent) ? registry.transparentSorted()
@@ -208,85 +205,62 @@ void PassForwardMRT::setup(RenderGraph &graph, const RenderPassContext &ctx,
         const uint32_t baseOffset =
             (m_mode == Mode::Transparent) ? engine.perDrawTransparentOffset()
                                           : engine.perDrawOpaqueOffset();
-        uint32_t visibleIdx = 0;
-        for (uint32_t i = 0; i < static_cast<uint32_t>(drawList.size()); ++i) {
-          const auto &r = drawList[i];
-          if (engine.isEntityHidden(r.entity))
-            continue;
-          (void)engine.materialIndex(r);
-          const auto &mc = engine.world().mesh(r.entity);
-          if (r.submesh >= mc.submeshes.size())
-            continue;
-          const auto &sm = mc.submeshes[r.submesh];
-          if (!engine.materials().isAlive(sm.material))
-            continue;
-
-          const auto &gpu = engine.materials().gpu(sm.material);
-          tryAdd(gpu.tex0123.x);
-          tryAdd(gpu.tex0123.y);
-          tryAdd(gpu.tex0123.z);
-          tryAdd(gpu.tex0123.w);
-          tryAdd(gpu.tex4_pad.x);
-
-          const auto &graph = engine.materials().graph(sm.material);
-          for (const auto &node : graph.nodes) {
-            switch (node.type) {
-            case MatNodeType::Texture2D:
-            case MatNodeType::TextureMRA:
-            case MatNodeType::NormalMap:
-              tryAdd(node.u.x);
-              break;
-            default:
-              break;
+
+        // drawCull().indirectBuffer() holds one command per DrawData entry
+        // (occlusion culling only zeroes instanceCount), so consecutive draws
+        // go out as one multi-draw. Camera gizmos only write IDs; they are
+        // batched separately rather than flipping the masks per draw.
+        // Graph materials whose specialized variant is ready are drawn with
+        // it, one batch per program; the rest share the VM program.
+        {
+          SubmitTimer timer(m_stats);
+          m_batchCount = 0;
+          m_cameraRanges.clear();
+          const MaterialSystem &materials = engine.materials();
+          uint32_t lastSlot = UINT32_MAX;
+          uint32_t lastProg = m_forwardProg;
+          uint32_t drawIndex = baseOffset;
+          for (const auto &r : drawList) {
+            if (engine.isEntityHidden(r.entity))
+              continue;
+            if (r.isCamera) {
+              appendDrawIndex(m_cameraRanges, drawIndex++);
+              continue;
+            }
+            if (r.materialGpuIndex != lastSlot) {
+              lastSlot = r.materialGpuIndex;
+              lastProg = m_forwardProg;
+              if (m_programs) {
+                if (const auto *g = materials.compiledGraphBySlot(lastSlot))
+                  if (const uint32_t p = m_programs->acquire(*g))
+                    lastProg = p;
+              }
             }
+            appendDrawIndex(batchFor(lastProg).ranges, drawIndex++);
           }
-        }
 
-        const auto &glTex = texTable.glTextures();
-        std::vector<uint32_t> remap(glTex.size(), TextureTable::Invalid);
-
-        for (size_t i = 0; i < compactOrig.size(); ++i) {
-          const uint32_t origIdx = compactOrig[i];
-          if (origIdx < remap.size())
-            remap[origIdx] = static_cast<uint32_t>(i);
-        }
-
-        glNamedBufferData(engine.texRemapSSBO(),
-                          remap.size() * sizeof(uint32_t), remap.data(),
-                          GL_DYNAMIC_DRAW);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 15, engine.texRemapSSBO());
-
-        if (locTexRemapCount >= 0)
-          glUniform1ui(locTexRemapCount,
-                       static_cast<uint32_t>(remap.size()));
-
-        // Bind compacted textures at unit 10 (matches forward_mrt.frag).
-        for (uint32_t i = 0; i < 16; ++i) {
-          uint32_t tex = 0;
-          if (i < compactOrig.size()) {
-            tex = texTable.glTexByIndex(compactOrig[i]);
+          const bool multiDraw = engine.renderer().multiDrawIndirect();
+          m_meshes->bind();
+          engine.drawCull().bindIndirect();
+          const uintptr_t cmdBase = engine.drawCull().indirectOffset();
+
+          glColorMaski(0, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+          glDepthMask(m_mode == Mode::Transparent ? GL_FALSE : GL_TRUE);
+          for (uint32_t i = 0; i < m_batchCount; ++i) {
+            const ProgramBatch &b = m_batches[i];
+            useProgram(b.prog);
+            for (const DrawRange &d : b.ranges)
+              drawIndirectRange(cmdBase, d.first, d.count, multiDraw, m_stats);
           }
-          glBindTextureUnit(10 + i, tex);
-        }
 
-        for (uint32_t i = 0; i < static_cast<uint32_t>(drawList.size()); ++i) {
-          const auto &r = drawList[i];
-          if (engine.isEntityHidden(r.entity))
-            continue;
-          if (r.isCamera) {
+          if (!m_cameraRanges.empty()) {
+            useProgram(m_forwardProg);
             glColorMaski(0, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
             glDepthMask(GL_FALSE);
-          } else {
-            glColorMaski(0, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-            if (m_mode == Mode::Transparent)
-              glDepthMask(GL_FALSE);
-            else
-              glDepthMask(GL_TRUE);
+            for (const DrawRange &d : m_cameraRanges)
+              drawIndirectRange(cmdBase, d.first, d.count, multiDraw, m_stats);
           }
-          const uint32_t baseInstance = baseOffset + visibleIdx;
-          engine.rendererDrawPrimitive(static_cast<uint32_t>(r.mesh),
-                                       baseInstance);
-          visibleIdx++;
+          glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
         }
         glColorMaski(0, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
         glColorMaski(1, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
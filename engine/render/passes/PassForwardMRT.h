@@ -1,13 +1,17 @@
 #pragma once
 
+#include "render/draw/MultiDrawBatch.h"
+#include "render/gl/GLMesh.h"
 #include "render/gl/GLResources.h"
 #include "render/gl/GLShaderUtil.h"
 #include "render/passes/RenderPass.h"
 #include <cstdint>
-#include <functional>
+#include <vector>
 
 namespace Nyx {
 
+class MaterialProgramCache;
+
 class PassForwardMRT final : public RenderPass {
 public:
   enum class Mode : uint8_t { Opaque = 0, Transparent = 1 };
@@ -15,19 +19,38 @@ public:
   void setMode(Mode mode) { m_mode = mode; }
   ~PassForwardMRT() override;
 
+  // `programs` (optional) supplies per-graph specialized programs; draws
+  // whose variant is not ready use the VM program.
   void configure(GLShaderUtil &shader, GLResources &res,
-                 std::function<void(ProcMeshType)> drawFn);
+                 const GLMeshPool &meshes,
+                 MaterialProgramCache *programs = nullptr);
 
   void setup(RenderGraph &graph, const RenderPassContext &ctx,
              const RenderableRegistry &registry, EngineContext &engine,
              bool editorVisible) override;
 
+  const DrawSubmitStats &submitStats() const { return m_stats; }
+
 private:
+  // Draw ranges sharing one program.
+  struct ProgramBatch final {
+    uint32_t prog = 0;
+    std::vector<DrawRange> ranges;
+  };
+
+  ProgramBatch &batchFor(uint32_t prog);
+
   uint32_t m_fbo = 0;
   uint32_t m_forwardProg = 0;
   GLResources *m_res = nullptr;
-  std::function<void(ProcMeshType)> m_draw;
+  const GLMeshPool *m_meshes = nullptr;
+  MaterialProgramCache *m_programs = nullptr;
   Mode m_mode = Mode::Opaque;
+
+  DrawSubmitStats m_stats{};
+  std::vector<ProgramBatch> m_batches; // reused per frame
+  uint32_t m_batchCount = 0;
+  std::vector<DrawRange> m_cameraRanges; // camera gizmos
 };
 
 } // namespace Nyx
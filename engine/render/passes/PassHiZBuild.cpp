@@ -59,15 +59,20 @@ void PassHiZBuild::setup(RenderGraph &graph, const RenderPassContext &ctx,
           const uint32_t w = std::max(1u, rc.fbWidth >> mip);
           const uint32_t h = std::max(1u, rc.fbHeight >> mip);
 
-          const GLint locMip = glGetUniformLocation(m_prog, "uMip");
-          const GLint locBase = glGetUniformLocation(m_prog, "uBaseSize");
+          const GLint locMip = GLShaderUtil::uniformLocation(m_prog, "uMip");
+          const GLint locBase =
+              GLShaderUtil::uniformLocation(m_prog, "uBaseSize");
           if (locMip >= 0)
             glUniform1ui(locMip, mip);
           if (locBase >= 0)
             glUniform2ui(locBase, rc.fbWidth, rc.fbHeight);
 
           glBindImageTexture(1, hiz.tex, (int)mip, GL_FALSE, 0, GL_WRITE_ONLY,
-                             GL_R32F);
+                             GL_RG32F);
+          if (mip > 0) {
+            glBindImageTexture(2, hiz.tex, (int)mip - 1, GL_FALSE, 0,
+                               GL_READ_ONLY, GL_RG32F);
+          }
 
           const uint32_t gx = (w + 15u) / 16u;
           const uint32_t gy = (h + 15u) / 16u;
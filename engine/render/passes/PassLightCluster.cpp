@@ -81,30 +81,12 @@ void PassLightCluster::setup(RenderGraph &graph, const RenderPassContext &ctx,
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 24, header.buf);
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 25, indices.buf);
 
-        const glm::mat4 invViewProj = glm::inverse(rc.viewProj);
-        const GLint locInvVP = glGetUniformLocation(m_prog, "uInvViewProj");
-        if (locInvVP >= 0)
-          glUniformMatrix4fv(locInvVP, 1, GL_FALSE, &invViewProj[0][0]);
-
-        const GLint locView = glGetUniformLocation(m_prog, "uView");
-        if (locView >= 0)
-          glUniformMatrix4fv(locView, 1, GL_FALSE, &rc.view[0][0]);
-
-        const GLint locVPsz = glGetUniformLocation(m_prog, "uViewportSize");
-        if (locVPsz >= 0)
-          glUniform2f(locVPsz, (float)rc.fbWidth, (float)rc.fbHeight);
-
-        const GLint locTile = glGetUniformLocation(m_prog, "uTileCount");
+        // Matrices, viewport size and near/far come from the per-view UBO.
+        const GLint locTile =
+            GLShaderUtil::uniformLocation(m_prog, "uTileCount");
         if (locTile >= 0)
           glUniform2ui(locTile, tilesX, tilesY);
 
-        const GLint locNear = glGetUniformLocation(m_prog, "uNear");
-        const GLint locFar = glGetUniformLocation(m_prog, "uFar");
-        if (locNear >= 0)
-          glUniform1f(locNear, metaCPU.nearZ);
-        if (locFar >= 0)
-          glUniform1f(locFar, metaCPU.farZ);
-
         glDispatchCompute(tilesX, tilesY, zSlices);
         glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT |
                         GL_TEXTURE_FETCH_BARRIER_BIT);
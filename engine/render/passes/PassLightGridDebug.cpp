@@ -55,7 +55,7 @@ void PassLightGridDebug::setup(RenderGraph &graph, const RenderPassContext &ctx,
         glBindImageTexture(1, out.tex, 0, GL_FALSE, 0, GL_WRITE_ONLY,
                            GL_RGBA16F);
 
-        const GLint locOut = glGetUniformLocation(m_prog, "uOutSize");
+        const GLint locOut = GLShaderUtil::uniformLocation(m_prog, "uOutSize");
         if (locOut >= 0)
           glUniform2ui(locOut, rc.fbWidth, rc.fbHeight);
 
@@ -2,18 +2,15 @@
 
 #include "app/EngineContext.h"
 #include "core/Assert.h"
-#include "render/material/GpuMaterial.h"
 #include "render/material/TextureTable.h"
 
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
-#include <unordered_map>
 #include <vector>
 
 namespace Nyx {
 
 static constexpr uint32_t kMaterialsBinding = 14;
-static constexpr uint32_t kTexRemapBinding = 15;
 
 PassMaterialPreview::~PassMaterialPreview() {
   if (m_fbo != 0 && m_res) {
@@ -96,19 +93,21 @@ void PassMaterialPreview::setup(RenderGraph &graph,
         const glm::mat4 vp = proj * view;
         const glm::mat4 model(1.0f);
 
-        const int locVP = glGetUniformLocation(m_prog, "u_ViewProj");
-        const int locM = glGetUniformLocation(m_prog, "u_Model");
-        const int locMat = glGetUniformLocation(m_prog, "u_MaterialIndex");
-        const int locLightDir = glGetUniformLocation(m_prog, "u_LightDir");
-        const int locLightColor = glGetUniformLocation(m_prog, "u_LightColor");
+        const int locVP = GLShaderUtil::uniformLocation(m_prog, "u_ViewProj");
+        const int locM = GLShaderUtil::uniformLocation(m_prog, "u_Model");
+        const int locMat =
+            GLShaderUtil::uniformLocation(m_prog, "u_MaterialIndex");
+        const int locLightDir =
+            GLShaderUtil::uniformLocation(m_prog, "u_LightDir");
+        const int locLightColor =
+            GLShaderUtil::uniformLocation(m_prog, "u_LightColor");
         const int locLightInt =
-            glGetUniformLocation(m_prog, "u_LightIntensity");
+            GLShaderUtil::uniformLocation(m_prog, "u_LightIntensity");
         const int locLightExposure =
-            glGetUniformLocation(m_prog, "u_LightExposure");
-        const int locAmbient = glGetUniformLocation(m_prog, "u_Ambient");
-        const int locCamPos = glGetUniformLocation(m_prog, "u_CamPos");
-        const int locTexRemapCount =
-            glGetUniformLocation(m_prog, "u_TexRemapCount");
+            GLShaderUtil::uniformLocation(m_prog, "u_LightExposure");
+        const int locAmbient =
+            GLShaderUtil::uniformLocation(m_prog, "u_Ambient");
+        const int locCamPos = GLShaderUtil::uniformLocation(m_prog, "u_CamPos");
 
         if (locVP >= 0)
           glUniformMatrix4fv(locVP, 1, GL_FALSE, &vp[0][0]);
@@ -140,57 +139,7 @@ void PassMaterialPreview::setup(RenderGraph &graph,
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kMaterialsBinding,
                          engine.materials().ssbo());
 
-        auto &texTable = engine.materials().textures();
-        const auto &gpu = engine.materials().gpu(mh);
-
-        std::vector<uint32_t> compactOrig;
-        compactOrig.reserve(16);
-        std::unordered_map<uint32_t, uint32_t> used;
-
-        auto tryAdd = [&](uint32_t origIdx) {
-          if (origIdx == kInvalidTexIndex)
-            return;
-          if (used.find(origIdx) != used.end())
-            return;
-          if (compactOrig.size() >= 16)
-            return;
-          uint32_t compactIdx = static_cast<uint32_t>(compactOrig.size());
-          used[origIdx] = compactIdx;
-          compactOrig.push_back(origIdx);
-        };
-
-        tryAdd(gpu.tex0123.x);
-        tryAdd(gpu.tex0123.y);
-        tryAdd(gpu.tex0123.z);
-        tryAdd(gpu.tex0123.w);
-        tryAdd(gpu.tex4_pad.x);
-        tryAdd(gpu.tex4_pad.y);
-
-        const auto &glTex = texTable.glTextures();
-        std::vector<uint32_t> remap(glTex.size(), TextureTable::Invalid);
-
-        for (size_t i = 0; i < compactOrig.size(); ++i) {
-          const uint32_t origIdx = compactOrig[i];
-          if (origIdx < remap.size())
-            remap[origIdx] = static_cast<uint32_t>(i);
-        }
-
-        glNamedBufferData(engine.texRemapSSBO(),
-                          remap.size() * sizeof(uint32_t), remap.data(),
-                          GL_DYNAMIC_DRAW);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kTexRemapBinding,
-                         engine.texRemapSSBO());
-
-        if (locTexRemapCount >= 0)
-          glUniform1ui(locTexRemapCount,
-                       static_cast<uint32_t>(remap.size()));
-
-        for (uint32_t i = 0; i < 16; ++i) {
-          uint32_t tex = 0;
-          if (i < compactOrig.size())
-            tex = texTable.glTexByIndex(compactOrig[i]);
-          glBindTextureUnit(10 + i, tex);
-        }
+        engine.materials().textures().bind();
 
         if (m_draw)
           m_draw(ProcMeshType::Sphere);
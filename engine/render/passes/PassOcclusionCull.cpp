@@ -0,0 +1,92 @@
+#include "PassOcclusionCull.h"
+
+#include "app/EngineContext.h"
+#include "core/Assert.h"
+#include "render/gl/GLShaderUtil.h"
+
+#include <algorithm>
+#include <glad/glad.h>
+
+namespace Nyx {
+
+PassOcclusionCull::~PassOcclusionCull() {
+  if (m_prog != 0) {
+    glDeleteProgram(m_prog);
+    m_prog = 0;
+  }
+  if (m_statsBuf[0] != 0)
+    glDeleteBuffers((GLsizei)kStatsSlots, m_statsBuf);
+}
+
+void PassOcclusionCull::configure(GLShaderUtil &shaders) {
+  m_prog = shaders.buildProgramC("passes/occlusion_cull.comp");
+  NYX_ASSERT(m_prog != 0, "PassOcclusionCull: shader build failed");
+
+  glCreateBuffers((GLsizei)kStatsSlots, m_statsBuf);
+  const uint32_t zero = 0;
+  for (uint32_t b : m_statsBuf)
+    glNamedBufferData(b, sizeof(uint32_t), &zero, GL_DYNAMIC_READ);
+}
+
+void PassOcclusionCull::setup(RenderGraph &graph, const RenderPassContext &ctx,
+                              const RenderableRegistry &registry,
+                              EngineContext &engine, bool editorVisible) {
+  (void)ctx;
+  (void)registry;
+  (void)editorVisible;
+
+  if (!engine.gpuOcclusionActive()) {
+    m_occluded = 0;
+    return;
+  }
+
+  graph.addPass(
+      "OcclusionCull",
+      [&](RenderPassBuilder &b) {
+        b.readTexture("HiZ.Depth", RenderAccess::SampledRead);
+        b.readBuffer("Scene.DrawBounds", RenderAccess::SSBORead);
+        b.writeBuffer("Scene.DrawIndirect", RenderAccess::SSBOWrite);
+      },
+      [&](const RenderPassContext &rc, RenderResourceBlackboard &bb,
+          RGResources &rg) {
+        NYX_ASSERT(m_prog != 0, "PassOcclusionCull: not initialized");
+
+        const auto &hiz = tex(bb, rg, "HiZ.Depth");
+        const auto &bounds = buf(bb, rg, "Scene.DrawBounds");
+        const auto &cmds = buf(bb, rg, "Scene.DrawIndirect");
+        const uint32_t drawCount = engine.drawCull().count();
+
+        // Oldest slot: written kStatsSlots - 1 frames ago.
+        const uint32_t slot = m_frame % kStatsSlots;
+        if (m_frame >= kStatsSlots) {
+          glGetNamedBufferSubData(m_statsBuf[slot], 0, sizeof(uint32_t),
+                                  &m_occluded);
+        }
+        ++m_frame;
+
+        const uint32_t zero = 0;
+        glNamedBufferSubData(m_statsBuf[slot], 0, sizeof(uint32_t), &zero);
+        if (drawCount == 0 || !bounds.buf || !cmds.buf)
+          return;
+
+        glUseProgram(m_prog);
+        glBindTextureUnit(0, hiz.tex);
+        engine.drawCull().bindBounds(0);
+        engine.drawCull().bindCommands(1);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_statsBuf[slot]);
+
+        const GLint locCount =
+            GLShaderUtil::uniformLocation(m_prog, "uDrawCount");
+        const GLint locBase =
+            GLShaderUtil::uniformLocation(m_prog, "uBaseSize");
+        const GLint locMips =
+            GLShaderUtil::uniformLocation(m_prog, "uMipCount");
+        glUniform1ui(locCount, drawCount);
+        glUniform2ui(locBase, rc.fbWidth, rc.fbHeight);
+        glUniform1ui(locMips, hiz.mips);
+
+        glDispatchCompute((drawCount + 63u) / 64u, 1, 1);
+      });
+}
+
+} // namespace Nyx
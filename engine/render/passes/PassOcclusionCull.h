@@ -0,0 +1,35 @@
+#pragma once
+
+#include "render/passes/RenderPass.h"
+#include <cstdint>
+
+namespace Nyx {
+
+class GLShaderUtil;
+
+// GPU Hi-Z occlusion test over the frustum-visible draws. Reads HiZ.Depth
+// (built from this frame's depth pre-pass) and Scene.DrawBounds, and writes
+// instanceCount into Scene.DrawIndirect, which ForwardMRT then draws from.
+class PassOcclusionCull final : public RenderPass {
+public:
+  ~PassOcclusionCull() override;
+
+  void configure(GLShaderUtil &shaders);
+
+  void setup(RenderGraph &graph, const RenderPassContext &ctx,
+             const RenderableRegistry &registry, EngineContext &engine,
+             bool editorVisible) override;
+
+  // Draws rejected by the test. Read back with a few frames of latency so the
+  // CPU never waits on the GPU; 0 while the pass is disabled.
+  uint32_t occludedCount() const { return m_occluded; }
+
+private:
+  static constexpr uint32_t kStatsSlots = 3;
+
+  uint32_t m_statsBuf[kStatsSlots]{};
+  uint32_t m_frame = 0;
+  uint32_t m_occluded = 0;
+};
+
+} // namespace Nyx
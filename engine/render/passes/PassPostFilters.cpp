@@ -73,11 +73,10 @@ void PassPostFilters::setup(RenderGraph &graph, const RenderPassContext &ctx,
         glUseProgram(m_prog);
 
         // uniforms
-        const GLint locTime = glGetUniformLocation(m_prog, "u_Time");
-        const GLint locStart = glGetUniformLocation(m_prog, "u_StartIndex");
-        const GLint locEnd = glGetUniformLocation(m_prog, "u_EndIndex");
-        if (locTime >= 0)
-          glUniform1f(locTime, engine.time());
+        const GLint locStart =
+            GLShaderUtil::uniformLocation(m_prog, "u_StartIndex");
+        const GLint locEnd =
+            GLShaderUtil::uniformLocation(m_prog, "u_EndIndex");
 
         const uint32_t lutCount = engine.postLUTCount();
         const uint32_t maxLuts = 8;
@@ -101,7 +101,7 @@ void PassSelection::setup(RenderGraph &graph, const RenderPassContext &ctx,
         if (m_fsTri)
           glBindVertexArray(m_fsTri->vao);
 
-        const int locFlip = glGetUniformLocation(m_prog, "u_FlipY");
+        const int locFlip = GLShaderUtil::uniformLocation(m_prog, "u_FlipY");
         if (locFlip >= 0)
           glUniform1i(locFlip, 0);
 
@@ -111,12 +111,14 @@ void PassSelection::setup(RenderGraph &graph, const RenderPassContext &ctx,
         glBindTextureUnit(3, maskT.tex); // uSelMaskT
 
         const int locThickness =
-            glGetUniformLocation(m_prog, "u_ThicknessPx");
+            GLShaderUtil::uniformLocation(m_prog, "u_ThicknessPx");
         if (locThickness >= 0)
           glUniform1f(locThickness, engine.renderer().outlineThicknessPx());
 
-        const int locActive = glGetUniformLocation(m_prog, "u_ColorActive");
-        const int locMulti = glGetUniformLocation(m_prog, "u_ColorMulti");
+        const int locActive =
+            GLShaderUtil::uniformLocation(m_prog, "u_ColorActive");
+        const int locMulti =
+            GLShaderUtil::uniformLocation(m_prog, "u_ColorMulti");
         if (locActive >= 0)
           glUniform3f(locActive, 1.0f, 0.45f, 0.1f);
         if (locMulti >= 0)
@@ -83,10 +83,7 @@ void PassSelectionMaskTransparent::setup(
           selected.insert(id);
 
         glUseProgram(m_prog);
-        const int locVP = glGetUniformLocation(m_prog, "u_ViewProj");
-        glUniformMatrix4fv(locVP, 1, GL_FALSE, &rc.viewProj[0][0]);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 13,
-                         engine.perDraw().ssbo());
+        engine.perDraw().bind(13);
 
         const auto &drawList = registry.transparentSorted();
         const uint32_t baseOffset = engine.perDrawTransparentOffset();
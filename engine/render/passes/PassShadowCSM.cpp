@@ -126,15 +126,16 @@ PassShadowCSM::~PassShadowCSM() {
     glDeleteProgram(m_prog);
     m_prog = 0;
   }
+  m_batch.shutdown();
 }
 
 void PassShadowCSM::configure(GLShaderUtil &shader, GLResources &res,
-                              std::function<void(ProcMeshType)> drawFn) {
+                              const GLMeshPool &meshes) {
   m_res = &res;
   m_fbo = res.acquireFBO();
   m_prog = shader.buildProgramVF("passes/shadow_csm.vert",
                                  "passes/shadow_csm.frag");
-  m_draw = std::move(drawFn);
+  m_meshes = &meshes;
   
   // Initialize shadow atlas (4096x4096 for 4 cascades)
   m_atlasAlloc.reset(4096, 4096);
@@ -145,6 +146,7 @@ void PassShadowCSM::setup(RenderGraph &graph, const RenderPassContext &ctx,
                           EngineContext &engine, bool editorVisible) {
   (void)ctx;
   (void)editorVisible;
+  m_stats = {};
 
   graph.addPass(
       "ShadowCSM",
@@ -228,8 +230,8 @@ void PassShadowCSM::setup(RenderGraph &graph, const RenderPassContext &ctx,
 
         glUseProgram(m_prog);
 
-        const int locM = glGetUniformLocation(m_prog, "u_Model");
-        const int locVP = glGetUniformLocation(m_prog, "u_LightViewProj");
+        const int locVP =
+            GLShaderUtil::uniformLocation(m_prog, "u_LightViewProj");
 
         glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
         glNamedFramebufferTexture(m_fbo, GL_DEPTH_ATTACHMENT, atlas.tex, 0);
@@ -260,6 +262,10 @@ void PassShadowCSM::setup(RenderGraph &graph, const RenderPassContext &ctx,
         glDrawBuffer(GL_NONE);
         glReadBuffer(GL_NONE);
 
+        const bool multiDraw = engine.renderer().multiDrawIndirect();
+        m_meshes->bind();
+        m_batch.reset();
+
         auto renderCascade = [&](int ci) {
           const ShadowTile &tile = m_cascadeTiles[ci];
           
@@ -315,18 +321,22 @@ void PassShadowCSM::setup(RenderGraph &graph, const RenderPassContext &ctx,
 
           glUniformMatrix4fv(locVP, 1, GL_FALSE, &lightVP[0][0]);
 
-          for (const auto &r : registry.all()) {
+          // Only casters inside the cascade's light volume can land in it.
+          SubmitTimer timer(m_stats);
+          m_casters.clear();
+          registry.queryFrustum(Frustum::fromViewProj(lightVP), m_casters);
+          for (uint32_t idx : m_casters) {
+            const Renderable &r = registry.all()[idx];
             if (engine.isEntityHidden(r.entity))
               continue;
             if (r.isCamera)
               continue;
             if (r.isLight)
               continue;
-            if (locM >= 0)
-              glUniformMatrix4fv(locM, 1, GL_FALSE, &r.model[0][0]);
-            if (m_draw)
-              m_draw(r.mesh);
+            m_batch.add(m_meshes->range(static_cast<uint32_t>(r.mesh)),
+                        r.model);
           }
+          m_batch.submit(engine.uploadRing(), multiDraw, m_stats);
         };
 
         for (uint32_t ci = 0; ci < cascadeCount; ++ci) {
@@ -1,11 +1,13 @@
 #pragma once
 
+#include "render/draw/MultiDrawBatch.h"
+#include "render/gl/GLMesh.h"
 #include "render/gl/GLResources.h"
 #include "render/gl/GLShaderUtil.h"
 #include "render/passes/RenderPass.h"
 #include "render/light/ShadowAtlasAllocator.h"
-#include <functional>
 #include <glm/glm.hpp>
+#include <vector>
 
 namespace Nyx {
 
@@ -49,19 +51,23 @@ public:
   ~PassShadowCSM() override;
 
   void configure(GLShaderUtil &shaders, GLResources &res,
-                 std::function<void(ProcMeshType)> drawFn);
+                 const GLMeshPool &meshes);
 
   void setup(RenderGraph &graph, const RenderPassContext &ctx,
              const RenderableRegistry &registry, EngineContext &engine,
              bool editorVisible) override;
 
+  const DrawSubmitStats &submitStats() const { return m_stats; }
+
   ShadowCSMConfig &config() { return m_cfg; }
   const ShadowCSMConfig &config() const { return m_cfg; }
 
 private:
   uint32_t m_fbo = 0;
   GLResources *m_res = nullptr;
-  std::function<void(ProcMeshType)> m_draw;
+  const GLMeshPool *m_meshes = nullptr;
+  MultiDrawBatch m_batch; // one multi-draw per shadow view
+  DrawSubmitStats m_stats{};
 
   ShadowCSMConfig m_cfg{};
   ShadowCSMUBO m_uboCPU{};
@@ -70,6 +76,8 @@ private:
   ShadowAtlasAllocator m_atlasAlloc;
   ShadowTile m_cascadeTiles[4];
   bool m_useAtlas = true;
+
+  std::vector<uint32_t> m_casters; // registry indices, per cascade
 };
 
 } // namespace Nyx
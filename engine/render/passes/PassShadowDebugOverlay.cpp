@@ -76,21 +76,8 @@ void PassShadowDebugOverlay::setup(RenderGraph &graph,
 
         glBindBufferBase(GL_UNIFORM_BUFFER, 5, engine.shadowCSMUBO());
 
-        const glm::mat4 invViewProj = glm::inverse(rc.viewProj);
-        const glm::mat4 view = rc.view;
-        const glm::vec3 camPos = rc.cameraPos;
-
-        const GLint locInvVP = glGetUniformLocation(m_prog, "u_InvViewProj");
-        const GLint locView = glGetUniformLocation(m_prog, "u_View");
-        const GLint locCam = glGetUniformLocation(m_prog, "u_CamPos");
-        const GLint locMode = glGetUniformLocation(m_prog, "u_Mode");
-        const GLint locAlpha = glGetUniformLocation(m_prog, "u_Alpha");
-        if (locInvVP >= 0)
-          glUniformMatrix4fv(locInvVP, 1, GL_FALSE, &invViewProj[0][0]);
-        if (locView >= 0)
-          glUniformMatrix4fv(locView, 1, GL_FALSE, &view[0][0]);
-        if (locCam >= 0)
-          glUniform3f(locCam, camPos.x, camPos.y, camPos.z);
+        const GLint locMode = GLShaderUtil::uniformLocation(m_prog, "u_Mode");
+        const GLint locAlpha = GLShaderUtil::uniformLocation(m_prog, "u_Alpha");
         if (locMode >= 0)
           glUniform1ui(locMode, static_cast<uint32_t>(m_mode));
         if (locAlpha >= 0)
@@ -10,12 +10,13 @@ namespace Nyx {
 
 PassShadowPoint::~PassShadowPoint() {
   if (m_fbo) glDeleteFramebuffers(1, &m_fbo);
+  m_batch.shutdown();
 }
 
 void PassShadowPoint::configure(GLShaderUtil &shaders, GLResources &res,
-                                std::function<void(ProcMeshType)> drawFn) {
+                                const GLMeshPool &meshes) {
   m_res = &res;
-  m_draw = drawFn;
+  m_meshes = &meshes;
   m_prog = shaders.buildProgramVF("shadow_point.vert", "shadow_point.frag");
   glCreateFramebuffers(1, &m_fbo);
 }
@@ -25,7 +26,7 @@ void PassShadowPoint::setup(RenderGraph &graph, const RenderPassContext &ctx,
                             EngineContext &engine, bool editorVisible) {
   (void)ctx;
   (void)editorVisible;
-  (void)registry;
+  m_stats = {};
 
   graph.addPass(
       "ShadowPoint",
@@ -89,10 +90,11 @@ void PassShadowPoint::setup(RenderGraph &graph, const RenderPassContext &ctx,
         if (m_pointLights.empty()) return;
 
         glUseProgram(m_prog);
-        const int locM = glGetUniformLocation(m_prog, "u_Model");
-        const int locVP = glGetUniformLocation(m_prog, "u_ViewProj");
-        const int locLightPos = glGetUniformLocation(m_prog, "uLightPos");
-        const int locFarPlane = glGetUniformLocation(m_prog, "uFarPlane");
+        const int locVP = GLShaderUtil::uniformLocation(m_prog, "u_ViewProj");
+        const int locLightPos =
+            GLShaderUtil::uniformLocation(m_prog, "uLightPos");
+        const int locFarPlane =
+            GLShaderUtil::uniformLocation(m_prog, "uFarPlane");
 
         glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
         glNamedFramebufferDrawBuffer(m_fbo, GL_NONE);
@@ -110,11 +112,23 @@ void PassShadowPoint::setup(RenderGraph &graph, const RenderPassContext &ctx,
         glDepthMask(GL_TRUE);
         glDisable(GL_CULL_FACE);
 
+        const bool multiDraw = engine.renderer().multiDrawIndirect();
+        m_meshes->bind();
+        m_batch.reset();
+
         // For each point light, render all 6 faces into 2D array layers
         for (const auto &pl : m_pointLights) {
           glUniform3fv(locLightPos, 1, &pl.position[0]);
           glUniform1f(locFarPlane, pl.farPlane);
 
+          // Casters within reach of the light; each face filters this set.
+          m_casters.clear();
+          registry.querySphere(pl.position, pl.farPlane, m_casters);
+          std::erase_if(m_casters, [&](uint32_t idx) {
+            const Renderable &r = registry.all()[idx];
+            return r.isCamera || r.isLight || engine.isEntityHidden(r.entity);
+          });
+
           for (int face = 0; face < 6; ++face) {
             const uint32_t layer = pl.arrayIndex * 6u + (uint32_t)face;
             glNamedFramebufferTextureLayer(m_fbo, GL_DEPTH_ATTACHMENT, atlas.tex,
@@ -122,22 +136,17 @@ void PassShadowPoint::setup(RenderGraph &graph, const RenderPassContext &ctx,
             glClear(GL_DEPTH_BUFFER_BIT);
             glUniformMatrix4fv(locVP, 1, GL_FALSE, &pl.viewProj[face][0][0]);
 
-            // Render scene geometry
-            for (EntityID e : engine.world().alive()) {
-              if (!engine.world().isAlive(e) || !engine.world().hasMesh(e))
-                continue;
-              const auto &tr = engine.world().transform(e);
-              if (tr.hidden || tr.hiddenEditor || tr.disabledAnim)
+            // Render casters inside this face's frustum
+            SubmitTimer timer(m_stats);
+            const Frustum faceFrustum = Frustum::fromViewProj(pl.viewProj[face]);
+            for (uint32_t idx : m_casters) {
+              const Renderable &r = registry.all()[idx];
+              if (!frustumIntersects(faceFrustum, r.bounds.center, r.bounds.extents))
                 continue;
-
-              const auto &mesh = engine.world().mesh(e);
-              const glm::mat4 model = engine.world().worldTransform(e).world;
-              glUniformMatrix4fv(locM, 1, GL_FALSE, &model[0][0]);
-
-              for (const auto &submesh : mesh.submeshes) {
-                m_draw(submesh.type);
-              }
+              m_batch.add(m_meshes->range(static_cast<uint32_t>(r.mesh)),
+                          r.model);
             }
+            m_batch.submit(engine.uploadRing(), multiDraw, m_stats);
           }
         }
       });
@@ -1,11 +1,12 @@
 #pragma once
 
 #include "RenderPass.h"
+#include "../draw/MultiDrawBatch.h"
+#include "../gl/GLMesh.h"
 #include "../gl/GLResources.h"
 #include "../gl/GLShaderUtil.h"
 #include "../../scene/EntityID.h"
 #include <vector>
-#include <functional>
 #include <glm/glm.hpp>
 
 namespace Nyx {
@@ -23,22 +24,28 @@ public:
   ~PassShadowPoint() override;
 
   void configure(GLShaderUtil &shaders, GLResources &res,
-                 std::function<void(ProcMeshType)> drawFn);
+                 const GLMeshPool &meshes);
 
   void setup(RenderGraph &graph, const RenderPassContext &ctx,
              const RenderableRegistry &registry, EngineContext &engine,
              bool editorVisible) override;
 
+  const DrawSubmitStats &submitStats() const { return m_stats; }
+
   const std::vector<PointLightShadow>& getPointLights() const { return m_pointLights; }
 
 private:
   uint32_t m_fbo = 0;
   GLResources *m_res = nullptr;
-  std::function<void(ProcMeshType)> m_draw;
+  const GLMeshPool *m_meshes = nullptr;
+  MultiDrawBatch m_batch; // one multi-draw per shadow view
+  DrawSubmitStats m_stats{};
   
   std::vector<PointLightShadow> m_pointLights;
   uint32_t m_maxPointLights = 16;
   uint16_t m_cubemapResolution = 512;
+
+  std::vector<uint32_t> m_casters; // registry indices, reused per light
 };
 
 } // namespace Nyx
@@ -11,12 +11,13 @@ namespace Nyx {
 
 PassShadowSpot::~PassShadowSpot() {
   if (m_fbo) glDeleteFramebuffers(1, &m_fbo);
+  m_batch.shutdown();
 }
 
 void PassShadowSpot::configure(GLShaderUtil &shaders, GLResources &res,
-                               std::function<void(ProcMeshType)> drawFn) {
+                               const GLMeshPool &meshes) {
   m_res = &res;
-  m_draw = drawFn;
+  m_meshes = &meshes;
   m_prog = shaders.buildProgramVF("shadow_spot.vert", "shadow_spot.frag");
   glCreateFramebuffers(1, &m_fbo);
   m_atlasAlloc.reset(m_atlasW, m_atlasH);
@@ -27,7 +28,7 @@ void PassShadowSpot::setup(RenderGraph &graph, const RenderPassContext &ctx,
                            EngineContext &engine, bool editorVisible) {
   (void)ctx;
   (void)editorVisible;
-  (void)registry;
+  m_stats = {};
 
   graph.addPass(
       "ShadowSpot",
@@ -85,8 +86,7 @@ void PassShadowSpot::setup(RenderGraph &graph, const RenderPassContext &ctx,
         if (m_spotLights.empty()) return;
 
         glUseProgram(m_prog);
-        const int locM = glGetUniformLocation(m_prog, "u_Model");
-        const int locVP = glGetUniformLocation(m_prog, "u_ViewProj");
+        const int locVP = GLShaderUtil::uniformLocation(m_prog, "u_ViewProj");
 
         glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
         glNamedFramebufferTexture(m_fbo, GL_DEPTH_ATTACHMENT, atlas.tex, 0);
@@ -102,6 +102,10 @@ void PassShadowSpot::setup(RenderGraph &graph, const RenderPassContext &ctx,
         glDepthMask(GL_TRUE);
         glDisable(GL_CULL_FACE);
 
+        const bool multiDraw = engine.renderer().multiDrawIndirect();
+        m_meshes->bind();
+        m_batch.reset();
+
         // Render each spot light to its tile
         for (const auto &spot : m_spotLights) {
           const auto &tile = spot.tile;
@@ -113,22 +117,18 @@ void PassShadowSpot::setup(RenderGraph &graph, const RenderPassContext &ctx,
 
           glUniformMatrix4fv(locVP, 1, GL_FALSE, &spot.viewProj[0][0]);
 
-          // Render scene geometry
-          for (EntityID e : engine.world().alive()) {
-            if (!engine.world().isAlive(e) || !engine.world().hasMesh(e))
-              continue;
-            const auto &tr = engine.world().transform(e);
-            if (tr.hidden || tr.hiddenEditor || tr.disabledAnim)
+          // Render casters inside the light volume
+          SubmitTimer timer(m_stats);
+          m_casters.clear();
+          registry.queryFrustum(Frustum::fromViewProj(spot.viewProj), m_casters);
+          for (uint32_t idx : m_casters) {
+            const Renderable &r = registry.all()[idx];
+            if (r.isCamera || r.isLight || engine.isEntityHidden(r.entity))
               continue;
-
-            const auto &mesh = engine.world().mesh(e);
-            const glm::mat4 model = engine.world().worldTransform(e).world;
-            glUniformMatrix4fv(locM, 1, GL_FALSE, &model[0][0]);
-
-            for (const auto &submesh : mesh.submeshes) {
-              m_draw(submesh.type);
-            }
+            m_batch.add(m_meshes->range(static_cast<uint32_t>(r.mesh)),
+                        r.model);
           }
+          m_batch.submit(engine.uploadRing(), multiDraw, m_stats);
         }
 
         glDisable(GL_SCISSOR_TEST);
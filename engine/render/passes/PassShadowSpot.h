@@ -2,11 +2,12 @@
 
 #include "RenderPass.h"
 #include "../light/ShadowAtlasAllocator.h"
+#include "../draw/MultiDrawBatch.h"
+#include "../gl/GLMesh.h"
 #include "../gl/GLResources.h"
 #include "../gl/GLShaderUtil.h"
 #include "../../scene/EntityID.h"
 #include <vector>
-#include <functional>
 #include <glm/glm.hpp>
 
 namespace Nyx {
@@ -26,23 +27,29 @@ public:
   ~PassShadowSpot() override;
 
   void configure(GLShaderUtil &shaders, GLResources &res,
-                 std::function<void(ProcMeshType)> drawFn);
+                 const GLMeshPool &meshes);
 
   void setup(RenderGraph &graph, const RenderPassContext &ctx,
              const RenderableRegistry &registry, EngineContext &engine,
              bool editorVisible) override;
 
+  const DrawSubmitStats &submitStats() const { return m_stats; }
+
   const std::vector<SpotLightShadow>& getSpotLights() const { return m_spotLights; }
 
 private:
   uint32_t m_fbo = 0;
   GLResources *m_res = nullptr;
-  std::function<void(ProcMeshType)> m_draw;
+  const GLMeshPool *m_meshes = nullptr;
+  MultiDrawBatch m_batch; // one multi-draw per shadow view
+  DrawSubmitStats m_stats{};
   
   SpotShadowAtlasAllocator m_atlasAlloc;
   std::vector<SpotLightShadow> m_spotLights;
   uint16_t m_atlasW = 2048;
   uint16_t m_atlasH = 2048;
+
+  std::vector<uint32_t> m_casters; // registry indices, reused per light
 };
 
 } // namespace Nyx
@@ -44,8 +44,10 @@ void PassTonemap::setup(RenderGraph &graph, const RenderPassContext &ctx,
         glUseProgram(m_prog);
 
         // uniforms
-        const GLint locExp = glGetUniformLocation(m_prog, "u_Exposure");
-        const GLint locGam = glGetUniformLocation(m_prog, "u_ApplyGamma");
+        const GLint locExp =
+            GLShaderUtil::uniformLocation(m_prog, "u_Exposure");
+        const GLint locGam =
+            GLShaderUtil::uniformLocation(m_prog, "u_ApplyGamma");
         if (locExp >= 0)
           glUniform1f(locExp, exposure);
         if (locGam >= 0)
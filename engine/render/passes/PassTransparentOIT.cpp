@@ -84,11 +84,7 @@ void PassTransparentOIT::setup(RenderGraph &graph, const RenderPassContext &ctx,
         glUseProgram(m_prog);
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kMaterialsBinding,
                          engine.materials().ssbo());
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kPerDrawBinding,
-                         engine.perDraw().ssbo());
-
-        const int locVP = glGetUniformLocation(m_prog, "u_ViewProj");
-        glUniformMatrix4fv(locVP, 1, GL_FALSE, &rc.viewProj[0][0]);
+        engine.perDraw().bind(kPerDrawBinding);
 
         const auto &drawList = registry.transparentSorted();
         const uint32_t baseOffset = engine.perDrawTransparentOffset();
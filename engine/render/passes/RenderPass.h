@@ -21,17 +21,31 @@ public:
 protected:
   uint32_t m_prog = 0;
 
+  // Names are hashed at compile time; the lookup is a probe into the
+  // blackboard's flat table. Refs from the builder skip even that.
   static const GLTexture2D &tex(RenderResourceBlackboard &bb, RGResources &rg,
-                                const char *name) {
+                                RGName name) {
     RGTextureRef ref = bb.getTexture(name);
     NYX_ASSERT(ref != InvalidRGTexture, "Missing RG texture");
     return rg.tex(bb.textureHandle(ref));
   }
 
+  static const GLTexture2D &tex(RenderResourceBlackboard &bb, RGResources &rg,
+                                RGTextureRef ref) {
+    NYX_ASSERT(ref != InvalidRGTexture, "Missing RG texture");
+    return rg.tex(bb.textureHandle(ref));
+  }
+
   static const GLBuffer &buf(RenderResourceBlackboard &bb, RGResources &rg,
-                             const char *name) {
+                             RGName name) {
     RGBufferRef ref = bb.getBuffer(name);
     NYX_ASSERT(ref != InvalidRGBuffer, "Missing RG buffer");
+    return buf(bb, rg, ref);
+  }
+
+  static const GLBuffer &buf(RenderResourceBlackboard &bb, RGResources &rg,
+                             RGBufferRef ref) {
+    NYX_ASSERT(ref != InvalidRGBuffer, "Missing RG buffer");
     if (bb.isExternalBuffer(ref))
       return bb.externalBuffer(ref);
     return rg.buf(bb.bufferHandle(ref));
@@ -9,6 +9,7 @@ enum class RGFormat : uint8_t {
   RGBA8,
   R32UI,
   R32F,
+  RG32F,
   Depth32F
 };
 
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Nyx {
+
+// RenderGraph resource name, hashed at compile time. String literals convert
+// implicitly, so `getTexture("HDR.Color")` and friends never hash or copy a
+// string at runtime. The literal itself rides along for logs and
+// dumpGraphDot(); it has static storage, so keeping it costs nothing.
+struct RGName {
+  uint64_t hash = 0;
+  const char *str = "";
+
+  RGName() = default;
+
+  template <size_t N>
+  consteval RGName(const char (&s)[N])
+      : hash(hashOf(std::string_view(s, N - 1))), str(s) {}
+
+  // FNV-1a 64-bit.
+  static constexpr uint64_t hashOf(std::string_view s) {
+    uint64_t h = 14695981039346656037ULL;
+    for (char c : s) {
+      h ^= static_cast<uint64_t>(static_cast<uint8_t>(c));
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+};
+
+// Open-addressed hash -> index map over RGName hashes. The hash is already
+// well mixed, so slots are picked from its low bits and probed linearly.
+class RGNameTable final {
+public:
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  void clear() {
+    for (Slot &s : m_slots)
+      s.index = kNone;
+    m_count = 0;
+  }
+
+  uint32_t find(uint64_t hash) const {
+    if (m_slots.empty())
+      return kNone;
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      const Slot &s = m_slots[i];
+      if (s.index == kNone || s.hash == hash)
+        return s.index;
+    }
+  }
+
+  void insert(uint64_t hash, uint32_t index) {
+    if ((m_count + 1) * 2 > m_slots.size())
+      grow();
+    place(hash, index);
+    ++m_count;
+  }
+
+private:
+  struct Slot {
+    uint64_t hash = 0;
+    uint32_t index = kNone;
+  };
+
+  std::vector<Slot> m_slots;
+  size_t m_count = 0;
+
+  void place(uint64_t hash, uint32_t index) {
+    const size_t mask = m_slots.size() - 1;
+    size_t i = hash & mask;
+    while (m_slots[i].index != kNone)
+      i = (i + 1) & mask;
+    m_slots[i] = Slot{hash, index};
+  }
+
+  void grow() {
+    std::vector<Slot> old = std::move(m_slots);
+    m_slots.assign(old.empty() ? 64 : old.size() * 2, Slot{});
+    for (const Slot &s : old) {
+      if (s.index != kNone)
+        place(s.hash, s.index);
+    }
+  }
+};
+
+} // namespace Nyx
@@ -5,21 +5,61 @@
 #include "render/rg/RGFormat.h"
 #include "render/rg/RGResource.h"
 
+#include <algorithm>
 #include <glad/glad.h>
 
 namespace Nyx {
 
-RGHandle RGResources::acquireTex(const char *debugName, const RGTexDesc &desc) {
-  // Try reuse existing alive texture with same desc
-  for (uint32_t i = 0; i < m_tex.size(); ++i) {
-    RGTexture &tex = m_tex[i];
-    if (tex.alive && tex.desc == desc) {
-      tex.lastUsedFrame = m_frame;
-      return makeHandle(i);
-    }
+// FNV-1a over the desc fields. RGNameTable picks slots from the low bits,
+// which a multiply only feeds from below, so fold the high half back in.
+static uint64_t hashTexDesc(const RGTexDesc &d) {
+  const uint32_t words[] = {d.w,    d.h,    d.layers,
+                            d.mips, (uint32_t)d.fmt, (uint32_t)d.usage};
+  uint64_t h = 14695981039346656037ULL;
+  for (uint32_t w : words) {
+    h ^= w;
+    h *= 1099511628211ULL;
+  }
+  return h ^ (h >> 32);
+}
+
+static uint32_t bytesPerTexel(RGFormat f) {
+  switch (f) {
+  case RGFormat::RGBA16F:
+  case RGFormat::RG32F:
+    return 8;
+  default:
+    return 4;
   }
+}
+
+static uint64_t texBytes(const RGTexDesc &d) {
+  uint64_t texels = 0;
+  for (uint32_t m = 0; m < std::max(1u, d.mips); ++m)
+    texels += uint64_t(std::max(1u, d.w >> m)) * std::max(1u, d.h >> m);
+  return texels * std::max(1u, d.layers) * bytesPerTexel(d.fmt);
+}
 
-  // Allocate new or reuse free slot
+uint32_t RGResources::bucketFor(const RGTexDesc &desc) {
+  const uint64_t hash = hashTexDesc(desc);
+  uint32_t b = m_bucketIndex.find(hash);
+  if (b == RGNameTable::kNone) {
+    b = static_cast<uint32_t>(m_buckets.size());
+    m_buckets.push_back(TexBucket{desc, {}});
+    m_bucketIndex.insert(hash, b);
+  }
+  NYX_ASSERT(m_buckets[b].desc == desc,
+             "RGResources: texture desc hash collision");
+  return b;
+}
+
+void RGResources::updatePeaks() {
+  m_stats.peakLiveBytes = std::max(m_stats.peakLiveBytes, m_stats.liveBytes);
+  m_stats.peakResidentBytes = std::max(
+      m_stats.peakResidentBytes, m_stats.liveBytes + m_stats.pooledBytes);
+}
+
+RGHandle RGResources::createTex(const RGTexDesc &desc) {
   uint32_t idx = 0;
   if (!m_free.empty()) {
     idx = m_free.back();
@@ -29,17 +69,14 @@ RGHandle RGResources::acquireTex(const char *debugName, const RGTexDesc &desc) {
     m_tex.push_back(RGTexture{});
   }
 
+  // A fresh GL texture gets a fresh generation; pooled reuse keeps it.
   auto &slot = m_tex[idx];
-  if (slot.alive) {
-    m_res.releaseTexture2D(slot.tex);
-    slot.alive = false;
-  }
-
   slot.desc = desc;
+  slot.bytes = texBytes(desc);
+  slot.bucket = bucketFor(desc);
   slot.lastUsedFrame = m_frame;
   slot.alive = true;
   slot.gen = (slot.gen == 0 ? 1 : slot.gen + 1);
-
   slot.tex = m_res.acquireTexture2D({
       .w = desc.w,
       .h = desc.h,
@@ -49,44 +86,42 @@ RGHandle RGResources::acquireTex(const char *debugName, const RGTexDesc &desc) {
       .usage = desc.usage,
   });
 
+  ++m_stats.creations;
+  ++m_stats.liveTextures;
+  m_stats.liveBytes += slot.bytes;
+  updatePeaks();
   return makeHandle(idx);
 }
 
-RGHandle RGResources::allocateTex(const char *debugName, const RGTexDesc &desc) {
+RGHandle RGResources::acquireTex(const char *debugName, const RGTexDesc &desc) {
   (void)debugName;
-  uint32_t idx = 0;
-  if (!m_free.empty()) {
-    idx = m_free.back();
-    m_free.pop_back();
-  } else {
-    idx = static_cast<uint32_t>(m_tex.size());
-    m_tex.push_back(RGTexture{});
-  }
+  ++m_stats.acquires;
 
-  auto &slot = m_tex[idx];
-  if (slot.tex.tex != 0 && !(slot.desc == desc)) {
-    m_res.releaseTexture2D(slot.tex);
-  }
+  TexBucket &bucket = m_buckets[bucketFor(desc)];
+  if (bucket.free.empty())
+    return createTex(desc);
 
-  slot.desc = desc;
-  slot.lastUsedFrame = m_frame;
+  const uint32_t idx = bucket.free.back();
+  bucket.free.pop_back();
+  RGTexture &slot = m_tex[idx];
   slot.alive = true;
-  slot.gen = (slot.gen == 0 ? 1 : slot.gen + 1);
-
-  if (slot.tex.tex == 0) {
-    slot.tex = m_res.acquireTexture2D({
-        .w = desc.w,
-        .h = desc.h,
-        .layers = desc.layers,
-        .mips = desc.mips,
-        .fmt = desc.fmt,
-        .usage = desc.usage,
-    });
-  }
+  slot.lastUsedFrame = m_frame;
 
+  ++m_stats.reuses;
+  --m_stats.pooledTextures;
+  ++m_stats.liveTextures;
+  m_stats.pooledBytes -= slot.bytes;
+  m_stats.liveBytes += slot.bytes;
+  updatePeaks();
   return makeHandle(idx);
 }
 
+RGHandle RGResources::allocateTex(const char *debugName, const RGTexDesc &desc) {
+  (void)debugName;
+  ++m_stats.acquires;
+  return createTex(desc);
+}
+
 void RGResources::releaseTex(RGHandle h) {
   if (h == InvalidRG)
     return;
@@ -97,7 +132,46 @@ void RGResources::releaseTex(RGHandle h) {
     return;
   tex.alive = false;
   tex.lastUsedFrame = m_frame;
-  m_free.push_back(h.idx);
+  m_buckets[tex.bucket].free.push_back(h.idx);
+
+  --m_stats.liveTextures;
+  ++m_stats.pooledTextures;
+  m_stats.liveBytes -= tex.bytes;
+  m_stats.pooledBytes += tex.bytes;
+}
+
+void RGResources::retainTex(RGHandle h) {
+  if (h == InvalidRG || h.idx >= m_tex.size())
+    return;
+  RGTexture &tex = m_tex[h.idx];
+  if (tex.alive || tex.gen != h.gen || tex.tex.tex == 0)
+    return;
+  std::vector<uint32_t> &free = m_buckets[tex.bucket].free;
+  const auto it = std::find(free.begin(), free.end(), h.idx);
+  NYX_ASSERT(it != free.end(),
+             "RGResources: pooled texture not in its free list");
+  *it = free.back();
+  free.pop_back();
+  tex.alive = true;
+  tex.lastUsedFrame = m_frame;
+
+  ++m_stats.liveTextures;
+  --m_stats.pooledTextures;
+  m_stats.liveBytes += tex.bytes;
+  m_stats.pooledBytes -= tex.bytes;
+  updatePeaks();
+}
+
+// Caller removes the index from its bucket's free list.
+void RGResources::evictTex(uint32_t idx) {
+  RGTexture &tex = m_tex[idx];
+  m_res.releaseTexture2D(tex.tex);
+  m_stats.pooledBytes -= tex.bytes;
+  --m_stats.pooledTextures;
+  ++m_stats.evictions;
+  tex.bytes = 0;
+  tex.bucket = UINT32_MAX;
+  m_free.push_back(idx);
 }
 
 const GLTexture2D &RGResources::tex(RGHandle h) const {
@@ -223,29 +297,48 @@ const RGBufferDesc &RGResources::bufDesc(RGBufHandle h) const {
 }
 
 void RGResources::gc(uint32_t keepFrames) {
-  for (uint32_t i = 0; i < m_tex.size(); ++i) {
-    auto &t = m_tex[i];
-    if (!t.alive) continue;
-    if ((m_frame  - t.lastUsedFrame) > keepFrames) {
-      m_res.releaseTexture2D(t.tex);
-      t.alive = false;
-      m_free.push_back(i);
+  auto idleFrames = [&](uint32_t lastUsed) {
+    return m_frame > lastUsed ? m_frame - lastUsed : 0u;
+  };
+
+  for (TexBucket &bucket : m_buckets) {
+    std::erase_if(bucket.free, [&](uint32_t i) {
+      if (idleFrames(m_tex[i].lastUsedFrame) <= keepFrames)
+        return false;
+      evictTex(i);
+      return true;
+    });
+  }
+
+  // Live textures belong to the compiled graph; only the pool can shrink.
+  const uint64_t budget = m_stats.budgetBytes;
+  if (budget != 0 && m_stats.pooledBytes > 0 &&
+      m_stats.liveBytes + m_stats.pooledBytes > budget) {
+    std::vector<uint32_t> pooled;
+    pooled.reserve(m_stats.pooledTextures);
+    for (const TexBucket &bucket : m_buckets)
+      pooled.insert(pooled.end(), bucket.free.begin(), bucket.free.end());
+    std::sort(pooled.begin(), pooled.end(), [&](uint32_t a, uint32_t b) {
+      return m_tex[a].lastUsedFrame < m_tex[b].lastUsedFrame;
+    });
+    for (uint32_t i : pooled) {
+      if (m_stats.liveBytes + m_stats.pooledBytes <= budget)
+        break;
+      evictTex(i);
+    }
+    for (TexBucket &bucket : m_buckets) {
+      std::erase_if(bucket.free,
+                    [&](uint32_t i) { return m_tex[i].tex.tex == 0; });
     }
   }
 
-  for (uint32_t i = 0; i < m_buf.size(); ++i) {
-    auto &b = m_buf[i];
-    if (!b.alive)
+  // Released buffers keep their GL buffer until the slot is reused.
+  for (RGBuffer &b : m_buf) {
+    if (b.alive || b.buf.buf == 0 || idleFrames(b.lastUsedFrame) <= keepFrames)
       continue;
-    if ((m_frame - b.lastUsedFrame) > keepFrames) {
-      if (b.buf.buf != 0) {
-        glDeleteBuffers(1, &b.buf.buf);
-        b.buf.buf = 0;
-      }
-      b.buf.byteSize = 0;
-      b.alive = false;
-      m_freeBuf.push_back(i);
-    }
+    glDeleteBuffers(1, &b.buf.buf);
+    b.buf.buf = 0;
+    b.buf.byteSize = 0;
   }
 }
 
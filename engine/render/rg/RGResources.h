@@ -1,6 +1,7 @@
 #pragma once
 
 #include "RGDesc.h"
+#include "RGName.h"
 #include "RGResource.h"
 
 #include "../gl/GLResources.h"
@@ -12,9 +13,11 @@ namespace Nyx {
 struct RGTexture {
   GLTexture2D tex{};
   RGTexDesc desc{};
+  uint64_t bytes = 0;
+  uint32_t bucket = UINT32_MAX; // desc bucket while it owns a texture
   uint32_t gen = 1;
   uint32_t lastUsedFrame = 0;
-  bool alive = false;
+  bool alive = false; // handed out; otherwise pooled (tex != 0) or empty
 };
 
 struct RGBuffer {
@@ -25,6 +28,29 @@ struct RGBuffer {
   bool alive = false;
 };
 
+struct RGTransientStats {
+  uint64_t liveBytes = 0;   // textures handed out
+  uint64_t pooledBytes = 0; // released, kept for reuse
+  uint64_t peakLiveBytes = 0;
+  uint64_t peakResidentBytes = 0; // live + pooled
+  uint64_t budgetBytes = 512ull << 20; // 0: no budget
+  uint32_t liveTextures = 0;
+  uint32_t pooledTextures = 0;
+  uint32_t acquires = 0; // since startup
+  uint32_t reuses = 0;   // acquires served from a free list
+  uint32_t creations = 0;
+  uint32_t evictions = 0; // pooled textures freed by gc()
+
+  float reuseRate() const {
+    return acquires ? float(reuses) / float(acquires) : 0.0f;
+  }
+};
+
+// Transient render graph textures. Released textures keep their GL object
+// and handle and wait in a free list per RGTexDesc (found through a desc
+// hash), so a later acquire with the same desc gets them back. gc() frees
+// pooled textures that went unused for too long, or oldest first while the
+// pool is over the VRAM budget.
 class RGResources {
 public:
   explicit RGResources(GLResources &res) : m_res(res) {}
@@ -35,10 +61,14 @@ public:
     m_fbH = h;
   }
 
-  // Acquire a texture resource matching the description
+  // Pooled texture matching `desc`; creates one if its free list is empty.
   RGHandle acquireTex(const char *debugName, const RGTexDesc &desc);
+  // Always a new texture.
   RGHandle allocateTex(const char *debugName, const RGTexDesc &desc);
+  // Back to its desc's free list; the handle stays valid for retainTex().
   void releaseTex(RGHandle h);
+  // Takes a released texture back out of its free list.
+  void retainTex(RGHandle h);
 
   // Resolve handle -> GLTexture2D
   const GLTexture2D &tex(RGHandle h) const;
@@ -54,9 +84,16 @@ public:
   GLBuffer &buf(RGBufHandle h);
   const RGBufferDesc &bufDesc(RGBufHandle h) const;
 
-  // Void: GC not used recently
+  // Frees pooled textures and released buffers unused for more than
+  // `keepFrames`, then the least recently used pooled textures while over
+  // the budget. Nothing handed out is touched.
   void gc(uint32_t keepFrames = 120);
 
+  // 0: no budget.
+  void setBudgetBytes(uint64_t bytes) { m_stats.budgetBytes = bytes; }
+  uint64_t budgetBytes() const { return m_stats.budgetBytes; }
+  const RGTransientStats &stats() const { return m_stats; }
+
   uint32_t fbW() const { return m_fbW; }
   uint32_t fbH() const { return m_fbH; }
 
@@ -65,12 +102,25 @@ private:
   uint32_t m_frame = 0;
   uint32_t m_fbW = 1, m_fbH = 1;
 
+  struct TexBucket {
+    RGTexDesc desc{};
+    std::vector<uint32_t> free; // pooled m_tex indices
+  };
+
   std::vector<RGTexture> m_tex;
-  std::vector<uint32_t> m_free;
+  std::vector<uint32_t> m_free; // slots without a texture
+  std::vector<TexBucket> m_buckets;
+  RGNameTable m_bucketIndex; // desc hash -> m_buckets index
+  RGTransientStats m_stats{};
 
   std::vector<RGBuffer> m_buf;
   std::vector<uint32_t> m_freeBuf;
 
+  uint32_t bucketFor(const RGTexDesc &desc);
+  RGHandle createTex(const RGTexDesc &desc);
+  void evictTex(uint32_t idx);
+  void updatePeaks();
+
   RGHandle makeHandle(uint32_t idx) { return RGHandle{idx, m_tex[idx].gen}; }
   RGBufHandle makeBufHandle(uint32_t idx) {
     return RGBufHandle{idx, m_buf[idx].gen};
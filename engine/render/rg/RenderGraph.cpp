@@ -4,14 +4,12 @@
 
 namespace Nyx {
 
+// The m_last* debug data describes the compiled graph and outlives reset().
 void RenderGraph::reset() {
+  m_buildStart = std::chrono::steady_clock::now();
   m_blackboard.reset();
   m_passes.clear();
   m_legacy.clear();
-  m_lastOrder.clear();
-  m_lastEdges.clear();
-  m_lastLifetimes.clear();
-  m_lastResolved.clear();
 }
 
 void RenderGraph::addPass(std::string name, SetupFn setup, ExecuteFn exec) {
@@ -1,18 +1,20 @@
 #pragma once
 
 #include "render/rg/RGDesc.h"
+#include "render/rg/RGName.h"
 #include "render/rg/RGResource.h"
 #include "render/rg/RGResources.h"
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace Nyx {
 
 struct RenderPassContext;
+class GLGpuTimer;
 
 enum class RenderAccess : uint32_t {
   None = 0,
@@ -24,6 +26,7 @@ enum class RenderAccess : uint32_t {
   SSBORead = 1u << 5,
   SSBOWrite = 1u << 6,
   UBORead = 1u << 7,
+  IndirectRead = 1u << 8, // draw/dispatch indirect arguments
 };
 
 inline RenderAccess operator|(RenderAccess a, RenderAccess b) {
@@ -81,26 +84,26 @@ class RenderResourceBlackboard final {
 public:
   void reset();
 
-  RGTextureRef declareTexture(const std::string &name,
-                              const RenderTextureDesc &desc);
-  RGTextureRef getTexture(const std::string &name) const;
+  RGTextureRef declareTexture(RGName name, const RenderTextureDesc &desc);
+  RGTextureRef getTexture(RGName name) const;
 
   const RenderTextureDesc &textureDesc(RGTextureRef ref) const;
   RGHandle textureHandle(RGTextureRef ref) const;
   void setTextureHandle(RGTextureRef ref, RGHandle handle);
 
-  const std::string &textureName(RGTextureRef ref) const;
+  const char *textureName(RGTextureRef ref) const;
+  uint64_t textureNameHash(RGTextureRef ref) const;
   uint32_t textureCount() const { return (uint32_t)m_textures.size(); }
 
-  RGBufferRef declareBuffer(const std::string &name,
-                            const RGBufferDesc &desc);
-  RGBufferRef getBuffer(const std::string &name) const;
+  RGBufferRef declareBuffer(RGName name, const RGBufferDesc &desc);
+  RGBufferRef getBuffer(RGName name) const;
 
   const RGBufferDesc &bufferDesc(RGBufferRef ref) const;
   RGBufHandle bufferHandle(RGBufferRef ref) const;
   void setBufferHandle(RGBufferRef ref, RGBufHandle handle);
 
-  const std::string &bufferName(RGBufferRef ref) const;
+  const char *bufferName(RGBufferRef ref) const;
+  uint64_t bufferNameHash(RGBufferRef ref) const;
   uint32_t bufferCount() const { return (uint32_t)m_buffers.size(); }
 
   void bindExternalBuffer(RGBufferRef ref, const GLBuffer &buf);
@@ -109,16 +112,16 @@ public:
 
 private:
   struct TextureEntry {
-    std::string name;
+    RGName name;
     RenderTextureDesc desc{};
     RGHandle handle = InvalidRG;
   };
 
   std::vector<TextureEntry> m_textures;
-  std::unordered_map<std::string, uint32_t> m_texByName;
+  RGNameTable m_texByName;
 
   struct BufferEntry {
-    std::string name;
+    RGName name;
     RGBufferDesc desc{};
     RGBufHandle handle = InvalidRG;
     GLBuffer external{};
@@ -126,7 +129,7 @@ private:
   };
 
   std::vector<BufferEntry> m_buffers;
-  std::unordered_map<std::string, uint32_t> m_bufByName;
+  RGNameTable m_bufByName;
 };
 
 class RenderPassBuilder final {
@@ -136,17 +139,16 @@ public:
                     std::vector<std::pair<uint32_t, RenderAccess>> &bufUses)
       : m_bb(bb), m_texUses(texUses), m_bufUses(bufUses) {}
 
-  RGTextureRef readTexture(const std::string &name,
+  RGTextureRef readTexture(RGName name,
                            RenderAccess access = RenderAccess::SampledRead);
-  RGTextureRef writeTexture(const std::string &name,
+  RGTextureRef writeTexture(RGName name,
                             RenderAccess access = RenderAccess::ColorWrite);
-  RGTextureRef createTexture(const std::string &name,
-                             const RenderTextureDesc &desc,
+  RGTextureRef createTexture(RGName name, const RenderTextureDesc &desc,
                              RenderAccess access = RenderAccess::ColorWrite);
 
-  RGBufferRef readBuffer(const std::string &name,
+  RGBufferRef readBuffer(RGName name,
                          RenderAccess access = RenderAccess::SSBORead);
-  RGBufferRef writeBuffer(const std::string &name,
+  RGBufferRef writeBuffer(RGName name,
                           RenderAccess access = RenderAccess::SSBOWrite);
 
 private:
@@ -155,6 +157,18 @@ private:
   std::vector<std::pair<uint32_t, RenderAccess>> &m_bufUses;
 };
 
+// CPU cost of the last frame's graph, split by phase.
+struct RenderGraphStats {
+  bool cacheHit = false;
+  uint32_t compiles = 0; // since startup
+  uint32_t passCount = 0;
+  uint32_t textureCount = 0;
+  uint32_t bufferCount = 0;
+  double buildMs = 0.0;   // reset() -> execute(): declarations + pass setup
+  double compileMs = 0.0; // structural hash, plus the compile on a miss
+  double executeMs = 0.0; // barriers + exec callbacks
+};
+
 class RenderGraph final {
 public:
   using SetupFn =
@@ -165,12 +179,10 @@ public:
 
   void reset();
 
-  RGTextureRef declareTexture(const std::string &name,
-                              const RenderTextureDesc &desc) {
+  RGTextureRef declareTexture(RGName name, const RenderTextureDesc &desc) {
     return m_blackboard.declareTexture(name, desc);
   }
-  RGBufferRef declareBuffer(const std::string &name,
-                            const RGBufferDesc &desc) {
+  RGBufferRef declareBuffer(RGName name, const RGBufferDesc &desc) {
     return m_blackboard.declareBuffer(name, desc);
   }
   RenderResourceBlackboard &blackboard() { return m_blackboard; }
@@ -178,8 +190,20 @@ public:
 
   void addPass(std::string name, SetupFn setup, ExecuteFn exec);
 
+  // Compiles on the first frame and whenever the structural hash (resources,
+  // resolved extents, passes and their accesses) changes; otherwise reuses
+  // the previous order, texture/buffer assignment and barriers.
   void execute(const RenderPassContext &ctx, RGResources &rg);
 
+  // Off: compile every frame (for comparing against the cached path).
+  void setCacheEnabled(bool enabled) { m_cacheEnabled = enabled; }
+  bool cacheEnabled() const { return m_cacheEnabled; }
+  const RenderGraphStats &stats() const { return m_stats; }
+
+  // Each pass of execute() gets a CPU profile scope and, when set, a GPU
+  // timestamp pair under its name.
+  void setGpuTimer(GLGpuTimer *timer) { m_gpuTimer = timer; }
+
   void enableDebug(const std::string &dotPath, bool dumpLifetimes);
   void enableValidation(bool enabled) { m_validate = enabled; }
   void dumpGraphDot() const;
@@ -208,11 +232,27 @@ private:
   std::vector<PassNode> m_passes;
   std::vector<LegacyPass> m_legacy;
 
-  struct AliasEntry {
-    RGHandle handle = InvalidRG;
-    RGTexDesc desc{};
+  // Everything execute() derives from the graph's structure. Holds on to
+  // its textures and buffers until the next compile.
+  struct CompiledGraph {
+    uint64_t hash = 0;
+    bool valid = false;
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> barriers; // GLbitfield per entry of `order`
+    std::vector<const char *> names; // interned pass name per entry
+    std::vector<RGHandle> texHandles;
+    std::vector<RGBufHandle> bufHandles;
   };
-  std::vector<AliasEntry> m_aliasPool;
+  CompiledGraph m_compiled;
+  bool m_cacheEnabled = true;
+  RenderGraphStats m_stats;
+  GLGpuTimer *m_gpuTimer = nullptr;
+  std::chrono::steady_clock::time_point m_buildStart{};
+
+  uint64_t structuralHash(const RenderPassContext &ctx) const;
+  void validate() const;
+  bool compile(const RenderPassContext &ctx, RGResources &rg);
+  void releaseCompiled(RGResources &rg);
 
   bool m_debugEnabled = false;
   bool m_debugDumpLifetimes = false;
@@ -220,6 +260,7 @@ private:
   bool m_validate = true;
   std::vector<uint32_t> m_lastOrder;
   std::vector<std::vector<uint32_t>> m_lastEdges;
+  std::vector<std::vector<const char *>> m_lastEdgeNames; // resource per edge
   std::vector<std::pair<uint32_t, uint32_t>> m_lastLifetimes;
   std::vector<RGTexDesc> m_lastResolved;
 };
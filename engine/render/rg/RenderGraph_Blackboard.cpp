@@ -2,6 +2,8 @@
 
 #include "core/Assert.h"
 
+#include <cstring>
+
 namespace Nyx {
 
 void RenderResourceBlackboard::reset() {
@@ -12,10 +14,12 @@ void RenderResourceBlackboard::reset() {
 }
 
 RGTextureRef RenderResourceBlackboard::declareTexture(
-    const std::string &name, const RenderTextureDesc &desc) {
-  auto it = m_texByName.find(name);
-  if (it != m_texByName.end()) {
-    const uint32_t idx = it->second;
+    RGName name, const RenderTextureDesc &desc) {
+  const uint32_t found = m_texByName.find(name.hash);
+  if (found != RGNameTable::kNone) {
+    const uint32_t idx = found;
+    NYX_ASSERT(std::strcmp(m_textures[idx].name.str, name.str) == 0,
+               "RenderGraph texture name hash collision");
     NYX_ASSERT(m_textures[idx].desc.format == desc.format,
                "RenderGraph texture desc mismatch");
     NYX_ASSERT(m_textures[idx].desc.usage == desc.usage,
@@ -35,15 +39,15 @@ RGTextureRef RenderResourceBlackboard::declareTexture(
 
   const uint32_t idx = (uint32_t)m_textures.size();
   m_textures.push_back(TextureEntry{.name = name, .desc = desc});
-  m_texByName.emplace(name, idx);
+  m_texByName.insert(name.hash, idx);
   return RGTextureRef{idx + 1};
 }
 
-RGTextureRef RenderResourceBlackboard::getTexture(const std::string &name) const {
-  auto it = m_texByName.find(name);
-  if (it == m_texByName.end())
+RGTextureRef RenderResourceBlackboard::getTexture(RGName name) const {
+  const uint32_t idx = m_texByName.find(name.hash);
+  if (idx == RGNameTable::kNone)
     return InvalidRGTexture;
-  return RGTextureRef{it->second + 1};
+  return RGTextureRef{idx + 1};
 }
 
 const RenderTextureDesc &
@@ -69,18 +73,27 @@ void RenderResourceBlackboard::setTextureHandle(RGTextureRef ref,
   m_textures[idx].handle = handle;
 }
 
-const std::string &RenderResourceBlackboard::textureName(RGTextureRef ref) const {
+const char *RenderResourceBlackboard::textureName(RGTextureRef ref) const {
+  NYX_ASSERT(ref != InvalidRGTexture, "Invalid RGTextureRef");
+  const uint32_t idx = ref.id - 1;
+  NYX_ASSERT(idx < m_textures.size(), "Invalid RGTextureRef");
+  return m_textures[idx].name.str;
+}
+
+uint64_t RenderResourceBlackboard::textureNameHash(RGTextureRef ref) const {
   NYX_ASSERT(ref != InvalidRGTexture, "Invalid RGTextureRef");
   const uint32_t idx = ref.id - 1;
   NYX_ASSERT(idx < m_textures.size(), "Invalid RGTextureRef");
-  return m_textures[idx].name;
+  return m_textures[idx].name.hash;
 }
 
 RGBufferRef RenderResourceBlackboard::declareBuffer(
-    const std::string &name, const RGBufferDesc &desc) {
-  auto it = m_bufByName.find(name);
-  if (it != m_bufByName.end()) {
-    const uint32_t idx = it->second;
+    RGName name, const RGBufferDesc &desc) {
+  const uint32_t found = m_bufByName.find(name.hash);
+  if (found != RGNameTable::kNone) {
+    const uint32_t idx = found;
+    NYX_ASSERT(std::strcmp(m_buffers[idx].name.str, name.str) == 0,
+               "RenderGraph buffer name hash collision");
     NYX_ASSERT(m_buffers[idx].desc == desc,
                "RenderGraph buffer desc mismatch");
     return RGBufferRef{idx + 1};
@@ -88,15 +101,15 @@ RGBufferRef RenderResourceBlackboard::declareBuffer(
 
   const uint32_t idx = (uint32_t)m_buffers.size();
   m_buffers.push_back(BufferEntry{.name = name, .desc = desc});
-  m_bufByName.emplace(name, idx);
+  m_bufByName.insert(name.hash, idx);
   return RGBufferRef{idx + 1};
 }
 
-RGBufferRef RenderResourceBlackboard::getBuffer(const std::string &name) const {
-  auto it = m_bufByName.find(name);
-  if (it == m_bufByName.end())
+RGBufferRef RenderResourceBlackboard::getBuffer(RGName name) const {
+  const uint32_t idx = m_bufByName.find(name.hash);
+  if (idx == RGNameTable::kNone)
     return InvalidRGBuffer;
-  return RGBufferRef{it->second + 1};
+  return RGBufferRef{idx + 1};
 }
 
 const RGBufferDesc &
@@ -122,11 +135,18 @@ void RenderResourceBlackboard::setBufferHandle(RGBufferRef ref,
   m_buffers[idx].handle = handle;
 }
 
-const std::string &RenderResourceBlackboard::bufferName(RGBufferRef ref) const {
+const char *RenderResourceBlackboard::bufferName(RGBufferRef ref) const {
+  NYX_ASSERT(ref != InvalidRGBuffer, "Invalid RGBufferRef");
+  const uint32_t idx = ref.id - 1;
+  NYX_ASSERT(idx < m_buffers.size(), "Invalid RGBufferRef");
+  return m_buffers[idx].name.str;
+}
+
+uint64_t RenderResourceBlackboard::bufferNameHash(RGBufferRef ref) const {
   NYX_ASSERT(ref != InvalidRGBuffer, "Invalid RGBufferRef");
   const uint32_t idx = ref.id - 1;
   NYX_ASSERT(idx < m_buffers.size(), "Invalid RGBufferRef");
-  return m_buffers[idx].name;
+  return m_buffers[idx].name.hash;
 }
 
 void RenderResourceBlackboard::bindExternalBuffer(RGBufferRef ref,
@@ -155,7 +175,7 @@ bool RenderResourceBlackboard::isExternalBuffer(RGBufferRef ref) const {
   return m_buffers[idx].externalBound;
 }
 
-RGTextureRef RenderPassBuilder::readTexture(const std::string &name,
+RGTextureRef RenderPassBuilder::readTexture(RGName name,
                                             RenderAccess access) {
   RGTextureRef ref = m_bb.getTexture(name);
   NYX_ASSERT(ref != InvalidRGTexture, "RenderGraph missing texture");
@@ -170,7 +190,7 @@ RGTextureRef RenderPassBuilder::readTexture(const std::string &name,
   return ref;
 }
 
-RGTextureRef RenderPassBuilder::writeTexture(const std::string &name,
+RGTextureRef RenderPassBuilder::writeTexture(RGName name,
                                              RenderAccess access) {
   RGTextureRef ref = m_bb.getTexture(name);
   NYX_ASSERT(ref != InvalidRGTexture, "RenderGraph missing texture");
@@ -185,7 +205,7 @@ RGTextureRef RenderPassBuilder::writeTexture(const std::string &name,
   return ref;
 }
 
-RGTextureRef RenderPassBuilder::createTexture(const std::string &name,
+RGTextureRef RenderPassBuilder::createTexture(RGName name,
                                               const RenderTextureDesc &desc,
                                               RenderAccess access) {
   RGTextureRef ref = m_bb.declareTexture(name, desc);
@@ -200,7 +220,7 @@ RGTextureRef RenderPassBuilder::createTexture(const std::string &name,
   return ref;
 }
 
-RGBufferRef RenderPassBuilder::readBuffer(const std::string &name,
+RGBufferRef RenderPassBuilder::readBuffer(RGName name,
                                           RenderAccess access) {
   RGBufferRef ref = m_bb.getBuffer(name);
   NYX_ASSERT(ref != InvalidRGBuffer, "RenderGraph missing buffer");
@@ -215,7 +235,7 @@ RGBufferRef RenderPassBuilder::readBuffer(const std::string &name,
   return ref;
 }
 
-RGBufferRef RenderPassBuilder::writeBuffer(const std::string &name,
+RGBufferRef RenderPassBuilder::writeBuffer(RGName name,
                                            RenderAccess access) {
   RGBufferRef ref = m_bb.getBuffer(name);
   NYX_ASSERT(ref != InvalidRGBuffer, "RenderGraph missing buffer");
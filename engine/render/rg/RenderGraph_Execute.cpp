@@ -2,12 +2,14 @@
 
 #include "core/Assert.h"
 #include "core/Log.h"
+#include "core/Profiler.h"
+#include "render/gl/GLGpuTimer.h"
 #include "render/rg/RenderPassContext.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <fstream>
-#include <unordered_map>
 
 #include <glad/glad.h>
 
@@ -34,7 +36,8 @@ static bool isSSBOAccess(RenderAccess a) {
 }
 
 static bool isBufferAccess(RenderAccess a) {
-  return isSSBOAccess(a) || hasAccess(a, RenderAccess::UBORead);
+  return isSSBOAccess(a) || hasAccess(a, RenderAccess::UBORead) ||
+         hasAccess(a, RenderAccess::IndirectRead);
 }
 
 static GLbitfield barrierForTransition(RenderAccess prev, RenderAccess next) {
@@ -44,6 +47,8 @@ static GLbitfield barrierForTransition(RenderAccess prev, RenderAccess next) {
     bits |= GL_SHADER_STORAGE_BARRIER_BIT;
     if (hasAccess(next, RenderAccess::UBORead))
       bits |= GL_UNIFORM_BARRIER_BIT;
+    if (hasAccess(next, RenderAccess::IndirectRead))
+      bits |= GL_COMMAND_BARRIER_BIT;
   }
 
   if (isTextureAccess(prev)) {
@@ -115,10 +120,158 @@ static RGTexDesc resolveTextureDesc(const RenderPassContext &ctx,
   return out;
 }
 
-void RenderGraph::execute(const RenderPassContext &ctx, RGResources &rg) {
-  if (m_passes.empty())
+// FNV-1a 64-bit over the fields that shape a compile.
+namespace {
+struct StructureHasher {
+  uint64_t h = 14695981039346656037ULL;
+
+  void bytes(const void *data, size_t size) {
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; ++i) {
+      h ^= static_cast<uint64_t>(p[i]);
+      h *= 1099511628211ULL;
+    }
+  }
+  void u32(uint32_t v) { bytes(&v, sizeof(v)); }
+  void u64(uint64_t v) { bytes(&v, sizeof(v)); }
+  void str(const std::string &s) {
+    u32((uint32_t)s.size());
+    bytes(s.data(), s.size());
+  }
+};
+} // namespace
+
+uint64_t RenderGraph::structuralHash(const RenderPassContext &ctx) const {
+  StructureHasher hs;
+
+  const uint32_t resourceCount = m_blackboard.textureCount();
+  hs.u32(resourceCount);
+  for (uint32_t i = 0; i < resourceCount; ++i) {
+    const RGTextureRef ref{i + 1};
+    const RGTexDesc desc = resolveTextureDesc(ctx, m_blackboard.textureDesc(ref));
+    hs.u64(m_blackboard.textureNameHash(ref));
+    hs.u32(desc.w);
+    hs.u32(desc.h);
+    hs.u32(desc.layers);
+    hs.u32(desc.mips);
+    hs.u32((uint32_t)desc.fmt);
+    hs.u32((uint32_t)desc.usage);
+  }
+
+  const uint32_t bufferCount = m_blackboard.bufferCount();
+  hs.u32(bufferCount);
+  for (uint32_t i = 0; i < bufferCount; ++i) {
+    const RGBufferRef ref{i + 1};
+    const RGBufferDesc &desc = m_blackboard.bufferDesc(ref);
+    hs.u64(m_blackboard.bufferNameHash(ref));
+    hs.u32(desc.byteSize);
+    hs.u32((uint32_t)desc.usage);
+    hs.u32(desc.dynamic ? 1u : 0u);
+    hs.u32(m_blackboard.isExternalBuffer(ref) ? 1u : 0u);
+  }
+
+  hs.u32((uint32_t)m_passes.size());
+  for (const auto &p : m_passes) {
+    hs.str(p.name);
+    hs.u32(p.exec ? 1u : 0u);
+    hs.u32((uint32_t)p.texUses.size());
+    for (const auto &use : p.texUses) {
+      hs.u32(use.first);
+      hs.u32((uint32_t)use.second);
+    }
+    hs.u32((uint32_t)p.bufUses.size());
+    for (const auto &use : p.bufUses) {
+      hs.u32(use.first);
+      hs.u32((uint32_t)use.second);
+    }
+  }
+
+  return hs.h;
+}
+
+void RenderGraph::validate() const {
+  const uint32_t resourceCount = m_blackboard.textureCount();
+  if (resourceCount == 0)
     return;
 
+  struct Usage {
+    bool used = false;
+    bool read = false;
+    bool written = false;
+  };
+  std::vector<Usage> usage(resourceCount);
+
+  for (const auto &p : m_passes) {
+    for (const auto &u : p.texUses) {
+      const uint32_t res = u.first;
+      if (res >= resourceCount)
+        continue;
+      const RenderAccess access = u.second;
+      const RenderTextureDesc &desc =
+          m_blackboard.textureDesc(RGTextureRef{res + 1});
+
+      usage[res].used = true;
+      if (isWriteAccess(access))
+        usage[res].written = true;
+      if (!isWriteAccess(access))
+        usage[res].read = true;
+
+      if (hasAccess(access, RenderAccess::ColorWrite) &&
+          !hasUsage(desc.usage, RGTexUsage::ColorAttach)) {
+        Log::Warn(
+            "RG: pass '{}' writes color to '{}' without ColorAttach usage",
+            p.name, m_blackboard.textureName(RGTextureRef{res + 1}));
+      }
+      if (hasAccess(access, RenderAccess::DepthWrite) &&
+          !hasUsage(desc.usage, RGTexUsage::DepthAttach)) {
+        Log::Warn(
+            "RG: pass '{}' writes depth to '{}' without DepthAttach usage",
+            p.name, m_blackboard.textureName(RGTextureRef{res + 1}));
+      }
+      if (hasAccess(access, RenderAccess::SampledRead) &&
+          !hasUsage(desc.usage, RGTexUsage::Sampled)) {
+        Log::Warn("RG: pass '{}' samples '{}' without Sampled usage", p.name,
+                  m_blackboard.textureName(RGTextureRef{res + 1}));
+      }
+      if ((hasAccess(access, RenderAccess::ImageRead) ||
+           hasAccess(access, RenderAccess::ImageWrite)) &&
+          !hasUsage(desc.usage, RGTexUsage::Image)) {
+        Log::Warn("RG: pass '{}' uses image '{}' without Image usage", p.name,
+                  m_blackboard.textureName(RGTextureRef{res + 1}));
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < resourceCount; ++i) {
+    if (!usage[i].used) {
+      Log::Warn("RG: texture '{}' declared but never used",
+                m_blackboard.textureName(RGTextureRef{i + 1}));
+      continue;
+    }
+    if (usage[i].read && !usage[i].written) {
+      Log::Warn("RG: texture '{}' is read but never written",
+                m_blackboard.textureName(RGTextureRef{i + 1}));
+    }
+  }
+}
+
+// Hands the compiled graph's textures and buffers back to RGResources; the
+// next compile picks the textures up again from their free lists.
+void RenderGraph::releaseCompiled(RGResources &rg) {
+  for (const RGHandle h : m_compiled.texHandles) {
+    if (h != InvalidRG)
+      rg.releaseTex(h);
+  }
+  for (const RGBufHandle h : m_compiled.bufHandles) {
+    if (h != InvalidRG)
+      rg.releaseBuf(h);
+  }
+  m_compiled = CompiledGraph{};
+}
+
+bool RenderGraph::compile(const RenderPassContext &ctx, RGResources &rg) {
+  releaseCompiled(rg);
+
   const uint32_t passCount = (uint32_t)m_passes.size();
   std::vector<std::vector<uint32_t>> edges(passCount);
   std::vector<uint32_t> indegree(passCount, 0);
@@ -127,75 +280,22 @@ void RenderGraph::execute(const RenderPassContext &ctx, RGResources &rg) {
   auto bufferCount = m_blackboard.bufferCount();
   std::vector<int32_t> lastWriter(resourceCount, -1);
   std::vector<int32_t> lastAccess(resourceCount, -1);
-  lastWriter.assign(resourceCount, -1);
-  lastAccess.assign(resourceCount, -1);
 
   std::vector<int32_t> lastBufWriter(bufferCount, -1);
   std::vector<int32_t> lastBufAccess(bufferCount, -1);
 
-  if (m_validate) {
-    if (resourceCount > 0) {
-      struct Usage {
-        bool used = false;
-        bool read = false;
-        bool written = false;
-      };
-      std::vector<Usage> usage(resourceCount);
-
-      for (const auto &p : m_passes) {
-        for (const auto &u : p.texUses) {
-          const uint32_t res = u.first;
-          if (res >= resourceCount)
-            continue;
-          const RenderAccess access = u.second;
-          const RenderTextureDesc &desc =
-              m_blackboard.textureDesc(RGTextureRef{res + 1});
-
-          usage[res].used = true;
-          if (isWriteAccess(access))
-            usage[res].written = true;
-          if (!isWriteAccess(access))
-            usage[res].read = true;
-
-          if (hasAccess(access, RenderAccess::ColorWrite) &&
-              !hasUsage(desc.usage, RGTexUsage::ColorAttach)) {
-            Log::Warn(
-                "RG: pass '{}' writes color to '{}' without ColorAttach usage",
-                p.name, m_blackboard.textureName(RGTextureRef{res + 1}));
-          }
-          if (hasAccess(access, RenderAccess::DepthWrite) &&
-              !hasUsage(desc.usage, RGTexUsage::DepthAttach)) {
-            Log::Warn(
-                "RG: pass '{}' writes depth to '{}' without DepthAttach usage",
-                p.name, m_blackboard.textureName(RGTextureRef{res + 1}));
-          }
-          if (hasAccess(access, RenderAccess::SampledRead) &&
-              !hasUsage(desc.usage, RGTexUsage::Sampled)) {
-            Log::Warn("RG: pass '{}' samples '{}' without Sampled usage", p.name,
-                      m_blackboard.textureName(RGTextureRef{res + 1}));
-          }
-          if ((hasAccess(access, RenderAccess::ImageRead) ||
-               hasAccess(access, RenderAccess::ImageWrite)) &&
-              !hasUsage(desc.usage, RGTexUsage::Image)) {
-            Log::Warn("RG: pass '{}' uses image '{}' without Image usage",
-                      p.name, m_blackboard.textureName(RGTextureRef{res + 1}));
-          }
-        }
-      }
-
-      for (uint32_t i = 0; i < resourceCount; ++i) {
-        if (!usage[i].used) {
-          Log::Warn("RG: texture '{}' declared but never used",
-                    m_blackboard.textureName(RGTextureRef{i + 1}));
-          continue;
-        }
-        if (usage[i].read && !usage[i].written) {
-          Log::Warn("RG: texture '{}' is read but never written",
-                    m_blackboard.textureName(RGTextureRef{i + 1}));
-        }
-      }
-    }
-  }
+  if (m_validate)
+    validate();
+
+  // With debug output on, every edge remembers the resource behind it.
+  std::vector<std::vector<const char *>> edgeNames;
+  if (m_debugEnabled)
+    edgeNames.resize(passCount);
+  auto addEdge = [&](uint32_t from, uint32_t to, const char *name) {
+    edges[from].push_back(to);
+    if (m_debugEnabled)
+      edgeNames[from].push_back(name);
+  };
 
   for (uint32_t i = 0; i < passCount; ++i) {
     for (const auto &use : m_passes[i].texUses) {
@@ -207,13 +307,15 @@ void RenderGraph::execute(const RenderPassContext &ctx, RGResources &rg) {
       const bool write = isWriteAccess(access);
       if (write) {
         if (lastAccess[res] >= 0) {
-          edges[(uint32_t)lastAccess[res]].push_back(i);
+          addEdge((uint32_t)lastAccess[res], i,
+                  m_blackboard.textureName(RGTextureRef{res + 1}));
         }
         lastWriter[res] = (int32_t)i;
         lastAccess[res] = (int32_t)i;
       } else {
         if (lastWriter[res] >= 0) {
-          edges[(uint32_t)lastWriter[res]].push_back(i);
+          addEdge((uint32_t)lastWriter[res], i,
+                  m_blackboard.textureName(RGTextureRef{res + 1}));
         }
         lastAccess[res] = (int32_t)i;
       }
@@ -227,13 +329,15 @@ void RenderGraph::execute(const RenderPassContext &ctx, RGResources &rg) {
       const bool write = isWriteAccess(access);
       if (write) {
         if (lastBufAccess[res] >= 0) {
-          edges[(uint32_t)lastBufAccess[res]].push_back(i);
+          addEdge((uint32_t)lastBufAccess[res], i,
+                  m_blackboard.bufferName(RGBufferRef{res + 1}));
         }
         lastBufWriter[res] = (int32_t)i;
         lastBufAccess[res] = (int32_t)i;
       } else {
         if (lastBufWriter[res] >= 0) {
-          edges[(uint32_t)lastBufWriter[res]].push_back(i);
+          addEdge((uint32_t)lastBufWriter[res], i,
+                  m_blackboard.bufferName(RGBufferRef{res + 1}));
         }
         lastBufAccess[res] = (int32_t)i;
       }
@@ -271,12 +375,13 @@ void RenderGraph::execute(const RenderPassContext &ctx, RGResources &rg) {
 
   if (order.size() != passCount) {
     NYX_ASSERT(false, "RenderGraph cycle detected");
-    return;
+    return false;
   }
 
   if (m_debugEnabled) {
     m_lastOrder = order;
     m_lastEdges = edges;
+    m_lastEdgeNames = std::move(edgeNames);
   }
 
   struct Lifetime {
@@ -306,6 +411,9 @@ void RenderGraph::execute(const RenderPassContext &ctx, RGResources &rg) {
     m_lastResolved.assign(resourceCount, RGTexDesc{});
   }
 
+  // Textures whose lifetimes do not overlap share one GL texture: a texture
+  // goes back to its desc's free list after its last pass, where a later
+  // resource with the same resolved desc picks it up.
   struct ActiveTex {
     uint32_t res = 0;
     uint32_t last = 0;
@@ -313,118 +421,145 @@ void RenderGraph::execute(const RenderPassContext &ctx, RGResources &rg) {
   std::vector<ActiveTex> active;
   active.reserve(resourceCount);
 
-  std::unordered_map<uint32_t, RGHandle> assigned;
-  assigned.reserve(resourceCount);
+  std::vector<RGHandle> &assigned = m_compiled.texHandles;
+  assigned.assign(resourceCount, InvalidRG);
 
   for (uint32_t i = 0; i < order.size(); ++i) {
-    active.erase(std::remove_if(active.begin(), active.end(), [&](ActiveTex &a) {
-                    if (a.last < i) {
-                      RGHandle h = assigned[a.res];
-                      const RGTexDesc desc = rg.desc(h);
-                      m_aliasPool.push_back(AliasEntry{h, desc});
-                      return true;
-                    }
-                    return false;
-                  }),
-                 active.end());
+    std::erase_if(active, [&](const ActiveTex &a) {
+      if (a.last >= i)
+        return false;
+      rg.releaseTex(assigned[a.res]);
+      return true;
+    });
 
     const auto &p = m_passes[order[i]];
     for (const auto &use : p.texUses) {
       const uint32_t res = use.first;
-      if (assigned.find(res) != assigned.end())
+      if (assigned[res] != InvalidRG)
         continue;
 
       const RenderTextureDesc &rt = m_blackboard.textureDesc(RGTextureRef{res + 1});
       const RGTexDesc desc = resolveTextureDesc(ctx, rt);
 
-      RGHandle handle = InvalidRG;
-      for (auto it = m_aliasPool.begin(); it != m_aliasPool.end(); ++it) {
-        if (it->desc == desc) {
-          handle = it->handle;
-          m_aliasPool.erase(it);
-          break;
-        }
-      }
-
-      if (handle == InvalidRG) {
-        handle = rg.allocateTex(m_blackboard.textureName(RGTextureRef{res + 1}).c_str(), desc);
-      }
-
+      const RGHandle handle =
+          rg.acquireTex(m_blackboard.textureName(RGTextureRef{res + 1}), desc);
       assigned[res] = handle;
-      m_blackboard.setTextureHandle(RGTextureRef{res + 1}, handle);
       active.push_back(ActiveTex{res, lifetimes[res].last});
       if (m_debugEnabled && res < m_lastResolved.size())
         m_lastResolved[res] = desc;
     }
   }
 
-  std::unordered_map<uint32_t, RenderAccess> lastAccessByRes;
-  lastAccessByRes.reserve(resourceCount);
-  std::unordered_map<uint32_t, RenderAccess> lastAccessByBuf;
-  lastAccessByBuf.reserve(bufferCount);
+  // Textures released above are still the graph's; the rest of the pool
+  // (e.g. the previous layout at the old size) is left to RGResources::gc().
+  for (const RGHandle h : assigned)
+    rg.retainTex(h);
 
-  std::vector<RGBufHandle> bufHandles;
-  bufHandles.reserve(bufferCount);
+  m_compiled.bufHandles.assign(bufferCount, InvalidRG);
   for (uint32_t i = 0; i < bufferCount; ++i) {
+    if (m_blackboard.isExternalBuffer(RGBufferRef{i + 1}))
+      continue;
     const RGBufferDesc &desc = m_blackboard.bufferDesc(RGBufferRef{i + 1});
-    RGBufHandle handle = InvalidRG;
-    if (!m_blackboard.isExternalBuffer(RGBufferRef{i + 1})) {
-      handle =
-          rg.acquireBuf(m_blackboard.bufferName(RGBufferRef{i + 1}).c_str(),
-                        desc);
-      m_blackboard.setBufferHandle(RGBufferRef{i + 1}, handle);
-    }
-    bufHandles.push_back(handle);
+    m_compiled.bufHandles[i] =
+        rg.acquireBuf(m_blackboard.bufferName(RGBufferRef{i + 1}),
+                      desc);
   }
 
+  std::vector<RenderAccess> lastAccessByRes(resourceCount, RenderAccess::None);
+  std::vector<RenderAccess> lastAccessByBuf(bufferCount, RenderAccess::None);
+
+  m_compiled.barriers.clear();
+  m_compiled.barriers.reserve(order.size());
+  m_compiled.names.clear();
+  m_compiled.names.reserve(order.size());
   for (uint32_t idx : order) {
+    m_compiled.names.push_back(Profiler::instance().intern(m_passes[idx].name));
+
     GLbitfield barrierBits = 0;
     for (const auto &use : m_passes[idx].texUses) {
-      const uint32_t res = use.first;
-      const RenderAccess access = use.second;
-      auto it = lastAccessByRes.find(res);
-      if (it != lastAccessByRes.end()) {
-        barrierBits |= barrierForTransition(it->second, access);
-      }
+      barrierBits |= barrierForTransition(lastAccessByRes[use.first], use.second);
     }
     for (const auto &use : m_passes[idx].bufUses) {
-      const uint32_t res = use.first;
-      const RenderAccess access = use.second;
-      auto it = lastAccessByBuf.find(res);
-      if (it != lastAccessByBuf.end()) {
-        barrierBits |= barrierForTransition(it->second, access);
-      }
+      if (use.first < bufferCount)
+        barrierBits |=
+            barrierForTransition(lastAccessByBuf[use.first], use.second);
     }
-
-    if (barrierBits != 0)
-      glMemoryBarrier(barrierBits);
-
-    if (m_passes[idx].exec)
-      m_passes[idx].exec(ctx, m_blackboard, rg);
+    m_compiled.barriers.push_back(barrierBits);
 
     for (const auto &use : m_passes[idx].texUses) {
       lastAccessByRes[use.first] = use.second;
     }
     for (const auto &use : m_passes[idx].bufUses) {
-      lastAccessByBuf[use.first] = use.second;
+      if (use.first < bufferCount)
+        lastAccessByBuf[use.first] = use.second;
     }
   }
 
-  for (const auto &a : active) {
-    RGHandle h = assigned[a.res];
-    const RGTexDesc desc = rg.desc(h);
-    m_aliasPool.push_back(AliasEntry{h, desc});
+  m_compiled.order = std::move(order);
+  m_compiled.valid = true;
+  return true;
+}
+
+void RenderGraph::execute(const RenderPassContext &ctx, RGResources &rg) {
+  using Clock = std::chrono::steady_clock;
+  auto msBetween = [](Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+  };
+
+  const Clock::time_point compileStart = Clock::now();
+  m_stats.buildMs = msBetween(m_buildStart, compileStart);
+  m_stats.passCount = (uint32_t)m_passes.size();
+  m_stats.textureCount = m_blackboard.textureCount();
+  m_stats.bufferCount = m_blackboard.bufferCount();
+  m_stats.cacheHit = false;
+  m_stats.compileMs = 0.0;
+  m_stats.executeMs = 0.0;
+
+  if (m_passes.empty())
+    return;
+
+  const uint64_t hash = structuralHash(ctx);
+  m_stats.cacheHit =
+      m_cacheEnabled && m_compiled.valid && m_compiled.hash == hash;
+  if (!m_stats.cacheHit) {
+    if (!compile(ctx, rg))
+      return;
+    m_compiled.hash = hash;
+    ++m_stats.compiles;
   }
 
-  for (uint32_t i = 0; i < bufferCount; ++i) {
-    if (m_blackboard.isExternalBuffer(RGBufferRef{i + 1}))
+  // reset() cleared the blackboard; hand the passes this layout's resources.
+  for (uint32_t i = 0; i < m_blackboard.textureCount(); ++i)
+    m_blackboard.setTextureHandle(RGTextureRef{i + 1}, m_compiled.texHandles[i]);
+  for (uint32_t i = 0; i < m_blackboard.bufferCount(); ++i) {
+    if (!m_blackboard.isExternalBuffer(RGBufferRef{i + 1}))
+      m_blackboard.setBufferHandle(RGBufferRef{i + 1},
+                                   m_compiled.bufHandles[i]);
+  }
+
+  const Clock::time_point executeStart = Clock::now();
+  m_stats.compileMs = msBetween(compileStart, executeStart);
+
+  for (uint32_t i = 0; i < m_compiled.order.size(); ++i) {
+    const GLbitfield barrierBits = m_compiled.barriers[i];
+    if (barrierBits != 0)
+      glMemoryBarrier(barrierBits);
+
+    const auto &pass = m_passes[m_compiled.order[i]];
+    if (!pass.exec)
       continue;
-    const RGBufHandle h = bufHandles[i];
-    if (h != InvalidRG)
-      rg.releaseBuf(h);
+    const char *name = m_compiled.names[i];
+    ProfileScope scope(name);
+    const uint32_t gpuScope =
+        m_gpuTimer ? m_gpuTimer->begin(name) : GLGpuTimer::kNone;
+    pass.exec(ctx, m_blackboard, rg);
+    if (m_gpuTimer)
+      m_gpuTimer->end(gpuScope);
   }
 
-  if (m_debugEnabled) {
+  m_stats.executeMs = msBetween(executeStart, Clock::now());
+
+  if (m_debugEnabled && !m_stats.cacheHit) {
     dumpGraphDot();
     if (m_debugDumpLifetimes)
       dumpResourceLifetimes();
@@ -454,8 +589,11 @@ void RenderGraph::dumpGraphDot() const {
     out << "  p" << i << " [label=\"" << m_passes[i].name << "\"];\n";
   }
   for (uint32_t u = 0; u < m_lastEdges.size(); ++u) {
-    for (uint32_t v : m_lastEdges[u]) {
-      out << "  p" << u << " -> p" << v << ";\n";
+    for (uint32_t e = 0; e < m_lastEdges[u].size(); ++e) {
+      out << "  p" << u << " -> p" << m_lastEdges[u][e];
+      if (u < m_lastEdgeNames.size() && e < m_lastEdgeNames[u].size())
+        out << " [label=\"" << m_lastEdgeNames[u][e] << "\"]";
+      out << ";\n";
     }
   }
   out << "}\n";
@@ -473,6 +611,8 @@ static const char *fmtName(RGFormat fmt) {
     return "R32UI";
   case RGFormat::R32F:
     return "R32F";
+  case RGFormat::RG32F:
+    return "RG32F";
   default:
     return "Unknown";
   }
@@ -484,7 +624,7 @@ void RenderGraph::dumpResourceLifetimes() const {
 
   for (uint32_t i = 0; i < m_blackboard.textureCount(); ++i) {
     RGTextureRef ref{i + 1};
-    const auto &name = m_blackboard.textureName(ref);
+    const char *name = m_blackboard.textureName(ref);
     const auto &desc = m_lastResolved.size() > i ? m_lastResolved[i]
                                                  : RGTexDesc{};
     const auto &lt = m_lastLifetimes.size() > i
@@ -10,8 +10,6 @@
 layout(location = 0) out vec4 oHDR;
 layout(location = 1) out uint oID;
 
-#define NYX_MAX_TEX 16
-#define MAT_REMAP_TEX(x) remapTex(x)
 #define MAT_UV0 (f.uv0 * gMat.mats[f.materialIndex].uvScaleOffset.xy + \
                  gMat.mats[f.materialIndex].uvScaleOffset.zw)
 
@@ -65,12 +63,7 @@ layout(std430, binding = 14) readonly buffer MaterialsSSBO {
 }
 gMat;
 
-layout(binding = 10) uniform sampler2D uTex2D[NYX_MAX_TEX];
-
-layout(std430, binding = 15) readonly buffer MaterialTexRemap { uint remap[]; }
-gTexRemap;
-
-uniform uint u_TexRemapCount;
+#include "include/MaterialTextures.glsl"
 
 layout(binding = 0) uniform samplerCube u_EnvIrradiance;
 layout(binding = 1) uniform samplerCube u_EnvPrefilter;
@@ -96,7 +89,6 @@ layout(std140, binding = 5) uniform ShadowCSMData {
 };
 
 uniform int u_HasIBL;
-uniform mat4 u_View;
 
 #include "include/forward_mrt_shadows.glsl"
 
@@ -114,39 +106,35 @@ f;
 
 const uint kInvalidTex = 0xFFFFFFFFu;
 
-uint remapTex(uint tid) {
-  if (tid == kInvalidTex || tid >= u_TexRemapCount)
-    return kInvalidTex;
-  return gTexRemap.remap[tid];
-}
-
 #define u_MaterialIndex f.materialIndex
 #include "include/MaterialCommon.glsl"
 #undef u_MaterialIndex
 
+#ifdef NYX_MATERIAL_SPECIALIZED
+// Straight-line material graph from MaterialGraphGLSL, appended after main().
+void evalMaterialSpecialized(out vec3 baseColor, out float metallic,
+                             out float roughness, out float ao,
+                             out vec3 emissive, out vec3 normalWS,
+                             out float alpha, out uint alphaMode,
+                             out float alphaCutoff);
+#endif
+
 vec2 applyUV(vec2 uv, vec4 scaleOffset) {
   return uv * scaleOffset.xy + scaleOffset.zw;
 }
 
 vec3 sampleSRGB(uint tid, vec2 uv) {
-  tid = remapTex(tid);
-  if (tid == kInvalidTex || tid >= NYX_MAX_TEX)
-    return vec3(1.0);
-  return texture(uTex2D[NONUNIFORM(tid)], uv).rgb;
+  return sampleMatTex(tid, uv, vec4(1.0)).rgb;
 }
 
 vec3 sampleLinear(uint tid, vec2 uv) {
-  tid = remapTex(tid);
-  if (tid == kInvalidTex || tid >= NYX_MAX_TEX)
-    return vec3(1.0);
-  return texture(uTex2D[NONUNIFORM(tid)], uv).rgb;
+  return sampleMatTex(tid, uv, vec4(1.0)).rgb;
 }
 
 vec3 sampleNormalTS(uint tid, vec2 uv) {
-  tid = remapTex(tid);
-  if (tid == kInvalidTex || tid >= NYX_MAX_TEX)
+  if (!matTexResident(tid))
     return vec3(0.0, 0.0, 1.0);
-  vec3 n = texture(uTex2D[NONUNIFORM(tid)], uv).xyz * 2.0 - 1.0;
+  vec3 n = sampleMatTex(tid, uv, vec4(1.0)).xyz * 2.0 - 1.0;
   return normalize(n);
 }
 
@@ -188,8 +176,13 @@ void main() {
   }
 
   if (useGraph) {
+#ifdef NYX_MATERIAL_SPECIALIZED
+    evalMaterialSpecialized(base, metallic, roughness, ao, emi, N, alpha,
+                            alphaMode, alphaCutoff);
+#else
     evalMaterial(base, metallic, roughness, ao, emi, N, alpha, alphaMode,
                  alphaCutoff);
+#endif
   } else {
     GpuMaterialPacked M = gMat.mats[f.materialIndex];
     const uint flags = materialFlagsFromPackedFloat(M.mrAoFlags.w);
@@ -227,7 +220,7 @@ void main() {
     discard;
   }
 
-  vec3 V = normalize(-(u_View * vec4(f.posW, 1.0)).xyz);
+  vec3 V = normalize(-(gView.view * vec4(f.posW, 1.0)).xyz);
 
   vec3 direct = vec3(0.0);
   uint lightCount = uLightCount;
@@ -6,18 +6,10 @@ const uint Alpha_Blend = 2u;
 #define NONUNIFORM(x) (x)
 #endif
 
-#ifndef MAT_REMAP_TEX
-#define MAT_REMAP_TEX(x) (x)
-#endif
-
 #ifndef MAT_UV0
 #define MAT_UV0 f.uv0
 #endif
 
-#ifndef NYX_MAX_TEX
-#define NYX_MAX_TEX 256
-#endif
-
 vec3 srgbToLinear(vec3 c) { return pow(c, vec3(2.2)); }
 
 vec4 regfile[128];
@@ -101,35 +93,22 @@ void evalMaterial(out vec3 baseColor, out float metallic, out float roughness,
       regfile[n.dst] = vec4(x, y, z, w);
     } else if (op == 15u /*Tex2D*/) {
       vec2 uv = regfile[n.a].xy;
-      uint texIndex = MAT_REMAP_TEX(n.extra);
-      if (texIndex == 0xFFFFFFFFu || texIndex >= NYX_MAX_TEX) {
-        regfile[n.dst] = vec4(1.0);
-      } else {
-        regfile[n.dst] = texture(uTex2D[NONUNIFORM(texIndex)], uv);
-      }
+      regfile[n.dst] = sampleMatTex(n.extra, uv, vec4(1.0));
     } else if (op == 16u /*Tex2D_SRGB*/) {
       vec2 uv = regfile[n.a].xy;
-      uint texIndex = MAT_REMAP_TEX(n.extra);
-      vec4 s = vec4(1.0);
-      if (!(texIndex == 0xFFFFFFFFu || texIndex >= NYX_MAX_TEX))
-        s = texture(uTex2D[NONUNIFORM(texIndex)], uv);
+      vec4 s = sampleMatTex(n.extra, uv, vec4(1.0));
       s.rgb = srgbToLinear(s.rgb);
       regfile[n.dst] = s;
     } else if (op == 17u /*Tex2D_MRA*/) {
       vec2 uv = regfile[n.a].xy;
-      uint texIndex = MAT_REMAP_TEX(n.extra);
-      vec4 s = vec4(1.0);
-      if (!(texIndex == 0xFFFFFFFFu || texIndex >= NYX_MAX_TEX))
-        s = texture(uTex2D[NONUNIFORM(texIndex)], uv);
+      vec4 s = sampleMatTex(n.extra, uv, vec4(1.0));
       // convention: R=metallic, G=roughness, B=AO
       regfile[n.dst] = vec4(s.r, s.g, s.b, 1.0);
     } else if (op == 18u /*NormalMapTS*/) {
       vec2 uv = regfile[n.a].xy;
-      uint texIndex = MAT_REMAP_TEX(n.extra);
       float strength = regfile[n.b].x;
-      vec3 ns = vec3(0.0, 0.0, 1.0);
-      if (!(texIndex == 0xFFFFFFFFu || texIndex >= NYX_MAX_TEX))
-        ns = decodeNormalTS(texture(uTex2D[NONUNIFORM(texIndex)], uv).xyz);
+      vec3 ns =
+          decodeNormalTS(sampleMatTex(n.extra, uv, vec4(0.5, 0.5, 1.0, 1.0)).xyz);
       ns = normalize(mix(vec3(0, 0, 1), ns, clamp(strength, 0.0, 4.0)));
       vec3 nw = normalize(TBN * ns);
       regfile[n.dst] = vec4(nw, 0);
@@ -0,0 +1,65 @@
+// Material textures, indexed directly by TextureTable index.
+// TextureTable keeps every resident texture in a layer of a sampler2DArray
+// pool bucketed by power-of-two size class; gTexSlots maps an index to its
+// (pool, layer) and the corner of the layer it fills.
+// Must match TextureTable::kFirstPoolUnit / kMaxPools / kSlotsBinding.
+
+#ifndef NONUNIFORM
+#define NONUNIFORM(x) (x)
+#endif
+
+#define NYX_TEX_POOLS 16
+
+layout(binding = 10) uniform sampler2DArray uTexPools[NYX_TEX_POOLS];
+
+// layer bit 31 (TextureTable::kSlotReconstructZ): the texture is BC5 and
+// stores only the XY of a unit normal.
+#define NYX_TEX_SLOT_RECONSTRUCT_Z 0x80000000u
+
+// uvScale all ones (TextureTable::kSlotFullUV): the texture fills its layer.
+#define NYX_TEX_SLOT_FULL_UV 0xFFFFFFFFu
+
+struct GpuTextureSlot {
+  uint pool; // 0xFFFFFFFF while loading or failed
+  uint layer;
+  uint uvScale; // unorm16 x2
+};
+
+layout(std430, binding = 15) readonly buffer MaterialTextureSlots {
+  GpuTextureSlot gTexSlots[];
+};
+
+bool matTexResident(uint tid) {
+  return tid < uint(gTexSlots.length()) &&
+         gTexSlots[tid].pool < uint(NYX_TEX_POOLS);
+}
+
+vec4 sampleMatTex(uint tid, vec2 uv, vec4 fallback) {
+  // Taken before any branch, like texture()'s implicit ones.
+  vec2 dx = dFdx(uv);
+  vec2 dy = dFdy(uv);
+  if (!matTexResident(tid))
+    return fallback;
+  GpuTextureSlot s = gTexSlots[tid];
+  uint layer = s.layer & ~NYX_TEX_SLOT_RECONSTRUCT_Z;
+  vec4 c;
+  if (s.uvScale == NYX_TEX_SLOT_FULL_UV) {
+    c = texture(uTexPools[NONUNIFORM(s.pool)], vec3(uv, float(layer)));
+  } else {
+    // Smaller than its size class: repeat the top-left corner by hand and
+    // keep bilinear taps off the unused texels past its edge.
+    vec2 scale = unpackUnorm2x16(s.uvScale);
+    vec2 halfTexel =
+        0.5 / vec2(textureSize(uTexPools[NONUNIFORM(s.pool)], 0).xy);
+    vec2 st = min(fract(uv) * scale, scale - halfTexel);
+    c = textureGrad(uTexPools[NONUNIFORM(s.pool)], vec3(st, float(layer)),
+                    dx * scale, dy * scale);
+  }
+  if ((s.layer & NYX_TEX_SLOT_RECONSTRUCT_Z) != 0u) {
+    // Rebuild Z so callers still see an RGB normal map.
+    vec2 xy = c.xy * 2.0 - 1.0;
+    c.z = sqrt(max(1.0 - dot(xy, xy), 0.0)) * 0.5 + 0.5;
+    c.w = 1.0;
+  }
+  return c;
+}
@@ -0,0 +1,12 @@
+// Per-view constants, uploaded once per frame by EngineContext.
+// Binding contract: binding = 1 (kViewUBOBinding)
+layout(std140, binding = 1) uniform ViewUBO
+{
+  mat4 view;
+  mat4 proj;
+  mat4 viewProj;
+  mat4 invViewProj;
+  vec4 camPos;      // xyz = camera world pos
+  vec4 nearFarTime; // x=near, y=far, z=time (s), w=dt (s)
+  uvec4 frame;      // x=frame index, y/z=framebuffer size
+} gView;
@@ -16,7 +16,7 @@ int chooseCascade(float viewDepth) {
 }
 
 float sampleShadowCSM(vec3 posW, vec3 N, vec3 Ldir) {
-  vec4 viewPos = u_View * vec4(posW, 1.0);
+  vec4 viewPos = gView.view * vec4(posW, 1.0);
   float viewDepth = -viewPos.z;
   int c = chooseCascade(viewDepth);
 
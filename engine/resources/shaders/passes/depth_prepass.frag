@@ -0,0 +1,4 @@
+#version 460 core
+
+// Depth-only. No outputs needed.
+void main() {}
@@ -0,0 +1,21 @@
+#version 460 core
+
+layout(location = 0) in vec3 aPos;
+
+#include "include/ViewCommon.glsl"
+
+struct DrawData {
+  mat4 model;
+  uint materialIndex;
+  uint pickID;
+  uint meshHandle;
+  uint _pad0;
+};
+
+layout(std430, binding = 13) readonly buffer PerDrawSSBO {
+  DrawData gDraw[];
+};
+
+void main() {
+  gl_Position = gView.viewProj * gDraw[gl_BaseInstance].model * vec4(aPos, 1.0);
+}
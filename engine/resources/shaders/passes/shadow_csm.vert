@@ -2,9 +2,14 @@
 
 layout(location = 0) in vec3 aPos;
 
-uniform mat4 u_Model;
+// Caster transforms, one per indirect command (MultiDrawBatch).
+layout(std430, binding = 11) readonly buffer DrawModels {
+  mat4 gModels[];
+};
+
 uniform mat4 u_LightViewProj;
 
 void main() {
-  gl_Position = u_LightViewProj * u_Model * vec4(aPos, 1.0);
+  mat4 model = gModels[gl_BaseInstance];
+  gl_Position = u_LightViewProj * model * vec4(aPos, 1.0);
 }
@@ -9,8 +9,6 @@
 
 layout(location = 0) out uint oID;
 
-#define NYX_MAX_TEX 16
-#define MAT_REMAP_TEX(x) remapTex(x)
 #define MAT_UV0 (f.uv0 * gMat.mats[f.materialIndex].uvScaleOffset.xy + \
                  gMat.mats[f.materialIndex].uvScaleOffset.zw)
 
@@ -61,12 +59,7 @@ layout(std430, binding = 14) readonly buffer MaterialsSSBO {
 }
 gMat;
 
-layout(binding = 10) uniform sampler2D uTex2D[NYX_MAX_TEX];
-
-layout(std430, binding = 15) readonly buffer MaterialTexRemap { uint remap[]; }
-gTexRemap;
-
-uniform uint u_TexRemapCount;
+#include "include/MaterialTextures.glsl"
 
 in VS_OUT {
   vec3 posW;
@@ -82,12 +75,6 @@ f;
 
 const uint kInvalidTex = 0xFFFFFFFFu;
 
-uint remapTex(uint tid) {
-  if (tid == kInvalidTex || tid >= u_TexRemapCount)
-    return kInvalidTex;
-  return gTexRemap.remap[tid];
-}
-
 #define u_MaterialIndex f.materialIndex
 #include "include/MaterialCommon.glsl"
 #undef u_MaterialIndex
@@ -97,10 +84,7 @@ vec2 applyUV(vec2 uv, vec4 scaleOffset) {
 }
 
 float sampleAlpha(uint tid, vec2 uv) {
-  tid = remapTex(tid);
-  if (tid == kInvalidTex || tid >= NYX_MAX_TEX)
-    return 1.0;
-  return texture(uTex2D[NONUNIFORM(tid)], uv).a;
+  return sampleMatTex(tid, uv, vec4(1.0)).a;
 }
 
 void main() {
@@ -5,8 +5,7 @@ layout(location=1) in vec3 aNrm;
 layout(location=2) in vec4 aTan; // xyz tangent, w sign (0 = missing)
 layout(location=3) in vec2 aUV;
 
-uniform mat4 u_ViewProj;
-uniform vec3 u_CamPos;
+#include "include/ViewCommon.glsl"
 
 struct DrawData {
   mat4 model;
@@ -44,10 +43,10 @@ void main() {
   v.tanW = vec4(tW, aTan.w);
   v.uv = aUV;
   v.uv0 = aUV;
-  v.viewDirW = normalize(u_CamPos - v.posW);
+  v.viewDirW = normalize(gView.camPos.xyz - v.posW);
 
   v.materialIndex = d.materialIndex;
   v.pickID = d.pickID;
 
-  gl_Position = u_ViewProj * wp;
+  gl_Position = gView.viewProj * wp;
 }
@@ -2,8 +2,6 @@
 
 layout(location = 0) out vec4 oColor;
 
-#define NYX_MAX_TEX 16
-
 #include "include/common.glsl"
 
 struct GpuMaterialPacked {
@@ -20,13 +18,7 @@ layout(std430, binding = 14) readonly buffer MaterialsSSBO {
   GpuMaterialPacked mats[];
 } gMat;
 
-layout(binding = 10) uniform sampler2D uTex2D[NYX_MAX_TEX];
-
-layout(std430, binding = 15) readonly buffer MaterialTexRemap {
-  uint remap[];
-} gTexRemap;
-
-uniform uint u_TexRemapCount;
+#include "include/MaterialTextures.glsl"
 
 uniform uint u_MaterialIndex;
 uniform vec3 u_LightDir;    // direction to light
@@ -47,35 +39,22 @@ in VS_OUT {
 
 const uint kInvalidTex = 0xFFFFFFFFu;
 
-uint remapTex(uint tid) {
-  if (tid == kInvalidTex || tid >= u_TexRemapCount)
-    return kInvalidTex;
-  return gTexRemap.remap[tid];
-}
-
 vec2 applyUV(vec2 uv, vec4 scaleOffset) {
   return uv * scaleOffset.xy + scaleOffset.zw;
 }
 
 vec3 sampleSRGB(uint tid, vec2 uv) {
-  tid = remapTex(tid);
-  if (tid == kInvalidTex || tid >= NYX_MAX_TEX)
-    return vec3(1.0);
-  return texture(uTex2D[tid], uv).rgb;
+  return sampleMatTex(tid, uv, vec4(1.0)).rgb;
 }
 
 vec3 sampleLinear(uint tid, vec2 uv) {
-  tid = remapTex(tid);
-  if (tid == kInvalidTex || tid >= NYX_MAX_TEX)
-    return vec3(1.0);
-  return texture(uTex2D[tid], uv).rgb;
+  return sampleMatTex(tid, uv, vec4(1.0)).rgb;
 }
 
 vec3 sampleNormalTS(uint tid, vec2 uv) {
-  tid = remapTex(tid);
-  if (tid == kInvalidTex || tid >= NYX_MAX_TEX)
+  if (!matTexResident(tid))
     return vec3(0.0, 0.0, 1.0);
-  vec3 n = texture(uTex2D[tid], uv).xyz * 2.0 - 1.0;
+  vec3 n = sampleMatTex(tid, uv, vec4(1.0)).xyz * 2.0 - 1.0;
   return normalize(n);
 }
 
@@ -5,7 +5,7 @@ layout(location = 1) in vec3 aNrm;
 layout(location = 2) in vec4 aTan;
 layout(location = 3) in vec2 aUV;
 
-uniform mat4 u_ViewProj;
+#include "include/ViewCommon.glsl"
 
 struct DrawData {
   mat4 model;
@@ -25,6 +25,6 @@ out VS_OUT {
 
 void main() {
   DrawData d = gDraw[gl_BaseInstance];
-  gl_Position = u_ViewProj * (d.model * vec4(aPos, 1.0));
+  gl_Position = gView.viewProj * (d.model * vec4(aPos, 1.0));
   v.pickID = d.pickID;
 }
@@ -4,9 +4,14 @@
 layout(location=0) in vec3 aPosition;
 layout(location=1) in vec3 aNormal;
 
-uniform mat4 u_Model;
+// Caster transforms, one per indirect command (MultiDrawBatch).
+layout(std430, binding = 11) readonly buffer DrawModels {
+  mat4 gModels[];
+};
+
 uniform mat4 u_ViewProj;
 
 void main() {
-  gl_Position = u_ViewProj * u_Model * vec4(aPosition, 1.0);
+  mat4 model = gModels[gl_BaseInstance];
+  gl_Position = u_ViewProj * model * vec4(aPosition, 1.0);
 }
@@ -4,7 +4,11 @@
 layout(location=0) in vec3 aPosition;
 layout(location=1) in vec3 aNormal;
 
-uniform mat4 u_Model;
+// Caster transforms, one per indirect command (MultiDrawBatch).
+layout(std430, binding = 11) readonly buffer DrawModels {
+  mat4 gModels[];
+};
+
 uniform mat4 u_ViewProj;
 
 out VS_OUT {
@@ -12,7 +16,8 @@ out VS_OUT {
 } vs_out;
 
 void main() {
-  vec4 worldPos = u_Model * vec4(aPosition, 1.0);
+  mat4 model = gModels[gl_BaseInstance];
+  vec4 worldPos = model * vec4(aPosition, 1.0);
   vs_out.fragPos = worldPos.xyz;
   gl_Position = u_ViewProj * worldPos;
 }
@@ -3,7 +3,7 @@
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNrm;
 
-uniform mat4 u_ViewProj;
+#include "include/ViewCommon.glsl"
 
 struct DrawData {
   mat4 model;
@@ -32,5 +32,5 @@ void main() {
   v.nrmW = normalize(nrmM * aNrm);
   v.materialIndex = d.materialIndex;
 
-  gl_Position = u_ViewProj * pw;
+  gl_Position = gView.viewProj * pw;
 }
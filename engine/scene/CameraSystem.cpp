@@ -16,10 +16,7 @@ void CameraSystem::update(World &world, uint32_t viewportW,
   ensureSize(viewportW, viewportH);
   const float aspect = float(viewportW) / float(viewportH);
 
-  for (EntityID e : world.alive()) {
-    if (!world.hasCamera(e))
-      continue;
-
+  for (EntityID e : world.cameraPool().entities()) {
     auto &cam = world.camera(e);
     auto &mats = world.cameraMatrices(e);
 
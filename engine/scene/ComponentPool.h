@@ -0,0 +1,163 @@
+#pragma once
+
+#include "../core/Assert.h"
+#include "EntityID.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Nyx {
+
+// ------------------------------
+// Paged sparse index: entity.index -> dense slot
+// ------------------------------
+// Pages are allocated lazily so a handful of high indices does not reserve
+// memory for every index below them. Lookups are two array loads.
+class SparsePageArray final {
+public:
+  static constexpr uint32_t PageShift = 12u;
+  static constexpr uint32_t PageSize = 1u << PageShift;
+  static constexpr uint32_t PageMask = PageSize - 1u;
+  static constexpr uint32_t Null = ~0u;
+
+  uint32_t get(uint32_t index) const {
+    const uint32_t page = index >> PageShift;
+    if (page >= m_pages.size() || !m_pages[page])
+      return Null;
+    return (*m_pages[page])[index & PageMask];
+  }
+
+  void set(uint32_t index, uint32_t slot) {
+    const uint32_t page = index >> PageShift;
+    if (page >= m_pages.size())
+      m_pages.resize((size_t)page + 1u);
+    if (!m_pages[page]) {
+      m_pages[page] = std::make_unique<Page>();
+      m_pages[page]->fill(Null);
+    }
+    (*m_pages[page])[index & PageMask] = slot;
+  }
+
+  void reset(uint32_t index) {
+    const uint32_t page = index >> PageShift;
+    if (page < m_pages.size() && m_pages[page])
+      (*m_pages[page])[index & PageMask] = Null;
+  }
+
+  void clear() { m_pages.clear(); }
+
+private:
+  using Page = std::array<uint32_t, PageSize>;
+  std::vector<std::unique_ptr<Page>> m_pages;
+};
+
+// ------------------------------
+// Dense+Sparse component storage
+// ------------------------------
+// Components live contiguously in m_dense (swap-remove keeps it packed), with
+// m_denseEntities as the parallel owner array. References and pointers from
+// get()/find()/ensure()/set()/values() are invalidated by adding a component
+// (ensure(), set()) or removing one (remove(), clear()) on the same pool:
+// m_dense may reallocate, and swap-remove moves the last component into the
+// hole. World calls that create, duplicate or destroy entities do both, so
+// copy what you need out of a component before making them.
+template <typename T> class ComponentPool final {
+public:
+  bool has(EntityID e) const { return indexOf(e) != SparsePageArray::Null; }
+
+  T *find(EntityID e) {
+    const uint32_t idx = indexOf(e);
+    return idx == SparsePageArray::Null ? nullptr : &m_dense[idx];
+  }
+  const T *find(EntityID e) const {
+    const uint32_t idx = indexOf(e);
+    return idx == SparsePageArray::Null ? nullptr : &m_dense[idx];
+  }
+
+  T &get(EntityID e) {
+    const uint32_t idx = indexOf(e);
+    NYX_ASSERT(idx != SparsePageArray::Null, "ComponentPool: missing component");
+    return m_dense[idx];
+  }
+  const T &get(EntityID e) const {
+    const uint32_t idx = indexOf(e);
+    NYX_ASSERT(idx != SparsePageArray::Null, "ComponentPool: missing component");
+    return m_dense[idx];
+  }
+
+  template <class... Args> T &ensure(EntityID e, Args &&...args) {
+    const uint32_t existing = indexOf(e);
+    if (existing != SparsePageArray::Null)
+      return m_dense[existing];
+    const uint32_t idx = (uint32_t)m_dense.size();
+    m_denseEntities.push_back(e);
+    m_dense.emplace_back(T{std::forward<Args>(args)...});
+    m_sparse.set(e.index, idx);
+    return m_dense.back();
+  }
+
+  // Insert or overwrite.
+  T &set(EntityID e, T value) {
+    const uint32_t existing = indexOf(e);
+    if (existing != SparsePageArray::Null) {
+      m_dense[existing] = std::move(value);
+      return m_dense[existing];
+    }
+    return ensure(e, std::move(value));
+  }
+
+  bool remove(EntityID e) {
+    const uint32_t idx = indexOf(e);
+    if (idx == SparsePageArray::Null)
+      return false;
+
+    const uint32_t last = (uint32_t)m_dense.size() - 1u;
+    if (idx != last) {
+      m_dense[idx] = std::move(m_dense[last]);
+      m_denseEntities[idx] = m_denseEntities[last];
+      m_sparse.set(m_denseEntities[idx].index, idx);
+    }
+
+    m_dense.pop_back();
+    m_denseEntities.pop_back();
+    m_sparse.reset(e.index);
+    return true;
+  }
+
+  void clear() {
+    m_dense.clear();
+    m_denseEntities.clear();
+    m_sparse.clear();
+  }
+
+  void reserve(size_t n) {
+    m_dense.reserve(n);
+    m_denseEntities.reserve(n);
+  }
+
+  // Linear access to the packed arrays (unordered).
+  uint32_t size() const { return (uint32_t)m_dense.size(); }
+  bool empty() const { return m_dense.empty(); }
+  const std::vector<EntityID> &entities() const { return m_denseEntities; }
+  std::vector<T> &values() { return m_dense; }
+  const std::vector<T> &values() const { return m_dense; }
+
+  // Dense slot of `e`, or SparsePageArray::Null. Stable until the next
+  // remove() on this pool.
+  uint32_t indexOf(EntityID e) const {
+    const uint32_t idx = m_sparse.get(e.index);
+    if (idx == SparsePageArray::Null || m_denseEntities[idx] != e)
+      return SparsePageArray::Null;
+    return idx;
+  }
+
+private:
+  std::vector<T> m_dense;
+  std::vector<EntityID> m_denseEntities;
+  SparsePageArray m_sparse;
+};
+
+} // namespace Nyx
@@ -9,16 +9,17 @@
 
 namespace Nyx {
 
-// Hierarchy storage: sibling-linked tree
+// Hierarchy storage: doubly sibling-linked tree
 struct CHierarchy final {
   // Tree links
   // - parent: InvalidEntity if root
-  // - firstChild: first child entity
-  // - nextSibling: next child under same parent
-  // - prevSibling: optional but makes detach O(1)
-  // - lastChild: optional, enables appendChild O(1)
+  // - firstChild / lastChild: child list ends (append is O(1))
+  // - prevSibling / nextSibling: neighbours under same parent (detach is O(1));
+  //   roots are linked into World's root list the same way
   EntityID parent = InvalidEntity;
   EntityID firstChild = InvalidEntity;
+  EntityID lastChild = InvalidEntity;
+  EntityID prevSibling = InvalidEntity;
   EntityID nextSibling = InvalidEntity;
 };
 
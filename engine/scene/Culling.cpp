@@ -0,0 +1,221 @@
+#include "Culling.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                     \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NYX_CULL_SSE 1
+#include <immintrin.h>
+#endif
+
+namespace Nyx {
+
+CullBounds localBoundsFor(ProcMeshType type) {
+  // All primitives are generated with a half extent / radius of 0.5.
+  switch (type) {
+  case ProcMeshType::Plane:
+  case ProcMeshType::Circle:
+    return {glm::vec3(0.0f), glm::vec3(0.5f, 0.0f, 0.5f), std::sqrt(0.5f)};
+  case ProcMeshType::Sphere:
+    return {glm::vec3(0.0f), glm::vec3(0.5f), 0.5f};
+  case ProcMeshType::Cube:
+  case ProcMeshType::Monkey:
+  default:
+    return {glm::vec3(0.0f), glm::vec3(0.5f), std::sqrt(0.75f)};
+  }
+}
+
+CullBounds transformBounds(const CullBounds &local, const glm::mat4 &model) {
+  CullBounds out{};
+  out.center = glm::vec3(model * glm::vec4(local.center, 1.0f));
+
+  const glm::vec3 c0 = glm::vec3(model[0]);
+  const glm::vec3 c1 = glm::vec3(model[1]);
+  const glm::vec3 c2 = glm::vec3(model[2]);
+  out.extents = glm::abs(c0) * local.extents.x +
+                glm::abs(c1) * local.extents.y +
+                glm::abs(c2) * local.extents.z;
+
+  const float maxScale2 = std::max(
+      {glm::dot(c0, c0), glm::dot(c1, c1), glm::dot(c2, c2)});
+  out.radius = local.radius * std::sqrt(maxScale2);
+  return out;
+}
+
+Frustum Frustum::fromViewProj(const glm::mat4 &m) {
+  // Gribb/Hartmann: planes are sums of the clip-space rows (GL -w..w depth).
+  auto row = [&](int r) {
+    return glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+  };
+  const glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+  Frustum f{};
+  f.planes[0] = r3 + r0;
+  f.planes[1] = r3 - r0;
+  f.planes[2] = r3 + r1;
+  f.planes[3] = r3 - r1;
+  f.planes[4] = r3 + r2;
+  f.planes[5] = r3 - r2;
+
+  for (glm::vec4 &p : f.planes) {
+    const float len = glm::length(glm::vec3(p));
+    // Degenerate plane (e.g. infinite far): never rejects anything.
+    p = (len > 1e-8f) ? p / len : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+  }
+  return f;
+}
+
+bool frustumIntersects(const Frustum &f, const glm::vec3 &center,
+                       const glm::vec3 &extents) {
+  for (const glm::vec4 &p : f.planes) {
+    const float dist = glm::dot(glm::vec3(p), center) + p.w;
+    const float r = glm::dot(glm::abs(glm::vec3(p)), extents);
+    if (dist + r < 0.0f)
+      return false;
+  }
+  return true;
+}
+
+// ------------------------------
+// CullBoundsSoA
+// ------------------------------
+
+void CullBoundsSoA::clear() {
+  m_cx.clear();
+  m_cy.clear();
+  m_cz.clear();
+  m_ex.clear();
+  m_ey.clear();
+  m_ez.clear();
+  m_r.clear();
+}
+
+void CullBoundsSoA::reserve(size_t n) {
+  m_cx.reserve(n);
+  m_cy.reserve(n);
+  m_cz.reserve(n);
+  m_ex.reserve(n);
+  m_ey.reserve(n);
+  m_ez.reserve(n);
+  m_r.reserve(n);
+}
+
+void CullBoundsSoA::push_back(const CullBounds &b) {
+  m_cx.push_back(b.center.x);
+  m_cy.push_back(b.center.y);
+  m_cz.push_back(b.center.z);
+  m_ex.push_back(b.extents.x);
+  m_ey.push_back(b.extents.y);
+  m_ez.push_back(b.extents.z);
+  m_r.push_back(b.radius);
+}
+
+void CullBoundsSoA::set(uint32_t i, const CullBounds &b) {
+  m_cx[i] = b.center.x;
+  m_cy[i] = b.center.y;
+  m_cz[i] = b.center.z;
+  m_ex[i] = b.extents.x;
+  m_ey[i] = b.extents.y;
+  m_ez[i] = b.extents.z;
+  m_r[i] = b.radius;
+}
+
+void CullBoundsSoA::move(uint32_t dst, uint32_t src) {
+  m_cx[dst] = m_cx[src];
+  m_cy[dst] = m_cy[src];
+  m_cz[dst] = m_cz[src];
+  m_ex[dst] = m_ex[src];
+  m_ey[dst] = m_ey[src];
+  m_ez[dst] = m_ez[src];
+  m_r[dst] = m_r[src];
+}
+
+void CullBoundsSoA::pop_back() {
+  m_cx.pop_back();
+  m_cy.pop_back();
+  m_cz.pop_back();
+  m_ex.pop_back();
+  m_ey.pop_back();
+  m_ez.pop_back();
+  m_r.pop_back();
+}
+
+// ------------------------------
+// Frustum test
+// ------------------------------
+// A box is outside a plane when dist(center) < -r, with r the smaller of the
+// box's projected half-size |n|.e and the sphere radius.
+
+static bool cullOneScalar(const Frustum &f, const CullBoundsSoA &b,
+                          uint32_t i) {
+  for (const glm::vec4 &p : f.planes) {
+    const float dist =
+        p.x * b.cx()[i] + p.y * b.cy()[i] + p.z * b.cz()[i] + p.w;
+    const float rBox = std::abs(p.x) * b.ex()[i] + std::abs(p.y) * b.ey()[i] +
+                       std::abs(p.z) * b.ez()[i];
+    if (dist + std::min(rBox, b.radius()[i]) < 0.0f)
+      return false;
+  }
+  return true;
+}
+
+uint32_t cullFrustum(const Frustum &f, const CullBoundsSoA &b,
+                     uint8_t *visible) {
+  const uint32_t n = b.size();
+  uint32_t count = 0;
+  uint32_t i = 0;
+
+#if defined(NYX_CULL_SSE)
+  __m128 pn[6][3], pnAbs[6][3], pw[6];
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+  for (int k = 0; k < 6; ++k) {
+    for (int a = 0; a < 3; ++a) {
+      pn[k][a] = _mm_set1_ps(f.planes[k][a]);
+      pnAbs[k][a] = _mm_andnot_ps(signMask, pn[k][a]);
+    }
+    pw[k] = _mm_set1_ps(f.planes[k].w);
+  }
+  const __m128 zero = _mm_setzero_ps();
+
+  for (; i + 4u <= n; i += 4u) {
+    const __m128 cx = _mm_loadu_ps(b.cx() + i);
+    const __m128 cy = _mm_loadu_ps(b.cy() + i);
+    const __m128 cz = _mm_loadu_ps(b.cz() + i);
+    const __m128 ex = _mm_loadu_ps(b.ex() + i);
+    const __m128 ey = _mm_loadu_ps(b.ey() + i);
+    const __m128 ez = _mm_loadu_ps(b.ez() + i);
+    const __m128 rs = _mm_loadu_ps(b.radius() + i);
+
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int k = 0; k < 6; ++k) {
+      __m128 dist = _mm_add_ps(_mm_mul_ps(pn[k][0], cx), pw[k]);
+      dist = _mm_add_ps(dist, _mm_mul_ps(pn[k][1], cy));
+      dist = _mm_add_ps(dist, _mm_mul_ps(pn[k][2], cz));
+
+      __m128 rBox = _mm_mul_ps(pnAbs[k][0], ex);
+      rBox = _mm_add_ps(rBox, _mm_mul_ps(pnAbs[k][1], ey));
+      rBox = _mm_add_ps(rBox, _mm_mul_ps(pnAbs[k][2], ez));
+
+      const __m128 r = _mm_min_ps(rBox, rs);
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, r), zero));
+    }
+
+    const int mask = _mm_movemask_ps(inside);
+    visible[i + 0] = (uint8_t)(mask & 1);
+    visible[i + 1] = (uint8_t)((mask >> 1) & 1);
+    visible[i + 2] = (uint8_t)((mask >> 2) & 1);
+    visible[i + 3] = (uint8_t)((mask >> 3) & 1);
+    count += (uint32_t)std::popcount((unsigned)mask);
+  }
+#endif
+
+  for (; i < n; ++i) {
+    visible[i] = cullOneScalar(f, b, i) ? 1u : 0u;
+    count += visible[i];
+  }
+  return count;
+}
+
+} // namespace Nyx
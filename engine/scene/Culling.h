@@ -0,0 +1,79 @@
+#pragma once
+
+#include "scene/Components.h"
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Nyx {
+
+// Bounds used for visibility tests: an AABB (center/half-extents) plus a
+// bounding sphere around the same center. Both are kept because neither is
+// tight for every orientation; a draw is culled if either is fully outside.
+struct CullBounds {
+  glm::vec3 center{0.0f};
+  glm::vec3 extents{0.0f};
+  float radius = 0.0f;
+};
+
+// Object-space bounds of the built-in primitives (see PrimitiveGenerator).
+CullBounds localBoundsFor(ProcMeshType type);
+
+// Conservative world-space bounds of `local` under `model`.
+CullBounds transformBounds(const CullBounds &local, const glm::mat4 &model);
+
+// Normalized planes with inward normals: dot(n, p) + w >= 0 is inside.
+// Order: left, right, bottom, top, near, far.
+struct Frustum {
+  glm::vec4 planes[6]{};
+
+  static Frustum fromViewProj(const glm::mat4 &viewProj);
+};
+
+// Single-box form of the cullFrustum() test (AABB only).
+bool frustumIntersects(const Frustum &frustum, const glm::vec3 &center,
+                       const glm::vec3 &extents);
+
+// ------------------------------
+// SoA bounds for batched culling
+// ------------------------------
+class CullBoundsSoA final {
+public:
+  void clear();
+  void reserve(size_t n);
+  uint32_t size() const { return (uint32_t)m_cx.size(); }
+
+  void push_back(const CullBounds &b);
+  void set(uint32_t i, const CullBounds &b);
+  void move(uint32_t dst, uint32_t src); // for swap-remove
+  void pop_back();
+
+  const float *cx() const { return m_cx.data(); }
+  const float *cy() const { return m_cy.data(); }
+  const float *cz() const { return m_cz.data(); }
+  const float *ex() const { return m_ex.data(); }
+  const float *ey() const { return m_ey.data(); }
+  const float *ez() const { return m_ez.data(); }
+  const float *radius() const { return m_r.data(); }
+
+private:
+  std::vector<float> m_cx, m_cy, m_cz;
+  std::vector<float> m_ex, m_ey, m_ez;
+  std::vector<float> m_r;
+};
+
+// Per-view counters of the last cull.
+struct CullStats {
+  uint32_t tested = 0;
+  uint32_t visible = 0;
+  uint32_t frustumCulled = 0;
+};
+
+// Writes 1 (visible) / 0 (culled) to visible[0, bounds.size()) and returns the
+// number of visible entries. Four bounds per iteration with SSE, scalar
+// otherwise.
+uint32_t cullFrustum(const Frustum &frustum, const CullBoundsSoA &bounds,
+                     uint8_t *visible);
+
+} // namespace Nyx
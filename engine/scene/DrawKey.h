@@ -0,0 +1,65 @@
+#pragma once
+
+#include "scene/Renderable.h"
+
+#include <bit>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace Nyx {
+
+// 64-bit sort keys for the routed draw lists, sorted ascending with
+// radixSortKeys(). Bit 62 holds camera gizmos in both layouts: they only
+// write IDs, so they go after the rest. Ties keep registry order.
+//
+// Opaque, most significant bits first:
+//   61..57 depth bucket: half-octaves of camera distance from 0.5 units,
+//          front to back, so the depth pre-pass still rejects early
+//   56..33 material GPU index
+//   32..25 mesh
+//   24..0  distance within the bucket's draws of one material and mesh
+// Within a bucket, draws of the same material and mesh are adjacent, so the
+// state a batch needs changes only at bucket or material boundaries.
+//
+// Transparent, most significant bits first:
+//   61..40 distance: top 22 bits of the (non-negative) float, which order
+//          like the value; inverted for back-to-front
+//   39..16 material GPU index
+//   15..8  mesh
+
+inline constexpr uint32_t DrawKey_DepthBuckets = 32u;
+
+// Distance bits: the float's bits order like the value for d >= 0.
+inline uint32_t drawKeyDistanceBits(const Renderable &r,
+                                    const glm::vec3 &camPos) {
+  return std::bit_cast<uint32_t>(glm::length(glm::vec3(r.model[3]) - camPos));
+}
+
+// Exponent and top mantissa bit, relative to 0.5 (bits 0x3F000000).
+inline uint32_t drawKeyDepthBucket(uint32_t distBits) {
+  constexpr uint32_t kNear = 0x3F000000u >> 22;
+  const uint32_t halfOctave = distBits >> 22;
+  if (halfOctave <= kNear)
+    return 0u;
+  const uint32_t bucket = halfOctave - kNear;
+  return bucket < DrawKey_DepthBuckets ? bucket : DrawKey_DepthBuckets - 1u;
+}
+
+inline uint64_t opaqueDrawKey(const Renderable &r, const glm::vec3 &camPos) {
+  const uint32_t distBits = drawKeyDistanceBits(r, camPos);
+  return (uint64_t(r.isCamera) << 62) |
+         (uint64_t(drawKeyDepthBucket(distBits)) << 57) |
+         (uint64_t(r.materialGpuIndex & 0xFFFFFFu) << 33) |
+         (uint64_t(r.mesh) << 25) | uint64_t(distBits >> 7);
+}
+
+inline uint64_t transparentDrawKey(const Renderable &r,
+                                   const glm::vec3 &camPos) {
+  const uint32_t distBits = drawKeyDistanceBits(r, camPos) >> 9;
+  return (uint64_t(r.isCamera) << 62) |
+         (uint64_t(~distBits & 0x3FFFFFu) << 40) |
+         (uint64_t(r.materialGpuIndex & 0xFFFFFFu) << 16) |
+         (uint64_t(r.mesh) << 8);
+}
+
+} // namespace Nyx
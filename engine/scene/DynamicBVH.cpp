@@ -0,0 +1,387 @@
+#include "DynamicBVH.h"
+
+#include "core/Assert.h"
+
+#include <array>
+#include <limits>
+
+namespace Nyx {
+
+static constexpr uint32_t kSahBins = 16;
+
+void DynamicBVH::clear() {
+  m_nodes.clear();
+  m_freeNodes.clear();
+  m_proxies.clear();
+  m_freeProxies.clear();
+  m_root = Null;
+  m_proxyCount = 0;
+  m_internalArea = 0.0;
+  m_builtCost = 0.0f;
+  m_dirty = false;
+}
+
+uint32_t DynamicBVH::allocNode() {
+  if (!m_freeNodes.empty()) {
+    const uint32_t n = m_freeNodes.back();
+    m_freeNodes.pop_back();
+    m_nodes[n] = Node{};
+    return n;
+  }
+  m_nodes.push_back(Node{});
+  return (uint32_t)m_nodes.size() - 1u;
+}
+
+void DynamicBVH::freeNode(uint32_t n) { m_freeNodes.push_back(n); }
+
+// ------------------------------
+// Proxies
+// ------------------------------
+
+uint32_t DynamicBVH::insert(const AABB &box, uint32_t userData) {
+  uint32_t proxy;
+  if (!m_freeProxies.empty()) {
+    proxy = m_freeProxies.back();
+    m_freeProxies.pop_back();
+  } else {
+    proxy = (uint32_t)m_proxies.size();
+    m_proxies.emplace_back();
+  }
+
+  const uint32_t leaf = allocNode();
+  m_nodes[leaf].box = box;
+  m_nodes[leaf].proxy = proxy;
+  m_proxies[proxy] = {box, userData, leaf};
+  ++m_proxyCount;
+
+  insertLeaf(leaf);
+  m_dirty = true;
+  return proxy;
+}
+
+void DynamicBVH::remove(uint32_t proxy) {
+  NYX_ASSERT(proxy < m_proxies.size() && m_proxies[proxy].leaf != Null,
+             "DynamicBVH: invalid proxy");
+  const uint32_t leaf = m_proxies[proxy].leaf;
+  removeLeaf(leaf);
+  freeNode(leaf);
+
+  m_proxies[proxy].leaf = Null;
+  m_freeProxies.push_back(proxy);
+  --m_proxyCount;
+  m_dirty = true;
+}
+
+void DynamicBVH::update(uint32_t proxy, const AABB &box) {
+  NYX_ASSERT(proxy < m_proxies.size() && m_proxies[proxy].leaf != Null,
+             "DynamicBVH: invalid proxy");
+  Proxy &p = m_proxies[proxy];
+  if (p.box == box)
+    return;
+  p.box = box;
+  m_nodes[p.leaf].box = box;
+  refitFrom(m_nodes[p.leaf].parent);
+  m_dirty = true;
+}
+
+// ------------------------------
+// Incremental edits
+// ------------------------------
+
+void DynamicBVH::insertLeaf(uint32_t leaf) {
+  if (m_root == Null) {
+    m_root = leaf;
+    m_nodes[leaf].parent = Null;
+    return;
+  }
+
+  // Greedy descent on the SAH cost of placing the leaf next to a node.
+  const AABB box = m_nodes[leaf].box;
+  uint32_t index = m_root;
+  while (!m_nodes[index].isLeaf()) {
+    const Node &n = m_nodes[index];
+    const float area = n.box.surfaceArea();
+    const float combined = AABB::merge(n.box, box).surfaceArea();
+
+    const float costHere = 2.0f * combined;
+    const float inherited = 2.0f * (combined - area);
+
+    auto descendCost = [&](uint32_t c) {
+      const Node &child = m_nodes[c];
+      const float merged = AABB::merge(child.box, box).surfaceArea();
+      return (child.isLeaf() ? merged : merged - child.box.surfaceArea()) +
+             inherited;
+    };
+    const float costL = descendCost(n.left);
+    const float costR = descendCost(n.right);
+
+    if (costHere < costL && costHere < costR)
+      break;
+    index = (costL < costR) ? n.left : n.right;
+  }
+
+  const uint32_t sibling = index;
+  const uint32_t oldParent = m_nodes[sibling].parent;
+  const uint32_t parent = allocNode();
+  m_nodes[parent].parent = oldParent;
+  m_nodes[parent].box = AABB::merge(box, m_nodes[sibling].box);
+  m_internalArea += m_nodes[parent].box.surfaceArea();
+  m_nodes[parent].left = sibling;
+  m_nodes[parent].right = leaf;
+  m_nodes[sibling].parent = parent;
+  m_nodes[leaf].parent = parent;
+
+  if (oldParent == Null) {
+    m_root = parent;
+  } else if (m_nodes[oldParent].left == sibling) {
+    m_nodes[oldParent].left = parent;
+  } else {
+    m_nodes[oldParent].right = parent;
+  }
+  refitFrom(oldParent);
+}
+
+void DynamicBVH::removeLeaf(uint32_t leaf) {
+  if (leaf == m_root) {
+    m_root = Null;
+    m_internalArea = 0.0;
+    return;
+  }
+
+  const uint32_t parent = m_nodes[leaf].parent;
+  const uint32_t grand = m_nodes[parent].parent;
+  const uint32_t sibling = (m_nodes[parent].left == leaf)
+                               ? m_nodes[parent].right
+                               : m_nodes[parent].left;
+
+  m_nodes[sibling].parent = grand;
+  if (grand == Null) {
+    m_root = sibling;
+    if (m_nodes[sibling].isLeaf()) {
+      // Last internal node: drop the rounding the running sum picked up.
+      m_internalArea = 0.0;
+      freeNode(parent);
+      return;
+    }
+  } else {
+    if (m_nodes[grand].left == parent)
+      m_nodes[grand].left = sibling;
+    else
+      m_nodes[grand].right = sibling;
+    refitFrom(grand);
+  }
+  m_internalArea -= m_nodes[parent].box.surfaceArea();
+  freeNode(parent);
+}
+
+void DynamicBVH::refitFrom(uint32_t node) {
+  // Stops as soon as a node's box is unaffected; everything above is too.
+  while (node != Null) {
+    Node &n = m_nodes[node];
+    const AABB box = AABB::merge(m_nodes[n.left].box, m_nodes[n.right].box);
+    if (box == n.box)
+      return;
+    setInternalBox(node, box);
+    node = n.parent;
+  }
+}
+
+void DynamicBVH::setInternalBox(uint32_t node, const AABB &box) {
+  Node &n = m_nodes[node];
+  m_internalArea += double(box.surfaceArea()) - double(n.box.surfaceArea());
+  n.box = box;
+}
+
+// ------------------------------
+// SAH rebuild
+// ------------------------------
+
+uint32_t DynamicBVH::buildRange(uint32_t *proxies, uint32_t count,
+                                uint32_t parent) {
+  if (count == 1) {
+    const uint32_t leaf = allocNode();
+    Node &n = m_nodes[leaf];
+    n.box = m_proxies[proxies[0]].box;
+    n.parent = parent;
+    n.proxy = proxies[0];
+    m_proxies[proxies[0]].leaf = leaf;
+    return leaf;
+  }
+
+  AABB centroids{m_proxies[proxies[0]].box.center(),
+                 m_proxies[proxies[0]].box.center()};
+  for (uint32_t i = 1; i < count; ++i) {
+    const glm::vec3 c = m_proxies[proxies[i]].box.center();
+    centroids.min = glm::min(centroids.min, c);
+    centroids.max = glm::max(centroids.max, c);
+  }
+
+  const glm::vec3 span = centroids.max - centroids.min;
+  const int axis = (span.x >= span.y && span.x >= span.z) ? 0
+                   : (span.y >= span.z)                    ? 1
+                                                           : 2;
+
+  uint32_t mid = count / 2u;
+  if (span[axis] > 1e-6f) {
+    struct Bin {
+      AABB box{};
+      uint32_t count = 0;
+    };
+    std::array<Bin, kSahBins> bins{};
+    const float scale = (float)kSahBins / span[axis];
+    auto binOf = [&](uint32_t p) {
+      const float c = m_proxies[p].box.center()[axis];
+      return std::min(kSahBins - 1u,
+                      (uint32_t)((c - centroids.min[axis]) * scale));
+    };
+
+    for (uint32_t i = 0; i < count; ++i) {
+      Bin &b = bins[binOf(proxies[i])];
+      const AABB &box = m_proxies[proxies[i]].box;
+      b.box = b.count ? AABB::merge(b.box, box) : box;
+      ++b.count;
+    }
+
+    // Sweep from the right to get suffix areas, then from the left.
+    std::array<float, kSahBins> rightArea{};
+    std::array<uint32_t, kSahBins> rightCount{};
+    AABB acc{};
+    uint32_t accCount = 0;
+    for (uint32_t i = kSahBins - 1u; i > 0; --i) {
+      if (bins[i].count)
+        acc = accCount ? AABB::merge(acc, bins[i].box) : bins[i].box;
+      accCount += bins[i].count;
+      rightArea[i] = accCount ? acc.surfaceArea() : 0.0f;
+      rightCount[i] = accCount;
+    }
+
+    float bestCost = std::numeric_limits<float>::max();
+    uint32_t bestSplit = 0;
+    acc = {};
+    accCount = 0;
+    for (uint32_t i = 0; i + 1u < kSahBins; ++i) {
+      if (bins[i].count)
+        acc = accCount ? AABB::merge(acc, bins[i].box) : bins[i].box;
+      accCount += bins[i].count;
+      if (accCount == 0 || rightCount[i + 1u] == 0)
+        continue;
+      const float cost = (float)accCount * acc.surfaceArea() +
+                         (float)rightCount[i + 1u] * rightArea[i + 1u];
+      if (cost < bestCost) {
+        bestCost = cost;
+        bestSplit = i + 1u;
+      }
+    }
+
+    if (bestSplit != 0) {
+      uint32_t *split = std::partition(proxies, proxies + count, [&](uint32_t p) {
+        return binOf(p) < bestSplit;
+      });
+      mid = (uint32_t)(split - proxies);
+    }
+  }
+
+  if (mid == 0 || mid == count) {
+    // Degenerate (all centroids in one bin): median split.
+    mid = count / 2u;
+    std::nth_element(proxies, proxies + mid, proxies + count,
+                     [&](uint32_t a, uint32_t b) {
+                       return m_proxies[a].box.center()[axis] <
+                              m_proxies[b].box.center()[axis];
+                     });
+  }
+
+  const uint32_t node = allocNode();
+  m_nodes[node].parent = parent;
+  const uint32_t left = buildRange(proxies, mid, node);
+  const uint32_t right = buildRange(proxies + mid, count - mid, node);
+  m_nodes[node].left = left;
+  m_nodes[node].right = right;
+  m_nodes[node].box = AABB::merge(m_nodes[left].box, m_nodes[right].box);
+  m_internalArea += m_nodes[node].box.surfaceArea();
+  return node;
+}
+
+void DynamicBVH::rebuild() {
+  std::vector<uint32_t> live;
+  live.reserve(m_proxyCount);
+  for (uint32_t p = 0; p < (uint32_t)m_proxies.size(); ++p) {
+    if (m_proxies[p].leaf != Null)
+      live.push_back(p);
+  }
+
+  m_nodes.clear();
+  m_freeNodes.clear();
+  m_internalArea = 0.0;
+  m_nodes.reserve(live.empty() ? 0 : live.size() * 2u - 1u);
+  m_root = live.empty() ? Null
+                        : buildRange(live.data(), (uint32_t)live.size(), Null);
+
+  m_builtCost = sahCost();
+  m_dirty = false;
+  ++m_rebuilds;
+}
+
+bool DynamicBVH::maintain() {
+  if (!m_dirty)
+    return false;
+  m_dirty = false;
+  if (sahCost() <= m_builtCost * kRebuildCostRatio)
+    return false;
+  rebuild();
+  return true;
+}
+
+// ------------------------------
+// Stats
+// ------------------------------
+
+uint32_t DynamicBVH::height() const {
+  if (m_root == Null)
+    return 0;
+  uint32_t best = 0;
+  std::vector<std::pair<uint32_t, uint32_t>> stack{{m_root, 1u}};
+  while (!stack.empty()) {
+    const auto [node, depth] = stack.back();
+    stack.pop_back();
+    best = std::max(best, depth);
+    const Node &n = m_nodes[node];
+    if (!n.isLeaf()) {
+      stack.push_back({n.left, depth + 1u});
+      stack.push_back({n.right, depth + 1u});
+    }
+  }
+  return best;
+}
+
+float DynamicBVH::sahCost() const {
+  if (m_root == Null)
+    return 0.0f;
+  const float rootArea = m_nodes[m_root].box.surfaceArea();
+  if (rootArea <= 0.0f)
+    return 0.0f;
+  return float(m_internalArea / double(rootArea));
+}
+
+float DynamicBVH::sahCostRecomputed() const {
+  if (m_root == Null)
+    return 0.0f;
+  const float rootArea = m_nodes[m_root].box.surfaceArea();
+  if (rootArea <= 0.0f)
+    return 0.0f;
+
+  double sum = 0.0;
+  std::vector<uint32_t> stack{m_root};
+  while (!stack.empty()) {
+    const Node &n = m_nodes[stack.back()];
+    stack.pop_back();
+    if (n.isLeaf())
+      continue;
+    sum += n.box.surfaceArea();
+    stack.push_back(n.left);
+    stack.push_back(n.right);
+  }
+  return float(sum / double(rootArea));
+}
+
+} // namespace Nyx
@@ -0,0 +1,254 @@
+#pragma once
+
+#include "scene/Culling.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+
+namespace Nyx {
+
+struct AABB {
+  glm::vec3 min{0.0f};
+  glm::vec3 max{0.0f};
+
+  static AABB fromCenterExtents(const glm::vec3 &c, const glm::vec3 &e) {
+    return {c - e, c + e};
+  }
+  static AABB merge(const AABB &a, const AABB &b) {
+    return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+  }
+
+  glm::vec3 center() const { return (min + max) * 0.5f; }
+  glm::vec3 extents() const { return (max - min) * 0.5f; }
+  float surfaceArea() const {
+    const glm::vec3 d = max - min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+  }
+  bool overlaps(const AABB &o) const {
+    return min.x <= o.max.x && max.x >= o.min.x && min.y <= o.max.y &&
+           max.y >= o.min.y && min.z <= o.max.z && max.z >= o.min.z;
+  }
+  bool operator==(const AABB &o) const { return min == o.min && max == o.max; }
+};
+
+// Dynamic AABB tree, one proxy per leaf.
+// Moving a proxy refits its ancestors in place and insert/remove relink a
+// single branch, so per-frame edits stay O(depth). Refits slowly loosen the
+// tree; maintain() rebuilds it top-down with binned SAH once its cost grows
+// past kRebuildCostRatio times the cost right after the last build. The
+// internal-area sum behind that cost is kept up to date by every edit, so
+// the check is O(1).
+class DynamicBVH final {
+public:
+  static constexpr uint32_t Null = ~0u;
+  static constexpr float kRebuildCostRatio = 1.5f;
+
+  void clear();
+
+  uint32_t insert(const AABB &box, uint32_t userData);
+  void remove(uint32_t proxy);
+  void update(uint32_t proxy, const AABB &box);
+
+  void setUserData(uint32_t proxy, uint32_t userData) {
+    m_proxies[proxy].userData = userData;
+  }
+  uint32_t userData(uint32_t proxy) const { return m_proxies[proxy].userData; }
+  const AABB &bounds(uint32_t proxy) const { return m_proxies[proxy].box; }
+
+  // Full binned-SAH rebuild.
+  void rebuild();
+  // Rebuilds if the tree degraded since the last build; returns true if so.
+  bool maintain();
+
+  // ---- Queries ----
+  // fn(userData) is called for every proxy whose box passes the test.
+  template <class F> void queryFrustum(const Frustum &f, F &&fn) const;
+  template <class F> void queryAABB(const AABB &box, F &&fn) const;
+  template <class F>
+  void querySphere(const glm::vec3 &center, float radius, F &&fn) const;
+  // fn(userData, tEnter) -> float returns the new max distance: the exact hit
+  // distance for closest-hit queries (or maxT to keep going, 0 to stop).
+  template <class F>
+  void raycast(const glm::vec3 &origin, const glm::vec3 &dir, float maxT,
+               F &&fn) const;
+
+  // ---- Stats ----
+  uint32_t proxyCount() const { return m_proxyCount; }
+  uint32_t nodeCount() const {
+    return (uint32_t)(m_nodes.size() - m_freeNodes.size());
+  }
+  uint32_t height() const;
+  // Sum of internal node areas relative to the root (lower is better).
+  float sahCost() const;
+  // The same, summed over the tree; for checking the tracked value.
+  float sahCostRecomputed() const;
+  uint32_t rebuildCount() const { return m_rebuilds; }
+
+private:
+  struct Node {
+    AABB box{};
+    uint32_t parent = Null;
+    uint32_t left = Null; // Null for leaves
+    uint32_t right = Null;
+    uint32_t proxy = Null; // leaves only
+    bool isLeaf() const { return left == Null; }
+  };
+
+  struct Proxy {
+    AABB box{};
+    uint32_t userData = 0;
+    uint32_t leaf = Null; // Null while the proxy slot is free
+  };
+
+  uint32_t allocNode();
+  void freeNode(uint32_t n);
+  void insertLeaf(uint32_t leaf);
+  void removeLeaf(uint32_t leaf);
+  void refitFrom(uint32_t node);
+  void setInternalBox(uint32_t node, const AABB &box);
+  uint32_t buildRange(uint32_t *proxies, uint32_t count, uint32_t parent);
+
+  template <class Test, class F> void traverse(Test &&test, F &&fn) const;
+
+  std::vector<Node> m_nodes;
+  std::vector<uint32_t> m_freeNodes;
+  std::vector<Proxy> m_proxies;
+  std::vector<uint32_t> m_freeProxies;
+  uint32_t m_root = Null;
+  uint32_t m_proxyCount = 0;
+
+  // Surface areas of all internal nodes; double so edits do not drift.
+  double m_internalArea = 0.0;
+  float m_builtCost = 0.0f;
+  bool m_dirty = false; // edited since the last maintain()
+  uint32_t m_rebuilds = 0;
+};
+
+// ------------------------------
+// Query implementation
+// ------------------------------
+
+namespace detail {
+
+// Traversal stack for queries: the first kInline entries live on the stack,
+// which covers any SAH-built tree; a tree degraded by many refits spills
+// into the heap instead of overflowing.
+class BVHStack final {
+public:
+  static constexpr uint32_t kInline = 64;
+
+  bool empty() const { return m_size == 0; }
+  void push(uint32_t node) {
+    if (m_size < kInline)
+      m_inline[m_size] = node;
+    else
+      m_spill.push_back(node);
+    ++m_size;
+  }
+  uint32_t pop() {
+    --m_size;
+    if (m_size < kInline)
+      return m_inline[m_size];
+    const uint32_t node = m_spill.back();
+    m_spill.pop_back();
+    return node;
+  }
+
+private:
+  uint32_t m_inline[kInline];
+  uint32_t m_size = 0;
+  std::vector<uint32_t> m_spill;
+};
+
+} // namespace detail
+
+template <class Test, class F>
+void DynamicBVH::traverse(Test &&test, F &&fn) const {
+  if (m_root == Null)
+    return;
+  detail::BVHStack stack;
+  stack.push(m_root);
+  while (!stack.empty()) {
+    const Node &n = m_nodes[stack.pop()];
+    if (!test(n.box))
+      continue;
+    if (n.isLeaf()) {
+      fn(m_proxies[n.proxy].userData);
+    } else {
+      stack.push(n.left);
+      stack.push(n.right);
+    }
+  }
+}
+
+template <class F>
+void DynamicBVH::queryFrustum(const Frustum &f, F &&fn) const {
+  traverse(
+      [&](const AABB &b) {
+        return frustumIntersects(f, b.center(), b.extents());
+      },
+      fn);
+}
+
+template <class F> void DynamicBVH::queryAABB(const AABB &box, F &&fn) const {
+  traverse([&](const AABB &b) { return b.overlaps(box); }, fn);
+}
+
+template <class F>
+void DynamicBVH::querySphere(const glm::vec3 &center, float radius,
+                             F &&fn) const {
+  const float r2 = radius * radius;
+  traverse(
+      [&](const AABB &b) {
+        const glm::vec3 d = center - glm::clamp(center, b.min, b.max);
+        return glm::dot(d, d) <= r2;
+      },
+      fn);
+}
+
+template <class F>
+void DynamicBVH::raycast(const glm::vec3 &origin, const glm::vec3 &dir,
+                         float maxT, F &&fn) const {
+  if (m_root == Null)
+    return;
+  // A zero component would give an infinite inverse, and 0 * inf = NaN for
+  // an origin on that slab's plane; FLT_MAX keeps the product at 0 there and
+  // still pushes every other plane out of reach.
+  glm::vec3 invDir;
+  for (int i = 0; i < 3; ++i) {
+    invDir[i] = std::clamp(1.0f / dir[i], -std::numeric_limits<float>::max(),
+                           std::numeric_limits<float>::max());
+  }
+
+  auto slab = [&](const AABB &b, float &tEnter) {
+    const glm::vec3 t0 = (b.min - origin) * invDir;
+    const glm::vec3 t1 = (b.max - origin) * invDir;
+    const glm::vec3 tmin = glm::min(t0, t1);
+    const glm::vec3 tmax = glm::max(t0, t1);
+    tEnter = std::max(std::max(tmin.x, tmin.y), std::max(tmin.z, 0.0f));
+    const float tExit = std::min(std::min(tmax.x, tmax.y), tmax.z);
+    return tEnter <= tExit && tEnter <= maxT;
+  };
+
+  detail::BVHStack stack;
+  stack.push(m_root);
+  while (!stack.empty()) {
+    const Node &n = m_nodes[stack.pop()];
+    float tEnter = 0.0f;
+    if (!slab(n.box, tEnter))
+      continue;
+    if (n.isLeaf()) {
+      maxT = std::min(maxT, (float)fn(m_proxies[n.proxy].userData, tEnter));
+      if (maxT <= 0.0f)
+        return;
+    } else {
+      stack.push(n.left);
+      stack.push(n.right);
+    }
+  }
+}
+
+} // namespace Nyx
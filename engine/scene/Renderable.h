@@ -2,6 +2,7 @@
 
 #include "EntityID.h"
 #include "scene/Components.h"
+#include "scene/Culling.h"
 #include "render/material/MaterialGraph.h"
 #include <glm/glm.hpp>
 
@@ -13,12 +14,12 @@ struct Renderable {
 
   ProcMeshType mesh = ProcMeshType::Cube;
   glm::mat4 model{1.0f};
+  CullBounds bounds{}; // world space, follows model
 
   uint32_t pickID = 0; // packed entity + submesh
   uint32_t materialGpuIndex = 0; // index into material SSBO
 
   MatAlphaMode alphaMode = MatAlphaMode::Opaque;
-  float sortKey = 0.0f; // used for transparent sorting
 
   bool isLight = false;
   bool isCamera = false;
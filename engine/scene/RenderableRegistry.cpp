@@ -1,10 +1,13 @@
 #include "RenderableRegistry.h"
 
+#include "core/RadixSort.h"
+#include "scene/DrawKey.h"
 #include "scene/Pick.h"
 #include "scene/World.h"
 #include "scene/WorldEvents.h"
 
 #include <algorithm>
+#include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace Nyx {
@@ -34,6 +37,10 @@ static void applyCameraFields(const World &world, EntityID e, Renderable &r) {
   r.isCamera = world.hasCamera(e);
 }
 
+static AABB boxOf(const CullBounds &b) {
+  return AABB::fromCenterExtents(b.center, b.extents);
+}
+
 static bool isEntityDisabledForRender(const World &world, EntityID e) {
   const auto &tr = world.transform(e);
   return tr.hidden || tr.hiddenEditor || tr.disabledAnim;
@@ -43,9 +50,15 @@ void RenderableRegistry::clear() {
   m_items.clear();
   m_opaque.clear();
   m_transparent.clear();
-  m_transparentSorted.clear();
+  m_opaqueKeys.clear();
+  m_transparentKeys.clear();
   m_pickToIndex.clear();
   m_entityToIndices.clear();
+  m_bounds.clear();
+  m_visible.clear();
+  m_cullStats = {};
+  m_proxy.clear();
+  m_bvh.clear();
 }
 
 bool RenderableRegistry::hasEntity(EntityID e) const {
@@ -73,6 +86,7 @@ const Renderable *RenderableRegistry::findByPick(uint32_t pickID) const {
 void RenderableRegistry::rebuildAll(const World &world) {
   clear();
   m_items.reserve(world.alive().size());
+  m_bounds.reserve(world.alive().size());
 
   std::vector<EntityID> ents = world.alive();
   std::sort(ents.begin(), ents.end());
@@ -96,6 +110,7 @@ void RenderableRegistry::rebuildAll(const World &world) {
       r.pickID = packPick(e, si);
       r.mesh = sm.type;
       r.model = renderModelForEntity(world, e);
+      r.bounds = transformBounds(localBoundsFor(r.mesh), r.model);
       applyLightFields(world, e, r);
       applyCameraFields(world, e, r);
 
@@ -103,9 +118,13 @@ void RenderableRegistry::rebuildAll(const World &world) {
       r.materialGpuIndex = 0;
 
       m_items.push_back(r);
+      m_bounds.push_back(r.bounds);
+      m_proxy.push_back(
+          m_bvh.insert(boxOf(r.bounds), (uint32_t)m_items.size() - 1u));
     }
   }
 
+  m_bvh.rebuild();
   rebuildMaps();
 }
 
@@ -132,6 +151,7 @@ void RenderableRegistry::eraseIndex(uint32_t idx) {
 
   const uint32_t last = (uint32_t)m_items.size() - 1u;
   const Renderable removed = m_items[idx];
+  m_bvh.remove(m_proxy[idx]);
 
   // Remove pick mapping for the removed renderable
   m_pickToIndex.erase(removed.pickID);
@@ -156,6 +176,9 @@ void RenderableRegistry::eraseIndex(uint32_t idx) {
   if (idx != last) {
     // Move last into idx
     m_items[idx] = m_items[last];
+    m_bounds.move(idx, last);
+    m_proxy[idx] = m_proxy[last];
+    m_bvh.setUserData(m_proxy[idx], idx);
 
     // Fix moved item mappings:
     const Renderable &moved = m_items[idx];
@@ -177,6 +200,8 @@ void RenderableRegistry::eraseIndex(uint32_t idx) {
   }
 
   m_items.pop_back();
+  m_bounds.pop_back();
+  m_proxy.pop_back();
 }
 
 void RenderableRegistry::removeEntity(EntityID e) {
@@ -203,9 +228,13 @@ void RenderableRegistry::updateEntityTransform(const World &world, EntityID e) {
   const glm::mat4 W = renderModelForEntity(world, e);
   for (uint32_t idx : it->second) {
     if (idx < m_items.size()) {
-      m_items[idx].model = W;
-      applyLightFields(world, e, m_items[idx]);
-      applyCameraFields(world, e, m_items[idx]);
+      Renderable &r = m_items[idx];
+      r.model = W;
+      r.bounds = transformBounds(localBoundsFor(r.mesh), W);
+      m_bounds.set(idx, r.bounds);
+      m_bvh.update(m_proxy[idx], boxOf(r.bounds));
+      applyLightFields(world, e, r);
+      applyCameraFields(world, e, r);
     }
   }
 }
@@ -237,11 +266,15 @@ void RenderableRegistry::rebuildEntity(const World &world, EntityID e) {
     r.pickID = packPick(e, si);
     r.mesh = sm.type;
     r.model = W;
+    r.bounds = transformBounds(localBoundsFor(r.mesh), W);
     r.materialGpuIndex = 0;
     applyLightFields(world, e, r);
     applyCameraFields(world, e, r);
 
     m_items.push_back(r);
+    m_bounds.push_back(r.bounds);
+    m_proxy.push_back(
+        m_bvh.insert(boxOf(r.bounds), (uint32_t)m_items.size() - 1u));
     indexRenderable((uint32_t)m_items.size() - 1u);
   }
 }
@@ -319,41 +352,145 @@ void RenderableRegistry::applyEvents(const World &world,
       continue;
     updateEntityTransform(world, e);
   }
+
+  m_bvh.maintain();
 }
 
 void RenderableRegistry::buildRoutedLists(const glm::vec3 &camPos,
-                                          const glm::vec3 &viewForward) {
+                                          const glm::vec3 &viewForward,
+                                          const Frustum *frustum) {
   (void)viewForward;
   m_opaque.clear();
   m_transparent.clear();
-  m_transparentSorted.clear();
-
-  m_opaque.reserve(m_items.size());
-  m_transparent.reserve(m_items.size());
-
-  for (const auto &r : m_items) {
+  m_opaqueKeys.clear();
+  m_transparentKeys.clear();
+
+  const uint32_t n = (uint32_t)m_items.size();
+  m_visible.resize(n);
+  uint32_t visibleCount = n;
+  if (frustum)
+    visibleCount = cullFrustum(*frustum, m_bounds, m_visible.data());
+  else
+    std::fill(m_visible.begin(), m_visible.end(), uint8_t(1));
+
+  m_cullStats.tested = n;
+  m_cullStats.visible = visibleCount;
+  m_cullStats.frustumCulled = n - visibleCount;
+
+  m_opaque.reserve(visibleCount);
+  m_opaqueKeys.reserve(visibleCount);
+
+  for (uint32_t i = 0; i < n; ++i) {
+    if (!m_visible[i])
+      continue;
+    const Renderable &r = m_items[i];
     if (r.alphaMode == MatAlphaMode::Blend) {
-      Renderable t = r;
-      const glm::vec3 worldPos = glm::vec3(r.model[3]);
-      const glm::vec3 d = worldPos - camPos;
-      t.sortKey = glm::dot(d, d);
-      m_transparent.push_back(t);
+      m_transparent.push_back(i);
+      m_transparentKeys.push_back(transparentDrawKey(r, camPos));
     } else {
-      m_opaque.push_back(r);
+      m_opaque.push_back(i);
+      m_opaqueKeys.push_back(opaqueDrawKey(r, camPos));
     }
   }
 
-  m_transparentSorted = m_transparent;
-  std::sort(m_transparentSorted.begin(), m_transparentSorted.end(),
-            [](const Renderable &a, const Renderable &b) {
-              if (a.sortKey != b.sortKey)
-                return a.sortKey > b.sortKey;
-              if (a.materialGpuIndex != b.materialGpuIndex)
-                return a.materialGpuIndex < b.materialGpuIndex;
-              if (a.pickID != b.pickID)
-                return a.pickID < b.pickID;
-              return a.submesh < b.submesh;
-            });
+  radixSortKeys(m_opaqueKeys, m_opaque, m_keyScratch, m_indexScratch);
+  radixSortKeys(m_transparentKeys, m_transparent, m_keyScratch,
+                m_indexScratch);
+}
+
+// ------------------------------
+// Spatial queries
+// ------------------------------
+
+void RenderableRegistry::queryFrustum(const Frustum &frustum,
+                                      std::vector<uint32_t> &out) const {
+  m_bvh.queryFrustum(frustum, [&](uint32_t idx) { out.push_back(idx); });
+}
+
+void RenderableRegistry::querySphere(const glm::vec3 &center, float radius,
+                                     std::vector<uint32_t> &out) const {
+  m_bvh.querySphere(center, radius,
+                    [&](uint32_t idx) { out.push_back(idx); });
+}
+
+void RenderableRegistry::queryAABB(const AABB &box,
+                                   std::vector<uint32_t> &out) const {
+  m_bvh.queryAABB(box, [&](uint32_t idx) { out.push_back(idx); });
+}
+
+// Ray vs. primitive in object space (all primitives fit in [-0.5, 0.5]^3).
+// Returns the entry distance or a negative value on a miss.
+static float rayPrimitive(ProcMeshType type, const glm::vec3 &o,
+                          const glm::vec3 &d) {
+  switch (type) {
+  case ProcMeshType::Sphere: {
+    const float a = glm::dot(d, d);
+    const float b = glm::dot(o, d);
+    const float c = glm::dot(o, o) - 0.25f;
+    const float disc = b * b - a * c;
+    if (disc < 0.0f || a <= 0.0f)
+      return -1.0f;
+    const float sq = std::sqrt(disc);
+    const float t0 = (-b - sq) / a;
+    return t0 >= 0.0f ? t0 : (-b + sq) / a;
+  }
+  case ProcMeshType::Plane:
+  case ProcMeshType::Circle: {
+    if (std::abs(d.y) < 1e-8f)
+      return -1.0f;
+    const float t = -o.y / d.y;
+    if (t < 0.0f)
+      return -1.0f;
+    const glm::vec3 p = o + d * t;
+    const bool inside = (type == ProcMeshType::Plane)
+                            ? (std::abs(p.x) <= 0.5f && std::abs(p.z) <= 0.5f)
+                            : (p.x * p.x + p.z * p.z <= 0.25f);
+    return inside ? t : -1.0f;
+  }
+  case ProcMeshType::Cube:
+  case ProcMeshType::Monkey:
+  default: {
+    const glm::vec3 inv = 1.0f / d;
+    const glm::vec3 t0 = (glm::vec3(-0.5f) - o) * inv;
+    const glm::vec3 t1 = (glm::vec3(0.5f) - o) * inv;
+    const glm::vec3 tmin = glm::min(t0, t1);
+    const glm::vec3 tmax = glm::max(t0, t1);
+    const float tEnter = std::max(std::max(tmin.x, tmin.y), tmin.z);
+    const float tExit = std::min(std::min(tmax.x, tmax.y), tmax.z);
+    if (tEnter > tExit || tExit < 0.0f)
+      return -1.0f;
+    return std::max(tEnter, 0.0f);
+  }
+  }
+}
+
+bool RenderableRegistry::raycast(
+    const glm::vec3 &origin, const glm::vec3 &dir, RayHit &hit,
+    const std::function<bool(const Renderable &)> &accept, float maxT) const {
+  hit = {};
+  float best = maxT;
+
+  m_bvh.raycast(origin, dir, maxT, [&](uint32_t idx, float tEnter) {
+    if (tEnter > best)
+      return best;
+    const Renderable &r = m_items[idx];
+    if (accept && !accept(r))
+      return best;
+
+    // Same parameterization in object space since the map is affine.
+    const glm::mat4 inv = glm::inverse(r.model);
+    const glm::vec3 o = glm::vec3(inv * glm::vec4(origin, 1.0f));
+    const glm::vec3 d = glm::vec3(inv * glm::vec4(dir, 0.0f));
+    const float t = rayPrimitive(r.mesh, o, d);
+    if (t >= 0.0f && t < best) {
+      best = t;
+      hit.index = idx;
+      hit.t = t;
+    }
+    return best;
+  });
+
+  return hit.index != ~0u;
 }
 
 } // namespace Nyx
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "scene/Culling.h"
+#include "scene/DynamicBVH.h"
 #include "scene/EntityID.h"
 #include "scene/Renderable.h"
+#include <cfloat>
 #include <cstdint>
+#include <functional>
 #include <glm/glm.hpp>
 #include <unordered_map>
 #include <vector>
@@ -12,6 +16,48 @@ namespace Nyx {
 class World;
 class WorldEvents;
 
+// Renderables of RenderableRegistry::all() in draw order, by index; valid
+// until the next buildRoutedLists() or registry edit.
+class RenderableDrawList final {
+public:
+  class Iterator final {
+  public:
+    Iterator(const Renderable *items, const uint32_t *at)
+        : m_items(items), m_at(at) {}
+    const Renderable &operator*() const { return m_items[*m_at]; }
+    Iterator &operator++() {
+      ++m_at;
+      return *this;
+    }
+    bool operator!=(const Iterator &o) const { return m_at != o.m_at; }
+
+  private:
+    const Renderable *m_items;
+    const uint32_t *m_at;
+  };
+
+  RenderableDrawList(const std::vector<Renderable> &items,
+                     const std::vector<uint32_t> &order)
+      : m_items(items.data()), m_order(&order) {}
+
+  size_t size() const { return m_order->size(); }
+  bool empty() const { return m_order->empty(); }
+  const Renderable &operator[](size_t i) const {
+    return m_items[(*m_order)[i]];
+  }
+  // Index into all() of the i-th draw.
+  uint32_t index(size_t i) const { return (*m_order)[i]; }
+
+  Iterator begin() const { return {m_items, m_order->data()}; }
+  Iterator end() const {
+    return {m_items, m_order->data() + m_order->size()};
+  }
+
+private:
+  const Renderable *m_items;
+  const std::vector<uint32_t> *m_order;
+};
+
 class RenderableRegistry final {
 public:
   void clear();
@@ -26,13 +72,43 @@ public:
   // Read access (renderer iterates this)
   const std::vector<Renderable> &all() const { return m_items; }
   std::vector<Renderable> &allMutable() { return m_items; }
-  const std::vector<Renderable> &opaque() const { return m_opaque; }
-  const std::vector<Renderable> &transparentSorted() const {
-    return m_transparentSorted;
+  // Opaque draws front to back, transparent ones back to front.
+  RenderableDrawList opaque() const { return {m_items, m_opaque}; }
+  RenderableDrawList transparentSorted() const {
+    return {m_items, m_transparent};
+  }
+
+  // Routes visible renderables into opaque()/transparentSorted(). With a
+  // frustum, items whose bounds are outside it are skipped; nullptr disables
+  // culling (everything is visible). Each list is ordered by a 64-bit draw
+  // key per renderable, radix sorted together with the indices.
+  void buildRoutedLists(const glm::vec3 &camPos, const glm::vec3 &viewForward,
+                        const Frustum *frustum = nullptr);
+
+  // Result of the last buildRoutedLists() for all()[idx].
+  bool isVisible(uint32_t idx) const {
+    return idx < m_visible.size() && m_visible[idx] != 0;
   }
+  const CullStats &cullStats() const { return m_cullStats; }
+
+  // ---- Spatial queries (BVH over all()) ----
+  // Append the indices into all() of renderables whose bounds pass the test.
+  void queryFrustum(const Frustum &frustum, std::vector<uint32_t> &out) const;
+  void querySphere(const glm::vec3 &center, float radius,
+                   std::vector<uint32_t> &out) const;
+  void queryAABB(const AABB &box, std::vector<uint32_t> &out) const;
 
-  void buildRoutedLists(const glm::vec3 &camPos,
-                        const glm::vec3 &viewForward);
+  struct RayHit {
+    uint32_t index = ~0u; // into all()
+    float t = 0.0f;       // distance along dir (in units of |dir|)
+  };
+  // Closest renderable hit by the ray, tested against the primitive's exact
+  // shape. `accept` may reject candidates (hidden entities, gizmos, ...).
+  bool raycast(const glm::vec3 &origin, const glm::vec3 &dir, RayHit &hit,
+               const std::function<bool(const Renderable &)> &accept = {},
+               float maxT = FLT_MAX) const;
+
+  const DynamicBVH &bvh() const { return m_bvh; }
 
   // Helpers
   bool hasEntity(EntityID e) const;
@@ -41,9 +117,20 @@ public:
 
 private:
   std::vector<Renderable> m_items;
-  std::vector<Renderable> m_opaque;
-  std::vector<Renderable> m_transparent;
-  std::vector<Renderable> m_transparentSorted;
+  // Indices into m_items in draw order, and their sort keys.
+  std::vector<uint32_t> m_opaque;
+  std::vector<uint32_t> m_transparent;
+  std::vector<uint64_t> m_opaqueKeys;
+  std::vector<uint64_t> m_transparentKeys;
+  std::vector<uint64_t> m_keyScratch;
+  std::vector<uint32_t> m_indexScratch;
+
+  // Parallel to m_items.
+  CullBoundsSoA m_bounds;
+  std::vector<uint8_t> m_visible;
+  CullStats m_cullStats{};
+  std::vector<uint32_t> m_proxy; // BVH proxy per item
+  DynamicBVH m_bvh;
 
   // Fast lookups
   std::unordered_map<uint32_t, uint32_t>
@@ -1,14 +1,57 @@
 #include "SceneManager.h"
 #include "scene/World.h"
+#include "core/JobSystem.h"
+#include "core/Log.h"
 #include "project/NyxProjectRuntime.h"
 #include "render/material/MaterialSystem.h"
 #include "serialization/SceneSerializer.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 
 namespace Nyx {
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+// One queued save. The active scene's carries a snapshot captured on the main
+// thread; other project scenes are loaded and rewritten on the worker.
+struct SceneManager::SaveJob {
+  std::string path;
+  bool active = false;
+  SceneSaveSnapshot snapshot;
+  double stallMs = 0.0;
+  double writeMs = 0.0;
+  bool ok = false;
+  std::atomic<bool> done{false};
+
+  void run() {
+    const Clock::time_point start = Clock::now();
+    if (active) {
+      ok = SceneSerializer::write(snapshot);
+    } else {
+      // Best-effort normalize/refresh existing scenes to the current
+      // serializer; one that does not load is left alone.
+      World tmp{};
+      ok = !SceneSerializer::load(path, tmp) ||
+           SceneSerializer::save(path, tmp);
+    }
+    writeMs = msSince(start);
+    done.store(true, std::memory_order_release);
+    done.notify_all();
+  }
+};
+
 void SceneManager::init(World &world, MaterialSystem &materials,
                         NyxProjectRuntime &project) {
   m_world = &world;
@@ -16,7 +59,16 @@ void SceneManager::init(World &world, MaterialSystem &materials,
   m_project = &project;
 }
 
-void SceneManager::shutdown() { m_active.reset(); }
+void SceneManager::shutdown() {
+  waitForSaves();
+  m_active.reset();
+  m_saveState.reset();
+}
+
+void SceneManager::trackWorldEvents() {
+  if (m_world && m_active)
+    m_saveState.observe(m_world->events());
+}
 
 const std::vector<std::string> &SceneManager::projectScenes() const {
   m_scenePathsCache.clear();
@@ -49,9 +101,10 @@ void SceneManager::ensureSceneListed(const std::string &relPath) {
 bool SceneManager::openScene(const std::string &absPath) {
   if (!m_world || !m_materials)
     return false;
+  waitForSaves();
 
   m_materials->reset();
-  if (!SceneSerializer::load(absPath, *m_world))
+  if (!SceneSerializer::load(absPath, *m_world, m_saveState))
     return false;
 
   SceneRuntime rt{};
@@ -74,8 +127,9 @@ bool SceneManager::createScene(const std::string &absPath) {
   if (p.has_parent_path())
     std::filesystem::create_directories(p.parent_path(), ec);
 
+  waitForSaves();
   m_world->clear();
-  if (!SceneSerializer::save(absPath, *m_world))
+  if (!SceneSerializer::save(absPath, *m_world, m_saveState))
     return false;
 
   SceneRuntime rt{};
@@ -92,11 +146,7 @@ bool SceneManager::createScene(const std::string &absPath) {
 bool SceneManager::saveActive() {
   if (!m_active || !m_world)
     return false;
-  std::error_code ec;
-  const std::filesystem::path p(m_active->pathAbs);
-  if (p.has_parent_path())
-    std::filesystem::create_directories(p.parent_path(), ec);
-  if (!SceneSerializer::save(m_active->pathAbs, *m_world))
+  if (!saveActiveTo(m_active->pathAbs))
     return false;
 
   m_active->dirty = false;
@@ -106,11 +156,7 @@ bool SceneManager::saveActive() {
 bool SceneManager::saveActiveAs(const std::string &absPath) {
   if (!m_world)
     return false;
-  std::error_code ec;
-  const std::filesystem::path p(absPath);
-  if (p.has_parent_path())
-    std::filesystem::create_directories(p.parent_path(), ec);
-  if (!SceneSerializer::save(absPath, *m_world))
+  if (!saveActiveTo(absPath))
     return false;
 
   SceneRuntime rt{};
@@ -139,11 +185,10 @@ bool SceneManager::saveAllProjectScenes() {
       continue;
     }
 
-    // Best-effort normalize/refresh existing scenes to the current serializer.
-    World tmp{};
-    if (!SceneSerializer::load(abs, tmp))
-      continue;
-    if (!SceneSerializer::save(abs, tmp))
+    waitForSave(abs);
+    auto job = std::make_shared<SaveJob>();
+    job->path = abs;
+    if (!runSave(job))
       return false;
     any = true;
   }
@@ -151,4 +196,105 @@ bool SceneManager::saveAllProjectScenes() {
   return any;
 }
 
+void SceneManager::pollSaves() {
+  std::vector<std::shared_ptr<SaveJob>> finished;
+  std::erase_if(m_saves, [&](const std::shared_ptr<SaveJob> &job) {
+    if (!job->done.load(std::memory_order_acquire))
+      return false;
+    finished.push_back(job);
+    return true;
+  });
+  // completeSave() may queue a retry, so m_saves is not walked here.
+  for (const std::shared_ptr<SaveJob> &job : finished)
+    completeSave(*job);
+}
+
+void SceneManager::waitForSaves() {
+  while (!m_saves.empty()) {
+    for (const std::shared_ptr<SaveJob> &job : m_saves)
+      job->done.wait(false, std::memory_order_acquire);
+    pollSaves();
+  }
+}
+
+// Waits for saves writing `absPath` and for the active scene's save: the save
+// state describes the file as of the last finished save, and the next capture
+// builds on that.
+void SceneManager::waitForSave(const std::string &absPath) {
+  bool waited = false;
+  for (const std::shared_ptr<SaveJob> &job : m_saves) {
+    if (job->active || job->path == absPath) {
+      job->done.wait(false, std::memory_order_acquire);
+      waited = true;
+    }
+  }
+  if (waited)
+    pollSaves();
+}
+
+bool SceneManager::saveActiveTo(const std::string &absPath) {
+  const Clock::time_point start = Clock::now();
+  waitForSave(absPath);
+
+  std::error_code ec;
+  const std::filesystem::path p(absPath);
+  if (p.has_parent_path())
+    std::filesystem::create_directories(p.parent_path(), ec);
+
+  trackWorldEvents();
+  auto job = std::make_shared<SaveJob>();
+  job->path = absPath;
+  job->active = true;
+  SceneSerializer::capture(absPath, *m_world, m_saveState, job->snapshot);
+  job->stallMs = msSince(start);
+
+  const bool ok = runSave(job);
+  if (!m_backgroundSaves)
+    m_lastSave.stallMs = msSince(start);
+  return ok;
+}
+
+bool SceneManager::runSave(const std::shared_ptr<SaveJob> &job) {
+  if (!m_backgroundSaves) {
+    job->run();
+    return completeSave(*job);
+  }
+  m_saves.push_back(job);
+  JobSystem::instance().submit([job] { job->run(); });
+  return true;
+}
+
+bool SceneManager::completeSave(SaveJob &job) {
+  if (!job.active) {
+    if (!job.ok)
+      Log::Error("Failed to save scene '{}'", job.path);
+    return job.ok;
+  }
+
+  SceneSerializer::finish(m_saveState, job.snapshot);
+  const bool current = m_active && m_active->pathAbs == job.path;
+  if (!job.ok && job.snapshot.incremental && current && m_world) {
+    // The save state was reset, so this captures a full rewrite.
+    Log::Warn("Scene '{}': incremental save failed, rewriting the file",
+              job.path);
+    if (saveActiveTo(job.path))
+      return true;
+  }
+
+  m_lastSave.phase = job.ok ? SceneSaveStatus::Phase::Saved
+                            : SceneSaveStatus::Phase::Failed;
+  m_lastSave.path = job.path;
+  m_lastSave.background = m_backgroundSaves;
+  m_lastSave.stallMs = job.stallMs;
+  m_lastSave.captureMs = job.snapshot.captureMs;
+  m_lastSave.writeMs = job.writeMs;
+
+  if (!job.ok) {
+    Log::Error("Failed to save scene '{}'", job.path);
+    if (current)
+      m_active->dirty = true;
+  }
+  return job.ok;
+}
+
 } // namespace Nyx
@@ -1,6 +1,8 @@
 #pragma once
 #include "SceneRuntime.h"
+#include "serialization/SceneSaveState.h"
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -11,6 +13,21 @@ class World;
 class MaterialSystem;
 class NyxProjectRuntime;
 
+// Outcome of the active scene's last finished save.
+struct SceneSaveStatus final {
+  enum class Phase : uint8_t { Idle, Saved, Failed };
+  Phase phase = Phase::Idle;
+  std::string path;
+  bool background = true;
+  double stallMs = 0.0;   // main thread: waiting on the previous save + capture
+  double captureMs = 0.0; // walking World
+  double writeMs = 0.0;   // encode + write; on the main thread when inline
+};
+
+// Scene saves are captured on the main thread and encoded and written by a
+// JobSystem worker. saveActive()/saveActiveAs()/saveAllProjectScenes() return
+// once the save is queued and report later failures through pollSaves(),
+// which marks the scene dirty again.
 class SceneManager final {
 public:
   void init(World &world, MaterialSystem &materials, NyxProjectRuntime &project);
@@ -22,11 +39,33 @@ public:
   bool saveActiveAs(const std::string &absPath);
   bool saveAllProjectScenes();
 
+  // Folds finished background saves back in; call once per frame.
+  void pollSaves();
+  // Blocks until no save is in flight, then polls.
+  void waitForSaves();
+  bool saveInFlight() const { return !m_saves.empty(); }
+  // Off: saves run start to finish on the calling thread (for comparing
+  // stalls, and for callers that need the file on disk right away).
+  void setBackgroundSaves(bool on) { m_backgroundSaves = on; }
+  bool backgroundSaves() const { return m_backgroundSaves; }
+  const SceneSaveStatus &lastSave() const { return m_lastSave; }
+
   bool hasActive() const { return m_active.has_value(); }
   SceneRuntime &active() { return *m_active; }
   const SceneRuntime &active() const { return *m_active; }
   uint64_t sceneChangeSerial() const { return m_sceneChangeSerial; }
 
+  // Feeds this frame's world events to the active scene's incremental save
+  // state; call before they are cleared. The editor calls it before tick(),
+  // and the engine again at the end of render() for the transforms
+  // animation moved. Edits that bypass events (undo/redo) must call
+  // markActiveSceneFullyDirty() instead.
+  void trackWorldEvents();
+  void markActiveSceneFullyDirty() { m_saveState.markAllDirty(); }
+  // Submesh materials assigned without a MeshChanged event.
+  void markActiveSceneMeshesDirty() { m_saveState.markMeshesDirty(); }
+  const SceneSaveState &saveState() const { return m_saveState; }
+
   const std::vector<std::string> &projectScenes() const;
 
 private:
@@ -36,9 +75,19 @@ private:
   mutable std::vector<std::string> m_scenePathsCache;
 
   std::optional<SceneRuntime> m_active;
+  SceneSaveState m_saveState;
   uint64_t m_sceneChangeSerial = 0;
 
+  struct SaveJob;
+  std::vector<std::shared_ptr<SaveJob>> m_saves;
+  bool m_backgroundSaves = true;
+  SceneSaveStatus m_lastSave;
+
   void ensureSceneListed(const std::string &relPath);
+  bool saveActiveTo(const std::string &absPath);
+  bool runSave(const std::shared_ptr<SaveJob> &job);
+  bool completeSave(SaveJob &job);
+  void waitForSave(const std::string &absPath);
 };
 
 } // namespace Nyx
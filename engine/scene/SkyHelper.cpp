@@ -6,13 +6,8 @@ namespace Nyx {
 
 EntityID getSkyEntity(World &world) {
   // Look for existing Sky component
-  for (EntityID e : world.alive()) {
-    if (!world.isAlive(e))
-      continue;
-    if (world.hasSky(e)) {
-      return e;
-    }
-  }
+  if (!world.skyPool().empty())
+    return world.skyPool().entities().front();
 
   // Create if missing
   EntityID skyE = world.createEntity("Sky");
@@ -1,64 +1,185 @@
 #include "TransformSystem.h"
-#include "../core/Assert.h"
-#include <glm/gtc/matrix_transform.hpp>
+#include "../core/JobSystem.h"
 #include <glm/gtx/quaternion.hpp>
 #include "World.h"
 
+#include <algorithm>
+
 namespace Nyx {
 
-static glm::mat4 trs(const CTransform &t) {
-  glm::mat4 M(1.0f);
-  M = glm::translate(M, t.translation);
-  M *= glm::toMat4(t.rotation);
-  M = glm::scale(M, t.scale);
-  return M;
-}
+// The first level with kMinSubtrees nodes splits the tree: everything below
+// it is handed out as whole subtrees, packed into blocks of at least
+// kBlockNodes. Fewer nodes than kParallelMinNodes below the split are not
+// worth waking workers for; otherwise each thread gets about
+// kChunksPerThread claims, enough to even out uneven subtrees.
+static constexpr uint32_t kMinSubtrees = 256;
+static constexpr uint32_t kBlockNodes = 2048;
+static constexpr uint32_t kParallelMinNodes = 4096;
+static constexpr uint32_t kChunksPerThread = 4;
 
-static void markSubtreeDirty(World &w, EntityID e) {
-  if (!w.isAlive(e))
-    return;
-  w.worldTransform(e).dirty = true;
+// translate * rotate * scale, written out: the rotation's columns scaled,
+// the translation in the last column. No matrix products.
+static glm::mat4 composeTRS(const CTransform &t) {
+  const glm::mat3 R = glm::mat3_cast(t.rotation);
+  return glm::mat4(glm::vec4(R[0] * t.scale.x, 0.0f),
+                   glm::vec4(R[1] * t.scale.y, 0.0f),
+                   glm::vec4(R[2] * t.scale.z, 0.0f),
+                   glm::vec4(t.translation, 1.0f));
+}
 
-  EntityID c = w.hierarchy(e).firstChild;
-  while (c != InvalidEntity) {
-    EntityID next = w.hierarchy(c).nextSibling;
-    markSubtreeDirty(w, c);
-    c = next;
+// parent * local where local's bottom row is (0, 0, 0, 1), as every TRS
+// matrix's is: 36 multiplies instead of 64.
+static glm::mat4 mulAffine(const glm::mat4 &parent, const glm::mat4 &local) {
+  glm::mat4 r;
+  for (int c = 0; c < 3; ++c) {
+    r[c] = parent[0] * local[c].x + parent[1] * local[c].y +
+           parent[2] * local[c].z;
   }
+  r[3] = parent[0] * local[3].x + parent[1] * local[3].y +
+         parent[2] * local[3].z + parent[3];
+  return r;
 }
 
-static void updateNode(World &w, EntityID e, const glm::mat4 &parentWorld,
-                       bool parentDirty) {
-  auto &lt = w.transform(e);
-  auto &wt = w.worldTransform(e);
+void TransformSystem::rebuild(World &world) {
+  m_entities.clear();
+  m_parent.clear();
+  m_blockBegin.clear();
+  m_topLevels = 0;
 
-  // If parent moved or local dirty, mark world dirty (cheap)
-  if (lt.dirty || parentDirty)
-    wt.dirty = true;
+  for (EntityID e : world.alive()) {
+    const CHierarchy *h = world.m_hier.find(e);
+    if (h && h->parent == InvalidEntity) {
+      m_entities.push_back(e);
+      m_parent.push_back(NoParent);
+    }
+  }
 
-  const bool worldUpdated = wt.dirty;
-  if (wt.dirty) {
-    wt.world = parentWorld * trs(lt);
-    wt.dirty = false;
-    lt.dirty = false;
+  // Breadth-first while the levels are narrow: a scene root or a handful of
+  // characters on top of everything else.
+  uint32_t begin = 0;
+  while (begin < (uint32_t)m_entities.size() &&
+         (uint32_t)m_entities.size() - begin < kMinSubtrees) {
+    const uint32_t end = (uint32_t)m_entities.size();
+    for (uint32_t i = begin; i < end; ++i) {
+      EntityID c = world.m_hier.get(m_entities[i]).firstChild;
+      while (c != InvalidEntity) {
+        m_entities.push_back(c);
+        m_parent.push_back(i);
+        c = world.m_hier.get(c).nextSibling;
+      }
+    }
+    begin = end;
+    ++m_topLevels;
   }
 
-  EntityID c = w.hierarchy(e).firstChild;
-  while (c != InvalidEntity) {
-    EntityID next = w.hierarchy(c).nextSibling;
-    updateNode(w, c, wt.world, worldUpdated);
-    c = next;
+  // Then the split level's subtrees one after another, each depth-first so
+  // a parent is the node written just before its first child.
+  const std::vector<EntityID> split(m_entities.begin() + begin,
+                                    m_entities.end());
+  const std::vector<uint32_t> splitParent(m_parent.begin() + begin,
+                                          m_parent.end());
+  m_entities.resize(begin);
+  m_parent.resize(begin);
+  m_blockBegin.push_back(begin);
+  std::vector<std::pair<EntityID, uint32_t>> stack;
+  for (size_t s = 0; s < split.size(); ++s) {
+    stack.push_back({split[s], splitParent[s]});
+    while (!stack.empty()) {
+      const auto [e, p] = stack.back();
+      stack.pop_back();
+      const uint32_t i = (uint32_t)m_entities.size();
+      m_entities.push_back(e);
+      m_parent.push_back(p);
+      EntityID c = world.m_hier.get(e).firstChild;
+      while (c != InvalidEntity) {
+        stack.push_back({c, i});
+        c = world.m_hier.get(c).nextSibling;
+      }
+    }
+    if ((uint32_t)m_entities.size() - m_blockBegin.back() >= kBlockNodes)
+      m_blockBegin.push_back((uint32_t)m_entities.size());
+  }
+  if (m_blockBegin.back() != (uint32_t)m_entities.size())
+    m_blockBegin.push_back((uint32_t)m_entities.size());
+
+  const size_t n = m_entities.size();
+  m_trSlot.resize(n);
+  m_wtrSlot.resize(n);
+  m_changed.assign(n, 0);
+  m_emit.assign(n, 0);
+
+  JobSystem::instance().parallelFor(
+      (uint32_t)n, kBlockNodes * 4u, [&](uint32_t b, uint32_t e) {
+        for (uint32_t i = b; i < e; ++i) {
+          m_trSlot[i] = world.m_tr.indexOf(m_entities[i]);
+          m_wtrSlot[i] = world.m_wtr.indexOf(m_entities[i]);
+        }
+      });
+
+  m_builtVersion = world.hierarchyVersion();
+}
+
+void TransformSystem::updateRange(World &world, uint32_t begin, uint32_t end) {
+  auto &locals = world.m_tr.values();
+  auto &worlds = world.m_wtr.values();
+  for (uint32_t i = begin; i < end; ++i) {
+    CTransform &lt = locals[m_trSlot[i]];
+    CWorldTransform &wt = worlds[m_wtrSlot[i]];
+    const uint32_t p = m_parent[i];
+    const bool parentChanged = p != NoParent && m_changed[p];
+    const bool localChanged = lt.dirty;
+
+    // The local matrix is recomposed whenever the world one is, as the
+    // recursive update did: undo/redo, snapshot restores and editor code
+    // assign CTransform fields without raising its dirty flag, so a cached
+    // local could be stale by the time a parent moves.
+    if (localChanged || parentChanged || wt.dirty) {
+      const glm::mat4 local = composeTRS(lt);
+      wt.world = (p == NoParent)
+                     ? local
+                     : mulAffine(worlds[m_wtrSlot[p]].world, local);
+      lt.dirty = false;
+      wt.dirty = false;
+      m_changed[i] = 1;
+    } else {
+      m_changed[i] = 0;
+    }
+    m_emit[i] = (localChanged || parentChanged) ? 1 : 0;
   }
 }
 
 void TransformSystem::update(World &world) {
-  // Roots drive traversal
-  auto roots = world.roots();
-  for (EntityID r : roots) {
-    if (!world.isAlive(r))
-      continue;
-    updateNode(world, r, glm::mat4(1.0f), false);
+  m_lastRebuilt = m_builtVersion != world.hierarchyVersion();
+  if (m_lastRebuilt)
+    rebuild(world);
+
+  // Above the split, breadth-first order puts every parent first.
+  const uint32_t split = m_blockBegin.front();
+  updateRange(world, 0, split);
+
+  // Below it, blocks only read their own nodes and the finished top.
+  JobSystem &jobs = JobSystem::instance();
+  const uint32_t blocks = (uint32_t)m_blockBegin.size() - 1u;
+  const uint32_t below = (uint32_t)m_entities.size() - split;
+  if (below < kParallelMinNodes || blocks < 2u) {
+    updateRange(world, split, split + below);
+  } else {
+    const uint32_t threads =
+        std::min(jobs.workerCount(), jobs.helperLimit()) + 1u;
+    const uint32_t claims = threads * kChunksPerThread;
+    jobs.parallelFor(blocks, (blocks + claims - 1u) / claims,
+                     [&](uint32_t b, uint32_t e) {
+                       updateRange(world, m_blockBegin[b], m_blockBegin[e]);
+                     });
+  }
+
+  // Events are pushed serially, in flat order.
+  m_lastUpdated = 0;
+  for (uint32_t i = 0; i < (uint32_t)m_entities.size(); ++i) {
+    m_lastUpdated += m_changed[i];
+    if (m_emit[i])
+      world.m_events.push({WorldEventType::TransformChanged, m_entities[i]});
   }
 }
 
-} // namespace Nyx
\ No newline at end of file
+} // namespace Nyx
@@ -1,12 +1,54 @@
 #pragma once
 
+#include "EntityID.h"
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
 namespace Nyx {
 
 class World;
 
+// Flattened transform hierarchy.
+// Nodes are stored with the flat index of their parent, always after it:
+// breadth-first down to the first level wide enough to split the tree, then
+// that level's subtrees one after another, packed into blocks that update in
+// parallel. A deep forest of narrow chains spreads over the workers as well
+// as a flat one. The layout is rebuilt when World::hierarchyVersion()
+// changes (entity created/destroyed, reparented).
 class TransformSystem final {
 public:
   void update(World &world); // recompute all dirty
+  void invalidate() { m_builtVersion = 0; }
+
+  // Stats for the last update().
+  uint32_t nodeCount() const { return (uint32_t)m_entities.size(); }
+  uint32_t topLevelCount() const { return m_topLevels; } // above the split
+  uint32_t blockCount() const {
+    return m_blockBegin.empty() ? 0u : (uint32_t)m_blockBegin.size() - 1u;
+  }
+  uint32_t lastUpdatedCount() const { return m_lastUpdated; }
+  bool lastRebuilt() const { return m_lastRebuilt; }
+
+private:
+  void rebuild(World &world);
+  void updateRange(World &world, uint32_t begin, uint32_t end);
+
+  static constexpr uint32_t NoParent = ~0u;
+
+  uint64_t m_builtVersion = 0;
+  uint32_t m_topLevels = 0;
+  std::vector<EntityID> m_entities;
+  std::vector<uint32_t> m_parent;     // flat index, NoParent for roots
+  std::vector<uint32_t> m_blockBegin; // block B = [begin[B], begin[B + 1])
+  std::vector<uint32_t> m_trSlot;     // dense slots in World's pools
+  std::vector<uint32_t> m_wtrSlot;
+  std::vector<uint8_t> m_changed; // world matrix recomputed this update
+  std::vector<uint8_t> m_emit;    // push TransformChanged
+
+  uint32_t m_lastUpdated = 0;
+  bool m_lastRebuilt = false;
 };
 
 } // namespace Nyx
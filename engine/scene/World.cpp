@@ -5,21 +5,34 @@
 namespace Nyx {
 
 EntityID World::createEntity(const std::string &n) {
-  const EntityID e = {m_next.index++, 1};
+  EntityID e{};
+  if (!m_freeIndices.empty()) {
+    e.index = m_freeIndices.back();
+    m_freeIndices.pop_back();
+  } else {
+    e.index = m_nextIndex++;
+    m_generation.resize((size_t)e.index + 1u, 1u);
+    m_aliveSlot.resize((size_t)e.index + 1u, ~0u);
+  }
+  e.generation = m_generation[e.index];
+
+  m_aliveSlot[e.index] = (uint32_t)m_alive.size();
   m_alive.push_back(e);
 
-  m_hier[e] = CHierarchy{};
-  m_name[e] = CName{n};
-  m_tr[e] = CTransform{};
-  m_wtr[e] = CWorldTransform{};
+  m_hier.set(e, CHierarchy{});
+  attachToParent(e, InvalidEntity);
+  m_name.set(e, CName{n});
+  m_tr.set(e, CTransform{});
+  m_wtr.set(e, CWorldTransform{});
 
   EntityUUID id = m_uuidGen.next();
   while (m_entityByUUID.find(id.value) != m_entityByUUID.end()) {
     id = m_uuidGen.next();
   }
-  m_uuid[e] = id;
+  m_uuid.set(e, id);
   m_entityByUUID[id.value] = e;
 
+  ++m_hierarchyVersion;
   m_events.push({WorldEventType::EntityCreated, e});
   return e;
 }
@@ -32,29 +45,41 @@ EntityID World::createEntityWithUUID(EntityUUID uuid, const std::string &name) {
 
   EntityID e = createEntity(name);
 
-  const EntityUUID old = m_uuid[e];
+  const EntityUUID old = m_uuid.get(e);
   m_entityByUUID.erase(old.value);
 
-  m_uuid[e] = uuid;
+  m_uuid.set(e, uuid);
   m_entityByUUID[uuid.value] = e;
   return e;
 }
 
 bool World::isAlive(EntityID e) const {
-  return e != InvalidEntity && m_hier.find(e) != m_hier.end();
+  if (e.generation == 0 || e.index >= m_aliveSlot.size())
+    return false;
+  const uint32_t slot = m_aliveSlot[e.index];
+  return slot < m_alive.size() && m_alive[slot] == e;
 }
 
 void World::destroySubtree(EntityID root) {
   if (!isAlive(root))
     return;
 
-  EntityID ch = m_hier[root].firstChild;
-  while (ch != InvalidEntity) {
-    EntityID next = m_hier[ch].nextSibling;
-    destroySubtree(ch);
-    ch = next;
+  // Breadth-first walk; destroying in reverse visits every child before its
+  // parent without recursing (deep chains would overflow the stack).
+  m_destroyScratch.clear();
+  m_destroyScratch.push_back(root);
+  for (size_t i = 0; i < m_destroyScratch.size(); ++i) {
+    EntityID ch = m_hier.get(m_destroyScratch[i]).firstChild;
+    while (ch != InvalidEntity) {
+      m_destroyScratch.push_back(ch);
+      ch = m_hier.get(ch).nextSibling;
+    }
   }
+  for (size_t i = m_destroyScratch.size(); i-- > 0;)
+    destroySingle(m_destroyScratch[i]);
+}
 
+void World::destroySingle(EntityID root) {
   if (hasCamera(root)) {
     m_events.push({WorldEventType::CameraDestroyed, root});
     if (m_activeCamera == root) {
@@ -67,34 +92,49 @@ void World::destroySubtree(EntityID root) {
   detachFromParent(root);
   clearEntityCategories(root);
 
-  m_mesh.erase(root);
-  m_renderableAsset.erase(root);
-  m_cam.erase(root);
-  m_camMat.erase(root);
-  m_light.erase(root);
-
-  m_hier.erase(root);
-  m_name.erase(root);
-  m_tr.erase(root);
-  m_wtr.erase(root);
-  auto uuidIt = m_uuid.find(root);
-  if (uuidIt != m_uuid.end()) {
-    m_entityByUUID.erase(uuidIt->second.value);
-    m_uuid.erase(uuidIt);
+  m_mesh.remove(root);
+  m_renderableAsset.remove(root);
+  m_cam.remove(root);
+  m_camMat.remove(root);
+  m_light.remove(root);
+  m_sky.remove(root);
+
+  m_hier.remove(root);
+  m_name.remove(root);
+  m_tr.remove(root);
+  m_wtr.remove(root);
+  if (const EntityUUID *id = m_uuid.find(root)) {
+    m_entityByUUID.erase(id->value);
+    m_uuid.remove(root);
   }
 
-  auto it = std::find(m_alive.begin(), m_alive.end(), root);
-  if (it != m_alive.end())
-    m_alive.erase(it);
+  // Swap-remove from the alive list, then retire the index with a bumped
+  // generation so stale handles stop resolving.
+  const uint32_t slot = m_aliveSlot[root.index];
+  const EntityID moved = m_alive.back();
+  m_alive[slot] = moved;
+  m_aliveSlot[moved.index] = slot;
+  m_alive.pop_back();
+  m_aliveSlot[root.index] = ~0u;
 
+  uint32_t &gen = m_generation[root.index];
+  gen = (gen == ~0u) ? 1u : gen + 1u;
+  m_freeIndices.push_back(root.index);
+
+  ++m_hierarchyVersion;
   m_events.push({WorldEventType::EntityDestroyed, root});
 }
 
 void World::destroyEntity(EntityID e) { destroySubtree(e); }
 
 void World::clear() {
-  m_next = {1, 0};
+  m_nextIndex = 1;
+  m_generation.clear();
+  m_aliveSlot.clear();
+  m_freeIndices.clear();
   m_alive.clear();
+  m_firstRoot = InvalidEntity;
+  m_lastRoot = InvalidEntity;
 
   m_hier.clear();
   m_name.clear();
@@ -116,27 +156,23 @@ void World::clear() {
 
   m_activeCamera = InvalidEntity;
   m_events.clear();
+  ++m_hierarchyVersion;
 }
 
 std::vector<EntityID> World::roots() const {
   std::vector<EntityID> r;
-  r.reserve(m_alive.size());
-  for (EntityID e : m_alive) {
-    auto it = m_hier.find(e);
-    if (it != m_hier.end() && it->second.parent == InvalidEntity)
-      r.push_back(e);
-  }
+  for (EntityID e = m_firstRoot; e != InvalidEntity;
+       e = m_hier.get(e).nextSibling)
+    r.push_back(e);
   return r;
 }
 
-CHierarchy &World::hierarchy(EntityID e) { return m_hier.at(e); }
-const CHierarchy &World::hierarchy(EntityID e) const { return m_hier.at(e); }
+CHierarchy &World::hierarchy(EntityID e) { return m_hier.get(e); }
+const CHierarchy &World::hierarchy(EntityID e) const { return m_hier.get(e); }
 
 EntityID World::parentOf(EntityID e) const {
-  auto it = m_hier.find(e);
-  if (it == m_hier.end())
-    return InvalidEntity;
-  return it->second.parent;
+  const CHierarchy *h = m_hier.find(e);
+  return h ? h->parent : InvalidEntity;
 }
 
 static bool isDescendant(const World &w, EntityID node,
@@ -176,51 +212,50 @@ void World::setParent(EntityID child, EntityID newParent) {
   m_events.push({WorldEventType::TransformChanged, child});
 }
 
+// Roots form a sibling list of their own (m_firstRoot/m_lastRoot), so
+// detaching a root unlinks it from there.
 void World::detachFromParent(EntityID child) {
-  auto &hc = m_hier.at(child);
-  EntityID p = hc.parent;
-  if (p == InvalidEntity)
-    return;
-
-  EntityID cur = m_hier.at(p).firstChild;
-  EntityID prev = InvalidEntity;
-
-  while (cur != InvalidEntity) {
-    if (cur == child) {
-      EntityID next = m_hier.at(cur).nextSibling;
-      if (prev == InvalidEntity)
-        m_hier.at(p).firstChild = next;
-      else
-        m_hier.at(prev).nextSibling = next;
-      break;
-    }
-    prev = cur;
-    cur = m_hier.at(cur).nextSibling;
-  }
+  auto &hc = m_hier.get(child);
+  const EntityID p = hc.parent;
+  EntityID &first = p != InvalidEntity ? m_hier.get(p).firstChild : m_firstRoot;
+  EntityID &last = p != InvalidEntity ? m_hier.get(p).lastChild : m_lastRoot;
+
+  if (hc.prevSibling != InvalidEntity)
+    m_hier.get(hc.prevSibling).nextSibling = hc.nextSibling;
+  else
+    first = hc.nextSibling;
+  if (hc.nextSibling != InvalidEntity)
+    m_hier.get(hc.nextSibling).prevSibling = hc.prevSibling;
+  else
+    last = hc.prevSibling;
 
   hc.parent = InvalidEntity;
+  hc.prevSibling = InvalidEntity;
   hc.nextSibling = InvalidEntity;
+  ++m_hierarchyVersion;
 }
 
 void World::attachToParent(EntityID child, EntityID newParent) {
-  auto &hc = m_hier.at(child);
+  auto &hc = m_hier.get(child);
 
   hc.parent = newParent;
+  hc.prevSibling = InvalidEntity;
   hc.nextSibling = InvalidEntity;
-
-  if (newParent == InvalidEntity)
-    return;
-
-  auto &hp = m_hier.at(newParent);
-  if (hp.firstChild == InvalidEntity) {
-    hp.firstChild = child;
+  ++m_hierarchyVersion;
+
+  EntityID &first =
+      newParent != InvalidEntity ? m_hier.get(newParent).firstChild : m_firstRoot;
+  EntityID &last =
+      newParent != InvalidEntity ? m_hier.get(newParent).lastChild : m_lastRoot;
+  if (last == InvalidEntity) {
+    first = child;
+    last = child;
     return;
   }
 
-  EntityID cur = hp.firstChild;
-  while (m_hier.at(cur).nextSibling != InvalidEntity)
-    cur = m_hier.at(cur).nextSibling;
-  m_hier.at(cur).nextSibling = child;
+  m_hier.get(last).nextSibling = child;
+  hc.prevSibling = last;
+  last = child;
 }
 
 } // namespace Nyx
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "Camera.h"
+#include "ComponentPool.h"
 #include "Components.h"
 #include "EntityID.h"
 #include "EntityUUID.h"
 #include "RenderableAssetComponent.h"
+#include "TransformSystem.h"
 #include "WorldEvents.h"
 
 #include <cstdint>
@@ -14,73 +16,6 @@
 
 namespace Nyx {
 
-// ------------------------------
-// Dense+Sparse component storage
-// ------------------------------
-template <typename T> class ComponentPool final {
-public:
-  bool has(EntityID e) const {
-    const auto it = m_sparse.find(e.index);
-    if (it == m_sparse.end())
-      return false;
-    const uint32_t denseIdx = it->second;
-    return denseIdx < m_denseEntities.size() && m_denseEntities[denseIdx] == e;
-  }
-
-  T &get(EntityID e) { return m_dense[denseIndex(e)]; }
-  const T &get(EntityID e) const { return m_dense[denseIndex(e)]; }
-
-  template <class... Args> T &ensure(EntityID e, Args &&...args) {
-    if (has(e))
-      return get(e);
-    const uint32_t idx = (uint32_t)m_dense.size();
-    m_denseEntities.push_back(e);
-    m_dense.emplace_back(T{std::forward<Args>(args)...});
-    m_sparse[e.index] = idx;
-    return m_dense.back();
-  }
-
-  void remove(EntityID e) {
-    const auto it = m_sparse.find(e.index);
-    if (it == m_sparse.end())
-      return;
-
-    const uint32_t idx = it->second;
-    if (idx >= m_denseEntities.size() || m_denseEntities[idx] != e) {
-      m_sparse.erase(it);
-      return;
-    }
-
-    const uint32_t last = (uint32_t)m_dense.size() - 1u;
-    if (idx != last) {
-      m_dense[idx] = std::move(m_dense[last]);
-      m_denseEntities[idx] = m_denseEntities[last];
-      m_sparse[m_denseEntities[idx].index] = idx;
-    }
-
-    m_dense.pop_back();
-    m_denseEntities.pop_back();
-    m_sparse.erase(it);
-  }
-
-  void clear() {
-    m_dense.clear();
-    m_denseEntities.clear();
-    m_sparse.clear();
-  }
-
-private:
-  uint32_t denseIndex(EntityID e) const {
-    const auto it = m_sparse.find(e.index);
-    return (it == m_sparse.end()) ? ~0u : it->second;
-  }
-
-  std::vector<T> m_dense;
-  std::vector<EntityID> m_denseEntities;
-  std::unordered_map<uint32_t, uint32_t>
-      m_sparse; // entity.index -> dense index
-};
-
 // ------------------------------
 // World
 // ------------------------------
@@ -102,8 +37,20 @@ public:
   bool isAlive(EntityID e) const;
 
   const std::vector<EntityID> &alive() const { return m_alive; }
+  // Parentless entities in creation order; one re-parented to the root
+  // goes last.
   std::vector<EntityID> roots() const;
 
+  // Packed component arrays for linear iteration (unordered).
+  const ComponentPool<CTransform> &transformPool() const { return m_tr; }
+  const ComponentPool<CWorldTransform> &worldTransformPool() const {
+    return m_wtr;
+  }
+  const ComponentPool<CMesh> &meshPool() const { return m_mesh; }
+  const ComponentPool<CCamera> &cameraPool() const { return m_cam; }
+  const ComponentPool<CLight> &lightPool() const { return m_light; }
+  const ComponentPool<CSky> &skyPool() const { return m_sky; }
+
   // ---- Hierarchy ----
   CHierarchy &hierarchy(EntityID e);
   const CHierarchy &hierarchy(EntityID e) const;
@@ -135,6 +82,10 @@ public:
 
   // recompute world matrices if dirty (hierarchy-aware)
   void updateTransforms();
+  const TransformSystem &transformSystem() const { return m_transformSystem; }
+
+  // Bumped whenever the entity set or any parent link changes.
+  uint64_t hierarchyVersion() const { return m_hierarchyVersion; }
 
   // ---- Mesh ----
   bool hasMesh(EntityID e) const;
@@ -206,29 +157,40 @@ public:
   void setCategoryParent(uint32_t idx, int32_t parentIdx);
 
 private:
-  // Entity storage (simple SoA-by-map for now; you can swap to sparse sets
-  // later)
-  EntityID m_next = {1, 0};
+  friend class TransformSystem;
+
+  // Entity slots: indices are recycled through m_freeIndices and carry a
+  // generation that is bumped on destroy. m_aliveSlot maps index -> position
+  // in m_alive for O(1) swap-remove.
+  uint32_t m_nextIndex = 1;
+  std::vector<uint32_t> m_generation;
+  std::vector<uint32_t> m_aliveSlot;
+  std::vector<uint32_t> m_freeIndices;
   std::vector<EntityID> m_alive;
+  // Roots are sibling-linked like children (CHierarchy prev/nextSibling).
+  EntityID m_firstRoot = InvalidEntity;
+  EntityID m_lastRoot = InvalidEntity;
+  std::vector<EntityID> m_destroyScratch;
+  std::vector<EntityID> m_dirtyScratch;
 
   // Core components
-  std::unordered_map<EntityID, CHierarchy, EntityHash> m_hier;
-  std::unordered_map<EntityID, CName, EntityHash> m_name;
-  std::unordered_map<EntityID, CTransform, EntityHash> m_tr;
-  std::unordered_map<EntityID, CWorldTransform, EntityHash> m_wtr;
+  ComponentPool<CHierarchy> m_hier;
+  ComponentPool<CName> m_name;
+  ComponentPool<CTransform> m_tr;
+  ComponentPool<CWorldTransform> m_wtr;
 
   // Optional components
-  std::unordered_map<EntityID, CMesh, EntityHash> m_mesh;
-  std::unordered_map<EntityID, CRenderableAsset, EntityHash> m_renderableAsset;
-  std::unordered_map<EntityID, CCamera, EntityHash> m_cam;
-  std::unordered_map<EntityID, CCameraMatrices, EntityHash> m_camMat;
-  std::unordered_map<EntityID, CLight, EntityHash> m_light;
-  std::unordered_map<EntityID, CSky, EntityHash> m_sky;
+  ComponentPool<CMesh> m_mesh;
+  ComponentPool<CRenderableAsset> m_renderableAsset;
+  ComponentPool<CCamera> m_cam;
+  ComponentPool<CCameraMatrices> m_camMat;
+  ComponentPool<CLight> m_light;
+  ComponentPool<CSky> m_sky;
   CSky m_skySettings{};
 
   // UUID storage
   EntityUUIDGen m_uuidGen{};
-  std::unordered_map<EntityID, EntityUUID, EntityHash> m_uuid;
+  ComponentPool<EntityUUID> m_uuid;
   std::unordered_map<uint64_t, EntityID> m_entityByUUID;
 
   // World meta
@@ -236,19 +198,22 @@ private:
 
   // Categories
   std::vector<Category> m_categories;
-  std::unordered_map<EntityID, std::vector<uint32_t>, EntityHash>
-      m_entityCategories;
+  ComponentPool<std::vector<uint32_t>> m_entityCategories;
 
   // Events
   WorldEvents m_events;
 
+  // Flattened transform hierarchy, rebuilt on hierarchyVersion changes
+  TransformSystem m_transformSystem;
+  uint64_t m_hierarchyVersion = 1;
+
 private:
   void detachFromParent(EntityID child);
   void attachToParent(EntityID child, EntityID newParent);
   void destroySubtree(EntityID root);
+  void destroySingle(EntityID e);
 
   // Transform helpers
-  glm::mat4 localMatrix(EntityID e) const;
   void markWorldDirtyRecursive(EntityID e);
 };
 
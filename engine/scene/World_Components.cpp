@@ -2,37 +2,31 @@
 
 namespace Nyx {
 
-bool World::hasMesh(EntityID e) const { return m_mesh.find(e) != m_mesh.end(); }
+bool World::hasMesh(EntityID e) const { return m_mesh.has(e); }
 
 CMesh &World::ensureMesh(EntityID e) {
-  auto it = m_mesh.find(e);
-  if (it != m_mesh.end())
-    return it->second;
+  if (CMesh *existing = m_mesh.find(e))
+    return *existing;
 
-  CMesh mc{};
+  CMesh &mc = m_mesh.ensure(e);
   mc.submeshes.push_back(MeshSubmesh{});
-  m_mesh.emplace(e, mc);
 
   m_events.push({WorldEventType::MeshChanged, e});
-  return m_mesh.at(e);
+  return mc;
 }
 
-CMesh &World::mesh(EntityID e) { return m_mesh.at(e); }
-const CMesh &World::mesh(EntityID e) const { return m_mesh.at(e); }
+CMesh &World::mesh(EntityID e) { return m_mesh.get(e); }
+const CMesh &World::mesh(EntityID e) const { return m_mesh.get(e); }
 
 void World::removeMesh(EntityID e) {
-  auto it = m_mesh.find(e);
-  if (it == m_mesh.end())
+  if (!m_mesh.remove(e))
     return;
-  m_mesh.erase(it);
   m_events.push({WorldEventType::MeshChanged, e});
 }
 
 uint32_t World::submeshCount(EntityID e) const {
-  auto it = m_mesh.find(e);
-  if (it == m_mesh.end())
-    return 0;
-  return (uint32_t)it->second.submeshes.size();
+  const CMesh *mc = m_mesh.find(e);
+  return mc ? (uint32_t)mc->submeshes.size() : 0u;
 }
 
 MeshSubmesh &World::submesh(EntityID e, uint32_t si) {
@@ -45,57 +39,50 @@ MeshSubmesh &World::submesh(EntityID e, uint32_t si) {
 }
 
 bool World::hasRenderableAsset(EntityID e) const {
-  return m_renderableAsset.find(e) != m_renderableAsset.end();
+  return m_renderableAsset.has(e);
 }
 
 CRenderableAsset &World::ensureRenderableAsset(EntityID e) {
-  auto it = m_renderableAsset.find(e);
-  if (it != m_renderableAsset.end())
-    return it->second;
-  m_renderableAsset.emplace(e, CRenderableAsset{});
-  return m_renderableAsset.at(e);
+  return m_renderableAsset.ensure(e);
 }
 
 CRenderableAsset &World::renderableAsset(EntityID e) {
-  return m_renderableAsset.at(e);
+  return m_renderableAsset.get(e);
 }
 
 const CRenderableAsset &World::renderableAsset(EntityID e) const {
-  return m_renderableAsset.at(e);
+  return m_renderableAsset.get(e);
 }
 
-void World::removeRenderableAsset(EntityID e) { m_renderableAsset.erase(e); }
+void World::removeRenderableAsset(EntityID e) { m_renderableAsset.remove(e); }
 
-bool World::hasCamera(EntityID e) const { return m_cam.find(e) != m_cam.end(); }
+bool World::hasCamera(EntityID e) const { return m_cam.has(e); }
 
 CCamera &World::ensureCamera(EntityID e) {
-  auto it = m_cam.find(e);
-  if (it != m_cam.end())
-    return it->second;
+  if (CCamera *existing = m_cam.find(e))
+    return *existing;
 
-  m_cam[e] = CCamera{};
-  m_camMat[e] = CCameraMatrices{};
+  m_cam.set(e, CCamera{});
+  m_camMat.set(e, CCameraMatrices{});
   m_events.push({WorldEventType::CameraCreated, e});
 
   if (m_activeCamera == InvalidEntity)
     setActiveCamera(e);
-  return m_cam.at(e);
+  return m_cam.get(e);
 }
 
-CCamera &World::camera(EntityID e) { return m_cam.at(e); }
-const CCamera &World::camera(EntityID e) const { return m_cam.at(e); }
+CCamera &World::camera(EntityID e) { return m_cam.get(e); }
+const CCamera &World::camera(EntityID e) const { return m_cam.get(e); }
 
-CCameraMatrices &World::cameraMatrices(EntityID e) { return m_camMat.at(e); }
+CCameraMatrices &World::cameraMatrices(EntityID e) { return m_camMat.get(e); }
 const CCameraMatrices &World::cameraMatrices(EntityID e) const {
-  return m_camMat.at(e);
+  return m_camMat.get(e);
 }
 
 void World::removeCamera(EntityID e) {
-  auto it = m_cam.find(e);
-  if (it == m_cam.end())
+  if (!m_cam.remove(e))
     return;
-  m_cam.erase(it);
-  m_camMat.erase(e);
+  m_camMat.remove(e);
   m_events.push({WorldEventType::CameraDestroyed, e});
   if (m_activeCamera == e) {
     EntityID old = m_activeCamera;
@@ -105,15 +92,14 @@ void World::removeCamera(EntityID e) {
 }
 
 bool World::hasLight(EntityID e) const {
-  return m_light.find(e) != m_light.end();
+  return m_light.has(e);
 }
 
 CLight &World::ensureLight(EntityID e) {
-  auto it = m_light.find(e);
-  if (it != m_light.end())
-    return it->second;
+  if (CLight *existing = m_light.find(e))
+    return *existing;
 
-  m_light[e] = CLight{};
+  m_light.set(e, CLight{});
   if (!hasMesh(e)) {
     auto &mc = ensureMesh(e);
     if (mc.submeshes.empty())
@@ -121,33 +107,26 @@ CLight &World::ensureLight(EntityID e) {
     mc.submeshes[0].name = "Light";
     mc.submeshes[0].type = ProcMeshType::Sphere;
   }
-  return m_light.at(e);
+  return m_light.get(e);
 }
 
-CLight &World::light(EntityID e) { return m_light.at(e); }
-const CLight &World::light(EntityID e) const { return m_light.at(e); }
+CLight &World::light(EntityID e) { return m_light.get(e); }
+const CLight &World::light(EntityID e) const { return m_light.get(e); }
 
 void World::removeLight(EntityID e) {
-  auto it = m_light.find(e);
-  if (it == m_light.end())
+  if (!m_light.remove(e))
     return;
-  m_light.erase(it);
   m_events.push({WorldEventType::LightChanged, e});
 }
 
-bool World::hasSky(EntityID e) const { return m_sky.find(e) != m_sky.end(); }
+bool World::hasSky(EntityID e) const { return m_sky.has(e); }
 
 CSky &World::ensureSky(EntityID e) {
-  auto it = m_sky.find(e);
-  if (it != m_sky.end())
-    return it->second;
-
-  m_sky[e] = CSky{};
-  return m_sky.at(e);
+  return m_sky.ensure(e);
 }
 
-CSky &World::sky(EntityID e) { return m_sky.at(e); }
-const CSky &World::sky(EntityID e) const { return m_sky.at(e); }
+CSky &World::sky(EntityID e) { return m_sky.get(e); }
+const CSky &World::sky(EntityID e) const { return m_sky.get(e); }
 
 CSky &World::skySettings() { return m_skySettings; }
 const CSky &World::skySettings() const { return m_skySettings; }
@@ -170,12 +149,10 @@ void World::setActiveCamera(EntityID cam) {
   m_activeCamera = cam;
 
   if (m_activeCamera != InvalidEntity) {
-    auto it = m_cam.find(m_activeCamera);
-    if (it != m_cam.end())
-      it->second.dirty = true;
-    auto mit = m_camMat.find(m_activeCamera);
-    if (mit != m_camMat.end())
-      mit->second.dirty = true;
+    if (CCamera *cam = m_cam.find(m_activeCamera))
+      cam->dirty = true;
+    if (CCameraMatrices *mats = m_camMat.find(m_activeCamera))
+      mats->dirty = true;
   }
 
   m_events.push({WorldEventType::ActiveCameraChanged, cam, old});
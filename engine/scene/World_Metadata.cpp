@@ -17,12 +17,10 @@ void World::removeCategory(uint32_t idx) {
     return;
   const int32_t parent = m_categories[idx].parent;
   for (EntityID e : m_categories[idx].entities) {
-    auto it = m_entityCategories.find(e);
-    if (it != m_entityCategories.end()) {
-      auto &lst = it->second;
-      lst.erase(std::remove(lst.begin(), lst.end(), idx), lst.end());
-      if (lst.empty())
-        m_entityCategories.erase(it);
+    if (auto *lst = m_entityCategories.find(e)) {
+      lst->erase(std::remove(lst->begin(), lst->end(), idx), lst->end());
+      if (lst->empty())
+        m_entityCategories.remove(e);
     }
   }
 
@@ -41,8 +39,8 @@ void World::removeCategory(uint32_t idx) {
 
   m_categories.erase(m_categories.begin() + (ptrdiff_t)idx);
 
-  for (auto &kv : m_entityCategories) {
-    for (uint32_t &v : kv.second) {
+  for (auto &lst : m_entityCategories.values()) {
+    for (uint32_t &v : lst) {
       if (v > idx)
         v--;
     }
@@ -81,7 +79,7 @@ void World::addEntityCategory(EntityID e, int32_t idx) {
     changed = true;
   }
 
-  auto &lst = m_entityCategories[e];
+  auto &lst = m_entityCategories.ensure(e);
   if (std::find(lst.begin(), lst.end(), (uint32_t)idx) == lst.end()) {
     lst.push_back((uint32_t)idx);
     changed = true;
@@ -102,14 +100,13 @@ void World::removeEntityCategory(EntityID e, int32_t idx) {
   vec.erase(std::remove(vec.begin(), vec.end(), e), vec.end());
   changed = changed || (vec.size() != before);
 
-  auto it = m_entityCategories.find(e);
-  if (it != m_entityCategories.end()) {
-    auto &lst = it->second;
-    const size_t beforeLst = lst.size();
-    lst.erase(std::remove(lst.begin(), lst.end(), (uint32_t)idx), lst.end());
-    changed = changed || (lst.size() != beforeLst);
-    if (lst.empty())
-      m_entityCategories.erase(it);
+  if (auto *lst = m_entityCategories.find(e)) {
+    const size_t beforeLst = lst->size();
+    lst->erase(std::remove(lst->begin(), lst->end(), (uint32_t)idx),
+               lst->end());
+    changed = changed || (lst->size() != beforeLst);
+    if (lst->empty())
+      m_entityCategories.remove(e);
   }
 
   if (changed)
@@ -119,11 +116,11 @@ void World::removeEntityCategory(EntityID e, int32_t idx) {
 void World::clearEntityCategories(EntityID e) {
   if (e == InvalidEntity)
     return;
-  auto it = m_entityCategories.find(e);
-  if (it == m_entityCategories.end())
+  const auto *lst = m_entityCategories.find(e);
+  if (!lst)
     return;
   bool changed = false;
-  for (uint32_t idx : it->second) {
+  for (uint32_t idx : *lst) {
     if (idx < m_categories.size()) {
       auto &vec = m_categories[idx].entities;
       const size_t before = vec.size();
@@ -131,17 +128,14 @@ void World::clearEntityCategories(EntityID e) {
       changed = changed || (vec.size() != before);
     }
   }
-  m_entityCategories.erase(it);
+  m_entityCategories.remove(e);
   changed = true;
   if (changed)
     m_events.push({WorldEventType::CategoriesChanged, e});
 }
 
 const std::vector<uint32_t> *World::entityCategories(EntityID e) const {
-  auto it = m_entityCategories.find(e);
-  if (it == m_entityCategories.end())
-    return nullptr;
-  return &it->second;
+  return m_entityCategories.find(e);
 }
 
 void World::setCategoryParent(uint32_t idx, int32_t parentIdx) {
@@ -180,10 +174,8 @@ void World::setActiveCameraUUID(EntityUUID id) {
 }
 
 EntityUUID World::uuid(EntityID e) const {
-  auto it = m_uuid.find(e);
-  if (it == m_uuid.end())
-    return EntityUUID{0};
-  return it->second;
+  const EntityUUID *id = m_uuid.find(e);
+  return id ? *id : EntityUUID{0};
 }
 
 EntityID World::findByUUID(EntityUUID uuid) const {
@@ -9,26 +9,19 @@
 
 namespace Nyx {
 
-glm::mat4 World::localMatrix(EntityID e) const {
-  const auto &tr = m_tr.at(e);
-  glm::mat4 M(1.0f);
-  M = glm::translate(M, tr.translation);
-  M *= glm::toMat4(tr.rotation);
-  M = glm::scale(M, tr.scale);
-  return M;
-}
-
 void World::markWorldDirtyRecursive(EntityID e) {
   if (!isAlive(e))
     return;
 
-  m_wtr.at(e).dirty = true;
-
-  EntityID ch = m_hier.at(e).firstChild;
-  while (ch != InvalidEntity) {
-    EntityID next = m_hier.at(ch).nextSibling;
-    markWorldDirtyRecursive(ch);
-    ch = next;
+  m_dirtyScratch.clear();
+  m_dirtyScratch.push_back(e);
+  while (!m_dirtyScratch.empty()) {
+    const EntityID cur = m_dirtyScratch.back();
+    m_dirtyScratch.pop_back();
+    m_wtr.get(cur).dirty = true;
+    for (EntityID ch = m_hier.get(cur).firstChild; ch != InvalidEntity;
+         ch = m_hier.get(ch).nextSibling)
+      m_dirtyScratch.push_back(ch);
   }
 }
 
@@ -53,14 +46,14 @@ void World::setParentKeepWorld(EntityID child, EntityID newParent) {
   updateTransforms();
 
   const EntityID oldParent = parentOf(child);
-  const glm::mat4 oldWorld = m_wtr.at(child).world;
+  const glm::mat4 oldWorld = m_wtr.get(child).world;
 
   detachFromParent(child);
   attachToParent(child, newParent);
 
   glm::mat4 parentWorld(1.0f);
   if (newParent != InvalidEntity) {
-    parentWorld = m_wtr.at(newParent).world;
+    parentWorld = m_wtr.get(newParent).world;
   }
 
   const glm::mat4 newLocal = glm::inverse(parentWorld) * oldWorld;
@@ -72,7 +65,7 @@ void World::setParentKeepWorld(EntityID child, EntityID newParent) {
   glm::vec3 trans;
   glm::decompose(newLocal, scale, rot, trans, skew, persp);
 
-  auto &tr = m_tr.at(child);
+  auto &tr = m_tr.get(child);
   tr.translation = trans;
   tr.rotation = rot;
   tr.scale = scale;
@@ -90,10 +83,10 @@ EntityID World::cloneSubtree(EntityID root, EntityID newParent) {
 
   updateTransforms();
 
-  const glm::mat4 srcWorld = m_wtr.at(root).world;
+  const glm::mat4 srcWorld = m_wtr.get(root).world;
   glm::mat4 parentWorld(1.0f);
   if (newParent != InvalidEntity && isAlive(newParent))
-    parentWorld = m_wtr.at(newParent).world;
+    parentWorld = m_wtr.get(newParent).world;
 
   const glm::mat4 newLocal = glm::inverse(parentWorld) * srcWorld;
 
@@ -104,39 +97,41 @@ EntityID World::cloneSubtree(EntityID root, EntityID newParent) {
   glm::vec3 trans;
   glm::decompose(newLocal, scale, rot, trans, skew, persp);
 
-  EntityID dup = createEntity(m_name.at(root).name);
+  EntityID dup = createEntity(m_name.get(root).name);
 
-  auto &tr = m_tr.at(dup);
+  auto &tr = m_tr.get(dup);
   tr.translation = trans;
   tr.rotation = rot;
   tr.scale = scale;
   tr.dirty = true;
 
   if (newParent != InvalidEntity && isAlive(newParent)) {
+    detachFromParent(dup);
     attachToParent(dup, newParent);
     m_events.push({WorldEventType::ParentChanged, dup, newParent, InvalidEntity});
   }
 
+  // set() takes its value by copy, so growing the pool cannot invalidate it.
   if (hasMesh(root))
-    m_mesh[dup] = m_mesh.at(root);
+    m_mesh.set(dup, m_mesh.get(root));
   if (hasRenderableAsset(root))
-    m_renderableAsset[dup] = m_renderableAsset.at(root);
+    m_renderableAsset.set(dup, m_renderableAsset.get(root));
 
   if (hasCamera(root)) {
     auto &cam = ensureCamera(dup);
-    cam = m_cam.at(root);
+    cam = m_cam.get(root);
     cam.dirty = true;
 
-    auto &mats = m_camMat.at(dup);
-    mats = m_camMat.at(root);
+    auto &mats = m_camMat.get(dup);
+    mats = m_camMat.get(root);
     mats.dirty = true;
   }
 
   markWorldDirtyRecursive(dup);
 
-  EntityID ch = m_hier.at(root).firstChild;
+  EntityID ch = m_hier.get(root).firstChild;
   while (ch != InvalidEntity) {
-    EntityID next = m_hier.at(ch).nextSibling;
+    EntityID next = m_hier.get(ch).nextSibling;
     cloneSubtree(ch, dup);
     ch = next;
   }
@@ -178,77 +173,41 @@ EntityID World::duplicateSubtree(EntityID root, EntityID newParent,
   return dup;
 }
 
-CName &World::name(EntityID e) { return m_name.at(e); }
-const CName &World::name(EntityID e) const { return m_name.at(e); }
+CName &World::name(EntityID e) { return m_name.get(e); }
+const CName &World::name(EntityID e) const { return m_name.get(e); }
 
 void World::setName(EntityID e, const std::string &n) {
-  m_name.at(e).name = n;
+  m_name.get(e).name = n;
   m_events.push({WorldEventType::NameChanged, e});
 }
 
-CTransform &World::transform(EntityID e) { return m_tr.at(e); }
-const CTransform &World::transform(EntityID e) const { return m_tr.at(e); }
+CTransform &World::transform(EntityID e) { return m_tr.get(e); }
+const CTransform &World::transform(EntityID e) const { return m_tr.get(e); }
 
-CWorldTransform &World::worldTransform(EntityID e) { return m_wtr.at(e); }
+CWorldTransform &World::worldTransform(EntityID e) { return m_wtr.get(e); }
 const CWorldTransform &World::worldTransform(EntityID e) const {
-  return m_wtr.at(e);
+  return m_wtr.get(e);
 }
 
 glm::vec3 World::worldPosition(EntityID e) const {
   if (!isAlive(e))
     return glm::vec3(0.0f);
-  const auto it = m_wtr.find(e);
-  if (it == m_wtr.end())
+  const CWorldTransform *wt = m_wtr.find(e);
+  if (!wt)
     return glm::vec3(0.0f);
-  return glm::vec3(it->second.world[3]);
+  return glm::vec3(wt->world[3]);
 }
 
 glm::vec3 World::worldDirection(EntityID e, const glm::vec3 &localDir) const {
   if (!isAlive(e))
     return localDir;
-  const auto it = m_wtr.find(e);
-  if (it == m_wtr.end())
+  const CWorldTransform *wt = m_wtr.find(e);
+  if (!wt)
     return localDir;
-  glm::vec4 worldDir = it->second.world * glm::vec4(localDir, 0.0f);
+  glm::vec4 worldDir = wt->world * glm::vec4(localDir, 0.0f);
   return glm::normalize(glm::vec3(worldDir));
 }
 
-void World::updateTransforms() {
-  auto updateNode = [&](auto &&self, EntityID e, const glm::mat4 &parentW,
-                        bool parentDirty) -> void {
-    auto &tr = m_tr.at(e);
-    auto &wt = m_wtr.at(e);
-
-    bool parentChanged = false;
-    bool localChanged = false;
-    if (parentDirty)
-      wt.dirty = true;
-    if (tr.dirty) {
-      wt.dirty = true;
-      tr.dirty = false;
-      localChanged = true;
-    }
-
-    if (wt.dirty) {
-      wt.world = parentW * localMatrix(e);
-      wt.dirty = false;
-      parentChanged = true;
-    }
-
-    if (localChanged || parentDirty)
-      m_events.push({WorldEventType::TransformChanged, e});
-
-    EntityID ch = m_hier.at(e).firstChild;
-    while (ch != InvalidEntity) {
-      EntityID next = m_hier.at(ch).nextSibling;
-      self(self, ch, wt.world, parentChanged);
-      ch = next;
-    }
-  };
-
-  for (EntityID r : roots()) {
-    updateNode(updateNode, r, glm::mat4(1.0f), false);
-  }
-}
+void World::updateTransforms() { m_transformSystem.update(*this); }
 
 } // namespace Nyx
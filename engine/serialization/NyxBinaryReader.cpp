@@ -1,76 +1,116 @@
 #include "NyxBinaryReader.h"
 
+#include "NyxChunkCodec.h"
+
 namespace Nyx {
 
+static constexpr uint64_t kChunkHeaderSize = 16;
+static constexpr uint64_t kSceneHeaderSize = 12;
+static constexpr uint64_t kFooterSize = 32;
+static constexpr uint64_t kTocEntrySizeV1 = 24;
+static constexpr uint64_t kTocEntrySizeV2 = 44;
+
 NyxBinaryReader::NyxBinaryReader(const std::string &path) {
-  m_in.open(path, std::ios::binary);
-  m_ok = m_in.good();
+  m_ok = m_file.open(path);
 }
 
-NyxBinaryReader::~NyxBinaryReader() {
-  if (m_in.is_open())
-    m_in.close();
-}
+NyxBinaryReader::~NyxBinaryReader() { m_file.close(); }
 
-uint8_t NyxBinaryReader::readU8() {
-  uint8_t v;
-  m_in.read(reinterpret_cast<char *>(&v), sizeof(v));
-  return v;
-}
-uint32_t NyxBinaryReader::readU32() {
-  uint32_t v;
-  m_in.read(reinterpret_cast<char *>(&v), sizeof(v));
-  return v;
-}
-uint64_t NyxBinaryReader::readU64() {
-  uint64_t v;
-  m_in.read(reinterpret_cast<char *>(&v), sizeof(v));
-  return v;
+void NyxBinaryReader::readBytes(void *dst, size_t sz) {
+  const uint8_t *src = readView(sz);
+  if (src)
+    std::memcpy(dst, src, sz);
+  else
+    std::memset(dst, 0, sz);
 }
-float NyxBinaryReader::readF32() {
-  float v;
-  m_in.read(reinterpret_cast<char *>(&v), sizeof(v));
-  return v;
+
+const uint8_t *NyxBinaryReader::readView(uint64_t sz) {
+  if (sz > m_file.size() - m_pos) {
+    m_failed = true;
+    m_pos = m_file.size();
+    return nullptr;
+  }
+  const uint8_t *p = m_file.data() + m_pos;
+  m_pos += sz;
+  return p;
 }
 
-void NyxBinaryReader::readBytes(void *dst, size_t sz) {
-  m_in.read(reinterpret_cast<char *>(dst), sz);
+std::string_view NyxBinaryReader::readStringView() {
+  const uint32_t len = readU32();
+  const uint8_t *p = readView(len);
+  if (!p)
+    return {};
+  return {reinterpret_cast<const char *>(p), len};
 }
 
 void NyxBinaryReader::seek(uint64_t abs) {
-  m_in.seekg(static_cast<std::streamoff>(abs), std::ios::beg);
+  if (abs > m_file.size()) {
+    m_failed = true;
+    abs = m_file.size();
+  }
+  m_pos = abs;
 }
 
-uint64_t NyxBinaryReader::tell() const {
-  return static_cast<uint64_t>(m_in.tellg());
-}
+uint64_t NyxBinaryReader::tell() const { return m_pos; }
 
 bool NyxBinaryReader::readSceneHeader(uint64_t &magic, uint32_t &version) {
-  if (!m_ok)
+  if (!m_ok || m_file.size() < kSceneHeaderSize)
     return false;
+  seek(0);
   magic = readU64();
   version = readU32();
-  return true;
+  m_committedFooter = 0;
+  if (version >= NYXSCENE_COMMITTED_FOOTER_VERSION) {
+    seek(NYXSCENE_COMMITTED_FOOTER_OFFSET);
+    m_committedFooter = readU64();
+  }
+  return !m_failed;
 }
 
 bool NyxBinaryReader::readChunkHeader(uint32_t &fourcc, uint32_t &version,
                                       uint64_t &size) {
-  if (!m_in.good())
+  if (!m_ok || kChunkHeaderSize > m_file.size() - m_pos)
     return false;
 
   fourcc = readU32();
   version = readU32();
   size = readU64();
-  return true;
+  return size <= m_file.size() - m_pos;
 }
 
 bool NyxBinaryReader::loadTOC() {
-  m_in.seekg(0, std::ios::end);
-  const uint64_t fileSize = static_cast<uint64_t>(m_in.tellg());
-  if (fileSize < 32)
+  const uint64_t fileSize = m_file.size();
+  m_recoveredTOC = false;
+  if (!m_ok || fileSize < kSceneHeaderSize + kFooterSize)
     return false;
+  if (loadTOCAt(fileSize - kFooterSize))
+    return true;
+
+  // Appends sync their tail before pointing the header at it, so the
+  // committed footer is complete whatever happened after it.
+  if (m_committedFooter != 0 && m_committedFooter < fileSize - kFooterSize &&
+      loadTOCAt(m_committedFooter)) {
+    m_recoveredTOC = true;
+    return true;
+  }
+
+  // Older files: walk back to the previous footer; everything it lists was complete
+  // before the append that left the tail behind started.
+  const uint8_t *data = m_file.data();
+  for (uint64_t footer = fileSize - kFooterSize;
+       footer-- > kSceneHeaderSize;) {
+    uint64_t magic = 0;
+    std::memcpy(&magic, data + footer + kFooterSize - 8, sizeof(magic));
+    if (magic == NYX_TOC_FOOTER_MAGIC && loadTOCAt(footer)) {
+      m_recoveredTOC = true;
+      return true;
+    }
+  }
+  return false;
+}
 
-  seek(fileSize - 32);
+bool NyxBinaryReader::loadTOCAt(uint64_t footerOffset) {
+  seek(footerOffset);
 
   const uint32_t footerFourcc = readU32();
   const uint32_t tocVersion = readU32();
@@ -82,13 +122,22 @@ bool NyxBinaryReader::loadTOC() {
       footerMagic != NYX_TOC_FOOTER_MAGIC) {
     return false;
   }
-  (void)tocVersion;
+  if (tocVersion == 0 || tocVersion > NYX_TOC_VERSION)
+    return false;
+  m_tocVersion = tocVersion;
+  const uint64_t entrySize =
+      (tocVersion >= 2) ? kTocEntrySizeV2 : kTocEntrySizeV1;
 
-  if (tocPayloadOffset + tocPayloadSize > fileSize)
+  const uint64_t tocLimit = footerOffset;
+  if (tocPayloadOffset < kSceneHeaderSize || tocPayloadOffset > tocLimit ||
+      tocPayloadSize > tocLimit - tocPayloadOffset || tocPayloadSize < 4)
     return false;
 
   seek(tocPayloadOffset);
   const uint32_t count = readU32();
+  if (uint64_t(count) * entrySize > tocPayloadSize - 4)
+    return false;
+
   m_toc.clear();
   m_toc.reserve(count);
 
@@ -98,9 +147,41 @@ bool NyxBinaryReader::loadTOC() {
     e.version = readU32();
     e.offset = readU64();
     e.size = readU64();
+    if (tocVersion >= 2) {
+      e.codec = static_cast<NyxCodec>(readU8());
+      e.filterStride = readU8();
+      skip(2);
+      e.rawSize = readU64();
+      e.checksum = readU64();
+      // Unknown codec, or a raw size no LZ stream of this size can produce
+      // (guards the decode allocation against a damaged TOC).
+      if (e.codec > NyxCodec::ShuffleDeltaLZ ||
+          (e.codec != NyxCodec::None && e.rawSize / 255u > e.size + 1u))
+        return false;
+    } else {
+      e.rawSize = e.size;
+    }
     m_toc.push_back(e);
   }
 
+  // Every chunk must sit between the scene header and the TOC and start with
+  // a header that agrees with its entry; a bad offset fails the whole load
+  // rather than letting a chunk loader parse garbage.
+  for (const NyxTocEntry &e : m_toc) {
+    if (e.offset < kSceneHeaderSize || e.offset > tocPayloadOffset ||
+        kChunkHeaderSize > tocPayloadOffset - e.offset ||
+        e.size > tocPayloadOffset - e.offset - kChunkHeaderSize)
+      return false;
+
+    uint32_t fourcc = 0;
+    uint32_t version = 0;
+    uint64_t size = 0;
+    seek(e.offset);
+    if (!readChunkHeader(fourcc, version, size) || fourcc != e.fourcc ||
+        version != e.version || size != e.size)
+      return false;
+  }
+
   m_index.clear();
   for (size_t i = 0; i < m_toc.size(); ++i) {
     m_index[m_toc[i].fourcc].push_back(i);
@@ -126,8 +207,34 @@ std::vector<NyxTocEntry> NyxBinaryReader::findAll(uint32_t fourcc) const {
   return out;
 }
 
+bool NyxBinaryReader::openChunk(const NyxTocEntry &entry,
+                                std::vector<uint8_t> &storage,
+                                NyxChunkReader &out) const {
+  const uint8_t *stored = m_file.data() + entry.offset + kChunkHeaderSize;
+  if (m_tocVersion >= 2 &&
+      nyxChunkChecksum(stored, entry.size) != entry.checksum)
+    return false;
+
+  if (entry.codec == NyxCodec::None) {
+    if (entry.rawSize != entry.size)
+      return false;
+    out = NyxChunkReader(stored, entry.size, entry.version);
+    return true;
+  }
+
+  if (!nyxDecodeChunk(entry, stored, storage))
+    return false;
+  out = NyxChunkReader(storage.data(), storage.size(), entry.version);
+  return true;
+}
+
 void NyxBinaryReader::skip(uint64_t bytes) {
-  m_in.seekg(static_cast<std::streamoff>(bytes), std::ios::cur);
+  if (bytes > m_file.size() - m_pos) {
+    m_failed = true;
+    m_pos = m_file.size();
+    return;
+  }
+  m_pos += bytes;
 }
 
 } // namespace Nyx
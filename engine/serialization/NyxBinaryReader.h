@@ -1,43 +1,147 @@
 #pragma once
 
 #include "NyxChunkIDs.h"
+#include "io/MappedFile.h"
 #include <cstdint>
-#include <fstream>
+#include <cstring>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 namespace Nyx {
 
+// Read-only cursor over one chunk's payload. Independent cursors over the
+// same mapping can be used from different threads.
+class NyxChunkReader {
+public:
+  NyxChunkReader() = default;
+  NyxChunkReader(const uint8_t *data, uint64_t size, uint32_t version)
+      : m_data(data), m_size(size), m_version(version) {}
+
+  uint32_t version() const { return m_version; }
+  uint64_t size() const { return m_size; }
+  uint64_t tell() const { return m_pos; }
+  uint64_t remaining() const { return m_size - m_pos; }
+  bool failed() const { return m_failed; }
+
+  uint8_t readU8() { return readPod<uint8_t>(); }
+  uint32_t readU32() { return readPod<uint32_t>(); }
+  uint64_t readU64() { return readPod<uint64_t>(); }
+  float readF32() { return readPod<float>(); }
+
+  const uint8_t *readView(uint64_t sz) {
+    if (sz > m_size - m_pos) {
+      m_failed = true;
+      m_pos = m_size;
+      return nullptr;
+    }
+    const uint8_t *p = m_data + m_pos;
+    m_pos += sz;
+    return p;
+  }
+  std::string_view readStringView() {
+    const uint32_t len = readU32();
+    const uint8_t *p = readView(len);
+    if (!p)
+      return {};
+    return {reinterpret_cast<const char *>(p), len};
+  }
+  void skip(uint64_t bytes) { (void)readView(bytes); }
+
+private:
+  template <class T> T readPod() {
+    T v{};
+    if (const uint8_t *p = readView(sizeof(T)))
+      std::memcpy(&v, p, sizeof(T));
+    return v;
+  }
+
+  const uint8_t *m_data = nullptr;
+  uint64_t m_size = 0;
+  uint64_t m_pos = 0;
+  uint32_t m_version = 0;
+  bool m_failed = false;
+};
+
+// Cursor over a memory-mapped .nyxscene file. Reads copy straight out of the
+// mapping; readView()/readStringView() return pointers into it that stay
+// valid for the reader's lifetime. Reading past the end yields zeros and
+// latches failed() instead of touching memory outside the file.
 class NyxBinaryReader {
 public:
   explicit NyxBinaryReader(const std::string &path);
   ~NyxBinaryReader();
 
   bool ok() const { return m_ok; }
+  bool failed() const { return m_failed; }
+  bool isMapped() const { return m_file.isMapped(); }
 
-  uint8_t readU8();
-  uint32_t readU32();
-  uint64_t readU64();
-  float readF32();
+  uint8_t readU8() { return readPod<uint8_t>(); }
+  uint32_t readU32() { return readPod<uint32_t>(); }
+  uint64_t readU64() { return readPod<uint64_t>(); }
+  float readF32() { return readPod<float>(); }
   void readBytes(void *dst, size_t sz);
 
+  // Zero-copy access: returns a pointer to the next `sz` bytes and advances,
+  // or nullptr if they run past the end of the file.
+  const uint8_t *readView(uint64_t sz);
+  // u32 length followed by the bytes; empty on overrun.
+  std::string_view readStringView();
+
   void seek(uint64_t abs);
   uint64_t tell() const;
+  uint64_t fileSize() const { return m_file.size(); }
 
+  // Also picks up the committed footer offset of 3.1+ files.
   bool readSceneHeader(uint64_t &magic, uint32_t &version);
   bool readChunkHeader(uint32_t &fourcc, uint32_t &version, uint64_t &size);
 
+  // Reads the TOC through the footer and checks every entry against the file
+  // (in bounds, below the TOC, matching chunk header). False if any fails.
+  // If the footer at the end of the file is damaged (an interrupted append),
+  // the committed footer from the header is used instead; files without one
+  // are searched backwards for the last earlier footer that passes.
   bool loadTOC();
+  bool recoveredTOC() const { return m_recoveredTOC; }
+  // The header names a committed footer (3.1+), so appends can update it.
+  bool hasCommittedFooter() const { return m_committedFooter != 0; }
   std::optional<NyxTocEntry> findChunk(uint32_t fourcc) const;
   std::vector<NyxTocEntry> findAll(uint32_t fourcc) const;
+  // Cursor over an entry's decoded payload; the entry must come from
+  // loadTOC(). Verifies the checksum (TOC v2+) and, for compressed chunks,
+  // decodes into `storage`, which must outlive the cursor. Returns false on a
+  // checksum mismatch or undecodable payload. Safe to call concurrently.
+  bool openChunk(const NyxTocEntry &entry, std::vector<uint8_t> &storage,
+                 NyxChunkReader &out) const;
+  uint32_t tocVersion() const { return m_tocVersion; }
+  const std::vector<NyxTocEntry> &toc() const { return m_toc; }
 
   void skip(uint64_t bytes);
 
 private:
-  mutable std::ifstream m_in;
+  bool loadTOCAt(uint64_t footerOffset);
+
+  template <class T> T readPod() {
+    T v{};
+    if (sizeof(T) > m_file.size() - m_pos) {
+      m_failed = true;
+      m_pos = m_file.size();
+      return v;
+    }
+    std::memcpy(&v, m_file.data() + m_pos, sizeof(T));
+    m_pos += sizeof(T);
+    return v;
+  }
+
+  MappedFile m_file;
+  uint64_t m_pos = 0;
   bool m_ok = false;
+  bool m_failed = false;
+  bool m_recoveredTOC = false;
+  uint64_t m_committedFooter = 0;
+  uint32_t m_tocVersion = 0;
   std::vector<NyxTocEntry> m_toc;
   std::unordered_map<uint32_t, std::vector<size_t>> m_index;
 };
@@ -1,11 +1,29 @@
 #include "NyxBinaryWriter.h"
+
+#include "NyxChunkCodec.h"
+#include "core/Assert.h"
+
 #include <cstdint>
+#include <cstring>
 
 namespace Nyx {
 
-NyxBinaryWriter::NyxBinaryWriter(const std::string &path) {
-  m_out.open(path, std::ios::binary);
+NyxBinaryWriter::NyxBinaryWriter(const std::string &path, Mode mode)
+    : m_mode(mode) {
+  NYX_ASSERT(mode != Mode::Memory, "NyxBinaryWriter: file mode expected");
+  if (mode == Mode::Append) {
+    m_out.open(path, std::ios::binary | std::ios::in | std::ios::out);
+    m_out.seekp(0, std::ios::end);
+  } else {
+    m_out.open(path, std::ios::binary);
+  }
   m_ok = m_out.good();
+  if (m_ok)
+    m_startOffset = tell();
+}
+
+NyxBinaryWriter::NyxBinaryWriter(Mode mode) : m_mode(mode), m_ok(true) {
+  NYX_ASSERT(mode == Mode::Memory, "NyxBinaryWriter: memory mode expected");
 }
 
 NyxBinaryWriter::~NyxBinaryWriter() {
@@ -14,61 +32,107 @@ NyxBinaryWriter::~NyxBinaryWriter() {
 }
 
 uint64_t NyxBinaryWriter::tell() const {
+  if (m_mode == Mode::Memory)
+    return m_memory.size();
   return static_cast<uint64_t>(m_out.tellp());
 }
 
-void NyxBinaryWriter::writeU8(uint8_t v) {
-  m_out.write(reinterpret_cast<const char *>(&v), sizeof(v));
+void NyxBinaryWriter::flush() {
+  if (m_mode != Mode::Memory)
+    m_out.flush();
 }
-void NyxBinaryWriter::writeU32(uint32_t v) {
-  m_out.write(reinterpret_cast<const char *>(&v), sizeof(v));
-}
-void NyxBinaryWriter::writeU64(uint64_t v) {
-  m_out.write(reinterpret_cast<const char *>(&v), sizeof(v));
-}
-void NyxBinaryWriter::writeF32(float v) {
+
+void NyxBinaryWriter::patchU64(uint64_t offset, uint64_t v) {
+  NYX_ASSERT(!m_inChunk, "NyxBinaryWriter: patchU64 inside a chunk");
+  if (m_mode == Mode::Memory) {
+    NYX_ASSERT(offset + sizeof(v) <= m_memory.size(),
+               "NyxBinaryWriter: patchU64 past the end");
+    std::memcpy(m_memory.data() + offset, &v, sizeof(v));
+    return;
+  }
+  const std::streampos end = m_out.tellp();
+  m_out.seekp(static_cast<std::streamoff>(offset), std::ios::beg);
   m_out.write(reinterpret_cast<const char *>(&v), sizeof(v));
+  m_out.seekp(end);
 }
 
-void NyxBinaryWriter::writeBytes(const void *data, size_t sz) {
-  m_out.write(reinterpret_cast<const char *>(data), sz);
+void NyxBinaryWriter::emit(const void *data, size_t sz) {
+  if (m_inChunk) {
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    m_payload.insert(m_payload.end(), p, p + sz);
+  } else if (m_mode == Mode::Memory) {
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    m_memory.insert(m_memory.end(), p, p + sz);
+  } else {
+    m_out.write(reinterpret_cast<const char *>(data), sz);
+  }
 }
 
-void NyxBinaryWriter::beginChunk(uint32_t fourcc, uint32_t version) {
-  OpenChunk c{};
-  c.fourcc = fourcc;
-  c.version = version;
-  c.headerOffset = tell();
+void NyxBinaryWriter::writeU8(uint8_t v) { emit(&v, sizeof(v)); }
+void NyxBinaryWriter::writeU32(uint32_t v) { emit(&v, sizeof(v)); }
+void NyxBinaryWriter::writeU64(uint64_t v) { emit(&v, sizeof(v)); }
+void NyxBinaryWriter::writeF32(float v) { emit(&v, sizeof(v)); }
 
-  writeU32(fourcc);
-  writeU32(version);
-  writeU64(0);
+void NyxBinaryWriter::writeBytes(const void *data, size_t sz) {
+  if (sz)
+    emit(data, sz);
+}
 
-  c.payloadStart = tell();
-  m_chunkStack.push_back(c);
+void NyxBinaryWriter::beginChunk(uint32_t fourcc, uint32_t version,
+                                 NyxCodec codec, uint8_t filterStride) {
+  NYX_ASSERT(!m_inChunk, "NyxBinaryWriter: chunks do not nest");
+  m_chunk = {fourcc, version, codec, filterStride};
+  m_payload.clear();
+  m_inChunk = true;
 }
 
 void NyxBinaryWriter::endChunk() {
-  if (m_chunkStack.empty())
+  if (!m_inChunk)
     return;
+  m_inChunk = false;
+
+  NyxTocEntry e{};
+  e.fourcc = m_chunk.fourcc;
+  e.version = m_chunk.version;
+  e.offset = tell();
+  e.codec =
+      nyxEncodeChunk(m_chunk.codec, m_chunk.filterStride, m_payload, m_stored);
+  e.filterStride =
+      (e.codec == NyxCodec::ShuffleDeltaLZ) ? m_chunk.filterStride : 0;
+  e.size = m_stored.size();
+  e.rawSize = m_payload.size();
+  e.checksum = nyxChunkChecksum(m_stored.data(), m_stored.size());
+
+  const auto [first, last] = m_reusable.equal_range(e.checksum);
+  for (auto it = first; it != last; ++it) {
+    const NyxTocEntry &prev = it->second;
+    if (prev.fourcc == e.fourcc && prev.version == e.version &&
+        prev.codec == e.codec && prev.size == e.size &&
+        prev.rawSize == e.rawSize) {
+      m_toc.push_back(prev);
+      ++m_chunksReused;
+      return;
+    }
+  }
 
-  const OpenChunk c = m_chunkStack.back();
-  m_chunkStack.pop_back();
+  writeU32(e.fourcc);
+  writeU32(e.version);
+  writeU64(e.size);
+  writeBytes(m_stored.data(), m_stored.size());
+  m_toc.push_back(e);
+  ++m_chunksWritten;
+}
 
-  const uint64_t end = tell();
-  const uint64_t payloadSize = end - c.payloadStart;
-  const uint64_t sizePos = c.headerOffset + 8;
-  const auto cur = tell();
-  m_out.seekp(sizePos);
-  writeU64(payloadSize);
-  m_out.seekp(cur);
+void NyxBinaryWriter::setReusable(const std::vector<NyxTocEntry> &entries) {
+  m_reusable.clear();
+  for (const NyxTocEntry &e : entries)
+    m_reusable.emplace(e.checksum, e);
+}
 
-  NyxTocEntry e{};
-  e.fourcc = c.fourcc;
-  e.version = c.version;
-  e.offset = c.headerOffset;
-  e.size = payloadSize;
+void NyxBinaryWriter::keepChunk(const NyxTocEntry &e) {
+  NYX_ASSERT(!m_inChunk, "NyxBinaryWriter: keepChunk inside a chunk");
   m_toc.push_back(e);
+  ++m_chunksReused;
 }
 
 void NyxBinaryWriter::finalize() {
@@ -79,11 +143,17 @@ void NyxBinaryWriter::finalize() {
     writeU32(e.version);
     writeU64(e.offset);
     writeU64(e.size);
+    writeU8(static_cast<uint8_t>(e.codec));
+    writeU8(e.filterStride);
+    writeU8(0); // reserved
+    writeU8(0);
+    writeU64(e.rawSize);
+    writeU64(e.checksum);
   }
 
   const uint64_t tocPayloadSize = tell() - tocPayloadOffset;
   writeU32(static_cast<uint32_t>(NyxChunk::TOC));
-  writeU32(1); // toc footer version
+  writeU32(NYX_TOC_VERSION);
   writeU64(tocPayloadSize);
   writeU64(tocPayloadOffset);
   writeU64(NYX_TOC_FOOTER_MAGIC);
@@ -4,16 +4,26 @@
 #include <cstdint>
 #include <fstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace Nyx {
 
 class NyxBinaryWriter {
 public:
-  explicit NyxBinaryWriter(const std::string &path);
+  enum class Mode : uint8_t {
+    Truncate,
+    Append, // keep the existing bytes; new chunks and TOC go after them
+    Memory, // build the file in memory, see bytes()
+  };
+
+  explicit NyxBinaryWriter(const std::string &path,
+                           Mode mode = Mode::Truncate);
+  // Mode::Memory.
+  explicit NyxBinaryWriter(Mode mode);
   ~NyxBinaryWriter();
 
-  bool ok() const { return m_ok; }
+  bool ok() const { return m_ok && (m_mode == Mode::Memory || m_out.good()); }
 
   void writeU8(uint8_t v);
   void writeU32(uint32_t v);
@@ -21,25 +31,58 @@ public:
   void writeF32(float v);
   void writeBytes(const void *data, size_t sz);
 
-  void beginChunk(uint32_t fourcc, uint32_t version = 1);
+  // Chunk payloads are buffered until endChunk(), which encodes them with the
+  // requested codec (if that makes them smaller) and records the checksum in
+  // the TOC. Chunks do not nest.
+  void beginChunk(uint32_t fourcc, uint32_t version = 1,
+                  NyxCodec codec = NyxCodec::None, uint8_t filterStride = 0);
   void endChunk();
 
+  // Append mode: chunks already in the file. endChunk() references a
+  // matching one (same id, version and stored checksum) instead of writing
+  // the payload again.
+  void setReusable(const std::vector<NyxTocEntry> &entries);
+  // Lists an existing chunk in the TOC without touching its bytes.
+  void keepChunk(const NyxTocEntry &e);
+
   void finalize();
+  void flush();
+  // Overwrites 8 bytes already written at `offset` (not inside a chunk) and
+  // leaves the write position where it was.
+  void patchU64(uint64_t offset, uint64_t v);
   uint64_t tell() const;
 
+  const std::vector<uint8_t> &bytes() const { return m_memory; }
+
+  const std::vector<NyxTocEntry> &toc() const { return m_toc; }
+  uint64_t startOffset() const { return m_startOffset; }
+  uint32_t chunksWritten() const { return m_chunksWritten; }
+  uint32_t chunksReused() const { return m_chunksReused; }
+
 private:
+  void emit(const void *data, size_t sz);
+
   mutable std::ofstream m_out;
+  Mode m_mode = Mode::Truncate;
   bool m_ok = false;
+  std::vector<uint8_t> m_memory;
 
   struct OpenChunk {
     uint32_t fourcc = 0;
     uint32_t version = 1;
-    uint64_t headerOffset = 0;
-    uint64_t payloadStart = 0;
+    NyxCodec codec = NyxCodec::None;
+    uint8_t filterStride = 0;
   };
 
+  uint64_t m_startOffset = 0;
   std::vector<NyxTocEntry> m_toc;
-  std::vector<OpenChunk> m_chunkStack;
+  std::unordered_multimap<uint64_t, NyxTocEntry> m_reusable;
+  uint32_t m_chunksWritten = 0;
+  uint32_t m_chunksReused = 0;
+  bool m_inChunk = false;
+  OpenChunk m_chunk{};
+  std::vector<uint8_t> m_payload;
+  std::vector<uint8_t> m_stored;
 };
 
 } // namespace Nyx
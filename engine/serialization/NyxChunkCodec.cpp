@@ -0,0 +1,68 @@
+#include "NyxChunkCodec.h"
+
+#include "io/Compression.h"
+
+#include <blake3.h>
+#include <cstring>
+
+namespace Nyx {
+
+uint64_t nyxChunkChecksum(const uint8_t *data, size_t size) {
+  blake3_hasher hasher;
+  blake3_hasher_init(&hasher);
+  blake3_hasher_update(&hasher, data, size);
+  uint8_t out[8];
+  blake3_hasher_finalize(&hasher, out, sizeof(out));
+  uint64_t v = 0;
+  std::memcpy(&v, out, sizeof(v));
+  return v;
+}
+
+NyxCodec nyxEncodeChunk(NyxCodec codec, uint8_t filterStride,
+                        const std::vector<uint8_t> &raw,
+                        std::vector<uint8_t> &stored) {
+  stored.clear();
+  if (codec != NyxCodec::None && raw.size() >= kNyxMinCompressSize) {
+    if (codec == NyxCodec::ShuffleDeltaLZ) {
+      std::vector<uint8_t> filtered;
+      Compression::shuffleDeltaEncode(raw.data(), raw.size(), filterStride,
+                                      filtered);
+      Compression::lzCompress(filtered.data(), filtered.size(), stored);
+    } else {
+      Compression::lzCompress(raw.data(), raw.size(), stored);
+    }
+    if (stored.size() < raw.size())
+      return codec;
+  }
+
+  stored = raw;
+  return NyxCodec::None;
+}
+
+bool nyxDecodeChunk(const NyxTocEntry &entry, const uint8_t *stored,
+                    std::vector<uint8_t> &raw) {
+  raw.resize(entry.rawSize);
+  switch (entry.codec) {
+  case NyxCodec::None:
+    if (entry.rawSize != entry.size)
+      return false;
+    if (entry.size)
+      std::memcpy(raw.data(), stored, entry.size);
+    return true;
+  case NyxCodec::LZ:
+    return Compression::lzDecompress(stored, entry.size, raw.data(),
+                                     raw.size());
+  case NyxCodec::ShuffleDeltaLZ: {
+    std::vector<uint8_t> filtered(entry.rawSize);
+    if (!Compression::lzDecompress(stored, entry.size, filtered.data(),
+                                   filtered.size()))
+      return false;
+    Compression::shuffleDeltaDecode(filtered.data(), filtered.size(),
+                                    entry.filterStride, raw.data());
+    return true;
+  }
+  }
+  return false;
+}
+
+} // namespace Nyx
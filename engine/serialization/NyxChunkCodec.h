@@ -0,0 +1,27 @@
+#pragma once
+
+#include "NyxChunkIDs.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nyx {
+
+// Payloads smaller than this are always stored raw.
+constexpr size_t kNyxMinCompressSize = 256;
+
+// First 8 bytes of the blake3 hash of `data`.
+uint64_t nyxChunkChecksum(const uint8_t *data, size_t size);
+
+// Encodes raw into stored with the requested codec. Falls back to storing the
+// raw bytes (and returns NyxCodec::None) when that would not be smaller.
+NyxCodec nyxEncodeChunk(NyxCodec codec, uint8_t filterStride,
+                        const std::vector<uint8_t> &raw,
+                        std::vector<uint8_t> &stored);
+
+// Decodes a stored payload described by entry into raw (entry.rawSize bytes).
+bool nyxDecodeChunk(const NyxTocEntry &entry, const uint8_t *stored,
+                    std::vector<uint8_t> &raw);
+
+} // namespace Nyx
@@ -23,15 +23,39 @@ enum class NyxChunk : uint32_t {
   TOC = FOURCC('T', 'O', 'C', ' '),  // chunk directory footer
 };
 
+// How a chunk payload is stored on disk.
+enum class NyxCodec : uint8_t {
+  None = 0,
+  LZ = 1,             // Compression::lzCompress
+  ShuffleDeltaLZ = 2, // Compression::shuffleDeltaEncode, then LZ
+};
+
 struct NyxTocEntry final {
   uint32_t fourcc = 0;
   uint32_t version = 1;
   uint64_t offset = 0; // absolute file offset to chunk header
-  uint64_t size = 0;   // payload size, excluding 16-byte header
+  uint64_t size = 0;   // stored payload size, excluding 16-byte header
+
+  // TOC v2+ (scene 2.0). v1 TOCs load as uncompressed and unchecked.
+  NyxCodec codec = NyxCodec::None;
+  uint8_t filterStride = 0; // record size in words for ShuffleDeltaLZ
+  uint64_t rawSize = 0;     // decoded payload size
+  uint64_t checksum = 0;    // blake3 of the stored payload, first 8 bytes
 };
 
 constexpr uint64_t NYXSCENE_MAGIC = 0x004E595853434E31ull;       // "\0NYXSCN1"
-constexpr uint32_t NYXSCENE_VERSION = 0x00010001u;               // 1.1
+// 2.0: TOC v2 with per-chunk codec and checksum. Readers reject other majors,
+// so 1.x builds refuse these files instead of misreading compressed chunks.
+// 3.0: STRS, ENTS, TRNS and MESH split into pages, and incremental saves that
+// append chunks plus a new TOC; only the last footer is live.
+// 3.1: the header is followed by the offset of the last footer known to be
+// on disk, so a torn append recovers without scanning the file.
+constexpr uint32_t NYXSCENE_VERSION = 0x00030001u;               // 3.1
+constexpr uint32_t NYXSCENE_MIN_READ_VERSION = 0x00010000u;      // 1.0
+constexpr uint32_t NYXSCENE_COMMITTED_FOOTER_VERSION = 0x00030001u;
+constexpr uint64_t NYXSCENE_COMMITTED_FOOTER_OFFSET = 12;        // u64
+constexpr uint32_t NYX_TOC_VERSION = 2;
+constexpr uint64_t NYX_TOC_FOOTER_SIZE = 32;
 constexpr uint64_t NYX_TOC_FOOTER_MAGIC = 0x4F46434F5458594Eull; // "NYXTOCFO"
 
 } // namespace Nyx
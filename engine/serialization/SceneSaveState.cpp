@@ -0,0 +1,188 @@
+#include "SceneSaveState.h"
+
+#include "NyxChunkCodec.h"
+#include "NyxChunkIDs.h"
+#include "SceneSerializer_ChunkIO.h"
+#include "scene/WorldEvents.h"
+
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+namespace Nyx {
+
+namespace {
+
+constexpr uint64_t kTocFooterBytes = 32u;
+
+// Hash of the last footer and the TOC payload it points at. Every save,
+// ours or anyone else's, rewrites both; 0 when there is no valid footer at
+// the end of the file (a torn append).
+uint64_t hashLiveToc(const std::string &path, uint64_t fileBytes) {
+  if (fileBytes < kTocFooterBytes)
+    return 0;
+  std::ifstream in(path, std::ios::binary);
+  uint8_t footer[kTocFooterBytes];
+  in.seekg(std::streamoff(fileBytes - kTocFooterBytes), std::ios::beg);
+  if (!in.read(reinterpret_cast<char *>(footer), sizeof(footer)))
+    return 0;
+
+  uint32_t fourcc = 0;
+  uint64_t tocSize = 0;
+  uint64_t tocOffset = 0;
+  uint64_t magic = 0;
+  std::memcpy(&fourcc, footer, sizeof(fourcc));
+  std::memcpy(&tocSize, footer + 8, sizeof(tocSize));
+  std::memcpy(&tocOffset, footer + 16, sizeof(tocOffset));
+  std::memcpy(&magic, footer + 24, sizeof(magic));
+  const uint64_t footerOffset = fileBytes - kTocFooterBytes;
+  if (fourcc != static_cast<uint32_t>(NyxChunk::TOC) ||
+      magic != NYX_TOC_FOOTER_MAGIC || tocOffset > footerOffset ||
+      tocSize != footerOffset - tocOffset)
+    return 0;
+
+  std::vector<uint8_t> bytes(tocSize + kTocFooterBytes);
+  in.seekg(std::streamoff(tocOffset), std::ios::beg);
+  if (!in.read(reinterpret_cast<char *>(bytes.data()),
+               std::streamsize(bytes.size())))
+    return 0;
+  const uint64_t h = nyxChunkChecksum(bytes.data(), bytes.size());
+  return h != 0 ? h : 1u;
+}
+
+} // namespace
+
+void SceneSaveState::observe(const WorldEvents &events) {
+  if (reordering) {
+    deferred.insert(deferred.end(), events.events().begin(),
+                    events.events().end());
+    return;
+  }
+  for (const WorldEvent &ev : events.events())
+    apply(ev);
+}
+
+void SceneSaveState::replayDeferred() {
+  std::vector<WorldEvent> events = std::move(deferred);
+  deferred = {};
+  reordering = false;
+  for (const WorldEvent &ev : events)
+    apply(ev);
+}
+
+void SceneSaveState::apply(const WorldEvent &ev) {
+  switch (ev.type) {
+  case WorldEventType::EntityCreated:
+    appendEntity(ev.a);
+    break;
+  case WorldEventType::EntityDestroyed:
+    removeEntity(ev.a);
+    break;
+  case WorldEventType::ParentChanged:
+  case WorldEventType::NameChanged:
+  case WorldEventType::CameraCreated:
+  case WorldEventType::CameraDestroyed:
+    markEntityDirty(ev.a, PageEntities);
+    break;
+  case WorldEventType::TransformChanged:
+    markEntityDirty(ev.a, PageTransforms);
+    break;
+  case WorldEventType::MeshChanged:
+    markEntityDirty(ev.a, PageEntities | PageMeshes);
+    break;
+  case WorldEventType::LightChanged:
+    markEntityDirty(ev.a, PageEntities);
+    dirty |= DirtyLights;
+    break;
+  case WorldEventType::SkyChanged:
+    dirty |= DirtySky;
+    break;
+  case WorldEventType::CategoriesChanged:
+    dirty |= DirtyCategories;
+    break;
+  default:
+    break;
+  }
+}
+
+void SceneSaveState::markEntityDirty(EntityID e, uint8_t pageBits) {
+  const uint32_t idx = indexOf(e);
+  if (idx == detail::sceneio::kInvalidIndex)
+    return; // not in the file yet; its EntityCreated covers it
+  const uint32_t page = idx / detail::sceneio::kEntityPageSize;
+  if (page < dirtyPages.size())
+    dirtyPages[page] |= pageBits;
+}
+
+void SceneSaveState::appendEntity(EntityID e) {
+  if (dirty & DirtyStructure)
+    return; // the next save re-collects everything anyway
+  const uint32_t known = indexOf(e);
+  if (known != detail::sceneio::kInvalidIndex && entities[known].e == e)
+    return; // already in the file (a load's own creation events)
+
+  const uint32_t idx = static_cast<uint32_t>(entities.size());
+  entities.push_back({e, EntityUUID{}});
+  if (e.index >= entityIndexByRaw.size())
+    entityIndexByRaw.resize(e.index + 1u, detail::sceneio::kInvalidIndex);
+  entityIndexByRaw[e.index] = idx;
+  const uint32_t page = idx / detail::sceneio::kEntityPageSize;
+  if (page >= dirtyPages.size())
+    dirtyPages.resize(page + 1u, 0u);
+  dirtyPages[page] |= PageEntities | PageTransforms | PageMeshes;
+}
+
+void SceneSaveState::removeEntity(EntityID e) {
+  if (dirty & DirtyStructure)
+    return;
+  const uint32_t idx = indexOf(e);
+  if (idx == detail::sceneio::kInvalidIndex || entities[idx].e != e)
+    return;
+
+  // Loading skips every chunk's rows for a tombstone, so its TRNS and MESH
+  // rows can stay as they are.
+  markEntityDirty(e, PageEntities);
+  entities[idx] = detail::sceneio::EntityRecord{};
+  entityIndexByRaw[e.index] = detail::sceneio::kInvalidIndex;
+  ++tombstones;
+  // LITE and CATS may still list the index; both are small, and the checksum
+  // drops them again if the entity was in neither.
+  dirty |= DirtyLights | DirtyCategories;
+}
+
+void SceneSaveState::reset() { *this = SceneSaveState{}; }
+
+void SceneSaveState::updateLiveBytes() {
+  constexpr uint64_t kSceneHeader = 8u + 4u + 8u;
+  constexpr uint64_t kChunkHeader = 16u;
+  constexpr uint64_t kTocEntry = 44u;
+  constexpr uint64_t kTocFooter = 4u + 4u + 8u + 8u + 8u;
+
+  liveBytes = kSceneHeader + 4u + kTocEntry * toc.size() + kTocFooter;
+  for (const NyxTocEntry &e : toc)
+    liveBytes += kChunkHeader + e.size;
+}
+
+bool SceneSaveState::matchesFile(const std::string &p) const {
+  if (path.empty() || p != path || toc.empty() || tocHash == 0)
+    return false;
+  std::error_code ec;
+  const uint64_t size = std::filesystem::file_size(p, ec);
+  if (ec || size != fileBytes)
+    return false;
+  const auto time = std::filesystem::last_write_time(p, ec);
+  if (ec || time != fileTime)
+    return false;
+  // Catches a same-size rewrite within the file system's timestamp
+  // resolution.
+  return hashLiveToc(p, size) == tocHash;
+}
+
+void SceneSaveState::stampFile() {
+  std::error_code ec;
+  fileTime = std::filesystem::last_write_time(path, ec);
+  tocHash = ec ? 0 : hashLiveToc(path, fileBytes);
+}
+
+} // namespace Nyx
@@ -0,0 +1,275 @@
+#pragma once
+
+#include "NyxChunkIDs.h"
+#include "material/MaterialHandle.h"
+#include "scene/Camera.h"
+#include "scene/Components.h"
+#include "scene/EntityID.h"
+#include "scene/EntityUUID.h"
+#include "scene/WorldEvents.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Nyx {
+
+namespace detail::sceneio {
+
+constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+struct EntityRecord {
+  EntityID e = InvalidEntity;
+  EntityUUID uuid{};
+};
+
+struct MaterialRefEntry {
+  std::string assetPath;
+  MaterialHandle legacyHandle = InvalidMaterial;
+};
+
+// Lets the intern maps look up a string_view without building a key.
+struct StringKeyHash {
+  using is_transparent = void;
+  size_t operator()(std::string_view s) const {
+    return std::hash<std::string_view>{}(s);
+  }
+};
+
+template <class V>
+using StringKeyMap =
+    std::unordered_map<std::string, V, StringKeyHash, std::equal_to<>>;
+
+} // namespace detail::sceneio
+
+// The string and material-ref tables chunks index into. They only grow
+// between full saves, so indices held by chunks that were not rewritten stay
+// valid; the saved* counts say how much of each is already in the file.
+struct SceneSaveTables final {
+  std::vector<std::string> strings;
+  detail::sceneio::StringKeyMap<uint32_t> stringMap;
+  std::vector<detail::sceneio::MaterialRefEntry> materialRefs;
+  detail::sceneio::StringKeyMap<uint32_t> materialRefMap;
+  uint32_t savedStringCount = 0;
+  uint32_t savedMaterialRefCount = 0;
+};
+
+// What SceneSerializer needs to append a delta to the .nyxscene it last
+// loaded or wrote instead of rewriting it.
+//
+// World events mark chunk categories, or single entity pages of the paged
+// ENTS/TRNS/MESH chunks, dirty. Entities created since the last full save are
+// appended after the file's last index and destroyed ones leave a tombstone
+// (a record with no UUID) in place, so neither shifts the indices held by
+// pages that did not change.
+// Events are cleared every frame, so observe() has to see them first. While a
+// structure save is in flight the entity order belongs to its snapshot (the
+// writer sorts it), so events are held back until finishSceneSave(). A save
+// re-encodes only dirty chunks and writes those whose checksum matches no
+// chunk already in the file; everything else is referenced from the previous
+// TOC.
+struct SceneSaveState final {
+  enum DirtyBits : uint32_t {
+    DirtyStructure = 1u << 0, // re-sort entities and redo every page
+    DirtyLights = 1u << 1,
+    DirtySky = 1u << 2,
+    DirtyCategories = 1u << 3,
+    DirtyMeshes = 1u << 4, // every MESH page; unchanged ones dedupe away
+    DirtyAll = 0xFFFFFFFFu,
+  };
+  // Per entity page, in dirtyPages.
+  enum PageBits : uint8_t {
+    PageEntities = 1u << 0, // names, parents, component flags
+    PageTransforms = 1u << 1,
+    PageMeshes = 1u << 2,
+  };
+
+  // Full rewrite once dead bytes outweigh live ones or after this many
+  // appends, whichever comes first.
+  static constexpr uint32_t kMaxAppends = 64;
+
+  void observe(const WorldEvents &events);
+  void markAllDirty() { dirty = DirtyAll; }
+  // Material handles written without a MeshChanged event.
+  void markMeshesDirty() { dirty |= DirtyMeshes; }
+  void markEntityDirty(EntityID e, uint8_t pageBits);
+  // appendEntity() gives `e` the index after the last one; removeEntity()
+  // turns its record into a tombstone.
+  void appendEntity(EntityID e);
+  void removeEntity(EntityID e);
+  void reset();
+  // Replays what observe() held back while `reordering`.
+  void replayDeferred();
+  // Recomputes liveBytes from `toc`.
+  void updateLiveBytes();
+
+  // True when `path` is the file this state describes and it has not been
+  // touched behind our back: same size, modification time and live TOC.
+  bool matchesFile(const std::string &path) const;
+  // Records fileTime and tocHash for the file at `path` as it is now;
+  // called once the state describes it.
+  void stampFile();
+  bool wantsCompaction() const {
+    return appendCount >= kMaxAppends || fileBytes > liveBytes * 2u ||
+           tombstones * 2u > entities.size();
+  }
+
+  std::string path;
+  uint64_t fileBytes = 0;
+  std::filesystem::file_time_type fileTime{};
+  uint64_t tocHash = 0; // footer plus the TOC it points at; 0: unreadable
+  uint64_t liveBytes = 0; // header + referenced chunks + current TOC
+  uint32_t appendCount = 0;
+
+  uint32_t dirty = DirtyAll;
+  std::vector<uint8_t> dirtyPages;
+
+  // Entity order and the tables chunks index into, as of the last save plus
+  // the entities appended since. While a save is being written its snapshot
+  // holds the tables.
+  std::vector<detail::sceneio::EntityRecord> entities; // tombstone: e invalid
+  // By EntityID::index; kInvalidIndex for entities not in `entities`.
+  std::vector<uint32_t> entityIndexByRaw;
+  uint32_t tombstones = 0;
+  SceneSaveTables tables;
+
+  // A structure save is in flight; observe() queues into `deferred`.
+  bool reordering = false;
+  std::vector<WorldEvent> deferred;
+
+  std::vector<NyxTocEntry> toc;
+  std::vector<NyxTocEntry> entityPages;
+  std::vector<NyxTocEntry> transformPages;
+  std::vector<NyxTocEntry> meshPages;
+
+  // Last save, for the editor's stats.
+  bool lastIncremental = false;
+  uint64_t lastBytesWritten = 0;
+  uint32_t lastChunksWritten = 0;
+  uint32_t lastChunksReused = 0;
+
+private:
+  void apply(const WorldEvent &ev);
+  uint32_t indexOf(EntityID e) const {
+    return e.index < entityIndexByRaw.size() ? entityIndexByRaw[e.index]
+                                             : detail::sceneio::kInvalidIndex;
+  }
+};
+
+// World data a save re-encodes, copied out on the saving thread. Only the
+// pages and chunks the dirty flags select are captured; the rest is
+// referenced from the previous TOC. Entity references are indices into
+// SceneSaveState::entities, or into SceneSaveSnapshot::entities while
+// `sortEntities` is set. Rows are fixed-size; names and paths go into one
+// `text` buffer and are interned by the writer.
+struct SceneCapture final {
+  struct Text {
+    uint32_t offset = 0;
+    uint32_t size = 0;
+  };
+  struct EntityRow {
+    EntityUUID uuid{};
+    Text name;
+    uint32_t parent = detail::sceneio::kInvalidIndex;
+    uint32_t flags = 0; // bit 0 mesh, 1 light, 2 camera
+  };
+  struct EntityPage {
+    uint32_t page = 0;
+    std::vector<EntityRow> rows;
+  };
+  struct TransformPage {
+    uint32_t page = 0;
+    std::vector<CTransform> transforms;
+  };
+  struct SubmeshRow {
+    Text name;
+    Text materialAssetPath;
+    MaterialHandle material = InvalidMaterial;
+    ProcMeshType type = ProcMeshType::Cube;
+  };
+  struct MeshRow {
+    uint32_t entity = 0;
+    uint32_t firstSubmesh = 0; // into the page's submeshes
+    uint32_t submeshCount = 0;
+  };
+  struct MeshPage {
+    uint32_t page = 0;
+    uint32_t count = 0; // entities in the page
+    std::vector<MeshRow> meshes;
+    std::vector<SubmeshRow> submeshes;
+  };
+  struct CameraRow {
+    uint32_t entity = 0;
+    CCamera camera;
+  };
+  struct LightRow {
+    uint32_t entity = 0;
+    CLight light;
+  };
+  struct CategoryRow {
+    std::string name;
+    int32_t parent = -1;
+    std::vector<uint32_t> members;
+  };
+
+  Text addText(std::string_view s) {
+    const Text t{static_cast<uint32_t>(text.size()),
+                 static_cast<uint32_t>(s.size())};
+    text.append(s);
+    return t;
+  }
+  std::string_view str(Text t) const {
+    return std::string_view(text).substr(t.offset, t.size);
+  }
+
+  // Entities were captured in World order; the writer sorts them by UUID
+  // (and every index above with them) before encoding.
+  bool sortEntities = false;
+  uint32_t pageCount = 0;
+  // Ascending by page; pages not listed are kept.
+  std::vector<EntityPage> entityPages;
+  std::vector<TransformPage> transformPages;
+  std::vector<MeshPage> meshPages;
+  std::string text;
+
+  std::vector<CameraRow> cameras; // always captured, see captureChunks()
+  uint32_t activeCamera = detail::sceneio::kInvalidIndex;
+  bool hasLights = false;
+  std::vector<LightRow> lights;
+  bool hasSky = false;
+  CSky sky;
+  bool hasCategories = false;
+  std::vector<CategoryRow> categories;
+};
+
+// One save split at the point where it stops reading World. Capturing copies
+// the dirty parts of World; encoding and writing need only the snapshot, so
+// that part can run on any thread while the main thread keeps editing.
+struct SceneSaveSnapshot final {
+  std::string path;
+  bool incremental = false;
+  uint64_t previousSize = 0;         // incremental: what to truncate back to
+  std::vector<NyxTocEntry> reusable; // incremental: the file's current TOC
+  SceneCapture capture;
+  SceneSaveTables tables; // moved out of the state until the save finishes
+  // capture.sortEntities: the entity order, moved out of the state and
+  // sorted by the writer, with its index.
+  std::vector<detail::sceneio::EntityRecord> entities;
+  std::vector<uint32_t> entityIndexByRaw;
+  double captureMs = 0.0;
+
+  // Outcome of the write.
+  bool written = false;
+  std::vector<NyxTocEntry> toc;
+  uint64_t fileBytes = 0;
+  uint64_t bytesWritten = 0;
+  uint32_t chunksWritten = 0;
+  uint32_t chunksReused = 0;
+  double writeMs = 0.0;
+};
+
+} // namespace Nyx
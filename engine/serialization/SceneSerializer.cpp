@@ -1,5 +1,6 @@
 #include "SceneSerializer.h"
 
+#include "SceneSaveState.h"
 #include "SceneSerializer_Impl.h"
 
 namespace Nyx {
@@ -12,4 +13,28 @@ bool SceneSerializer::load(const std::string &path, World &world) {
   return detail::loadSceneBinary(path, world);
 }
 
+bool SceneSerializer::save(const std::string &path, World &world,
+                           SceneSaveState &state) {
+  return detail::saveSceneBinary(path, world, state);
+}
+
+bool SceneSerializer::load(const std::string &path, World &world,
+                           SceneSaveState &state) {
+  return detail::loadSceneBinary(path, world, &state);
+}
+
+void SceneSerializer::capture(const std::string &path, World &world,
+                              SceneSaveState &state, SceneSaveSnapshot &out) {
+  detail::captureSceneBinary(path, world, state, out);
+}
+
+bool SceneSerializer::write(SceneSaveSnapshot &snapshot) {
+  return detail::writeSceneBinary(snapshot);
+}
+
+void SceneSerializer::finish(SceneSaveState &state,
+                             SceneSaveSnapshot &snapshot) {
+  detail::finishSceneSave(state, snapshot);
+}
+
 } // namespace Nyx
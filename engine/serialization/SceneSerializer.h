@@ -5,11 +5,31 @@
 namespace Nyx {
 
 class World;
+struct SceneSaveState;
+struct SceneSaveSnapshot;
 
 class SceneSerializer {
 public:
   static bool save(const std::string &path, World &world);
   static bool load(const std::string &path, World &world);
+
+  // Incremental variants: load() seeds `state` from the file, and save()
+  // appends only what changed since (see SceneSaveState), falling back to a
+  // full rewrite for a different path, an outdated layout, or when the file
+  // is due for compaction.
+  static bool save(const std::string &path, World &world,
+                   SceneSaveState &state);
+  static bool load(const std::string &path, World &world,
+                   SceneSaveState &state);
+
+  // save() split so the expensive part can leave the main thread: capture()
+  // records the chunk inputs from `world`, write() encodes and writes them
+  // from any thread, and finish() folds the outcome back into `state`.
+  // `state` must not be captured again before finish() ran.
+  static void capture(const std::string &path, World &world,
+                      SceneSaveState &state, SceneSaveSnapshot &out);
+  static bool write(SceneSaveSnapshot &snapshot);
+  static void finish(SceneSaveState &state, SceneSaveSnapshot &snapshot);
 };
 
 } // namespace Nyx
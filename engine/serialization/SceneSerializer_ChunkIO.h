@@ -2,12 +2,15 @@
 
 #include "NyxBinaryReader.h"
 #include "NyxBinaryWriter.h"
+#include "SceneSaveState.h"
+#include "scene/Camera.h"
 #include "scene/Components.h"
 #include "scene/EntityID.h"
 #include "scene/EntityUUID.h"
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -17,93 +20,224 @@ class World;
 
 namespace detail::sceneio {
 
-constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
-
-struct EntityRecord {
-  EntityID e = InvalidEntity;
-  EntityUUID uuid{};
+// Chunk versions the savers write. Loading a file whose chunks all match
+// these seeds SceneSaveState, so the first save after opening can already be
+// incremental.
+constexpr uint32_t kStringsVersion = 2;
+constexpr uint32_t kEntitiesVersion = 3; // v3: UUID 0 marks a free slot
+constexpr uint32_t kTransformsVersion = 4;
+constexpr uint32_t kMaterialRefsVersion = 2;
+constexpr uint32_t kMeshesVersion = 3;
+constexpr uint32_t kCamerasVersion = 3;
+constexpr uint32_t kLightsVersion = 2;
+constexpr uint32_t kSkyVersion = 2;
+constexpr uint32_t kCategoriesVersion = 1;
+
+// From these versions on, STRS/ENTS/TRNS/MESH are split into pages: several
+// chunks of the same id, each starting with `u32 first, u32 count` (the
+// string-id or entity-index range it covers) followed by the previous
+// version's body for that range. Record indices inside stay absolute.
+constexpr uint32_t kStringsPagedVersion = 2;
+constexpr uint32_t kEntitiesPagedVersion = 2;
+constexpr uint32_t kTransformsPagedVersion = 4;
+constexpr uint32_t kMeshesPagedVersion = 3;
+
+// Entities per ENTS/TRNS/MESH page. Small enough that editing one entity
+// rewrites a few KB, large enough that the TOC stays short for 100k+ entity
+// scenes. String pages are only ever appended, so they are sized by what a
+// save happened to add (up to kStringPageSize).
+constexpr uint32_t kEntityPageSize = 1024;
+constexpr uint32_t kStringPageSize = 4096;
+
+// ------------------------------
+// Save: capture -> encode
+// ------------------------------
+// capture*() copy what a chunk needs out of World into SceneCapture (the
+// only part that reads World). save*() encode captured data and intern
+// strings and material refs into the tables as they go, so STRS and MATL are
+// written after everything that references them.
+
+// Live entities with a UUID, in World order.
+void collectEntities(World &world, std::vector<EntityRecord> &out);
+// Fills `byRaw` (by EntityID::index) and returns the tombstone count.
+uint32_t indexEntities(const std::vector<EntityRecord> &entities,
+                       std::vector<uint32_t> &byRaw);
+void indexEntities(SceneSaveState &state);
+// For a capture with sortEntities: orders snap.entities by UUID and remaps
+// every captured row to the new indices. Runs with the write, off the main
+// thread.
+void sortCapture(SceneSaveSnapshot &snap);
+std::string makeMaterialRefKey(std::string_view assetPath,
+                               MaterialHandle legacyHandle);
+
+// Entities [page * kEntityPageSize, ...).
+void captureEntityPage(World &world, const SceneSaveState &state,
+                       uint32_t page, SceneCapture &capture,
+                       SceneCapture::EntityPage &out);
+void captureTransformPage(World &world, const SceneSaveState &state,
+                          uint32_t page, SceneCapture::TransformPage &out);
+void captureMeshPage(World &world, const SceneSaveState &state, uint32_t page,
+                     SceneCapture &capture, SceneCapture::MeshPage &out);
+void captureCameras(World &world, const SceneSaveState &state,
+                    SceneCapture &out);
+void captureLights(World &world, const SceneSaveState &state,
+                   SceneCapture &out);
+void captureCategories(World &world, const SceneSaveState &state,
+                       SceneCapture &out);
+
+// Strings [first, first + count).
+void saveStringPage(NyxBinaryWriter &w, const SceneSaveTables &tables,
+                    uint32_t first, uint32_t count);
+void saveEntityPage(NyxBinaryWriter &w, const SceneCapture &capture,
+                    const SceneCapture::EntityPage &page,
+                    SceneSaveTables &tables);
+void saveTransformPage(NyxBinaryWriter &w,
+                       const SceneCapture::TransformPage &page);
+void saveMeshPage(NyxBinaryWriter &w, const SceneCapture &capture,
+                  const SceneCapture::MeshPage &page, SceneSaveTables &tables);
+void saveMaterialRefs(NyxBinaryWriter &w, SceneSaveTables &tables);
+void saveCameras(NyxBinaryWriter &w, const SceneCapture &capture);
+void saveLights(NyxBinaryWriter &w, const SceneCapture &capture);
+void saveSky(NyxBinaryWriter &w, const SceneCapture &capture,
+             SceneSaveTables &tables);
+void saveCategories(NyxBinaryWriter &w, const SceneCapture &capture,
+                    SceneSaveTables &tables);
+
+// TRNS v3+ record; the chunk stores `count` of these back to back followed
+// by `count` hidden flags, so the records load with a single copy.
+struct TransformRecord {
+  float translation[3];
+  float rotation[4]; // x, y, z, w
+  float scale[3];
+};
+static_assert(sizeof(TransformRecord) == 40, "TRNS record must stay packed");
+
+// ------------------------------
+// Load: decode -> stage -> commit
+// ------------------------------
+// decode*() parse one chunk into plain staging data without touching World,
+// so independent chunks (and sub-ranges of ENTS/TRNS) decode concurrently.
+// commitScene() then applies everything to World on the calling thread in the
+// same order the sequential loader used. String views point into the
+// reader's mapping and stay valid as long as the reader.
+
+struct EntityStage {
+  uint64_t uuid = 0;
+  uint32_t nameId = kInvalidIndex;
+  uint32_t parentIdx = kInvalidIndex;
 };
 
-struct MaterialRefEntry {
-  std::string assetPath;
+struct MaterialRefStage {
+  uint32_t pathId = kInvalidIndex;
   MaterialHandle legacyHandle = InvalidMaterial;
 };
 
-void collectSortedEntities(World &world, std::vector<EntityRecord> &out);
-
-void saveStringsAndMap(
-    NyxBinaryWriter &w, World &world, const std::vector<EntityRecord> &ents,
-    std::vector<std::string> &strings,
-    std::unordered_map<std::string, uint32_t> &stringMap,
-    std::unordered_map<std::string, uint32_t> &materialRefMap,
-    std::vector<MaterialRefEntry> &materialRefs);
+struct SubmeshStage {
+  uint32_t nameId = kInvalidIndex;
+  ProcMeshType type = ProcMeshType::Cube;
+  uint32_t matRefIdx = kInvalidIndex; // v2+
+  MaterialHandle legacyHandle = InvalidMaterial; // v1
+};
 
-void saveEntities(
-    NyxBinaryWriter &w, World &world, const std::vector<EntityRecord> &ents,
-    const std::unordered_map<std::string, uint32_t> &stringMap,
-    std::unordered_map<uint32_t, uint32_t> &entityIndexByRaw);
+struct MeshStage {
+  uint32_t entIdx = kInvalidIndex;
+  uint32_t firstSubmesh = 0;
+  uint32_t submeshCount = 0;
+};
 
-void saveTransforms(NyxBinaryWriter &w, World &world,
-                    const std::vector<EntityRecord> &ents);
+struct CameraStage {
+  uint32_t entIdx = kInvalidIndex;
+  CCamera camera{};
+};
 
-void saveMaterialRefs(
-    NyxBinaryWriter &w, const std::vector<MaterialRefEntry> &materialRefs,
-    const std::unordered_map<std::string, uint32_t> &stringMap);
+struct LightStage {
+  uint32_t entIdx = kInvalidIndex;
+  CLight light{};
+};
 
-void saveMeshes(
-    NyxBinaryWriter &w, World &world, const std::vector<EntityRecord> &ents,
-    const std::unordered_map<std::string, uint32_t> &stringMap,
-    const std::unordered_map<std::string, uint32_t> &materialRefMap,
-    const std::unordered_map<uint32_t, uint32_t> &entityIndexByRaw);
+struct CategoryStage {
+  uint32_t nameId = kInvalidIndex;
+  int32_t parent = -1;
+  uint32_t firstEntity = 0;
+  uint32_t entityCount = 0;
+};
 
-void saveCameras(
-    NyxBinaryWriter &w, World &world, const std::vector<EntityRecord> &ents,
-    const std::unordered_map<uint32_t, uint32_t> &entityIndexByRaw);
+// A paged chunk as found in the file; kept for seeding SceneSaveState.
+struct PageStage {
+  NyxTocEntry entry{};
+  uint32_t first = 0;
+  uint32_t count = 0;
+};
 
-void saveLights(
-    NyxBinaryWriter &w, World &world, const std::vector<EntityRecord> &ents,
-    const std::unordered_map<uint32_t, uint32_t> &entityIndexByRaw);
+struct SceneLoadStaging {
+  // Set by paged decoders; a page decodes into its own staging and is then
+  // merged with mergePage().
+  PageStage page{};
 
-void saveSky(NyxBinaryWriter &w, World &world,
-             const std::unordered_map<std::string, uint32_t> &stringMap);
+  std::vector<PageStage> stringPages;
+  std::vector<PageStage> entityPages;
+  std::vector<PageStage> transformPages;
+  std::vector<PageStage> meshPages;
 
-void saveCategories(
-    NyxBinaryWriter &w, World &world,
-    const std::unordered_map<std::string, uint32_t> &stringMap,
-    const std::unordered_map<uint32_t, uint32_t> &entityIndexByRaw);
+  std::vector<std::string_view> strings;
 
-void loadStrings(NyxBinaryReader &r, const NyxTocEntry &entry,
-                 std::vector<std::string> &strings);
+  std::vector<EntityStage> entities;
 
-void loadEntities(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-                  const std::vector<std::string> &strings,
-                  std::vector<EntityID> &created,
-                  std::vector<uint32_t> &parentIndices);
+  bool hasTransforms = false;
+  uint32_t transformVersion = 0;
+  std::vector<TransformRecord> transforms;
+  std::vector<uint8_t> transformHidden;
 
-void loadTransforms(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-                    const std::vector<EntityID> &created);
+  bool hasMaterialRefs = false;
+  uint32_t materialRefVersion = 0;
+  std::vector<MaterialRefStage> materialRefs;
 
-void loadMaterialRefs(NyxBinaryReader &r, const NyxTocEntry &entry,
-                      const std::vector<std::string> &strings,
-                      std::vector<MaterialRefEntry> &materialRefs);
+  uint32_t meshVersion = 0;
+  std::vector<MeshStage> meshes;
+  std::vector<SubmeshStage> submeshes;
 
-void loadMeshes(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-                const std::vector<std::string> &strings,
-                const std::vector<EntityID> &created,
-                const std::vector<MaterialRefEntry> &materialRefs);
+  uint32_t activeCamera = kInvalidIndex;
+  std::vector<CameraStage> cameras;
 
-void loadCameras(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-                 const std::vector<EntityID> &created);
+  std::vector<LightStage> lights;
 
-void loadLights(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-                const std::vector<EntityID> &created);
+  bool hasSky = false;
+  uint32_t skyVersion = 0;
+  uint32_t skyHdriId = kInvalidIndex;
+  CSky sky{};
 
-void loadSky(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-             const std::vector<std::string> &strings);
+  bool hasCategories = false;
+  std::vector<CategoryStage> categories;
+  std::vector<uint32_t> categoryEntities;
+};
 
-void loadCategories(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-                    const std::vector<std::string> &strings,
-                    const std::vector<EntityID> &created);
+// Records per sub-range job when decoding ENTS/TRNS.
+constexpr uint32_t kDecodeGrain = 16384;
+
+void decodeStrings(NyxChunkReader &r, SceneLoadStaging &out);
+void decodeEntities(NyxChunkReader &r, SceneLoadStaging &out);
+void decodeTransforms(NyxChunkReader &r, SceneLoadStaging &out);
+void decodeMaterialRefs(NyxChunkReader &r, SceneLoadStaging &out);
+void decodeMeshes(NyxChunkReader &r, SceneLoadStaging &out);
+void decodeCameras(NyxChunkReader &r, SceneLoadStaging &out);
+void decodeLights(NyxChunkReader &r, SceneLoadStaging &out);
+void decodeSky(NyxChunkReader &r, SceneLoadStaging &out);
+void decodeCategories(NyxChunkReader &r, SceneLoadStaging &out);
+
+// Whether a chunk is a page that must decode into its own staging.
+bool isPagedChunk(const NyxTocEntry &entry);
+// Folds one decoded page into `dst`. Call single-threaded, with the pages of
+// each id in ascending `page.first` order; false if they do not line up.
+bool mergePage(SceneLoadStaging &dst, SceneLoadStaging &page);
+
+void commitScene(const SceneLoadStaging &staged, World &world);
+
+// After commitScene(): adopts the file's TOC and tables into `state` if every
+// chunk is in the current layout; otherwise leaves it reset, and the next
+// save is a full rewrite.
+void seedSaveState(const NyxBinaryReader &r, const SceneLoadStaging &staged,
+                   World &world, const std::string &path,
+                   SceneSaveState &state);
 
 } // namespace detail::sceneio
 
@@ -5,11 +5,21 @@
 namespace Nyx {
 
 class World;
+struct SceneSaveState;
+struct SceneSaveSnapshot;
 
 namespace detail {
 
 bool saveSceneBinary(const std::string &path, World &world);
-bool loadSceneBinary(const std::string &path, World &world);
+bool saveSceneBinary(const std::string &path, World &world,
+                     SceneSaveState &state);
+// The three steps of saveSceneBinary(); only capture reads World.
+void captureSceneBinary(const std::string &path, World &world,
+                        SceneSaveState &state, SceneSaveSnapshot &out);
+bool writeSceneBinary(SceneSaveSnapshot &snap);
+void finishSceneSave(SceneSaveState &state, SceneSaveSnapshot &snap);
+bool loadSceneBinary(const std::string &path, World &world,
+                     SceneSaveState *state = nullptr);
 
 } // namespace detail
 
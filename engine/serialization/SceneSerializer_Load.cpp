@@ -2,16 +2,26 @@
 
 #include "NyxChunkIDs.h"
 #include "NyxBinaryReader.h"
+#include "SceneSaveState.h"
 #include "SceneSerializer_ChunkIO.h"
+#include "core/JobSystem.h"
+#include "core/Log.h"
 #include "scene/World.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Nyx::detail {
 
-bool loadSceneBinary(const std::string &path, World &world) {
+bool loadSceneBinary(const std::string &path, World &world,
+                     SceneSaveState *state) {
+  if (state)
+    state->reset();
+
   NyxBinaryReader r(path);
   if (!r.ok())
     return false;
@@ -26,48 +36,120 @@ bool loadSceneBinary(const std::string &path, World &world) {
 
   const uint32_t fileMajor = version & 0xFFFF0000u;
   const uint32_t localMajor = NYXSCENE_VERSION & 0xFFFF0000u;
-  if (fileMajor != localMajor)
+  const uint32_t minMajor = NYXSCENE_MIN_READ_VERSION & 0xFFFF0000u;
+  if (fileMajor > localMajor || fileMajor < minMajor)
     return false;
 
   if (!r.loadTOC())
     return false;
+  if (r.recoveredTOC())
+    Log::Warn("Scene '{}': damaged tail after the last save, loading the "
+              "previous one",
+              path);
+
+  // Decode every chunk concurrently into staging; nothing touches World
+  // until all of them are done.
+  using Decoder = void (*)(NyxChunkReader &, sceneio::SceneLoadStaging &);
+  struct ChunkDecoder {
+    NyxChunk id;
+    Decoder decode;
+  };
+  static constexpr ChunkDecoder kDecoders[] = {
+      {NyxChunk::STRS, sceneio::decodeStrings},
+      {NyxChunk::ENTS, sceneio::decodeEntities},
+      {NyxChunk::TRNS, sceneio::decodeTransforms},
+      {NyxChunk::MATL, sceneio::decodeMaterialRefs},
+      {NyxChunk::MESH, sceneio::decodeMeshes},
+      {NyxChunk::CAMR, sceneio::decodeCameras},
+      {NyxChunk::LITE, sceneio::decodeLights},
+      {NyxChunk::SKY, sceneio::decodeSky},
+      {NyxChunk::CATS, sceneio::decodeCategories},
+  };
+
+  // Checksum verification and decompression run inside each job; staged
+  // string views may point into a job's storage, so jobs outlive the commit.
+  // Pages of STRS/ENTS/TRNS/MESH decode into their own staging and are
+  // merged afterwards.
+  struct DecodeJob {
+    Decoder decode;
+    NyxTocEntry entry;
+    std::unique_ptr<sceneio::SceneLoadStaging> page;
+    std::vector<uint8_t> storage;
+    NyxChunkReader chunk;
+    bool corrupt = false;   // failed its checksum or wouldn't decompress
+    bool truncated = false; // decoder read past the end of the chunk
+  };
+  std::vector<DecodeJob> jobs;
+  for (const ChunkDecoder &d : kDecoders) {
+    for (const NyxTocEntry &entry : r.findAll(static_cast<uint32_t>(d.id))) {
+      if (!sceneio::isPagedChunk(entry)) {
+        jobs.push_back({d.decode, entry});
+        break; // unpaged ids are single chunks; first one wins
+      }
+      DecodeJob &job = jobs.emplace_back(DecodeJob{d.decode, entry});
+      job.page = std::make_unique<sceneio::SceneLoadStaging>();
+      job.page->page.entry = entry;
+    }
+  }
+
+  sceneio::SceneLoadStaging staged;
+  JobSystem::instance().parallelFor(
+      (uint32_t)jobs.size(), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+          DecodeJob &job = jobs[i];
+          if (!r.openChunk(job.entry, job.storage, job.chunk)) {
+            job.corrupt = true;
+            continue;
+          }
+          job.decode(job.chunk, job.page ? *job.page : staged);
+          job.truncated = job.chunk.failed();
+        }
+      });
+
+  // Any failed job fails the load before World is touched: a half-decoded
+  // scene must not replace the one that is open.
+  for (const DecodeJob &job : jobs) {
+    if (!job.corrupt && !job.truncated)
+      continue;
+    const char cc[5] = {char(job.entry.fourcc), char(job.entry.fourcc >> 8),
+                        char(job.entry.fourcc >> 16),
+                        char(job.entry.fourcc >> 24), 0};
+    if (job.corrupt)
+      Log::Error("Scene '{}': chunk {} failed its integrity check", path, cc);
+    else
+      Log::Error("Scene '{}': chunk {} is truncated", path, cc);
+    return false;
+  }
+
+  std::vector<sceneio::SceneLoadStaging *> pages;
+  for (DecodeJob &job : jobs) {
+    if (job.page)
+      pages.push_back(job.page.get());
+  }
+  std::sort(pages.begin(), pages.end(),
+            [](const sceneio::SceneLoadStaging *a,
+               const sceneio::SceneLoadStaging *b) {
+              if (a->page.entry.fourcc != b->page.entry.fourcc)
+                return a->page.entry.fourcc < b->page.entry.fourcc;
+              return a->page.first < b->page.first;
+            });
+  for (sceneio::SceneLoadStaging *page : pages) {
+    if (!sceneio::mergePage(staged, *page)) {
+      Log::Error("Scene '{}': chunk pages overlap or leave gaps", path);
+      return false;
+    }
+  }
 
   world.clear();
-
-  std::vector<std::string> strings;
-  std::vector<EntityID> created;
-  std::vector<uint32_t> parentIndices;
-  std::vector<sceneio::MaterialRefEntry> materialRefs;
-
-  if (auto entry = r.findChunk(static_cast<uint32_t>(NyxChunk::STRS)); entry)
-    sceneio::loadStrings(r, *entry, strings);
-
-  if (auto entry = r.findChunk(static_cast<uint32_t>(NyxChunk::ENTS)); entry)
-    sceneio::loadEntities(r, *entry, world, strings, created, parentIndices);
-
-  if (auto entry = r.findChunk(static_cast<uint32_t>(NyxChunk::TRNS)); entry)
-    sceneio::loadTransforms(r, *entry, world, created);
-
-  if (auto entry = r.findChunk(static_cast<uint32_t>(NyxChunk::MATL)); entry)
-    sceneio::loadMaterialRefs(r, *entry, strings, materialRefs);
-
-  if (auto entry = r.findChunk(static_cast<uint32_t>(NyxChunk::MESH)); entry)
-    sceneio::loadMeshes(r, *entry, world, strings, created, materialRefs);
-
-  if (auto entry = r.findChunk(static_cast<uint32_t>(NyxChunk::CAMR)); entry)
-    sceneio::loadCameras(r, *entry, world, created);
-
-  if (auto entry = r.findChunk(static_cast<uint32_t>(NyxChunk::LITE)); entry)
-    sceneio::loadLights(r, *entry, world, created);
-
-  if (auto entry = r.findChunk(static_cast<uint32_t>(NyxChunk::SKY)); entry)
-    sceneio::loadSky(r, *entry, world, strings);
-
-  if (auto entry = r.findChunk(static_cast<uint32_t>(NyxChunk::CATS)); entry)
-    sceneio::loadCategories(r, *entry, world, strings, created);
+  sceneio::commitScene(staged, world);
 
   world.updateTransforms();
   world.clearEvents();
+
+  // A recovered file gets rewritten in full on its next save, and so does
+  // one from before 3.1, which has no committed footer to update.
+  if (state && !r.recoveredTOC() && r.hasCommittedFooter())
+    sceneio::seedSaveState(r, staged, world, path, *state);
   return true;
 }
 
@@ -1,9 +1,12 @@
 #include "SceneSerializer_ChunkIO.h"
 
+#include "core/JobSystem.h"
 #include "scene/Components.h"
 #include "scene/World.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -11,225 +14,210 @@ namespace Nyx::detail::sceneio {
 
 namespace {
 
-std::string readString(NyxBinaryReader &r) {
-  const uint32_t len = r.readU32();
-  std::string s(len, '\0');
-  if (len > 0)
-    r.readBytes(s.data(), len);
-  return s;
-}
-
-std::string getStringSafe(const std::vector<std::string> &strings,
+std::string getStringSafe(const std::vector<std::string_view> &strings,
                           uint32_t idx, const char *fallback) {
   if (idx < strings.size())
-    return strings[idx];
+    return std::string(strings[idx]);
   return fallback;
 }
 
-} // namespace
-
-void loadStrings(NyxBinaryReader &r, const NyxTocEntry &entry,
-                 std::vector<std::string> &strings) {
-  r.seek(entry.offset);
-  uint32_t fourcc = 0;
-  uint32_t version = 0;
-  uint64_t size = 0;
-  if (!r.readChunkHeader(fourcc, version, size))
-    return;
+template <class T> T loadPod(const uint8_t *p) {
+  T v;
+  std::memcpy(&v, p, sizeof(T));
+  return v;
+}
 
-  const uint32_t count = r.readU32();
-  strings.clear();
-  strings.reserve(count);
-  for (uint32_t i = 0; i < count; ++i)
-    strings.push_back(readString(r));
+// Fixed-stride record block after a u32 count. Clamps the count to what the
+// chunk actually holds and returns the first record (or nullptr).
+const uint8_t *recordBlock(NyxChunkReader &r, uint32_t &count,
+                           uint64_t stride) {
+  count = r.readU32();
+  const uint64_t fits = stride ? r.remaining() / stride : 0;
+  count = (uint32_t)std::min<uint64_t>(count, fits);
+  return r.readView(uint64_t(count) * stride);
 }
 
-void loadEntities(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-                  const std::vector<std::string> &strings,
-                  std::vector<EntityID> &created,
-                  std::vector<uint32_t> &parentIndices) {
-  r.seek(entry.offset);
-  uint32_t fourcc = 0;
-  uint32_t version = 0;
-  uint64_t size = 0;
-  if (!r.readChunkHeader(fourcc, version, size))
+// Paged chunk versions start with the range they cover.
+void readPageHeader(NyxChunkReader &r, uint32_t pagedVersion,
+                    SceneLoadStaging &out) {
+  if (r.version() < pagedVersion)
     return;
-
-  const uint32_t count = r.readU32();
-  created.assign(count, InvalidEntity);
-  parentIndices.assign(count, kInvalidIndex);
-
-  for (uint32_t i = 0; i < count; ++i) {
-    const uint64_t uuidValue = r.readU64();
-    const uint32_t nameId = r.readU32();
-    const uint32_t parentIdx = r.readU32();
-    const uint32_t flags = r.readU32();
-    (void)flags;
-
-    EntityID e = world.createEntityWithUUID(
-        EntityUUID{uuidValue}, getStringSafe(strings, nameId, "Entity"));
-    created[i] = e;
-    parentIndices[i] = parentIdx;
-  }
-
-  for (uint32_t i = 0; i < count; ++i) {
-    const EntityID child = created[i];
-    if (child == InvalidEntity)
-      continue;
-    const uint32_t parentIdx = parentIndices[i];
-    if (parentIdx < created.size()) {
-      EntityID parent = created[parentIdx];
-      if (parent != InvalidEntity)
-        world.setParent(child, parent);
-    }
-  }
+  out.page.first = r.readU32();
+  out.page.count = r.readU32();
 }
 
-void loadTransforms(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-                    const std::vector<EntityID> &created) {
-  r.seek(entry.offset);
-  uint32_t fourcc = 0;
-  uint32_t version = 0;
-  uint64_t size = 0;
-  if (!r.readChunkHeader(fourcc, version, size))
-    return;
+// Copies a page's records to `first` in `to`. Pages are merged in order, so
+// anything but the next contiguous range means a damaged file.
+template <class T>
+bool placePage(std::vector<T> &to, const std::vector<T> &from,
+               uint32_t first) {
+  if (first != to.size())
+    return false;
+  to.insert(to.end(), from.begin(), from.end());
+  return true;
+}
 
-  const uint32_t count = r.readU32();
-  for (uint32_t i = 0; i < count && i < created.size(); ++i) {
-    const EntityID e = created[i];
-    if (e == InvalidEntity)
-      continue;
+} // namespace
 
-    CTransform &t = world.transform(e);
+// ------------------------------
+// Decode (any thread)
+// ------------------------------
 
-    t.translation.x = r.readF32();
-    t.translation.y = r.readF32();
-    t.translation.z = r.readF32();
+void decodeStrings(NyxChunkReader &r, SceneLoadStaging &out) {
+  readPageHeader(r, kStringsPagedVersion, out);
+  const uint32_t count = r.readU32();
+  out.strings.clear();
+  out.strings.reserve(std::min<uint64_t>(count, r.remaining() / 4u));
+  for (uint32_t i = 0; i < count && !r.failed(); ++i)
+    out.strings.push_back(r.readStringView());
+}
 
-    t.rotation.x = r.readF32();
-    t.rotation.y = r.readF32();
-    t.rotation.z = r.readF32();
+void decodeEntities(NyxChunkReader &r, SceneLoadStaging &out) {
+  readPageHeader(r, kEntitiesPagedVersion, out);
+  // uuid u64, name u32, parent u32, flags u32
+  constexpr uint64_t kStride = 8u + 4u + 4u + 4u;
+  uint32_t count = 0;
+  const uint8_t *base = recordBlock(r, count, kStride);
+  out.entities.assign(count, EntityStage{});
+  if (!base)
+    return;
 
-    if (version >= 2) {
-      t.rotation.w = r.readF32();
-    } else {
-      t.rotation.w = 1.0f;
-    }
+  JobSystem::instance().parallelFor(
+      count, kDecodeGrain, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+          const uint8_t *p = base + uint64_t(i) * kStride;
+          EntityStage &e = out.entities[i];
+          e.uuid = loadPod<uint64_t>(p);
+          e.nameId = loadPod<uint32_t>(p + 8);
+          e.parentIdx = loadPod<uint32_t>(p + 12);
+        }
+      });
+}
 
-    t.scale.x = r.readF32();
-    t.scale.y = r.readF32();
-    t.scale.z = r.readF32();
+void decodeTransforms(NyxChunkReader &r, SceneLoadStaging &out) {
+  readPageHeader(r, kTransformsPagedVersion, out);
+  const uint32_t version = r.version();
+  out.hasTransforms = true;
+  out.transformVersion = version;
+
+  if (version >= 3) {
+    // Record block followed by one hidden byte per record.
+    constexpr uint64_t kStride = sizeof(TransformRecord) + 1u;
+    uint32_t count = r.readU32();
+    count = (uint32_t)std::min<uint64_t>(count, r.remaining() / kStride);
+    const uint8_t *records = r.readView(uint64_t(count) * sizeof(TransformRecord));
+    const uint8_t *hidden = r.readView(count);
+    out.transforms.resize(count);
+    out.transformHidden.resize(count);
+    if (!records || !hidden)
+      return;
+
+    JobSystem::instance().parallelFor(
+        count, kDecodeGrain, [&](uint32_t begin, uint32_t end) {
+          std::memcpy(out.transforms.data() + begin,
+                      records + uint64_t(begin) * sizeof(TransformRecord),
+                      uint64_t(end - begin) * sizeof(TransformRecord));
+          std::memcpy(out.transformHidden.data() + begin, hidden + begin,
+                      end - begin);
+        });
+    return;
+  }
 
-    if (version >= 2)
-      t.hidden = (r.readU8() != 0);
+  // v1: t3 r3 s3; v2: t3 r4 s3 hidden.
+  const uint64_t stride = (version >= 2) ? 10u * 4u + 1u : 9u * 4u;
+  uint32_t count = 0;
+  const uint8_t *base = recordBlock(r, count, stride);
+  out.transforms.resize(count);
+  out.transformHidden.assign(count, 0u);
+  if (!base)
+    return;
 
-    t.dirty = true;
-    world.worldTransform(e).dirty = true;
-  }
+  JobSystem::instance().parallelFor(
+      count, kDecodeGrain, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+          const uint8_t *p = base + uint64_t(i) * stride;
+          TransformRecord &t = out.transforms[i];
+          std::memcpy(t.translation, p, 3 * sizeof(float));
+          std::memcpy(t.rotation, p + 12, 3 * sizeof(float));
+          if (version >= 2) {
+            t.rotation[3] = loadPod<float>(p + 24);
+            std::memcpy(t.scale, p + 28, 3 * sizeof(float));
+            out.transformHidden[i] = p[40];
+          } else {
+            t.rotation[3] = 1.0f;
+            std::memcpy(t.scale, p + 24, 3 * sizeof(float));
+          }
+        }
+      });
 }
 
-void loadMaterialRefs(NyxBinaryReader &r, const NyxTocEntry &entry,
-                      const std::vector<std::string> &strings,
-                      std::vector<MaterialRefEntry> &materialRefs) {
-  r.seek(entry.offset);
-  uint32_t fourcc = 0;
-  uint32_t version = 0;
-  uint64_t size = 0;
-  if (!r.readChunkHeader(fourcc, version, size))
-    return;
+void decodeMaterialRefs(NyxChunkReader &r, SceneLoadStaging &out) {
+  const uint32_t version = r.version();
+  out.hasMaterialRefs = true;
+  out.materialRefVersion = version;
 
   const uint32_t count = r.readU32();
-  materialRefs.clear();
-  materialRefs.reserve(count);
-  for (uint32_t i = 0; i < count; ++i) {
-    MaterialRefEntry ref{};
-    if (version >= 2) {
-      const uint32_t pathID = r.readU32();
-      if (pathID < strings.size())
-        ref.assetPath = strings[pathID];
-      ref.legacyHandle.slot = r.readU32();
-      ref.legacyHandle.gen = r.readU32();
-    } else {
-      ref.legacyHandle.slot = r.readU32();
-      ref.legacyHandle.gen = r.readU32();
-    }
-    materialRefs.push_back(std::move(ref));
+  out.materialRefs.clear();
+  out.materialRefs.reserve(std::min<uint64_t>(count, r.remaining() / 8u));
+  for (uint32_t i = 0; i < count && !r.failed(); ++i) {
+    MaterialRefStage ref{};
+    if (version >= 2)
+      ref.pathId = r.readU32();
+    ref.legacyHandle.slot = r.readU32();
+    ref.legacyHandle.gen = r.readU32();
+    out.materialRefs.push_back(ref);
   }
 }
 
-void loadMeshes(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-                const std::vector<std::string> &strings,
-                const std::vector<EntityID> &created,
-                const std::vector<MaterialRefEntry> &materialRefs) {
-  r.seek(entry.offset);
-  uint32_t fourcc = 0;
-  uint32_t version = 0;
-  uint64_t size = 0;
-  if (!r.readChunkHeader(fourcc, version, size))
-    return;
+void decodeMeshes(NyxChunkReader &r, SceneLoadStaging &out) {
+  readPageHeader(r, kMeshesPagedVersion, out);
+  const uint32_t version = r.version();
+  out.meshVersion = version;
 
   const uint32_t meshEntityCount = r.readU32();
-  for (uint32_t i = 0; i < meshEntityCount; ++i) {
-    const uint32_t entIdx = r.readU32();
-    const uint32_t subCount = r.readU32();
-
-    if (entIdx >= created.size() || created[entIdx] == InvalidEntity) {
-      const uint32_t perSubSize = (version >= 2) ? (4u + 1u + 4u) : (4u + 1u + 8u);
-      r.skip(uint64_t(subCount) * perSubSize);
-      continue;
+  out.meshes.clear();
+  out.submeshes.clear();
+  out.meshes.reserve(std::min<uint64_t>(meshEntityCount, r.remaining() / 8u));
+
+  for (uint32_t i = 0; i < meshEntityCount && !r.failed(); ++i) {
+    MeshStage m{};
+    m.entIdx = r.readU32();
+    m.submeshCount = r.readU32();
+    m.firstSubmesh = (uint32_t)out.submeshes.size();
+
+    const uint64_t perSubSize = (version >= 2) ? (4u + 1u + 4u) : (4u + 1u + 8u);
+    if (uint64_t(m.submeshCount) * perSubSize > r.remaining()) {
+      r.skip(r.remaining() + 1u); // truncated: latch failure and stop
+      break;
     }
 
-    EntityID e = created[entIdx];
-    CMesh &m = world.ensureMesh(e);
-    m.submeshes.clear();
-    m.submeshes.resize(subCount);
-
-    for (uint32_t s = 0; s < subCount; ++s) {
-      const uint32_t nameId = r.readU32();
-      const uint8_t type = r.readU8();
-
-      MaterialRefEntry matRef{};
+    for (uint32_t s = 0; s < m.submeshCount; ++s) {
+      SubmeshStage sub{};
+      sub.nameId = r.readU32();
+      sub.type = static_cast<ProcMeshType>(r.readU8());
       if (version >= 2) {
-        const uint32_t matRefIdx = r.readU32();
-        if (matRefIdx < materialRefs.size())
-          matRef = materialRefs[matRefIdx];
+        sub.matRefIdx = r.readU32();
       } else {
-        matRef.legacyHandle.slot = r.readU32();
-        matRef.legacyHandle.gen = r.readU32();
+        sub.legacyHandle.slot = r.readU32();
+        sub.legacyHandle.gen = r.readU32();
       }
-
-      m.submeshes[s].name = getStringSafe(strings, nameId, "Submesh");
-      m.submeshes[s].type = static_cast<ProcMeshType>(type);
-      m.submeshes[s].materialAssetPath = matRef.assetPath;
-      m.submeshes[s].material = matRef.legacyHandle;
+      out.submeshes.push_back(sub);
     }
+    out.meshes.push_back(m);
   }
 }
 
-void loadCameras(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-                 const std::vector<EntityID> &created) {
-  r.seek(entry.offset);
-  uint32_t fourcc = 0;
-  uint32_t version = 0;
-  uint64_t size = 0;
-  if (!r.readChunkHeader(fourcc, version, size))
-    return;
-
+void decodeCameras(NyxChunkReader &r, SceneLoadStaging &out) {
+  const uint32_t version = r.version();
   const uint32_t count = r.readU32();
-  const uint32_t activeIndex = r.readU32();
-
-  for (uint32_t i = 0; i < count; ++i) {
-    const uint32_t entIdx = r.readU32();
-    if (entIdx >= created.size() || created[entIdx] == InvalidEntity) {
-      if (version >= 3) {
-        r.skip(1 + 9 * sizeof(float));
-      } else {
-        r.skip(1 + 5 * sizeof(float));
-      }
-      continue;
-    }
-
-    CCamera &c = world.ensureCamera(created[entIdx]);
+  out.activeCamera = r.readU32();
+  out.cameras.clear();
+  out.cameras.reserve(std::min<uint64_t>(count, r.remaining() / 25u));
+
+  for (uint32_t i = 0; i < count && !r.failed(); ++i) {
+    CameraStage cs{};
+    cs.entIdx = r.readU32();
+    CCamera &c = cs.camera;
     c.projection = static_cast<CameraProjection>(r.readU8());
     c.fovYDeg = r.readF32();
     c.orthoHeight = r.readF32();
@@ -242,38 +230,20 @@ void loadCameras(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
       c.sensorWidth = r.readF32();
       c.sensorHeight = r.readF32();
     }
-    c.dirty = true;
-  }
-
-  if (activeIndex < created.size() && created[activeIndex] != InvalidEntity &&
-      world.hasCamera(created[activeIndex])) {
-    world.setActiveCamera(created[activeIndex]);
+    out.cameras.push_back(cs);
   }
 }
 
-void loadLights(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-                const std::vector<EntityID> &created) {
-  r.seek(entry.offset);
-  uint32_t fourcc = 0;
-  uint32_t version = 0;
-  uint64_t size = 0;
-  if (!r.readChunkHeader(fourcc, version, size))
-    return;
-
+void decodeLights(NyxChunkReader &r, SceneLoadStaging &out) {
+  const uint32_t version = r.version();
   const uint32_t count = r.readU32();
-  for (uint32_t i = 0; i < count; ++i) {
-    const uint32_t entIdx = r.readU32();
+  out.lights.clear();
+  out.lights.reserve(std::min<uint64_t>(count, r.remaining() / 37u));
 
-    if (entIdx >= created.size() || created[entIdx] == InvalidEntity) {
-      if (version >= 2) {
-        r.skip(1 + 2 + 12 * sizeof(float) + 3 * sizeof(uint32_t));
-      } else {
-        r.skip(1 + 3 * sizeof(float) + 5 * sizeof(float));
-      }
-      continue;
-    }
-
-    CLight &l = world.ensureLight(created[entIdx]);
+  for (uint32_t i = 0; i < count && !r.failed(); ++i) {
+    LightStage ls{};
+    ls.entIdx = r.readU32();
+    CLight &l = ls.light;
     l.type = static_cast<LightType>(r.readU8());
 
     l.color.x = r.readF32();
@@ -299,22 +269,17 @@ void loadLights(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
       l.pcfRadius = r.readF32();
       l.pointFar = r.readF32();
     }
+    out.lights.push_back(ls);
   }
 }
 
-void loadSky(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-             const std::vector<std::string> &strings) {
-  r.seek(entry.offset);
-  uint32_t fourcc = 0;
-  uint32_t version = 0;
-  uint64_t size = 0;
-  if (!r.readChunkHeader(fourcc, version, size))
-    return;
+void decodeSky(NyxChunkReader &r, SceneLoadStaging &out) {
+  const uint32_t version = r.version();
+  out.hasSky = true;
+  out.skyVersion = version;
 
-  CSky &sky = world.skySettings();
-
-  const uint32_t hdriId = r.readU32();
-  sky.hdriPath = (hdriId < strings.size()) ? strings[hdriId] : std::string{};
+  CSky &sky = out.sky;
+  out.skyHdriId = r.readU32();
   sky.intensity = r.readF32();
   sky.exposure = r.readF32();
 
@@ -331,39 +296,343 @@ void loadSky(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
   }
 }
 
-void loadCategories(NyxBinaryReader &r, const NyxTocEntry &entry, World &world,
-                    const std::vector<std::string> &strings,
-                    const std::vector<EntityID> &created) {
-  r.seek(entry.offset);
-  uint32_t fourcc = 0;
-  uint32_t version = 0;
-  uint64_t size = 0;
-  if (!r.readChunkHeader(fourcc, version, size))
+void decodeCategories(NyxChunkReader &r, SceneLoadStaging &out) {
+  out.hasCategories = true;
+  const uint32_t count = r.readU32();
+  out.categories.clear();
+  out.categoryEntities.clear();
+  out.categories.reserve(std::min<uint64_t>(count, r.remaining() / 12u));
+
+  for (uint32_t i = 0; i < count && !r.failed(); ++i) {
+    CategoryStage c{};
+    c.nameId = r.readU32();
+    c.parent = static_cast<int32_t>(r.readU32());
+    c.entityCount = r.readU32();
+    c.firstEntity = (uint32_t)out.categoryEntities.size();
+
+    if (uint64_t(c.entityCount) * 4u > r.remaining()) {
+      r.skip(r.remaining() + 1u);
+      break;
+    }
+    for (uint32_t j = 0; j < c.entityCount; ++j)
+      out.categoryEntities.push_back(r.readU32());
+    out.categories.push_back(c);
+  }
+}
+
+// ------------------------------
+// Pages
+// ------------------------------
+
+bool isPagedChunk(const NyxTocEntry &entry) {
+  switch (static_cast<NyxChunk>(entry.fourcc)) {
+  case NyxChunk::STRS:
+    return entry.version >= kStringsPagedVersion;
+  case NyxChunk::ENTS:
+    return entry.version >= kEntitiesPagedVersion;
+  case NyxChunk::TRNS:
+    return entry.version >= kTransformsPagedVersion;
+  case NyxChunk::MESH:
+    return entry.version >= kMeshesPagedVersion;
+  default:
+    return false;
+  }
+}
+
+bool mergePage(SceneLoadStaging &dst, SceneLoadStaging &src) {
+  const uint32_t first = src.page.first;
+  switch (static_cast<NyxChunk>(src.page.entry.fourcc)) {
+  case NyxChunk::STRS:
+    dst.stringPages.push_back(src.page);
+    return placePage(dst.strings, src.strings, first);
+  case NyxChunk::ENTS:
+    dst.entityPages.push_back(src.page);
+    return placePage(dst.entities, src.entities, first);
+  case NyxChunk::TRNS:
+    dst.transformPages.push_back(src.page);
+    dst.hasTransforms = true;
+    dst.transformVersion = src.transformVersion;
+    return placePage(dst.transformHidden, src.transformHidden, first) &&
+           placePage(dst.transforms, src.transforms, first);
+  case NyxChunk::MESH: {
+    dst.meshPages.push_back(src.page);
+    dst.meshVersion = src.meshVersion;
+    const uint32_t base = (uint32_t)dst.submeshes.size();
+    dst.submeshes.insert(dst.submeshes.end(), src.submeshes.begin(),
+                         src.submeshes.end());
+    for (MeshStage m : src.meshes) {
+      m.firstSubmesh += base;
+      dst.meshes.push_back(m);
+    }
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+// ------------------------------
+// Commit (main thread)
+// ------------------------------
+
+void commitScene(const SceneLoadStaging &st, World &world) {
+  const std::vector<std::string_view> &strings = st.strings;
+
+  // ENTS
+  const uint32_t entityCount = (uint32_t)st.entities.size();
+  std::vector<EntityID> created(entityCount, InvalidEntity);
+  for (uint32_t i = 0; i < entityCount; ++i) {
+    const EntityStage &rec = st.entities[i];
+    if (rec.uuid == 0)
+      continue; // tombstone left by an incremental save
+    created[i] = world.createEntityWithUUID(
+        EntityUUID{rec.uuid}, getStringSafe(strings, rec.nameId, "Entity"));
+  }
+  for (uint32_t i = 0; i < entityCount; ++i) {
+    const EntityID child = created[i];
+    if (child == InvalidEntity)
+      continue;
+    const uint32_t parentIdx = st.entities[i].parentIdx;
+    if (parentIdx < created.size()) {
+      EntityID parent = created[parentIdx];
+      if (parent != InvalidEntity)
+        world.setParent(child, parent);
+    }
+  }
+
+  // TRNS
+  if (st.hasTransforms) {
+    const uint32_t n =
+        std::min<uint32_t>((uint32_t)st.transforms.size(), entityCount);
+    for (uint32_t i = 0; i < n; ++i) {
+      const EntityID e = created[i];
+      if (e == InvalidEntity)
+        continue;
+
+      const TransformRecord &src = st.transforms[i];
+      CTransform &t = world.transform(e);
+      t.translation = glm::vec3(src.translation[0], src.translation[1],
+                                src.translation[2]);
+      t.rotation.x = src.rotation[0];
+      t.rotation.y = src.rotation[1];
+      t.rotation.z = src.rotation[2];
+      t.rotation.w = src.rotation[3];
+      t.scale = glm::vec3(src.scale[0], src.scale[1], src.scale[2]);
+      if (st.transformVersion >= 2)
+        t.hidden = (st.transformHidden[i] != 0);
+      t.dirty = true;
+      world.worldTransform(e).dirty = true;
+    }
+  }
+
+  // MATL
+  std::vector<MaterialRefEntry> materialRefs;
+  materialRefs.reserve(st.materialRefs.size());
+  for (const MaterialRefStage &src : st.materialRefs) {
+    MaterialRefEntry ref{};
+    if (src.pathId < strings.size())
+      ref.assetPath = std::string(strings[src.pathId]);
+    ref.legacyHandle = src.legacyHandle;
+    materialRefs.push_back(std::move(ref));
+  }
+
+  // MESH
+  for (const MeshStage &ms : st.meshes) {
+    if (ms.entIdx >= created.size() || created[ms.entIdx] == InvalidEntity)
+      continue;
+
+    CMesh &m = world.ensureMesh(created[ms.entIdx]);
+    m.submeshes.clear();
+    m.submeshes.resize(ms.submeshCount);
+
+    for (uint32_t s = 0; s < ms.submeshCount; ++s) {
+      const SubmeshStage &sub = st.submeshes[ms.firstSubmesh + s];
+
+      MaterialRefEntry matRef{};
+      if (st.meshVersion >= 2) {
+        if (sub.matRefIdx < materialRefs.size())
+          matRef = materialRefs[sub.matRefIdx];
+      } else {
+        matRef.legacyHandle = sub.legacyHandle;
+      }
+
+      m.submeshes[s].name = getStringSafe(strings, sub.nameId, "Submesh");
+      m.submeshes[s].type = sub.type;
+      m.submeshes[s].materialAssetPath = matRef.assetPath;
+      m.submeshes[s].material = matRef.legacyHandle;
+    }
+  }
+
+  // CAMR
+  for (const CameraStage &cs : st.cameras) {
+    if (cs.entIdx >= created.size() || created[cs.entIdx] == InvalidEntity)
+      continue;
+    CCamera &c = world.ensureCamera(created[cs.entIdx]);
+    c = cs.camera;
+    c.dirty = true;
+  }
+  if (st.activeCamera < created.size() &&
+      created[st.activeCamera] != InvalidEntity &&
+      world.hasCamera(created[st.activeCamera])) {
+    world.setActiveCamera(created[st.activeCamera]);
+  }
+
+  // LITE
+  for (const LightStage &ls : st.lights) {
+    if (ls.entIdx >= created.size() || created[ls.entIdx] == InvalidEntity)
+      continue;
+    world.ensureLight(created[ls.entIdx]) = ls.light;
+  }
+
+  // SKY
+  if (st.hasSky) {
+    CSky &sky = world.skySettings();
+    sky.hdriPath = getStringSafe(strings, st.skyHdriId, "");
+    sky.intensity = st.sky.intensity;
+    sky.exposure = st.sky.exposure;
+    sky.rotationYawDeg = st.sky.rotationYawDeg;
+    sky.ambient = st.sky.ambient;
+    sky.enabled = st.sky.enabled;
+    sky.drawBackground = st.sky.drawBackground;
+  }
+
+  // CATS
+  if (st.hasCategories) {
+    for (uint32_t i = 0; i < (uint32_t)st.categories.size(); ++i) {
+      const CategoryStage &c = st.categories[i];
+      world.addCategory(getStringSafe(strings, c.nameId, "Category"));
+      for (uint32_t j = 0; j < c.entityCount; ++j) {
+        const uint32_t entIdx = st.categoryEntities[c.firstEntity + j];
+        if (entIdx < created.size() && created[entIdx] != InvalidEntity)
+          world.addEntityCategory(created[entIdx], static_cast<int32_t>(i));
+      }
+    }
+    for (uint32_t i = 0; i < (uint32_t)st.categories.size(); ++i)
+      world.setCategoryParent(i, st.categories[i].parent);
+  }
+}
+
+// ------------------------------
+// Save-state seeding
+// ------------------------------
+
+namespace {
+
+// Page entries indexed by page number, if the pages tile [0, total) with
+// `pageSize` ranges exactly as the savers lay them out.
+bool collectPages(const std::vector<PageStage> &pages, uint32_t total,
+                  uint32_t pageSize, std::vector<NyxTocEntry> &out) {
+  const uint32_t count = (total + pageSize - 1) / pageSize;
+  if (pages.size() != count)
+    return false;
+  out.assign(count, NyxTocEntry{});
+  std::vector<uint8_t> seen(count, 0u);
+  for (const PageStage &page : pages) {
+    const uint32_t p = page.first / pageSize;
+    if (page.first % pageSize != 0 || p >= count || seen[p] ||
+        page.count != std::min(pageSize, total - page.first))
+      return false;
+    seen[p] = 1u;
+    out[p] = page.entry;
+  }
+  return true;
+}
+
+} // namespace
+
+void seedSaveState(const NyxBinaryReader &r, const SceneLoadStaging &st,
+                   World &world, const std::string &path,
+                   SceneSaveState &state) {
+  state.reset();
+  if (r.tocVersion() < NYX_TOC_VERSION)
     return;
 
-  const uint32_t count = r.readU32();
-  std::vector<int32_t> parentIndices;
-  parentIndices.reserve(count);
-
-  for (uint32_t i = 0; i < count; ++i) {
-    const uint32_t nameId = r.readU32();
-    const int32_t parent = static_cast<int32_t>(r.readU32());
-    const uint32_t entityCount = r.readU32();
-
-    const uint32_t catIdx =
-        world.addCategory(getStringSafe(strings, nameId, "Category"));
-    (void)catIdx;
-    parentIndices.push_back(parent);
-
-    for (uint32_t j = 0; j < entityCount; ++j) {
-      const uint32_t entIdx = r.readU32();
-      if (entIdx < created.size() && created[entIdx] != InvalidEntity)
-        world.addEntityCategory(created[entIdx], static_cast<int32_t>(i));
+  struct Layout {
+    NyxChunk id;
+    uint32_t version;
+    bool paged;
+  };
+  static constexpr Layout kLayout[] = {
+      {NyxChunk::STRS, kStringsVersion, true},
+      {NyxChunk::ENTS, kEntitiesVersion, true},
+      {NyxChunk::TRNS, kTransformsVersion, true},
+      {NyxChunk::MESH, kMeshesVersion, true},
+      {NyxChunk::MATL, kMaterialRefsVersion, false},
+      {NyxChunk::CAMR, kCamerasVersion, false},
+      {NyxChunk::LITE, kLightsVersion, false},
+      {NyxChunk::SKY, kSkyVersion, false},
+      {NyxChunk::CATS, kCategoriesVersion, false},
+  };
+  for (const NyxTocEntry &e : r.toc()) {
+    const Layout *match = nullptr;
+    for (const Layout &l : kLayout) {
+      if (static_cast<uint32_t>(l.id) == e.fourcc)
+        match = &l;
     }
+    if (!match || match->version != e.version ||
+        (!match->paged && r.findAll(e.fourcc).size() != 1))
+      return;
+  }
+
+  // Chunk indices are the file's own order, tombstones included, and every
+  // live entity must have come from the file.
+  std::vector<EntityRecord> ents(st.entities.size());
+  size_t live = 0;
+  for (size_t i = 0; i < ents.size(); ++i) {
+    const EntityUUID id{st.entities[i].uuid};
+    if (!id)
+      continue;
+    ents[i].e = world.findByUUID(id);
+    ents[i].uuid = id;
+    if (ents[i].e == InvalidEntity)
+      return;
+    ++live;
+  }
+  if (live != world.alive().size())
+    return;
+
+  const uint32_t entityCount = (uint32_t)ents.size();
+  if (!collectPages(st.entityPages, entityCount, kEntityPageSize,
+                    state.entityPages) ||
+      !collectPages(st.transformPages, entityCount, kEntityPageSize,
+                    state.transformPages) ||
+      !collectPages(st.meshPages, entityCount, kEntityPageSize,
+                    state.meshPages)) {
+    state.reset();
+    return;
+  }
+
+  state.entities = std::move(ents);
+  indexEntities(state);
+
+  SceneSaveTables &tables = state.tables;
+  tables.strings.reserve(st.strings.size());
+  for (std::string_view s : st.strings) {
+    tables.stringMap.emplace(std::string(s), (uint32_t)tables.strings.size());
+    tables.strings.emplace_back(s);
+  }
+
+  tables.materialRefs.reserve(st.materialRefs.size());
+  for (const MaterialRefStage &src : st.materialRefs) {
+    MaterialRefEntry ref{};
+    if (src.pathId < st.strings.size())
+      ref.assetPath = std::string(st.strings[src.pathId]);
+    ref.legacyHandle = src.legacyHandle;
+    tables.materialRefMap.emplace(
+        makeMaterialRefKey(ref.assetPath, ref.legacyHandle),
+        (uint32_t)tables.materialRefs.size());
+    tables.materialRefs.push_back(std::move(ref));
   }
 
-  for (uint32_t i = 0; i < parentIndices.size(); ++i)
-    world.setCategoryParent(i, parentIndices[i]);
+  tables.savedStringCount = (uint32_t)tables.strings.size();
+  tables.savedMaterialRefCount = (uint32_t)tables.materialRefs.size();
+  state.toc = r.toc();
+  state.dirtyPages.assign(state.entityPages.size(), 0u);
+  state.dirty = 0;
+  state.path = path;
+  state.fileBytes = r.fileSize();
+  state.stampFile();
+  state.updateLiveBytes();
 }
 
 } // namespace Nyx::detail::sceneio
@@ -2,47 +2,370 @@
 
 #include "NyxChunkIDs.h"
 #include "NyxBinaryWriter.h"
+#include "SceneSaveState.h"
 #include "SceneSerializer_ChunkIO.h"
+#include "core/Log.h"
+#include "io/FileUtil.h"
 #include "scene/World.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <filesystem>
 #include <string>
-#include <unordered_map>
+#include <system_error>
 #include <vector>
 
 namespace Nyx::detail {
 
-bool saveSceneBinary(const std::string &path, World &world) {
-  NyxBinaryWriter w(path);
-  if (!w.ok())
+namespace {
+
+using sceneio::kEntityPageSize;
+using sceneio::kStringPageSize;
+using Clock = std::chrono::steady_clock;
+
+void keepChunks(NyxBinaryWriter &w, const std::vector<NyxTocEntry> &toc,
+                NyxChunk id) {
+  for (const NyxTocEntry &e : toc) {
+    if (e.fourcc == static_cast<uint32_t>(id))
+      w.keepChunk(e);
+  }
+}
+
+// Pages to re-encode: those flagged with `bit` and those past the end of the
+// file (appended entities), or all of them if `all`.
+template <class Page, class CapturePage>
+void capturePages(const SceneSaveState &state,
+                  const std::vector<NyxTocEntry> &previous, uint8_t bit,
+                  bool all, uint32_t pageCount, std::vector<Page> &out,
+                  CapturePage &&capturePage) {
+  all = all || previous.size() > pageCount;
+  out.clear();
+  for (uint32_t p = 0; p < pageCount; ++p) {
+    if (all || p >= previous.size() ||
+        (p < state.dirtyPages.size() && (state.dirtyPages[p] & bit)))
+      capturePage(p, out.emplace_back());
+  }
+}
+
+// Copies whatever the dirty flags say may have changed out of World. With
+// `full` everything is captured.
+void captureChunks(World &world, SceneSaveState &state, bool full,
+                   SceneCapture &out) {
+  const bool structure =
+      full || (state.dirty & SceneSaveState::DirtyStructure) != 0;
+  auto dirty = [&](uint32_t bits) {
+    return structure || (state.dirty & bits) != 0;
+  };
+
+  if (structure) {
+    // World order here; the writer sorts by UUID (sceneio::sortCapture()).
+    sceneio::collectEntities(world, state.entities);
+    sceneio::indexEntities(state);
+    out.sortEntities = true;
+  }
+  out.pageCount = static_cast<uint32_t>(
+      (state.entities.size() + kEntityPageSize - 1) / kEntityPageSize);
+
+  capturePages(state, state.entityPages, SceneSaveState::PageEntities,
+               structure, out.pageCount, out.entityPages,
+               [&](uint32_t p, SceneCapture::EntityPage &page) {
+                 sceneio::captureEntityPage(world, state, p, out, page);
+               });
+  capturePages(state, state.transformPages, SceneSaveState::PageTransforms,
+               structure, out.pageCount, out.transformPages,
+               [&](uint32_t p, SceneCapture::TransformPage &page) {
+                 sceneio::captureTransformPage(world, state, p, page);
+               });
+  capturePages(state, state.meshPages, SceneSaveState::PageMeshes,
+               dirty(SceneSaveState::DirtyMeshes), out.pageCount,
+               out.meshPages,
+               [&](uint32_t p, SceneCapture::MeshPage &page) {
+                 sceneio::captureMeshPage(world, state, p, out, page);
+               });
+
+  // Camera parameter edits do not raise events; CAMR is tiny, so always
+  // capture it and let the checksum decide whether it gets written.
+  sceneio::captureCameras(world, state, out);
+
+  if (dirty(SceneSaveState::DirtyLights))
+    sceneio::captureLights(world, state, out);
+  if (dirty(SceneSaveState::DirtySky)) {
+    out.hasSky = true;
+    out.sky = world.skySettings();
+  }
+  if (dirty(SceneSaveState::DirtyCategories))
+    sceneio::captureCategories(world, state, out);
+}
+
+// Encodes the captured pages and keeps the others from `previous`.
+template <class Page, class SavePage>
+void writePages(NyxBinaryWriter &w, const std::vector<Page> &pages,
+                const std::vector<NyxTocEntry> &previous, uint32_t pageCount,
+                SavePage &&savePage) {
+  auto next = pages.begin();
+  for (uint32_t p = 0; p < pageCount; ++p) {
+    if (next != pages.end() && next->page == p)
+      savePage(*next++);
+    else
+      w.keepChunk(previous[p]);
+  }
+}
+
+// writeChunks() emits the pages of each chunk id in page order.
+void collectPages(const std::vector<NyxTocEntry> &toc, NyxChunk id,
+                  std::vector<NyxTocEntry> &out) {
+  out.clear();
+  for (const NyxTocEntry &e : toc) {
+    if (e.fourcc == static_cast<uint32_t>(id))
+      out.push_back(e);
+  }
+}
+
+// Encodes the snapshot's capture, keeping what it left out from the previous
+// TOC. STRS goes last since the other savers intern into it.
+void writeChunks(NyxBinaryWriter &w, SceneSaveSnapshot &snap) {
+  const SceneCapture &cap = snap.capture;
+  SceneSaveTables &tables = snap.tables;
+  const bool full = !snap.incremental;
+
+  std::vector<NyxTocEntry> previous;
+  collectPages(snap.reusable, NyxChunk::ENTS, previous);
+  writePages(w, cap.entityPages, previous, cap.pageCount,
+             [&](const SceneCapture::EntityPage &page) {
+               sceneio::saveEntityPage(w, cap, page, tables);
+             });
+  collectPages(snap.reusable, NyxChunk::TRNS, previous);
+  writePages(w, cap.transformPages, previous, cap.pageCount,
+             [&](const SceneCapture::TransformPage &page) {
+               sceneio::saveTransformPage(w, page);
+             });
+  collectPages(snap.reusable, NyxChunk::MESH, previous);
+  writePages(w, cap.meshPages, previous, cap.pageCount,
+             [&](const SceneCapture::MeshPage &page) {
+               sceneio::saveMeshPage(w, cap, page, tables);
+             });
+
+  // The ref table only grows, so an unchanged size means unchanged content.
+  if (full || tables.materialRefs.size() != tables.savedMaterialRefCount)
+    sceneio::saveMaterialRefs(w, tables);
+  else
+    keepChunks(w, snap.reusable, NyxChunk::MATL);
+
+  sceneio::saveCameras(w, cap);
+
+  if (cap.hasLights)
+    sceneio::saveLights(w, cap);
+  else
+    keepChunks(w, snap.reusable, NyxChunk::LITE);
+
+  if (cap.hasSky)
+    sceneio::saveSky(w, cap, tables);
+  else
+    keepChunks(w, snap.reusable, NyxChunk::SKY);
+
+  if (cap.hasCategories)
+    sceneio::saveCategories(w, cap, tables);
+  else
+    keepChunks(w, snap.reusable, NyxChunk::CATS);
+
+  // Existing string pages never change; only what this save interned is new.
+  const uint32_t firstNew = full ? 0u : tables.savedStringCount;
+  if (!full)
+    keepChunks(w, snap.reusable, NyxChunk::STRS);
+  const uint32_t total = static_cast<uint32_t>(tables.strings.size());
+  for (uint32_t first = firstNew; first < total; first += kStringPageSize)
+    sceneio::saveStringPage(w, tables, first,
+                            std::min(kStringPageSize, total - first));
+
+  tables.savedStringCount = total;
+  tables.savedMaterialRefCount =
+      static_cast<uint32_t>(tables.materialRefs.size());
+}
+
+bool sameChunks(const std::vector<NyxTocEntry> &a,
+                const std::vector<NyxTocEntry> &b) {
+  if (a.size() != b.size())
     return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].fourcc != b[i].fourcc || a[i].offset != b[i].offset)
+      return false;
+  }
+  return true;
+}
 
+void recordWrite(const NyxBinaryWriter &w, SceneSaveSnapshot &snap) {
+  snap.toc = w.toc();
+  snap.chunksWritten = w.chunksWritten();
+  snap.chunksReused = w.chunksReused();
+}
+
+// The whole file is built in memory and swapped in with a rename, so a
+// failed or interrupted save leaves the previous file untouched.
+bool writeFullScene(SceneSaveSnapshot &snap) {
+  NyxBinaryWriter w(NyxBinaryWriter::Mode::Memory);
   w.writeU64(NYXSCENE_MAGIC);
   w.writeU32(NYXSCENE_VERSION);
+  w.writeU64(0); // committed footer, patched below
+  writeChunks(w, snap);
+  w.finalize();
+  w.patchU64(NYXSCENE_COMMITTED_FOOTER_OFFSET, w.tell() - NYX_TOC_FOOTER_SIZE);
 
-  std::vector<sceneio::EntityRecord> ents;
-  sceneio::collectSortedEntities(world, ents);
-
-  std::vector<std::string> strings;
-  std::unordered_map<std::string, uint32_t> stringMap;
-  std::unordered_map<std::string, uint32_t> materialRefMap;
-  std::vector<sceneio::MaterialRefEntry> materialRefs;
-  std::unordered_map<uint32_t, uint32_t> entityIndexByRaw;
-
-  sceneio::saveStringsAndMap(w, world, ents, strings, stringMap, materialRefMap,
-                             materialRefs);
-  sceneio::saveEntities(w, world, ents, stringMap, entityIndexByRaw);
-  sceneio::saveTransforms(w, world, ents);
-  sceneio::saveMaterialRefs(w, materialRefs, stringMap);
-  sceneio::saveMeshes(w, world, ents, stringMap, materialRefMap,
-                      entityIndexByRaw);
-  sceneio::saveCameras(w, world, ents, entityIndexByRaw);
-  sceneio::saveLights(w, world, ents, entityIndexByRaw);
-  sceneio::saveSky(w, world, stringMap);
-  sceneio::saveCategories(w, world, stringMap, entityIndexByRaw);
+  std::string err;
+  if (!FileUtil::writeFileBytesAtomic(snap.path, w.bytes().data(),
+                                      w.bytes().size(), &err)) {
+    Log::Error("Scene '{}': {}", snap.path, err);
+    return false;
+  }
 
-  w.finalize();
+  recordWrite(w, snap);
+  snap.fileBytes = w.tell();
+  snap.bytesWritten = w.tell();
   return true;
 }
 
+// New and changed chunks plus a fresh TOC go after the current footer;
+// readers take the last footer, so the old TOC simply goes dead. The header's
+// committed footer only moves to the new one once the tail is on disk, so a
+// torn append leaves it naming the previous footer for the reader to fall
+// back to without a scan.
+bool appendScene(SceneSaveSnapshot &snap) {
+  {
+    NyxBinaryWriter w(snap.path, NyxBinaryWriter::Mode::Append);
+    if (!w.ok() || w.startOffset() != snap.previousSize)
+      return false;
+
+    w.setReusable(snap.reusable);
+    writeChunks(w, snap);
+    if (w.chunksWritten() == 0 && sameChunks(w.toc(), snap.reusable)) {
+      // Nothing changed on disk; the current footer already says all this.
+      recordWrite(w, snap);
+      snap.fileBytes = snap.previousSize;
+      snap.bytesWritten = 0;
+      return true;
+    }
+    w.finalize();
+    w.flush();
+    bool committed = w.ok() && FileUtil::syncFile(snap.path);
+    if (committed) {
+      w.patchU64(NYXSCENE_COMMITTED_FOOTER_OFFSET,
+                 w.tell() - NYX_TOC_FOOTER_SIZE);
+      w.flush();
+      committed = w.ok() && FileUtil::syncFile(snap.path);
+    }
+    if (committed) {
+      recordWrite(w, snap);
+      snap.fileBytes = w.tell();
+      snap.bytesWritten = w.tell() - w.startOffset();
+      return true;
+    }
+  }
+
+  // Drop the partial tail so the previous footer is the last one again.
+  std::error_code ec;
+  std::filesystem::resize_file(snap.path, snap.previousSize, ec);
+  return false;
+}
+
+double msSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+void captureSceneBinary(const std::string &path, World &world,
+                        SceneSaveState &state, SceneSaveSnapshot &out) {
+  const Clock::time_point start = Clock::now();
+
+  out = SceneSaveSnapshot{};
+  out.path = path;
+  out.incremental = state.matchesFile(path) && !state.wantsCompaction();
+  if (out.incremental) {
+    out.previousSize = state.fileBytes;
+    out.reusable = state.toc;
+  } else {
+    state.reset();
+  }
+
+  captureChunks(world, state, !out.incremental, out.capture);
+
+  // The tables travel with the snapshot until finishSceneSave(); anything
+  // observed from here on belongs to the next save.
+  out.tables = std::move(state.tables);
+  state.tables = {};
+  if (out.capture.sortEntities) {
+    // So does the entity order, which the writer changes.
+    out.entities = std::move(state.entities);
+    out.entityIndexByRaw = std::move(state.entityIndexByRaw);
+    state.entities = {};
+    state.entityIndexByRaw = {};
+    state.reordering = true;
+  }
+  state.dirty = 0;
+  state.dirtyPages.assign(out.capture.pageCount, 0u);
+
+  out.captureMs = msSince(start);
+}
+
+bool writeSceneBinary(SceneSaveSnapshot &snap) {
+  const Clock::time_point start = Clock::now();
+  if (snap.capture.sortEntities)
+    sceneio::sortCapture(snap);
+  snap.written = snap.incremental ? appendScene(snap) : writeFullScene(snap);
+  snap.writeMs = msSince(start);
+  return snap.written;
+}
+
+void finishSceneSave(SceneSaveState &state, SceneSaveSnapshot &snap) {
+  if (!snap.written) {
+    // The tables may be ahead of the file now; start over with a full save.
+    state.reset();
+  } else {
+    if (state.reordering) {
+      state.entities = std::move(snap.entities);
+      state.entityIndexByRaw = std::move(snap.entityIndexByRaw);
+    }
+    state.path = snap.path;
+    state.toc = snap.toc;
+    state.tables = std::move(snap.tables);
+    state.fileBytes = snap.fileBytes;
+    state.stampFile();
+    state.updateLiveBytes();
+    collectPages(state.toc, NyxChunk::ENTS, state.entityPages);
+    collectPages(state.toc, NyxChunk::TRNS, state.transformPages);
+    collectPages(state.toc, NyxChunk::MESH, state.meshPages);
+    if (!snap.incremental)
+      state.appendCount = 0;
+    else if (snap.bytesWritten > 0)
+      ++state.appendCount;
+
+    state.lastIncremental = snap.incremental;
+    state.lastBytesWritten = snap.bytesWritten;
+    state.lastChunksWritten = snap.chunksWritten;
+    state.lastChunksReused = snap.chunksReused;
+    state.replayDeferred();
+  }
+}
+
+bool saveSceneBinary(const std::string &path, World &world) {
+  SceneSaveState state;
+  return saveSceneBinary(path, world, state);
+}
+
+bool saveSceneBinary(const std::string &path, World &world,
+                     SceneSaveState &state) {
+  SceneSaveSnapshot snap;
+  captureSceneBinary(path, world, state, snap);
+  if (!writeSceneBinary(snap) && snap.incremental) {
+    Log::Warn("Scene '{}': incremental save failed, rewriting the file",
+              path);
+    finishSceneSave(state, snap);
+    captureSceneBinary(path, world, state, snap);
+    writeSceneBinary(snap);
+  }
+  finishSceneSave(state, snap);
+  return snap.written;
+}
+
 } // namespace Nyx::detail
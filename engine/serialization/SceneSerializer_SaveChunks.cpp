@@ -6,45 +6,80 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <numeric>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 namespace Nyx::detail::sceneio {
 
 namespace {
 
-void writeString(NyxBinaryWriter &w, const std::string &s) {
+void writeString(NyxBinaryWriter &w, std::string_view s) {
   w.writeU32(static_cast<uint32_t>(s.size()));
   if (!s.empty())
     w.writeBytes(s.data(), s.size());
 }
 
-uint32_t internString(std::vector<std::string> &strings,
-                      std::unordered_map<std::string, uint32_t> &map,
-                      const std::string &s) {
-  auto it = map.find(s);
-  if (it != map.end())
+uint32_t internString(SceneSaveTables &tables, std::string_view s) {
+  auto it = tables.stringMap.find(s);
+  if (it != tables.stringMap.end())
     return it->second;
-  const uint32_t id = static_cast<uint32_t>(strings.size());
-  strings.push_back(s);
-  map.emplace(s, id);
+  const uint32_t id = static_cast<uint32_t>(tables.strings.size());
+  tables.strings.emplace_back(s);
+  tables.stringMap.emplace(s, id);
   return id;
 }
 
-std::string makeMaterialRefKey(const MeshSubmesh &sm) {
-  if (!sm.materialAssetPath.empty())
-    return "A:" + sm.materialAssetPath;
-  if (sm.material != InvalidMaterial) {
-    return "H:" + std::to_string(sm.material.slot) + ":" +
-           std::to_string(sm.material.gen);
-  }
-  return "N:";
+uint32_t internMaterialRef(SceneSaveTables &tables, std::string_view assetPath,
+                           MaterialHandle material) {
+  const std::string key = makeMaterialRefKey(assetPath, material);
+  auto it = tables.materialRefMap.find(key);
+  if (it != tables.materialRefMap.end())
+    return it->second;
+  if (!assetPath.empty())
+    internString(tables, assetPath);
+  const uint32_t idx = static_cast<uint32_t>(tables.materialRefs.size());
+  MaterialRefEntry entry{};
+  entry.assetPath = assetPath;
+  entry.legacyHandle = material;
+  tables.materialRefs.push_back(std::move(entry));
+  tables.materialRefMap.emplace(key, idx);
+  return idx;
+}
+
+// Entities in the page starting at `first`.
+uint32_t pageLength(const SceneSaveState &state, uint32_t first) {
+  return std::min<uint32_t>(kEntityPageSize,
+                            static_cast<uint32_t>(state.entities.size()) -
+                                first);
+}
+
+// Tombstones, and records whose entity went away without an event yet.
+bool isLive(World &world, const EntityRecord &rec) {
+  return rec.e != InvalidEntity && world.isAlive(rec.e);
+}
+
+uint32_t entityIndex(const SceneSaveState &state, EntityID e) {
+  return e.index < state.entityIndexByRaw.size()
+             ? state.entityIndexByRaw[e.index]
+             : kInvalidIndex;
 }
 
 } // namespace
 
-void collectSortedEntities(World &world, std::vector<EntityRecord> &out) {
+std::string makeMaterialRefKey(std::string_view assetPath,
+                               MaterialHandle legacyHandle) {
+  if (!assetPath.empty())
+    return "A:" + std::string(assetPath);
+  if (legacyHandle != InvalidMaterial) {
+    return "H:" + std::to_string(legacyHandle.slot) + ":" +
+           std::to_string(legacyHandle.gen);
+  }
+  return "N:";
+}
+
+void collectEntities(World &world, std::vector<EntityRecord> &out) {
   out.clear();
   out.reserve(world.alive().size());
   for (EntityID e : world.alive()) {
@@ -55,227 +90,374 @@ void collectSortedEntities(World &world, std::vector<EntityRecord> &out) {
       continue;
     out.push_back({e, id});
   }
+}
 
-  std::sort(out.begin(), out.end(),
-            [](const EntityRecord &a, const EntityRecord &b) {
-              return a.uuid.value < b.uuid.value;
-            });
+uint32_t indexEntities(const std::vector<EntityRecord> &entities,
+                       std::vector<uint32_t> &byRaw) {
+  uint32_t rawCount = 0;
+  for (const EntityRecord &rec : entities) {
+    if (rec.e != InvalidEntity)
+      rawCount = std::max(rawCount, rec.e.index + 1u);
+  }
+  byRaw.assign(rawCount, kInvalidIndex);
+
+  uint32_t tombstones = 0;
+  for (uint32_t i = 0; i < entities.size(); ++i) {
+    if (entities[i].e == InvalidEntity)
+      ++tombstones;
+    else
+      byRaw[entities[i].e.index] = i;
+  }
+  return tombstones;
 }
 
-void saveStringsAndMap(
-    NyxBinaryWriter &w, World &world, const std::vector<EntityRecord> &ents,
-    std::vector<std::string> &strings,
-    std::unordered_map<std::string, uint32_t> &stringMap,
-    std::unordered_map<std::string, uint32_t> &materialRefMap,
-    std::vector<MaterialRefEntry> &materialRefs) {
-  strings.clear();
-  stringMap.clear();
-  materialRefMap.clear();
-  materialRefs.clear();
-
-  for (const EntityRecord &rec : ents) {
-    const EntityID e = rec.e;
-    internString(strings, stringMap, world.name(e).name);
-
-    if (world.hasMesh(e)) {
-      const CMesh &m = world.mesh(e);
-      for (const MeshSubmesh &sm : m.submeshes) {
-        internString(strings, stringMap, sm.name);
-
-        if (!sm.materialAssetPath.empty())
-          internString(strings, stringMap, sm.materialAssetPath);
-
-        const std::string key = makeMaterialRefKey(sm);
-        if (materialRefMap.find(key) == materialRefMap.end()) {
-          const uint32_t idx = static_cast<uint32_t>(materialRefs.size());
-          materialRefMap.emplace(key, idx);
-          MaterialRefEntry entry{};
-          entry.assetPath = sm.materialAssetPath;
-          entry.legacyHandle = sm.material;
-          materialRefs.push_back(std::move(entry));
-        }
-      }
+void indexEntities(SceneSaveState &state) {
+  state.tombstones = indexEntities(state.entities, state.entityIndexByRaw);
+}
+
+void sortCapture(SceneSaveSnapshot &snap) {
+  SceneCapture &cap = snap.capture;
+  std::vector<EntityRecord> &ents = snap.entities;
+  const uint32_t count = static_cast<uint32_t>(ents.size());
+
+  std::vector<uint32_t> order(count);
+  std::iota(order.begin(), order.end(), 0u);
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return ents[a].uuid.value < ents[b].uuid.value;
+  });
+  std::vector<uint32_t> moved(count);
+  for (uint32_t i = 0; i < count; ++i)
+    moved[order[i]] = i;
+  auto remap = [&](uint32_t idx) {
+    return idx < count ? moved[idx] : kInvalidIndex;
+  };
+
+  // A structure capture lists every page, so the pages keep their sizes and
+  // only the rows move between them.
+  std::vector<SceneCapture::EntityRow> rows(count);
+  for (const SceneCapture::EntityPage &page : cap.entityPages) {
+    const uint32_t first = page.page * kEntityPageSize;
+    for (uint32_t i = 0; i < page.rows.size(); ++i) {
+      SceneCapture::EntityRow &row = rows[moved[first + i]];
+      row = page.rows[i];
+      row.parent = remap(row.parent);
     }
   }
+  for (SceneCapture::EntityPage &page : cap.entityPages)
+    std::copy_n(rows.begin() + page.page * kEntityPageSize, page.rows.size(),
+                page.rows.begin());
+
+  std::vector<CTransform> transforms(count);
+  for (const SceneCapture::TransformPage &page : cap.transformPages) {
+    const uint32_t first = page.page * kEntityPageSize;
+    for (uint32_t i = 0; i < page.transforms.size(); ++i)
+      transforms[moved[first + i]] = page.transforms[i];
+  }
+  for (SceneCapture::TransformPage &page : cap.transformPages)
+    std::copy_n(transforms.begin() + page.page * kEntityPageSize,
+                page.transforms.size(), page.transforms.begin());
+
+  struct MovedMesh {
+    uint32_t entity;
+    const SceneCapture::MeshPage *page;
+    const SceneCapture::MeshRow *row;
+  };
+  std::vector<MovedMesh> meshes;
+  for (const SceneCapture::MeshPage &page : cap.meshPages) {
+    for (const SceneCapture::MeshRow &row : page.meshes)
+      meshes.push_back({moved[row.entity], &page, &row});
+  }
+  std::sort(meshes.begin(), meshes.end(),
+            [](const MovedMesh &a, const MovedMesh &b) {
+              return a.entity < b.entity;
+            });
+  std::vector<SceneCapture::MeshPage> meshPages(cap.meshPages.size());
+  for (size_t p = 0; p < meshPages.size(); ++p) {
+    meshPages[p].page = cap.meshPages[p].page;
+    meshPages[p].count = cap.meshPages[p].count;
+  }
+  for (const MovedMesh &m : meshes) {
+    SceneCapture::MeshPage &dst = meshPages[m.entity / kEntityPageSize];
+    dst.meshes.push_back({m.entity,
+                          static_cast<uint32_t>(dst.submeshes.size()),
+                          m.row->submeshCount});
+    const auto src = m.page->submeshes.begin() + m.row->firstSubmesh;
+    dst.submeshes.insert(dst.submeshes.end(), src,
+                         src + m.row->submeshCount);
+  }
+  cap.meshPages = std::move(meshPages);
+
+  for (SceneCapture::CameraRow &row : cap.cameras)
+    row.entity = moved[row.entity];
+  std::sort(cap.cameras.begin(), cap.cameras.end(),
+            [](const SceneCapture::CameraRow &a,
+               const SceneCapture::CameraRow &b) {
+              return a.entity < b.entity;
+            });
+  cap.activeCamera = remap(cap.activeCamera);
+
+  for (SceneCapture::LightRow &row : cap.lights)
+    row.entity = moved[row.entity];
+  std::sort(cap.lights.begin(), cap.lights.end(),
+            [](const SceneCapture::LightRow &a,
+               const SceneCapture::LightRow &b) {
+              return a.entity < b.entity;
+            });
 
-  const CSky &sky = world.skySettings();
-  if (!sky.hdriPath.empty())
-    internString(strings, stringMap, sky.hdriPath);
-
-  for (const auto &cat : world.categories())
-    internString(strings, stringMap, cat.name);
+  for (SceneCapture::CategoryRow &cat : cap.categories) {
+    for (uint32_t &idx : cat.members)
+      idx = moved[idx];
+  }
 
-  w.beginChunk(static_cast<uint32_t>(NyxChunk::STRS), 1);
-  w.writeU32(static_cast<uint32_t>(strings.size()));
-  for (const std::string &s : strings)
-    writeString(w, s);
-  w.endChunk();
+  std::vector<EntityRecord> sorted(count);
+  for (uint32_t i = 0; i < count; ++i)
+    sorted[i] = ents[order[i]];
+  ents = std::move(sorted);
+  indexEntities(ents, snap.entityIndexByRaw);
+  cap.sortEntities = false;
 }
 
-void saveEntities(
-    NyxBinaryWriter &w, World &world, const std::vector<EntityRecord> &ents,
-    const std::unordered_map<std::string, uint32_t> &stringMap,
-    std::unordered_map<uint32_t, uint32_t> &entityIndexByRaw) {
-  entityIndexByRaw.clear();
-  entityIndexByRaw.reserve(ents.size());
-
-  for (uint32_t i = 0; i < ents.size(); ++i)
-    entityIndexByRaw.emplace(ents[i].e.index, i);
-
-  w.beginChunk(static_cast<uint32_t>(NyxChunk::ENTS), 1);
-  w.writeU32(static_cast<uint32_t>(ents.size()));
+// ------------------------------
+// Capture
+// ------------------------------
+
+void captureEntityPage(World &world, const SceneSaveState &state,
+                       uint32_t page, SceneCapture &capture,
+                       SceneCapture::EntityPage &out) {
+  const uint32_t first = page * kEntityPageSize;
+  const uint32_t count = pageLength(state, first);
+
+  out.page = page;
+  out.rows.resize(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    const EntityRecord &rec = state.entities[first + i];
+    SceneCapture::EntityRow &row = out.rows[i];
+    if (!isLive(world, rec)) {
+      row = SceneCapture::EntityRow{};
+      continue;
+    }
+    // Appended records only learn their UUID here.
+    row.uuid = world.uuid(rec.e);
+    row.name = capture.addText(world.name(rec.e).name);
 
-  for (uint32_t i = 0; i < ents.size(); ++i) {
-    const EntityID e = ents[i].e;
-    const EntityUUID id = world.uuid(e);
+    const EntityID parent = world.parentOf(rec.e);
+    row.parent =
+        parent != InvalidEntity ? entityIndex(state, parent) : kInvalidIndex;
 
-    w.writeU64(id.value);
+    row.flags = 0;
+    if (world.hasMesh(rec.e))
+      row.flags |= 1u << 0;
+    if (world.hasLight(rec.e))
+      row.flags |= 1u << 1;
+    if (world.hasCamera(rec.e))
+      row.flags |= 1u << 2;
+  }
+}
 
-    const std::string &name = world.name(e).name;
-    auto nit = stringMap.find(name);
-    w.writeU32(nit == stringMap.end() ? 0u : nit->second);
+void captureTransformPage(World &world, const SceneSaveState &state,
+                          uint32_t page, SceneCapture::TransformPage &out) {
+  const uint32_t first = page * kEntityPageSize;
+  const uint32_t count = pageLength(state, first);
+
+  out.page = page;
+  out.transforms.resize(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    const EntityRecord &rec = state.entities[first + i];
+    out.transforms[i] =
+        isLive(world, rec) ? world.transform(rec.e) : CTransform{};
+  }
+}
 
-    EntityID parent = world.parentOf(e);
-    uint32_t parentIndex = kInvalidIndex;
-    if (parent != InvalidEntity) {
-      auto pit = entityIndexByRaw.find(parent.index);
-      if (pit != entityIndexByRaw.end())
-        parentIndex = pit->second;
+void captureMeshPage(World &world, const SceneSaveState &state, uint32_t page,
+                     SceneCapture &capture, SceneCapture::MeshPage &out) {
+  const uint32_t first = page * kEntityPageSize;
+  const uint32_t count = pageLength(state, first);
+
+  out.page = page;
+  out.count = count;
+  out.meshes.clear();
+  out.submeshes.clear();
+  for (uint32_t i = first; i < first + count; ++i) {
+    const EntityRecord &rec = state.entities[i];
+    if (!isLive(world, rec) || !world.hasMesh(rec.e))
+      continue;
+    const std::vector<MeshSubmesh> &submeshes = world.mesh(rec.e).submeshes;
+    out.meshes.push_back({i, static_cast<uint32_t>(out.submeshes.size()),
+                          static_cast<uint32_t>(submeshes.size())});
+    for (const MeshSubmesh &sm : submeshes) {
+      SceneCapture::SubmeshRow &row = out.submeshes.emplace_back();
+      row.name = capture.addText(sm.name);
+      row.materialAssetPath = capture.addText(sm.materialAssetPath);
+      row.material = sm.material;
+      row.type = sm.type;
     }
-    w.writeU32(parentIndex);
-
-    uint32_t flags = 0;
-    if (world.hasMesh(e))
-      flags |= 1u << 0;
-    if (world.hasLight(e))
-      flags |= 1u << 1;
-    if (world.hasCamera(e))
-      flags |= 1u << 2;
-    w.writeU32(flags);
   }
-
-  w.endChunk();
 }
 
-void saveTransforms(NyxBinaryWriter &w, World &world,
-                    const std::vector<EntityRecord> &ents) {
-  w.beginChunk(static_cast<uint32_t>(NyxChunk::TRNS), 2);
-  w.writeU32(static_cast<uint32_t>(ents.size()));
-
-  for (const EntityRecord &rec : ents) {
-    const CTransform &t = world.transform(rec.e);
-
-    w.writeF32(t.translation.x);
-    w.writeF32(t.translation.y);
-    w.writeF32(t.translation.z);
-
-    w.writeF32(t.rotation.x);
-    w.writeF32(t.rotation.y);
-    w.writeF32(t.rotation.z);
-    w.writeF32(t.rotation.w);
+void captureCameras(World &world, const SceneSaveState &state,
+                    SceneCapture &out) {
+  out.cameras.clear();
+  for (uint32_t i = 0; i < state.entities.size(); ++i) {
+    const EntityRecord &rec = state.entities[i];
+    if (isLive(world, rec) && world.hasCamera(rec.e))
+      out.cameras.push_back({i, world.camera(rec.e)});
+  }
 
-    w.writeF32(t.scale.x);
-    w.writeF32(t.scale.y);
-    w.writeF32(t.scale.z);
+  const EntityID active = world.activeCamera();
+  out.activeCamera =
+      active != InvalidEntity ? entityIndex(state, active) : kInvalidIndex;
+}
 
-    w.writeU8(t.hidden ? 1u : 0u);
+void captureLights(World &world, const SceneSaveState &state,
+                   SceneCapture &out) {
+  out.hasLights = true;
+  out.lights.clear();
+  for (uint32_t i = 0; i < state.entities.size(); ++i) {
+    const EntityRecord &rec = state.entities[i];
+    if (isLive(world, rec) && world.hasLight(rec.e))
+      out.lights.push_back({i, world.light(rec.e)});
   }
-
-  w.endChunk();
 }
 
-void saveMaterialRefs(
-    NyxBinaryWriter &w, const std::vector<MaterialRefEntry> &materialRefs,
-    const std::unordered_map<std::string, uint32_t> &stringMap) {
-  w.beginChunk(static_cast<uint32_t>(NyxChunk::MATL), 2);
-  w.writeU32(static_cast<uint32_t>(materialRefs.size()));
-  for (const MaterialRefEntry &ref : materialRefs) {
-    uint32_t pathID = kInvalidIndex;
-    if (!ref.assetPath.empty()) {
-      auto it = stringMap.find(ref.assetPath);
-      if (it != stringMap.end())
-        pathID = it->second;
+void captureCategories(World &world, const SceneSaveState &state,
+                       SceneCapture &out) {
+  out.hasCategories = true;
+  out.categories.clear();
+  out.categories.reserve(world.categories().size());
+  for (const auto &cat : world.categories()) {
+    SceneCapture::CategoryRow &row = out.categories.emplace_back();
+    row.name = cat.name;
+    row.parent = cat.parent;
+    row.members.reserve(cat.entities.size());
+    for (EntityID e : cat.entities) {
+      const uint32_t idx = entityIndex(state, e);
+      if (idx != kInvalidIndex)
+        row.members.push_back(idx);
     }
-    w.writeU32(pathID);
-    w.writeU32(ref.legacyHandle.slot);
-    w.writeU32(ref.legacyHandle.gen);
   }
-  w.endChunk();
 }
 
-void saveMeshes(
-    NyxBinaryWriter &w, World &world, const std::vector<EntityRecord> &ents,
-    const std::unordered_map<std::string, uint32_t> &stringMap,
-    const std::unordered_map<std::string, uint32_t> &materialRefMap,
-    const std::unordered_map<uint32_t, uint32_t> &entityIndexByRaw) {
-  w.beginChunk(static_cast<uint32_t>(NyxChunk::MESH), 2);
+// ------------------------------
+// Encode
+// ------------------------------
+
+void saveStringPage(NyxBinaryWriter &w, const SceneSaveTables &tables,
+                    uint32_t first, uint32_t count) {
+  w.beginChunk(static_cast<uint32_t>(NyxChunk::STRS), kStringsVersion,
+               NyxCodec::LZ);
+  w.writeU32(first);
+  w.writeU32(count);
+  w.writeU32(count);
+  for (uint32_t i = first; i < first + count; ++i)
+    writeString(w, tables.strings[i]);
+  w.endChunk();
+}
 
-  std::vector<EntityID> meshEnts;
-  meshEnts.reserve(ents.size());
-  for (const EntityRecord &rec : ents) {
-    if (world.hasMesh(rec.e))
-      meshEnts.push_back(rec.e);
+void saveEntityPage(NyxBinaryWriter &w, const SceneCapture &capture,
+                    const SceneCapture::EntityPage &page,
+                    SceneSaveTables &tables) {
+  const uint32_t count = static_cast<uint32_t>(page.rows.size());
+
+  w.beginChunk(static_cast<uint32_t>(NyxChunk::ENTS), kEntitiesVersion,
+               NyxCodec::LZ);
+  w.writeU32(page.page * kEntityPageSize);
+  w.writeU32(count);
+  w.writeU32(count);
+
+  for (const SceneCapture::EntityRow &row : page.rows) {
+    w.writeU64(row.uuid.value);
+    w.writeU32(internString(tables, capture.str(row.name)));
+    w.writeU32(row.parent);
+    w.writeU32(row.flags);
   }
 
-  w.writeU32(static_cast<uint32_t>(meshEnts.size()));
-
-  for (EntityID e : meshEnts) {
-    auto eit = entityIndexByRaw.find(e.index);
-    if (eit == entityIndexByRaw.end())
-      continue;
+  w.endChunk();
+}
 
-    w.writeU32(eit->second);
+void saveTransformPage(NyxBinaryWriter &w,
+                       const SceneCapture::TransformPage &page) {
+  const uint32_t count = static_cast<uint32_t>(page.transforms.size());
+
+  // Plain LZ: XOR-delta and byte planes over the records came out larger
+  // and twice as slow to decode on both the grid and hand-placed scenes of
+  // nyx_bench --micro scenecodec. Files saved with it still load.
+  w.beginChunk(static_cast<uint32_t>(NyxChunk::TRNS), kTransformsVersion,
+               NyxCodec::LZ);
+  w.writeU32(page.page * kEntityPageSize);
+  w.writeU32(count);
+  w.writeU32(count);
+
+  std::vector<TransformRecord> records(count);
+  std::vector<uint8_t> hidden(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    const CTransform &t = page.transforms[i];
+    TransformRecord &dst = records[i];
+    dst.translation[0] = t.translation.x;
+    dst.translation[1] = t.translation.y;
+    dst.translation[2] = t.translation.z;
+    dst.rotation[0] = t.rotation.x;
+    dst.rotation[1] = t.rotation.y;
+    dst.rotation[2] = t.rotation.z;
+    dst.rotation[3] = t.rotation.w;
+    dst.scale[0] = t.scale.x;
+    dst.scale[1] = t.scale.y;
+    dst.scale[2] = t.scale.z;
+    hidden[i] = t.hidden ? 1u : 0u;
+  }
+  w.writeBytes(records.data(), records.size() * sizeof(TransformRecord));
+  w.writeBytes(hidden.data(), hidden.size());
 
-    const CMesh &m = world.mesh(e);
-    w.writeU32(static_cast<uint32_t>(m.submeshes.size()));
+  w.endChunk();
+}
 
-    for (const MeshSubmesh &sm : m.submeshes) {
-      auto sit = stringMap.find(sm.name);
-      w.writeU32(sit == stringMap.end() ? 0u : sit->second);
+void saveMeshPage(NyxBinaryWriter &w, const SceneCapture &capture,
+                  const SceneCapture::MeshPage &page, SceneSaveTables &tables) {
+  w.beginChunk(static_cast<uint32_t>(NyxChunk::MESH), kMeshesVersion,
+               NyxCodec::LZ);
+  w.writeU32(page.page * kEntityPageSize);
+  w.writeU32(page.count);
+  w.writeU32(static_cast<uint32_t>(page.meshes.size()));
+
+  for (const SceneCapture::MeshRow &mesh : page.meshes) {
+    w.writeU32(mesh.entity);
+    w.writeU32(mesh.submeshCount);
+
+    for (uint32_t i = 0; i < mesh.submeshCount; ++i) {
+      const SceneCapture::SubmeshRow &sm =
+          page.submeshes[mesh.firstSubmesh + i];
+      w.writeU32(internString(tables, capture.str(sm.name)));
       w.writeU8(static_cast<uint8_t>(sm.type));
-
-      uint32_t materialIdx = kInvalidIndex;
-      const std::string key = makeMaterialRefKey(sm);
-      auto mit = materialRefMap.find(key);
-      if (mit != materialRefMap.end())
-        materialIdx = mit->second;
-      w.writeU32(materialIdx);
+      w.writeU32(internMaterialRef(
+          tables, capture.str(sm.materialAssetPath), sm.material));
     }
   }
 
   w.endChunk();
 }
 
-void saveCameras(
-    NyxBinaryWriter &w, World &world, const std::vector<EntityRecord> &ents,
-    const std::unordered_map<uint32_t, uint32_t> &entityIndexByRaw) {
-  w.beginChunk(static_cast<uint32_t>(NyxChunk::CAMR), 3);
-
-  std::vector<EntityID> cams;
-  cams.reserve(ents.size());
-  for (const EntityRecord &rec : ents) {
-    if (world.hasCamera(rec.e))
-      cams.push_back(rec.e);
+void saveMaterialRefs(NyxBinaryWriter &w, SceneSaveTables &tables) {
+  w.beginChunk(static_cast<uint32_t>(NyxChunk::MATL), kMaterialRefsVersion,
+               NyxCodec::LZ);
+  w.writeU32(static_cast<uint32_t>(tables.materialRefs.size()));
+  for (const MaterialRefEntry &ref : tables.materialRefs) {
+    w.writeU32(ref.assetPath.empty() ? kInvalidIndex
+                                     : internString(tables, ref.assetPath));
+    w.writeU32(ref.legacyHandle.slot);
+    w.writeU32(ref.legacyHandle.gen);
   }
+  w.endChunk();
+}
 
-  w.writeU32(static_cast<uint32_t>(cams.size()));
-
-  uint32_t activeIndex = kInvalidIndex;
-  const EntityID active = world.activeCamera();
-  if (active != InvalidEntity) {
-    auto ait = entityIndexByRaw.find(active.index);
-    if (ait != entityIndexByRaw.end())
-      activeIndex = ait->second;
-  }
-  w.writeU32(activeIndex);
+void saveCameras(NyxBinaryWriter &w, const SceneCapture &capture) {
+  w.beginChunk(static_cast<uint32_t>(NyxChunk::CAMR), kCamerasVersion,
+               NyxCodec::LZ);
 
-  for (EntityID e : cams) {
-    auto eit = entityIndexByRaw.find(e.index);
-    if (eit == entityIndexByRaw.end())
-      continue;
+  w.writeU32(static_cast<uint32_t>(capture.cameras.size()));
+  w.writeU32(capture.activeCamera);
 
-    const CCamera &c = world.camera(e);
-    w.writeU32(eit->second);
+  for (const SceneCapture::CameraRow &row : capture.cameras) {
+    const CCamera &c = row.camera;
+    w.writeU32(row.entity);
     w.writeU8(static_cast<uint8_t>(c.projection));
     w.writeF32(c.fovYDeg);
     w.writeF32(c.orthoHeight);
@@ -291,27 +473,15 @@ void saveCameras(
   w.endChunk();
 }
 
-void saveLights(
-    NyxBinaryWriter &w, World &world, const std::vector<EntityRecord> &ents,
-    const std::unordered_map<uint32_t, uint32_t> &entityIndexByRaw) {
-  w.beginChunk(static_cast<uint32_t>(NyxChunk::LITE), 2);
+void saveLights(NyxBinaryWriter &w, const SceneCapture &capture) {
+  w.beginChunk(static_cast<uint32_t>(NyxChunk::LITE), kLightsVersion,
+               NyxCodec::LZ);
 
-  std::vector<EntityID> lights;
-  lights.reserve(ents.size());
-  for (const EntityRecord &rec : ents) {
-    if (world.hasLight(rec.e))
-      lights.push_back(rec.e);
-  }
-
-  w.writeU32(static_cast<uint32_t>(lights.size()));
-
-  for (EntityID e : lights) {
-    auto eit = entityIndexByRaw.find(e.index);
-    if (eit == entityIndexByRaw.end())
-      continue;
+  w.writeU32(static_cast<uint32_t>(capture.lights.size()));
 
-    const CLight &l = world.light(e);
-    w.writeU32(eit->second);
+  for (const SceneCapture::LightRow &row : capture.lights) {
+    const CLight &l = row.light;
+    w.writeU32(row.entity);
     w.writeU8(static_cast<uint8_t>(l.type));
 
     w.writeF32(l.color.x);
@@ -340,17 +510,12 @@ void saveLights(
   w.endChunk();
 }
 
-void saveSky(NyxBinaryWriter &w, World &world,
-             const std::unordered_map<std::string, uint32_t> &stringMap) {
-  w.beginChunk(static_cast<uint32_t>(NyxChunk::SKY), 2);
+void saveSky(NyxBinaryWriter &w, const SceneCapture &capture,
+             SceneSaveTables &tables) {
+  w.beginChunk(static_cast<uint32_t>(NyxChunk::SKY), kSkyVersion);
 
-  const CSky &sky = world.skySettings();
-  uint32_t hdriId = 0;
-  auto it = stringMap.find(sky.hdriPath);
-  if (it != stringMap.end())
-    hdriId = it->second;
-
-  w.writeU32(hdriId);
+  const CSky &sky = capture.sky;
+  w.writeU32(internString(tables, sky.hdriPath));
   w.writeF32(sky.intensity);
   w.writeF32(sky.exposure);
   w.writeF32(sky.rotationYawDeg);
@@ -361,32 +526,20 @@ void saveSky(NyxBinaryWriter &w, World &world,
   w.endChunk();
 }
 
-void saveCategories(
-    NyxBinaryWriter &w, World &world,
-    const std::unordered_map<std::string, uint32_t> &stringMap,
-    const std::unordered_map<uint32_t, uint32_t> &entityIndexByRaw) {
-  const auto &cats = world.categories();
-  if (cats.empty())
+void saveCategories(NyxBinaryWriter &w, const SceneCapture &capture,
+                    SceneSaveTables &tables) {
+  if (capture.categories.empty())
     return;
 
-  w.beginChunk(static_cast<uint32_t>(NyxChunk::CATS), 1);
-  w.writeU32(static_cast<uint32_t>(cats.size()));
+  w.beginChunk(static_cast<uint32_t>(NyxChunk::CATS), kCategoriesVersion,
+               NyxCodec::LZ);
+  w.writeU32(static_cast<uint32_t>(capture.categories.size()));
 
-  for (const auto &cat : cats) {
-    auto nit = stringMap.find(cat.name);
-    w.writeU32(nit == stringMap.end() ? 0u : nit->second);
+  for (const SceneCapture::CategoryRow &cat : capture.categories) {
+    w.writeU32(internString(tables, cat.name));
     w.writeU32(static_cast<uint32_t>(cat.parent));
-
-    std::vector<uint32_t> members;
-    members.reserve(cat.entities.size());
-    for (EntityID e : cat.entities) {
-      auto eit = entityIndexByRaw.find(e.index);
-      if (eit != entityIndexByRaw.end())
-        members.push_back(eit->second);
-    }
-
-    w.writeU32(static_cast<uint32_t>(members.size()));
-    for (uint32_t idx : members)
+    w.writeU32(static_cast<uint32_t>(cat.members.size()));
+    for (uint32_t idx : cat.members)
       w.writeU32(idx);
   }
 